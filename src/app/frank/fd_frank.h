@@ -19,7 +19,28 @@
 
      {HA,SV}_FILT_{CNT,SZ} is frank specific and the number of times a
      transaction was dropped by a verify tile due to failing signature
-     verification. */
+     verification.
+
+     PACK_* are frank specific and updated by the pack tile.
+     PACK_PENDING_CNT is the number of transactions currently waiting to
+     be scheduled, PACK_DROP_CNT is the number of transactions rejected
+     by the pack (or evicted from it by higher priority ones),
+     PACK_{MICROBLOCK,TXN,BLOCK}_CNT are the number of microblocks,
+     scheduled transactions and blocks and PACK_BLOCK_CU is the compute
+     units used by the most recently ended block.
+
+     LOAD_* are frank specific and updated by a load tile (a synthetic
+     transaction generator feeding a verify tile's in).  LOAD_PUB_{CNT,SZ}
+     are the number of transactions published and their payload bytes,
+     LOAD_DUP_CNT and LOAD_ERRSV_CNT are the number of those that were
+     deliberate duplicates / had a deliberately invalid signature,
+     LOAD_STALE_CNT is the number of transactions that were repeats
+     because the tile ran through its pool of signed transactions faster
+     than it could resign it (ideally never), LOAD_SIGN_CNT is the
+     number of transactions signed and LOAD_DUP_PPM is the effective
+     duplicate rate (deliberate and stale) in parts per million over the
+     most recently completed measurement window (nominally dup_frac*1e6,
+     higher if the pool is too small for the publish rate). */
 
 #define FD_FRANK_CNC_DIAG_IN_BACKP    FD_CNC_DIAG_IN_BACKP  /* ==0 */
 #define FD_FRANK_CNC_DIAG_BACKP_CNT   FD_CNC_DIAG_BACKP_CNT /* ==1 */
@@ -28,8 +49,88 @@
 #define FD_FRANK_CNC_DIAG_SV_FILT_CNT (4UL)                 /* ", ideally never */
 #define FD_FRANK_CNC_DIAG_SV_FILT_SZ  (5UL)                 /* " */
 
+#define FD_FRANK_CNC_DIAG_PACK_PENDING_CNT    (6UL)         /* updated by pack tile, frequently */
+#define FD_FRANK_CNC_DIAG_PACK_DROP_CNT       (7UL)         /* ", ideally never */
+#define FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT (8UL)         /* ", frequently */
+#define FD_FRANK_CNC_DIAG_PACK_TXN_CNT        (9UL)         /* ", frequently */
+#define FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT      (10UL)        /* ", once per block */
+#define FD_FRANK_CNC_DIAG_PACK_BLOCK_CU       (11UL)        /* ", once per block */
+
+#define FD_FRANK_CNC_DIAG_LOAD_PUB_CNT   (12UL)             /* updated by load tile, frequently */
+#define FD_FRANK_CNC_DIAG_LOAD_PUB_SZ    (13UL)             /* ", frequently */
+#define FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   (14UL)             /* ", as configured */
+#define FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT (15UL)             /* ", as configured */
+#define FD_FRANK_CNC_DIAG_LOAD_STALE_CNT (16UL)             /* ", ideally never */
+#define FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT  (17UL)             /* ", frequently */
+#define FD_FRANK_CNC_DIAG_LOAD_DUP_PPM   (18UL)             /* ", once per window */
+
+/* A verify tile consumes raw transactions (e.g. UDP payloads) from its
+   in and publishes the ones that parsed and passed signature
+   verification.  The frag sig is the transaction's dedup tag (the least
+   significant 64-bits of its first signature, never
+   FD_TCACHE_TAG_NULL).  The frag payload is laid out as:
+
+     txn payload (payload_sz bytes, as received)
+     zero padding (to 2 byte alignment)
+     fd_txn_t (as parsed by fd_txn_parse, variable sized)
+     seq (ulong, the frag's sequence number in the verify's mcache)
+     payload_sz (ushort)
+
+   such that downstream tiles do not need to reparse the transaction
+   (and, if the verify has a hold table, such that they know which seq
+   to pin the payload's slot with even after the frag was forwarded by
+   another tile).
+   The frag sz covers the whole layout.  FD_FRANK_TXN_PAYLOAD_MAX is the
+   largest transaction payload a verify tile accepts and
+   FD_FRANK_VERIFY_MTU is the largest frag it can publish (the verify
+   dcache should be sized for this mtu). */
+
+#define FD_FRANK_TXN_PAYLOAD_MAX FD_TXN_MTU /* ==1232 */
+#define FD_FRANK_VERIFY_MTU      (FD_FRANK_TXN_PAYLOAD_MAX + FD_TXN_MAX_SZ + 10UL) /* ==4812 */
+
+/* The pack tile publishes each microblock it schedules as an entry to
+   the block store (see fd_bstore.h).  Its slots are the pack's blocks.
+   The entry payload is laid out as:
+
+     txn_cnt (ushort)
+     lane_idx (ushort, the executor lane the microblock was scheduled for)
+     for each transaction in the microblock, in execution order:
+       payload_sz (ushort)
+       txn payload (payload_sz bytes, as received)
+
+   FD_FRANK_ENTRY_MTU( microblock_max ) is the largest entry a pack tile
+   configured for microblock_max transactions per microblock can publish
+   (the block store dcache should be sized for this mtu). */
+
+#define FD_FRANK_ENTRY_MTU( microblock_max ) (4UL + (microblock_max)*(2UL + FD_FRANK_TXN_PAYLOAD_MAX))
+
 FD_PROTOTYPES_BEGIN
 
+/* fd_frank_txn_payload_sz returns the size of the transaction payload at
+   the start of a verified transaction frag of sz bytes (see above).
+   fd_frank_txn returns the location of the parsed transaction in such
+   a frag.  fd_frank_txn_seq returns the frag's sequence number in the
+   mcache of the verify that published it.  Assumes frag is a valid
+   verified transaction frag. */
+
+FD_FN_PURE static inline ulong
+fd_frank_txn_payload_sz( uchar const * frag,
+                         ulong         sz ) {
+  return fd_ulong_load_2( frag + sz - 2UL );
+}
+
+FD_FN_PURE static inline ulong
+fd_frank_txn_seq( uchar const * frag,
+                  ulong         sz ) {
+  return fd_ulong_load_8( frag + sz - 10UL );
+}
+
+FD_FN_PURE static inline fd_txn_t const *
+fd_frank_txn( uchar const * frag,
+              ulong         sz ) {
+  return (fd_txn_t const *)(frag + fd_ulong_align_up( fd_frank_txn_payload_sz( frag, sz ), 2UL ));
+}
+
 /* fd_frank_{verify,dedup,pack}_task is a fd_tile_task_t compatible
    function whose task is to run a {verify,dedup,pack} tile.  argc is
    ignored, argv[0] points to a cstr with the tile name (for a verify,
@@ -42,7 +143,17 @@ FD_PROTOTYPES_BEGIN
    used after the tile has successfully booted.  Aborts the thread group
    on error.  Returns 0 on success and non-zero on failure (logs
    details, given abortive behavior, only reason for a failure return is
-   build target is without FD_HAS_FRANK). */
+   build target is without FD_HAS_FRANK).
+
+   fd_frank_dedup_shard_task is the same for a dedup shard tile.
+   argv[0] is the name of the shard (used to find the specific shard
+   configuration under dedup.shard in the frank instance's
+   configuration).  When the dedup is sharded, the dedup tile merges
+   the shard outputs instead of deduping the verify outputs itself.
+
+   fd_frank_load_task is the same for a load tile.  argv[0] is the name
+   of the verify tile the load tile feeds (its configuration is under
+   verify.[name].load and it publishes to verify.[name].in). */
 
 int
 fd_frank_verify_task( int     argc,
@@ -52,10 +163,18 @@ int
 fd_frank_dedup_task( int     argc,
                      char ** argv );
 
+int
+fd_frank_dedup_shard_task( int     argc,
+                           char ** argv );
+
 int
 fd_frank_pack_task( int     argc,
                     char ** argv );
 
+int
+fd_frank_load_task( int     argc,
+                    char ** argv );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_app_frank_fd_frank_h */
@@ -0,0 +1,488 @@
+#include "fd_frank.h"
+
+#if FD_HAS_FRANK
+
+#include <stdio.h>
+
+/* fd_frank_bench runs a complete frank pipeline (load -> verify x
+   verify_cnt -> dedup (optionally sharded) -> pack) in a single thread
+   group for a fixed duration and prints a machine readable (JSON)
+   summary of its capacity to stdout.  Unlike fd_frank_run.bin, it needs
+   no fd_frank_init / named workspace: all the IPC objects live in an
+   anonymous workspace sized for the configuration and the tiles are
+   the exact same tasks fd_frank_run.bin uses, configured through a pod
+   in that workspace.  Each verify tile is fed by its own load tile (see
+   fd_frank_load.c for the transaction mix knobs).
+
+   The tile layout is the same as fd_frank_run.bin (tile 0 is this
+   monitor, tile 1 pack, tile 2 dedup, then the verify, the dedup shard
+   and the load tiles), such that --tile-cpus picks the cores for each
+   stage.  E.g. 2 verify tiles unsharded on cores 1-7 with this monitor
+   floating:
+
+     fd_frank_bench --tile-cpus f,1-7 --verify-cnt 2
+
+   Statistics are accumulated over --duration ns after --warmup ns.
+   Throughputs are in transactions per second, backp is the fraction of
+   time the producers of a stage were backpressured by the stage
+   downstream (sampled) and lat_ns are quantiles of the time from a
+   transaction's origination in a load tile to it reaching the pack tile
+   (to within the histogram bucket resolution). */
+
+#define BENCH_NAME        "frank_bench"
+#define BENCH_CNC_APP_SZ  (4032UL)
+#define BENCH_POD_MAX     (65536UL)
+#define BENCH_VERIFY_MAX  (64UL)
+#define BENCH_SHARD_MAX   (64UL)
+#define BENCH_DIAG_CNT    (FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT+1UL)
+
+/* bench_alloc allocates footprint bytes with alignment align from wksp
+   and records its location in the pod at path (formatted). */
+
+static void *
+bench_alloc( fd_wksp_t *  wksp,
+             uchar *      pod,
+             ulong        align,
+             ulong        footprint,
+             char const * fmt,
+             ulong        idx ) {
+  char path[ 128 ];
+  char gaddr[ FD_WKSP_CSTR_MAX ];
+  void * laddr = fd_wksp_alloc_laddr( wksp, align, footprint );
+  if( FD_UNLIKELY( !laddr ) ) FD_LOG_ERR(( "fd_wksp_alloc_laddr failed (increase --page-cnt)" ));
+  if( FD_UNLIKELY( !fd_pod_insert_cstr( pod, fd_cstr_printf( path, 128UL, NULL, fmt, idx ), fd_wksp_cstr_laddr( laddr, gaddr ) ) ) )
+    FD_LOG_ERR(( "fd_pod_insert_cstr failed" ));
+  return laddr;
+}
+
+static fd_cnc_t *
+bench_cnc( fd_wksp_t *  wksp,
+           uchar *      pod,
+           char const * fmt,
+           ulong        idx ) {
+  void * mem = bench_alloc( wksp, pod, fd_cnc_align(), fd_cnc_footprint( BENCH_CNC_APP_SZ ), fmt, idx );
+  fd_cnc_t * cnc = fd_cnc_join( fd_cnc_new( mem, BENCH_CNC_APP_SZ, 0UL, fd_tickcount() ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+  memset( fd_cnc_app_laddr( cnc ), 0, BENCH_CNC_APP_SZ );
+  return cnc;
+}
+
+static fd_frag_meta_t *
+bench_mcache( fd_wksp_t *  wksp,
+              uchar *      pod,
+              ulong        depth,
+              ulong        app_sz,
+              char const * fmt,
+              ulong        idx ) {
+  void * mem = bench_alloc( wksp, pod, fd_mcache_align(), fd_mcache_footprint( depth, app_sz ), fmt, idx );
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( mem, depth, app_sz, 0UL ) );
+  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  return mcache;
+}
+
+static uchar *
+bench_dcache( fd_wksp_t *  wksp,
+              uchar *      pod,
+              ulong        mtu,
+              ulong        depth,
+              ulong        burst,
+              int          compact,
+              char const * fmt,
+              ulong        idx ) {
+  ulong data_sz = fd_dcache_req_data_sz( mtu, depth, burst, compact );
+  void * mem = bench_alloc( wksp, pod, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ), fmt, idx );
+  uchar * dcache = fd_dcache_join( fd_dcache_new( mem, data_sz, 0UL ) );
+  if( FD_UNLIKELY( !dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+  return dcache;
+}
+
+static fd_dcache_hold_t *
+bench_hold( fd_wksp_t *  wksp,
+            uchar *      pod,
+            ulong        slot_cnt,
+            ulong        depth,
+            char const * fmt,
+            ulong        idx ) {
+  void * mem = bench_alloc( wksp, pod, fd_dcache_hold_align(), fd_dcache_hold_footprint( slot_cnt ), fmt, idx );
+  fd_dcache_hold_t * hold = fd_dcache_hold_join( fd_dcache_hold_new( mem, slot_cnt, depth, 1UL, 0UL ) );
+  if( FD_UNLIKELY( !hold ) ) FD_LOG_ERR(( "fd_dcache_hold_join failed" ));
+  return hold;
+}
+
+static ulong *
+bench_fseq( fd_wksp_t *  wksp,
+            uchar *      pod,
+            char const * fmt,
+            ulong        idx ) {
+  void * mem = bench_alloc( wksp, pod, fd_fseq_align(), fd_fseq_footprint(), fmt, idx );
+  ulong * fseq = fd_fseq_join( fd_fseq_new( mem, 0UL ) );
+  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  return fseq;
+}
+
+static void
+bench_tcache( fd_wksp_t *  wksp,
+              uchar *      pod,
+              ulong        depth,
+              char const * fmt,
+              ulong        idx ) {
+  void * mem = bench_alloc( wksp, pod, fd_tcache_align(), fd_tcache_footprint( depth, 0UL ), fmt, idx );
+  if( FD_UNLIKELY( !fd_tcache_new( mem, depth, 0UL ) ) ) FD_LOG_ERR(( "fd_tcache_new failed" ));
+}
+
+/* snap_t is a snapshot of the diagnostics the summary is computed
+   from. */
+
+struct snap {
+  long  ts;
+  ulong load_diag  [ BENCH_DIAG_CNT ]; /* Summed over load tiles */
+  ulong verify_diag[ BENCH_DIAG_CNT ]; /* Summed over verify tiles */
+  ulong verify_in_pub_cnt;             /* Transactions that passed verify */
+  ulong verify_in_filt_cnt;            /* Transactions filtered by verify */
+  ulong pack_diag  [ BENCH_DIAG_CNT ];
+  ulong dedup_pub_cnt;                 /* Transactions that passed dedup */
+  ulong lat[ FD_FSEQ_LAT_BUCKET_CNT ]; /* tsorig to pack latency histogram */
+};
+
+typedef struct snap snap_t;
+
+static void
+snap( snap_t *    s,
+      ulong       verify_cnt,
+      fd_cnc_t ** load_cnc,
+      fd_cnc_t ** verify_cnc,
+      ulong **    verify_in_fseq,
+      fd_cnc_t *  pack_cnc,
+      ulong *     dedup_fseq ) {
+  memset( s, 0, sizeof(snap_t) );
+  FD_COMPILER_MFENCE();
+  s->ts = fd_tickcount();
+  for( ulong verify_idx=0UL; verify_idx<verify_cnt; verify_idx++ ) {
+    ulong const * load_diag   = (ulong const *)fd_cnc_app_laddr_const( load_cnc  [ verify_idx ] );
+    ulong const * verify_diag = (ulong const *)fd_cnc_app_laddr_const( verify_cnc[ verify_idx ] );
+    ulong const * in_diag     = (ulong const *)fd_fseq_app_laddr_const( verify_in_fseq[ verify_idx ] );
+    for( ulong idx=0UL; idx<BENCH_DIAG_CNT; idx++ ) {
+      s->load_diag  [ idx ] += load_diag  [ idx ];
+      s->verify_diag[ idx ] += verify_diag[ idx ];
+    }
+    s->verify_in_pub_cnt  += in_diag[ FD_FSEQ_DIAG_PUB_CNT  ];
+    s->verify_in_filt_cnt += in_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+  }
+  ulong const * pack_diag = (ulong const *)fd_cnc_app_laddr_const( pack_cnc );
+  for( ulong idx=0UL; idx<BENCH_DIAG_CNT; idx++ ) s->pack_diag[ idx ] = pack_diag[ idx ];
+  ulong const * dedup_diag = (ulong const *)fd_fseq_app_laddr_const( dedup_fseq );
+  s->dedup_pub_cnt = dedup_diag[ FD_FSEQ_DIAG_PUB_CNT ];
+  for( ulong idx=0UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) s->lat[ idx ] = dedup_diag[ FD_FSEQ_DIAG_LAT_ORIG+idx ];
+  FD_COMPILER_MFENCE();
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",      NULL, "gigantic"                 );
+  ulong        page_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",     NULL, 0UL                        ); /* 0 <> auto */
+  ulong        numa_idx      = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",     NULL, fd_shmem_numa_idx( 0UL )   );
+  ulong        verify_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--verify-cnt",   NULL, 1UL                        );
+  ulong        shard_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-cnt",    NULL, 0UL                        );
+  ulong        depth         = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth",        NULL, 8192UL                     );
+  ulong        tcache_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-depth", NULL, 4194302UL                  );
+  ulong        txn_max       = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-max",      NULL, 4096UL                     );
+  ulong        lane_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--lane-cnt",     NULL, 4UL                        );
+  ulong        mblk_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--microblock-max", NULL, 32UL                     );
+  ulong        bstore_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--bstore-depth", NULL, 1024UL                     );
+  float        pps           = fd_env_strip_cmdline_float( &argc, &argv, "--pps",          NULL, 0.f                        ); /* per load tile, 0 <> unlimited */
+  ulong        pool_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--pool-cnt",     NULL, 4096UL                     );
+  ulong        sig_cnt_min   = fd_env_strip_cmdline_ulong( &argc, &argv, "--sig-cnt-min",  NULL, 1UL                        );
+  ulong        sig_cnt_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--sig-cnt-max",  NULL, 1UL                        );
+  float        v0_frac       = fd_env_strip_cmdline_float( &argc, &argv, "--v0-frac",      NULL, 0.5f                       );
+  ulong        write_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--write-cnt",    NULL, 2UL                        );
+  ulong        read_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--read-cnt",     NULL, 2UL                        );
+  ulong        hot_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--hot-cnt",      NULL, 16UL                       );
+  float        hot_frac      = fd_env_strip_cmdline_float( &argc, &argv, "--hot-frac",     NULL, 0.25f                      );
+  float        dup_frac      = fd_env_strip_cmdline_float( &argc, &argv, "--dup-frac",     NULL, 0.01f                      );
+  ulong        dup_age_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--dup-age-max",  NULL, 1024UL                     );
+  float        errsv_frac    = fd_env_strip_cmdline_float( &argc, &argv, "--errsv-frac",   NULL, 1e-3f                      );
+  long         warmup        = (long)fd_env_strip_cmdline_double( &argc, &argv, "--warmup",   NULL, 1e9  );
+  long         duration      = (long)fd_env_strip_cmdline_double( &argc, &argv, "--duration", NULL, 10e9 );
+  uint         seed          = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",         NULL, 1234U                      );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !((1UL<=verify_cnt) & (verify_cnt<=BENCH_VERIFY_MAX)) ) ) FD_LOG_ERR(( "--verify-cnt should be in [1,%lu]", BENCH_VERIFY_MAX ));
+  if( FD_UNLIKELY( shard_cnt>BENCH_SHARD_MAX ) ) FD_LOG_ERR(( "--shard-cnt should be at most %lu", BENCH_SHARD_MAX ));
+  if( FD_UNLIKELY( shard_cnt && (tcache_depth<shard_cnt) ) ) FD_LOG_ERR(( "--tcache-depth too small for --shard-cnt" ));
+  if( FD_UNLIKELY( (warmup<0L) | (duration<=0L) ) ) FD_LOG_ERR(( "--warmup should be non-negative and --duration positive" ));
+
+  ulong tile_cnt = 3UL + verify_cnt + shard_cnt + verify_cnt; /* main, pack, dedup, verify, shards, loads */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "at least %lu tiles required for this config (use --tile-cpus)", tile_cnt ));
+  if( FD_UNLIKELY( fd_tile_cnt()>tile_cnt ) ) FD_LOG_WARNING(( "only %lu tiles required for this config", tile_cnt ));
+
+  /* Size the workspace for the configuration.  The per verify load
+     pool estimate covers the default load key_cnt.  Allocations are
+     padded generously for alignment and wksp partition overheads. */
+
+  ulong   slot_max   = 1024UL;
+  ulong   shard_depth = shard_cnt ? tcache_depth / shard_cnt : 0UL;
+  ulong   pad        = 16384UL;
+  ulong   cnc_sz     = fd_cnc_footprint( BENCH_CNC_APP_SZ ) + pad;
+  ulong   fseq_sz    = fd_fseq_footprint() + pad;
+  ulong   mcache_sz  = fd_mcache_footprint( depth, 0UL ) + pad;
+  ulong   pack_sz    = fd_pack_footprint( txn_max, lane_cnt, mblk_max );
+  if( FD_UNLIKELY( !pack_sz ) ) FD_LOG_ERR(( "bad --txn-max, --lane-cnt and/or --microblock-max" ));
+  ulong   pin_max    = txn_max + lane_cnt*mblk_max + 1UL; /* Worst case pack pins in any one verify dcache (see fd_frank_init) */
+  ulong   slot_cnt   = depth + 1UL + pin_max;
+  if( FD_UNLIKELY( !fd_tcache_footprint( tcache_depth, 0UL ) ) ) FD_LOG_ERR(( "bad --tcache-depth" ));
+  if( FD_UNLIKELY( !fd_mcache_footprint( depth, 0UL ) ) ) FD_LOG_ERR(( "bad --depth" ));
+  if( FD_UNLIKELY( !fd_mcache_footprint( bstore_depth, fd_bstore_footprint( slot_max ) ) ) ) FD_LOG_ERR(( "bad --bstore-depth" ));
+
+  ulong wksp_sz = BENCH_POD_MAX + pad
+                + cnc_sz + fd_mcache_footprint( bstore_depth, fd_bstore_footprint( slot_max ) ) + pad   /* pack */
+                + fd_dcache_footprint( fd_dcache_req_data_sz( FD_FRANK_ENTRY_MTU( mblk_max ), bstore_depth, 1UL, 1 ), 0UL ) + pad
+                + pack_sz + pad
+                + cnc_sz + mcache_sz + fseq_sz                                                           /* dedup */
+                + (shard_cnt ? 0UL : (fd_tcache_footprint( tcache_depth, 0UL ) + pad))
+                + shard_cnt*( cnc_sz + mcache_sz + fseq_sz + fd_tcache_footprint( shard_depth, 0UL ) + pad )
+                + verify_cnt*( cnc_sz + mcache_sz + fseq_sz*fd_ulong_max( shard_cnt, 1UL )               /* verify */
+                             + fd_dcache_footprint( fd_dcache_req_data_sz( FD_FRANK_VERIFY_MTU, depth, 1UL+pin_max, 0 ), 0UL ) + pad
+                             + fd_dcache_hold_footprint( slot_cnt ) + pad
+                             + mcache_sz + fseq_sz                                                       /* verify in */
+                             + fd_dcache_footprint( fd_dcache_req_data_sz( FD_FRANK_TXN_PAYLOAD_MAX, depth, 1UL, 1 ), 0UL ) + pad
+                             + cnc_sz + pool_cnt*(FD_TXN_MTU+64UL) + 1024UL*64UL + pad );                /* load */
+  wksp_sz += wksp_sz/16UL + (16UL<<20);
+  if( !page_cnt ) page_cnt = (wksp_sz + page_sz - 1UL) / page_sz;
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), BENCH_NAME, 0UL );
+  if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "fd_wksp_new_anonymous failed" ));
+
+  /* Create the configuration pod and IPC objects (mirrors
+     fd_frank_init) */
+
+  FD_LOG_NOTICE(( "Creating configuration" ));
+
+  void * pod_mem = fd_wksp_alloc_laddr( wksp, FD_POD_ALIGN, FD_POD_FOOTPRINT( BENCH_POD_MAX ) );
+  if( FD_UNLIKELY( !pod_mem ) ) FD_LOG_ERR(( "fd_wksp_alloc_laddr failed" ));
+  uchar * pod = fd_pod_join( fd_pod_new( pod_mem, BENCH_POD_MAX ) );
+  if( FD_UNLIKELY( !pod ) ) FD_LOG_ERR(( "fd_pod_join failed" ));
+
+  fd_cnc_t * pack_cnc = bench_cnc( wksp, pod, BENCH_NAME ".pack.cnc", 0UL );
+  bench_mcache( wksp, pod, bstore_depth, fd_bstore_footprint( slot_max ), BENCH_NAME ".pack.mcache", 0UL );
+  bench_dcache( wksp, pod, FD_FRANK_ENTRY_MTU( mblk_max ), bstore_depth, 1UL, 1, BENCH_NAME ".pack.dcache", 0UL );
+  int ok = 1;
+  ok &= !!fd_pod_insert_ulong( pod, BENCH_NAME ".pack.txn_max",        txn_max  );
+  ok &= !!fd_pod_insert_ulong( pod, BENCH_NAME ".pack.lane_cnt",       lane_cnt );
+  ok &= !!fd_pod_insert_ulong( pod, BENCH_NAME ".pack.microblock_max", mblk_max );
+  ok &= !!fd_pod_insert_ulong( pod, BENCH_NAME ".pack.slot_max",       slot_max );
+
+  fd_cnc_t * dedup_cnc  = bench_cnc   ( wksp, pod,        BENCH_NAME ".dedup.cnc",    0UL );
+  /**/                    bench_mcache( wksp, pod, depth, 0UL, BENCH_NAME ".dedup.mcache", 0UL );
+  ulong *    dedup_fseq = bench_fseq  ( wksp, pod,        BENCH_NAME ".dedup.fseq",   0UL );
+  if( !shard_cnt ) bench_tcache( wksp, pod, tcache_depth, BENCH_NAME ".dedup.tcache", 0UL );
+
+  fd_cnc_t * shard_cnc[ BENCH_SHARD_MAX ];
+  for( ulong shard_idx=0UL; shard_idx<shard_cnt; shard_idx++ ) {
+    shard_cnc[ shard_idx ] = bench_cnc( wksp, pod, BENCH_NAME ".dedup.shard.s%lu.cnc", shard_idx );
+    bench_tcache( wksp, pod, shard_depth, BENCH_NAME ".dedup.shard.s%lu.tcache", shard_idx );
+    bench_mcache( wksp, pod, depth, 0UL,  BENCH_NAME ".dedup.shard.s%lu.mcache", shard_idx );
+    bench_fseq  ( wksp, pod,              BENCH_NAME ".dedup.shard.s%lu.fseq",   shard_idx );
+  }
+
+  fd_cnc_t * verify_cnc    [ BENCH_VERIFY_MAX ];
+  ulong *    verify_in_fseq[ BENCH_VERIFY_MAX ];
+  fd_cnc_t * load_cnc      [ BENCH_VERIFY_MAX ];
+  for( ulong verify_idx=0UL; verify_idx<verify_cnt; verify_idx++ ) {
+    verify_cnc[ verify_idx ] = bench_cnc( wksp, pod, BENCH_NAME ".verify.v%lu.cnc", verify_idx );
+    bench_mcache( wksp, pod, depth, 0UL,                BENCH_NAME ".verify.v%lu.mcache", verify_idx );
+    bench_dcache( wksp, pod, FD_FRANK_VERIFY_MTU, depth, 1UL+pin_max, 0, BENCH_NAME ".verify.v%lu.dcache", verify_idx );
+    bench_hold  ( wksp, pod, slot_cnt, depth,                          BENCH_NAME ".verify.v%lu.hold",   verify_idx );
+    if( !shard_cnt ) bench_fseq( wksp, pod, BENCH_NAME ".verify.v%lu.fseq", verify_idx );
+    for( ulong shard_idx=0UL; shard_idx<shard_cnt; shard_idx++ ) {
+      char fmt[ 128 ];
+      bench_fseq( wksp, pod, fd_cstr_printf( fmt, 128UL, NULL, BENCH_NAME ".verify.v%%lu.shard_fseq.s%lu", shard_idx ), verify_idx );
+    }
+
+    bench_mcache( wksp, pod, depth, 0UL,                     BENCH_NAME ".verify.v%lu.in.mcache", verify_idx );
+    bench_dcache( wksp, pod, FD_FRANK_TXN_PAYLOAD_MAX, depth, 1UL, 1, BENCH_NAME ".verify.v%lu.in.dcache", verify_idx );
+    verify_in_fseq[ verify_idx ] = bench_fseq( wksp, pod, BENCH_NAME ".verify.v%lu.in.fseq", verify_idx );
+
+    load_cnc[ verify_idx ] = bench_cnc( wksp, pod, BENCH_NAME ".verify.v%lu.load.cnc", verify_idx );
+    char path[ 128 ];
+#   define LOAD_INSERT( type, key, val ) \
+    ok &= !!fd_pod_insert_##type( pod, fd_cstr_printf( path, 128UL, NULL, BENCH_NAME ".verify.v%lu.load." key, verify_idx ), (val) )
+    LOAD_INSERT( float, "pps",         pps         );
+    LOAD_INSERT( ulong, "pool_cnt",    pool_cnt    );
+    LOAD_INSERT( ulong, "sig_cnt_min", sig_cnt_min );
+    LOAD_INSERT( ulong, "sig_cnt_max", sig_cnt_max );
+    LOAD_INSERT( float, "v0_frac",     v0_frac     );
+    LOAD_INSERT( ulong, "write_cnt",   write_cnt   );
+    LOAD_INSERT( ulong, "read_cnt",    read_cnt    );
+    LOAD_INSERT( ulong, "hot_cnt",     hot_cnt     );
+    LOAD_INSERT( float, "hot_frac",    hot_frac    );
+    LOAD_INSERT( float, "dup_frac",    dup_frac    );
+    LOAD_INSERT( ulong, "dup_age_max", dup_age_max );
+    LOAD_INSERT( float, "errsv_frac",  errsv_frac  );
+    LOAD_INSERT( uint,  "seed",        seed + (uint)verify_idx );
+#   undef LOAD_INSERT
+  }
+  if( FD_UNLIKELY( !ok ) ) FD_LOG_ERR(( "fd_pod_insert failed (increase BENCH_POD_MAX)" ));
+
+  char pod_gaddr[ FD_WKSP_CSTR_MAX ];
+  if( FD_UNLIKELY( !fd_wksp_cstr_laddr( pod, pod_gaddr ) ) ) FD_LOG_ERR(( "fd_wksp_cstr_laddr failed" ));
+  char const * cfg_path = BENCH_NAME;
+
+  /* Boot the tiles (same order as fd_frank_run.bin) */
+
+  char       tile_name[ 3UL + 2UL*BENCH_VERIFY_MAX + BENCH_SHARD_MAX ][ 16 ];
+  fd_cnc_t * tile_cnc [ 3UL + 2UL*BENCH_VERIFY_MAX + BENCH_SHARD_MAX ];
+  fd_tile_task_t tile_task[ 3UL + 2UL*BENCH_VERIFY_MAX + BENCH_SHARD_MAX ];
+  do {
+    ulong tile_idx = 1UL;
+    strcpy( tile_name[ tile_idx ], "pack"  ); tile_cnc[ tile_idx ] = pack_cnc;  tile_task[ tile_idx ] = fd_frank_pack_task;  tile_idx++;
+    strcpy( tile_name[ tile_idx ], "dedup" ); tile_cnc[ tile_idx ] = dedup_cnc; tile_task[ tile_idx ] = fd_frank_dedup_task; tile_idx++;
+    for( ulong verify_idx=0UL; verify_idx<verify_cnt; verify_idx++ ) {
+      fd_cstr_printf( tile_name[ tile_idx ], 16UL, NULL, "v%lu", verify_idx );
+      tile_cnc [ tile_idx ] = verify_cnc[ verify_idx ];
+      tile_task[ tile_idx ] = fd_frank_verify_task;
+      tile_idx++;
+    }
+    for( ulong shard_idx=0UL; shard_idx<shard_cnt; shard_idx++ ) {
+      fd_cstr_printf( tile_name[ tile_idx ], 16UL, NULL, "s%lu", shard_idx );
+      tile_cnc [ tile_idx ] = shard_cnc[ shard_idx ];
+      tile_task[ tile_idx ] = fd_frank_dedup_shard_task;
+      tile_idx++;
+    }
+    for( ulong verify_idx=0UL; verify_idx<verify_cnt; verify_idx++ ) {
+      fd_cstr_printf( tile_name[ tile_idx ], 16UL, NULL, "v%lu", verify_idx ); /* The load task is told which verify it feeds */
+      tile_cnc [ tile_idx ] = load_cnc[ verify_idx ];
+      tile_task[ tile_idx ] = fd_frank_load_task;
+      tile_idx++;
+    }
+  } while(0);
+
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) {
+    FD_LOG_NOTICE(( "booting tile %lu (%s)", tile_idx, tile_name[ tile_idx ] ));
+    char * task_argv[3];
+    task_argv[0] = tile_name[ tile_idx ];
+    task_argv[1] = pod_gaddr;
+    task_argv[2] = (char *)cfg_path;
+    if( FD_UNLIKELY( !fd_tile_exec_new( tile_idx, tile_task[ tile_idx ], 0, task_argv ) ) ) FD_LOG_ERR(( "fd_tile_exec_new failed" ));
+    if( FD_UNLIKELY( fd_cnc_wait( tile_cnc[ tile_idx ], FD_CNC_SIGNAL_BOOT, (long)60e9, NULL )!=FD_CNC_SIGNAL_RUN ) )
+      FD_LOG_ERR(( "tile failed to boot in a timely fashion" ));
+  }
+
+  /* Run for the requested duration, sampling the backpressure of each
+     stage's producers along the way */
+
+  FD_LOG_NOTICE(( "Running (--warmup %li ns, --duration %li ns)", warmup, duration ));
+  fd_log_sleep( warmup );
+
+  snap_t snap0[1]; snap_t snap1[1];
+  snap( snap0, verify_cnt, load_cnc, verify_cnc, verify_in_fseq, pack_cnc, dedup_fseq );
+
+  ulong sample_cnt   = 0UL;
+  ulong load_backp   = 0UL; /* Sum over samples of the number of backpressured tiles of the stage */
+  ulong verify_backp = 0UL;
+  ulong shard_backp  = 0UL;
+  ulong dedup_backp  = 0UL;
+  long  tstop        = fd_log_wallclock() + duration;
+  while( fd_log_wallclock()<tstop ) {
+    for( ulong verify_idx=0UL; verify_idx<verify_cnt; verify_idx++ ) {
+      load_backp   += FD_VOLATILE_CONST( ((ulong const *)fd_cnc_app_laddr_const( load_cnc  [ verify_idx ] ))[ FD_CNC_DIAG_IN_BACKP ] );
+      verify_backp += FD_VOLATILE_CONST( ((ulong const *)fd_cnc_app_laddr_const( verify_cnc[ verify_idx ] ))[ FD_CNC_DIAG_IN_BACKP ] );
+    }
+    for( ulong shard_idx=0UL; shard_idx<shard_cnt; shard_idx++ )
+      shard_backp += FD_VOLATILE_CONST( ((ulong const *)fd_cnc_app_laddr_const( shard_cnc[ shard_idx ] ))[ FD_CNC_DIAG_IN_BACKP ] );
+    dedup_backp += FD_VOLATILE_CONST( ((ulong const *)fd_cnc_app_laddr_const( dedup_cnc ))[ FD_CNC_DIAG_IN_BACKP ] );
+    sample_cnt++;
+    fd_log_sleep( (long)100e3 );
+  }
+
+  snap( snap1, verify_cnt, load_cnc, verify_cnc, verify_in_fseq, pack_cnc, dedup_fseq );
+
+  /* Halt the tiles (reverse order) */
+
+  for( ulong tile_idx=tile_cnt-1UL; tile_idx>0UL; tile_idx-- ) {
+    FD_LOG_NOTICE(( "halting tile %lu (%s)", tile_idx, tile_name[ tile_idx ] ));
+    if( FD_UNLIKELY( fd_cnc_open( tile_cnc[ tile_idx ] ) ) ) FD_LOG_ERR(( "fd_cnc_open failed for tile %lu", tile_idx ));
+    fd_cnc_signal( tile_cnc[ tile_idx ], FD_CNC_SIGNAL_HALT );
+    fd_cnc_close ( tile_cnc[ tile_idx ] );
+    int ret;
+    if( FD_UNLIKELY( fd_tile_exec_delete( fd_tile_exec( tile_idx ), &ret ) ) ) FD_LOG_ERR(( "fd_tile_exec_delete failed" ));
+    if( FD_UNLIKELY( ret ) ) FD_LOG_ERR(( "unexpected ret (%i)", ret ));
+  }
+
+  /* Summarize */
+
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  double dt          = (double)(snap1->ts - snap0->ts) / (tick_per_ns*1e9); /* In s */
+  double samples     = (double)fd_ulong_max( sample_cnt, 1UL );
+
+# define RATE( field ) ((double)(snap1->field - snap0->field) / dt)
+
+  ulong lat[ FD_FSEQ_LAT_BUCKET_CNT ];
+  for( ulong idx=0UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) lat[ idx ] = snap1->lat[ idx ] - snap0->lat[ idx ];
+  static double const q[4] = { 0.5, 0.9, 0.99, 0.999 };
+  double lat_ns[4];
+  for( ulong idx=0UL; idx<4UL; idx++ ) {
+    ulong ticks = fd_fseq_lat_quantile( lat, q[ idx ] );
+    lat_ns[ idx ] = (ticks==ULONG_MAX) ? -1. : ((double)ticks / tick_per_ns);
+  }
+
+  /* Effective duplicate fraction seen downstream (deliberate duplicates
+     plus stale republications, see fd_frank_load.c) */
+
+  ulong  load_pub_cnt = snap1->load_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT ] - snap0->load_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT ];
+  double load_dup_eff = (double)( snap1->load_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   ] - snap0->load_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   ]
+                                + snap1->load_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT ] - snap0->load_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT ] )
+                      / (double)fd_ulong_max( load_pub_cnt, 1UL );
+
+  printf( "{\n" );
+  printf( "  \"config\": { \"verify_cnt\": %lu, \"shard_cnt\": %lu, \"depth\": %lu, \"txn_max\": %lu, \"lane_cnt\": %lu, "
+          "\"microblock_max\": %lu, \"pps\": %g, \"sig_cnt_min\": %lu, \"sig_cnt_max\": %lu, \"v0_frac\": %g, \"write_cnt\": %lu, "
+          "\"read_cnt\": %lu, \"hot_cnt\": %lu, \"hot_frac\": %g, \"dup_frac\": %g, \"errsv_frac\": %g },\n",
+          verify_cnt, shard_cnt, depth, txn_max, lane_cnt, mblk_max, (double)pps, sig_cnt_min, sig_cnt_max, (double)v0_frac,
+          write_cnt, read_cnt, hot_cnt, (double)hot_frac, (double)dup_frac, (double)errsv_frac );
+  printf( "  \"duration_s\": %.6f,\n", dt );
+  printf( "  \"load\": { \"pub_tps\": %.1f, \"pub_Bps\": %.1f, \"dup_tps\": %.1f, \"errsv_tps\": %.1f, \"stale_tps\": %.1f, \"sign_tps\": %.1f, \"dup_frac_eff\": %.4f, \"backp\": %.4f },\n",
+          RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT   ] ), RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_SZ    ] ),
+          RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   ] ), RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT ] ),
+          RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT ] ), RATE( load_diag[ FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT  ] ),
+          load_dup_eff,
+          (double)load_backp / (samples*(double)verify_cnt) );
+  printf( "  \"verify\": { \"pub_tps\": %.1f, \"filt_tps\": %.1f, \"ha_filt_tps\": %.1f, \"sv_filt_tps\": %.1f, \"backp\": %.4f },\n",
+          RATE( verify_in_pub_cnt ), RATE( verify_in_filt_cnt ),
+          RATE( verify_diag[ FD_FRANK_CNC_DIAG_HA_FILT_CNT ] ), RATE( verify_diag[ FD_FRANK_CNC_DIAG_SV_FILT_CNT ] ),
+          (double)verify_backp / (samples*(double)verify_cnt) );
+  if( shard_cnt ) printf( "  \"dedup_shard\": { \"backp\": %.4f },\n", (double)shard_backp / (samples*(double)shard_cnt) );
+  printf( "  \"dedup\": { \"pub_tps\": %.1f, \"backp\": %.4f },\n", RATE( dedup_pub_cnt ), (double)dedup_backp / samples );
+  printf( "  \"pack\": { \"txn_tps\": %.1f, \"microblock_ps\": %.1f, \"block_ps\": %.3f, \"drop_tps\": %.1f, \"pending_cnt\": %lu },\n",
+          RATE( pack_diag[ FD_FRANK_CNC_DIAG_PACK_TXN_CNT        ] ), RATE( pack_diag[ FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT ] ),
+          RATE( pack_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT      ] ), RATE( pack_diag[ FD_FRANK_CNC_DIAG_PACK_DROP_CNT       ] ),
+          snap1->pack_diag[ FD_FRANK_CNC_DIAG_PACK_PENDING_CNT ] );
+  printf( "  \"lat_ns\": { \"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f, \"p999\": %.0f }\n", lat_ns[0], lat_ns[1], lat_ns[2], lat_ns[3] );
+  printf( "}\n" );
+  fflush( stdout );
+
+# undef RATE
+
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "unsupported for this build target" ));
+  fd_halt();
+  return 1;
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "fd_frank.h"
+
+#if FD_HAS_FRANK
+
+/* fd_frank_ctl issues attach / detach commands to the inputs of a
+   running frank's dedup tile or dedup shard tiles (see fd_disco_in_cmd
+   in fd_disco_base.h).  E.g.:
+
+     fd_frank_ctl.bin [MON_ARGS] --tile dedup --cmd detach --in-idx 1
+     fd_frank_ctl.bin [MON_ARGS] --tile dedup --cmd attach --in-idx 1 --weight 4
+
+   detaches verify 1 from an unsharded dedup tile and then reattaches it
+   with a poll weight of 4.  Given an --mcache and --fseq (paths
+   relative to the instance config of a gaddr cstr in the same wksp as
+   the tile's cnc), attach binds the in slot to that mcache / fseq pair
+   first, e.g. an unbound slot reserved with in_spare:
+
+     fd_frank_ctl.bin [MON_ARGS] --tile dedup --cmd attach --in-idx 4 \
+       --mcache verify.v4.mcache --fseq verify.v4.fseq */
+
+/* fd_frank_ctl_gaddr maps the gaddr cstr at [cfg_path].[path] and
+   returns its gaddr in the wksp containing the cnc.  The mapping is
+   released before returning (the tile maps it on its own when the
+   command is processed). */
+
+static ulong
+fd_frank_ctl_gaddr( uchar const *    cfg_pod,
+                    char const *     cfg_path,
+                    char const *     path,
+                    fd_cnc_t const * cnc ) {
+  void * laddr = fd_wksp_pod_map( cfg_pod, path );
+  if( FD_UNLIKELY( !laddr ) ) FD_LOG_ERR(( "%s.%s not found", cfg_path, path ));
+
+  fd_wksp_t * wksp     = fd_wksp_containing( laddr );
+  fd_wksp_t * cnc_wksp = fd_wksp_containing( cnc   );
+  if( FD_UNLIKELY( !wksp || !cnc_wksp || strcmp( fd_wksp_name( wksp ), fd_wksp_name( cnc_wksp ) ) ) )
+    FD_LOG_ERR(( "%s.%s is not in the same wksp as the tile's cnc", cfg_path, path ));
+
+  ulong gaddr = fd_wksp_gaddr( wksp, laddr );
+  fd_wksp_pod_unmap( laddr );
+  return gaddr;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  /* Parse command line arguments */
+
+  char const * pod_gaddr   =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--pod",     NULL, NULL );
+  char const * cfg_path    =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--cfg",     NULL, NULL );
+  char const * tile_path   =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--tile",    NULL, NULL );
+  char const * cmd         =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--cmd",     NULL, NULL );
+  ulong        in_idx      =       fd_env_strip_cmdline_ulong ( &argc, &argv, "--in-idx",  NULL, ULONG_MAX );
+  ulong        weight      =       fd_env_strip_cmdline_ulong ( &argc, &argv, "--weight",  NULL, 1UL  );
+  char const * mcache_path =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--mcache",  NULL, NULL );
+  char const * fseq_path   =       fd_env_strip_cmdline_cstr  ( &argc, &argv, "--fseq",    NULL, NULL );
+  long         timeout     = (long)fd_env_strip_cmdline_double( &argc, &argv, "--timeout", NULL, 5e9  );
+
+  if( FD_UNLIKELY( !pod_gaddr            ) ) FD_LOG_ERR(( "--pod not specified"    ));
+  if( FD_UNLIKELY( !cfg_path             ) ) FD_LOG_ERR(( "--cfg not specified"    ));
+  if( FD_UNLIKELY( !tile_path            ) ) FD_LOG_ERR(( "--tile not specified"   ));
+  if( FD_UNLIKELY( !cmd                  ) ) FD_LOG_ERR(( "--cmd not specified"    ));
+  if( FD_UNLIKELY( in_idx==ULONG_MAX     ) ) FD_LOG_ERR(( "--in-idx not specified" ));
+  if( FD_UNLIKELY( !!mcache_path != !!fseq_path ) ) FD_LOG_ERR(( "--mcache and --fseq should be specified together" ));
+  if( FD_UNLIKELY( timeout<=0L           ) ) FD_LOG_ERR(( "--timeout should be positive" ));
+
+  ulong signal;
+  if(      !strcmp( cmd, "attach" ) ) signal = FD_DISCO_CNC_SIGNAL_ATTACH;
+  else if( !strcmp( cmd, "detach" ) ) signal = FD_DISCO_CNC_SIGNAL_DETACH;
+  else FD_LOG_ERR(( "--cmd should be attach or detach" ));
+  if( FD_UNLIKELY( (signal==FD_DISCO_CNC_SIGNAL_DETACH) & !!mcache_path ) ) FD_LOG_ERR(( "--mcache and --fseq are only used by attach" ));
+
+  if( FD_UNLIKELY( strcmp( tile_path, "dedup" ) && strncmp( tile_path, "dedup.shard.", 12UL ) ) )
+    FD_LOG_ERR(( "--tile should be dedup or dedup.shard.[shard name]" ));
+
+  /* Load up the configuration for this frank instance */
+
+  FD_LOG_INFO(( "using configuration in pod --pod %s at path --cfg %s", pod_gaddr, cfg_path ));
+
+  uchar const * pod     = fd_wksp_pod_attach( pod_gaddr );
+  uchar const * cfg_pod = fd_pod_query_subpod( pod, cfg_path );
+  if( FD_UNLIKELY( !cfg_pod ) ) FD_LOG_ERR(( "path not found" ));
+
+  uchar const * tile_pod = fd_pod_query_subpod( cfg_pod, tile_path );
+  if( FD_UNLIKELY( !tile_pod ) ) FD_LOG_ERR(( "%s.%s path not found", cfg_path, tile_path ));
+
+  FD_LOG_INFO(( "joining %s.%s.cnc", cfg_path, tile_path ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( tile_pod, "cnc" ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+
+  ulong mcache_gaddr = 0UL;
+  ulong fseq_gaddr   = 0UL;
+  if( mcache_path ) {
+    mcache_gaddr = fd_frank_ctl_gaddr( cfg_pod, cfg_path, mcache_path, cnc );
+    fseq_gaddr   = fd_frank_ctl_gaddr( cfg_pod, cfg_path, fseq_path,   cnc );
+  }
+
+  /* Issue the command */
+
+  FD_LOG_NOTICE(( "%s %s.%s in %lu", cmd, cfg_path, tile_path, in_idx ));
+  int err = fd_disco_in_cmd( cnc, signal, in_idx, weight, mcache_gaddr, fseq_gaddr, timeout );
+  if( FD_UNLIKELY( err ) ) FD_LOG_WARNING(( "%s failed (see the %s tile log for details)", cmd, tile_path ));
+  else                     FD_LOG_NOTICE (( "%s done", cmd ));
+
+  /* Clean up */
+
+  fd_wksp_pod_unmap( fd_cnc_leave( cnc ) );
+  fd_wksp_pod_detach( pod );
+  fd_halt();
+  return err;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_ERR(( "unsupported for this build target" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -2,6 +2,172 @@
 
 #if FD_HAS_FRANK
 
+/* fd_frank_dedup_join_verify joins the mcaches of all the verify tiles
+   and the fseqs used by a consumer of those mcaches to return flow
+   control credits to them.  If shard_name is NULL, the fseqs are at
+   verify.[verify name].fseq.  Otherwise, they are at
+   verify.[verify name].shard_fseq.[shard_name].  The poll weight of
+   each verify is at verify.[verify name].weight (1 if absent).
+   in_mcache, in_fseq and in_weight are indexed
+   [0,fd_pod_cnt_subpod( verify_pods )). */
+
+static void
+fd_frank_dedup_join_verify( char const *            cfg_path,
+                            uchar const *           verify_pods,
+                            char const *            shard_name,
+                            fd_frag_meta_t const ** in_mcache,
+                            ulong **                in_fseq,
+                            ulong *                 in_weight ) {
+  ulong in_idx = 0UL;
+  for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+    fd_pod_info_t info = fd_pod_iter_info( iter );
+    if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+    char const  * verify_name =                info.key;
+    uchar const * verify_pod  = (uchar const *)info.val;
+
+    FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
+    in_mcache[ in_idx ] = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
+    if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+    if( !shard_name ) {
+      FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
+      in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+    } else {
+      FD_LOG_INFO(( "joining %s.verify.%s.shard_fseq.%s", cfg_path, verify_name, shard_name ));
+      uchar const * shard_fseq_pod = fd_pod_query_subpod( verify_pod, "shard_fseq" );
+      if( FD_UNLIKELY( !shard_fseq_pod ) ) FD_LOG_ERR(( "%s.verify.%s.shard_fseq path not found", cfg_path, verify_name ));
+      in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( shard_fseq_pod, shard_name ) );
+    }
+    if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+
+    in_weight[ in_idx ] = fd_pod_query_ulong( verify_pod, "weight", 1UL );
+    FD_LOG_INFO(( "configuring poll weight (%s.verify.%s.weight %lu)", cfg_path, verify_name, in_weight[ in_idx ] ));
+
+    in_idx++;
+  }
+}
+
+/* fd_frank_dedup_in_spare returns the number of unbound in slots to
+   reserve for the tile described by tile_pod (at
+   [cfg_path].[tile_path]).  Such slots can be bound to a new in while
+   the tile runs with fd_disco_in_cmd (e.g. via fd_frank_ctl). */
+
+static ulong
+fd_frank_dedup_in_spare( char const *  cfg_path,
+                         char const *  tile_path,
+                         uchar const * tile_pod ) {
+  ulong in_spare = fd_pod_query_ulong( tile_pod, "in_spare", 0UL );
+  FD_LOG_INFO(( "reserving unbound in slots (%s.%s.in_spare %lu)", cfg_path, tile_path, in_spare ));
+  return in_spare;
+}
+
+/* fd_frank_dedup_run runs the tile described by tile_pod (at
+   [cfg_path].[tile_path]) over the in_cnt already joined ins, polled
+   with the given in_weight.  Unbound in slots (NULL mcache and fseq,
+   zero weight) can be bound while the tile runs.  If merge is zero,
+   the tile dedups the ins as dedup shard shard_idx of shard_cnt (use 0
+   and 1 for an unsharded dedup).  Otherwise, the ins are the outputs of
+   dedup shards and the tile just merges them with a mux.  The ins are
+   left on return. */
+
+static void
+fd_frank_dedup_run( char const *            cfg_path,
+                    char const *            tile_path,
+                    uchar const *           tile_pod,
+                    ulong                   in_cnt,
+                    fd_frag_meta_t const ** in_mcache,
+                    ulong **                in_fseq,
+                    ulong const *           in_weight,
+                    int                     merge,
+                    ulong                   shard_idx,
+                    ulong                   shard_cnt ) {
+
+  /* Join the IPC objects needed this tile instance */
+
+  FD_LOG_INFO(( "joining %s.%s.cnc", cfg_path, tile_path ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( tile_pod, "cnc" ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+  if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
+
+  fd_tcache_t * tcache = NULL;
+  if( !merge ) {
+    FD_LOG_INFO(( "joining %s.%s.tcache", cfg_path, tile_path ));
+    tcache = fd_tcache_join( fd_wksp_pod_map( tile_pod, "tcache" ) );
+    if( FD_UNLIKELY( !tcache ) ) FD_LOG_ERR(( "fd_tcache_join failed" ));
+  }
+
+  FD_LOG_INFO(( "joining %s.%s.mcache", cfg_path, tile_path ));
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( tile_pod, "mcache" ) );
+  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+  FD_LOG_INFO(( "joining %s.%s.fseq", cfg_path, tile_path ));
+  ulong * out_fseq = fd_fseq_join( fd_wksp_pod_map( tile_pod, "fseq" ) );
+  if( FD_UNLIKELY( !out_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+
+  /* Setup local objects used by this tile */
+
+  ulong cr_max = fd_pod_query_ulong( tile_pod, "cr_max", 0UL ); /*  0  <> pick reasonable default */
+  long  lazy   = fd_pod_query_long ( tile_pod, "lazy",   0L  ); /* <=0 <> pick reasonable default */
+  FD_LOG_INFO(( "configuring flow control (%s.%s.cr_max %lu %s.%s.lazy %li)", cfg_path, tile_path, cr_max, cfg_path, tile_path, lazy ));
+
+  int hot = 0;
+  if( !merge ) {
+    hot = fd_pod_query_int( tile_pod, "hot", 0 ); /* 0 <> no hot tcache */
+    FD_LOG_INFO(( "configuring hot tcache (%s.%s.hot %i)", cfg_path, tile_path, hot ));
+  }
+
+  fd_idle_t   _idle[ 1 ];
+  fd_idle_t * idle = NULL;
+  if( merge ) {
+    int idle_en = fd_pod_query_int( tile_pod, "idle", 0 ); /* 0 <> always poll */
+    FD_LOG_INFO(( "configuring idle policy (%s.%s.idle %i)", cfg_path, tile_path, idle_en ));
+    if( idle_en ) {
+      idle = fd_idle_join( fd_idle_new( _idle, -1L, -1L, -1L ) );
+      if( FD_UNLIKELY( !idle ) ) FD_LOG_ERR(( "fd_idle_join failed" ));
+    }
+  }
+
+  uint seed = fd_pod_query_uint( tile_pod, "seed", (uint)fd_tile_id() ); /* use app tile_id as default */
+  FD_LOG_INFO(( "creating rng (%s.%s.seed %u)", cfg_path, tile_path, seed ));
+  fd_rng_t _rng[ 1 ];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+  if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
+
+  FD_LOG_INFO(( "creating scratch" ));
+  ulong footprint = merge ? fd_mux_tile_scratch_footprint( in_cnt, 1UL ) : fd_dedup_tile_scratch_footprint( in_cnt, 1UL, hot );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "scratch footprint failed" ));
+  void * scratch = fd_alloca( FD_DEDUP_TILE_SCRATCH_ALIGN, footprint ); /* == FD_MUX_TILE_SCRATCH_ALIGN */
+  if( FD_UNLIKELY( !scratch ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  /* Start deduping */
+
+  FD_LOG_INFO(( "%s run", tile_path ));
+  int err;
+  if( !merge ) {
+    err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, in_weight, tcache, hot, shard_idx, shard_cnt, mcache, 1UL, &out_fseq,
+                         cr_max, lazy, rng, scratch );
+    if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
+  } else {
+    err = fd_mux_tile( cnc, in_cnt, in_mcache, in_fseq, in_weight, mcache, 1UL, &out_fseq, cr_max, lazy, idle, rng, scratch );
+    if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
+  }
+
+  /* Clean up */
+
+  FD_LOG_INFO(( "%s fini", tile_path ));
+  fd_rng_delete    ( fd_rng_leave   ( rng      ) );
+  if( idle ) fd_idle_delete( fd_idle_leave( idle ) );
+  fd_wksp_pod_unmap( fd_fseq_leave  ( out_fseq ) );
+  fd_wksp_pod_unmap( fd_mcache_leave( mcache   ) );
+  if( tcache ) fd_wksp_pod_unmap( fd_tcache_leave( tcache ) );
+  for( ulong in_idx=in_cnt; in_idx; in_idx-- ) {
+    if( !in_mcache[ in_idx-1UL ] ) continue; /* unbound slot */
+    fd_wksp_pod_unmap( fd_fseq_leave  ( in_fseq  [ in_idx-1UL ] ) );
+    fd_wksp_pod_unmap( fd_mcache_leave( in_mcache[ in_idx-1UL ] ) );
+  }
+  fd_wksp_pod_unmap( fd_cnc_leave( cnc ) );
+}
+
 int
 fd_frank_dedup_task( int     argc,
                      char ** argv ) {
@@ -21,17 +187,26 @@ fd_frank_dedup_task( int     argc,
   uchar const * cfg_pod = fd_pod_query_subpod( pod, cfg_path );
   if( FD_UNLIKELY( !cfg_pod ) ) FD_LOG_ERR(( "path not found" ));
 
-  FD_LOG_INFO(( "joining %s.dedup.cnc", cfg_path ));
-  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "dedup.cnc" ) );
-  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
-  if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
-  /* FIXME: CNC DIAG REGION? */
+  uchar const * dedup_pod = fd_pod_query_subpod( cfg_pod, "dedup" );
+  if( FD_UNLIKELY( !dedup_pod ) ) FD_LOG_ERR(( "%s.dedup path not found", cfg_path ));
+
+  /* If the dedup is sharded, the shards do the actual deduplication of
+     the verify outputs and this tile just merges the shard outputs
+     into a single sequenced stream for pack.  Otherwise, this tile
+     dedups the verify outputs directly. */
+
+  uchar const * shard_pods = fd_pod_query_subpod( dedup_pod, "shard" );
+  ulong shard_cnt = fd_pod_cnt_subpod( shard_pods );
+  FD_LOG_INFO(( "%lu dedup shards found", shard_cnt ));
 
   uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
-  ulong in_cnt = fd_pod_cnt_subpod( verify_pods );
-  FD_LOG_INFO(( "%lu verify found", in_cnt ));
+  ulong verify_cnt = fd_pod_cnt_subpod( verify_pods );
+  FD_LOG_INFO(( "%lu verify found", verify_cnt ));
 
-  /* Join the IPC objects needed this tile instance */
+  ulong bound_cnt = shard_cnt ? shard_cnt : verify_cnt;
+  ulong in_cnt    = bound_cnt + fd_frank_dedup_in_spare( cfg_path, "dedup", dedup_pod );
+
+  /* Join the ins of this tile instance */
 
   fd_frag_meta_t const ** in_mcache = (fd_frag_meta_t const **)
     fd_alloca( alignof(fd_frag_meta_t const *), sizeof(fd_frag_meta_t const *)*in_cnt );
@@ -40,72 +215,115 @@ fd_frank_dedup_task( int     argc,
   ulong ** in_fseq = (ulong **)fd_alloca( alignof(ulong *), sizeof(ulong *)*in_cnt );
   if( FD_UNLIKELY( !in_fseq ) ) FD_LOG_ERR(( "fd_alloca failed" ));
 
-  ulong in_idx = 0UL;
-  for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
-    fd_pod_info_t info = fd_pod_iter_info( iter );
-    if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
-    char const  * verify_name =                info.key;
-    uchar const * verify_pod  = (uchar const *)info.val;
+  ulong * in_weight = (ulong *)fd_alloca( alignof(ulong), sizeof(ulong)*in_cnt );
+  if( FD_UNLIKELY( !in_weight ) ) FD_LOG_ERR(( "fd_alloca failed" ));
 
-    FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
-    in_mcache[ in_idx ] = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
-    if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  for( ulong in_idx=bound_cnt; in_idx<in_cnt; in_idx++ ) {
+    in_mcache[ in_idx ] = NULL;
+    in_fseq  [ in_idx ] = NULL;
+    in_weight[ in_idx ] = 0UL;
+  }
 
-    FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-    in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
-    if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  if( !shard_cnt ) fd_frank_dedup_join_verify( cfg_path, verify_pods, NULL, in_mcache, in_fseq, in_weight );
+  else {
+    ulong in_idx = 0UL;
+    for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+      char const  * shard_name =                info.key;
+      uchar const * shard_pod  = (uchar const *)info.val;
 
-    in_idx++;
+      FD_LOG_INFO(( "joining %s.dedup.shard.%s.mcache", cfg_path, shard_name ));
+      in_mcache[ in_idx ] = fd_mcache_join( fd_wksp_pod_map( shard_pod, "mcache" ) );
+      if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+      FD_LOG_INFO(( "joining %s.dedup.shard.%s.fseq", cfg_path, shard_name ));
+      in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( shard_pod, "fseq" ) );
+      if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+
+      in_weight[ in_idx ] = fd_pod_query_ulong( shard_pod, "weight", 1UL );
+      FD_LOG_INFO(( "configuring poll weight (%s.dedup.shard.%s.weight %lu)", cfg_path, shard_name, in_weight[ in_idx ] ));
+
+      in_idx++;
+    }
   }
 
-  FD_LOG_INFO(( "joining %s.dedup.tcache", cfg_path ));
-  fd_tcache_t * tcache = fd_tcache_join( fd_wksp_pod_map( cfg_pod, "dedup.tcache" ) );
-  if( FD_UNLIKELY( !tcache ) ) FD_LOG_ERR(( "fd_tcache_join failed" ));
+  fd_frank_dedup_run( cfg_path, "dedup", dedup_pod, in_cnt, in_mcache, in_fseq, in_weight, !!shard_cnt, 0UL, 1UL );
 
-  FD_LOG_INFO(( "joining %s.dedup.mcache", cfg_path ));
-  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "dedup.mcache" ) );
-  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  fd_wksp_pod_detach( pod );
+  return 0;
+}
 
-  FD_LOG_INFO(( "joining %s.dedup.fseq", cfg_path ));
-  ulong * out_fseq = fd_fseq_join( fd_wksp_pod_map( cfg_pod, "dedup.fseq" ) );
-  if( FD_UNLIKELY( !out_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+int
+fd_frank_dedup_shard_task( int     argc,
+                           char ** argv ) {
+  (void)argc;
+  fd_log_thread_set( argv[0] );
+  char const * shard_name = argv[0];
+  FD_LOG_INFO(( "dedup.shard.%s init", shard_name ));
 
-  /* Setup local objects used by this tile */
+  /* Parse "command line" arguments */
 
-  ulong cr_max = fd_pod_query_ulong( cfg_pod, "dedup.cr_max", 0UL ); /*  0  <> pick reasonable default */
-  long  lazy   = fd_pod_query_long ( cfg_pod, "dedup.lazy",   0L  ); /* <=0 <> pick reasonable default */
-  FD_LOG_INFO(( "configuring flow control (%s.dedup.cr_max %lu %s.dedup.lazy %li)", cfg_path, cr_max, cfg_path, lazy ));
+  char const * pod_gaddr = argv[1];
+  char const * cfg_path  = argv[2];
 
-  uint seed = fd_pod_query_uint( cfg_pod, "dedup.seed", (uint)fd_tile_id() ); /* use app tile_id as default */
-  FD_LOG_INFO(( "creating rng (%s.dedup.seed %u)", cfg_path, seed ));
-  fd_rng_t _rng[ 1 ];
-  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
-  if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
+  /* Load up the configuration for this frank instance */
 
-  FD_LOG_INFO(( "creating scratch" ));
-  ulong footprint = fd_dedup_tile_scratch_footprint( in_cnt, 1UL );
-  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_dedup_tile_scratch_footprint failed" ));
-  void * scratch = fd_alloca( FD_DEDUP_TILE_SCRATCH_ALIGN, footprint );
-  if( FD_UNLIKELY( !scratch ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+  FD_LOG_INFO(( "using configuration in pod %s at path %s", pod_gaddr, cfg_path ));
+  uchar const * pod     = fd_wksp_pod_attach( pod_gaddr );
+  uchar const * cfg_pod = fd_pod_query_subpod( pod, cfg_path );
+  if( FD_UNLIKELY( !cfg_pod ) ) FD_LOG_ERR(( "path not found" ));
 
-  /* Start deduping */
+  uchar const * shard_pods = fd_pod_query_subpod( cfg_pod, "dedup.shard" );
+  if( FD_UNLIKELY( !shard_pods ) ) FD_LOG_ERR(( "%s.dedup.shard path not found", cfg_path ));
 
-  FD_LOG_INFO(( "dedup run" ));
-  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, mcache, 1UL, &out_fseq, cr_max, lazy, rng, scratch );
-  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
+  /* The index of a shard is the position of its subpod in the config */
 
-  /* Clean up */
+  ulong         shard_cnt = 0UL;
+  ulong         shard_idx = ULONG_MAX;
+  uchar const * shard_pod = NULL;
+  for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+    fd_pod_info_t info = fd_pod_iter_info( iter );
+    if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+    if( !strcmp( info.key, shard_name ) ) {
+      shard_idx = shard_cnt;
+      shard_pod = (uchar const *)info.val;
+    }
+    shard_cnt++;
+  }
+  if( FD_UNLIKELY( !shard_pod ) ) FD_LOG_ERR(( "%s.dedup.shard.%s path not found", cfg_path, shard_name ));
+  FD_LOG_INFO(( "dedup.shard.%s is shard %lu of %lu", shard_name, shard_idx, shard_cnt ));
 
-  FD_LOG_INFO(( "dedup fini" ));
-  fd_rng_delete    ( fd_rng_leave   ( rng      ) );
-  fd_wksp_pod_unmap( fd_fseq_leave  ( out_fseq ) );
-  fd_wksp_pod_unmap( fd_mcache_leave( mcache   ) );
-  fd_wksp_pod_unmap( fd_tcache_leave( tcache   ) );
-  for( ulong in_idx=in_cnt; in_idx; in_idx-- ) {
-    fd_wksp_pod_unmap( fd_fseq_leave  ( in_fseq  [ in_idx-1UL ] ) );
-    fd_wksp_pod_unmap( fd_mcache_leave( in_mcache[ in_idx-1UL ] ) );
+  char tile_path[ 128 ];
+  fd_cstr_printf( tile_path, 128UL, NULL, "dedup.shard.%s", shard_name );
+
+  uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
+  ulong bound_cnt = fd_pod_cnt_subpod( verify_pods );
+  FD_LOG_INFO(( "%lu verify found", bound_cnt ));
+  ulong in_cnt = bound_cnt + fd_frank_dedup_in_spare( cfg_path, tile_path, shard_pod );
+
+  /* Join the ins of this tile instance */
+
+  fd_frag_meta_t const ** in_mcache = (fd_frag_meta_t const **)
+    fd_alloca( alignof(fd_frag_meta_t const *), sizeof(fd_frag_meta_t const *)*in_cnt );
+  if( FD_UNLIKELY( !in_mcache ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  ulong ** in_fseq = (ulong **)fd_alloca( alignof(ulong *), sizeof(ulong *)*in_cnt );
+  if( FD_UNLIKELY( !in_fseq ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  ulong * in_weight = (ulong *)fd_alloca( alignof(ulong), sizeof(ulong)*in_cnt );
+  if( FD_UNLIKELY( !in_weight ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  for( ulong in_idx=bound_cnt; in_idx<in_cnt; in_idx++ ) {
+    in_mcache[ in_idx ] = NULL;
+    in_fseq  [ in_idx ] = NULL;
+    in_weight[ in_idx ] = 0UL;
   }
-  fd_wksp_pod_unmap( fd_cnc_leave( cnc ) );
+
+  fd_frank_dedup_join_verify( cfg_path, verify_pods, shard_name, in_mcache, in_fseq, in_weight );
+
+  fd_frank_dedup_run( cfg_path, tile_path, shard_pod, in_cnt, in_mcache, in_fseq, in_weight, 0, shard_idx, shard_cnt );
+
   fd_wksp_pod_detach( pod );
   return 0;
 }
@@ -120,5 +338,12 @@ fd_frank_dedup_task( int     argc,
   return 1;
 }
 
-#endif
+int
+fd_frank_dedup_shard_task( int     argc,
+                           char ** argv ) {
+  (void)argc; (void)argv;
+  FD_LOG_WARNING(( "unsupported for this build target" ));
+  return 1;
+}
 
+#endif
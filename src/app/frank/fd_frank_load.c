@@ -0,0 +1,580 @@
+#include "fd_frank.h"
+
+#if FD_HAS_FRANK
+
+/* A load tile publishes synthetic but valid (parsable, correctly
+   signed) transactions into a verify tile's in at a configurable rate
+   such that the whole pipeline can be exercised without a network.
+
+   Signing is much slower than publishing so transactions are drawn
+   from a pool of pool_cnt transactions signed at boot.  Each is
+   published fresh once and then resigned (with new accounts, compute
+   budget and a new nonce) when the tile has nothing better to do (i.e.
+   while waiting for flow control credits or for the next publish
+   time).  The most recent dup_age_max published transactions are kept
+   around such that they can be republished as duplicates.  If the tile
+   runs out of fresh transactions, it republishes stale ones (these
+   will be filtered by dedup).  Stale republications are duplicates
+   too, so the effective duplicate rate seen downstream is measured
+   over windows of FD_FRANK_LOAD_DUP_WIN publications, exported as the
+   LOAD_DUP_PPM cnc diagnostic and a warning is logged when it drifts
+   materially above dup_frac (i.e. pool_cnt is too small to be resigned
+   at pps on this core).
+
+   Each transaction is a legacy or V0 (without address table lookups)
+   transaction with sig_cnt signers (drawn from key_cnt keys, the first
+   signer is the fee payer), write_cnt writable and read_cnt readonly
+   non-signer accounts (each one of hot_cnt hot accounts with
+   probability hot_frac and a random cold account otherwise), compute
+   budget instructions with a random limit and price and one
+   instruction referencing all the accounts whose data is a random
+   nonce. */
+
+#define FD_FRANK_LOAD_SIG_MAX (16UL) /* Max signers per transaction */
+#define FD_FRANK_LOAD_ACCT_MAX (32UL) /* Max non-signer accounts per transaction */
+#define FD_FRANK_LOAD_DUP_WIN  (65536UL) /* Publications per effective duplicate rate window */
+
+/* The compute budget program's address (base58
+   ComputeBudget111111111111111111111111111111) and an arbitrary
+   program address for the nonce instruction. */
+
+static uchar const fd_frank_load_compute_budget_addr[ FD_TXN_ACCT_ADDR_SZ ] = {
+  0x03,0x06,0x46,0x6f,0xe5,0x21,0x17,0x32,0xff,0xec,0xad,0xba,0x72,0xc3,0x9b,0xe7,
+  0xbc,0x8c,0xe5,0xbb,0xc5,0xf7,0x12,0x6b,0x2c,0x43,0x9b,0x3a,0x40,0x00,0x00,0x00
+};
+
+static uchar const fd_frank_load_program_addr[ FD_TXN_ACCT_ADDR_SZ ] = {
+  0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64,
+  0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64,0x4c,0x6f,0x61,0x64
+};
+
+struct fd_frank_load_key {
+  uchar private_key[ 32 ];
+  uchar public_key [ 32 ];
+};
+
+typedef struct fd_frank_load_key fd_frank_load_key_t;
+
+struct fd_frank_load_txn {
+  ulong sz;        /* Payload size */
+  ulong nonce_off; /* Location of the nonce in the payload */
+  uchar payload[ FD_TXN_MTU ];
+};
+
+typedef struct fd_frank_load_txn fd_frank_load_txn_t;
+
+struct fd_frank_load_cfg {
+  ulong key_cnt;
+  ulong sig_cnt_min;
+  ulong sig_cnt_max;
+  ulong write_cnt;
+  ulong read_cnt;
+  ulong hot_cnt;
+  float hot_frac;
+  float v0_frac;
+  uchar blockhash[ FD_TXN_BLOCKHASH_SZ ];
+};
+
+typedef struct fd_frank_load_cfg fd_frank_load_cfg_t;
+
+/* fd_frank_load_txn_sz_max returns the size of the largest transaction
+   fd_frank_load_txn_gen can produce for the given cfg. */
+
+static ulong
+fd_frank_load_txn_sz_max( fd_frank_load_cfg_t const * cfg ) {
+  ulong acct_cnt = cfg->sig_cnt_max + cfg->write_cnt + cfg->read_cnt + 2UL;
+  return 1UL + FD_TXN_SIGNATURE_SZ*cfg->sig_cnt_max                   /* signatures */
+       + 1UL + 3UL + 1UL + FD_TXN_ACCT_ADDR_SZ*acct_cnt               /* version, header, accounts */
+       + FD_TXN_BLOCKHASH_SZ + 1UL                                    /* blockhash, instr_cnt */
+       + (3UL+5UL) + (3UL+9UL) + (1UL+1UL+(acct_cnt-2UL)+1UL+8UL)    /* instructions */
+       + 1UL;                                                         /* address table lookup cnt */
+}
+
+static void
+fd_frank_load_acct( uchar *                     a,
+                    fd_rng_t *                  rng,
+                    fd_frank_load_cfg_t const * cfg ) {
+  ulong idx = (fd_rng_float_c0( rng )<cfg->hot_frac) ? fd_rng_ulong_roll( rng, cfg->hot_cnt ) : (cfg->hot_cnt + fd_rng_ulong( rng ));
+  memset( a, 0, FD_TXN_ACCT_ADDR_SZ );
+  FD_STORE( ulong, a,      fd_ulong_hash( idx+1UL ) );
+  FD_STORE( ulong, a+24UL, idx+1UL );
+}
+
+/* fd_frank_load_txn_gen generates and signs a new random transaction
+   into t.  Assumes cfg is valid (in particular that the largest
+   transaction fits in FD_TXN_MTU). */
+
+static void
+fd_frank_load_txn_gen( fd_frank_load_txn_t *       t,
+                       fd_rng_t *                  rng,
+                       fd_frank_load_cfg_t const * cfg,
+                       fd_frank_load_key_t const * key,
+                       fd_sha512_t *               sha ) {
+
+  /* Pick distinct signers and non-signer accounts */
+
+  ulong sig_cnt = cfg->sig_cnt_min + fd_rng_ulong_roll( rng, cfg->sig_cnt_max - cfg->sig_cnt_min + 1UL );
+  ulong signer[ FD_FRANK_LOAD_SIG_MAX ];
+  for( ulong s=0UL; s<sig_cnt; s++ ) {
+    ulong k;
+    int   dup;
+    do {
+      k   = fd_rng_ulong_roll( rng, cfg->key_cnt );
+      dup = 0;
+      for( ulong r=0UL; r<s; r++ ) dup |= (signer[r]==k);
+    } while( dup );
+    signer[ s ] = k;
+  }
+
+  ulong acct_cnt = cfg->write_cnt + cfg->read_cnt;
+  uchar acct[ FD_FRANK_LOAD_ACCT_MAX ][ FD_TXN_ACCT_ADDR_SZ ];
+  for( ulong a=0UL; a<acct_cnt; a++ ) {
+    int dup;
+    do {
+      fd_frank_load_acct( acct[a], rng, cfg );
+      dup = 0;
+      for( ulong b=0UL; b<a; b++ ) dup |= !memcmp( acct[a], acct[b], FD_TXN_ACCT_ADDR_SZ );
+    } while( dup );
+  }
+
+  /* Lay out the transaction */
+
+  ulong addr_cnt = sig_cnt + acct_cnt + 2UL; /* signers, accounts, program, compute budget program */
+  int   v0       = fd_rng_float_c0( rng )<cfg->v0_frac;
+
+  uchar * buf = t->payload;
+  ulong   i   = 0UL;
+  buf[ i++ ] = (uchar)sig_cnt;
+  ulong sig_off = i;
+  i += FD_TXN_SIGNATURE_SZ*sig_cnt;
+  ulong msg_off = i;
+  if( v0 ) buf[ i++ ] = (uchar)0x80;
+  buf[ i++ ] = (uchar)sig_cnt;
+  buf[ i++ ] = (uchar)0;
+  buf[ i++ ] = (uchar)(cfg->read_cnt + 2UL);
+  buf[ i++ ] = (uchar)addr_cnt;
+  for( ulong s=0UL; s<sig_cnt;  s++ ) { fd_memcpy( buf+i, key[ signer[s] ].public_key, FD_TXN_ACCT_ADDR_SZ ); i += FD_TXN_ACCT_ADDR_SZ; }
+  for( ulong a=0UL; a<acct_cnt; a++ ) { fd_memcpy( buf+i, acct[a],                    FD_TXN_ACCT_ADDR_SZ ); i += FD_TXN_ACCT_ADDR_SZ; }
+  fd_memcpy( buf+i, fd_frank_load_program_addr,        FD_TXN_ACCT_ADDR_SZ ); i += FD_TXN_ACCT_ADDR_SZ;
+  fd_memcpy( buf+i, fd_frank_load_compute_budget_addr, FD_TXN_ACCT_ADDR_SZ ); i += FD_TXN_ACCT_ADDR_SZ;
+  fd_memcpy( buf+i, cfg->blockhash,                    FD_TXN_BLOCKHASH_SZ ); i += FD_TXN_BLOCKHASH_SZ;
+  buf[ i++ ] = (uchar)3;
+  buf[ i++ ] = (uchar)(addr_cnt-1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)5;
+  buf[ i++ ] = (uchar)2; FD_STORE( uint,  buf+i, 1000U + fd_rng_uint_roll( rng, 200000U ) ); i += 4UL;
+  buf[ i++ ] = (uchar)(addr_cnt-1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)9;
+  buf[ i++ ] = (uchar)3; FD_STORE( ulong, buf+i, fd_rng_ulong_roll( rng, 100000UL ) ); i += 8UL;
+  buf[ i++ ] = (uchar)(addr_cnt-2UL);
+  buf[ i++ ] = (uchar)(addr_cnt-2UL);
+  for( ulong a=0UL; a<addr_cnt-2UL; a++ ) buf[ i++ ] = (uchar)a;
+  buf[ i++ ] = (uchar)8;
+  ulong nonce_off = i;
+  FD_STORE( ulong, buf+i, fd_rng_ulong( rng ) ); i += 8UL;
+  if( v0 ) buf[ i++ ] = (uchar)0; /* No address table lookups */
+
+  /* Sign it */
+
+  for( ulong s=0UL; s<sig_cnt; s++ )
+    fd_ed25519_sign( buf + sig_off + s*FD_TXN_SIGNATURE_SZ, buf + msg_off, i - msg_off,
+                     key[ signer[s] ].public_key, key[ signer[s] ].private_key, sha );
+
+  t->sz        = i;
+  t->nonce_off = nonce_off;
+}
+
+int
+fd_frank_load_task( int     argc,
+                    char ** argv ) {
+  (void)argc;
+  char const * verify_name = argv[0];
+  char thread_name[ FD_LOG_NAME_MAX ];
+  fd_log_thread_set( fd_cstr_printf( thread_name, FD_LOG_NAME_MAX, NULL, "%s.load", verify_name ) );
+  FD_LOG_INFO(( "verify.%s.load init", verify_name ));
+
+  /* Parse "command line" arguments */
+
+  char const * pod_gaddr = argv[1];
+  char const * cfg_path  = argv[2];
+
+  /* Load up the configuration for this frank instance */
+
+  FD_LOG_INFO(( "using configuration in pod %s at path %s", pod_gaddr, cfg_path ));
+  uchar const * pod     = fd_wksp_pod_attach( pod_gaddr );
+  uchar const * cfg_pod = fd_pod_query_subpod( pod, cfg_path );
+  if( FD_UNLIKELY( !cfg_pod ) ) FD_LOG_ERR(( "path not found" ));
+
+  uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
+  if( FD_UNLIKELY( !verify_pods ) ) FD_LOG_ERR(( "%s.verify path not found", cfg_path ));
+
+  uchar const * verify_pod = fd_pod_query_subpod( verify_pods, verify_name );
+  if( FD_UNLIKELY( !verify_pod ) ) FD_LOG_ERR(( "%s.verify.%s path not found", cfg_path, verify_name ));
+
+  uchar const * load_pod = fd_pod_query_subpod( verify_pod, "load" );
+  if( FD_UNLIKELY( !load_pod ) ) FD_LOG_ERR(( "%s.verify.%s.load path not found", cfg_path, verify_name ));
+
+  uchar const * in_pod = fd_pod_query_subpod( verify_pod, "in" );
+  if( FD_UNLIKELY( !in_pod ) ) FD_LOG_ERR(( "%s.verify.%s.in path not found", cfg_path, verify_name ));
+
+  /* Join the IPC objects needed this tile instance */
+
+  FD_LOG_INFO(( "joining %s.verify.%s.load.cnc", cfg_path, verify_name ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( load_pod, "cnc" ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+  if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
+  ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  if( FD_UNLIKELY( !cnc_diag ) ) FD_LOG_ERR(( "fd_cnc_app_laddr failed" ));
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<(FD_FRANK_CNC_DIAG_LOAD_DUP_PPM+1UL)*sizeof(ulong) ) )
+    FD_LOG_ERR(( "cnc app sz too small for load diagnostics" ));
+
+  static fd_cnc_metric_t const cnc_metric[] = {
+    { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_FRANK_CNC_DIAG_IN_BACKP,       1U },
+    { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_BACKP_CNT,      1U },
+    { "pub_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_PUB_CNT,   1U },
+    { "pub_sz",    FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_PUB_SZ,    1U },
+    { "dup_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_DUP_CNT,   1U },
+    { "errsv_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT, 1U },
+    { "stale_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_STALE_CNT, 1U },
+    { "sign_cnt",  FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT,  1U },
+    { "dup_ppm",   FD_CNC_METRIC_TYPE_GAUGE,   FD_FRANK_CNC_DIAG_LOAD_DUP_PPM,   1U }
+  };
+  fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+  int in_backp = 1;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_IN_BACKP        ] ) = 1UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT       ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT    ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_SZ     ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT    ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT  ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT  ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT   ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_PPM    ] ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  FD_LOG_INFO(( "joining %s.verify.%s.in.mcache", cfg_path, verify_name ));
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( in_pod, "mcache" ) );
+  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  ulong   depth = fd_mcache_depth( mcache );
+  ulong * sync  = fd_mcache_seq_laddr( mcache );
+  ulong   seq   = fd_mcache_seq_query( sync );
+
+  FD_LOG_INFO(( "joining %s.verify.%s.in.dcache", cfg_path, verify_name ));
+  uchar * dcache = fd_dcache_join( fd_wksp_pod_map( in_pod, "dcache" ) );
+  if( FD_UNLIKELY( !dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+  fd_wksp_t * wksp = fd_wksp_containing( dcache ); /* chunks are referenced relative to the containing workspace */
+  if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "fd_wksp_containing failed" ));
+  if( FD_UNLIKELY( !fd_dcache_compact_is_safe( wksp, dcache, FD_FRANK_TXN_PAYLOAD_MAX, depth ) ) )
+    FD_LOG_ERR(( "%s.verify.%s.in.dcache too small for mtu %lu", cfg_path, verify_name, FD_FRANK_TXN_PAYLOAD_MAX ));
+  ulong   chunk0 = fd_dcache_compact_chunk0( wksp, dcache );
+  ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, FD_FRANK_TXN_PAYLOAD_MAX );
+  ulong   chunk  = chunk0;
+
+  FD_LOG_INFO(( "joining %s.verify.%s.in.fseq", cfg_path, verify_name ));
+  ulong * fseq = fd_fseq_join( fd_wksp_pod_map( in_pod, "fseq" ) );
+  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
+  if( FD_UNLIKELY( !fseq_diag ) ) FD_LOG_ERR(( "fd_fseq_app_laddr failed" ));
+  FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL; /* Managed by the fctl */
+
+  /* Setup local objects used by this tile */
+
+  FD_LOG_INFO(( "configuring flow control" ));
+  ulong cr_max = fd_pod_query_ulong( load_pod, "cr_max", 0UL );
+  long  lazy   = fd_pod_query_long ( load_pod, "lazy",   0L  );
+  FD_LOG_INFO(( "%s.verify.%s.load.cr_max %lu", cfg_path, verify_name, cr_max ));
+  FD_LOG_INFO(( "%s.verify.%s.load.lazy   %li", cfg_path, verify_name, lazy   ));
+
+  fd_fctl_t * fctl = fd_fctl_cfg_done( fd_fctl_cfg_rx_add( fd_fctl_join( fd_fctl_new( fd_alloca( FD_FCTL_ALIGN,
+                                                                                                  fd_fctl_footprint( 1UL ) ),
+                                                                                       1UL ) ),
+                                                           depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ),
+                                       1UL /*cr_burst*/, cr_max, 0UL, 0UL );
+  if( FD_UNLIKELY( !fctl ) ) FD_LOG_ERR(( "Unable to create flow control" ));
+  FD_LOG_INFO(( "using cr_burst %lu, cr_max %lu, cr_resume %lu, cr_refill %lu",
+                fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
+
+  ulong cr_avail = 0UL;
+
+  if( lazy<=0L ) lazy = fd_tempo_lazy_default( depth );
+  FD_LOG_INFO(( "using lazy %li ns", lazy ));
+  ulong async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+  if( FD_UNLIKELY( !async_min ) ) FD_LOG_ERR(( "bad lazy" ));
+
+  uint seed = fd_pod_query_uint( load_pod, "seed", (uint)fd_tile_id() ); /* use app tile_id as default */
+  FD_LOG_INFO(( "creating rng (%s.verify.%s.load.seed %u)", cfg_path, verify_name, seed ));
+  fd_rng_t _rng[ 1 ];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+  if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
+
+  fd_sha512_t _sha[1];
+  fd_sha512_t * sha = fd_sha512_join( fd_sha512_new( _sha ) );
+  if( FD_UNLIKELY( !sha ) ) FD_LOG_ERR(( "fd_sha512 join failed" ));
+
+  /* Configure the transaction mix */
+
+  fd_frank_load_cfg_t cfg[1];
+  cfg->key_cnt     = fd_pod_query_ulong( load_pod, "key_cnt",     1024UL );
+  cfg->sig_cnt_min = fd_pod_query_ulong( load_pod, "sig_cnt_min", 1UL    );
+  cfg->sig_cnt_max = fd_pod_query_ulong( load_pod, "sig_cnt_max", 1UL    );
+  cfg->write_cnt   = fd_pod_query_ulong( load_pod, "write_cnt",   2UL    );
+  cfg->read_cnt    = fd_pod_query_ulong( load_pod, "read_cnt",    2UL    );
+  cfg->hot_cnt     = fd_pod_query_ulong( load_pod, "hot_cnt",     16UL   );
+  cfg->hot_frac    = fd_pod_query_float( load_pod, "hot_frac",    0.25f  );
+  cfg->v0_frac     = fd_pod_query_float( load_pod, "v0_frac",     0.5f   );
+  for( ulong b=0UL; b<FD_TXN_BLOCKHASH_SZ; b++ ) cfg->blockhash[ b ] = fd_rng_uchar( rng );
+
+  ulong pool_cnt    = fd_pod_query_ulong( load_pod, "pool_cnt",    4096UL );
+  ulong dup_age_max = fd_pod_query_ulong( load_pod, "dup_age_max", 1024UL );
+  float dup_frac    = fd_pod_query_float( load_pod, "dup_frac",    0.01f  );
+  float errsv_frac  = fd_pod_query_float( load_pod, "errsv_frac",  1e-3f  );
+  float pps         = fd_pod_query_float( load_pod, "pps",         0.f    );
+
+  FD_LOG_INFO(( "%s.verify.%s.load: key_cnt %lu, sig_cnt_min %lu, sig_cnt_max %lu, write_cnt %lu, read_cnt %lu, hot_cnt %lu, "
+                "hot_frac %g, v0_frac %g, pool_cnt %lu, dup_age_max %lu, dup_frac %g, errsv_frac %g, pps %g",
+                cfg_path, verify_name, cfg->key_cnt, cfg->sig_cnt_min, cfg->sig_cnt_max, cfg->write_cnt, cfg->read_cnt,
+                cfg->hot_cnt, (double)cfg->hot_frac, (double)cfg->v0_frac, pool_cnt, dup_age_max, (double)dup_frac,
+                (double)errsv_frac, (double)pps ));
+
+  if( FD_UNLIKELY( !((1UL<=cfg->sig_cnt_min) & (cfg->sig_cnt_min<=cfg->sig_cnt_max) & (cfg->sig_cnt_max<=FD_FRANK_LOAD_SIG_MAX)) ) )
+    FD_LOG_ERR(( "bad sig_cnt_min / sig_cnt_max (should satisfy 1<=sig_cnt_min<=sig_cnt_max<=%lu)", FD_FRANK_LOAD_SIG_MAX ));
+  if( FD_UNLIKELY( cfg->key_cnt<cfg->sig_cnt_max ) ) FD_LOG_ERR(( "key_cnt should be at least sig_cnt_max" ));
+  if( FD_UNLIKELY( cfg->write_cnt+cfg->read_cnt>FD_FRANK_LOAD_ACCT_MAX ) )
+    FD_LOG_ERR(( "write_cnt + read_cnt should be at most %lu", FD_FRANK_LOAD_ACCT_MAX ));
+  if( FD_UNLIKELY( !cfg->hot_cnt ) ) FD_LOG_ERR(( "hot_cnt should be positive" ));
+  if( FD_UNLIKELY( fd_frank_load_txn_sz_max( cfg )>FD_FRANK_TXN_PAYLOAD_MAX ) )
+    FD_LOG_ERR(( "sig_cnt_max, write_cnt and read_cnt too large (transactions could be larger than %lu bytes)", FD_FRANK_TXN_PAYLOAD_MAX ));
+  if( FD_UNLIKELY( pool_cnt<=dup_age_max ) ) FD_LOG_ERR(( "pool_cnt should be larger than dup_age_max" ));
+  if( FD_UNLIKELY( pps<0.f ) ) FD_LOG_ERR(( "pps should be non-negative" ));
+
+  /* Create the keys and the initial pool of signed transactions */
+
+  FD_LOG_INFO(( "signing initial pool" ));
+  ulong key_footprint  = fd_ulong_align_up( cfg->key_cnt*sizeof(fd_frank_load_key_t), 128UL );
+  ulong pool_footprint = pool_cnt*sizeof(fd_frank_load_txn_t);
+  uchar * load_mem = (uchar *)fd_wksp_alloc_laddr( wksp, 128UL, key_footprint + pool_footprint );
+  if( FD_UNLIKELY( !load_mem ) ) FD_LOG_ERR(( "fd_wksp_alloc_laddr failed" ));
+  fd_frank_load_key_t * key  = (fd_frank_load_key_t *) load_mem;
+  fd_frank_load_txn_t * pool = (fd_frank_load_txn_t *)(load_mem + key_footprint);
+
+  for( ulong key_idx=0UL; key_idx<cfg->key_cnt; key_idx++ ) {
+    for( ulong b=0UL; b<32UL; b++ ) key[ key_idx ].private_key[ b ] = fd_rng_uchar( rng );
+    fd_ed25519_public_from_private( key[ key_idx ].public_key, key[ key_idx ].private_key, sha );
+  }
+
+  for( ulong pool_idx=0UL; pool_idx<pool_cnt; pool_idx++ ) fd_frank_load_txn_gen( pool + pool_idx, rng, cfg, key, sha );
+
+  /* Sanity check the generator */
+
+  do {
+    uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+    fd_txn_t * txn = (fd_txn_t *)txn_mem;
+    fd_frank_load_txn_t const * t = pool;
+    if( FD_UNLIKELY( !fd_txn_parse( t->payload, t->sz, txn, NULL ) ) ) FD_LOG_ERR(( "generated transaction did not parse" ));
+    if( FD_UNLIKELY( fd_ed25519_verify_batch_single_msg( t->payload + txn->message_off, t->sz - (ulong)txn->message_off,
+                                                         t->payload + txn->signature_off, t->payload + txn->acct_addr_off,
+                                                         sha, (ulong)txn->signature_cnt ) ) )
+      FD_LOG_ERR(( "generated transaction did not verify" ));
+  } while(0);
+
+  /* pub_nxt is the number of fresh transactions published so far and
+     sign_nxt is the number of transactions signed so far.  Fresh
+     transaction n is in pool[ n % pool_cnt ] and is ready to publish if
+     n<sign_nxt.  Resigning pool[ sign_nxt % pool_cnt ] overwrites fresh
+     transaction sign_nxt-pool_cnt, which is only allowed once that one
+     is older than the dup_age_max most recent publications. */
+
+  ulong pub_nxt  = 0UL;
+  ulong sign_nxt = pool_cnt;
+
+  ulong dup_thresh   = (ulong)(dup_frac  *(float)(1UL<<32)); /* Compared to 32-bit uniform randoms */
+  ulong errsv_thresh = (ulong)(errsv_frac*(float)(1UL<<32));
+
+  double tick_per_ns  = fd_tempo_tick_per_ns( NULL );
+  long   pub_interval = (pps>0.f) ? fd_long_max( (long)(tick_per_ns*1e9/(double)pps), 1L ) : 0L; /* In ticks, 0 <> no rate limit */
+  long   pub_slack    = 16L*pub_interval; /* Max burst when catching up after being backpressured */
+
+  ulong accum_pub_cnt   = 0UL;
+  ulong accum_pub_sz    = 0UL;
+  ulong accum_dup_cnt   = 0UL;
+  ulong accum_errsv_cnt = 0UL;
+  ulong accum_stale_cnt = 0UL;
+  ulong accum_sign_cnt  = pool_cnt;
+
+  /* win_* accumulate publications over the current effective duplicate
+     rate window.  The rate is considered to have drifted when stale
+     republications alone exceed a tenth of the configured duplicates
+     (any stale republication if dup_frac is zero). */
+
+  ulong win_pub_cnt   = 0UL;
+  ulong win_dup_cnt   = 0UL;
+  ulong win_stale_cnt = 0UL;
+  int   dup_drift     = 0;
+
+  /* Start generating */
+
+  FD_LOG_INFO(( "verify.%s.load run", verify_name ));
+
+  long now      = fd_tickcount();
+  long then     = now;            /* Do housekeeping on first iteration of run loop */
+  long pub_next = now;            /* Publish the first transaction immediately */
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Send synchronization info (and wake up any parked consumers) */
+      fd_mcache_seq_update( sync, seq );
+      fd_idle_wake( sync, seq );
+
+      /* Send diagnostic info */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT   ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_CNT   ] ) + accum_pub_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_SZ    ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_PUB_SZ    ] ) + accum_pub_sz;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_CNT   ] ) + accum_dup_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_ERRSV_CNT ] ) + accum_errsv_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_STALE_CNT ] ) + accum_stale_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT  ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_SIGN_CNT  ] ) + accum_sign_cnt;
+      FD_COMPILER_MFENCE();
+      win_pub_cnt   += accum_pub_cnt;
+      win_dup_cnt   += accum_dup_cnt;
+      win_stale_cnt += accum_stale_cnt;
+      accum_pub_cnt   = 0UL;
+      accum_pub_sz    = 0UL;
+      accum_dup_cnt   = 0UL;
+      accum_errsv_cnt = 0UL;
+      accum_stale_cnt = 0UL;
+      accum_sign_cnt  = 0UL;
+
+      /* Update the effective duplicate rate and check it for drift */
+      if( FD_UNLIKELY( win_pub_cnt>=FD_FRANK_LOAD_DUP_WIN ) ) {
+        double dup_eff = (double)(win_dup_cnt+win_stale_cnt) / (double)win_pub_cnt;
+        FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_LOAD_DUP_PPM ] ) = (ulong)(dup_eff*1e6 + 0.5);
+        int drift = ((double)win_stale_cnt > 0.1*(double)dup_frac*(double)win_pub_cnt);
+        if( FD_UNLIKELY( drift & !dup_drift ) )
+          FD_LOG_WARNING(( "verify.%s.load effective dup rate %g exceeds dup_frac %g (%lu of %lu publications stale); "
+                           "increase pool_cnt or decrease pps", verify_name, dup_eff, (double)dup_frac, win_stale_cnt, win_pub_cnt ));
+        else if( FD_UNLIKELY( (!drift) & dup_drift ) )
+          FD_LOG_INFO(( "verify.%s.load effective dup rate %g back in line with dup_frac %g", verify_name, dup_eff, (double)dup_frac ));
+        dup_drift     = drift;
+        win_pub_cnt   = 0UL;
+        win_dup_cnt   = 0UL;
+        win_stale_cnt = 0UL;
+      }
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_HALT ) ) FD_LOG_ERR(( "Unexpected signal" ));
+        break;
+      }
+
+      /* Receive flow control credits */
+      cr_avail = fd_fctl_tx_cr_update( fctl, cr_avail, seq );
+      if( FD_UNLIKELY( in_backp ) ) {
+        if( FD_LIKELY( cr_avail ) ) {
+          FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_IN_BACKP ] ) = 0UL;
+          in_backp = 0;
+        }
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured or it is not time to publish yet.
+       If so, use the time to resign a pool transaction (if there is
+       one that can be resigned). */
+
+    int backp = !cr_avail;
+    if( FD_UNLIKELY( backp | ((now-pub_next)<0L) ) ) {
+      if( FD_UNLIKELY( backp & !in_backp ) ) {
+        FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_IN_BACKP  ] ) = 1UL;
+        FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT ] )+1UL;
+        in_backp = 1;
+      }
+      if( FD_LIKELY( sign_nxt+dup_age_max+1UL<=pub_nxt+pool_cnt ) ) {
+        fd_frank_load_txn_gen( pool + (sign_nxt % pool_cnt), rng, cfg, key, sha );
+        sign_nxt++;
+        accum_sign_cnt++;
+      } else FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Pick the transaction to publish: a recently published one (a
+       duplicate), the next fresh one or, if we ran out of those, a
+       stale one. */
+
+    fd_frank_load_txn_t const * t;
+    ulong r = (ulong)fd_rng_uint( rng );
+    if( FD_UNLIKELY( (r<dup_thresh) & (pub_nxt>0UL) ) ) {
+      ulong age = fd_rng_ulong_roll( rng, fd_ulong_min( dup_age_max, pub_nxt ) );
+      t = pool + ((pub_nxt-1UL-age) % pool_cnt);
+      accum_dup_cnt++;
+    } else if( FD_LIKELY( pub_nxt<sign_nxt ) ) {
+      t = pool + (pub_nxt % pool_cnt);
+      pub_nxt++;
+    } else {
+      t = pool + (pub_nxt % pool_cnt);
+      accum_stale_cnt++;
+    }
+
+    /* Publish it (corrupting the nonce of the copy if this one should
+       fail signature verification) */
+
+    ulong   sz      = t->sz;
+    uchar * payload = (uchar *)fd_chunk_to_laddr( wksp, chunk );
+    fd_memcpy( payload, t->payload, sz );
+    if( FD_UNLIKELY( (ulong)fd_rng_uint( rng )<errsv_thresh ) ) {
+      payload[ t->nonce_off ] = (uchar)~payload[ t->nonce_off ];
+      accum_errsv_cnt++;
+    }
+
+    ulong sig = fd_ulong_load_8( payload + 1UL ); /* Least significant 64-bits of the first signature */
+    ulong ctl = fd_frag_meta_ctl( 0UL /*orig*/, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
+
+    now = fd_tickcount();
+    ulong tspub = fd_frag_meta_ts_comp( now );
+    fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tspub /*tsorig*/, tspub );
+
+    chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+    seq   = fd_seq_inc( seq, 1UL );
+    cr_avail--;
+
+    accum_pub_cnt++;
+    accum_pub_sz += sz;
+
+    if( pub_interval ) pub_next = fd_long_max( pub_next + pub_interval, now - pub_slack );
+  }
+
+  /* Clean up */
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+  FD_LOG_INFO(( "verify.%s.load fini", verify_name ));
+  fd_wksp_free_laddr( load_mem );
+  fd_sha512_delete ( fd_sha512_leave( sha  ) );
+  fd_rng_delete    ( fd_rng_leave   ( rng  ) );
+  fd_fctl_delete   ( fd_fctl_leave  ( fctl ) );
+  fd_wksp_pod_unmap( fd_fseq_leave  ( fseq   ) );
+  fd_wksp_pod_unmap( fd_dcache_leave( dcache ) );
+  fd_wksp_pod_unmap( fd_mcache_leave( mcache ) );
+  fd_wksp_pod_unmap( fd_cnc_leave   ( cnc    ) );
+  fd_wksp_pod_detach( pod );
+  return 0;
+}
+
+#else
+
+int
+fd_frank_load_task( int     argc,
+                    char ** argv ) {
+  (void)argc; (void)argv;
+  FD_LOG_WARNING(( "unsupported for this build target" ));
+  return 1;
+}
+
+#endif
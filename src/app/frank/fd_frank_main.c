@@ -63,7 +63,20 @@ main( int     argc,
   ulong verify_cnt = fd_pod_cnt_subpod( verify_pods );
   FD_LOG_NOTICE(( "%lu verify found", verify_cnt ));
 
-  ulong tile_cnt = 3UL + verify_cnt;
+  uchar const * shard_pods = fd_pod_query_subpod( cfg_pod, "dedup.shard" );
+  ulong shard_cnt = fd_pod_cnt_subpod( shard_pods );
+  FD_LOG_NOTICE(( "%lu dedup shards found", shard_cnt ));
+
+  ulong load_cnt = 0UL;
+  for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+    fd_pod_info_t info = fd_pod_iter_info( iter );
+    if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+    load_cnt += (ulong)!!fd_pod_query_subpod( (uchar const *)info.val, "load" );
+  }
+  FD_LOG_NOTICE(( "%lu load found", load_cnt ));
+
+  ulong load_idx0 = 3UL + verify_cnt + shard_cnt; /* Load tiles are last such that they boot after / halt before what they feed */
+  ulong tile_cnt  = load_idx0 + load_cnt;
   if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "at least %lu tiles required for this config", tile_cnt ));
   if( FD_UNLIKELY( fd_tile_cnt()>tile_cnt ) ) FD_LOG_WARNING(( "only %lu tiles required for this config", tile_cnt ));
 
@@ -113,12 +126,41 @@ main( int     argc,
       tile_idx++;
     }
 
+    for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+      char const  * shard_name =                info.key;
+      uchar const * shard_pod  = (uchar const *)info.val;
+
+      FD_LOG_NOTICE(( "joining %s.dedup.shard.%s.cnc", cfg_path, shard_name ));
+      tile_name[ tile_idx ] = shard_name;
+      tile_cnc [ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( shard_pod, "cnc" ) );
+      if( FD_UNLIKELY( !tile_cnc[tile_idx] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+      if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
+      tile_idx++;
+    }
+
+    for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+      char const  * verify_name =                info.key;
+      uchar const * load_pod    = fd_pod_query_subpod( (uchar const *)info.val, "load" );
+      if( !load_pod ) continue;
+
+      FD_LOG_NOTICE(( "joining %s.verify.%s.load.cnc", cfg_path, verify_name ));
+      tile_name[ tile_idx ] = verify_name; /* The load task is told which verify it feeds */
+      tile_cnc [ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( load_pod, "cnc" ) );
+      if( FD_UNLIKELY( !tile_cnc[tile_idx] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+      if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
+      tile_idx++;
+    }
+
   } while(0);
 
   /* Boot all the tiles that main controls */
 
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) {
-    FD_LOG_NOTICE(( "booting tile %s", tile_name[ tile_idx ] ));
+    FD_LOG_NOTICE(( "booting tile %s%s", tile_name[ tile_idx ], (tile_idx<load_idx0) ? "" : ".load" ));
 
     /* Note: could do this in parallel but one at a time makes
        boot logging easier to read and easier to pass args */
@@ -128,7 +170,11 @@ main( int     argc,
     case 0UL: task = main;                 break;
     case 1UL: task = fd_frank_pack_task;   break;
     case 2UL: task = fd_frank_dedup_task;  break;
-    default:  task = fd_frank_verify_task; break;
+    default:
+      if     ( tile_idx<3UL+verify_cnt           ) task = fd_frank_verify_task;
+      else if( tile_idx<load_idx0                ) task = fd_frank_dedup_shard_task;
+      else                                         task = fd_frank_load_task;
+      break;
     }
 
     char * task_argv[3];
@@ -184,7 +230,7 @@ main( int     argc,
   FD_LOG_NOTICE(( "app fini" ));
 
   for( ulong tile_idx=tile_cnt; tile_idx>1UL; tile_idx-- ) {
-    FD_LOG_NOTICE(( "halting tile %s", tile_name[ tile_idx-1UL ] ));
+    FD_LOG_NOTICE(( "halting tile %s%s", tile_name[ tile_idx-1UL ], (tile_idx-1UL<load_idx0) ? "" : ".load" ));
 
     /* Note: could do this in parallel too but doing reverse
        one-at-a-time for symmetry with boot */
@@ -222,10 +222,34 @@ printf_pct( ulong  num_now,
   /**/                 printf( ">999.999" );
 }
 
+/* printf_lat prints to stdout the latency at quantile q of the
+   latency histogram hist (in ticks, see fd_fseq_lat_quantile) as an age
+   in ns.  Will be exactly 10 char wide.  If there were no samples, this
+   will print "-". */
+
+static void
+printf_lat( ulong const * hist,
+            double        q,
+            double        ns_per_tic ) {
+  ulong lat = fd_fseq_lat_quantile( hist, q );
+  if( FD_UNLIKELY( lat==ULONG_MAX ) ) { printf( "         -" ); return; }
+  printf_age( (long)(0.5+ns_per_tic*(double)lat) );
+}
+
 /**********************************************************************/
 
 /* snap reads all the IPC diagnostics in a frank instance and stores
-   them into the easy to process structure snap */
+   them into the easy to process structure snap.  The cnc diagnostics
+   are the values of the first SNAP_METRIC_MAX metrics each tile
+   registered in its cnc such that diagnostics added to a tile show up
+   here without changes to this monitor (snap_metric looks up the ones
+   summarized by name, a tile that does not publish one reads as 0).
+   When a tile's output is consumed by multiple reliable consumers (e.g.
+   a verify tile feeding a sharded dedup), the fseq values summarize all
+   of them: fseq_seq is the position of the slowest consumer and the
+   fseq diagnostics are summed. */
+
+#define SNAP_METRIC_MAX (32UL)
 
 struct snap {
   ulong pmap; /* Bit {0,1,2} set <> {cnc,mcache,fseq} values are valid */
@@ -233,12 +257,8 @@ struct snap {
   long  cnc_heartbeat;
   ulong cnc_signal;
 
-  ulong cnc_diag_in_backp;
-  ulong cnc_diag_backp_cnt;
-  ulong cnc_diag_ha_filt_cnt;
-  ulong cnc_diag_ha_filt_sz;
-  ulong cnc_diag_sv_filt_cnt;
-  ulong cnc_diag_sv_filt_sz;
+  ulong cnc_metric_cnt;
+  ulong cnc_metric[ SNAP_METRIC_MAX ];
 
   ulong mcache_seq;
 
@@ -251,16 +271,29 @@ struct snap {
   ulong fseq_diag_ovrnp_cnt;
   ulong fseq_diag_ovrnr_cnt;
   ulong fseq_diag_slow_cnt;
+  ulong fseq_diag_lat[ 2UL*FD_FSEQ_LAT_BUCKET_CNT ]; /* LAT_PUB then LAT_ORIG histograms */
 };
 
 typedef struct snap snap_t;
 
+static inline ulong
+snap_metric( snap_t const *   snap,
+             fd_cnc_t const * cnc,
+             char const *     name ) {
+  if( FD_UNLIKELY( !(snap->pmap & 1UL) ) ) return 0UL;
+  ulong metric_idx = fd_cnc_metric_find( cnc, name );
+  return (metric_idx<snap->cnc_metric_cnt) ? snap->cnc_metric[ metric_idx ] : 0UL;
+}
+
 static void
-snap( ulong             tile_cnt,     /* Number of tiles to snapshot */
-      snap_t *          snap_cur,     /* Snaphot for each tile, indexed [0,tile_cnt) */
-      fd_cnc_t **       tile_cnc,     /* Local cnc    joins for each tile, NULL if n/a, indexed [0,tile_cnt) */
-      fd_frag_meta_t ** tile_mcache,  /* Local mcache joins for each tile, NULL if n/a, indexed [0,tile_cnt) */
-      ulong **          tile_fseq ) { /* Local fseq   joins for each tile, NULL if n/a, indexed [0,tile_cnt) */
+snap( ulong             tile_cnt,         /* Number of tiles to snapshot */
+      snap_t *          snap_cur,         /* Snaphot for each tile, indexed [0,tile_cnt) */
+      fd_cnc_t **       tile_cnc,         /* Local cnc    joins for each tile, NULL if n/a, indexed [0,tile_cnt) */
+      fd_frag_meta_t ** tile_mcache,      /* Local mcache joins for each tile, NULL if n/a, indexed [0,tile_cnt) */
+      ulong             fseq_max,         /* Max number of fseqs per tile */
+      ulong const *     tile_fseq_cnt,    /* Number of fseqs for each tile, 0 if n/a, indexed [0,tile_cnt) */
+      ulong **          tile_fseq ) {     /* Local fseq   joins for each tile, indexed [0,tile_cnt*fseq_max), the
+                                             fseqs of tile tile_idx are at [tile_idx*fseq_max,tile_idx*fseq_max+fseq_cnt) */
 
   for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
     snap_t * snap = &snap_cur[ tile_idx ];
@@ -271,15 +304,10 @@ snap( ulong             tile_cnt,     /* Number of tiles to snapshot */
     if( FD_LIKELY( cnc ) ) {
       snap->cnc_heartbeat = fd_cnc_heartbeat_query( cnc );
       snap->cnc_signal    = fd_cnc_signal_query   ( cnc );
-      ulong const * cnc_diag = (ulong const *)fd_cnc_app_laddr_const( cnc );
-      FD_COMPILER_MFENCE();
-      snap->cnc_diag_in_backp    = cnc_diag[ FD_FRANK_CNC_DIAG_IN_BACKP    ];
-      snap->cnc_diag_backp_cnt   = cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT   ];
-      snap->cnc_diag_ha_filt_cnt = cnc_diag[ FD_FRANK_CNC_DIAG_HA_FILT_CNT ];
-      snap->cnc_diag_ha_filt_sz  = cnc_diag[ FD_FRANK_CNC_DIAG_HA_FILT_SZ  ];
-      snap->cnc_diag_sv_filt_cnt = cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_CNT ];
-      snap->cnc_diag_sv_filt_sz  = cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_SZ  ];
-      FD_COMPILER_MFENCE();
+      ulong metric_cnt = fd_ulong_min( fd_cnc_metric_cnt( cnc ), SNAP_METRIC_MAX );
+      for( ulong metric_idx=0UL; metric_idx<metric_cnt; metric_idx++ )
+        snap->cnc_metric[ metric_idx ] = fd_cnc_metric_query( cnc, fd_cnc_metric( cnc, metric_idx ) );
+      snap->cnc_metric_cnt = metric_cnt;
 
       pmap |= 1UL;
     }
@@ -292,19 +320,32 @@ snap( ulong             tile_cnt,     /* Number of tiles to snapshot */
       pmap |= 2UL;
     }
 
-    ulong const * fseq = tile_fseq[ tile_idx ];
-    if( FD_LIKELY( fseq ) ) {
-      snap->fseq_seq = fd_fseq_query( fseq );
-      ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( fseq );
-      FD_COMPILER_MFENCE();
-      snap->fseq_diag_tot_cnt   = fseq_diag[ FD_FSEQ_DIAG_PUB_CNT   ];
-      snap->fseq_diag_tot_sz    = fseq_diag[ FD_FSEQ_DIAG_PUB_SZ    ];
-      snap->fseq_diag_filt_cnt  = fseq_diag[ FD_FSEQ_DIAG_FILT_CNT  ];
-      snap->fseq_diag_filt_sz   = fseq_diag[ FD_FSEQ_DIAG_FILT_SZ   ];
-      snap->fseq_diag_ovrnp_cnt = fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ];
-      snap->fseq_diag_ovrnr_cnt = fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ];
-      snap->fseq_diag_slow_cnt  = fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT  ];
-      FD_COMPILER_MFENCE();
+    ulong fseq_cnt = tile_fseq_cnt[ tile_idx ];
+    if( FD_LIKELY( fseq_cnt ) ) {
+      snap->fseq_diag_tot_cnt   = 0UL;
+      snap->fseq_diag_tot_sz    = 0UL;
+      snap->fseq_diag_filt_cnt  = 0UL;
+      snap->fseq_diag_filt_sz   = 0UL;
+      snap->fseq_diag_ovrnp_cnt = 0UL;
+      snap->fseq_diag_ovrnr_cnt = 0UL;
+      snap->fseq_diag_slow_cnt  = 0UL;
+      for( ulong idx=0UL; idx<2UL*FD_FSEQ_LAT_BUCKET_CNT; idx++ ) snap->fseq_diag_lat[ idx ] = 0UL;
+      for( ulong fseq_idx=0UL; fseq_idx<fseq_cnt; fseq_idx++ ) {
+        ulong const * fseq = tile_fseq[ tile_idx*fseq_max + fseq_idx ];
+        ulong seq = fd_fseq_query( fseq );
+        if( !fseq_idx || fd_seq_lt( seq, snap->fseq_seq ) ) snap->fseq_seq = seq;
+        ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( fseq );
+        FD_COMPILER_MFENCE();
+        snap->fseq_diag_tot_cnt   += fseq_diag[ FD_FSEQ_DIAG_PUB_CNT   ];
+        snap->fseq_diag_tot_sz    += fseq_diag[ FD_FSEQ_DIAG_PUB_SZ    ];
+        snap->fseq_diag_filt_cnt  += fseq_diag[ FD_FSEQ_DIAG_FILT_CNT  ];
+        snap->fseq_diag_filt_sz   += fseq_diag[ FD_FSEQ_DIAG_FILT_SZ   ];
+        snap->fseq_diag_ovrnp_cnt += fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ];
+        snap->fseq_diag_ovrnr_cnt += fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ];
+        snap->fseq_diag_slow_cnt  += fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT  ];
+        for( ulong idx=0UL; idx<2UL*FD_FSEQ_LAT_BUCKET_CNT; idx++ ) snap->fseq_diag_lat[ idx ] += fseq_diag[ FD_FSEQ_DIAG_LAT_PUB+idx ];
+        FD_COMPILER_MFENCE();
+      }
       snap->fseq_diag_tot_cnt += snap->fseq_diag_filt_cnt;
       snap->fseq_diag_tot_sz  += snap->fseq_diag_filt_sz;
       pmap |= 4UL;
@@ -345,15 +386,21 @@ main( int     argc,
   uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
   ulong verify_cnt = fd_pod_cnt_subpod( verify_pods );
   FD_LOG_INFO(( "%lu verify found", verify_cnt ));
-  ulong tile_cnt = 3UL + verify_cnt;
+  uchar const * shard_pods = fd_pod_query_subpod( cfg_pod, "dedup.shard" );
+  ulong shard_cnt = fd_pod_cnt_subpod( shard_pods );
+  FD_LOG_INFO(( "%lu dedup shards found", shard_cnt ));
+  ulong tile_cnt = 3UL + verify_cnt + shard_cnt;
+  ulong fseq_max = fd_ulong_max( shard_cnt, 1UL ); /* A verify tile has one fseq per dedup shard */
 
   /* Join all IPC objects for this frank instance */
 
-  char const **     tile_name   = fd_alloca( alignof(char const *    ), sizeof(char const *    )*tile_cnt );
-  fd_cnc_t **       tile_cnc    = fd_alloca( alignof(fd_cnc_t *      ), sizeof(fd_cnc_t *      )*tile_cnt );
-  fd_frag_meta_t ** tile_mcache = fd_alloca( alignof(fd_frag_meta_t *), sizeof(fd_frag_meta_t *)*tile_cnt );
-  ulong **          tile_fseq   = fd_alloca( alignof(ulong *         ), sizeof(ulong *         )*tile_cnt );
-  if( FD_UNLIKELY( (!tile_name) | (!tile_cnc) | (!tile_mcache) | (!tile_fseq) ) ) FD_LOG_ERR(( "fd_alloca failed" )); /* paranoia */
+  char const **     tile_name     = fd_alloca( alignof(char const *    ), sizeof(char const *    )*tile_cnt          );
+  fd_cnc_t **       tile_cnc      = fd_alloca( alignof(fd_cnc_t *      ), sizeof(fd_cnc_t *      )*tile_cnt          );
+  fd_frag_meta_t ** tile_mcache   = fd_alloca( alignof(fd_frag_meta_t *), sizeof(fd_frag_meta_t *)*tile_cnt          );
+  ulong *           tile_fseq_cnt = fd_alloca( alignof(ulong           ), sizeof(ulong           )*tile_cnt          );
+  ulong **          tile_fseq     = fd_alloca( alignof(ulong *         ), sizeof(ulong *         )*tile_cnt*fseq_max );
+  if( FD_UNLIKELY( (!tile_name) | (!tile_cnc) | (!tile_mcache) | (!tile_fseq_cnt) | (!tile_fseq) ) )
+    FD_LOG_ERR(( "fd_alloca failed" )); /* paranoia */
   
   do {
     ulong tile_idx = 0UL;
@@ -363,8 +410,8 @@ main( int     argc,
     tile_cnc[ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "main.cnc" ) );
     if( FD_UNLIKELY( !tile_cnc[ tile_idx ] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
     if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
-    tile_mcache[ tile_idx ] = NULL; /* main has no mcache */
-    tile_fseq  [ tile_idx ] = NULL; /* main has no fseq */
+    tile_mcache  [ tile_idx ] = NULL; /* main has no mcache */
+    tile_fseq_cnt[ tile_idx ] = 0UL;  /* main has no fseq */
     tile_idx++;
 
     tile_name[ tile_idx ] = "pack";
@@ -372,8 +419,8 @@ main( int     argc,
     tile_cnc[ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "pack.cnc" ) );
     if( FD_UNLIKELY( !tile_cnc[ tile_idx ] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
     if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
-    tile_mcache[ tile_idx ] = NULL; /* pack has no mcache */
-    tile_fseq  [ tile_idx ] = NULL; /* pack has no fseq */
+    tile_mcache  [ tile_idx ] = NULL; /* pack has no mcache */
+    tile_fseq_cnt[ tile_idx ] = 0UL;  /* pack has no fseq */
     tile_idx++;
 
     tile_name[ tile_idx ] = "dedup";
@@ -385,8 +432,9 @@ main( int     argc,
     tile_mcache[ tile_idx ] = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "dedup.mcache" ) );
     if( FD_UNLIKELY( !tile_mcache[ tile_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
     FD_LOG_INFO(( "joining %s.dedup.fseq", cfg_path ));
-    tile_fseq[ tile_idx ] = fd_fseq_join( fd_wksp_pod_map( cfg_pod, "dedup.fseq" ) );
-    if( FD_UNLIKELY( !tile_fseq[ tile_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+    tile_fseq[ tile_idx*fseq_max ] = fd_fseq_join( fd_wksp_pod_map( cfg_pod, "dedup.fseq" ) );
+    if( FD_UNLIKELY( !tile_fseq[ tile_idx*fseq_max ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+    tile_fseq_cnt[ tile_idx ] = 1UL;
     tile_idx++;
 
     for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
@@ -403,9 +451,48 @@ main( int     argc,
       FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
       tile_mcache[ tile_idx ] = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
       if( FD_UNLIKELY( !tile_mcache[ tile_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
-      FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-      tile_fseq[ tile_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
-      if( FD_UNLIKELY( !tile_fseq[ tile_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+      if( !shard_cnt ) {
+        FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
+        tile_fseq[ tile_idx*fseq_max ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+        if( FD_UNLIKELY( !tile_fseq[ tile_idx*fseq_max ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+        tile_fseq_cnt[ tile_idx ] = 1UL;
+      } else { /* verify output is consumed by every shard */
+        uchar const * shard_fseq_pod = fd_pod_query_subpod( verify_pod, "shard_fseq" );
+        if( FD_UNLIKELY( !shard_fseq_pod ) ) FD_LOG_ERR(( "%s.verify.%s.shard_fseq path not found", cfg_path, verify_name ));
+        ulong fseq_cnt = 0UL;
+        for( fd_pod_iter_t shard_iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( shard_iter ); shard_iter = fd_pod_iter_next( shard_iter ) ) {
+          fd_pod_info_t shard_info = fd_pod_iter_info( shard_iter );
+          if( FD_UNLIKELY( shard_info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+          char const * shard_name = shard_info.key;
+          FD_LOG_INFO(( "joining %s.verify.%s.shard_fseq.%s", cfg_path, verify_name, shard_name ));
+          ulong * fseq = fd_fseq_join( fd_wksp_pod_map( shard_fseq_pod, shard_name ) );
+          if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+          tile_fseq[ tile_idx*fseq_max + fseq_cnt ] = fseq;
+          fseq_cnt++;
+        }
+        tile_fseq_cnt[ tile_idx ] = fseq_cnt;
+      }
+      tile_idx++;
+    }
+
+    for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+      char const  * shard_name =                info.key;
+      uchar const * shard_pod  = (uchar const *)info.val;
+
+      FD_LOG_INFO(( "joining %s.dedup.shard.%s.cnc", cfg_path, shard_name ));
+      tile_name[ tile_idx ] = shard_name;
+      tile_cnc [ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( shard_pod, "cnc" ) );
+      if( FD_UNLIKELY( !tile_cnc[ tile_idx ] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+      if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
+      FD_LOG_INFO(( "joining %s.dedup.shard.%s.mcache", cfg_path, shard_name ));
+      tile_mcache[ tile_idx ] = fd_mcache_join( fd_wksp_pod_map( shard_pod, "mcache" ) );
+      if( FD_UNLIKELY( !tile_mcache[ tile_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+      FD_LOG_INFO(( "joining %s.dedup.shard.%s.fseq", cfg_path, shard_name ));
+      tile_fseq[ tile_idx*fseq_max ] = fd_fseq_join( fd_wksp_pod_map( shard_pod, "fseq" ) );
+      if( FD_UNLIKELY( !tile_fseq[ tile_idx*fseq_max ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+      tile_fseq_cnt[ tile_idx ] = 1UL;
       tile_idx++;
     }
   } while(0);
@@ -421,15 +508,22 @@ main( int     argc,
 
   /* Get the inital reference diagnostic snapshot */
 
-  snap( tile_cnt, snap_prv, tile_cnc, tile_mcache, tile_fseq );
-  long then; long tic; fd_tempo_observe_pair( &then, &tic );
+  snap( tile_cnt, snap_prv, tile_cnc, tile_mcache, fseq_max, tile_fseq_cnt, tile_fseq );
+  long then; fd_tempo_observe_pair( &then, NULL );
 
   /* Monitor for duration ns.  Note that for duration==0, this
      will still do exactly one pretty print. */
 
   FD_LOG_NOTICE(( "monitoring --dt-min %li ns, --dt-max %li ns, --duration %li ns, --seed %u", dt_min, dt_max, duration, seed ));
 
-  double ns_per_tic = 1./fd_tempo_tick_per_ns( NULL ); /* calibrate during first wait */
+  /* Model the relationship between the tile tickcounts and the
+     wallclock (calibrates during the first wait).  The model is
+     refreshed at every snapshot such that conversions stay accurate
+     over long monitoring sessions. */
+
+  fd_tempo_clock_t _clock[1];
+  fd_tempo_clock_t * clock = fd_tempo_clock_join( fd_tempo_clock_new( _clock, 0., dt_min ) );
+  if( FD_UNLIKELY( !clock ) ) FD_LOG_ERR(( "fd_tempo_clock_join failed" ));
 
   long stop = then + duration;
   for(;;) {
@@ -439,8 +533,10 @@ main( int     argc,
 
     fd_log_wait_until( then + dt_min + (long)fd_rng_ulong_roll( rng, 1UL+(ulong)(dt_max-dt_min) ) );
 
-    snap( tile_cnt, snap_cur, tile_cnc, tile_mcache, tile_fseq );
+    snap( tile_cnt, snap_cur, tile_cnc, tile_mcache, fseq_max, tile_fseq_cnt, tile_fseq );
     long now; long toc; fd_tempo_observe_pair( &now, &toc );
+    fd_tempo_clock_observe( clock, now, toc );
+    double ns_per_tic = fd_tempo_clock_ns_per_tick( clock );
     
     /* Pretty print a comparison between this diagnostic snapshot and
        the previous one. */
@@ -458,12 +554,13 @@ main( int     argc,
       snap_t * cur = &snap_cur[ tile_idx ];
       printf( " %5s", tile_name[ tile_idx ] );
       if( FD_LIKELY( cur->pmap & 1UL ) ) {
-        printf( " | " ); printf_stale   ( (long)(0.5+ns_per_tic*(double)(toc - cur->cnc_heartbeat)), dt_min );
+        printf( " | " ); printf_stale   ( now - fd_tempo_clock_ns( clock, cur->cnc_heartbeat ), dt_min );
         printf( " | " ); printf_heart   ( cur->cnc_heartbeat,        prv->cnc_heartbeat        );
         printf( " | " ); printf_sig     ( cur->cnc_signal,           prv->cnc_signal           );
-        printf( " | " ); printf_err_bool( cur->cnc_diag_in_backp,    prv->cnc_diag_in_backp    );
-        printf( " | " ); printf_err_cnt ( cur->cnc_diag_backp_cnt,   prv->cnc_diag_backp_cnt   );
-        printf( " | " ); printf_err_cnt ( cur->cnc_diag_sv_filt_cnt, prv->cnc_diag_sv_filt_cnt );
+        fd_cnc_t const * cnc = tile_cnc[ tile_idx ];
+        printf( " | " ); printf_err_bool( snap_metric( cur, cnc, "in_backp"    ), snap_metric( prv, cnc, "in_backp"    ) );
+        printf( " | " ); printf_err_cnt ( snap_metric( cur, cnc, "backp_cnt"   ), snap_metric( prv, cnc, "backp_cnt"   ) );
+        printf( " | " ); printf_err_cnt ( snap_metric( cur, cnc, "sv_filt_cnt" ), snap_metric( prv, cnc, "sv_filt_cnt" ) );
       } else {
         printf(       " |          - |     - |          - |        - |                   -" );
       }
@@ -488,10 +585,11 @@ main( int     argc,
       if( tile_idx==2UL ) printf( " %5s->%-5s", tile_name[ 2        ], tile_name[ 1 ] );
       else                printf( " %5s->%-5s", tile_name[ tile_idx ], tile_name[ 2 ] );
       long dt = now-then;
-      ulong cur_raw_cnt = cur->cnc_diag_ha_filt_cnt + cur->fseq_diag_tot_cnt;
-      ulong cur_raw_sz  = cur->cnc_diag_ha_filt_sz  + cur->fseq_diag_tot_sz;
-      ulong prv_raw_cnt = prv->cnc_diag_ha_filt_cnt + prv->fseq_diag_tot_cnt;
-      ulong prv_raw_sz  = prv->cnc_diag_ha_filt_sz  + prv->fseq_diag_tot_sz;
+      fd_cnc_t const * cnc = tile_cnc[ tile_idx ];
+      ulong cur_raw_cnt = snap_metric( cur, cnc, "ha_filt_cnt" ) + cur->fseq_diag_tot_cnt;
+      ulong cur_raw_sz  = snap_metric( cur, cnc, "ha_filt_sz"  ) + cur->fseq_diag_tot_sz;
+      ulong prv_raw_cnt = snap_metric( prv, cnc, "ha_filt_cnt" ) + prv->fseq_diag_tot_cnt;
+      ulong prv_raw_sz  = snap_metric( prv, cnc, "ha_filt_sz"  ) + prv->fseq_diag_tot_sz;
 
       printf( " | " ); printf_rate( 1e9, 0., cur_raw_cnt,             prv_raw_cnt,             dt );
       printf( " | " ); printf_rate( 8e9, 0., cur_raw_sz,              prv_raw_sz,              dt ); /* Assumes sz incl framing */
@@ -513,6 +611,49 @@ main( int     argc,
       printf( "\n" );
     }
     printf( "\n" );
+    printf( "         link |    pub p50 |    pub p99 |   pub p999 |   orig p50 |   orig p99 |  orig p999\n" );
+    printf( "--------------+------------+------------+------------+------------+------------+------------\n" );
+    for( ulong tile_idx=2UL; tile_idx<tile_cnt; tile_idx++ ) {
+      snap_t * prv = &snap_prv[ tile_idx ];
+      snap_t * cur = &snap_cur[ tile_idx ];
+      if( tile_idx==2UL ) printf( " %5s->%-5s", tile_name[ 2        ], tile_name[ 1 ] );
+      else                printf( " %5s->%-5s", tile_name[ tile_idx ], tile_name[ 2 ] );
+      if( FD_LIKELY( cur->pmap & 4UL ) ) {
+        /* Latency distribution of frags consumed since the last snapshot */
+        ulong lat[ 2UL*FD_FSEQ_LAT_BUCKET_CNT ];
+        for( ulong idx=0UL; idx<2UL*FD_FSEQ_LAT_BUCKET_CNT; idx++ ) lat[ idx ] = cur->fseq_diag_lat[ idx ] - prv->fseq_diag_lat[ idx ];
+        ulong const * lat_pub  = lat;
+        ulong const * lat_orig = lat + FD_FSEQ_LAT_BUCKET_CNT;
+        printf( " | " ); printf_lat( lat_pub,  0.5,   ns_per_tic );
+        printf( " | " ); printf_lat( lat_pub,  0.99,  ns_per_tic );
+        printf( " | " ); printf_lat( lat_pub,  0.999, ns_per_tic );
+        printf( " | " ); printf_lat( lat_orig, 0.5,   ns_per_tic );
+        printf( " | " ); printf_lat( lat_orig, 0.99,  ns_per_tic );
+        printf( " | " ); printf_lat( lat_orig, 0.999, ns_per_tic );
+      } else {
+        printf( " |          - |          - |          - |          - |          - |          -" );
+      }
+      printf( "\n" );
+    }
+    printf( "\n" );
+    printf( "  tile |                  metric |      type |                value |     rate\n" );
+    printf( "-------+-------------------------+-----------+----------------------+----------\n" );
+    for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+      snap_t * prv = &snap_prv[ tile_idx ];
+      snap_t * cur = &snap_cur[ tile_idx ];
+      if( FD_UNLIKELY( !(cur->pmap & 1UL) ) ) continue;
+      for( ulong metric_idx=0UL; metric_idx<cur->cnc_metric_cnt; metric_idx++ ) {
+        fd_cnc_metric_t const * metric = fd_cnc_metric( tile_cnc[ tile_idx ], metric_idx );
+        ulong val_now  = cur->cnc_metric[ metric_idx ];
+        ulong val_then = (metric_idx<prv->cnc_metric_cnt) ? prv->cnc_metric[ metric_idx ] : val_now;
+        printf( " %5s | %23s | %9s | %20lu | ", tile_name[ tile_idx ], metric->name,
+                fd_cnc_metric_type_cstr( (int)metric->type ), val_now );
+        if( metric->type==FD_CNC_METRIC_TYPE_GAUGE ) printf( "       -" );
+        else                                         printf_rate( 1e9, 0., val_now, val_then, now-then );
+        printf( "\n" );
+      }
+    }
+    printf( "\n" );
 
     /* Stop once we've been monitoring for duration ns */
 
@@ -521,16 +662,18 @@ main( int     argc,
     /* Still more monitoring to do ... wind up for the next iteration by
        swaping the two snap arrays. */
 
-    then = now; tic = toc;
+    then = now;
     snap_t * tmp = snap_prv; snap_prv = snap_cur; snap_cur = tmp;
   }
 
   /* Monitoring done ... clean up */
 
   FD_LOG_NOTICE(( "cleaning up" ));
+  fd_tempo_clock_delete( fd_tempo_clock_leave( clock ) );
   fd_rng_delete( fd_rng_leave( rng ) );
   for( ulong tile_idx=tile_cnt; tile_idx; tile_idx-- ) {
-    if( FD_LIKELY( tile_fseq  [ tile_idx-1UL ] ) ) fd_wksp_pod_unmap( fd_fseq_leave  ( tile_fseq  [ tile_idx-1UL ] ) );
+    for( ulong fseq_idx=tile_fseq_cnt[ tile_idx-1UL ]; fseq_idx; fseq_idx-- )
+      fd_wksp_pod_unmap( fd_fseq_leave( tile_fseq[ (tile_idx-1UL)*fseq_max + fseq_idx-1UL ] ) );
     if( FD_LIKELY( tile_mcache[ tile_idx-1UL ] ) ) fd_wksp_pod_unmap( fd_mcache_leave( tile_mcache[ tile_idx-1UL ] ) );
     if( FD_LIKELY( tile_cnc   [ tile_idx-1UL ] ) ) fd_wksp_pod_unmap( fd_cnc_leave   ( tile_cnc   [ tile_idx-1UL ] ) );
   }
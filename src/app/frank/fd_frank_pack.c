@@ -2,6 +2,44 @@
 
 #if FD_HAS_FRANK
 
+/* A fd_frank_pack_verify_t holds this tile's joins to the output of a
+   verify tile.  Frags published by a verify with a hold table (see
+   fd_dcache.h) are inserted into the pack by reference with their
+   dcache slot pinned until the transaction leaves the pack.  The pack
+   ref of such a transaction is the verify index in the upper 32-bits
+   and the slot index in the lower 32-bits. */
+
+struct fd_frank_pack_verify {
+  fd_frag_meta_t const * mcache;
+  ulong                  depth;
+  uchar const *          dcache;
+  fd_dcache_hold_t *     hold;     /* NULL if the verify has no hold table */
+  ulong                  chunk0;   /* Verify dcache data region chunks are [chunk0,chunk1) */
+  ulong                  chunk1;
+  ulong                  slot_cnt; /* 0 if the verify has no hold table */
+};
+
+typedef struct fd_frank_pack_verify fd_frank_pack_verify_t;
+
+static inline void
+fd_frank_pack_unpin( fd_frank_pack_verify_t * verify,
+                     ulong                    ref ) {
+  if( ref!=FD_PACK_TXN_REF_NULL ) fd_dcache_hold_unpin( verify[ ref>>32 ].hold, ref & (ulong)UINT_MAX );
+}
+
+/* fd_frank_pack_complete completes the microblock of lane lane_idx (at
+   lane_txn, txn_cnt transactions) and unpins its transactions. */
+
+static void
+fd_frank_pack_complete( fd_pack_t *              pack,
+                        fd_frank_pack_verify_t * verify,
+                        fd_pack_txn_t const **   lane_txn,
+                        ulong                    txn_cnt,
+                        ulong                    lane_idx ) {
+  for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) fd_frank_pack_unpin( verify, lane_txn[ txn_idx ]->ref );
+  fd_pack_microblock_complete( pack, lane_idx );
+}
+
 int
 fd_frank_pack_task( int     argc,
                     char ** argv ) {
@@ -27,24 +65,92 @@ fd_frank_pack_task( int     argc,
   fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "pack.cnc" ) );
   if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
   if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
-  /* FIXME: CNC DIAG REGION? */
+  ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  if( FD_UNLIKELY( !cnc_diag ) ) FD_LOG_ERR(( "fd_cnc_app_laddr failed" ));
+
+  static fd_cnc_metric_t const cnc_metric[] = {
+    { "pending_cnt",    FD_CNC_METRIC_TYPE_GAUGE,   FD_FRANK_CNC_DIAG_PACK_PENDING_CNT,    1U },
+    { "drop_cnt",       FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_PACK_DROP_CNT,       1U },
+    { "microblock_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT, 1U },
+    { "txn_cnt",        FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_PACK_TXN_CNT,        1U },
+    { "block_cnt",      FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT,      1U },
+    { "block_cu",       FD_CNC_METRIC_TYPE_GAUGE,   FD_FRANK_CNC_DIAG_PACK_BLOCK_CU,       1U }
+  };
+  fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_PENDING_CNT    ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_DROP_CNT       ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_TXN_CNT        ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT      ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CU       ] ) = 0UL;
+  FD_COMPILER_MFENCE();
+  ulong accum_drop_cnt       = 0UL;
+  ulong accum_microblock_cnt = 0UL;
+  ulong accum_txn_cnt        = 0UL;
 
   FD_LOG_INFO(( "joining %s.dedup.mcache", cfg_path ));
   fd_frag_meta_t const * mcache = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "dedup.mcache" ) );
   if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
   ulong         depth = fd_mcache_depth( mcache );
-  ulong const * sync  = fd_mcache_seq_laddr_const( mcache );
+  ulong *       sync  = fd_mcache_seq_laddr( (fd_frag_meta_t *)mcache ); /* non-const for parking (see fd_idle.h) */
   ulong         seq   = fd_mcache_seq_query( sync );
 
   fd_frag_meta_t const * mline = mcache + fd_mcache_line_idx( seq, depth );
 
-  FD_LOG_INFO(( "joining %s.verify.*.dcache", cfg_path ));
   /* Note (chunks are referenced relative to the containing workspace
-     currently and there is just one workspace).  (FIXME: VALIDATE
-     COMMON WORKSPACE FOR THESE) */
+     currently and there is just one workspace) */
   fd_wksp_t * wksp = fd_wksp_containing( mcache );
   if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "fd_wksp_containing failed" ));
 
+  /* Join the verify outputs.  Frags from a verify this tile doesn't
+     know (no hold table or bound to dedup after this tile booted) are
+     copied into the pack. */
+
+  uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
+  ulong         verify_cnt  = fd_pod_cnt_subpod( verify_pods );
+  FD_LOG_INFO(( "%lu verify found", verify_cnt ));
+  fd_frank_pack_verify_t * verify = (fd_frank_pack_verify_t *)
+    fd_alloca( alignof(fd_frank_pack_verify_t), sizeof(fd_frank_pack_verify_t)*fd_ulong_max( verify_cnt, 1UL ) );
+  if( FD_UNLIKELY( !verify ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+  ulong chunk_mtu = FD_DCACHE_SLOT_FOOTPRINT( FD_FRANK_VERIFY_MTU ) >> FD_CHUNK_LG_SZ;
+
+  ulong verify_idx = 0UL;
+  for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+    fd_pod_info_t info = fd_pod_iter_info( iter );
+    if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+    char const  * verify_name =                info.key;
+    uchar const * verify_pod  = (uchar const *)info.val;
+    fd_frank_pack_verify_t * v = verify + verify_idx;
+
+    FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
+    v->mcache = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
+    if( FD_UNLIKELY( !v->mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+    v->depth = fd_mcache_depth( v->mcache );
+
+    FD_LOG_INFO(( "joining %s.verify.%s.dcache", cfg_path, verify_name ));
+    v->dcache = fd_dcache_join( fd_wksp_pod_map( verify_pod, "dcache" ) );
+    if( FD_UNLIKELY( !v->dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+    if( FD_UNLIKELY( fd_wksp_containing( v->dcache )!=wksp ) ) FD_LOG_ERR(( "%s.verify.%s.dcache not in the dedup.mcache wksp", cfg_path, verify_name ));
+    v->chunk0 = fd_dcache_compact_chunk0( wksp, v->dcache );
+    v->chunk1 = fd_dcache_compact_chunk1( wksp, v->dcache );
+
+    v->hold     = NULL;
+    v->slot_cnt = 0UL;
+    if( fd_pod_query_cstr( verify_pod, "hold", NULL ) ) {
+      FD_LOG_INFO(( "joining %s.verify.%s.hold", cfg_path, verify_name ));
+      v->hold = fd_dcache_hold_join( fd_wksp_pod_map( verify_pod, "hold" ) );
+      if( FD_UNLIKELY( !v->hold ) ) FD_LOG_ERR(( "fd_dcache_hold_join failed" ));
+      v->slot_cnt = fd_dcache_hold_slot_cnt( v->hold );
+      if( FD_UNLIKELY( !fd_dcache_hold_is_safe( wksp, v->dcache, FD_FRANK_VERIFY_MTU, v->slot_cnt ) ) )
+        FD_LOG_ERR(( "%s.verify.%s.dcache too small for %s.verify.%s.hold", cfg_path, verify_name, cfg_path, verify_name ));
+      if( FD_UNLIKELY( v->slot_cnt>(ulong)UINT_MAX ) ) FD_LOG_ERR(( "%s.verify.%s.hold has too many slots", cfg_path, verify_name ));
+    }
+
+    verify_idx++;
+  }
+
   FD_LOG_INFO(( "joining %s.dedup.fseq", cfg_path ));
   ulong * fseq = fd_fseq_join( fd_wksp_pod_map( cfg_pod, "dedup.fseq" ) );
   if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
@@ -72,18 +178,115 @@ fd_frank_pack_task( int     argc,
   ulong async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
   if( FD_UNLIKELY( !async_min ) ) FD_LOG_ERR(( "bad lazy" ));
 
+  int idle_en = fd_pod_query_int( cfg_pod, "pack.idle", 0 ); /* 0 <> always poll */
+  FD_LOG_INFO(( "configuring idle policy (%s.pack.idle %i)", cfg_path, idle_en ));
+  fd_idle_t   _idle[ 1 ];
+  fd_idle_t * idle = NULL;
+  if( idle_en ) {
+    idle = fd_idle_join( fd_idle_new( _idle, -1L, -1L, -1L ) );
+    if( FD_UNLIKELY( !idle ) ) FD_LOG_ERR(( "fd_idle_join failed" ));
+  }
+
   uint seed = fd_pod_query_uint( cfg_pod, "pack.seed", (uint)fd_tile_id() ); /* use app tile_id as default */
   FD_LOG_INFO(( "creating rng (%s.pack.seed %u)", cfg_path, seed ));
   fd_rng_t _rng[ 1 ];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
   if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
 
+  ulong txn_max        = fd_pod_query_ulong( cfg_pod, "pack.txn_max",        4096UL );
+  ulong lane_cnt       = fd_pod_query_ulong( cfg_pod, "pack.lane_cnt",       4UL    );
+  ulong microblock_max = fd_pod_query_ulong( cfg_pod, "pack.microblock_max", 32UL   );
+  ulong block_cu_max   = fd_pod_query_ulong( cfg_pod, "pack.block_cu_max",   0UL    );
+  FD_LOG_INFO(( "creating pack (%s.pack.txn_max %lu, %s.pack.lane_cnt %lu, %s.pack.microblock_max %lu, %s.pack.block_cu_max %lu)",
+                cfg_path, txn_max, cfg_path, lane_cnt, cfg_path, microblock_max, cfg_path, block_cu_max ));
+  ulong pack_footprint = fd_pack_footprint( txn_max, lane_cnt, microblock_max );
+  if( FD_UNLIKELY( !pack_footprint ) ) FD_LOG_ERR(( "bad txn_max, lane_cnt or microblock_max" ));
+  void * pack_mem = fd_wksp_alloc_laddr( wksp, fd_pack_align(), pack_footprint );
+  if( FD_UNLIKELY( !pack_mem ) ) FD_LOG_ERR(( "fd_wksp_alloc_laddr failed" ));
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_mem, txn_max, lane_cnt, microblock_max, block_cu_max, fd_rng_ulong( rng ) ) );
+  if( FD_UNLIKELY( !pack ) ) FD_LOG_ERR(( "fd_pack_join failed" ));
+
+  FD_LOG_INFO(( "joining %s.pack.mcache", cfg_path ));
+  fd_frag_meta_t * out_mcache = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "pack.mcache" ) );
+  if( FD_UNLIKELY( !out_mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  ulong   out_depth = fd_mcache_depth( out_mcache );
+  ulong * out_sync  = fd_mcache_seq_laddr( out_mcache );
+  ulong   out_seq   = fd_mcache_seq_query( out_sync );
+
+  FD_LOG_INFO(( "joining %s.pack.dcache", cfg_path ));
+  uchar * out_dcache = fd_dcache_join( fd_wksp_pod_map( cfg_pod, "pack.dcache" ) );
+  if( FD_UNLIKELY( !out_dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+  ulong out_mtu = FD_FRANK_ENTRY_MTU( microblock_max );
+  if( FD_UNLIKELY( fd_wksp_containing( out_dcache )!=wksp ) ) FD_LOG_ERR(( "%s.pack.dcache not in the dedup.mcache wksp", cfg_path ));
+  if( FD_UNLIKELY( !fd_dcache_compact_is_safe( wksp, out_dcache, out_mtu, out_depth ) ) )
+    FD_LOG_ERR(( "%s.pack.dcache too small for mtu %lu", cfg_path, out_mtu ));
+  ulong out_chunk0 = fd_dcache_compact_chunk0( wksp, out_dcache );
+  ulong out_wmark  = fd_dcache_compact_wmark ( wksp, out_dcache, out_mtu );
+  ulong out_chunk  = out_chunk0;
+
+  ulong slot_max = fd_pod_query_ulong( cfg_pod, "pack.slot_max", 1024UL );
+  FD_LOG_INFO(( "creating block store slot index (%s.pack.slot_max %lu)", cfg_path, slot_max ));
+  ulong bstore_footprint = fd_bstore_footprint( slot_max );
+  if( FD_UNLIKELY( !bstore_footprint ) ) FD_LOG_ERR(( "bad slot_max" ));
+  if( FD_UNLIKELY( bstore_footprint>fd_mcache_app_sz( out_mcache ) ) ) FD_LOG_ERR(( "%s.pack.mcache app region too small for slot_max", cfg_path ));
+  fd_bstore_t * bstore = fd_bstore_join( fd_bstore_new( fd_mcache_app_laddr( out_mcache ), slot_max ) );
+  if( FD_UNLIKELY( !bstore ) ) FD_LOG_ERR(( "fd_bstore_join failed" ));
+  ulong slot = fd_pod_query_ulong( cfg_pod, "pack.slot0", 0UL );
+
+  /* Lane lane_idx's in flight microblock is at lane_txn[
+     lane_idx*microblock_max ] and was published to the block store at
+     lane_seq[ lane_idx ].  If the lanes have executors (lane_fseq), a
+     lane's microblock is complete once the executor has acked it.
+     lane_ack caches the executor acks (refreshed during housekeeping).
+     Otherwise, a microblock is complete once it is published to the
+     block store (the block store is the terminal consumer). */
+
+  fd_pack_txn_t const ** lane_txn = (fd_pack_txn_t const **)
+    fd_alloca( alignof(fd_pack_txn_t const *), lane_cnt*microblock_max*sizeof(fd_pack_txn_t const *) );
+  ulong *  lane_seq  = (ulong *) fd_alloca( alignof(ulong),   lane_cnt*sizeof(ulong)   );
+  ulong *  lane_ack  = (ulong *) fd_alloca( alignof(ulong),   lane_cnt*sizeof(ulong)   );
+  ulong ** lane_fseq = (ulong **)fd_alloca( alignof(ulong *), lane_cnt*sizeof(ulong *) );
+  if( FD_UNLIKELY( (!lane_txn) | (!lane_seq) | (!lane_ack) | (!lane_fseq) ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  uchar const * lane_fseq_pod = fd_pod_query_subpod( cfg_pod, "pack.lane_fseq" );
+  int           lane_ack_en   = !!lane_fseq_pod;
+  if( lane_ack_en ) {
+    if( FD_UNLIKELY( fd_pod_cnt( lane_fseq_pod )!=lane_cnt ) ) FD_LOG_ERR(( "%s.pack.lane_fseq should have %s.pack.lane_cnt entries", cfg_path, cfg_path ));
+    ulong lane_idx = 0UL;
+    for( fd_pod_iter_t iter = fd_pod_iter_init( lane_fseq_pod ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      FD_LOG_INFO(( "joining %s.pack.lane_fseq.%s", cfg_path, info.key ));
+      lane_fseq[ lane_idx ] = fd_fseq_join( fd_wksp_pod_map( lane_fseq_pod, info.key ) );
+      if( FD_UNLIKELY( !lane_fseq[ lane_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+      lane_idx++;
+    }
+  }
+  for( ulong lane_idx=0UL; lane_idx<lane_cnt; lane_idx++ ) {
+    lane_seq[ lane_idx ] = out_seq;
+    lane_ack[ lane_idx ] = lane_ack_en ? fd_fseq_query( lane_fseq[ lane_idx ] ) : out_seq;
+  }
+  ulong lane_busy_cnt = 0UL;
+  ulong lane_idx      = 0UL;
+
+  long block_ns = fd_pod_query_long( cfg_pod, "pack.block_ns", 400000000L );
+  FD_LOG_INFO(( "configuring block duration (%s.pack.block_ns %li)", cfg_path, block_ns ));
+  if( FD_UNLIKELY( block_ns<=0L ) ) FD_LOG_ERR(( "bad block_ns" ));
+  long block_ticks = (long)(((double)block_ns)*fd_tempo_tick_per_ns( NULL ));
+
+  /* Verified transaction frags from verifies without a hold table are
+     copied here while speculatively processing them (this also gives
+     fd_txn_t the alignment it needs) */
+
+  uchar __attribute__((aligned(FD_CHUNK_ALIGN))) frag[ FD_FRANK_VERIFY_MTU ];
+
   /* Start packing */
 
   FD_LOG_INFO(( "pack run" ));
 
-  long now  = fd_tickcount();
-  long then = now;            /* Do housekeeping on first iteration of run loop */
+  long now        = fd_tickcount();
+  long then       = now;              /* Do housekeeping on first iteration of run loop */
+  long block_then = now + block_ticks;
+  fd_bstore_slot_begin( bstore, slot, out_seq );
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
   for(;;) {
 
@@ -91,9 +294,15 @@ fd_frank_pack_task( int     argc,
 
     if( FD_UNLIKELY( (now-then)>=0L ) ) {
 
+      /* Send synchronization info */
+      fd_mcache_seq_update( out_sync, out_seq );
+
       /* Send flow control credits */
       fd_fctl_rx_cr_return( fseq, seq );
 
+      /* Receive microblock acks */
+      if( lane_ack_en ) for( ulong idx=0UL; idx<lane_cnt; idx++ ) lane_ack[ idx ] = fd_fseq_query( lane_fseq[ idx ] );
+
       /* Send diagnostic info */
       fd_cnc_heartbeat( cnc, now );
       FD_COMPILER_MFENCE();
@@ -107,6 +316,25 @@ fd_frank_pack_task( int     argc,
       accum_ovrnp_cnt = 0UL;
       accum_ovrnr_cnt = 0UL;
 
+      /* End the current block if it is time */
+      if( FD_UNLIKELY( (now-block_then)>=0L ) ) {
+        FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CU ] ) = fd_pack_block_cu_used( pack );
+        FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT ] ) = cnc_diag[ FD_FRANK_CNC_DIAG_PACK_BLOCK_CNT ] + 1UL;
+        fd_pack_end_block( pack );
+        fd_bstore_slot_begin( bstore, ++slot, out_seq ); /* Ends the current slot */
+        block_then = now + block_ticks;
+      }
+
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_PENDING_CNT    ] ) = fd_pack_pending_cnt( pack );
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_DROP_CNT       ] ) = cnc_diag[ FD_FRANK_CNC_DIAG_PACK_DROP_CNT       ] + accum_drop_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT ] ) = cnc_diag[ FD_FRANK_CNC_DIAG_PACK_MICROBLOCK_CNT ] + accum_microblock_cnt;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PACK_TXN_CNT        ] ) = cnc_diag[ FD_FRANK_CNC_DIAG_PACK_TXN_CNT        ] + accum_txn_cnt;
+      FD_COMPILER_MFENCE();
+      accum_drop_cnt       = 0UL;
+      accum_microblock_cnt = 0UL;
+      accum_txn_cnt        = 0UL;
+
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
       if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
@@ -118,12 +346,53 @@ fd_frank_pack_task( int     argc,
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
+    /* Visit the next lane (round robin).  If the lane's microblock
+       has been acked by its executor, complete it.  If the lane is
+       idle, schedule a microblock for it and publish it to the block
+       store as an entry of the current slot. */
+
+    fd_pack_txn_t const ** microblock = lane_txn + lane_idx*microblock_max;
+    ulong                  busy_cnt   = fd_pack_lane_txn_cnt( pack, lane_idx );
+    if( FD_UNLIKELY( busy_cnt && fd_seq_gt( lane_ack[ lane_idx ], lane_seq[ lane_idx ] ) ) ) {
+      fd_frank_pack_complete( pack, verify, microblock, busy_cnt, lane_idx );
+      lane_busy_cnt--;
+      busy_cnt = 0UL;
+    }
+
+    if( FD_LIKELY( (!busy_cnt) & (!!fd_pack_pending_cnt( pack )) ) ) {
+      ulong txn_cnt = fd_pack_schedule( pack, lane_idx, microblock );
+      if( FD_LIKELY( txn_cnt ) ) {
+        uchar * p   = (uchar *)fd_chunk_to_laddr( wksp, out_chunk );
+        ulong   off = 4UL;
+        FD_STORE( ushort, p,     (ushort)txn_cnt  );
+        FD_STORE( ushort, p+2UL, (ushort)lane_idx );
+        for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) {
+          ulong payload_sz = (ulong)microblock[ txn_idx ]->payload_sz;
+          FD_STORE( ushort, p+off, (ushort)payload_sz );
+          fd_memcpy( p+off+2UL, fd_pack_txn_payload( microblock[ txn_idx ] ), payload_sz );
+          off += 2UL + payload_sz;
+        }
+        ulong ts = fd_frag_meta_ts_comp( now );
+        fd_bstore_publish( bstore, out_mcache, out_depth, out_seq, out_chunk, off, ts, ts );
+        lane_seq[ lane_idx ] = out_seq;
+        out_seq   = fd_seq_inc( out_seq, 1UL );
+        out_chunk = fd_dcache_compact_next( out_chunk, off, out_chunk0, out_wmark );
+        if( lane_ack_en ) lane_busy_cnt++;
+        else              fd_frank_pack_complete( pack, verify, microblock, txn_cnt, lane_idx );
+      }
+      accum_microblock_cnt += (ulong)(txn_cnt>0UL);
+      accum_txn_cnt        += txn_cnt;
+    }
+    lane_idx = fd_ulong_if( lane_idx+1UL<lane_cnt, lane_idx+1UL, 0UL );
+
     /* See if there are any transactions waiting to be packed */
     ulong seq_found = fd_frag_meta_seq_query( mline );
     long  diff      = fd_seq_diff( seq_found, seq );
     if( FD_UNLIKELY( diff ) ) { /* caught up or overrun, optimize for expected sequence number ready */
       if( FD_LIKELY( diff<0L ) ) { /* caught up */
-        FD_SPIN_PAUSE();
+        /* Only park when there is nothing left to schedule or complete */
+        if( FD_UNLIKELY( idle && !fd_pack_pending_cnt( pack ) && !lane_busy_cnt ) ) fd_idle_wait( idle, seq, now, &mline->seq, seq_found, sync );
+        else                                                        FD_SPIN_PAUSE();
         now = fd_tickcount();
         continue;
       }
@@ -138,20 +407,97 @@ fd_frank_pack_task( int     argc,
     /* At this point, we have started receiving frag seq with details in
        mline at time now.  Speculatively processs it here. */
 
-    /* Placeholder for speculative pack operations */
-    ulong sz = (ulong)mline->sz;
+    /* The frag sz is always in [11,FD_FRANK_VERIFY_MTU] for a verified
+       transaction but we don't trust an overrun meta. */
+
+    ulong sz     = (ulong)mline->sz;
+    ulong chunk  = (ulong)mline->chunk;
+    ulong sig    = (ulong)mline->sig;
+    ulong tsorig = (ulong)mline->tsorig;
+    ulong tspub  = (ulong)mline->tspub;
+    int   bad_sz = (sz<11UL) | (sz>FD_FRANK_VERIFY_MTU);
+
+    /* Find the verify that published the frag */
+
+    ulong vidx = 0UL;
+    while( (vidx<verify_cnt) && !((verify[ vidx ].chunk0<=chunk) & (chunk<verify[ vidx ].chunk1)) ) vidx++;
+    fd_frank_pack_verify_t * v = vidx<verify_cnt ? verify + vidx : NULL;
+
+    uchar const * txn_frag = frag;
+    ulong         ref      = FD_PACK_TXN_REF_NULL;
+    int           ovrn     = 0;
+    if( FD_LIKELY( v && v->hold ) ) {
+
+      /* Pin the frag's slot in the verify dcache such that the verify
+         can't reuse it while the transaction is in the pack.  If the
+         verify already reused the slot (we are too far behind) or we
+         were overrun, the verify seq read from the frag trailer might
+         be garbage.  Then the pin either fails or pins some other
+         frag.  So, once pinned, we check the verify published the
+         pinned frag with the same sig and sz as the frag described by
+         mline before using it. */
+
+      ulong slot_idx = fd_dcache_hold_slot_idx( v->chunk0, chunk_mtu, chunk );
+      txn_frag = (uchar const *)fd_chunk_to_laddr_const( wksp, chunk );
+      if( FD_LIKELY( (!bad_sz) & (slot_idx<v->slot_cnt) & (fd_dcache_hold_chunk( v->chunk0, chunk_mtu, slot_idx )==chunk) ) ) {
+        ulong vseq = fd_frank_txn_seq( txn_frag, sz );
+        if( FD_LIKELY( fd_dcache_hold_pin( v->hold, slot_idx, vseq ) ) ) {
+          fd_frag_meta_t const * vline = v->mcache + fd_mcache_line_idx( vseq, v->depth );
+          FD_COMPILER_MFENCE();
+          ulong vseq_found = vline->seq;
+          ulong vsig       = vline->sig;
+          ulong vsz        = (ulong)vline->sz;
+          FD_COMPILER_MFENCE();
+          ulong vseq_test  = vline->seq;
+          FD_COMPILER_MFENCE();
+          if( FD_LIKELY( fd_seq_eq( vseq_found, vseq ) & fd_seq_eq( vseq_test, vseq ) & (vsig==sig) & (vsz==sz) ) )
+            ref = (vidx<<32) | slot_idx;
+          else {
+            fd_dcache_hold_unpin( v->hold, slot_idx );
+            ovrn = 1;
+          }
+        } else ovrn = 1;
+      }
+
+    } else if( FD_LIKELY( !bad_sz ) ) fd_memcpy( frag, fd_chunk_to_laddr_const( wksp, chunk ), sz );
 
     /* Check that we weren't overrun while processing */
     seq_found = fd_frag_meta_seq_query( mline );
     if( FD_UNLIKELY( fd_seq_ne( seq_found, seq ) ) ) {
+      fd_frank_pack_unpin( verify, ref );
       accum_ovrnr_cnt++;
       seq = seq_found;
       continue;
     }
 
-    /* Placeholder for non-speculative pack operations */
+    /* The verify reused the frag's slot before we got to it.  This
+       frag is lost. */
+    if( FD_UNLIKELY( ovrn ) ) {
+      accum_ovrnr_cnt++;
+      seq   = fd_seq_inc( seq, 1UL );
+      mline = mcache + fd_mcache_line_idx( seq, depth );
+      continue;
+    }
+
+    /* Insert the transaction into the pack's pool of pending
+       transactions (by reference if pinned).  If the pool is full and
+       the transaction has a higher priority than something pending,
+       the lower priority one gets dropped. */
+
+    if( FD_LIKELY( !bad_sz ) ) {
+      ulong evict_ref = FD_PACK_TXN_REF_NULL;
+      int   err       = fd_pack_insert_ref( pack, txn_frag, fd_frank_txn_payload_sz( txn_frag, sz ), fd_frank_txn( txn_frag, sz ),
+                                            ref, &evict_ref );
+      if(      FD_UNLIKELY( err<0                      ) ) fd_frank_pack_unpin( verify, ref       );
+      else if( FD_UNLIKELY( err==FD_PACK_INSERT_REPLACE ) ) fd_frank_pack_unpin( verify, evict_ref );
+      accum_drop_cnt += (ulong)(err!=FD_PACK_INSERT_ACCEPT);
+    } else {
+      accum_drop_cnt++;
+    }
+
     accum_pub_cnt++;
     accum_pub_sz += sz;
+    fd_fseq_lat_sample( fseq_diag, now, tsorig, tspub );
 
     /* Wind up for the next iteration */
     seq   = fd_seq_inc( seq, 1UL );
@@ -159,10 +505,27 @@ fd_frank_pack_task( int     argc,
   }
 
   /* Clean up */
-  
+
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
   FD_LOG_INFO(( "pack fini" ));
+  fd_bstore_slot_end( bstore );
+  fd_mcache_seq_update( out_sync, out_seq );
+  fd_bstore_leave( bstore ); /* The slot index stays valid for block store readers */
+  fd_wksp_pod_unmap( fd_dcache_leave( out_dcache ) );
+  fd_wksp_pod_unmap( fd_mcache_leave( out_mcache ) );
+  for( ulong idx=0UL; idx<lane_cnt; idx++ )
+    fd_frank_pack_complete( pack, verify, lane_txn + idx*microblock_max, fd_pack_lane_txn_cnt( pack, idx ), idx );
+  for( ulong idx=fd_pack_pending_cnt( pack ); idx; idx-- ) fd_frank_pack_unpin( verify, fd_pack_pending_ref( pack, idx-1UL ) );
+  if( lane_ack_en ) for( ulong idx=lane_cnt; idx; idx-- ) fd_wksp_pod_unmap( fd_fseq_leave( lane_fseq[ idx-1UL ] ) );
+  for( ulong idx=verify_cnt; idx; idx-- ) {
+    fd_frank_pack_verify_t * v = verify + idx - 1UL;
+    if( v->hold ) fd_wksp_pod_unmap( fd_dcache_hold_leave( v->hold ) );
+    fd_wksp_pod_unmap( fd_dcache_leave( v->dcache ) );
+    fd_wksp_pod_unmap( fd_mcache_leave( v->mcache ) );
+  }
+  fd_wksp_free_laddr( fd_pack_delete( fd_pack_leave( pack ) ) );
   fd_rng_delete    ( fd_rng_leave   ( rng    ) );
+  if( idle ) fd_idle_delete( fd_idle_leave( idle ) );
   fd_wksp_pod_unmap( fd_fseq_leave  ( fseq   ) );
   fd_wksp_pod_unmap( fd_mcache_leave( mcache ) );
   fd_wksp_pod_unmap( fd_cnc_leave   ( cnc    ) );
@@ -36,6 +36,17 @@ fd_frank_verify_task( int     argc,
   if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
   ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
   if( FD_UNLIKELY( !cnc_diag ) ) FD_LOG_ERR(( "fd_cnc_app_laddr failed" ));
+
+  static fd_cnc_metric_t const cnc_metric[] = {
+    { "in_backp",    FD_CNC_METRIC_TYPE_GAUGE,   FD_FRANK_CNC_DIAG_IN_BACKP,    1U },
+    { "backp_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_BACKP_CNT,   1U },
+    { "ha_filt_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_HA_FILT_CNT, 1U },
+    { "ha_filt_sz",  FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_HA_FILT_SZ,  1U },
+    { "sv_filt_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_SV_FILT_CNT, 1U },
+    { "sv_filt_sz",  FD_CNC_METRIC_TYPE_COUNTER, FD_FRANK_CNC_DIAG_SV_FILT_SZ,  1U }
+  };
+  fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
   int in_backp = 1;
 
   FD_COMPILER_MFENCE();
@@ -60,15 +71,109 @@ fd_frank_verify_task( int     argc,
   fd_wksp_t * wksp = fd_wksp_containing( dcache ); /* chunks are referenced relative to the containing workspace */
   if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "fd_wksp_containing failed" ));
   ulong   chunk0 = fd_dcache_compact_chunk0( wksp, dcache );
-  ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, 1542UL ); /* FIXME: MTU? SAFETY CHECK THE FOOTPRINT? */
+  ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, FD_FRANK_VERIFY_MTU );
   ulong   chunk  = chunk0;
 
-  FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-  ulong * fseq = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
-  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
-  ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
-  if( FD_UNLIKELY( !fseq_diag ) ) FD_LOG_ERR(( "fd_fseq_app_laddr failed" ));
-  FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL; /* Managed by the fctl */
+  /* If this tile has a hold table (see fd_dcache.h), the dcache is
+     partitioned into fixed size slots and each frag is written to a
+     slot claimed from the hold table.  This lets pack pin the payloads
+     of its pending transactions in place instead of copying them out.
+     Otherwise, frags are written to the dcache compactly. */
+
+  fd_dcache_hold_t * hold      = NULL;
+  ulong              chunk_mtu = 0UL;
+  ulong              hold_slot = ULONG_MAX; /* Slot claimed for frag seq, ULONG_MAX if none */
+  ulong              hold_last = 0UL;       /* Slot most recently claimed */
+
+  if( fd_pod_query_cstr( verify_pod, "hold", NULL ) ) {
+    FD_LOG_INFO(( "joining %s.verify.%s.hold", cfg_path, verify_name ));
+    hold = fd_dcache_hold_join( fd_wksp_pod_map( verify_pod, "hold" ) );
+    if( FD_UNLIKELY( !hold ) ) FD_LOG_ERR(( "fd_dcache_hold_join failed" ));
+    ulong slot_cnt = fd_dcache_hold_slot_cnt( hold );
+    if( FD_UNLIKELY( !fd_dcache_hold_is_safe( wksp, dcache, FD_FRANK_VERIFY_MTU, slot_cnt ) ) )
+      FD_LOG_ERR(( "%s.verify.%s.dcache too small for %lu slots of mtu %lu", cfg_path, verify_name, slot_cnt, FD_FRANK_VERIFY_MTU ));
+    if( FD_UNLIKELY( fd_dcache_hold_dist( hold )<depth+1UL ) )
+      FD_LOG_ERR(( "%s.verify.%s.hold was created for a shallower mcache", cfg_path, verify_name ));
+    chunk_mtu = FD_DCACHE_SLOT_FOOTPRINT( FD_FRANK_VERIFY_MTU ) >> FD_CHUNK_LG_SZ;
+    hold_last = slot_cnt - 1UL;
+  } else if( FD_UNLIKELY( !fd_dcache_compact_is_safe( wksp, dcache, FD_FRANK_VERIFY_MTU, depth ) ) )
+    FD_LOG_ERR(( "%s.verify.%s.dcache too small for mtu %lu", cfg_path, verify_name, FD_FRANK_VERIFY_MTU ));
+
+  /* Join this tile's in (if any).  The in producer (e.g. a
+     fd_sock_tile receiving transactions over UDP) publishes raw
+     transactions to in.mcache with the payloads in in.dcache and
+     receives flow control credits from this tile via in.fseq.  Without
+     an in, this tile has nothing to verify (it still runs such that the
+     rest of the pipeline can be exercised). */
+
+  fd_frag_meta_t const * in_mcache = NULL;
+  uchar const *          in_dcache = NULL;
+  ulong *                in_fseq   = NULL;
+  ulong                  in_depth  = 1UL;
+  ulong                  in_seq    = 0UL;
+  fd_frag_meta_t const * in_mline  = NULL;
+  fd_wksp_t *            in_wksp   = NULL;
+  ulong                  in_chunk0 = 0UL;
+  ulong                  in_chunk1 = 0UL;
+
+  uchar const * in_pod = fd_pod_query_subpod( verify_pod, "in" );
+  if( FD_UNLIKELY( !in_pod ) ) FD_LOG_WARNING(( "%s.verify.%s.in not found; nothing to verify", cfg_path, verify_name ));
+  else {
+    FD_LOG_INFO(( "joining %s.verify.%s.in.mcache", cfg_path, verify_name ));
+    in_mcache = fd_mcache_join( fd_wksp_pod_map( in_pod, "mcache" ) );
+    if( FD_UNLIKELY( !in_mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+    in_depth = fd_mcache_depth( in_mcache );
+    in_seq   = fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache ) );
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    FD_LOG_INFO(( "joining %s.verify.%s.in.dcache", cfg_path, verify_name ));
+    in_dcache = fd_dcache_join( fd_wksp_pod_map( in_pod, "dcache" ) );
+    if( FD_UNLIKELY( !in_dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+    in_wksp = fd_wksp_containing( in_dcache );
+    if( FD_UNLIKELY( !in_wksp ) ) FD_LOG_ERR(( "fd_wksp_containing failed" ));
+    in_chunk0 = fd_dcache_compact_chunk0( in_wksp, in_dcache );
+    in_chunk1 = fd_dcache_compact_chunk1( in_wksp, in_dcache );
+
+    FD_LOG_INFO(( "joining %s.verify.%s.in.fseq", cfg_path, verify_name ));
+    in_fseq = fd_fseq_join( fd_wksp_pod_map( in_pod, "fseq" ) );
+    if( FD_UNLIKELY( !in_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+    fd_fseq_update( in_fseq, in_seq );
+  }
+
+  ulong in_accum[6] = { 0UL, 0UL, 0UL, 0UL, 0UL, 0UL }; /* Indexed by FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CNT} */
+
+  /* If the dedup is sharded, each dedup shard consumes all of this
+     tile's output (filtering out the frags for other shards by sig)
+     and returns flow control credits to this tile via its own fseq in
+     shard_fseq.  Otherwise, the dedup tile is the only consumer. */
+
+  uchar const * shard_fseq_pod = fd_pod_query_subpod( verify_pod, "shard_fseq" );
+  ulong rx_cnt = shard_fseq_pod ? fd_pod_cnt( shard_fseq_pod ) : 1UL;
+  if( FD_UNLIKELY( !rx_cnt ) ) FD_LOG_ERR(( "%s.verify.%s.shard_fseq is empty", cfg_path, verify_name ));
+
+  ulong ** fseq = (ulong **)fd_alloca( alignof(ulong *), sizeof(ulong *)*rx_cnt );
+  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  if( !shard_fseq_pod ) {
+    FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
+    fseq[ 0 ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+    if( FD_UNLIKELY( !fseq[ 0 ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  } else {
+    ulong rx_idx = 0UL;
+    for( fd_pod_iter_t iter = fd_pod_iter_init( shard_fseq_pod ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      FD_LOG_INFO(( "joining %s.verify.%s.shard_fseq.%s", cfg_path, verify_name, info.key ));
+      fseq[ rx_idx ] = fd_fseq_join( fd_wksp_pod_map( shard_fseq_pod, info.key ) );
+      if( FD_UNLIKELY( !fseq[ rx_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+      rx_idx++;
+    }
+  }
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq[ rx_idx ] );
+    if( FD_UNLIKELY( !fseq_diag ) ) FD_LOG_ERR(( "fd_fseq_app_laddr failed" ));
+    FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL; /* Managed by the fctl */
+  }
 
   /* Setup local objects used by this tile */
 
@@ -76,20 +181,29 @@ fd_frank_verify_task( int     argc,
   ulong cr_max    = fd_pod_query_ulong( verify_pod, "cr_max",    0UL );
   ulong cr_resume = fd_pod_query_ulong( verify_pod, "cr_resume", 0UL );
   ulong cr_refill = fd_pod_query_ulong( verify_pod, "cr_refill", 0UL );
+  ulong cr_adapt  = fd_pod_query_ulong( verify_pod, "cr_adapt",  1UL );
   long  lazy      = fd_pod_query_long ( verify_pod, "lazy",      0L  );
   FD_LOG_INFO(( "%s.verify.%s.cr_max    %lu", cfg_path, verify_name, cr_max    ));
   FD_LOG_INFO(( "%s.verify.%s.cr_resume %lu", cfg_path, verify_name, cr_resume ));
   FD_LOG_INFO(( "%s.verify.%s.cr_refill %lu", cfg_path, verify_name, cr_refill ));
+  FD_LOG_INFO(( "%s.verify.%s.cr_adapt  %lu", cfg_path, verify_name, cr_adapt  ));
   FD_LOG_INFO(( "%s.verify.%s.lazy      %li", cfg_path, verify_name, lazy      ));
 
-  fd_fctl_t * fctl = fd_fctl_cfg_done( fd_fctl_cfg_rx_add( fd_fctl_join( fd_fctl_new( fd_alloca( FD_FCTL_ALIGN,
-                                                                                                 fd_fctl_footprint( 1UL ) ),
-                                                                                      1UL ) ),
-                                                           depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ),
-                                       1UL /*cr_burst*/, cr_max, cr_resume, cr_refill );
+  fd_fctl_t * fctl = fd_fctl_join( fd_fctl_new( fd_alloca( FD_FCTL_ALIGN, fd_fctl_footprint( rx_cnt ) ), rx_cnt ) );
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq[ rx_idx ] );
+    fctl = fd_fctl_cfg_rx_add( fctl, depth, fseq[ rx_idx ], &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] );
+  }
+  fctl = fd_fctl_cfg_done( fctl, 1UL /*cr_burst*/, cr_max, cr_resume, cr_refill );
   if( FD_UNLIKELY( !fctl ) ) FD_LOG_ERR(( "Unable to create flow control" ));
-  FD_LOG_INFO(( "using cr_burst %lu, cr_max %lu, cr_resume %lu, cr_refill %lu",
-                fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
+  if( cr_adapt ) { /* The chosen thresholds are published to the first rx's fseq diag */
+    ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq[ 0 ] );
+    fctl = fd_fctl_cfg_adapt( fctl, &fseq_diag[ FD_FSEQ_DIAG_CR_RESUME ] );
+    if( FD_UNLIKELY( !fctl ) ) FD_LOG_ERR(( "Unable to enable adaptive flow control" ));
+  }
+  FD_LOG_INFO(( "using cr_burst %lu, cr_max %lu, cr_resume %lu, cr_refill %lu%s",
+                fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ),
+                fd_fctl_adapt( fctl ) ? " (adaptive)" : "" ));
 
   ulong cr_avail = 0UL;
 
@@ -124,6 +238,9 @@ fd_frank_verify_task( int     argc,
 
   ulong accum_sv_filt_cnt = 0UL; ulong accum_sv_filt_sz = 0UL;
 
+  fd_txn_parse_counters_t txn_parse_counters[1];
+  memset( txn_parse_counters, 0, sizeof(fd_txn_parse_counters_t) );
+
   /* Start verifying */
 
   FD_LOG_INFO(( "verify.%s run", verify_name ));
@@ -137,8 +254,9 @@ fd_frank_verify_task( int     argc,
 
     if( FD_UNLIKELY( (now-then)>=0L ) ) {
 
-      /* Send synchronization info */
+      /* Send synchronization info (and wake up any parked consumers) */
       fd_mcache_seq_update( sync, seq );
+      fd_idle_wake( sync, seq );
       FD_COMPILER_MFENCE();
       FD_VOLATILE( *_tcache_sync ) = tcache_oldest;
       FD_COMPILER_MFENCE();
@@ -156,6 +274,18 @@ fd_frank_verify_task( int     argc,
       accum_sv_filt_cnt = 0UL;
       accum_sv_filt_sz  = 0UL;
 
+      /* Send flow control credits to the in and drain its diagnostics.
+         Transactions are copied into this tile's dcache before being
+         verified so everything consumed can be returned immediately. */
+      if( FD_LIKELY( in_fseq ) ) {
+        fd_fseq_update( in_fseq, in_seq );
+        ulong * in_diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+        FD_COMPILER_MFENCE();
+        for( ulong idx=0UL; idx<6UL; idx++ ) in_diag[ idx ] += in_accum[ idx ];
+        FD_COMPILER_MFENCE();
+        for( ulong idx=0UL; idx<6UL; idx++ ) in_accum[ idx ] = 0UL;
+      }
+
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
       if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
@@ -188,26 +318,183 @@ fd_frank_verify_task( int     argc,
       continue;
     }
 
-    /* Placeholder for sig verify */
-    (void)_tcache_map;
-    (void)_tcache_ring;
-    (void)tcache_depth;
-    (void)tcache_map_cnt;
-    (void)chunk;
-    (void)wmark;
+    /* Claim a slot for frag seq if we don't have one yet.  No slot is
+       available only if pack has pinned more transactions than the hold
+       table was sized for.  Treat that like being backpressured. */
+    if( hold && hold_slot==ULONG_MAX ) {
+      hold_slot = fd_dcache_hold_next( hold, hold_last, seq );
+      if( FD_UNLIKELY( hold_slot==ULONG_MAX ) ) {
+        if( FD_UNLIKELY( !in_backp ) ) {
+          FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_IN_BACKP  ] ) = 1UL;
+          FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_CNT ] )+1UL;
+          in_backp = 1;
+        }
+        FD_SPIN_PAUSE();
+        now = fd_tickcount();
+        continue;
+      }
+      hold_last = hold_slot;
+      chunk     = fd_dcache_hold_chunk( chunk0, chunk_mtu, hold_slot );
+    }
+
+    /* Check if there is a new transaction to verify */
+
+    if( FD_UNLIKELY( !in_mcache ) ) {
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    FD_COMPILER_MFENCE();
+    ulong seq_found = in_mline->seq;
+    FD_COMPILER_MFENCE();
+
+    long diff = fd_seq_diff( in_seq, seq_found );
+    if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+      if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if the in is honoring our flow control) */
+        in_seq   = seq_found; /* Resume from here */
+        in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+        in_accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+      } else FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    FD_COMPILER_MFENCE();
+    ulong in_chunk = (ulong)in_mline->chunk;
+    ulong sz       = (ulong)in_mline->sz;
+    ulong ctl      = (ulong)in_mline->ctl;
+    ulong tsorig   = (ulong)in_mline->tsorig;
+    ulong in_tspub = (ulong)in_mline->tspub;
+    FD_COMPILER_MFENCE();
+
+    /* Copy the transaction into our dcache before looking at it (such
+       that the in producer can't modify it between verifying it and
+       publishing it and such that we can return the in's credits
+       immediately).  We sanity check the in chunk range as the in
+       might be untrusted.  An oversized or empty transaction is
+       filtered like a transaction that fails to parse. */
+
+    uchar * payload = (uchar *)fd_chunk_to_laddr( wksp, chunk );
+    int     bad_sz  = (!sz) | (sz>FD_FRANK_TXN_PAYLOAD_MAX) |
+                      (in_chunk<in_chunk0) | ((in_chunk + ((sz+FD_CHUNK_SZ-1UL)>>FD_CHUNK_LG_SZ))>in_chunk1);
+    if( FD_LIKELY( !bad_sz ) ) fd_memcpy( payload, fd_chunk_to_laddr_const( in_wksp, in_chunk ), sz );
+
+    FD_COMPILER_MFENCE();
+    ulong seq_test = in_mline->seq;
+    FD_COMPILER_MFENCE();
+
+    if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading (impossible if the in is honoring our flow control) */
+      in_seq   = seq_test; /* Resume from here */
+      in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+      in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+      now = fd_tickcount();
+      continue;
+    }
+
+    in_seq   = fd_seq_inc( in_seq, 1UL );
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    /* Parse the transaction.  The parsed transaction goes right after
+       the payload in our dcache (see fd_frank.h for the layout). */
+
+    ulong    txn_off = fd_ulong_align_up( sz, 2UL );
+    fd_txn_t * txn   = (fd_txn_t *)(payload + txn_off);
+    ulong    txn_sz  = bad_sz ? 0UL : fd_txn_parse( payload, sz, txn, txn_parse_counters );
+    if( FD_UNLIKELY( !txn_sz ) ) {
+      accum_sv_filt_cnt++;
+      accum_sv_filt_sz += sz;
+      in_accum[ FD_FSEQ_DIAG_FILT_CNT ]++;
+      in_accum[ FD_FSEQ_DIAG_FILT_SZ  ] += sz;
+      now = fd_tickcount();
+      continue;
+    }
+
+    uchar const * sig     = payload + txn->signature_off;
+    uchar const * pub     = payload + txn->acct_addr_off; /* Signers are the first signature_cnt accounts */
+    uchar const * msg     = payload + txn->message_off;
+    ulong         msg_sz  = sz - (ulong)txn->message_off;
+
+    /* The first signature is already effectively a cryptographically
+       secure hash of the transaction.  So use its least significant
+       64-bits as the dedup tag.  We drop redundant copies of a
+       transaction we recently verified (e.g. from ha ingress) before
+       spending any time verifying them.  The tag is only inserted into
+       the tcache after the transaction verifies such that an invalid
+       transaction with a copied signature can't shadow the real one. */
+
+    ulong tag = fd_ulong_load_8( sig );
+    tag = fd_ulong_if( tag==FD_TCACHE_TAG_NULL, 1UL, tag );
+
+    int   ha_dup;
+    ulong map_idx;
+    FD_TCACHE_QUERY( ha_dup, map_idx, _tcache_map, tcache_map_cnt, tag );
+    (void)map_idx;
+    if( FD_UNLIKELY( ha_dup ) ) { /* optimize for the non dup case */
+      accum_ha_filt_cnt++;
+      accum_ha_filt_sz += sz;
+      in_accum[ FD_FSEQ_DIAG_FILT_CNT ]++;
+      in_accum[ FD_FSEQ_DIAG_FILT_SZ  ] += sz;
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Verify all the signatures (they all sign the same message) */
+
+    int err = fd_ed25519_verify_batch_single_msg( msg, msg_sz, sig, pub, sha, (ulong)txn->signature_cnt );
+    if( FD_UNLIKELY( err ) ) {
+      accum_sv_filt_cnt++;
+      accum_sv_filt_sz += sz;
+      in_accum[ FD_FSEQ_DIAG_FILT_CNT ]++;
+      in_accum[ FD_FSEQ_DIAG_FILT_SZ  ] += sz;
+      now = fd_tickcount();
+      continue;
+    }
+
+    FD_TCACHE_INSERT( ha_dup, tcache_oldest, _tcache_ring, tcache_depth, _tcache_map, tcache_map_cnt, tag );
+
+    /* Transaction looks good.  Forward it.  If somebody is opening
+       multiple connections (which would potentially be flow steered to
+       different verify tiles) and spammed these connections with the
+       same transaction, ha dedup here is likely to miss that.  But the
+       dedup tile that muxes all the inputs will take care of that. */
+
+    ulong out_sz = txn_off + txn_sz + 10UL;
+    if( FD_UNLIKELY( txn_off>sz ) ) payload[ sz ] = (uchar)0;
+    FD_STORE( ulong,  payload + out_sz - 10UL, seq );
+    FD_STORE( ushort, payload + out_sz -  2UL, (ushort)sz );
+
     now = fd_tickcount();
+    ulong tspub = fd_frag_meta_ts_comp( now );
+    fd_mcache_publish( mcache, depth, seq, tag, chunk, out_sz, ctl, tsorig, tspub );
+
+    if( hold ) hold_slot = ULONG_MAX; /* Claim a new slot for the next frag */
+    else       chunk     = fd_dcache_compact_next( chunk, out_sz, chunk0, wmark );
+    seq = fd_seq_inc( seq, 1UL );
+    cr_avail--;
+
+    in_accum[ FD_FSEQ_DIAG_PUB_CNT ]++;
+    in_accum[ FD_FSEQ_DIAG_PUB_SZ  ] += sz;
+    fd_fseq_lat_sample( (ulong *)fd_fseq_app_laddr( in_fseq ), now, tsorig, in_tspub );
 
   }
 
   /* Clean up */
 
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
-  FD_LOG_INFO(( "verify.%s fini", verify_name ));
+  FD_LOG_INFO(( "verify.%s fini (txn parse success %lu, failure %lu)", verify_name,
+                txn_parse_counters->success_cnt, txn_parse_counters->failure_cnt ));
   fd_sha512_delete ( fd_sha512_leave( sha    ) );
   fd_tcache_delete ( fd_tcache_leave( tcache ) );
   fd_rng_delete    ( fd_rng_leave   ( rng    ) );
   fd_fctl_delete   ( fd_fctl_leave  ( fctl   ) );
-  fd_wksp_pod_unmap( fd_fseq_leave  ( fseq   ) );
+  for( ulong rx_idx=rx_cnt; rx_idx; rx_idx-- ) fd_wksp_pod_unmap( fd_fseq_leave( fseq[ rx_idx-1UL ] ) );
+  if( in_mcache ) {
+    fd_wksp_pod_unmap( fd_fseq_leave  ( in_fseq   ) );
+    fd_wksp_pod_unmap( fd_dcache_leave( in_dcache ) );
+    fd_wksp_pod_unmap( fd_mcache_leave( in_mcache ) );
+  }
+  if( hold ) fd_wksp_pod_unmap( fd_dcache_hold_leave( hold ) );
   fd_wksp_pod_unmap( fd_dcache_leave( dcache ) );
   fd_wksp_pod_unmap( fd_mcache_leave( mcache ) );
   fd_wksp_pod_unmap( fd_cnc_leave   ( cnc    ) );
@@ -94,6 +94,28 @@ fd_ed25519_verify( void const *  msg,
                    void const *  public_key,
                    fd_sha512_t * sha );
 
+/* fd_ed25519_verify_batch_single_msg verifies batch_sz signatures of
+   the same message (e.g. the signatures of a multi-signer transaction).
+   sig points to batch_sz contiguous 64 byte signatures and public_key
+   points to batch_sz contiguous 32 byte public keys (sig[i] is checked
+   against public_key[i]).  Other arguments and interests are as in
+   fd_ed25519_verify.  Returns FD_ED25519_SUCCESS if all the signatures
+   verified (batch_sz==0 fine) or the FD_ED25519_ERR_* code of the first
+   failure otherwise (the remaining signatures are not checked).
+
+   This is the front end callers that can batch should use (e.g. a
+   verify tile) such that a batched implementation can be swapped in
+   without changing them.  The current implementation verifies the
+   signatures one at a time. */
+
+int
+fd_ed25519_verify_batch_single_msg( void const *  msg,
+                                    ulong         sz,
+                                    void const *  sig,
+                                    void const *  public_key,
+                                    fd_sha512_t * sha,
+                                    ulong         batch_sz );
+
 /* fd_ed25519_strerror converts an FD_ED25519_SUCCESS / FD_ED25519_ERR_*
    code into a human readable cstr.  The lifetime of the returned
    pointer is infinite.  The returned pointer is always to a non-NULL
@@ -430,6 +430,24 @@ fd_ed25519_verify( void const *  msg,
 # endif
 }
 
+int
+fd_ed25519_verify_batch_single_msg( void const *  msg,
+                                    ulong         sz,
+                                    void const *  sig,
+                                    void const *  public_key,
+                                    fd_sha512_t * sha,
+                                    ulong         batch_sz ) {
+  uchar const * s = (uchar const *)sig;
+  uchar const * a = (uchar const *)public_key;
+  for( ulong idx=0UL; idx<batch_sz; idx++ ) {
+    int err = fd_ed25519_verify( msg, sz, s, a, sha );
+    if( FD_UNLIKELY( err ) ) return err;
+    s += 64UL;
+    a += 32UL;
+  }
+  return FD_ED25519_SUCCESS;
+}
+
 char const *
 fd_ed25519_strerror( int err ) {
   switch( err ) {
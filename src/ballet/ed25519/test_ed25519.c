@@ -778,6 +778,46 @@ test_verify( fd_rng_t *    rng,
   }
 }
 
+static void
+test_verify_batch( fd_rng_t *    rng,
+                   fd_sha512_t * sha ) {
+# define BATCH_MAX (8UL)
+  uchar msg[ 256 ];
+  uchar pub[ BATCH_MAX*32UL ];
+  uchar sig[ BATCH_MAX*64UL ];
+  uchar prv[ 32 ];
+
+  for( ulong rem=100UL; rem; rem-- ) {
+    ulong sz       = (ulong)fd_rng_uint_roll( rng, 257U );
+    ulong batch_sz = (ulong)fd_rng_uint_roll( rng, (uint)BATCH_MAX+1U );
+    for( ulong b=0UL; b<sz; b++ ) msg[b] = fd_rng_uchar( rng );
+    for( ulong idx=0UL; idx<batch_sz; idx++ ) {
+      fd_ed25519_public_from_private( pub+32UL*idx, fd_rng_b256( rng, prv ), sha );
+      fd_ed25519_sign( sig+64UL*idx, msg, sz, pub+32UL*idx, prv, sha );
+    }
+    FD_TEST( fd_ed25519_verify_batch_single_msg( msg, sz, sig, pub, sha, batch_sz )==FD_ED25519_SUCCESS );
+    if( !batch_sz ) continue;
+
+    /* Corrupting any one signature should fail the whole batch */
+
+    ulong idx = (ulong)fd_rng_uint_roll( rng, (uint)batch_sz );
+    sig[ 64UL*idx + 1UL ] ^= (uchar)1;
+    FD_TEST( fd_ed25519_verify_batch_single_msg( msg, sz, sig, pub, sha, batch_sz )!=FD_ED25519_SUCCESS );
+    sig[ 64UL*idx + 1UL ] ^= (uchar)1;
+
+    /* As should swapping keys between signers */
+
+    if( batch_sz>1UL ) {
+      uchar tmp[32];
+      memcpy( tmp,       pub,       32UL );
+      memcpy( pub,       pub+32UL,  32UL );
+      memcpy( pub+32UL,  tmp,       32UL );
+      FD_TEST( fd_ed25519_verify_batch_single_msg( msg, sz, sig, pub, sha, batch_sz )!=FD_ED25519_SUCCESS );
+    }
+  }
+# undef BATCH_MAX
+}
+
 /**********************************************************************/
 
 int
@@ -810,6 +850,7 @@ main( int     argc,
   test_public_from_private( rng, sha );
   test_sign               ( rng, sha );
   test_verify             ( rng, sha );
+  test_verify_batch       ( rng, sha );
 
   fd_sha512_delete( fd_sha512_leave( sha ) );
   fd_rng_delete( fd_rng_leave( rng ) );
@@ -7,5 +7,7 @@
 #include "ed25519/fd_ed25519.h" /* Includes sha512/fd_sha512.h */
 #include "poh/fd_poh.h"         /* Includes sha256/fd_sha256.h */
 #include "shred/fd_shred.h"
+#include "txn/fd_txn.h"
+#include "pack/fd_pack.h"         /* Includes txn/fd_txn.h */
 
 #endif /* HEADER_fd_src_ballet_fd_ballet_h */
@@ -0,0 +1,5 @@
+$(call add-hdrs,fd_acct_lock.h fd_pack.h)
+$(call add-objs,fd_acct_lock fd_pack,fd_ballet)
+$(call make-unit-test,test_acct_lock,test_acct_lock,fd_ballet fd_util)
+$(call make-unit-test,test_pack,test_pack,fd_ballet fd_util)
+$(call make-unit-test,bench_pack,bench_pack,fd_ballet fd_util)
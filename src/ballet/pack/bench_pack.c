@@ -0,0 +1,225 @@
+#include "../fd_ballet.h"
+
+#if FD_HAS_HOSTED
+
+#include <stdlib.h> /* For aligned_alloc, free */
+
+/* bench_pack measures how fast a pack can schedule transactions from a
+   synthetic conflict heavy workload.  Every transaction has a unique fee
+   payer, writes --write-cnt other accounts and reads --read-cnt
+   accounts.  Each of the written / read accounts is one of --hot-cnt
+   hot accounts with probability --hot-frac and a random cold account
+   otherwise.  Compute unit limits and prices are random.
+
+   The bench keeps the pack's pool full and cycles through the lanes,
+   completing each lane's previous microblock just before scheduling its
+   next one (i.e. it models infinitely fast executors such that the
+   scheduler is the bottleneck).  A block ends when nothing more fits. */
+
+#define POOL_TXN_CNT (65536UL) /* Number of distinct pregenerated transactions */
+#define ACCT_MAX     (16UL)
+
+static uchar const compute_budget_addr[ 32 ] = {
+  0x03,0x06,0x46,0x6f,0xe5,0x21,0x17,0x32,0xff,0xec,0xad,0xba,0x72,0xc3,0x9b,0xe7,
+  0xbc,0x8c,0xe5,0xbb,0xc5,0xf7,0x12,0x6b,0x2c,0x43,0x9b,0x3a,0x40,0x00,0x00,0x00
+};
+
+struct bench_txn {
+  ulong payload_sz;
+  uchar payload[ FD_TXN_MTU ];
+  uchar txn[ FD_TXN_MAX_SZ ] __attribute__((aligned(8)));
+};
+
+typedef struct bench_txn bench_txn_t;
+
+static void
+bench_acct( uchar *    a,
+            fd_rng_t * rng,
+            ulong      hot_cnt,
+            float      hot_frac ) {
+  ulong idx = (fd_rng_float_c0( rng )<hot_frac) ? fd_rng_ulong_roll( rng, hot_cnt ) : (hot_cnt + fd_rng_ulong( rng ));
+  memset( a, 0, 32UL );
+  FD_STORE( ulong, a,      fd_ulong_hash( idx+1UL ) );
+  FD_STORE( ulong, a+24UL, idx+1UL );
+}
+
+/* bench_txn_gen generates a legacy transaction with a unique fee payer,
+   write_cnt writable accounts, read_cnt readonly accounts, compute
+   budget instructions and one instruction referencing all the
+   accounts.  Returns 1 on success and 0 if the random account choice
+   produced a duplicate account (caller should retry). */
+
+static int
+bench_txn_gen( bench_txn_t * t,
+               fd_rng_t *    rng,
+               ulong         txn_idx,
+               ulong         write_cnt,
+               ulong         read_cnt,
+               ulong         hot_cnt,
+               float         hot_frac ) {
+  uchar acct[ ACCT_MAX ][ 32 ];
+  ulong cnt = 1UL + write_cnt + read_cnt;
+  memset( acct[0], 0, 32UL );
+  FD_STORE( ulong, acct[0],      fd_ulong_hash( ~txn_idx ) ); /* fee payer */
+  FD_STORE( ulong, acct[0]+24UL, ~txn_idx                  );
+  for( ulong a=1UL; a<cnt; a++ ) {
+    bench_acct( acct[a], rng, hot_cnt, hot_frac );
+    for( ulong b=0UL; b<a; b++ ) if( !memcmp( acct[a], acct[b], 32UL ) ) return 0;
+  }
+
+  uchar * buf = t->payload;
+  ulong   i   = 0UL;
+  buf[ i++ ] = (uchar)1;
+  for( ulong b=0UL; b<64UL; b++ ) buf[ i++ ] = fd_rng_uchar( rng );
+  buf[ i++ ] = (uchar)1;
+  buf[ i++ ] = (uchar)0;
+  buf[ i++ ] = (uchar)(read_cnt + 2UL);
+  buf[ i++ ] = (uchar)(cnt + 2UL);
+  for( ulong a=0UL; a<cnt; a++ ) { fd_memcpy( buf+i, acct[a], 32UL ); i += 32UL; }
+  memset( buf+i, 0xaa, 32UL ); i += 32UL;
+  fd_memcpy( buf+i, compute_budget_addr, 32UL ); i += 32UL;
+  memset( buf+i, 0x55, 32UL ); i += 32UL;
+  buf[ i++ ] = (uchar)3;
+  buf[ i++ ] = (uchar)(cnt+1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)5;
+  buf[ i++ ] = (uchar)2; FD_STORE( uint,  buf+i, 1000U + fd_rng_uint_roll( rng, 400000U ) ); i += 4UL;
+  buf[ i++ ] = (uchar)(cnt+1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)9;
+  buf[ i++ ] = (uchar)3; FD_STORE( ulong, buf+i, fd_rng_ulong_roll( rng, 100000UL ) ); i += 8UL;
+  buf[ i++ ] = (uchar)cnt;
+  buf[ i++ ] = (uchar)cnt;
+  for( ulong a=0UL; a<cnt; a++ ) buf[ i++ ] = (uchar)a;
+  buf[ i++ ] = (uchar)0;
+
+  t->payload_sz = i;
+  if( FD_UNLIKELY( !fd_txn_parse( t->payload, i, t->txn, NULL ) ) ) FD_LOG_ERR(( "fd_txn_parse failed" ));
+  return 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong txn_max        = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-max",        NULL, 4096UL    );
+  ulong lane_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--lane-cnt",       NULL, 4UL       );
+  ulong microblock_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--microblock-max", NULL, 32UL      );
+  ulong write_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--write-cnt",      NULL, 2UL       );
+  ulong read_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--read-cnt",       NULL, 2UL       );
+  ulong hot_cnt        = fd_env_strip_cmdline_ulong( &argc, &argv, "--hot-cnt",        NULL, 16UL      );
+  float hot_frac       = fd_env_strip_cmdline_float( &argc, &argv, "--hot-frac",       NULL, 0.25f     );
+  long  duration       = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",       NULL, (long)1e9 );
+  uint  seed           = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",           NULL, 0U        );
+
+  if( FD_UNLIKELY( 1UL+write_cnt+read_cnt>ACCT_MAX ) ) FD_LOG_ERR(( "--write-cnt + --read-cnt too large for this bench" ));
+  if( FD_UNLIKELY( !hot_cnt                        ) ) FD_LOG_ERR(( "--hot-cnt should be positive" ));
+
+  FD_LOG_NOTICE(( "--txn-max %lu --lane-cnt %lu --microblock-max %lu --write-cnt %lu --read-cnt %lu --hot-cnt %lu --hot-frac %g "
+                  "--duration %li --seed %u",
+                  txn_max, lane_cnt, microblock_max, write_cnt, read_cnt, hot_cnt, (double)hot_frac, duration, seed ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+
+  FD_LOG_NOTICE(( "Generating workload" ));
+
+  bench_txn_t * txn = (bench_txn_t *)aligned_alloc( 64UL, POOL_TXN_CNT*sizeof(bench_txn_t) );
+  if( FD_UNLIKELY( !txn ) ) FD_LOG_ERR(( "aligned_alloc failed" ));
+  for( ulong txn_idx=0UL; txn_idx<POOL_TXN_CNT; txn_idx++ )
+    while( !bench_txn_gen( txn + txn_idx, rng, txn_idx, write_cnt, read_cnt, hot_cnt, hot_frac ) ) ;
+
+  FD_LOG_NOTICE(( "Creating pack" ));
+
+  ulong footprint = fd_pack_footprint( txn_max, lane_cnt, microblock_max );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "bad --txn-max, --lane-cnt and/or --microblock-max" ));
+  void * mem = aligned_alloc( fd_pack_align(), footprint );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "aligned_alloc failed" ));
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( mem, txn_max, lane_cnt, microblock_max, 0UL, fd_rng_ulong( rng ) ) );
+  if( FD_UNLIKELY( !pack ) ) FD_LOG_ERR(( "fd_pack_join failed" ));
+
+  fd_pack_txn_t const ** out = (fd_pack_txn_t const **)aligned_alloc( 64UL, fd_ulong_align_up( microblock_max*sizeof(void *), 64UL ) );
+  if( FD_UNLIKELY( !out ) ) FD_LOG_ERR(( "aligned_alloc failed" ));
+
+  FD_LOG_NOTICE(( "Running" ));
+
+  ulong next_txn       = 0UL;
+  ulong lane_idx       = 0UL;
+  ulong insert_cnt     = 0UL;
+  ulong reject_cnt     = 0UL;
+  ulong sched_cnt      = 0UL;
+  ulong microblock_cnt = 0UL;
+  ulong block_cnt      = 0UL;
+  ulong block_cu       = 0UL;
+  ulong idle_cnt       = 0UL; /* Consecutive schedules that produced nothing */
+
+  long dt_insert = 0L;
+  long dt_sched  = 0L;
+  long t0        = fd_log_wallclock();
+  long tick0     = fd_tickcount();
+  long tstop     = t0 + duration;
+  for(;;) {
+
+    long ts0 = fd_tickcount();
+    while( fd_pack_pending_cnt( pack )<txn_max ) {
+      bench_txn_t const * t = txn + next_txn;
+      next_txn = fd_ulong_if( next_txn+1UL<POOL_TXN_CNT, next_txn+1UL, 0UL );
+      int err = fd_pack_insert( pack, t->payload, t->payload_sz, (fd_txn_t const *)t->txn );
+      insert_cnt++;
+      reject_cnt += (ulong)(err<0);
+    }
+    long ts1 = fd_tickcount();
+
+    fd_pack_microblock_complete( pack, lane_idx );
+    ulong cnt = fd_pack_schedule( pack, lane_idx, out );
+    long ts2 = fd_tickcount();
+
+    dt_insert += ts1 - ts0;
+    dt_sched  += ts2 - ts1;
+
+    sched_cnt      += cnt;
+    microblock_cnt += (ulong)(!!cnt);
+    idle_cnt = fd_ulong_if( !!cnt, 0UL, idle_cnt+1UL );
+    if( FD_UNLIKELY( idle_cnt>=lane_cnt ) ) { /* Nothing fits in any lane, start a new block */
+      block_cu += fd_pack_block_cu_used( pack );
+      block_cnt++;
+      fd_pack_end_block( pack );
+      idle_cnt = 0UL;
+    }
+    lane_idx = fd_ulong_if( lane_idx+1UL<lane_cnt, lane_idx+1UL, 0UL );
+
+    if( FD_UNLIKELY( !lane_idx ) && fd_log_wallclock()>=tstop ) break;
+  }
+  long dt    = fd_log_wallclock() - t0;
+  long dtick = fd_tickcount()     - tick0;
+
+  double tick_per_ns = (double)dtick / (double)dt;
+  FD_LOG_NOTICE(( "scheduled %lu txn in %lu microblocks (%.1f txn / microblock) over %lu blocks (%.1f%% cu full) in %.3f s",
+                  sched_cnt, microblock_cnt, (double)sched_cnt / (double)fd_ulong_max( microblock_cnt, 1UL ),
+                  block_cnt, 100.*(double)block_cu / ((double)fd_ulong_max( block_cnt, 1UL )*(double)fd_pack_block_cu_max( pack )),
+                  1e-9*(double)dt ));
+  FD_LOG_NOTICE(( "%.3f Mtxn/s scheduled (%.1f ns / txn insert, %.1f ns / txn schedule, %lu of %lu inserts rejected)",
+                  1e3*(double)sched_cnt / (double)dt,
+                  (double)dt_insert / (tick_per_ns*(double)fd_ulong_max( insert_cnt, 1UL )),
+                  (double)dt_sched  / (tick_per_ns*(double)fd_ulong_max( sched_cnt,  1UL )),
+                  reject_cnt, insert_cnt ));
+
+  for( ulong idx=0UL; idx<lane_cnt; idx++ ) fd_pack_microblock_complete( pack, idx );
+  free( out );
+  free( fd_pack_delete( fd_pack_leave( pack ) ) );
+  free( txn );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
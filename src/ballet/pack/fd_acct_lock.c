@@ -0,0 +1,318 @@
+#include "fd_acct_lock.h"
+
+#define FD_ACCT_LOCK_MAGIC (0xf17eda2c37acc100UL) /* firedancer acct lock ver 0 */
+
+/* FD_ACCT_LOCK_ACCT_MAX bounds acct_max such that the map (which keeps
+   its hashes in a uint and is kept at most half full) can address all
+   of its slots and footprint calculations can't overflow. */
+
+#define FD_ACCT_LOCK_ACCT_MAX (1UL<<30)
+
+/* An account address as a map key.  Addresses are loaded as 4 ulongs
+   such that key comparisons are cheap.  Account addresses can be
+   chosen by users so the key is hashed over all 32 bytes with the
+   table's seed (otherwise, it would be cheap to craft many addresses
+   that collide and degrade the map to linear scans).  The map template
+   hashes a key without access to the table, so the seeded hash is
+   computed once when the key is made and carried in the key. */
+
+struct fd_acct_lock_private_addr {
+  ulong b[4];
+  uint  hash; /* fd_hash( seed, b, 32 ) truncated, 0 for the null key */
+};
+
+typedef struct fd_acct_lock_private_addr fd_acct_lock_private_addr_t;
+
+static fd_acct_lock_private_addr_t const fd_acct_lock_private_addr_null = { { 0UL, 0UL, 0UL, 0UL }, 0U };
+
+FD_FN_PURE static inline fd_acct_lock_private_addr_t
+fd_acct_lock_private_addr( uchar const * addr,
+                           ulong         seed ) {
+  fd_acct_lock_private_addr_t a;
+  a.b[0] = fd_ulong_load_8( addr      );
+  a.b[1] = fd_ulong_load_8( addr+ 8UL );
+  a.b[2] = fd_ulong_load_8( addr+16UL );
+  a.b[3] = fd_ulong_load_8( addr+24UL );
+  a.hash = (uint)fd_hash( seed, a.b, 32UL );
+  return a;
+}
+
+FD_FN_CONST static inline int
+fd_acct_lock_private_addr_eq( fd_acct_lock_private_addr_t a,
+                              fd_acct_lock_private_addr_t b ) {
+  return !((a.b[0]^b.b[0]) | (a.b[1]^b.b[1]) | (a.b[2]^b.b[2]) | (a.b[3]^b.b[3]));
+}
+
+FD_FN_CONST static inline int
+fd_acct_lock_private_addr_is_null( fd_acct_lock_private_addr_t a ) {
+  return !(a.b[0] | a.b[1] | a.b[2] | a.b[3]);
+}
+
+/* The lock table proper.  An entry exists for every account currently
+   locked. */
+
+struct fd_acct_lock_private_entry {
+  fd_acct_lock_private_addr_t key;
+  uint                        hash;
+  ulong                       writer;     /* Owner of the write lock, FD_ACCT_LOCK_OWNER_NULL if not write locked */
+  ulong                       reader_cnt; /* Number of read locks */
+};
+
+typedef struct fd_acct_lock_private_entry fd_acct_lock_private_entry_t;
+
+#define MAP_NAME              fd_acct_lock_private_map
+#define MAP_T                 fd_acct_lock_private_entry_t
+#define MAP_KEY_T             fd_acct_lock_private_addr_t
+#define MAP_KEY_NULL          fd_acct_lock_private_addr_null
+#define MAP_KEY_INVAL(k)      fd_acct_lock_private_addr_is_null( (k) )
+#define MAP_KEY_EQUAL(k0,k1)  fd_acct_lock_private_addr_eq( (k0), (k1) )
+#define MAP_KEY_EQUAL_IS_SLOW 1
+#define MAP_KEY_HASH(k)       ((k).hash)
+#include "../../util/tmpl/fd_map_dynamic.c"
+
+/* A lock table's memory region is the header followed by the map
+   (referenced by offset such that the table can be mapped at different
+   addresses). */
+
+struct __attribute__((aligned(FD_ACCT_LOCK_ALIGN))) fd_acct_lock_private {
+  ulong magic; /* ==FD_ACCT_LOCK_MAGIC */
+  ulong acct_max;
+  ulong seed;
+  int   lg_slot_cnt;
+  ulong map_off;
+};
+
+FD_FN_CONST static inline int
+fd_acct_lock_private_lg_slot_cnt( ulong acct_max ) {
+  return fd_ulong_find_msb( 2UL*acct_max ) + 1; /* Keep the map at most half full */
+}
+
+FD_FN_CONST static inline ulong
+fd_acct_lock_private_map_off( void ) {
+  return fd_ulong_align_up( sizeof(fd_acct_lock_t), fd_acct_lock_private_map_align() );
+}
+
+static inline fd_acct_lock_private_entry_t *
+fd_acct_lock_private_map( fd_acct_lock_t const * lock ) {
+  return fd_acct_lock_private_map_join( (void *)((ulong)lock + lock->map_off) );
+}
+
+ulong
+fd_acct_lock_align( void ) {
+  return FD_ACCT_LOCK_ALIGN;
+}
+
+ulong
+fd_acct_lock_footprint( ulong acct_max ) {
+  if( FD_UNLIKELY( (!acct_max) | (acct_max>FD_ACCT_LOCK_ACCT_MAX) ) ) return 0UL;
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, FD_ACCT_LOCK_ALIGN,                sizeof(fd_acct_lock_t) );
+  l = FD_LAYOUT_APPEND( l, fd_acct_lock_private_map_align(), fd_acct_lock_private_map_footprint( fd_acct_lock_private_lg_slot_cnt( acct_max ) ) );
+  return FD_LAYOUT_FINI( l, FD_ACCT_LOCK_ALIGN );
+}
+
+void *
+fd_acct_lock_new( void * shmem,
+                  ulong  acct_max,
+                  ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_acct_lock_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_acct_lock_footprint( acct_max ) ) ) {
+    FD_LOG_WARNING(( "bad acct_max (%lu)", acct_max ));
+    return NULL;
+  }
+
+  fd_acct_lock_t * lock = (fd_acct_lock_t *)shmem;
+  fd_memset( lock, 0, sizeof(fd_acct_lock_t) );
+
+  lock->acct_max    = acct_max;
+  lock->seed        = seed;
+  lock->lg_slot_cnt = fd_acct_lock_private_lg_slot_cnt( acct_max );
+  lock->map_off     = fd_acct_lock_private_map_off();
+
+  fd_acct_lock_private_map_new( (void *)((ulong)lock + lock->map_off), lock->lg_slot_cnt );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( lock->magic ) = FD_ACCT_LOCK_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_acct_lock_t *
+fd_acct_lock_join( void * shlock ) {
+
+  if( FD_UNLIKELY( !shlock ) ) {
+    FD_LOG_WARNING(( "NULL shlock" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shlock, fd_acct_lock_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shlock" ));
+    return NULL;
+  }
+
+  fd_acct_lock_t * lock = (fd_acct_lock_t *)shlock;
+  if( FD_UNLIKELY( lock->magic!=FD_ACCT_LOCK_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return lock;
+}
+
+void *
+fd_acct_lock_leave( fd_acct_lock_t * lock ) {
+
+  if( FD_UNLIKELY( !lock ) ) {
+    FD_LOG_WARNING(( "NULL lock" ));
+    return NULL;
+  }
+
+  return (void *)lock;
+}
+
+void *
+fd_acct_lock_delete( void * shlock ) {
+
+  if( FD_UNLIKELY( !shlock ) ) {
+    FD_LOG_WARNING(( "NULL shlock" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shlock, fd_acct_lock_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shlock" ));
+    return NULL;
+  }
+
+  fd_acct_lock_t * lock = (fd_acct_lock_t *)shlock;
+  if( FD_UNLIKELY( lock->magic!=FD_ACCT_LOCK_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( lock->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shlock;
+}
+
+ulong fd_acct_lock_acct_max( fd_acct_lock_t const * lock ) { return lock->acct_max; }
+ulong fd_acct_lock_seed    ( fd_acct_lock_t const * lock ) { return lock->seed;     }
+
+ulong
+fd_acct_lock_acct_cnt( fd_acct_lock_t const * lock ) {
+  return fd_acct_lock_private_map_key_cnt( fd_acct_lock_private_map( lock ) );
+}
+
+/* fd_acct_lock_private_check returns 1 if the account set conflicts
+   with the currently held locks and 0 otherwise.  If it doesn't
+   conflict, *_new_cnt will hold the number of accounts in the set that
+   aren't currently locked on return. */
+
+static inline int
+fd_acct_lock_private_check( fd_acct_lock_private_entry_t * map,
+                            ulong                          seed,
+                            uchar const *                  addr,
+                            ulong                          acct_cnt,
+                            ulong                          writable,
+                            ulong *                        _new_cnt ) {
+  ulong new_cnt = 0UL;
+  for( ulong acct_idx=0UL; acct_idx<acct_cnt; acct_idx++ ) {
+    fd_acct_lock_private_addr_t key = fd_acct_lock_private_addr( addr + acct_idx*FD_ACCT_LOCK_ADDR_SZ, seed );
+    if( FD_UNLIKELY( fd_acct_lock_private_addr_is_null( key ) ) ) continue;
+    fd_acct_lock_private_entry_t * entry = fd_acct_lock_private_map_query( map, key, NULL );
+    if( FD_LIKELY( !entry ) ) { new_cnt++; continue; }
+    int write_locked = entry->writer!=FD_ACCT_LOCK_OWNER_NULL;
+    if( (writable>>acct_idx) & 1UL ) { if( write_locked | (!!entry->reader_cnt) ) return 1; }
+    else                             { if( write_locked                         ) return 1; }
+  }
+  *_new_cnt = new_cnt;
+  return 0;
+}
+
+int
+fd_acct_lock_conflict( fd_acct_lock_t const * lock,
+                       uchar const *          addr,
+                       ulong                  acct_cnt,
+                       ulong                  writable ) {
+  ulong new_cnt;
+  return fd_acct_lock_private_check( fd_acct_lock_private_map( lock ), lock->seed, addr, acct_cnt, writable, &new_cnt );
+}
+
+int
+fd_acct_lock_acquire( fd_acct_lock_t * lock,
+                      uchar const *    addr,
+                      ulong            acct_cnt,
+                      ulong            writable,
+                      ulong            owner ) {
+
+  fd_acct_lock_private_entry_t * map  = fd_acct_lock_private_map( lock );
+  ulong                          seed = lock->seed;
+
+  ulong new_cnt;
+  if( FD_UNLIKELY( fd_acct_lock_private_check( map, seed, addr, acct_cnt, writable, &new_cnt ) ) ) return FD_ACCT_LOCK_ERR_CONFLICT;
+  if( FD_UNLIKELY( new_cnt > lock->acct_max - fd_acct_lock_private_map_key_cnt( map ) ) ) return FD_ACCT_LOCK_ERR_FULL;
+
+  for( ulong acct_idx=0UL; acct_idx<acct_cnt; acct_idx++ ) {
+    fd_acct_lock_private_addr_t key = fd_acct_lock_private_addr( addr + acct_idx*FD_ACCT_LOCK_ADDR_SZ, seed );
+    if( FD_UNLIKELY( fd_acct_lock_private_addr_is_null( key ) ) ) continue;
+    fd_acct_lock_private_entry_t * entry = fd_acct_lock_private_map_query( map, key, NULL );
+    if( FD_LIKELY( !entry ) ) {
+      entry = fd_acct_lock_private_map_insert( map, key ); /* Can't fail (checked above) */
+      entry->writer     = FD_ACCT_LOCK_OWNER_NULL;
+      entry->reader_cnt = 0UL;
+    }
+    if( (writable>>acct_idx) & 1UL ) entry->writer = owner;
+    else                             entry->reader_cnt++;
+  }
+
+  return FD_ACCT_LOCK_SUCCESS;
+}
+
+void
+fd_acct_lock_release( fd_acct_lock_t * lock,
+                      uchar const *    addr,
+                      ulong            acct_cnt,
+                      ulong            writable ) {
+
+  fd_acct_lock_private_entry_t * map  = fd_acct_lock_private_map( lock );
+  ulong                          seed = lock->seed;
+
+  for( ulong acct_idx=0UL; acct_idx<acct_cnt; acct_idx++ ) {
+    fd_acct_lock_private_addr_t key = fd_acct_lock_private_addr( addr + acct_idx*FD_ACCT_LOCK_ADDR_SZ, seed );
+    if( FD_UNLIKELY( fd_acct_lock_private_addr_is_null( key ) ) ) continue;
+    fd_acct_lock_private_entry_t * entry = fd_acct_lock_private_map_query( map, key, NULL );
+    if( (writable>>acct_idx) & 1UL ) entry->writer = FD_ACCT_LOCK_OWNER_NULL;
+    else                             entry->reader_cnt--;
+    if( (entry->writer==FD_ACCT_LOCK_OWNER_NULL) & (!entry->reader_cnt) ) fd_acct_lock_private_map_remove( map, entry );
+  }
+}
+
+ulong
+fd_acct_lock_reader_cnt( fd_acct_lock_t const * lock,
+                         uchar const *          addr ) {
+  fd_acct_lock_private_addr_t key = fd_acct_lock_private_addr( addr, lock->seed );
+  if( FD_UNLIKELY( fd_acct_lock_private_addr_is_null( key ) ) ) return 0UL;
+  fd_acct_lock_private_entry_t * entry = fd_acct_lock_private_map_query( fd_acct_lock_private_map( lock ), key, NULL );
+  return entry ? entry->reader_cnt : 0UL;
+}
+
+ulong
+fd_acct_lock_writer( fd_acct_lock_t const * lock,
+                     uchar const *          addr ) {
+  fd_acct_lock_private_addr_t key = fd_acct_lock_private_addr( addr, lock->seed );
+  if( FD_UNLIKELY( fd_acct_lock_private_addr_is_null( key ) ) ) return FD_ACCT_LOCK_OWNER_NULL;
+  fd_acct_lock_private_entry_t * entry = fd_acct_lock_private_map_query( fd_acct_lock_private_map( lock ), key, NULL );
+  return entry ? entry->writer : FD_ACCT_LOCK_OWNER_NULL;
+}
@@ -0,0 +1,167 @@
+#ifndef HEADER_fd_src_ballet_pack_fd_acct_lock_h
+#define HEADER_fd_src_ballet_pack_fd_acct_lock_h
+
+/* fd_acct_lock is a table of account read / write locks keyed by 32
+   byte account address.  It is used to ensure that transactions being
+   executed in parallel (e.g. by multiple executor lanes) don't
+   conflict: any number of transactions can hold a read lock on an
+   account but a write lock on an account is exclusive.
+
+   Locks are acquired and released a transaction's worth of accounts at
+   a time.  An acquire is all-or-nothing: if any account in the set
+   can't be locked as requested, no locks are acquired.  Acquire,
+   release and conflict checks cost O(1) per account in the set.  The
+   table tracks, for each currently locked account, the number of read
+   locks held on it and the owner of its write lock (if any).  The owner
+   is an arbitrary user provided tag (e.g. an executor lane index) to
+   facilitate diagnostics.
+
+   A lock table does not contain any pointers so it can be placed in a
+   wksp and joined by multiple tiles (possibly at different local
+   addresses).  Operations are not atomic though.  Users are responsible
+   for serializing modifications and for not reading concurrently with
+   them (e.g. the pack tile is the only one to acquire and release locks
+   and executor tiles only inspect the table while the pack tile is
+   known to be quiescent).
+
+   The all zero address (the system program) is never locked.  It is a
+   reserved account (it is demoted to read only by the runtime if
+   requested writable) so it never conflicts.  This is also the
+   natural null key for the underlying map. */
+
+#include "../fd_ballet_base.h"
+
+/* FD_ACCT_LOCK_ALIGN gives the required alignment of a memory region
+   for a lock table.  (Footprint is a function of acct_max.) */
+
+#define FD_ACCT_LOCK_ALIGN (128UL)
+
+/* FD_ACCT_LOCK_ADDR_SZ is the size of an account address.
+   FD_ACCT_LOCK_SET_ACCT_MAX is the maximum number of accounts in a
+   set (the writable mask is a ulong). */
+
+#define FD_ACCT_LOCK_ADDR_SZ      (32UL)
+#define FD_ACCT_LOCK_SET_ACCT_MAX (64UL)
+
+/* FD_ACCT_LOCK_OWNER_NULL is the owner of the write lock of an account
+   that is not write locked. */
+
+#define FD_ACCT_LOCK_OWNER_NULL (ULONG_MAX)
+
+/* FD_ACCT_LOCK_{SUCCESS,ERR_*} are the return values of
+   fd_acct_lock_acquire. */
+
+#define FD_ACCT_LOCK_SUCCESS      ( 0) /* All locks acquired */
+#define FD_ACCT_LOCK_ERR_CONFLICT (-1) /* Conflicts with a currently held lock, no locks acquired */
+#define FD_ACCT_LOCK_ERR_FULL     (-2) /* Too many locked accounts, no locks acquired */
+
+struct fd_acct_lock_private;
+typedef struct fd_acct_lock_private fd_acct_lock_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_acct_lock_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a lock table that
+   can have up to acct_max distinct accounts locked at once.  align
+   returns FD_ACCT_LOCK_ALIGN.  If acct_max is zero or too large,
+   footprint silently returns 0 (so can be used by the caller to
+   validate the parameters).
+
+   fd_acct_lock_new formats a memory region with the appropriate
+   alignment and footprint into a lock table.  seed is an arbitrary
+   value used to seed the table's account address hash (addresses are
+   user controlled so this should be chosen unpredictably, e.g. from a
+   rng, to make it hard to craft colliding addresses).  Returns shmem
+   on success and NULL on failure (logs details).  The table starts with
+   no locks held.
+
+   fd_acct_lock_join joins the caller to a lock table.  Returns a local
+   handle on success and NULL on failure (logs details).
+   fd_acct_lock_leave leaves a current local join and returns the
+   underlying shared memory region.  fd_acct_lock_delete unformats a
+   memory region used as a lock table and returns ownership of it to the
+   caller. */
+
+FD_FN_CONST ulong
+fd_acct_lock_align( void );
+
+FD_FN_CONST ulong
+fd_acct_lock_footprint( ulong acct_max );
+
+void *
+fd_acct_lock_new( void * shmem,
+                  ulong  acct_max,
+                  ulong  seed );
+
+fd_acct_lock_t * fd_acct_lock_join  ( void *           shlock );
+void *           fd_acct_lock_leave ( fd_acct_lock_t * lock   );
+void *           fd_acct_lock_delete( void *           shlock );
+
+/* fd_acct_lock_{acct_max,seed} return the values used to create the
+   lock table.  fd_acct_lock_acct_cnt returns the number of distinct
+   accounts currently locked.  Assumes lock is a current local join. */
+
+FD_FN_PURE ulong fd_acct_lock_acct_max( fd_acct_lock_t const * lock );
+FD_FN_PURE ulong fd_acct_lock_seed    ( fd_acct_lock_t const * lock );
+FD_FN_PURE ulong fd_acct_lock_acct_cnt( fd_acct_lock_t const * lock );
+
+/* An account set is given by acct_cnt contiguous 32 byte account
+   addresses starting at addr (e.g. the account addresses of a
+   transaction payload, which need not be aligned) and a mask writable
+   whose bit i is set if the set wants to write lock account i (and
+   clear if it wants to read lock it).  acct_cnt is in
+   [0,FD_ACCT_LOCK_SET_ACCT_MAX] and the addresses in a set are assumed
+   to be distinct.
+
+   fd_acct_lock_conflict returns 1 if the account set can't be locked
+   given the currently held locks (some account wanted writable is read
+   or write locked, or some account wanted read only is write locked)
+   and 0 otherwise.
+
+   fd_acct_lock_acquire acquires the locks for an account set.  owner
+   is recorded as the owner of the write locks acquired (should not be
+   FD_ACCT_LOCK_OWNER_NULL).  Returns FD_ACCT_LOCK_SUCCESS on success
+   and a FD_ACCT_LOCK_ERR_* code on failure (no locks are acquired).
+
+   fd_acct_lock_release releases the locks for an account set.  Assumes
+   the set currently holds its locks (i.e. the same set was
+   successfully acquired and has not been released since).
+
+   These assume lock is a current local join. */
+
+FD_FN_PURE int
+fd_acct_lock_conflict( fd_acct_lock_t const * lock,
+                       uchar const *          addr,
+                       ulong                  acct_cnt,
+                       ulong                  writable );
+
+int
+fd_acct_lock_acquire( fd_acct_lock_t * lock,
+                      uchar const *    addr,
+                      ulong            acct_cnt,
+                      ulong            writable,
+                      ulong            owner );
+
+void
+fd_acct_lock_release( fd_acct_lock_t * lock,
+                      uchar const *    addr,
+                      ulong            acct_cnt,
+                      ulong            writable );
+
+/* fd_acct_lock_reader_cnt returns the number of read locks currently
+   held on the account with the given 32 byte address.
+   fd_acct_lock_writer returns the owner of its write lock
+   (FD_ACCT_LOCK_OWNER_NULL if it is not write locked).  Assumes lock is
+   a current local join. */
+
+FD_FN_PURE ulong
+fd_acct_lock_reader_cnt( fd_acct_lock_t const * lock,
+                         uchar const *          addr );
+
+FD_FN_PURE ulong
+fd_acct_lock_writer( fd_acct_lock_t const * lock,
+                     uchar const *          addr );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_pack_fd_acct_lock_h */
@@ -0,0 +1,548 @@
+#include "fd_pack.h"
+
+#define FD_PACK_MAGIC (0xf17eda2c37bac000UL) /* firedancer pack ver 0 */
+
+/* FD_PACK_{TXN,LANE,MICROBLOCK}_MAX bound the pack parameters such that
+   pool indices fit in a uint and footprint calculations can't
+   overflow. */
+
+#define FD_PACK_TXN_MAX        (1UL<<24)
+#define FD_PACK_LANE_MAX       (1024UL)
+#define FD_PACK_MICROBLOCK_MAX (1024UL)
+
+/* FD_PACK_SCAN_MULT gives the maximum number of conflicting or over
+   budget pending transactions skipped over while scheduling a
+   microblock as a multiple of microblock_max.  FD_PACK_EVICT_SCAN_MAX
+   is the maximum number of pending transactions examined to find one
+   to replace when the pool is full. */
+
+#define FD_PACK_SCAN_MULT      (4UL)
+#define FD_PACK_EVICT_SCAN_MAX (64UL)
+
+/* The compute budget program's address (base58
+   ComputeBudget111111111111111111111111111111) and its instructions we
+   care about. */
+
+static uchar const fd_pack_private_compute_budget_addr[ FD_TXN_ACCT_ADDR_SZ ] = {
+  0x03,0x06,0x46,0x6f,0xe5,0x21,0x17,0x32,0xff,0xec,0xad,0xba,0x72,0xc3,0x9b,0xe7,
+  0xbc,0x8c,0xe5,0xbb,0xc5,0xf7,0x12,0x6b,0x2c,0x43,0x9b,0x3a,0x40,0x00,0x00,0x00
+};
+
+#define FD_PACK_PRIVATE_CB_REQUEST_UNITS_DEPRECATED (0) /* u32 units, u32 additional fee */
+#define FD_PACK_PRIVATE_CB_SET_CU_LIMIT             (2) /* u32 units */
+#define FD_PACK_PRIVATE_CB_SET_CU_PRICE             (3) /* u64 micro-lamports per unit */
+
+/* fd_pack_private_addr_eq returns 1 if the 32 byte account addresses
+   at a and b are the same and 0 otherwise. */
+
+FD_FN_PURE static inline int
+fd_pack_private_addr_eq( uchar const * a,
+                         uchar const * b ) {
+  return !( (fd_ulong_load_8( a      ) ^ fd_ulong_load_8( b      )) |
+            (fd_ulong_load_8( a+ 8UL ) ^ fd_ulong_load_8( b+ 8UL )) |
+            (fd_ulong_load_8( a+16UL ) ^ fd_ulong_load_8( b+16UL )) |
+            (fd_ulong_load_8( a+24UL ) ^ fd_ulong_load_8( b+24UL )) );
+}
+
+/* Pending transaction priority queue.  A max queue on pri. */
+
+struct fd_pack_private_ord {
+  double pri;
+  ulong  txn_idx;
+};
+
+typedef struct fd_pack_private_ord fd_pack_private_ord_t;
+
+#define PRQ_NAME               fd_pack_private_ordq
+#define PRQ_T                  fd_pack_private_ord_t
+#define PRQ_TIMEOUT            pri
+#define PRQ_TIMEOUT_T          double
+#define PRQ_TIMEOUT_AFTER(x,y) ((x)<(y))
+#include "../../util/tmpl/fd_prq.c"
+
+/* A pack's memory region is laid out as:
+
+     fd_pack_private_t header
+     fd_pack_txn_t     pool[ pool_cnt ]           (pending and scheduled transactions)
+     uint              free[ pool_cnt ]           (stack of free pool indices)
+     ordq              with room for txn_max      (pending transactions by priority)
+     fd_acct_lock_t    with room for acct_max     (account locks)
+     ulong             lane_txn_cnt[ lane_cnt ]
+     uint              lane_txn[ lane_cnt ][ microblock_max ] (pool indices of scheduled transactions)
+     fd_pack_private_ord_t skip[ scan_max ]       (scratch for scheduling)
+
+   where pool_cnt = txn_max + lane_cnt*microblock_max (such that there
+   is always a free pool slot when there is room for another pending
+   transaction).  Everything is referenced by offset from the header
+   such that the pack can be mapped at different addresses. */
+
+struct __attribute__((aligned(FD_PACK_ALIGN))) fd_pack_private {
+  ulong magic; /* ==FD_PACK_MAGIC */
+  ulong txn_max;
+  ulong lane_cnt;
+  ulong microblock_max;
+  ulong block_cu_max;
+  ulong pool_cnt;
+  ulong scan_max;
+  ulong acct_max;
+
+  ulong block_cu_used;
+  ulong block_txn_cnt;
+  ulong free_cnt;
+
+  ulong pool_off;
+  ulong free_off;
+  ulong ordq_off;
+  ulong acct_off;
+  ulong lane_txn_cnt_off;
+  ulong lane_txn_off;
+  ulong skip_off;
+};
+
+typedef struct fd_pack_private fd_pack_private_t;
+
+/* fd_pack_private_layout computes the layout of a pack with the given
+   parameters, storing the offsets in pack (if non-NULL).  Returns the
+   footprint on success and 0 if the parameters are invalid. */
+
+static ulong
+fd_pack_private_layout( ulong       txn_max,
+                        ulong       lane_cnt,
+                        ulong       microblock_max,
+                        fd_pack_t * pack ) {
+
+  if( FD_UNLIKELY( (!txn_max       ) | (txn_max       >FD_PACK_TXN_MAX       ) |
+                   (!lane_cnt      ) | (lane_cnt      >FD_PACK_LANE_MAX      ) |
+                   (!microblock_max) | (microblock_max>FD_PACK_MICROBLOCK_MAX) ) ) return 0UL;
+
+  ulong pool_cnt         = txn_max + lane_cnt*microblock_max;
+  ulong scan_max         = FD_PACK_SCAN_MULT*microblock_max;
+  ulong acct_max         = lane_cnt*microblock_max*FD_PACK_TXN_ACCT_MAX; /* Max accounts locked at once */
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, FD_PACK_ALIGN, sizeof(fd_pack_private_t) );
+  ulong pool_off         = fd_ulong_align_up( l, alignof(fd_pack_txn_t)          ); l = pool_off         + pool_cnt*sizeof(fd_pack_txn_t);
+  ulong free_off         = fd_ulong_align_up( l, alignof(uint)                   ); l = free_off         + pool_cnt*sizeof(uint);
+  ulong ordq_off         = fd_ulong_align_up( l, fd_pack_private_ordq_align()    ); l = ordq_off         + fd_pack_private_ordq_footprint( txn_max );
+  ulong acct_off         = fd_ulong_align_up( l, fd_acct_lock_align()            ); l = acct_off         + fd_acct_lock_footprint( acct_max );
+  ulong lane_txn_cnt_off = fd_ulong_align_up( l, alignof(ulong)                  ); l = lane_txn_cnt_off + lane_cnt*sizeof(ulong);
+  ulong lane_txn_off     = fd_ulong_align_up( l, alignof(uint)                   ); l = lane_txn_off     + lane_cnt*microblock_max*sizeof(uint);
+  ulong skip_off         = fd_ulong_align_up( l, alignof(fd_pack_private_ord_t)  ); l = skip_off         + scan_max*sizeof(fd_pack_private_ord_t);
+  l = FD_LAYOUT_FINI( l, FD_PACK_ALIGN );
+
+  if( pack ) {
+    pack->txn_max          = txn_max;
+    pack->lane_cnt         = lane_cnt;
+    pack->microblock_max   = microblock_max;
+    pack->pool_cnt         = pool_cnt;
+    pack->scan_max         = scan_max;
+    pack->acct_max         = acct_max;
+    pack->pool_off         = pool_off;
+    pack->free_off         = free_off;
+    pack->ordq_off         = ordq_off;
+    pack->acct_off         = acct_off;
+    pack->lane_txn_cnt_off = lane_txn_cnt_off;
+    pack->lane_txn_off     = lane_txn_off;
+    pack->skip_off         = skip_off;
+  }
+
+  return l;
+}
+
+/* Local addresses of the pack's components.  (The ordq and acct lock
+   joins are just pointer arithmetic.) */
+
+FD_FN_PURE static inline fd_pack_txn_t *         fd_pack_private_pool        ( fd_pack_t * pack ) { return (fd_pack_txn_t *)((ulong)pack + pack->pool_off); }
+FD_FN_PURE static inline uint *                  fd_pack_private_free        ( fd_pack_t * pack ) { return (uint *)((ulong)pack + pack->free_off); }
+FD_FN_PURE static inline ulong *                 fd_pack_private_lane_txn_cnt( fd_pack_t * pack ) { return (ulong *)((ulong)pack + pack->lane_txn_cnt_off); }
+FD_FN_PURE static inline uint *                  fd_pack_private_lane_txn    ( fd_pack_t * pack ) { return (uint *)((ulong)pack + pack->lane_txn_off); }
+FD_FN_PURE static inline fd_pack_private_ord_t * fd_pack_private_skip        ( fd_pack_t * pack ) { return (fd_pack_private_ord_t *)((ulong)pack + pack->skip_off); }
+
+static inline fd_pack_private_ord_t * fd_pack_private_ordq( fd_pack_t * pack ) { return fd_pack_private_ordq_join( (void *)((ulong)pack + pack->ordq_off) ); }
+static inline fd_acct_lock_t *        fd_pack_private_acct( fd_pack_t * pack ) { return fd_acct_lock_join        ( (void *)((ulong)pack + pack->acct_off) ); }
+
+void
+fd_pack_estimate( uchar const *    payload,
+                  fd_txn_t const * txn,
+                  ulong *          _reward,
+                  ulong *          _cost ) {
+
+  ulong sig_cnt      = (ulong)txn->signature_cnt;
+  ulong acct_cnt     = (ulong)txn->acct_addr_cnt;
+  uchar const * addr = payload + (ulong)txn->acct_addr_off;
+
+  int   cu_limit_set = 0;
+  ulong cu_limit     = 0UL;
+  ulong cu_price     = 0UL;
+  ulong adtl_fee     = 0UL;
+  ulong instr_cnt    = 0UL; /* Non compute budget instructions */
+
+  for( ulong instr_idx=0UL; instr_idx<(ulong)txn->instr_cnt; instr_idx++ ) {
+    fd_txn_instr_t const * instr = txn->instr + instr_idx;
+    ulong program_id = (ulong)instr->program_id;
+    if( FD_LIKELY( (program_id>=acct_cnt) ||
+                   memcmp( addr + program_id*FD_TXN_ACCT_ADDR_SZ, fd_pack_private_compute_budget_addr, FD_TXN_ACCT_ADDR_SZ ) ) ) {
+      instr_cnt++;
+      continue;
+    }
+
+    uchar const * data    = payload + (ulong)instr->data_off;
+    ulong         data_sz = (ulong)instr->data_sz;
+    if( FD_UNLIKELY( !data_sz ) ) continue;
+    switch( data[0] ) {
+    case FD_PACK_PRIVATE_CB_REQUEST_UNITS_DEPRECATED:
+      if( FD_UNLIKELY( data_sz!=9UL ) ) break;
+      cu_limit_set = 1;
+      cu_limit     = fd_ulong_load_4( data+1UL );
+      adtl_fee     = fd_ulong_load_4( data+5UL );
+      break;
+    case FD_PACK_PRIVATE_CB_SET_CU_LIMIT:
+      if( FD_UNLIKELY( data_sz!=5UL ) ) break;
+      cu_limit_set = 1;
+      cu_limit     = fd_ulong_load_4( data+1UL );
+      break;
+    case FD_PACK_PRIVATE_CB_SET_CU_PRICE:
+      if( FD_UNLIKELY( data_sz!=9UL ) ) break;
+      cu_price     = fd_ulong_load_8( data+1UL );
+      break;
+    default:
+      break;
+    }
+  }
+
+  if( !cu_limit_set ) cu_limit = instr_cnt*FD_PACK_DEFAULT_INSTR_CU;
+  cu_limit = fd_ulong_min( cu_limit, FD_PACK_MAX_TXN_CU );
+
+  /* Priority fee is ceil( cu_limit*cu_price / 1e6 ), saturating.  Note
+     cu_limit<2^21 so the numerator only overflows for absurd prices. */
+
+  ulong priority_fee;
+  if( FD_UNLIKELY( cu_limit && (cu_price>(ULONG_MAX-999999UL)/cu_limit) ) ) priority_fee = ULONG_MAX/1000000UL;
+  else                                                                      priority_fee = (cu_limit*cu_price + 999999UL) / 1000000UL;
+
+  ulong writable_cnt = (sig_cnt - (ulong)txn->readonly_signed_cnt) + (acct_cnt - sig_cnt - (ulong)txn->readonly_unsigned_cnt);
+
+  *_reward = FD_PACK_LAMPORTS_PER_SIGNATURE*sig_cnt + priority_fee + adtl_fee;
+  *_cost   = cu_limit + FD_PACK_COST_PER_SIGNATURE*sig_cnt + FD_PACK_COST_PER_WRITE_LOCK*writable_cnt;
+}
+
+ulong
+fd_pack_align( void ) {
+  return FD_PACK_ALIGN;
+}
+
+ulong
+fd_pack_footprint( ulong txn_max,
+                   ulong lane_cnt,
+                   ulong microblock_max ) {
+  return fd_pack_private_layout( txn_max, lane_cnt, microblock_max, NULL );
+}
+
+void *
+fd_pack_new( void * shmem,
+             ulong  txn_max,
+             ulong  lane_cnt,
+             ulong  microblock_max,
+             ulong  block_cu_max,
+             ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_pack_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_pack_footprint( txn_max, lane_cnt, microblock_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad txn_max (%lu), lane_cnt (%lu) and/or microblock_max (%lu)", txn_max, lane_cnt, microblock_max ));
+    return NULL;
+  }
+
+  if( !block_cu_max ) block_cu_max = FD_PACK_DEFAULT_BLOCK_CU_MAX;
+
+  fd_pack_t * pack = (fd_pack_t *)shmem;
+  fd_memset( pack, 0, sizeof(fd_pack_private_t) );
+  fd_pack_private_layout( txn_max, lane_cnt, microblock_max, pack );
+
+  pack->block_cu_max  = block_cu_max;
+  pack->block_cu_used = 0UL;
+  pack->block_txn_cnt = 0UL;
+
+  ulong  pool_cnt = pack->pool_cnt;
+  uint * free     = fd_pack_private_free( pack );
+  for( ulong idx=0UL; idx<pool_cnt; idx++ ) free[ idx ] = (uint)(pool_cnt-1UL-idx);
+  pack->free_cnt = pool_cnt;
+
+  fd_pack_private_ordq_new( (void *)((ulong)pack + pack->ordq_off), txn_max                );
+  fd_acct_lock_new        ( (void *)((ulong)pack + pack->acct_off), pack->acct_max, seed );
+
+  ulong * lane_txn_cnt = fd_pack_private_lane_txn_cnt( pack );
+  for( ulong lane_idx=0UL; lane_idx<lane_cnt; lane_idx++ ) lane_txn_cnt[ lane_idx ] = 0UL;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( pack->magic ) = FD_PACK_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_pack_t *
+fd_pack_join( void * shpack ) {
+
+  if( FD_UNLIKELY( !shpack ) ) {
+    FD_LOG_WARNING(( "NULL shpack" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shpack, fd_pack_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shpack" ));
+    return NULL;
+  }
+
+  fd_pack_t * pack = (fd_pack_t *)shpack;
+  if( FD_UNLIKELY( pack->magic!=FD_PACK_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return pack;
+}
+
+void *
+fd_pack_leave( fd_pack_t * pack ) {
+
+  if( FD_UNLIKELY( !pack ) ) {
+    FD_LOG_WARNING(( "NULL pack" ));
+    return NULL;
+  }
+
+  return (void *)pack;
+}
+
+void *
+fd_pack_delete( void * shpack ) {
+
+  if( FD_UNLIKELY( !shpack ) ) {
+    FD_LOG_WARNING(( "NULL shpack" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shpack, fd_pack_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shpack" ));
+    return NULL;
+  }
+
+  fd_pack_t * pack = (fd_pack_t *)shpack;
+  if( FD_UNLIKELY( pack->magic!=FD_PACK_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( pack->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shpack;
+}
+
+ulong fd_pack_txn_max       ( fd_pack_t const * pack ) { return pack->txn_max;        }
+ulong fd_pack_lane_cnt      ( fd_pack_t const * pack ) { return pack->lane_cnt;       }
+ulong fd_pack_microblock_max( fd_pack_t const * pack ) { return pack->microblock_max; }
+ulong fd_pack_block_cu_max  ( fd_pack_t const * pack ) { return pack->block_cu_max;   }
+ulong fd_pack_block_cu_used ( fd_pack_t const * pack ) { return pack->block_cu_used;  }
+ulong fd_pack_block_txn_cnt ( fd_pack_t const * pack ) { return pack->block_txn_cnt;  }
+
+ulong
+fd_pack_pending_cnt( fd_pack_t const * pack ) {
+  return fd_pack_private_ordq_cnt( fd_pack_private_ordq( (fd_pack_t *)pack ) );
+}
+
+ulong
+fd_pack_lane_txn_cnt( fd_pack_t const * pack,
+                      ulong             lane_idx ) {
+  return fd_pack_private_lane_txn_cnt( (fd_pack_t *)pack )[ lane_idx ];
+}
+
+ulong
+fd_pack_pending_ref( fd_pack_t const * pack,
+                     ulong             idx ) {
+  fd_pack_private_ord_t const * ordq = fd_pack_private_ordq( (fd_pack_t *)pack );
+  return fd_pack_private_pool( (fd_pack_t *)pack )[ ordq[ idx ].txn_idx ].ref;
+}
+
+int
+fd_pack_insert_ref( fd_pack_t *      pack,
+                    uchar const *    payload,
+                    ulong            payload_sz,
+                    fd_txn_t const * txn,
+                    ulong            ref,
+                    ulong *          _evict_ref ) {
+
+  if( FD_UNLIKELY( payload_sz>FD_TXN_MTU                  ) ) return FD_PACK_INSERT_REJECT_SZ;
+  if( FD_UNLIKELY( txn->addr_table_lookup_cnt             ) ) return FD_PACK_INSERT_REJECT_ADDR_TABLE;
+  ulong acct_cnt = (ulong)txn->acct_addr_cnt;
+  if( FD_UNLIKELY( acct_cnt>FD_PACK_TXN_ACCT_MAX           ) ) return FD_PACK_INSERT_REJECT_ACCT_CNT;
+
+  /* The runtime rejects transactions that reference an account more
+     than once.  We do too (it would also confuse the lock accounting).
+     acct_cnt is small so a quadratic check is fine. */
+
+  uchar const * addr = payload + (ulong)txn->acct_addr_off;
+  for( ulong i=1UL; i<acct_cnt; i++ )
+    for( ulong j=0UL; j<i; j++ )
+      if( FD_UNLIKELY( fd_pack_private_addr_eq( addr + i*FD_TXN_ACCT_ADDR_SZ, addr + j*FD_TXN_ACCT_ADDR_SZ ) ) )
+        return FD_PACK_INSERT_REJECT_DUP_ACCT;
+
+  /* Writable accounts are the first signature_cnt-readonly_signed_cnt
+     signers and the first acct_cnt-signature_cnt-readonly_unsigned_cnt
+     non-signers. */
+
+  ulong sig_cnt        = (ulong)txn->signature_cnt;
+  ulong writable_cnt_s = sig_cnt  - (ulong)txn->readonly_signed_cnt;
+  ulong writable_cnt_u = acct_cnt - sig_cnt - (ulong)txn->readonly_unsigned_cnt;
+  ulong acct_writable  = fd_ulong_mask_lsb( (int)writable_cnt_s ) | (fd_ulong_mask_lsb( (int)writable_cnt_u ) << sig_cnt);
+
+  ulong reward;
+  ulong cost;
+  fd_pack_estimate( payload, txn, &reward, &cost );
+  double pri = (double)reward / (double)cost;
+
+  /* If the pool is full, replace the lowest priority pending
+     transaction we can find quickly.  The minimum of a max heap is one
+     of its leaves.  We only look at the last few (they are at the
+     deepest level and thus tend to be the lowest priority) to bound
+     the cost of an insert under heavy load. */
+
+  fd_pack_private_ord_t * ordq = fd_pack_private_ordq( pack );
+  fd_pack_txn_t *         pool = fd_pack_private_pool( pack );
+  uint *                  free = fd_pack_private_free( pack );
+
+  int   ret = FD_PACK_INSERT_ACCEPT;
+  ulong cnt = fd_pack_private_ordq_cnt( ordq );
+  if( FD_UNLIKELY( cnt>=pack->txn_max ) ) {
+    ulong lo      = fd_ulong_max( cnt>>1, cnt - fd_ulong_min( cnt, FD_PACK_EVICT_SCAN_MAX ) );
+    ulong min_idx = lo;
+    for( ulong idx=lo+1UL; idx<cnt; idx++ ) min_idx = fd_ulong_if( ordq[ idx ].pri<ordq[ min_idx ].pri, idx, min_idx );
+    if( FD_UNLIKELY( ordq[ min_idx ].pri>=pri ) ) return FD_PACK_INSERT_REJECT_PRIORITY;
+    ulong evict_idx = ordq[ min_idx ].txn_idx;
+    *_evict_ref = pool[ evict_idx ].ref;
+    free[ pack->free_cnt++ ] = (uint)evict_idx;
+    fd_pack_private_ordq_remove( ordq, min_idx );
+    ret = FD_PACK_INSERT_REPLACE;
+  }
+
+  ulong           txn_idx = (ulong)free[ --pack->free_cnt ];
+  fd_pack_txn_t * ptxn    = pool + txn_idx;
+
+  ptxn->pri                   = pri;
+  ptxn->reward                = reward;
+  ptxn->cost                  = (uint)cost;
+  ptxn->payload_sz            = (ushort)payload_sz;
+  ptxn->acct_addr_off         = txn->acct_addr_off;
+  ptxn->acct_addr_cnt         = (uchar)acct_cnt;
+  ptxn->signature_cnt         = txn->signature_cnt;
+  ptxn->acct_writable         = acct_writable;
+  ptxn->ext                   = ref==FD_PACK_TXN_REF_NULL ? NULL : payload;
+  ptxn->ref                   = ref;
+  if( !ptxn->ext ) fd_memcpy( ptxn->payload, payload, payload_sz );
+
+  fd_pack_private_ord_t ord[1];
+  ord->pri     = pri;
+  ord->txn_idx = txn_idx;
+  fd_pack_private_ordq_insert( ordq, ord );
+
+  return ret;
+}
+
+int
+fd_pack_insert( fd_pack_t *      pack,
+                uchar const *    payload,
+                ulong            payload_sz,
+                fd_txn_t const * txn ) {
+  ulong evict_ref;
+  return fd_pack_insert_ref( pack, payload, payload_sz, txn, FD_PACK_TXN_REF_NULL, &evict_ref );
+}
+
+ulong
+fd_pack_schedule( fd_pack_t *            pack,
+                  ulong                  lane_idx,
+                  fd_pack_txn_t const ** out ) {
+
+  ulong * lane_txn_cnt = fd_pack_private_lane_txn_cnt( pack );
+  if( FD_UNLIKELY( lane_txn_cnt[ lane_idx ] ) ) return 0UL; /* Lane busy */
+
+  fd_pack_private_ord_t *  ordq     = fd_pack_private_ordq( pack );
+  fd_acct_lock_t *         acct     = fd_pack_private_acct( pack );
+  fd_pack_txn_t *          pool     = fd_pack_private_pool( pack );
+  fd_pack_private_ord_t *  skip     = fd_pack_private_skip( pack );
+  ulong                    mb_max   = pack->microblock_max;
+  uint *                   lane_txn = fd_pack_private_lane_txn( pack ) + lane_idx*mb_max;
+  ulong                    scan_max = pack->scan_max;
+
+  ulong cu_rem   = pack->block_cu_max - pack->block_cu_used;
+  ulong cnt      = 0UL;
+  ulong skip_cnt = 0UL;
+
+  while( (cnt<mb_max) & (skip_cnt<scan_max) & (!!fd_pack_private_ordq_cnt( ordq )) ) {
+    fd_pack_private_ord_t ord = ordq[0];
+    fd_pack_private_ordq_remove_min( ordq );
+
+    /* The lock table is sized for the worst case so an acquire only
+       fails on a conflict */
+
+    fd_pack_txn_t * txn = pool + ord.txn_idx;
+    if( FD_UNLIKELY( ((ulong)txn->cost>cu_rem) ||
+                     fd_acct_lock_acquire( acct, fd_pack_txn_acct_addr( txn, 0UL ), (ulong)txn->acct_addr_cnt,
+                                           txn->acct_writable, lane_idx ) ) ) {
+      skip[ skip_cnt++ ] = ord;
+      continue;
+    }
+
+    lane_txn[ cnt ] = (uint)ord.txn_idx;
+    out     [ cnt ] = txn;
+    cnt++;
+    cu_rem -= (ulong)txn->cost;
+  }
+
+  /* Put the skipped transactions back for later microblocks */
+
+  for( ulong skip_idx=0UL; skip_idx<skip_cnt; skip_idx++ ) fd_pack_private_ordq_insert( ordq, skip + skip_idx );
+
+  lane_txn_cnt[ lane_idx ] = cnt;
+  pack->block_cu_used      = pack->block_cu_max - cu_rem;
+  pack->block_txn_cnt     += cnt;
+  return cnt;
+}
+
+void
+fd_pack_microblock_complete( fd_pack_t * pack,
+                             ulong       lane_idx ) {
+
+  ulong * lane_txn_cnt = fd_pack_private_lane_txn_cnt( pack );
+  ulong   cnt          = lane_txn_cnt[ lane_idx ];
+  if( FD_UNLIKELY( !cnt ) ) return;
+
+  fd_acct_lock_t *         acct     = fd_pack_private_acct( pack );
+  fd_pack_txn_t *          pool     = fd_pack_private_pool( pack );
+  uint *                   free     = fd_pack_private_free( pack );
+  uint const *             lane_txn = fd_pack_private_lane_txn( pack ) + lane_idx*pack->microblock_max;
+
+  for( ulong idx=0UL; idx<cnt; idx++ ) {
+    uint txn_idx = lane_txn[ idx ];
+    fd_pack_txn_t const * txn = pool + txn_idx;
+    fd_acct_lock_release( acct, fd_pack_txn_acct_addr( txn, 0UL ), (ulong)txn->acct_addr_cnt, txn->acct_writable );
+    free[ pack->free_cnt++ ] = txn_idx;
+  }
+
+  lane_txn_cnt[ lane_idx ] = 0UL;
+}
+
+void
+fd_pack_end_block( fd_pack_t * pack ) {
+  pack->block_cu_used = 0UL;
+  pack->block_txn_cnt = 0UL;
+}
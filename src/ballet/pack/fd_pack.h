@@ -0,0 +1,291 @@
+#ifndef HEADER_fd_src_ballet_pack_fd_pack_h
+#define HEADER_fd_src_ballet_pack_fd_pack_h
+
+/* fd_pack is a block packing scheduler.  A pack holds a bounded pool of
+   pending transactions ordered by estimated reward per compute unit and
+   schedules them into microblocks for lane_cnt downstream executor
+   lanes.
+
+   Each lane executes at most one microblock at a time.  The transactions
+   in all microblocks currently scheduled (over all lanes) never
+   conflict: an account written by one of them is not read or written by
+   any other.  That is, the lanes can execute their microblocks in
+   parallel in any interleaving and get the same result as executing
+   them serially in the order they were scheduled.  The pack tracks this
+   with read / write locks on the accounts referenced by the scheduled
+   transactions (in a fd_acct_lock table, the write locks are owned by
+   the lane index).  The locks are acquired when a microblock is
+   scheduled and released when the lane reports the microblock
+   complete.
+
+   Scheduling is greedy: the highest priority pending transactions that
+   do not conflict with anything currently scheduled and that fit in the
+   block's remaining compute budget go into the microblock.  Pending
+   transactions that conflict are skipped over (and retried for later
+   microblocks) such that a hot account does not stall the whole pool.
+   The number of transactions examined per microblock is bounded.
+
+   A pack is a tile local object (it is not safe for concurrent use by
+   multiple threads) but it can live in a wksp (e.g. to allow inspection
+   from a debugger) as it does not contain any pointers (other than to
+   the payloads of transactions inserted by reference, see
+   fd_pack_insert_ref).
+
+   Transactions that use address lookup tables are not currently
+   supported (their full account set can't be known without the
+   accounts database) and are rejected on insert. */
+
+#include "../txn/fd_txn.h"
+#include "fd_acct_lock.h"
+
+/* FD_PACK_ALIGN gives the required alignment of a memory region for a
+   pack.  (Footprint is a function of the pack's parameters.) */
+
+#define FD_PACK_ALIGN (128UL)
+
+/* FD_PACK_TXN_ACCT_MAX is the maximum number of accounts a transaction
+   inserted into a pack can reference (at most 35 can fit in a
+   FD_TXN_MTU payload). */
+
+#define FD_PACK_TXN_ACCT_MAX (35UL)
+
+/* FD_PACK_DEFAULT_BLOCK_CU_MAX is a reasonable default for the compute
+   unit limit of a block. */
+
+#define FD_PACK_DEFAULT_BLOCK_CU_MAX (48000000UL)
+
+/* Constants used to estimate the reward and cost of a transaction (see
+   fd_pack_estimate below). */
+
+#define FD_PACK_LAMPORTS_PER_SIGNATURE (5000UL)    /* Base fee per signature */
+#define FD_PACK_DEFAULT_INSTR_CU       (200000UL)  /* Compute units per instruction if not requested */
+#define FD_PACK_MAX_TXN_CU             (1400000UL) /* Max compute units a transaction can request */
+#define FD_PACK_COST_PER_SIGNATURE     (720UL)     /* Cost in compute units of verifying a signature */
+#define FD_PACK_COST_PER_WRITE_LOCK    (300UL)     /* Cost in compute units of a write lock */
+
+/* FD_PACK_INSERT_* are the return values of fd_pack_insert.
+   Non-negative values indicate the transaction was accepted and
+   negative values indicate the transaction was rejected. */
+
+#define FD_PACK_INSERT_ACCEPT            ( 0) /* Accepted */
+#define FD_PACK_INSERT_REPLACE           ( 1) /* Accepted, replaced a lower priority pending transaction */
+#define FD_PACK_INSERT_REJECT_PRIORITY   (-1) /* Pool full, priority too low to replace anything */
+#define FD_PACK_INSERT_REJECT_ADDR_TABLE (-2) /* Uses address lookup tables */
+#define FD_PACK_INSERT_REJECT_ACCT_CNT   (-3) /* Too many accounts */
+#define FD_PACK_INSERT_REJECT_DUP_ACCT   (-4) /* References the same account more than once */
+#define FD_PACK_INSERT_REJECT_SZ         (-5) /* Payload larger than FD_TXN_MTU */
+
+/* FD_PACK_TXN_REF_NULL is the ref of a transaction inserted by copy
+   (see fd_pack_insert_ref). */
+
+#define FD_PACK_TXN_REF_NULL (ULONG_MAX)
+
+/* A fd_pack_txn_t holds a transaction in a pack.  The transaction
+   payload is stored as received, either in payload (inserted by copy)
+   or in caller memory at ext (inserted by reference).  The other fields
+   are derived from the parsed transaction on insert. */
+
+struct __attribute__((aligned(64))) fd_pack_txn {
+  double pri;              /* reward / cost, in lamports per compute unit */
+  ulong  reward;           /* Estimated reward for including this transaction (lamports) */
+  ulong  acct_writable;    /* Bit i set if the transaction write locks account i (see fd_acct_lock.h) */
+  uint   cost;             /* Estimated compute units this transaction will consume */
+  ushort payload_sz;       /* In [1,FD_TXN_MTU] */
+  ushort acct_addr_off;    /* Offset of the account addresses in payload */
+  uchar  acct_addr_cnt;    /* In [1,FD_PACK_TXN_ACCT_MAX] */
+  uchar  signature_cnt;
+  uchar const * ext;       /* Location of the payload if inserted by reference, NULL if inserted by copy */
+  ulong  ref;              /* Caller's reference to the payload if inserted by reference, FD_PACK_TXN_REF_NULL if by copy */
+  uchar  payload[ FD_TXN_MTU ];
+};
+
+typedef struct fd_pack_txn fd_pack_txn_t;
+
+struct fd_pack_private;
+typedef struct fd_pack_private fd_pack_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_pack_txn_payload returns a pointer to the payload of txn
+   (payload_sz bytes).  fd_pack_txn_acct_addr returns a pointer to the
+   32-byte address of the acct_idx account referenced by txn.  fd_pack_txn_acct_is_writable
+   returns 1 if the transaction write locks that account and 0 if it
+   only read locks it.  Assumes acct_idx<txn->acct_addr_cnt. */
+
+FD_FN_PURE static inline uchar const *
+fd_pack_txn_payload( fd_pack_txn_t const * txn ) {
+  return txn->ext ? txn->ext : txn->payload;
+}
+
+FD_FN_PURE static inline uchar const *
+fd_pack_txn_acct_addr( fd_pack_txn_t const * txn,
+                       ulong                 acct_idx ) {
+  return fd_pack_txn_payload( txn ) + (ulong)txn->acct_addr_off + acct_idx*FD_TXN_ACCT_ADDR_SZ;
+}
+
+FD_FN_PURE static inline int
+fd_pack_txn_acct_is_writable( fd_pack_txn_t const * txn,
+                              ulong                 acct_idx ) {
+  return (int)((txn->acct_writable >> acct_idx) & 1UL);
+}
+
+/* fd_pack_estimate estimates the reward and cost of including the
+   transaction with the given payload and parsed representation in a
+   block.  The reward is the base fee (FD_PACK_LAMPORTS_PER_SIGNATURE
+   per signature) plus the priority fee (the compute unit limit times
+   the compute unit price, as requested via compute budget program
+   instructions).  The cost is the compute unit limit (as requested via
+   the compute budget program or FD_PACK_DEFAULT_INSTR_CU per non compute
+   budget instruction if not requested, capped at FD_PACK_MAX_TXN_CU)
+   plus signature verification and write lock overheads.  The cost is
+   always positive.  Malformed compute budget instructions are ignored
+   (the runtime will fail such a transaction but it still pays its base
+   fee). */
+
+void
+fd_pack_estimate( uchar const *    payload,
+                  fd_txn_t const * txn,
+                  ulong *          _reward,
+                  ulong *          _cost );
+
+/* fd_pack_{align,footprint} return the required alignment and footprint
+   of a memory region suitable for use as a pack that can hold up to
+   txn_max pending transactions and schedule microblocks of up to
+   microblock_max transactions for up to lane_cnt lanes.  align returns
+   FD_PACK_ALIGN.  If any parameter is zero or too large, footprint
+   silently returns 0 (so can be used by the caller to validate the
+   parameters).
+
+   fd_pack_new formats a memory region with the appropriate alignment
+   and footprint into a pack.  block_cu_max is the compute unit limit of
+   a block (0 indicates to use FD_PACK_DEFAULT_BLOCK_CU_MAX).  seed
+   seeds the hash of the pack's account lock table (see
+   fd_acct_lock_new).  Returns shmem on success and NULL on failure (logs details).  The pack
+   starts with no pending transactions, all lanes idle and an empty
+   block.
+
+   fd_pack_join joins the caller to a pack.  Returns a local handle on
+   success and NULL on failure (logs details).  fd_pack_leave leaves a
+   current local join and returns the underlying shared memory region.
+   fd_pack_delete unformats a memory region used as a pack and returns
+   ownership of it to the caller. */
+
+FD_FN_CONST ulong
+fd_pack_align( void );
+
+FD_FN_CONST ulong
+fd_pack_footprint( ulong txn_max,
+                   ulong lane_cnt,
+                   ulong microblock_max );
+
+void *
+fd_pack_new( void * shmem,
+             ulong  txn_max,
+             ulong  lane_cnt,
+             ulong  microblock_max,
+             ulong  block_cu_max,
+             ulong  seed );
+
+fd_pack_t * fd_pack_join  ( void *      shpack );
+void *      fd_pack_leave ( fd_pack_t * pack   );
+void *      fd_pack_delete( void *      shpack );
+
+/* Accessors.  txn_max, lane_cnt, microblock_max and block_cu_max return
+   the values used to create the pack.  pending_cnt returns the number
+   of transactions currently waiting to be scheduled.  block_cu_used and
+   block_txn_cnt return the compute units and number of transactions
+   scheduled in the current block so far.  lane_txn_cnt returns the
+   number of transactions in the microblock lane is currently executing
+   (0 if the lane is idle).  pending_ref returns the ref of pending
+   transaction idx (in no particular order, idx in [0,pending_cnt), e.g.
+   to release the payloads of pending transactions inserted by
+   reference before deleting the pack).  Assumes pack is a current
+   local join. */
+
+FD_FN_PURE ulong fd_pack_txn_max       ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_lane_cnt      ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_microblock_max( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_block_cu_max  ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_pending_cnt   ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_block_cu_used ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_block_txn_cnt ( fd_pack_t const * pack );
+FD_FN_PURE ulong fd_pack_lane_txn_cnt  ( fd_pack_t const * pack, ulong lane_idx );
+FD_FN_PURE ulong fd_pack_pending_ref   ( fd_pack_t const * pack, ulong idx      );
+
+/* fd_pack_insert inserts the transaction with the given payload and
+   parsed representation into the pack's pool of pending transactions.
+   The pack copies what it needs and has no interest in payload or txn
+   on return.  If the pool is full, the transaction replaces a lower
+   priority pending transaction (if one can be found quickly) and is
+   rejected otherwise.  Returns a FD_PACK_INSERT_* code.  Assumes pack
+   is a current local join and txn is the result of successfully parsing
+   payload_sz bytes at payload. */
+
+int
+fd_pack_insert( fd_pack_t *      pack,
+                uchar const *    payload,
+                ulong            payload_sz,
+                fd_txn_t const * txn );
+
+/* fd_pack_insert_ref is the same as fd_pack_insert but, if ref is not
+   FD_PACK_TXN_REF_NULL, the payload is not copied.  Instead, the pack
+   keeps a pointer to it and the caller promises the payload_sz bytes at
+   payload are stable until the transaction leaves the pack (e.g. by
+   pinning them in a dcache hold table, see fd_dcache.h).  ref is an
+   arbitrary caller value identifying the payload.  A transaction
+   leaves the pack when it is rejected on insert (the return is
+   negative), when it is evicted by a later insert (on
+   FD_PACK_INSERT_REPLACE, *_evict_ref holds the evicted transaction's
+   ref, FD_PACK_TXN_REF_NULL if it was inserted by copy, and is
+   unchanged otherwise) or when the microblock it was scheduled into is
+   completed (txn->ref, read before calling
+   fd_pack_microblock_complete).  The transaction's ext field points to
+   payload in the caller's address space, so a pack holding
+   transactions inserted by reference should only be used by the thread
+   group that inserted them. */
+
+int
+fd_pack_insert_ref( fd_pack_t *      pack,
+                    uchar const *    payload,
+                    ulong            payload_sz,
+                    fd_txn_t const * txn,
+                    ulong            ref,
+                    ulong *          _evict_ref );
+
+/* fd_pack_schedule schedules a microblock for lane lane_idx.  On return,
+   out[i] for i in [0,cnt) points to the transactions in the microblock
+   in the order they should be executed, where cnt is the return value
+   (in [0,microblock_max]).  The pointed to transactions are valid until
+   the microblock is completed.  Returns 0 if the lane is already
+   executing a microblock or there is nothing schedulable at this time
+   (e.g. no pending transactions, all pending transactions examined
+   conflict with currently scheduled transactions or the block is
+   full).  Assumes pack is a current local join, lane_idx<lane_cnt and
+   out has room for microblock_max pointers. */
+
+ulong
+fd_pack_schedule( fd_pack_t *            pack,
+                  ulong                  lane_idx,
+                  fd_pack_txn_t const ** out );
+
+/* fd_pack_microblock_complete indicates lane lane_idx has finished
+   executing its current microblock.  The microblock's locks are
+   released and its transactions are removed from the pack.  No-op if
+   the lane is idle.  Assumes pack is a current local join and
+   lane_idx<lane_cnt. */
+
+void
+fd_pack_microblock_complete( fd_pack_t * pack,
+                             ulong       lane_idx );
+
+/* fd_pack_end_block ends the current block and starts a new empty one.
+   Microblocks that are currently executing are not affected (they
+   count against the ended block).  Assumes pack is a current local
+   join. */
+
+void
+fd_pack_end_block( fd_pack_t * pack );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_pack_fd_pack_h */
@@ -0,0 +1,215 @@
+#include "../fd_ballet.h"
+
+FD_STATIC_ASSERT( FD_ACCT_LOCK_ALIGN==128UL,             unit_test );
+FD_STATIC_ASSERT( FD_ACCT_LOCK_ADDR_SZ==FD_TXN_ACCT_ADDR_SZ, unit_test );
+FD_STATIC_ASSERT( FD_ACCT_LOCK_SET_ACCT_MAX>=FD_PACK_TXN_ACCT_MAX, unit_test );
+
+#define ACCT_MAX (64UL)
+#define ADDR_CNT (16UL) /* Number of distinct addresses in the randomized test */
+#define SET_MAX  (8UL)  /* Number of account sets held at once in the randomized test */
+
+static uchar lock_mem[ 1UL<<16 ] __attribute__((aligned(FD_ACCT_LOCK_ALIGN)));
+
+/* addr writes a distinct 32 byte account address for idx to a.  The
+   addresses are intentionally unaligned in the sets below. */
+
+static void
+addr( uchar * a,
+      ulong   idx ) {
+  for( ulong i=0UL; i<4UL; i++ ) FD_STORE( ulong, a + 8UL*i, fd_ulong_hash( idx + (i<<32) + 1UL ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test construction */
+
+  FD_TEST( fd_acct_lock_align()==FD_ACCT_LOCK_ALIGN );
+  FD_TEST( !fd_acct_lock_footprint( 0UL ) );
+  FD_TEST( !fd_acct_lock_footprint( ULONG_MAX ) );
+  ulong footprint = fd_acct_lock_footprint( ACCT_MAX );
+  FD_TEST( footprint && footprint<=sizeof(lock_mem) );
+  FD_LOG_NOTICE(( "footprint %lu", footprint ));
+
+  ulong seed = fd_rng_ulong( rng );
+
+  FD_TEST( !fd_acct_lock_new( NULL,       ACCT_MAX, seed ) );
+  FD_TEST( !fd_acct_lock_new( lock_mem+1, ACCT_MAX, seed ) );
+  FD_TEST( !fd_acct_lock_new( lock_mem,   0UL,      seed ) );
+  FD_TEST( !fd_acct_lock_join( NULL       ) );
+  FD_TEST( !fd_acct_lock_join( lock_mem+1 ) );
+  FD_TEST( !fd_acct_lock_join( lock_mem   ) ); /* bad magic */
+
+  fd_acct_lock_t * lock = fd_acct_lock_join( fd_acct_lock_new( lock_mem, ACCT_MAX, seed ) ); FD_TEST( lock );
+  FD_TEST( fd_acct_lock_acct_max( lock )==ACCT_MAX );
+  FD_TEST( fd_acct_lock_seed    ( lock )==seed     );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==0UL      );
+
+  /* Test basic semantics.  x gets read locked by two sets and write
+     locked by neither, y gets write locked. */
+
+  uchar buf[ 1UL + 4UL*32UL ];
+  uchar * s = buf + 1UL; /* Unaligned */
+  uchar x[32]; addr( x, 0UL );
+  uchar y[32]; addr( y, 1UL );
+  uchar z[32]; addr( z, 2UL );
+  uchar n[32]; memset( n, 0, 32UL );
+
+  memcpy( s, x, 32UL ); memcpy( s+32UL, y, 32UL );
+  FD_TEST( !fd_acct_lock_conflict( lock, s, 2UL, 2UL )                              );
+  FD_TEST( fd_acct_lock_acquire( lock, s, 2UL, 2UL, 7UL )==FD_ACCT_LOCK_SUCCESS     ); /* read x, write y */
+  FD_TEST( fd_acct_lock_acct_cnt  ( lock    )==2UL                                  );
+  FD_TEST( fd_acct_lock_reader_cnt( lock, x )==1UL                                  );
+  FD_TEST( fd_acct_lock_writer    ( lock, x )==FD_ACCT_LOCK_OWNER_NULL              );
+  FD_TEST( fd_acct_lock_reader_cnt( lock, y )==0UL                                  );
+  FD_TEST( fd_acct_lock_writer    ( lock, y )==7UL                                  );
+  FD_TEST( fd_acct_lock_writer    ( lock, z )==FD_ACCT_LOCK_OWNER_NULL              );
+
+  FD_TEST( !fd_acct_lock_conflict( lock, x, 1UL, 0UL ) ); /* read x ok */
+  FD_TEST(  fd_acct_lock_conflict( lock, x, 1UL, 1UL ) ); /* write x conflicts with reader */
+  FD_TEST(  fd_acct_lock_conflict( lock, y, 1UL, 0UL ) ); /* read y conflicts with writer */
+  FD_TEST(  fd_acct_lock_conflict( lock, y, 1UL, 1UL ) ); /* write y conflicts with writer */
+  FD_TEST( !fd_acct_lock_conflict( lock, z, 1UL, 1UL ) ); /* z is free */
+
+  /* All-or-nothing: z is free but y conflicts */
+
+  memcpy( s, z, 32UL ); memcpy( s+32UL, y, 32UL );
+  FD_TEST( fd_acct_lock_acquire( lock, s, 2UL, 1UL, 8UL )==FD_ACCT_LOCK_ERR_CONFLICT );
+  FD_TEST( fd_acct_lock_acct_cnt( lock    )==2UL                     );
+  FD_TEST( fd_acct_lock_writer  ( lock, z )==FD_ACCT_LOCK_OWNER_NULL );
+
+  /* The null address is never locked */
+
+  memcpy( s, n, 32UL ); memcpy( s+32UL, x, 32UL );
+  FD_TEST( fd_acct_lock_acquire( lock, s, 2UL, 1UL, 9UL )==FD_ACCT_LOCK_SUCCESS ); /* "write" null, read x */
+  FD_TEST( fd_acct_lock_acct_cnt  ( lock    )==2UL                     );
+  FD_TEST( fd_acct_lock_reader_cnt( lock, x )==2UL                     );
+  FD_TEST( fd_acct_lock_writer    ( lock, n )==FD_ACCT_LOCK_OWNER_NULL );
+  FD_TEST( !fd_acct_lock_conflict ( lock, n, 1UL, 1UL )                );
+
+  fd_acct_lock_release( lock, s, 2UL, 1UL );
+  FD_TEST( fd_acct_lock_reader_cnt( lock, x )==1UL );
+  memcpy( s, x, 32UL ); memcpy( s+32UL, y, 32UL );
+  fd_acct_lock_release( lock, s, 2UL, 2UL );
+  FD_TEST( fd_acct_lock_acct_cnt  ( lock    )==0UL                     );
+  FD_TEST( fd_acct_lock_reader_cnt( lock, x )==0UL                     );
+  FD_TEST( fd_acct_lock_writer    ( lock, y )==FD_ACCT_LOCK_OWNER_NULL );
+  FD_TEST( !fd_acct_lock_conflict ( lock, s, 2UL, 3UL )                );
+
+  /* Test the table filling up */
+
+  uchar big[ (ACCT_MAX+1UL)*32UL ];
+  for( ulong idx=0UL; idx<=ACCT_MAX; idx++ ) addr( big + idx*32UL, 100UL+idx );
+  FD_TEST( fd_acct_lock_acquire( lock, big, ACCT_MAX-1UL, 0UL, 0UL )==FD_ACCT_LOCK_SUCCESS );
+  FD_TEST( fd_acct_lock_acquire( lock, big + (ACCT_MAX-1UL)*32UL, 2UL, 0UL, 0UL )==FD_ACCT_LOCK_ERR_FULL );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==ACCT_MAX-1UL );
+  FD_TEST( fd_acct_lock_acquire( lock, big, 2UL, 0UL, 0UL )==FD_ACCT_LOCK_SUCCESS ); /* Already locked accounts don't count */
+  FD_TEST( fd_acct_lock_acquire( lock, big + (ACCT_MAX-1UL)*32UL, 1UL, 1UL, 0UL )==FD_ACCT_LOCK_SUCCESS );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==ACCT_MAX );
+  fd_acct_lock_release( lock, big + (ACCT_MAX-1UL)*32UL, 1UL, 1UL );
+  fd_acct_lock_release( lock, big, 2UL, 0UL );
+  fd_acct_lock_release( lock, big, ACCT_MAX-1UL, 0UL );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==0UL );
+
+  /* Randomized test against a reference model */
+
+  static uchar set_addr[ SET_MAX ][ 8UL*32UL ];
+  ulong set_cnt     [ SET_MAX ];
+  ulong set_writable[ SET_MAX ];
+  int   set_held    [ SET_MAX ];
+  ulong ref_reader  [ ADDR_CNT ];
+  ulong ref_writer  [ ADDR_CNT ];
+  for( ulong set_idx=0UL; set_idx<SET_MAX; set_idx++ ) set_held[ set_idx ] = 0;
+  for( ulong addr_idx=0UL; addr_idx<ADDR_CNT; addr_idx++ ) { ref_reader[ addr_idx ] = 0UL; ref_writer[ addr_idx ] = FD_ACCT_LOCK_OWNER_NULL; }
+
+  ulong acquire_cnt = 0UL;
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+    ulong set_idx = fd_rng_ulong_roll( rng, SET_MAX );
+
+    if( set_held[ set_idx ] ) {
+      fd_acct_lock_release( lock, set_addr[ set_idx ], set_cnt[ set_idx ], set_writable[ set_idx ] );
+      for( ulong acct_idx=0UL; acct_idx<set_cnt[ set_idx ]; acct_idx++ ) {
+        ulong addr_idx = (ulong)set_addr[ set_idx ][ acct_idx*32UL + 31UL ]; /* See below */
+        if( (set_writable[ set_idx ]>>acct_idx) & 1UL ) ref_writer[ addr_idx ] = FD_ACCT_LOCK_OWNER_NULL;
+        else                                            ref_reader[ addr_idx ]--;
+      }
+      set_held[ set_idx ] = 0;
+
+    } else {
+
+      /* Pick up to 8 distinct addresses (the last byte of each address
+         is overwritten with its index to make the model easy) */
+
+      ulong cnt      = fd_rng_ulong_roll( rng, 9UL );
+      ulong writable = fd_rng_ulong( rng ) & fd_rng_ulong( rng ) & fd_ulong_mask_lsb( (int)cnt );
+      ulong used     = 0UL;
+      for( ulong acct_idx=0UL; acct_idx<cnt; acct_idx++ ) {
+        ulong addr_idx;
+        do addr_idx = fd_rng_ulong_roll( rng, ADDR_CNT ); while( (used>>addr_idx) & 1UL );
+        used |= 1UL<<addr_idx;
+        addr( set_addr[ set_idx ] + acct_idx*32UL, addr_idx );
+        set_addr[ set_idx ][ acct_idx*32UL + 31UL ] = (uchar)addr_idx;
+      }
+
+      int ref_conflict = 0;
+      for( ulong acct_idx=0UL; acct_idx<cnt; acct_idx++ ) {
+        ulong addr_idx = (ulong)set_addr[ set_idx ][ acct_idx*32UL + 31UL ];
+        int   w        = (int)((writable>>acct_idx) & 1UL);
+        ref_conflict |= (ref_writer[ addr_idx ]!=FD_ACCT_LOCK_OWNER_NULL) | (w & (!!ref_reader[ addr_idx ]));
+      }
+
+      FD_TEST( fd_acct_lock_conflict( lock, set_addr[ set_idx ], cnt, writable )==ref_conflict );
+      int err = fd_acct_lock_acquire( lock, set_addr[ set_idx ], cnt, writable, set_idx );
+      FD_TEST( err==(ref_conflict ? FD_ACCT_LOCK_ERR_CONFLICT : FD_ACCT_LOCK_SUCCESS) );
+      if( !err ) {
+        for( ulong acct_idx=0UL; acct_idx<cnt; acct_idx++ ) {
+          ulong addr_idx = (ulong)set_addr[ set_idx ][ acct_idx*32UL + 31UL ];
+          if( (writable>>acct_idx) & 1UL ) ref_writer[ addr_idx ] = set_idx;
+          else                             ref_reader[ addr_idx ]++;
+        }
+        set_cnt     [ set_idx ] = cnt;
+        set_writable[ set_idx ] = writable;
+        set_held    [ set_idx ] = 1;
+        acquire_cnt++;
+      }
+    }
+
+    ulong ref_cnt = 0UL;
+    for( ulong addr_idx=0UL; addr_idx<ADDR_CNT; addr_idx++ ) {
+      uchar a[32]; addr( a, addr_idx ); a[31] = (uchar)addr_idx;
+      FD_TEST( fd_acct_lock_reader_cnt( lock, a )==ref_reader[ addr_idx ] );
+      FD_TEST( fd_acct_lock_writer    ( lock, a )==ref_writer[ addr_idx ] );
+      ref_cnt += (ulong)((!!ref_reader[ addr_idx ]) | (ref_writer[ addr_idx ]!=FD_ACCT_LOCK_OWNER_NULL));
+    }
+    FD_TEST( fd_acct_lock_acct_cnt( lock )==ref_cnt );
+  }
+  FD_LOG_NOTICE(( "acquire_cnt %lu", acquire_cnt ));
+
+  FD_TEST( fd_acct_lock_leave( NULL )==NULL );
+  FD_TEST( fd_acct_lock_delete( fd_acct_lock_leave( lock ) )==lock_mem );
+  FD_TEST( !fd_acct_lock_delete( lock_mem ) ); /* bad magic */
+
+  /* Test addresses that only differ in their last bytes (all of an
+     address is hashed) fill a table with a different seed */
+
+  lock = fd_acct_lock_join( fd_acct_lock_new( lock_mem, ACCT_MAX, ~seed ) ); FD_TEST( lock );
+  uchar w[ ACCT_MAX ][ 32 ];
+  for( ulong idx=0UL; idx<ACCT_MAX; idx++ ) { memset( w[ idx ], 0xab, 32UL ); w[ idx ][ 31 ] = (uchar)idx; }
+  for( ulong idx=0UL; idx<ACCT_MAX; idx++ ) FD_TEST( fd_acct_lock_acquire( lock, w[ idx ], 1UL, 1UL, idx )==FD_ACCT_LOCK_SUCCESS );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==ACCT_MAX );
+  for( ulong idx=0UL; idx<ACCT_MAX; idx++ ) FD_TEST( fd_acct_lock_writer( lock, w[ idx ] )==idx );
+  FD_TEST( fd_acct_lock_acquire( lock, z, 1UL, 0UL, 0UL )==FD_ACCT_LOCK_ERR_FULL );
+  for( ulong idx=0UL; idx<ACCT_MAX; idx++ ) fd_acct_lock_release( lock, w[ idx ], 1UL, 1UL );
+  FD_TEST( fd_acct_lock_acct_cnt( lock )==0UL );
+  FD_TEST( fd_acct_lock_delete( fd_acct_lock_leave( lock ) )==lock_mem );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,361 @@
+#include "../fd_ballet.h"
+
+FD_STATIC_ASSERT( FD_PACK_ALIGN==128UL,              unit_test );
+FD_STATIC_ASSERT( sizeof(fd_pack_txn_t)==1344UL,     unit_test );
+FD_STATIC_ASSERT( FD_PACK_TXN_ACCT_MAX*FD_TXN_ACCT_ADDR_SZ + FD_TXN_SIGNATURE_SZ + FD_TXN_BLOCKHASH_SZ + 6UL<=FD_TXN_MTU, unit_test );
+
+static uchar const compute_budget_addr[ 32 ] = {
+  0x03,0x06,0x46,0x6f,0xe5,0x21,0x17,0x32,0xff,0xec,0xad,0xba,0x72,0xc3,0x9b,0xe7,
+  0xbc,0x8c,0xe5,0xbb,0xc5,0xf7,0x12,0x6b,0x2c,0x43,0x9b,0x3a,0x40,0x00,0x00,0x00
+};
+
+#define TXN_MAX (64UL)
+#define LANE_MAX (4UL)
+#define MB_MAX   (8UL)
+
+static uchar pack_mem[ 1UL<<22 ] __attribute__((aligned(FD_PACK_ALIGN)));
+
+/* build_txn builds a legacy transaction in buf with one signature (from
+   the fee payer w[0]), writable accounts w[0,w_cnt), readonly accounts
+   r[0,r_cnt) and one instruction for a program that references all of
+   them.  If cu_limit / cu_price are non-zero, compute budget
+   instructions requesting them are prepended.  Returns the payload
+   size. */
+
+static ulong
+build_txn( uchar *       buf,
+           fd_rng_t *    rng,
+           uchar const * w,
+           ulong         w_cnt,
+           uchar const * r,
+           ulong         r_cnt,
+           ulong         cu_limit,
+           ulong         cu_price ) {
+  int   cb       = (!!cu_limit) | (!!cu_price);
+  ulong acct_cnt = w_cnt + r_cnt + 1UL + (ulong)cb;
+  ulong prog_idx = w_cnt + r_cnt;
+  ulong i        = 0UL;
+
+  buf[ i++ ] = (uchar)1;                                         /* signature_cnt */
+  for( ulong b=0UL; b<64UL; b++ ) buf[ i++ ] = fd_rng_uchar( rng ); /* signature */
+  buf[ i++ ] = (uchar)1;                                         /* header */
+  buf[ i++ ] = (uchar)0;
+  buf[ i++ ] = (uchar)(r_cnt + 1UL + (ulong)cb);
+  buf[ i++ ] = (uchar)acct_cnt;
+  fd_memcpy( buf+i, w, 32UL*w_cnt ); i += 32UL*w_cnt;
+  fd_memcpy( buf+i, r, 32UL*r_cnt ); i += 32UL*r_cnt;
+  memset( buf+i, 0xaa, 32UL ); i += 32UL;                        /* program */
+  if( cb ) { fd_memcpy( buf+i, compute_budget_addr, 32UL ); i += 32UL; }
+  memset( buf+i, 0x55, 32UL ); i += 32UL;                        /* recent blockhash */
+
+  buf[ i++ ] = (uchar)(1UL + (ulong)(!!cu_limit) + (ulong)(!!cu_price));
+  if( cu_limit ) {
+    buf[ i++ ] = (uchar)(prog_idx+1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)5;
+    buf[ i++ ] = (uchar)2; FD_STORE( uint, buf+i, (uint)cu_limit ); i += 4UL;
+  }
+  if( cu_price ) {
+    buf[ i++ ] = (uchar)(prog_idx+1UL); buf[ i++ ] = (uchar)0; buf[ i++ ] = (uchar)9;
+    buf[ i++ ] = (uchar)3; FD_STORE( ulong, buf+i, cu_price ); i += 8UL;
+  }
+  buf[ i++ ] = (uchar)prog_idx;
+  buf[ i++ ] = (uchar)(w_cnt + r_cnt);
+  for( ulong a=0UL; a<w_cnt+r_cnt; a++ ) buf[ i++ ] = (uchar)a;
+  buf[ i++ ] = (uchar)0;
+  return i;
+}
+
+static uchar  payload[ FD_TXN_MTU ];
+static uchar  txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(8)));
+static ulong  payload_sz;
+
+static fd_txn_t const *
+make_txn( fd_rng_t *    rng,
+          uchar const * w,
+          ulong         w_cnt,
+          uchar const * r,
+          ulong         r_cnt,
+          ulong         cu_limit,
+          ulong         cu_price ) {
+  payload_sz = build_txn( payload, rng, w, w_cnt, r, r_cnt, cu_limit, cu_price );
+  FD_TEST( fd_txn_parse( payload, payload_sz, txn_mem, NULL ) );
+  return (fd_txn_t const *)txn_mem;
+}
+
+static int
+insert( fd_pack_t *   pack,
+        fd_rng_t *    rng,
+        uchar const * w,
+        ulong         w_cnt,
+        uchar const * r,
+        ulong         r_cnt,
+        ulong         cu_limit,
+        ulong         cu_price ) {
+  fd_txn_t const * txn = make_txn( rng, w, w_cnt, r, r_cnt, cu_limit, cu_price );
+  return fd_pack_insert( pack, payload, payload_sz, txn );
+}
+
+/* addr fills a with a distinct (nonzero) address for idx */
+
+static uchar *
+addr( uchar * a,
+      ulong   idx ) {
+  memset( a, 0, 32UL );
+  FD_STORE( ulong, a,      fd_ulong_hash( idx+1UL ) );
+  FD_STORE( ulong, a+24UL, idx+1UL );
+  return a;
+}
+
+/* check_no_conflict checks that no pair of transactions scheduled over
+   all lanes conflicts */
+
+static void
+check_no_conflict( fd_pack_txn_t const * mb[ LANE_MAX ][ MB_MAX ],
+                   ulong const           mb_cnt[ LANE_MAX ],
+                   ulong                 lane_cnt ) {
+  for( ulong l0=0UL; l0<lane_cnt; l0++ ) for( ulong t0=0UL; t0<mb_cnt[l0]; t0++ ) {
+    fd_pack_txn_t const * x = mb[l0][t0];
+    for( ulong l1=0UL; l1<lane_cnt; l1++ ) for( ulong t1=0UL; t1<mb_cnt[l1]; t1++ ) {
+      fd_pack_txn_t const * y = mb[l1][t1];
+      if( x==y ) continue;
+      for( ulong a0=0UL; a0<x->acct_addr_cnt; a0++ ) for( ulong a1=0UL; a1<y->acct_addr_cnt; a1++ ) {
+        if( memcmp( fd_pack_txn_acct_addr( x, a0 ), fd_pack_txn_acct_addr( y, a1 ), 32UL ) ) continue;
+        FD_TEST( !fd_pack_txn_acct_is_writable( x, a0 ) );
+        FD_TEST( !fd_pack_txn_acct_is_writable( y, a1 ) );
+      }
+    }
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  uchar x[32]; addr( x, 0UL );
+  uchar y[32]; addr( y, 1UL );
+  uchar w[4*32];
+  uchar r[4*32];
+
+  /* Test estimates */
+
+  ulong reward; ulong cost;
+  addr( w, 10UL );
+  fd_pack_estimate( payload, make_txn( rng, w, 1UL, x, 1UL, 0UL, 0UL ), &reward, &cost );
+  FD_TEST( reward==FD_PACK_LAMPORTS_PER_SIGNATURE );
+  FD_TEST( cost  ==FD_PACK_DEFAULT_INSTR_CU + FD_PACK_COST_PER_SIGNATURE + FD_PACK_COST_PER_WRITE_LOCK );
+
+  fd_pack_estimate( payload, make_txn( rng, w, 1UL, x, 1UL, 100000UL, 1000UL ), &reward, &cost );
+  FD_TEST( reward==FD_PACK_LAMPORTS_PER_SIGNATURE + 100UL );
+  FD_TEST( cost  ==100000UL + FD_PACK_COST_PER_SIGNATURE + FD_PACK_COST_PER_WRITE_LOCK );
+
+  fd_pack_estimate( payload, make_txn( rng, w, 1UL, x, 1UL, 10000000UL, 1UL ), &reward, &cost ); /* Limit capped, fee rounded up */
+  FD_TEST( reward==FD_PACK_LAMPORTS_PER_SIGNATURE + 2UL );
+  FD_TEST( cost  ==FD_PACK_MAX_TXN_CU + FD_PACK_COST_PER_SIGNATURE + FD_PACK_COST_PER_WRITE_LOCK );
+
+  /* Test construction */
+
+  FD_TEST( fd_pack_align()==FD_PACK_ALIGN );
+  FD_TEST( !fd_pack_footprint( 0UL,     LANE_MAX, MB_MAX ) );
+  FD_TEST( !fd_pack_footprint( TXN_MAX, 0UL,      MB_MAX ) );
+  FD_TEST( !fd_pack_footprint( TXN_MAX, LANE_MAX, 0UL    ) );
+  ulong footprint = fd_pack_footprint( TXN_MAX, LANE_MAX, MB_MAX );
+  FD_TEST( footprint && footprint<=sizeof(pack_mem) );
+  FD_LOG_NOTICE(( "footprint %lu", footprint ));
+
+  FD_TEST( !fd_pack_new( NULL,           TXN_MAX, LANE_MAX, MB_MAX, 0UL, 1234UL ) );
+  FD_TEST( !fd_pack_new( pack_mem+1,     TXN_MAX, LANE_MAX, MB_MAX, 0UL, 1234UL ) );
+  FD_TEST( !fd_pack_new( pack_mem,       0UL,     LANE_MAX, MB_MAX, 0UL, 1234UL ) );
+  FD_TEST( !fd_pack_join( NULL       ) );
+  FD_TEST( !fd_pack_join( pack_mem+1 ) );
+  FD_TEST( !fd_pack_join( pack_mem   ) ); /* bad magic */
+
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_mem, TXN_MAX, LANE_MAX, MB_MAX, 0UL, 1234UL ) ); FD_TEST( pack );
+  FD_TEST( fd_pack_txn_max       ( pack )==TXN_MAX                      );
+  FD_TEST( fd_pack_lane_cnt      ( pack )==LANE_MAX                     );
+  FD_TEST( fd_pack_microblock_max( pack )==MB_MAX                       );
+  FD_TEST( fd_pack_block_cu_max  ( pack )==FD_PACK_DEFAULT_BLOCK_CU_MAX );
+  FD_TEST( !fd_pack_pending_cnt  ( pack ) );
+  FD_TEST( !fd_pack_block_cu_used( pack ) );
+
+  fd_pack_txn_t const * out[ MB_MAX ];
+  FD_TEST( !fd_pack_schedule( pack, 0UL, out ) );
+
+  /* Test insert rejects */
+
+  addr( w, 20UL ); fd_memcpy( w+32UL, x, 32UL );
+  FD_TEST( insert( pack, rng, w, 2UL, x, 1UL, 0UL, 0UL )==FD_PACK_INSERT_REJECT_DUP_ACCT );
+  FD_TEST( !fd_pack_pending_cnt( pack ) );
+
+  /* Test conflict handling.  In priority order: a writes x, b writes x,
+     c reads y, d reads y, e writes y.  The first microblock should get
+     a, c and d.  Nothing else can be scheduled until that completes and
+     then b and e can go together. */
+
+  addr( w, 100UL ); fd_memcpy( w+32UL, x, 32UL );
+  FD_TEST( insert( pack, rng, w, 2UL, NULL, 0UL, 100000UL, 5000UL )==FD_PACK_INSERT_ACCEPT ); /* a */
+  addr( w, 101UL ); fd_memcpy( w+32UL, x, 32UL );
+  FD_TEST( insert( pack, rng, w, 2UL, NULL, 0UL, 100000UL, 4000UL )==FD_PACK_INSERT_ACCEPT ); /* b */
+  addr( w, 102UL );
+  FD_TEST( insert( pack, rng, w, 1UL, y,    1UL, 100000UL, 3000UL )==FD_PACK_INSERT_ACCEPT ); /* c */
+  addr( w, 103UL );
+  FD_TEST( insert( pack, rng, w, 1UL, y,    1UL, 100000UL, 2000UL )==FD_PACK_INSERT_ACCEPT ); /* d */
+  addr( w, 104UL ); fd_memcpy( w+32UL, y, 32UL );
+  FD_TEST( insert( pack, rng, w, 2UL, NULL, 0UL, 100000UL, 1000UL )==FD_PACK_INSERT_ACCEPT ); /* e */
+  FD_TEST( fd_pack_pending_cnt( pack )==5UL );
+
+  FD_TEST( fd_pack_schedule( pack, 0UL, out )==3UL );
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[0], 0UL ) )==fd_ulong_hash( 101UL ) ); /* a */
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[1], 0UL ) )==fd_ulong_hash( 103UL ) ); /* c */
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[2], 0UL ) )==fd_ulong_hash( 104UL ) ); /* d */
+  FD_TEST( fd_pack_lane_txn_cnt( pack, 0UL )==3UL );
+  FD_TEST( fd_pack_pending_cnt ( pack      )==2UL );
+  FD_TEST( fd_pack_block_txn_cnt( pack )==3UL );
+  FD_TEST( fd_pack_block_cu_used( pack )==3UL*(100000UL + FD_PACK_COST_PER_SIGNATURE) + 4UL*FD_PACK_COST_PER_WRITE_LOCK );
+
+  FD_TEST( !fd_pack_schedule( pack, 0UL, out ) ); /* Lane busy */
+  FD_TEST( !fd_pack_schedule( pack, 1UL, out ) ); /* Everything conflicts */
+  FD_TEST( fd_pack_pending_cnt( pack )==2UL );
+
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( !fd_pack_lane_txn_cnt( pack, 0UL ) );
+  fd_pack_microblock_complete( pack, 0UL ); /* No-op */
+
+  FD_TEST( fd_pack_schedule( pack, 1UL, out )==2UL );
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[0], 0UL ) )==fd_ulong_hash( 102UL ) ); /* b */
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[1], 0UL ) )==fd_ulong_hash( 105UL ) ); /* e */
+  fd_pack_microblock_complete( pack, 1UL );
+  FD_TEST( !fd_pack_pending_cnt( pack ) );
+
+  /* Test block limits */
+
+  fd_pack_end_block( pack );
+  FD_TEST( !fd_pack_block_cu_used( pack ) );
+  FD_TEST( !fd_pack_block_txn_cnt( pack ) );
+  FD_TEST( fd_pack_delete( fd_pack_leave( pack ) )==pack_mem );
+
+  ulong txn_cost = 1000000UL + FD_PACK_COST_PER_SIGNATURE + FD_PACK_COST_PER_WRITE_LOCK;
+  pack = fd_pack_join( fd_pack_new( pack_mem, TXN_MAX, LANE_MAX, MB_MAX, 3UL*txn_cost - 1UL, 1234UL ) ); FD_TEST( pack );
+  for( ulong idx=0UL; idx<4UL; idx++ ) {
+    addr( w, 200UL+idx );
+    FD_TEST( insert( pack, rng, w, 1UL, NULL, 0UL, 1000000UL, 1UL+idx )==FD_PACK_INSERT_ACCEPT );
+  }
+  FD_TEST( fd_pack_schedule( pack, 0UL, out )==2UL );
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( !fd_pack_schedule( pack, 0UL, out ) ); /* Block full */
+  FD_TEST( fd_pack_pending_cnt( pack )==2UL );
+  fd_pack_end_block( pack );
+  FD_TEST( fd_pack_schedule( pack, 0UL, out )==2UL );
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( fd_pack_delete( fd_pack_leave( pack ) )==pack_mem );
+
+  /* Test replacement when full */
+
+  pack = fd_pack_join( fd_pack_new( pack_mem, 4UL, 1UL, MB_MAX, 0UL, 1234UL ) ); FD_TEST( pack );
+  for( ulong idx=0UL; idx<4UL; idx++ ) {
+    addr( w, 300UL+idx );
+    FD_TEST( insert( pack, rng, w, 1UL, NULL, 0UL, 100000UL, 10UL*(idx+1UL) )==FD_PACK_INSERT_ACCEPT );
+  }
+  addr( w, 304UL );
+  FD_TEST( insert( pack, rng, w, 1UL, NULL, 0UL, 100000UL, 1UL   )==FD_PACK_INSERT_REJECT_PRIORITY );
+  FD_TEST( insert( pack, rng, w, 1UL, NULL, 0UL, 100000UL, 100UL )==FD_PACK_INSERT_REPLACE );
+  FD_TEST( fd_pack_pending_cnt( pack )==4UL );
+  FD_TEST( fd_pack_schedule( pack, 0UL, out )==4UL );
+  FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[0], 0UL ) )==fd_ulong_hash( 305UL ) );
+  for( ulong idx=1UL; idx<4UL; idx++ ) FD_TEST( out[idx]->pri<=out[idx-1UL]->pri );
+  for( ulong idx=0UL; idx<4UL; idx++ ) FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[idx], 0UL ) )!=fd_ulong_hash( 301UL ) );
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( fd_pack_delete( fd_pack_leave( pack ) )==pack_mem );
+
+  /* Test insert by reference.  a (copy) and b (ref 1) fill the pool, c
+     (ref 2) replaces a (a copy, so its evicted ref is null) and d (ref
+     3) replaces b.  Scheduled transactions point at the caller's
+     payloads. */
+
+  static uchar ref_payload[ 4 ][ FD_TXN_MTU ];
+  ulong        ref_sz     [ 4 ];
+  fd_txn_t const * ref_txn;
+  ulong evict_ref;
+
+  pack = fd_pack_join( fd_pack_new( pack_mem, 2UL, 1UL, MB_MAX, 0UL, 1234UL ) ); FD_TEST( pack );
+  addr( w, 400UL );
+  FD_TEST( insert( pack, rng, w, 1UL, NULL, 0UL, 100000UL, 10UL )==FD_PACK_INSERT_ACCEPT ); /* a */
+  FD_TEST( fd_pack_pending_ref( pack, 0UL )==FD_PACK_TXN_REF_NULL );
+  for( ulong idx=1UL; idx<4UL; idx++ ) {
+    addr( w, 400UL+idx );
+    ref_txn = make_txn( rng, w, 1UL, NULL, 0UL, 100000UL, 10UL*(idx+1UL) );
+    fd_memcpy( ref_payload[ idx ], payload, payload_sz ); ref_sz[ idx ] = payload_sz;
+    evict_ref = 42UL;
+    int err = fd_pack_insert_ref( pack, ref_payload[ idx ], ref_sz[ idx ], ref_txn, idx, &evict_ref );
+    if( idx==1UL ) { FD_TEST( err==FD_PACK_INSERT_ACCEPT  ); FD_TEST( evict_ref==42UL                 ); }
+    if( idx==2UL ) { FD_TEST( err==FD_PACK_INSERT_REPLACE ); FD_TEST( evict_ref==FD_PACK_TXN_REF_NULL ); }
+    if( idx==3UL ) { FD_TEST( err==FD_PACK_INSERT_REPLACE ); FD_TEST( evict_ref==1UL                  ); }
+  }
+  FD_TEST( fd_pack_pending_cnt( pack )==2UL );
+  FD_TEST( (fd_pack_pending_ref( pack, 0UL ) | fd_pack_pending_ref( pack, 1UL ))==3UL ); /* c and d in some order */
+  FD_TEST( fd_pack_schedule( pack, 0UL, out )==2UL );
+  for( ulong idx=0UL; idx<2UL; idx++ ) {
+    ulong ref = 3UL-idx; /* d first */
+    FD_TEST( out[idx]->ref==ref );
+    FD_TEST( fd_pack_txn_payload( out[idx] )==ref_payload[ ref ] );
+    FD_TEST( (ulong)out[idx]->payload_sz==ref_sz[ ref ] );
+    FD_TEST( fd_ulong_load_8( fd_pack_txn_acct_addr( out[idx], 0UL ) )==fd_ulong_hash( 401UL+ref ) );
+  }
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( fd_pack_delete( fd_pack_leave( pack ) )==pack_mem );
+
+  /* Randomized test with a few hot accounts.  Nothing scheduled at the
+     same time should ever conflict and everything inserted should
+     eventually get scheduled. */
+
+  pack = fd_pack_join( fd_pack_new( pack_mem, TXN_MAX, LANE_MAX, MB_MAX, ULONG_MAX, 1234UL ) ); FD_TEST( pack );
+
+  fd_pack_txn_t const * mb[ LANE_MAX ][ MB_MAX ];
+  ulong                 mb_cnt[ LANE_MAX ] = { 0UL };
+  ulong                 insert_cnt         = 0UL;
+  ulong                 sched_cnt          = 0UL;
+  for( ulong iter=0UL; iter<100000UL; iter++ ) {
+    ulong lane_idx = fd_rng_ulong_roll( rng, LANE_MAX );
+    if( fd_rng_uint_roll( rng, 2U ) ) {
+      if( fd_pack_pending_cnt( pack )<TXN_MAX ) {
+        ulong w_cnt = 1UL + fd_rng_ulong_roll( rng, 3UL );
+        ulong r_cnt =       fd_rng_ulong_roll( rng, 3UL );
+        addr( w, 1000000UL + iter );                                                         /* Unique fee payer */
+        for( ulong a=1UL; a<w_cnt; a++ ) addr( w+32UL*a, 2UL + 2UL*a   + fd_rng_ulong_roll( rng, 2UL ) ); /* Hot writable */
+        for( ulong a=0UL; a<r_cnt; a++ ) addr( r+32UL*a, 100UL + 4UL*a + fd_rng_ulong_roll( rng, 4UL ) ); /* Warm readonly */
+        FD_TEST( insert( pack, rng, w, w_cnt, r, r_cnt, 1UL+fd_rng_ulong_roll( rng, 1000000UL ), fd_rng_ulong_roll( rng, 10000UL ) )==FD_PACK_INSERT_ACCEPT );
+        insert_cnt++;
+      }
+    } else {
+      fd_pack_microblock_complete( pack, lane_idx );
+      mb_cnt[ lane_idx ] = 0UL;
+      if( fd_rng_uint_roll( rng, 2U ) ) {
+        mb_cnt[ lane_idx ] = fd_pack_schedule( pack, lane_idx, mb[ lane_idx ] );
+        sched_cnt += mb_cnt[ lane_idx ];
+        check_no_conflict( mb, mb_cnt, LANE_MAX );
+      }
+    }
+  }
+
+  for( ulong rem=1000000UL; fd_pack_pending_cnt( pack ); rem-- ) {
+    FD_TEST( rem );
+    ulong lane_idx = fd_rng_ulong_roll( rng, LANE_MAX );
+    fd_pack_microblock_complete( pack, lane_idx );
+    mb_cnt[ lane_idx ] = fd_pack_schedule( pack, lane_idx, mb[ lane_idx ] );
+    sched_cnt += mb_cnt[ lane_idx ];
+    check_no_conflict( mb, mb_cnt, LANE_MAX );
+  }
+  FD_LOG_NOTICE(( "insert_cnt %lu sched_cnt %lu", insert_cnt, sched_cnt ));
+  FD_TEST( sched_cnt==insert_cnt );
+  for( ulong lane_idx=0UL; lane_idx<LANE_MAX; lane_idx++ ) fd_pack_microblock_complete( pack, lane_idx );
+
+  FD_TEST( fd_pack_delete( fd_pack_leave( pack ) )==pack_mem );
+  FD_TEST( !fd_pack_delete( pack_mem ) ); /* bad magic */
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
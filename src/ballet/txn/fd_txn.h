@@ -49,6 +49,11 @@
    SHA256 hash, giving a size of 256 bits = 32 bytes. */
 #define FD_TXN_BLOCKHASH_SZ (32UL)
 
+/* FD_TXN_MTU: The maximum size (in bytes) of a transaction payload.  This
+   is the IPv6 minimum MTU of 1280 B less 48 B for IPv6 and fragment
+   headers. */
+#define FD_TXN_MTU          (1232UL)
+
 
 /* FD_TXN_SIG_MAX: The (inclusive) maximum number of signatures a transaction
    can have.  Note: for the current MTU size of 1232 B, the maximum that a
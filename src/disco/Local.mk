@@ -1,4 +1,5 @@
 $(call make-lib,fd_disco)
 $(call add-hdrs,fd_disco_base.h fd_disco.h)
+$(call add-objs,fd_disco_base,fd_disco)
 $(call make-unit-test,test_disco_base,test_disco_base,fd_disco fd_tango fd_util)
 
@@ -0,0 +1,3 @@
+$(call add-hdrs,fd_bstore.h)
+$(call add-objs,fd_bstore,fd_disco)
+$(call make-unit-test,test_bstore,test_bstore,fd_disco fd_tango fd_util)
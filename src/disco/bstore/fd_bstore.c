@@ -0,0 +1,280 @@
+#include "fd_bstore.h"
+
+#define FD_BSTORE_MAGIC (0xf17eda2c37b5704eUL) /* firedancer bstore ver 0 */
+
+/* FD_BSTORE_SLOT_MAX bounds slot_max such that footprint calculations
+   can't overflow. */
+
+#define FD_BSTORE_SLOT_MAX (1UL<<32)
+
+struct __attribute__((aligned(FD_BSTORE_ALIGN))) fd_bstore_private {
+  ulong magic;     /* ==FD_BSTORE_MAGIC */
+  ulong slot_max;  /* Positive integer power of 2 */
+  ulong slot_cnt;  /* Updated by the producer */
+  ulong entry_cnt; /* " */
+  ulong slot_cur;  /* " */
+
+  /* Padding to FD_BSTORE_ALIGN here */
+
+  /* slot_max fd_bstore_slot_t here */
+};
+
+FD_FN_PURE static inline fd_bstore_slot_t *
+fd_bstore_private_slot( fd_bstore_t const * bstore,
+                        ulong               slot ) {
+  return ((fd_bstore_slot_t *)(bstore+1)) + (slot & (bstore->slot_max-1UL));
+}
+
+ulong
+fd_bstore_align( void ) {
+  return FD_BSTORE_ALIGN;
+}
+
+ulong
+fd_bstore_footprint( ulong slot_max ) {
+  if( FD_UNLIKELY( (!fd_ulong_is_pow2( slot_max )) | (slot_max>FD_BSTORE_SLOT_MAX) ) ) return 0UL;
+  return sizeof(fd_bstore_t) + fd_ulong_align_up( slot_max*sizeof(fd_bstore_slot_t), FD_BSTORE_ALIGN );
+}
+
+void *
+fd_bstore_new( void * shmem,
+               ulong  slot_max ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_bstore_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_bstore_footprint( slot_max ) ) ) {
+    FD_LOG_WARNING(( "bad slot_max (%lu)", slot_max ));
+    return NULL;
+  }
+
+  fd_bstore_t * bstore = (fd_bstore_t *)shmem;
+  fd_memset( bstore, 0, sizeof(fd_bstore_t) );
+
+  bstore->slot_max  = slot_max;
+  bstore->slot_cnt  = 0UL;
+  bstore->entry_cnt = 0UL;
+  bstore->slot_cur  = FD_BSTORE_SLOT_NULL;
+
+  fd_bstore_slot_t * slot = (fd_bstore_slot_t *)(bstore+1);
+  for( ulong idx=0UL; idx<slot_max; idx++ ) {
+    slot[ idx ].slot      = FD_BSTORE_SLOT_NULL;
+    slot[ idx ].seq0      = 0UL;
+    slot[ idx ].entry_cnt = 0UL;
+    slot[ idx ].done      = 0UL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( bstore->magic ) = FD_BSTORE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_bstore_t *
+fd_bstore_join( void * shbstore ) {
+
+  if( FD_UNLIKELY( !shbstore ) ) {
+    FD_LOG_WARNING(( "NULL shbstore" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shbstore, fd_bstore_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shbstore" ));
+    return NULL;
+  }
+
+  fd_bstore_t * bstore = (fd_bstore_t *)shbstore;
+  if( FD_UNLIKELY( bstore->magic!=FD_BSTORE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return bstore;
+}
+
+void *
+fd_bstore_leave( fd_bstore_t * bstore ) {
+
+  if( FD_UNLIKELY( !bstore ) ) {
+    FD_LOG_WARNING(( "NULL bstore" ));
+    return NULL;
+  }
+
+  return (void *)bstore;
+}
+
+void *
+fd_bstore_delete( void * shbstore ) {
+
+  if( FD_UNLIKELY( !shbstore ) ) {
+    FD_LOG_WARNING(( "NULL shbstore" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shbstore, fd_bstore_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shbstore" ));
+    return NULL;
+  }
+
+  fd_bstore_t * bstore = (fd_bstore_t *)shbstore;
+  if( FD_UNLIKELY( bstore->magic!=FD_BSTORE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( bstore->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shbstore;
+}
+
+ulong fd_bstore_slot_max ( fd_bstore_t const * bstore ) { return bstore->slot_max;                       }
+ulong fd_bstore_slot_cnt ( fd_bstore_t const * bstore ) { return FD_VOLATILE_CONST( bstore->slot_cnt  ); }
+ulong fd_bstore_entry_cnt( fd_bstore_t const * bstore ) { return FD_VOLATILE_CONST( bstore->entry_cnt ); }
+ulong fd_bstore_slot_cur ( fd_bstore_t const * bstore ) { return FD_VOLATILE_CONST( bstore->slot_cur  ); }
+
+void
+fd_bstore_slot_begin( fd_bstore_t * bstore,
+                      ulong         slot,
+                      ulong         seq ) {
+
+  fd_bstore_slot_end( bstore );
+
+  /* Invalidate the index entry before reusing it such that concurrent
+     consumers never see a mix of the old and new slot's fields */
+
+  fd_bstore_slot_t * entry = fd_bstore_private_slot( bstore, slot );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->slot      ) = FD_BSTORE_SLOT_NULL;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->seq0      ) = seq;
+  FD_VOLATILE( entry->entry_cnt ) = 0UL;
+  FD_VOLATILE( entry->done      ) = 0UL;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->slot      ) = slot;
+  FD_COMPILER_MFENCE();
+
+  FD_VOLATILE( bstore->slot_cur ) = slot;
+  FD_VOLATILE( bstore->slot_cnt ) = bstore->slot_cnt + 1UL;
+}
+
+#if FD_HAS_X86
+
+void
+fd_bstore_publish( fd_bstore_t *    bstore,
+                   fd_frag_meta_t * mcache,
+                   ulong            depth,
+                   ulong            seq,
+                   ulong            chunk,
+                   ulong            sz,
+                   ulong            tsorig,
+                   ulong            tspub ) {
+  ulong slot = bstore->slot_cur;
+  fd_mcache_publish( mcache, depth, seq, slot, chunk, sz, fd_frag_meta_ctl( 0UL, 1, 1, 0 ), tsorig, tspub );
+
+  /* Only count the entry once it is visible in the mcache */
+
+  fd_bstore_slot_t * entry = fd_bstore_private_slot( bstore, slot );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->entry_cnt  ) = entry->entry_cnt + 1UL;
+  FD_VOLATILE( bstore->entry_cnt ) = bstore->entry_cnt + 1UL;
+  FD_COMPILER_MFENCE();
+}
+
+#endif
+
+void
+fd_bstore_slot_end( fd_bstore_t * bstore ) {
+  ulong slot = bstore->slot_cur;
+  if( FD_UNLIKELY( slot==FD_BSTORE_SLOT_NULL ) ) return;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( fd_bstore_private_slot( bstore, slot )->done ) = 1UL;
+  FD_VOLATILE( bstore->slot_cur                             ) = FD_BSTORE_SLOT_NULL;
+  FD_COMPILER_MFENCE();
+}
+
+int
+fd_bstore_slot_query( fd_bstore_t const * bstore,
+                      ulong               slot,
+                      ulong *             _seq0,
+                      ulong *             _entry_cnt,
+                      int *               _done ) {
+  if( FD_UNLIKELY( slot==FD_BSTORE_SLOT_NULL ) ) return FD_BSTORE_ERR_UNKNOWN;
+
+  fd_bstore_slot_t const * entry = fd_bstore_private_slot( bstore, slot );
+
+  FD_COMPILER_MFENCE();
+  ulong slot0     = FD_VOLATILE_CONST( entry->slot      );
+  FD_COMPILER_MFENCE();
+  ulong seq0      = FD_VOLATILE_CONST( entry->seq0      );
+  ulong done      = FD_VOLATILE_CONST( entry->done      ); /* Read done before entry_cnt so done implies entry_cnt is final */
+  FD_COMPILER_MFENCE();
+  ulong entry_cnt = FD_VOLATILE_CONST( entry->entry_cnt );
+  FD_COMPILER_MFENCE();
+  ulong slot1     = FD_VOLATILE_CONST( entry->slot      );
+  FD_COMPILER_MFENCE();
+
+  if( FD_UNLIKELY( (slot0!=slot) | (slot1!=slot) ) ) return FD_BSTORE_ERR_UNKNOWN;
+
+  *_seq0      = seq0;
+  *_entry_cnt = entry_cnt;
+  *_done      = (int)done;
+  return FD_BSTORE_SUCCESS;
+}
+
+int
+fd_bstore_entry_query( fd_frag_meta_t const * mcache,
+                       ulong                  seq,
+                       fd_frag_meta_t *       _meta ) {
+  fd_frag_meta_t const * mline = mcache + fd_mcache_line_idx( seq, fd_mcache_depth( mcache ) );
+
+  FD_COMPILER_MFENCE();
+  ulong seq0 = fd_frag_meta_seq_query( mline );
+  FD_COMPILER_MFENCE();
+  *_meta = *mline;
+  FD_COMPILER_MFENCE();
+  ulong seq1 = fd_frag_meta_seq_query( mline );
+  FD_COMPILER_MFENCE();
+
+  /* If the line changed while we were reading it, seq1 tells us if it
+     was overwritten by a newer entry or it was in the middle of being
+     published (the producer marks a line being published with seq-1). */
+
+  long diff = fd_seq_diff( seq1, seq );
+  if( FD_LIKELY( (!diff) & (seq0==seq) ) ) return FD_BSTORE_SUCCESS;
+  return diff>0L ? FD_BSTORE_ERR_EVICTED : FD_BSTORE_ERR_UNKNOWN;
+}
+
+int
+fd_bstore_query( fd_bstore_t const *    bstore,
+                 fd_frag_meta_t const * mcache,
+                 ulong                  slot,
+                 ulong                  entry_idx,
+                 fd_frag_meta_t *       _meta ) {
+  ulong seq0;
+  ulong entry_cnt;
+  int   done;
+  int   err = fd_bstore_slot_query( bstore, slot, &seq0, &entry_cnt, &done );
+  if( FD_UNLIKELY( err                  ) ) return err;
+  if( FD_UNLIKELY( entry_idx>=entry_cnt ) ) return FD_BSTORE_ERR_UNKNOWN;
+  return fd_bstore_entry_query( mcache, fd_seq_inc( seq0, entry_idx ), _meta );
+}
+
+int
+fd_bstore_entry_check( fd_frag_meta_t const * mcache,
+                       ulong                  seq ) {
+  fd_frag_meta_t const * mline = mcache + fd_mcache_line_idx( seq, fd_mcache_depth( mcache ) );
+  FD_COMPILER_MFENCE();
+  ulong seq_found = fd_frag_meta_seq_query( mline );
+  FD_COMPILER_MFENCE();
+  return fd_seq_eq( seq_found, seq );
+}
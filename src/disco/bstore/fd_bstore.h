@@ -0,0 +1,219 @@
+#ifndef HEADER_fd_src_disco_bstore_fd_bstore_h
+#define HEADER_fd_src_disco_bstore_fd_bstore_h
+
+/* fd_bstore provides a block store: a deep mcache / dcache pair holding
+   the most recently produced block entries (e.g. the microblocks
+   scheduled by a pack tile) plus a slot index that allows consumers to
+   find the entries of a recent slot.
+
+   Entries are published as normal tango frags: any normal consumer
+   (e.g. a recorder) can follow the block store as a frag stream.  Each
+   entry is a complete message (SOM and EOM set) and the frag sig is the
+   entry's slot.  The producer publishes all the entries of a slot
+   consecutively.  Thus, the entries of a slot occupy a contiguous range
+   of sequence numbers and entry entry_idx of slot is at sequence number
+   seq0+entry_idx where seq0 is the sequence number of the slot's first
+   entry.
+
+   The slot index records seq0 and the number of entries published so
+   far for the slot_max most recently started slots (it is direct mapped
+   by slot so a slot is dropped from the index when a slot that maps to
+   the same index entry is started).  The index lives in the app region
+   of the block store's mcache such that the mcache / dcache pair is
+   self-contained.
+
+   There is no flow control.  The block store is a ring and the oldest
+   entries are overwritten as new ones are published.  Retention is
+   configured when the block store is created (the mcache depth and
+   dcache data size bound the number and total size of entries retained
+   and slot_max bounds the number of slots indexed).  Consumers read
+   entries in place (the payload is not copied) and detect if an entry
+   was overwritten while they were reading it.  Typical usage for a
+   consumer that wants to stream the entries of a slot:
+
+     ulong seq0; ulong entry_cnt; int done;
+     if( fd_bstore_slot_query( bstore, slot, &seq0, &entry_cnt, &done ) ) ... slot not in index
+     for( ulong entry_idx=0UL; entry_idx<entry_cnt; entry_idx++ ) {
+       fd_frag_meta_t meta[1];
+       int err = fd_bstore_entry_query( mcache, seq0+entry_idx, meta );
+       if( FD_UNLIKELY( err ) ) ... entry overwritten (or not yet published)
+       uchar const * payload = (uchar const *)fd_chunk_to_laddr_const( base, meta->chunk );
+       ... process meta->sz bytes at payload speculatively
+       if( FD_UNLIKELY( !fd_bstore_entry_check( mcache, seq0+entry_idx ) ) ) ... entry overwritten while processing
+     }
+
+   The dcache should be sized such that fd_dcache_compact_is_safe for
+   the producer's mtu and the mcache's depth (then the payload of an
+   entry is valid as long as its mcache line is). */
+
+#include "../fd_disco_base.h"
+
+/* FD_BSTORE_ALIGN gives the required alignment of a slot index
+   (matches the alignment of a mcache app region). */
+
+#define FD_BSTORE_ALIGN (128UL)
+
+/* FD_BSTORE_SLOT_NULL is a slot number that is never used. */
+
+#define FD_BSTORE_SLOT_NULL (ULONG_MAX)
+
+/* FD_BSTORE_{SUCCESS,ERR_*} are the return values of the query
+   functions. */
+
+#define FD_BSTORE_SUCCESS     ( 0) /* Success */
+#define FD_BSTORE_ERR_UNKNOWN (-1) /* Slot not in index / entry not published yet */
+#define FD_BSTORE_ERR_EVICTED (-2) /* Entry has been overwritten by a newer entry */
+
+/* A fd_bstore_slot_t is an index entry.  Updated by the producer and
+   read by consumers concurrently (consumers validate their reads by
+   checking slot is unchanged). */
+
+struct __attribute__((aligned(32))) fd_bstore_slot {
+  ulong slot;      /* Slot number, FD_BSTORE_SLOT_NULL if this index entry is not in use */
+  ulong seq0;      /* Sequence number of the slot's first entry */
+  ulong entry_cnt; /* Number of entries published for the slot so far */
+  ulong done;      /* 1 if the producer finished the slot and 0 otherwise */
+};
+
+typedef struct fd_bstore_slot fd_bstore_slot_t;
+
+struct fd_bstore_private;
+typedef struct fd_bstore_private fd_bstore_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_bstore_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a slot index for
+   up to slot_max slots (i.e. the minimum app_sz of the block store's
+   mcache).  slot_max should be a positive integer power of two.
+   footprint returns 0 if slot_max is invalid.
+
+   fd_bstore_new formats a memory region (typically the app region of
+   the block store's mcache) as an empty slot index.  Returns shmem on
+   success and NULL on failure (logs details).  fd_bstore_join joins the
+   caller to a slot index.  Returns a local handle on success and NULL
+   on failure (logs details).  fd_bstore_leave leaves a current local
+   join and returns the underlying shared memory region.
+   fd_bstore_delete unformats a memory region used as a slot index and
+   returns ownership of it to the caller. */
+
+FD_FN_CONST ulong
+fd_bstore_align( void );
+
+FD_FN_CONST ulong
+fd_bstore_footprint( ulong slot_max );
+
+void *
+fd_bstore_new( void * shmem,
+               ulong  slot_max );
+
+fd_bstore_t * fd_bstore_join  ( void *        shbstore );
+void *        fd_bstore_leave ( fd_bstore_t * bstore   );
+void *        fd_bstore_delete( void *        shbstore );
+
+/* Accessors.  slot_max returns the value used to create the index.
+   slot_cnt returns the number of slots started and entry_cnt returns
+   the number of entries published over the lifetime of the index.
+   slot_cur returns the slot currently being produced
+   (FD_BSTORE_SLOT_NULL if none).  Assumes bstore is a current local
+   join. */
+
+FD_FN_PURE ulong fd_bstore_slot_max ( fd_bstore_t const * bstore );
+FD_FN_PURE ulong fd_bstore_slot_cnt ( fd_bstore_t const * bstore );
+FD_FN_PURE ulong fd_bstore_entry_cnt( fd_bstore_t const * bstore );
+FD_FN_PURE ulong fd_bstore_slot_cur ( fd_bstore_t const * bstore );
+
+/* Producer API.  A block store has a single producer.
+
+   fd_bstore_slot_begin starts producing slot.  seq is the sequence
+   number at which the slot's first entry will be published.  If there
+   is a slot currently being produced, it is ended first.  Assumes slot
+   is not FD_BSTORE_SLOT_NULL and that slot has not been started before.
+
+   fd_bstore_publish publishes the next entry of the current slot at
+   sequence number seq of mcache (with the given depth) and updates the
+   index.  chunk, sz, tsorig and tspub are as in fd_mcache_publish.
+   Assumes a slot is being produced, seq is the slot's seq0 plus the
+   number of entries published for it so far and the payload has
+   already been written to chunk.  (Only available on targets with
+   fd_mcache_publish.)
+
+   fd_bstore_slot_end finishes producing the current slot.  No-op if no
+   slot is being produced. */
+
+void
+fd_bstore_slot_begin( fd_bstore_t * bstore,
+                      ulong         slot,
+                      ulong         seq );
+
+#if FD_HAS_X86
+
+void
+fd_bstore_publish( fd_bstore_t *    bstore,
+                   fd_frag_meta_t * mcache,
+                   ulong            depth,
+                   ulong            seq,
+                   ulong            chunk,
+                   ulong            sz,
+                   ulong            tsorig,
+                   ulong            tspub );
+
+#endif
+
+void
+fd_bstore_slot_end( fd_bstore_t * bstore );
+
+/* Consumer API.
+
+   fd_bstore_slot_query looks up slot in the index.  On success, returns
+   FD_BSTORE_SUCCESS and *_seq0, *_entry_cnt and *_done hold the
+   sequence number of the slot's first entry, the number of entries
+   published for it at some point during the call and whether the
+   producer finished the slot at that point.  Returns
+   FD_BSTORE_ERR_UNKNOWN if slot is not in the index (never started or
+   dropped from the index) and the out fields are unchanged.
+
+   fd_bstore_entry_query copies the metadata of the entry published at
+   sequence number seq into *_meta.  Returns FD_BSTORE_SUCCESS on
+   success, FD_BSTORE_ERR_EVICTED if the entry has been overwritten and
+   FD_BSTORE_ERR_UNKNOWN if no entry has been published at seq yet (in
+   both cases *_meta is clobbered).  fd_bstore_query does the same for
+   entry entry_idx of slot (this also returns FD_BSTORE_ERR_UNKNOWN if
+   slot is not in the index or entry_idx is not a published entry of
+   slot).
+
+   fd_bstore_entry_check returns 1 if the entry published at seq is
+   still available and 0 if it has been overwritten.  Consumers
+   processing an entry's payload in place should use this after
+   processing to verify the payload was not overwritten while they were
+   processing it.
+
+   These can be used concurrently with the producer by any number of
+   consumers. */
+
+int
+fd_bstore_slot_query( fd_bstore_t const * bstore,
+                      ulong               slot,
+                      ulong *             _seq0,
+                      ulong *             _entry_cnt,
+                      int *               _done );
+
+int
+fd_bstore_entry_query( fd_frag_meta_t const * mcache,
+                       ulong                  seq,
+                       fd_frag_meta_t *       _meta );
+
+int
+fd_bstore_query( fd_bstore_t const *    bstore,
+                 fd_frag_meta_t const * mcache,
+                 ulong                  slot,
+                 ulong                  entry_idx,
+                 fd_frag_meta_t *       _meta );
+
+int
+fd_bstore_entry_check( fd_frag_meta_t const * mcache,
+                       ulong                  seq );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_bstore_fd_bstore_h */
@@ -0,0 +1,183 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_X86
+
+FD_STATIC_ASSERT( FD_BSTORE_ALIGN       ==128UL,     unit_test );
+FD_STATIC_ASSERT( FD_BSTORE_SLOT_NULL   ==ULONG_MAX, unit_test );
+FD_STATIC_ASSERT( FD_BSTORE_SUCCESS     == 0,        unit_test );
+FD_STATIC_ASSERT( FD_BSTORE_ERR_UNKNOWN ==-1,        unit_test );
+FD_STATIC_ASSERT( FD_BSTORE_ERR_EVICTED ==-2,        unit_test );
+FD_STATIC_ASSERT( sizeof(fd_bstore_slot_t)==32UL,    unit_test );
+
+#define DEPTH    (128UL)
+#define SLOT_MAX (8UL)
+#define MTU      (256UL)
+#define SLOT_CNT (1024UL) /* Slots produced by the test */
+#define SEQ0     (1234UL)
+
+static uchar mcache_mem[ 1UL<<16 ] __attribute__((aligned(FD_MCACHE_ALIGN)));
+static uchar dcache_mem[ 1UL<<18 ] __attribute__((aligned(FD_DCACHE_ALIGN)));
+
+/* Track what was produced for validation */
+
+static ulong slot_seq0[ SLOT_CNT ];
+static ulong slot_cnt [ SLOT_CNT ];
+
+static ulong
+entry_sz( ulong slot,
+          ulong entry_idx ) {
+  return 8UL + (fd_ulong_hash( (slot<<32) | entry_idx ) % (MTU-7UL)); /* In [8,MTU] */
+}
+
+static void
+validate( fd_bstore_t const *    bstore,
+          fd_frag_meta_t const * mcache,
+          uchar const *          base,
+          ulong                  slot_nxt,  /* Slots [0,slot_nxt) have been started */
+          ulong                  seq_nxt ) {
+  for( ulong slot=0UL; slot<slot_nxt; slot++ ) {
+    ulong seq0; ulong cnt; int done;
+    int err = fd_bstore_slot_query( bstore, 100UL+slot, &seq0, &cnt, &done );
+    if( slot+SLOT_MAX<slot_nxt ) { FD_TEST( err==FD_BSTORE_ERR_UNKNOWN ); continue; } /* Dropped from the index */
+    FD_TEST( !err );
+    FD_TEST( seq0==slot_seq0[ slot ] );
+    FD_TEST( cnt ==slot_cnt [ slot ] );
+    FD_TEST( done==(slot+1UL<slot_nxt) );
+
+    fd_frag_meta_t meta[1];
+    FD_TEST( fd_bstore_query( bstore, mcache, 100UL+slot, cnt, meta )==FD_BSTORE_ERR_UNKNOWN );
+
+    for( ulong entry_idx=0UL; entry_idx<cnt; entry_idx++ ) {
+      ulong seq = seq0 + entry_idx;
+      err = fd_bstore_query( bstore, mcache, 100UL+slot, entry_idx, meta );
+      if( seq+DEPTH<seq_nxt ) { /* Overwritten */
+        FD_TEST( err==FD_BSTORE_ERR_EVICTED );
+        FD_TEST( !fd_bstore_entry_check( mcache, seq ) );
+        continue;
+      }
+      FD_TEST( !err );
+      FD_TEST( meta->seq==seq                  );
+      FD_TEST( meta->sig==100UL+slot           );
+      FD_TEST( meta->sz ==entry_sz( slot, entry_idx ) );
+      FD_TEST( fd_frag_meta_ctl_som( (ulong)meta->ctl ) && fd_frag_meta_ctl_eom( (ulong)meta->ctl ) );
+      uchar const * p = (uchar const *)fd_chunk_to_laddr_const( base, (ulong)meta->chunk );
+      FD_TEST( fd_ulong_load_8( p )==seq );
+      for( ulong off=8UL; off<(ulong)meta->sz; off++ ) FD_TEST( p[ off ]==(uchar)(seq+off) );
+      FD_TEST( fd_bstore_entry_check( mcache, seq ) );
+    }
+  }
+
+  fd_frag_meta_t meta[1];
+  FD_TEST( fd_bstore_entry_query( mcache, seq_nxt, meta )==FD_BSTORE_ERR_UNKNOWN ); /* Not published yet */
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test construction */
+
+  FD_TEST( fd_bstore_align()==FD_BSTORE_ALIGN );
+  FD_TEST( !fd_bstore_footprint( 0UL ) );
+  FD_TEST( !fd_bstore_footprint( 3UL ) );
+  ulong app_sz = fd_bstore_footprint( SLOT_MAX );
+  FD_TEST( app_sz && fd_ulong_is_aligned( app_sz, FD_BSTORE_ALIGN ) );
+
+  FD_TEST( fd_mcache_footprint( DEPTH, app_sz )<=sizeof(mcache_mem) );
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( mcache_mem, DEPTH, app_sz, SEQ0 ) ); FD_TEST( mcache );
+  void * shbstore = fd_mcache_app_laddr( mcache );
+
+  ulong data_sz = fd_dcache_req_data_sz( MTU, DEPTH, 1UL, 1 ); FD_TEST( data_sz );
+  FD_TEST( fd_dcache_footprint( data_sz, 0UL )<=sizeof(dcache_mem) );
+  uchar * dcache = fd_dcache_join( fd_dcache_new( dcache_mem, data_sz, 0UL ) ); FD_TEST( dcache );
+  uchar * base   = dcache_mem; /* chunks relative to the dcache */
+  FD_TEST( fd_dcache_compact_is_safe( base, dcache, MTU, DEPTH ) );
+  ulong chunk0 = fd_dcache_compact_chunk0( base, dcache );
+  ulong wmark  = fd_dcache_compact_wmark ( base, dcache, MTU );
+  ulong chunk  = chunk0;
+
+  FD_TEST( !fd_bstore_new( NULL,                 SLOT_MAX ) );
+  FD_TEST( !fd_bstore_new( (uchar *)shbstore+1,  SLOT_MAX ) );
+  FD_TEST( !fd_bstore_new( shbstore,             3UL      ) );
+  FD_TEST( !fd_bstore_join( NULL                ) );
+  FD_TEST( !fd_bstore_join( (uchar *)shbstore+1 ) );
+
+  fd_bstore_t * bstore = fd_bstore_join( fd_bstore_new( shbstore, SLOT_MAX ) ); FD_TEST( bstore );
+  FD_TEST( fd_bstore_slot_max ( bstore )==SLOT_MAX            );
+  FD_TEST( fd_bstore_slot_cnt ( bstore )==0UL                 );
+  FD_TEST( fd_bstore_entry_cnt( bstore )==0UL                 );
+  FD_TEST( fd_bstore_slot_cur ( bstore )==FD_BSTORE_SLOT_NULL );
+
+  ulong seq0; ulong cnt; int done;
+  FD_TEST( fd_bstore_slot_query( bstore, 100UL,               &seq0, &cnt, &done )==FD_BSTORE_ERR_UNKNOWN );
+  FD_TEST( fd_bstore_slot_query( bstore, FD_BSTORE_SLOT_NULL, &seq0, &cnt, &done )==FD_BSTORE_ERR_UNKNOWN );
+  fd_bstore_slot_end( bstore ); /* No-op */
+
+  /* Produce slots with a random number of entries (including some
+     empty slots and some slots with more entries than the mcache can
+     hold) and validate everything visible after every entry. */
+
+  ulong seq       = SEQ0;
+  ulong entry_tot = 0UL;
+  for( ulong slot=0UL; slot<SLOT_CNT; slot++ ) {
+    ulong r = fd_rng_ulong( rng );
+    ulong n = (r & 7UL) ? ((r>>3) & 15UL) : ((r>>3) & 127UL);
+
+    fd_bstore_slot_begin( bstore, 100UL+slot, seq ); /* Ends the previous slot */
+    slot_seq0[ slot ] = seq;
+    slot_cnt [ slot ] = 0UL;
+    FD_TEST( fd_bstore_slot_cur( bstore )==100UL+slot );
+
+    for( ulong entry_idx=0UL; entry_idx<n; entry_idx++ ) {
+      ulong   sz = entry_sz( slot, entry_idx );
+      uchar * p  = (uchar *)fd_chunk_to_laddr( base, chunk );
+      FD_STORE( ulong, p, seq );
+      for( ulong off=8UL; off<sz; off++ ) p[ off ] = (uchar)(seq+off);
+      fd_bstore_publish( bstore, mcache, DEPTH, seq, chunk, sz, 0UL, 0UL );
+      seq   = fd_seq_inc( seq, 1UL );
+      chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+      slot_cnt[ slot ]++;
+      entry_tot++;
+      if( (slot<32UL) | (!(entry_idx & 7UL)) ) validate( bstore, mcache, base, slot+1UL, seq );
+    }
+
+    validate( bstore, mcache, base, slot+1UL, seq );
+  }
+
+  fd_bstore_slot_end( bstore );
+  FD_TEST( fd_bstore_slot_cur ( bstore )==FD_BSTORE_SLOT_NULL );
+  FD_TEST( fd_bstore_slot_cnt ( bstore )==SLOT_CNT            );
+  FD_TEST( fd_bstore_entry_cnt( bstore )==entry_tot           );
+  FD_TEST( !fd_bstore_slot_query( bstore, 100UL+SLOT_CNT-1UL, &seq0, &cnt, &done ) );
+  FD_TEST( done );
+  FD_LOG_NOTICE(( "entry_tot %lu", entry_tot ));
+
+  FD_TEST( fd_bstore_leave( NULL )==NULL );
+  FD_TEST( fd_bstore_delete( fd_bstore_leave( bstore ) )==shbstore );
+  FD_TEST( !fd_bstore_join  ( shbstore ) ); /* bad magic */
+  FD_TEST( !fd_bstore_delete( shbstore ) ); /* bad magic */
+
+  fd_dcache_delete( fd_dcache_leave( dcache ) );
+  fd_mcache_delete( fd_mcache_leave( mcache ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
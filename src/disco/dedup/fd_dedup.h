@@ -21,6 +21,21 @@
 
 #define FD_DEDUP_CNC_SIGNAL_ACK (4UL)
 
+/* FD_DEDUP_CNC_SIGNAL_{ATTACH,DETACH} and FD_DEDUP_CNC_ARG_* can be
+   used to attach / detach an input to / from a running dedup tile.
+   These are the standard disco in commands (see
+   FD_DISCO_CNC_SIGNAL_{ATTACH,DETACH} in fd_disco_base.h for details).
+   Since the tcache is untouched, this allows scaling the number of
+   producers feeding a dedup tile without losing its dedup history. */
+
+#define FD_DEDUP_CNC_SIGNAL_ATTACH FD_DISCO_CNC_SIGNAL_ATTACH
+#define FD_DEDUP_CNC_SIGNAL_DETACH FD_DISCO_CNC_SIGNAL_DETACH
+
+#define FD_DEDUP_CNC_ARG_IN_IDX    FD_DISCO_CNC_ARG_IN_IDX
+#define FD_DEDUP_CNC_ARG_IN_WEIGHT FD_DISCO_CNC_ARG_IN_WEIGHT
+#define FD_DEDUP_CNC_ARG_IN_MCACHE FD_DISCO_CNC_ARG_IN_MCACHE
+#define FD_DEDUP_CNC_ARG_IN_FSEQ   FD_DISCO_CNC_ARG_IN_FSEQ
+
 /* FD_DEDUP_TILE_IN_MAX and FD_DEDUP_TILE_OUT_MAX are the maximum number
    of inputs and outputs respectively that a dedup tile can have.  These
    limits are more or less arbitrary from a functional correctness POV.
@@ -32,9 +47,21 @@
 #define FD_DEDUP_TILE_IN_MAX  FD_FRAG_META_ORIG_MAX
 #define FD_DEDUP_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
 
+/* FD_DEDUP_TILE_IN_WEIGHT_MAX is the maximum polling weight that can be
+   assigned to an input (see FD_MUX_TILE_IN_WEIGHT_MAX). */
+
+#define FD_DEDUP_TILE_IN_WEIGHT_MAX (16UL)
+
+/* FD_DEDUP_TILE_SHARD_MAX is the maximum number of shards a dedup can
+   be split over (see fd_dedup_shard_idx below).  This is more or less
+   arbitrary but must be at most 2^32. */
+
+#define FD_DEDUP_TILE_SHARD_MAX FD_FRAG_META_ORIG_MAX
+
 /* FD_DEDUP_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
    footprint needed for a dedup tile scratch region that can support
-   in_cnt mcaches and out_cnt reliable outputs.  ALIGN is an integer
+   in_cnt mcaches (with arbitrary in weights) and out_cnt reliable
+   outputs, with a hot tcache if hot is non-zero.  ALIGN is an integer
    power of 2 of at least double cache line to mitigate various kinds of
    false sharing.  FOOTPRINT will be an integer multiple of ALIGN.
    {in,out}_cnt are assumed to be valid (i.e. at most
@@ -43,18 +70,36 @@
    facilitate compile time declarations. */
 
 #define FD_DEDUP_TILE_SCRATCH_ALIGN (128UL)
-#define FD_DEDUP_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt )              \
-  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( \
-  FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                   \
-    64UL,             (in_cnt)*64UL                           ),        \
-    alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
-    alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
-    alignof(ulong),   (out_cnt)*sizeof(ulong)                 ),        \
-    alignof(ushort),  ((in_cnt)+(out_cnt)+1UL)*sizeof(ushort) ),        \
+#define FD_DEDUP_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt, hot )                                              \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(                   \
+  FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                                     \
+    64UL,             (in_cnt)*64UL                                                                ),       \
+    alignof(ushort),  (in_cnt)*FD_DEDUP_TILE_IN_WEIGHT_MAX*sizeof(ushort)                          ),       \
+    FD_TCACHE_ALIGN,  (hot) ? FD_TCACHE_FOOTPRINT( FD_TCACHE_HOT_DEPTH, FD_TCACHE_HOT_MAP_CNT ) : 0UL ),     \
+    alignof(ulong *), (out_cnt)*sizeof(ulong *)                                                    ),       \
+    alignof(ulong *), (out_cnt)*sizeof(ulong *)                                                    ),       \
+    alignof(ulong),   (out_cnt)*sizeof(ulong)                                                      ),       \
+    alignof(ushort),  ((in_cnt)+(out_cnt)+1UL)*sizeof(ushort)                                      ),       \
     FD_DEDUP_TILE_SCRATCH_ALIGN )
 
 FD_PROTOTYPES_BEGIN
 
+/* fd_dedup_shard_idx returns the index of the dedup shard responsible
+   for frags with signature sig when deduplication is split over
+   shard_cnt shards.  shard_cnt is assumed in [1,FD_DEDUP_TILE_SHARD_MAX].
+   Result will be in [0,shard_cnt).  Shards cover contiguous ranges of
+   the most significant sig bits (such that, for the recommended
+   randomized sigs, load is evenly distributed over shards and the least
+   significant sig bits used by the tcache map remain uniform within a
+   shard).  Since duplicate frags have the same sig, all duplicates of a
+   frag are handled by the same shard. */
+
+FD_FN_CONST static inline ulong
+fd_dedup_shard_idx( ulong sig,
+                    ulong shard_cnt ) {
+  return ((sig>>32)*shard_cnt)>>32;
+}
+
 /* fd_dedup_tile deduplicates multiple fragment streams described by the
    in_mcaches into a single out_mcache that can be consumed by out_cnt
    reliable consumers and an arbitrary number of unreliable consumers.
@@ -74,6 +119,31 @@ FD_PROTOTYPES_BEGIN
    discard frags that whose signatures match any of the most recent
    tcache depth unique signatures observed by the dedup tile.
 
+   If hot is non-zero, to exploit the temporal clustering typical of
+   duplicates (e.g. spam bursts), the dedup tile keeps a small hot
+   tcache of the most recent FD_TCACHE_HOT_DEPTH unique signatures in
+   its scratch region (and thus in its core's cache).  Duplicates found
+   there are filtered without touching the (typically large and DRAM
+   resident) tcache.  This does not change which frags are considered
+   duplicates (see FD_TCACHE_INSERT_HOT for details).  Whether this is a
+   win depends on how much other cache pressure the tile is under and
+   how clustered duplicates are so it is opt-in (and the scratch region
+   only needs room for the hot tcache if it is enabled).
+
+   To scale deduplication beyond a single core (and a single core's
+   DRAM latency bound), deduplication can be sharded over shard_cnt
+   dedup tiles, each with its own tcache.  Every shard consumes the same
+   in_mcaches (each shard with its own in_fseqs) but only handles frags
+   for which fd_dedup_shard_idx( sig, shard_cnt )==shard_idx.  Frags
+   handled by other shards are skipped and not counted in this shard's
+   in_fseq pub / filt diagnostics (such that, summed over all the
+   shards' in_fseqs, every frag is counted exactly once).  The deduped
+   outputs of the shards can then be merged back into a single stream
+   with a mux tile.  The result is equivalent to a single dedup with
+   the combined tcache depth except for the interleaving of frags
+   handled by different shards.  Use shard_idx 0 and shard_cnt 1 for an
+   unsharded dedup.
+
    IMPORTANT!  Strictly speaking, the dedup tile does not care about the
    specifics of the tagging scheme other than signature method should
    not produce a sig of FD_TCACHE_TAG_NULL.  At the same time, this
@@ -100,6 +170,15 @@ FD_PROTOTYPES_BEGIN
    to avoid starvation and minimize slip between different groups of
    streams).
 
+   in_weight[in_idx] is the polling weight of input in_idx, in
+   [0,FD_DEDUP_TILE_IN_WEIGHT_MAX].  A weight of 0 boots the input
+   detached.  NULL means all inputs have weight 1.  Inputs can be
+   attached and detached while running with the
+   FD_DEDUP_CNC_SIGNAL_{ATTACH,DETACH} commands.  Weighting, attaching,
+   detaching and unbound input slots (NULL in_mcache[in_idx] and
+   in_fseq[in_idx]) work identically to fd_mux_tile (see fd_mux.h for
+   details).
+
    The sig, chunk, sz, ctl and tsorig input fragment metadata will be
    unchanged by this tile.
 
@@ -206,8 +285,9 @@ FD_PROTOTYPES_BEGIN
    and fd_dedup_tile_scratch_footprint return the required alignment and
    footprint needed for this region.  This memory region is exclusively
    owned by the dedup tile while the tile is running and is ideally near
-   the core running the dedup tile.  fd_dedup_tile_scratch_align will
-   return the same value as FD_DEDUP_TILE_SCRATCH_ALIGN.  If
+   the core running the dedup tile.  The scratch region should be sized
+   with the same hot as passed to the tile.  fd_dedup_tile_scratch_align
+   will return the same value as FD_DEDUP_TILE_SCRATCH_ALIGN.  If
    (in_cnt,out_cnt) is not valid, fd_dedup_tile_scratch_footprint
    silently returns 0 so callers can diagnose configuration issues.
    Otherwise, fd_dedup_tile_scratch_footprint will return the same value
@@ -219,7 +299,10 @@ FD_PROTOTYPES_BEGIN
    at boot (as such that they can be accumulated over multiple runs).
    Clearing is up to monitoring scripts.  It is recommend that inputs
    and outputs also use their cnc and fseq application regions similarly
-   for monitoring simplicity / consistency.
+   for monitoring simplicity / consistency.  In particular, the latency
+   of every frag this shard handles from an in is accumulated to the
+   LAT_PUB / LAT_ORIG histograms of its in_fseq (like the pub / filt
+   counts, frags handled by other shards are not sampled).
 
    The lifetime of the cnc, mcaches, fseqs, tcache, rng and scratch used
    by this tile should be a superset of this tile's lifetime.  While
@@ -243,14 +326,19 @@ fd_dedup_tile_scratch_align( void );
 
 FD_FN_CONST ulong
 fd_dedup_tile_scratch_footprint( ulong in_cnt,
-                                 ulong out_cnt );
+                                 ulong out_cnt,
+                                 int   hot );
 
 int
 fd_dedup_tile( fd_cnc_t *              cnc,       /* Local join to the dedup's command-and-control */
                ulong                   in_cnt,    /* Number of input mcaches to dedup, inputs are indexed [0,in_cnt) */
                fd_frag_meta_t const ** in_mcache, /* in_mcache[in_idx] is the local join to input in_idx's mcache */
                ulong **                in_fseq,   /* in_fseq  [in_idx] is the local join to input in_idx's fseq */
+               ulong const *           in_weight, /* in_weight[in_idx] is input in_idx's polling weight, NULL means all 1 */
                fd_tcache_t *           tcache,    /* Local join to the dedup's unique signature cache */
+               int                     hot,       /* Non-zero to filter through a small hot tcache in scratch first */
+               ulong                   shard_idx, /* Index of this dedup shard, in [0,shard_cnt) */
+               ulong                   shard_cnt, /* Number of dedup shards, in [1,FD_DEDUP_TILE_SHARD_MAX] */
                fd_frag_meta_t *        mcache,    /* Local join to the dedup's frag stream output mcache */
                ulong                   out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
                ulong **                out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
@@ -14,12 +14,16 @@ main( int     argc,
   char const * _cnc        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",        NULL, NULL );
   char const * _in_mcaches = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcaches", NULL, ""   );
   char const * _in_fseqs   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseqs",   NULL, ""   );
+  char const * _in_weights = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-weights", NULL, NULL ); /* NULL <> all 1 */
   char const * _tcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tcache",     NULL, NULL );
   char const * _mcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",     NULL, NULL );
   char const * _out_fseqs  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",  NULL, ""   );
   ulong        cr_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",     NULL, 0UL  ); /*   0 <> use default */
   long         lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",       NULL, 0L   ); /* <=0 <> use default */
   uint         seed        = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",       NULL, (uint)(ulong)fd_tickcount() );
+  int          hot         = fd_env_strip_cmdline_int  ( &argc, &argv, "--hot",        NULL, 0    ); /*   0 <> no hot tcache */
+  ulong        shard_idx   = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-idx",  NULL, 0UL  );
+  ulong        shard_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-cnt",  NULL, 1UL  ); /*   1 <> not sharded */
 
   if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
   FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
@@ -48,6 +52,19 @@ main( int     argc,
     if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
   }
 
+  ulong   _in_weight[ 256 ];
+  ulong * in_weight = NULL;
+  if( _in_weights ) {
+    char * _in_weight_cstr[ 256 ];
+    tmp = fd_cstr_tokenize( _in_weight_cstr, 256UL, (char *)_in_weights, ',' ); /* argv is non-const */
+    if( FD_UNLIKELY( tmp!=in_cnt ) ) FD_LOG_ERR(( "--in-mcaches and --in-weights mismatch" ));
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+      _in_weight[ in_idx ] = fd_cstr_to_ulong( _in_weight_cstr[ in_idx ] );
+      FD_LOG_NOTICE(( "Using --in-weights[%lu] %lu", in_idx, _in_weight[ in_idx ] ));
+    }
+    in_weight = _in_weight;
+  }
+
   if( FD_UNLIKELY( !_tcache ) ) FD_LOG_ERR(( "--tcache not specified" ));
   FD_LOG_NOTICE(( "Joining --tcache %s", _tcache ));
   fd_tcache_t * tcache = fd_tcache_join( fd_wksp_map( _tcache ) );
@@ -76,7 +93,7 @@ main( int     argc,
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
 
   FD_LOG_NOTICE(( "Creating scratch" ));
-  ulong footprint = fd_dedup_tile_scratch_footprint( in_cnt, out_cnt );
+  ulong footprint = fd_dedup_tile_scratch_footprint( in_cnt, out_cnt, hot );
   if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_dedup_tile_scratch_footprint failed" ));
   ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
   ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
@@ -87,7 +104,8 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, in_weight, tcache, hot, shard_idx, shard_cnt, mcache, out_cnt, out_fseq,
+                           cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
@@ -29,6 +29,9 @@ struct test_cfg {
   uchar *     dedup_scratch_mem;
   ulong       dedup_cr_max;
   long        dedup_lazy;
+  int         dedup_hot;
+  ulong       dedup_shard_idx;
+  ulong       dedup_shard_cnt;
   uint        dedup_seed;
 
   ulong       rx_cnt;
@@ -48,6 +51,12 @@ struct test_cfg {
 
 typedef struct test_cfg test_cfg_t;
 
+/* The dedup is booted with an unbound in slot at index tx_cnt (see
+   dedup_tile_main).  The rxs count the frags they received from tx 0
+   in their cnc diagnostics to check in detach / attach. */
+
+#define RX_CNC_DIAG_TX0_CNT (2UL)
+
 /* TX tile ************************************************************/
 
 /* This uses the same methodology as test_frag_tx.c to inject test
@@ -271,13 +280,17 @@ dedup_tile_main( int     argc,
 
   fd_cnc_t * cnc = fd_cnc_join( cfg->dedup_cnc_mem );
 
-  fd_frag_meta_t const * tx_mcache[ 128 ];
-  for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ )
+  fd_frag_meta_t const * tx_mcache[ 129 ];
+  ulong *                tx_fseq  [ 129 ];
+  ulong                  tx_weight[ 129 ];
+  for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ ) {
     tx_mcache[ tx_idx ] = fd_mcache_join( cfg->tx_mcache_mem + tx_idx*cfg->tx_mcache_footprint );
-
-  ulong * tx_fseq[ 128 ];
-  for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ )
-    tx_fseq[ tx_idx ] = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
+    tx_fseq  [ tx_idx ] = fd_fseq_join  ( cfg->tx_fseq_mem   + tx_idx*cfg->tx_fseq_footprint   );
+    tx_weight[ tx_idx ] = 1UL;
+  }
+  tx_mcache[ cfg->tx_cnt ] = NULL; /* Unbound slot for attaching a producer at run time */
+  tx_fseq  [ cfg->tx_cnt ] = NULL;
+  tx_weight[ cfg->tx_cnt ] = 0UL;
 
   fd_tcache_t *    dedup_tcache = fd_tcache_join( cfg->dedup_tcache_mem );
   fd_frag_meta_t * dedup_mcache = fd_mcache_join( cfg->dedup_mcache_mem );
@@ -289,7 +302,8 @@ dedup_tile_main( int     argc,
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->dedup_seed, 0UL ) );
 
-  int err = fd_dedup_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, dedup_tcache, dedup_mcache, cfg->rx_cnt, rx_fseq,
+  int err = fd_dedup_tile( cnc, cfg->tx_cnt+1UL, tx_mcache, tx_fseq, tx_weight, dedup_tcache, cfg->dedup_hot, cfg->dedup_shard_idx, cfg->dedup_shard_cnt,
+                           dedup_mcache, cfg->rx_cnt, rx_fseq,
                            cfg->dedup_cr_max, cfg->dedup_lazy, rng, cfg->dedup_scratch_mem );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
 
@@ -348,6 +362,9 @@ rx_tile_main( int     argc,
   long  then = fd_log_wallclock();
   ulong iter = 0UL;
 
+  ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  ulong   tx0_cnt  = 0UL;
+
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
   for(;;) {
 
@@ -377,6 +394,9 @@ rx_tile_main( int     argc,
       /* Send diagnostic info */
       long now = fd_log_wallclock();
       fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( cnc_diag[ RX_CNC_DIAG_TX0_CNT ] ) = tx0_cnt;
+      FD_COMPILER_MFENCE();
 
       long dt = now - then;
       if( FD_UNLIKELY( dt > (long)1e9 ) ) {
@@ -407,8 +427,12 @@ rx_tile_main( int     argc,
     int is_dup;
     FD_TCACHE_INSERT( is_dup, tcache_sync, _tcache_ring, tcache_depth, _tcache_map, tcache_map_cnt, sig );
     if( FD_UNLIKELY( is_dup ) ) FD_LOG_ERR(( "Received a duplicate" ));
+    if( FD_UNLIKELY( fd_dedup_shard_idx( sig, cfg->dedup_shard_cnt )!=cfg->dedup_shard_idx ) )
+      FD_LOG_ERR(( "Received a frag for another shard" ));
+
+    tx0_cnt += (ulong)!fd_frag_meta_ctl_orig( ctl );
 
-    (void)ctl; (void)tsorig; (void)tspub; (void)sz; (void)chunk; (void)wksp;
+    (void)tsorig; (void)tspub; (void)sz; (void)chunk; (void)wksp;
 
     uchar const * p = (uchar const *)fd_chunk_to_laddr_const( wksp, chunk );
     __m256i avx = _mm256_set1_epi64x( (long)sig );
@@ -444,6 +468,20 @@ rx_tile_main( int     argc,
 
 /* CNC tile ***********************************************************/
 
+/* rx_tx0_cnt returns the number of frags from tx 0 the rxs have
+   received (as of their last housekeeping) */
+
+static ulong
+rx_tx0_cnt( test_cfg_t * cfg ) {
+  ulong cnt = 0UL;
+  for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ ) {
+    fd_cnc_t * cnc = fd_cnc_join( cfg->rx_cnc_mem + rx_idx*cfg->rx_cnc_footprint );
+    cnt += FD_VOLATILE_CONST( ((ulong const *)fd_cnc_app_laddr_const( cnc ))[ RX_CNC_DIAG_TX0_CNT ] );
+    fd_cnc_leave( cnc );
+  }
+  return cnt;
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -453,34 +491,50 @@ main( int     argc,
   fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
 
   FD_TEST( fd_dedup_tile_scratch_align()==FD_DEDUP_TILE_SCRATCH_ALIGN );
-  FD_TEST( !fd_dedup_tile_scratch_footprint( FD_DEDUP_TILE_IN_MAX +1UL, 1UL ) );
-  FD_TEST( !fd_dedup_tile_scratch_footprint( 1UL, FD_DEDUP_TILE_OUT_MAX+1UL ) );
+  FD_TEST( !fd_dedup_tile_scratch_footprint( FD_DEDUP_TILE_IN_MAX +1UL, 1UL, 0 ) );
+  FD_TEST( !fd_dedup_tile_scratch_footprint( 1UL, FD_DEDUP_TILE_OUT_MAX+1UL, 0 ) );
+  for( ulong iter_rem=10000000UL; iter_rem; iter_rem-- ) {
+    ulong shard_cnt = fd_rng_ulong_roll( rng, FD_DEDUP_TILE_SHARD_MAX ) + 1UL;
+    ulong sig0      = fd_rng_ulong( rng );
+    ulong sig1      = fd_rng_ulong( rng );
+    ulong shard0    = fd_dedup_shard_idx( sig0, shard_cnt );
+    ulong shard1    = fd_dedup_shard_idx( sig1, shard_cnt );
+    FD_TEST( !fd_dedup_shard_idx( sig0, 1UL ) );
+    FD_TEST( shard0<shard_cnt ); FD_TEST( shard1<shard_cnt );
+    FD_TEST( (sig0<=sig1) ? (shard0<=shard1) : (shard0>=shard1) ); /* shards are contiguous sig ranges */
+  }
+  FD_TEST( fd_dedup_shard_idx( ULONG_MAX, FD_DEDUP_TILE_SHARD_MAX )==FD_DEDUP_TILE_SHARD_MAX-1UL );
   for( ulong iter_rem=10000000UL; iter_rem; iter_rem-- ) {
     ulong in_cnt  = fd_rng_ulong_roll( rng, FD_DEDUP_TILE_IN_MAX +1UL );
     ulong out_cnt = fd_rng_ulong_roll( rng, FD_DEDUP_TILE_OUT_MAX+1UL );
-    FD_TEST( fd_dedup_tile_scratch_footprint( in_cnt, out_cnt )==FD_DEDUP_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt ) );
+    int   hot     = (int)fd_rng_uint_roll( rng, 2U );
+    FD_TEST( fd_dedup_tile_scratch_footprint( in_cnt, out_cnt, hot )==FD_DEDUP_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt, hot ) );
+    if( hot ) FD_TEST( fd_dedup_tile_scratch_footprint( in_cnt, out_cnt, 0 )<fd_dedup_tile_scratch_footprint( in_cnt, out_cnt, 1 ) );
   }
 
   ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
   if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
 
-  char const * _page_sz       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",        NULL, "gigantic"                 );
-  ulong        page_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",       NULL, 1UL                        );
-  ulong        numa_idx       = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",       NULL, fd_shmem_numa_idx(cpu_idx) );
-  ulong        tx_cnt         = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cnt",         NULL, 2UL                        );
-  ulong        tx_depth       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",       NULL, 32768UL                    );
-  ulong        tx_mtu         = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",         NULL, 1472UL                     );
-  long         tx_lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",        NULL, 0L                         );
-  ulong        tcache_depth   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-depth",   NULL, 4194302UL                  );
-  ulong        tcache_map_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-map-cnt", NULL, 0UL /* use default */      );
-  ulong        dedup_depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-depth",    NULL, 32768UL                    );
-  ulong        dedup_cr_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-cr-max",   NULL, 0UL /* use default */      );
-  long         dedup_lazy     = fd_env_strip_cmdline_long ( &argc, &argv, "--dedup-lazy",     NULL, 0L /* use default */       );
-  ulong        rx_cnt         = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",         NULL, 2UL                        );
-  int          rx_lazy        = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",        NULL, 7                          );
-  ulong        test_depth     = fd_env_strip_cmdline_ulong( &argc, &argv, "--test-depth",     NULL, 2046UL                     );
-  ulong        test_map_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--test-map-cnt",   NULL, 0UL /* use default */      );
-  long         duration       = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",       NULL, (long)10e9                 );
+  char const * _page_sz        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",         NULL, "gigantic"                 );
+  ulong        page_cnt        = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",        NULL, 1UL                        );
+  ulong        numa_idx        = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",        NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        tx_cnt          = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cnt",          NULL, 2UL                        );
+  ulong        tx_depth        = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",        NULL, 32768UL                    );
+  ulong        tx_mtu          = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",          NULL, 1472UL                     );
+  long         tx_lazy         = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",         NULL, 0L                         );
+  ulong        tcache_depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-depth",    NULL, 4194302UL                  );
+  ulong        tcache_map_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-map-cnt",  NULL, 0UL /* use default */      );
+  ulong        dedup_depth     = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-depth",     NULL, 32768UL                    );
+  ulong        dedup_cr_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-cr-max",    NULL, 0UL /* use default */      );
+  long         dedup_lazy      = fd_env_strip_cmdline_long ( &argc, &argv, "--dedup-lazy",      NULL, 0L /* use default */       );
+  int          dedup_hot       = fd_env_strip_cmdline_int  ( &argc, &argv, "--dedup-hot",       NULL, 0                          );
+  ulong        dedup_shard_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-shard-idx", NULL, 0UL                        );
+  ulong        dedup_shard_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-shard-cnt", NULL, 1UL                        );
+  ulong        rx_cnt          = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",          NULL, 2UL                        );
+  int          rx_lazy         = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",         NULL, 7                          );
+  ulong        test_depth      = fd_env_strip_cmdline_ulong( &argc, &argv, "--test-depth",      NULL, 2046UL                     );
+  ulong        test_map_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--test-map-cnt",    NULL, 0UL /* use default */      );
+  long         duration        = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",        NULL, (long)10e9                 );
 
   float burst_avg       = fd_env_strip_cmdline_float( &argc, &argv, "--burst-avg",       NULL,                    1472.f );
   ulong pkt_payload_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-payload-max", NULL,                    1472UL );
@@ -530,8 +584,9 @@ main( int     argc,
   fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( wksp );
 
-  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, dedup-cnt 1, --rx-cnt %lu, app-sz 64)", tx_cnt, rx_cnt ));
-  ulong   cnc_footprint = fd_cnc_footprint( 64UL ); /* Room for 8 64-bit diagnostic counters */
+  ulong cnc_app_sz = 160UL; /* Room for the in command args and a metric registry describing the 2 tile diagnostics */
+  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, dedup-cnt 1, --rx-cnt %lu, app-sz %lu)", tx_cnt, rx_cnt, cnc_app_sz ));
+  ulong   cnc_footprint = fd_cnc_footprint( cnc_app_sz );
   uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), cnc_footprint*(tx_cnt+1UL+rx_cnt) );
   FD_TEST( cnc_mem );
 
@@ -574,7 +629,7 @@ main( int     argc,
   FD_TEST( dedup_mcache_mem );
 
   FD_LOG_NOTICE(( "Creating dedup scratch" ));
-  ulong   dedup_scratch_footprint = fd_dedup_tile_scratch_footprint( tx_cnt, rx_cnt );
+  ulong   dedup_scratch_footprint = fd_dedup_tile_scratch_footprint( tx_cnt+1UL, rx_cnt, dedup_hot ); /* +1 for the unbound slot */
   uchar * dedup_scratch_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_dedup_tile_scratch_align(), dedup_scratch_footprint );
   FD_TEST( dedup_scratch_mem );
 
@@ -604,6 +659,9 @@ main( int     argc,
   cfg->dedup_scratch_mem = dedup_scratch_mem;
   cfg->dedup_cr_max      = dedup_cr_max;
   cfg->dedup_lazy        = dedup_lazy;
+  cfg->dedup_hot         = dedup_hot;
+  cfg->dedup_shard_idx   = dedup_shard_idx;
+  cfg->dedup_shard_cnt   = dedup_shard_cnt;
   cfg->dedup_seed        = rng_seq++;
 
   cfg->rx_cnt        = rx_cnt;
@@ -622,7 +680,7 @@ main( int     argc,
 
   for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
     ulong tx_seq0 = fd_rng_ulong( rng );
-    FD_TEST( fd_cnc_new   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint,    64UL, 0UL, now         ) );
+    FD_TEST( fd_cnc_new   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint,    cnc_app_sz, 0UL, now   ) );
     FD_TEST( fd_rng_new   ( cfg->tx_rng_mem    + tx_idx*cfg->tx_rng_footprint,    rng_seq++, 0UL         ) );
     FD_TEST( fd_fseq_new  ( cfg->tx_fseq_mem   + tx_idx*cfg->tx_fseq_footprint,   tx_seq0                ) );
     FD_TEST( fd_mcache_new( cfg->tx_mcache_mem + tx_idx*cfg->tx_mcache_footprint, tx_depth, 0UL, tx_seq0 ) );
@@ -631,12 +689,12 @@ main( int     argc,
   }
 
   ulong dedup_seq0 = fd_rng_ulong( rng );
-  FD_TEST( fd_cnc_new   ( cfg->dedup_cnc_mem,    64UL, 1UL, now               ) );
+  FD_TEST( fd_cnc_new   ( cfg->dedup_cnc_mem,    cnc_app_sz, 1UL, now         ) );
   FD_TEST( fd_tcache_new( cfg->dedup_tcache_mem, tcache_depth, tcache_map_cnt ) );
   FD_TEST( fd_mcache_new( cfg->dedup_mcache_mem, dedup_depth, 0UL, dedup_seq0 ) );
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
-    FD_TEST( fd_cnc_new   ( cfg->rx_cnc_mem    + rx_idx*cfg->rx_cnc_footprint,    64UL, 2UL, now           ) );
+    FD_TEST( fd_cnc_new   ( cfg->rx_cnc_mem    + rx_idx*cfg->rx_cnc_footprint,    cnc_app_sz, 2UL, now     ) );
     FD_TEST( fd_rng_new   ( cfg->rx_rng_mem    + rx_idx*cfg->rx_rng_footprint,    rng_seq++, 0UL           ) );
     FD_TEST( fd_fseq_new  ( cfg->rx_fseq_mem   + rx_idx*cfg->rx_fseq_footprint,   dedup_seq0               ) );
     FD_TEST( fd_tcache_new( cfg->rx_tcache_mem + rx_idx*cfg->rx_tcache_footprint, test_depth, test_map_cnt ) );
@@ -663,11 +721,62 @@ main( int     argc,
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
     FD_TEST( fd_cnc_wait( cnc[ tile_idx ], FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --dedup-cr-max %lu, --dedup-lazy %li ns, --rx-lazy %i)",
-                  duration, tx_lazy, dedup_cr_max, dedup_lazy, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --dedup-cr-max %lu, --dedup-lazy %li ns, --dedup-hot %i, "
+                  "--dedup-shard-idx %lu, --dedup-shard-cnt %lu, --rx-lazy %i)",
+                  duration, tx_lazy, dedup_cr_max, dedup_lazy, dedup_hot, dedup_shard_idx, dedup_shard_cnt, rx_lazy ));
 
   /* FIXME: DO MONITORING WHILE RUNNING */
-  fd_log_sleep( duration );
+  fd_log_sleep( duration/4L );
+
+  /* Detach tx 0 from the running dedup and check its frags stop
+     arriving at the rxs (after letting the frags already in flight
+     drain).  Then reattach it and check its frags resume.  tx 0 is
+     backpressured while detached and resumes where it left off (the
+     rxs check for overruns).  Redundant / bad commands should be
+     rejected. */
+
+  fd_cnc_t * dedup_cnc = cnc[ tx_cnt+1UL ];
+  FD_TEST( !fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_DETACH, 0UL,        0UL, 0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_DETACH, 0UL,        0UL, 0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_DETACH, tx_cnt+1UL, 0UL, 0UL, 0UL, (long)5e9 ) );
+  fd_log_sleep( duration/16L );
+
+  ulong tx0_cnt = rx_tx0_cnt( cfg );
+  fd_log_sleep( duration/8L );
+  FD_TEST( rx_tx0_cnt( cfg )==tx0_cnt );
+
+  FD_TEST(  fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_ATTACH, 0UL, FD_DEDUP_TILE_IN_WEIGHT_MAX+1UL, 0UL, 0UL, (long)5e9 ) );
+  FD_TEST( !fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_ATTACH, 0UL, 1UL,                             0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_ATTACH, 0UL, 1UL,                             0UL, 0UL, (long)5e9 ) );
+  fd_log_sleep( duration/8L );
+  FD_TEST( rx_tx0_cnt( cfg )>tx0_cnt );
+
+  /* Move tx 0 to the unbound slot by detaching it, waiting for the rxs
+     to catch up (such that the dedup has returned all of tx 0's
+     credits) and binding the unbound slot to tx 0's mcache and fseq at
+     run time.  The slot cannot be attached without an mcache while it
+     is unbound. */
+
+  FD_TEST( !fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_DETACH, 0UL,    0UL, 0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_ATTACH, tx_cnt, 1UL, 0UL, 0UL, (long)5e9 ) );
+  fd_log_sleep( duration/16L );
+
+  tx0_cnt = rx_tx0_cnt( cfg );
+  fd_log_sleep( duration/8L );
+  FD_TEST( rx_tx0_cnt( cfg )==tx0_cnt );
+
+  ulong tx0_mcache_gaddr = fd_wksp_gaddr( wksp, cfg->tx_mcache_mem );
+  ulong tx0_fseq_gaddr   = fd_wksp_gaddr( wksp, cfg->tx_fseq_mem   );
+  FD_TEST( !fd_disco_in_cmd( dedup_cnc, FD_DEDUP_CNC_SIGNAL_ATTACH, tx_cnt, 1UL, tx0_mcache_gaddr, tx0_fseq_gaddr, (long)5e9 ) );
+
+  /* The in command args should not have clobbered the tile's metric
+     registry */
+
+  FD_TEST( fd_cnc_metric_find( dedup_cnc, "in_backp"  )!=ULONG_MAX );
+  FD_TEST( fd_cnc_metric_find( dedup_cnc, "backp_cnt" )!=ULONG_MAX );
+
+  fd_log_sleep( duration/4L );
+  FD_TEST( rx_tx0_cnt( cfg )>tx0_cnt );
 
   FD_LOG_NOTICE(( "Halting" ));
 
@@ -688,6 +797,24 @@ main( int     argc,
 
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_cnc_leave( cnc[ tile_idx ] ) );
 
+  /* Every frag this shard handled from a tx should have been sampled
+     into the latency histograms of the tx's fseq exactly once (frags
+     handled by other shards are neither counted nor sampled) */
+
+  for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+    ulong const * fseq = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
+    ulong const * diag = (ulong const *)fd_fseq_app_laddr_const( fseq );
+    ulong lat_pub_cnt  = 0UL;
+    ulong lat_orig_cnt = 0UL;
+    for( ulong idx=0UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) {
+      lat_pub_cnt  += diag[ FD_FSEQ_DIAG_LAT_PUB  + idx ];
+      lat_orig_cnt += diag[ FD_FSEQ_DIAG_LAT_ORIG + idx ];
+    }
+    ulong cnt = diag[ FD_FSEQ_DIAG_PUB_CNT ] + diag[ FD_FSEQ_DIAG_FILT_CNT ];
+    FD_TEST( lat_pub_cnt==cnt ); FD_TEST( lat_orig_cnt==cnt );
+    fd_fseq_leave( fseq );
+  }
+
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
@@ -2,9 +2,15 @@
 #define HEADER_fd_src_disco_fd_disco_h
 
 //#include "fd_disco_base.h"  /* includes ../tango/fd_tango.h */
+#include "bstore/fd_bstore.h" /* includes fd_disco_base.h */
 #include "dedup/fd_dedup.h"   /* includes fd_disco_base.h */
+#include "lb/fd_lb.h"         /* includes fd_disco_base.h */
 #include "mux/fd_mux.h"       /* includes fd_disco_base.h */
+#include "rec/fd_rec.h"       /* includes fd_disco_base.h */
+#include "relay/fd_relay.h"   /* includes fd_disco_base.h */
 #include "replay/fd_replay.h" /* includes fd_disco_base.h */
+#include "sink/fd_sink.h"     /* includes fd_disco_base.h */
+#include "sock/fd_sock.h"     /* includes fd_disco_base.h */
 
 #endif /* HEADER_fd_src_disco_fd_disco_base_h */
 
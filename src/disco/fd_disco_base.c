@@ -0,0 +1,170 @@
+#include "fd_disco_base.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+ulong
+fd_disco_in_cmd_handle( fd_cnc_t *      cnc,
+                        int             attach,
+                        fd_disco_in_t * in,
+                        ulong           in_cnt,
+                        ulong           weight_max,
+                        ulong           cr_max,
+                        ulong           exposed_cnt,
+                        ushort *        poll_map,
+                        ulong           poll_cnt,
+                        fd_rng_t *      rng ) {
+  ulong *      cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  ulong        in_idx   = cnc_diag[ FD_DISCO_CNC_ARG_IN_IDX ];
+  char const * op       = attach ? "attach" : "detach";
+
+  if( FD_UNLIKELY( in_idx>=in_cnt ) ) {
+    FD_LOG_WARNING(( "%s in %lu failed (in_idx must be in [0,%lu))", op, in_idx, in_cnt ));
+    goto fail;
+  }
+
+  ulong found = 0UL;
+  for( ulong poll_seq=0UL; poll_seq<poll_cnt; poll_seq++ ) found += (ulong)(poll_map[ poll_seq ]==(ushort)in_idx);
+
+  if( !attach ) {
+    if( FD_UNLIKELY( !found ) ) {
+      FD_LOG_WARNING(( "detach in %lu failed (not attached)", in_idx ));
+      goto fail;
+    }
+    ulong keep_cnt = 0UL;
+    for( ulong poll_seq=0UL; poll_seq<poll_cnt; poll_seq++ ) {
+      ushort map_tmp = poll_map[ poll_seq ];
+      poll_map[ keep_cnt ] = map_tmp;
+      keep_cnt += (ulong)(map_tmp!=(ushort)in_idx);
+    }
+    FD_LOG_INFO(( "detached in %lu (poll_cnt %lu)", in_idx, keep_cnt ));
+    return keep_cnt;
+  }
+
+  ulong weight       = cnc_diag[ FD_DISCO_CNC_ARG_IN_WEIGHT ];
+  ulong mcache_gaddr = cnc_diag[ FD_DISCO_CNC_ARG_IN_MCACHE ];
+  ulong fseq_gaddr   = cnc_diag[ FD_DISCO_CNC_ARG_IN_FSEQ   ];
+  if( !weight ) weight = 1UL;
+
+  if( FD_UNLIKELY( found ) ) {
+    FD_LOG_WARNING(( "attach in %lu failed (already attached)", in_idx ));
+    goto fail;
+  }
+
+  if( FD_UNLIKELY( weight>weight_max ) ) {
+    FD_LOG_WARNING(( "attach in %lu failed (weight %lu must be in [1,%lu])", in_idx, weight, weight_max ));
+    goto fail;
+  }
+
+  fd_disco_in_t * this_in = &in[ in_idx ];
+
+  if( mcache_gaddr ) {
+
+    /* Bind the slot to a new in */
+
+    fd_wksp_t * wksp = fd_wksp_containing( cnc );
+    if( FD_UNLIKELY( !wksp ) ) {
+      FD_LOG_WARNING(( "attach in %lu failed (cnc is not in a wksp)", in_idx ));
+      goto fail;
+    }
+
+    fd_frag_meta_t const * mcache = fd_mcache_join( fd_wksp_laddr( wksp, mcache_gaddr ) );
+    if( FD_UNLIKELY( !mcache ) ) {
+      FD_LOG_WARNING(( "attach in %lu failed (no mcache at gaddr %lu)", in_idx, mcache_gaddr ));
+      goto fail;
+    }
+
+    ulong * fseq = fseq_gaddr ? fd_fseq_join( fd_wksp_laddr( wksp, fseq_gaddr ) ) : NULL;
+    if( FD_UNLIKELY( !fseq ) ) {
+      FD_LOG_WARNING(( "attach in %lu failed (no fseq at gaddr %lu)", in_idx, fseq_gaddr ));
+      goto fail;
+    }
+
+    ulong depth = fd_mcache_depth( mcache );
+    if( FD_UNLIKELY( depth<cr_max ) ) {
+      FD_LOG_WARNING(( "attach in %lu failed (mcache depth %lu must be at least cr_max %lu)", in_idx, depth, cr_max ));
+      goto fail;
+    }
+
+    /* Settle up with the previous in (if any) */
+
+    fd_disco_in_update( this_in, exposed_cnt );
+
+    ulong seq      = fd_mcache_seq_query( fd_mcache_seq_laddr_const( mcache ) );
+    ulong fseq_seq = fd_fseq_query( fseq );
+    long  lag      = fd_seq_diff( seq, fseq_seq );
+    if( FD_LIKELY( (0L<=lag) & (lag<=(long)depth) ) ) seq = fseq_seq;
+    else                                              fd_fseq_update( fseq, seq );
+
+    fd_disco_in_init( this_in, mcache, fseq, seq );
+    FD_LOG_INFO(( "bound in %lu to mcache gaddr %lu and fseq gaddr %lu (seq %lu)", in_idx, mcache_gaddr, fseq_gaddr, seq ));
+
+  } else if( FD_UNLIKELY( !this_in->mcache ) ) {
+    FD_LOG_WARNING(( "attach in %lu failed (slot not bound to an in and no mcache given)", in_idx ));
+    goto fail;
+  }
+
+  for( ulong rem=weight; rem; rem-- ) {
+    ulong swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)(poll_cnt+1UL) );
+    poll_map[ poll_cnt ] = poll_map[ swap_idx ];
+    poll_map[ swap_idx ] = (ushort)in_idx;
+    poll_cnt++;
+  }
+  FD_LOG_INFO(( "attached in %lu (weight %lu, poll_cnt %lu)", in_idx, weight, poll_cnt ));
+  return poll_cnt;
+
+fail:
+  cnc_diag[ FD_DISCO_CNC_ARG_IN_IDX ] = ULONG_MAX;
+  return poll_cnt;
+}
+
+int
+fd_disco_in_cmd( fd_cnc_t * cnc,
+                 ulong      signal,
+                 ulong      in_idx,
+                 ulong      weight,
+                 ulong      mcache_gaddr,
+                 ulong      fseq_gaddr,
+                 long       timeout ) {
+
+  if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+
+  if( FD_UNLIKELY( !((signal==FD_DISCO_CNC_SIGNAL_ATTACH) | (signal==FD_DISCO_CNC_SIGNAL_DETACH)) ) ) {
+    FD_LOG_WARNING(( "bad signal %lu", signal ));
+    return 1;
+  }
+
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_DISCO_CNC_CMD_APP_SZ ) ) {
+    FD_LOG_WARNING(( "cnc app sz must be at least %lu for in commands", FD_DISCO_CNC_CMD_APP_SZ ));
+    return 1;
+  }
+
+  int err = fd_cnc_open( cnc );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "fd_cnc_open failed (%i-%s)", err, fd_cnc_strerror( err ) ));
+    return 1;
+  }
+
+  ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cnc_diag[ FD_DISCO_CNC_ARG_IN_IDX    ] ) = in_idx;
+  FD_VOLATILE( cnc_diag[ FD_DISCO_CNC_ARG_IN_WEIGHT ] ) = weight;
+  FD_VOLATILE( cnc_diag[ FD_DISCO_CNC_ARG_IN_MCACHE ] ) = mcache_gaddr;
+  FD_VOLATILE( cnc_diag[ FD_DISCO_CNC_ARG_IN_FSEQ   ] ) = fseq_gaddr;
+  FD_COMPILER_MFENCE();
+  fd_cnc_signal( cnc, signal );
+
+  ulong s = fd_cnc_wait( cnc, signal, timeout, NULL );
+  if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+    char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+    FD_LOG_WARNING(( "%s in %lu failed (tile did not return to run, signal %s)",
+                     signal==FD_DISCO_CNC_SIGNAL_ATTACH ? "attach" : "detach", in_idx, fd_cnc_signal_cstr( s, buf ) ));
+    fd_cnc_close( cnc );
+    return 1;
+  }
+
+  err = (FD_VOLATILE_CONST( cnc_diag[ FD_DISCO_CNC_ARG_IN_IDX ] )==ULONG_MAX); /* tile logged details */
+  fd_cnc_close( cnc );
+  return err;
+}
+
+#endif
@@ -3,12 +3,277 @@
 
 #include "../tango/fd_tango.h"
 
-//FD_PROTOTYPES_BEGIN
+#if FD_HAS_HOSTED && FD_HAS_X86
 
-/* This is currently just a stub in anticipation of future common tile
-   functionality */
+/* FD_DISCO_CNC_SIGNAL_{ATTACH,DETACH} can be raised by a cnc thread
+   with an open command session while a disco tile that polls multiple
+   ins (e.g. fd_mux and fd_dedup) is in the RUN state to attach / detach
+   an in to / from the tile while it is running (e.g. to scale the
+   number of producers feeding the tile up and down without restarting
+   the tile and everything downstream of it).  The arguments of the
+   command are passed in the cnc app region:
 
-//FD_PROTOTYPES_END
+     FD_DISCO_CNC_ARG_IN_IDX:    index of the in to attach / detach, in
+                                 [0,in_cnt) where in_cnt is the number of
+                                 in slots the tile was booted with.
+     FD_DISCO_CNC_ARG_IN_WEIGHT: (attach only) polling weight for the in,
+                                 in [0,weight_max] (0 is treated as 1).
+     FD_DISCO_CNC_ARG_IN_MCACHE: (attach only) wksp gaddr of the mcache
+                                 to bind the slot to or 0 to resume the
+                                 in the slot is currently bound to.
+     FD_DISCO_CNC_ARG_IN_FSEQ:   (attach only, ignored if IN_MCACHE is 0)
+                                 wksp gaddr of the fseq the tile should
+                                 use to return credits to the new in.
+
+   The gaddrs are relative to the wksp holding the tile's cnc.  The tile
+   transitions the cnc back to RUN the next time it processes cnc
+   signals after it has handled the command.  If the command failed
+   (e.g. bad in_idx, attaching an in that is already attached, detaching
+   an in that is not attached, bad mcache / fseq), the tile logs details
+   and sets FD_DISCO_CNC_ARG_IN_IDX to ULONG_MAX.  The cnc app region
+   must be at least FD_DISCO_CNC_CMD_APP_SZ bytes to use these (if not,
+   these signals are handled like any other unexpected signal).  The
+   args are not metrics so such tiles register their metrics with a
+   reserved_sz of FD_DISCO_CNC_CMD_APP_SZ (see fd_cnc_metric_register).
+   fd_disco_in_cmd below issues a command and waits for the result. */
+
+#define FD_DISCO_CNC_SIGNAL_ATTACH (5UL)
+#define FD_DISCO_CNC_SIGNAL_DETACH (6UL)
+
+#define FD_DISCO_CNC_ARG_IN_IDX    (6UL)
+#define FD_DISCO_CNC_ARG_IN_WEIGHT (7UL)
+#define FD_DISCO_CNC_ARG_IN_MCACHE (8UL)
+#define FD_DISCO_CNC_ARG_IN_FSEQ   (9UL)
+
+#define FD_DISCO_CNC_CMD_APP_SZ (80UL)
+
+/* A fd_disco_in has all the state a tile needs for consuming frags
+   from an in it polls.  It fits on exactly one cache line.  An in slot
+   that is not bound to an in has a NULL mcache and fseq. */
+
+struct __attribute__((aligned(64))) fd_disco_in {
+  fd_frag_meta_t const * mcache;   /* local join to this in's mcache */
+  ulong                  depth;    /* == fd_mcache_depth( mcache ), depth of this in's cache (const) */
+  ulong                  seq;      /* sequence number of next frag expected from the upstream producer,
+                                      updated when frag from this in published/filtered */
+  fd_frag_meta_t const * mline;    /* == mcache + fd_mcache_line_idx( seq, depth ), location to poll next */
+  ulong *                fseq;     /* local join to the fseq used to return flow control credits the in */
+  uint                   accum[6]; /* local diagnostic accumualtors.  These are drained during in housekeeping. */
+                                   /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+};
+
+typedef struct fd_disco_in fd_disco_in_t;
+
+#endif
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_disco_copy_nt copies sz bytes from src to dst using non-temporal
+   stores where possible.  dst is assumed to be 32-byte aligned and to
+   have room for sz rounded up to a multiple of 32 bytes (bytes past sz
+   in the last 32-byte block will be clobbered).  src has no alignment
+   requirements and only [src,src+sz) will be read.  Payload chunks in a
+   dcache are double chunk aligned and have a footprint that is a
+   multiple of a double chunk so any dcache chunk satisfies the dst
+   requirements.  The stores are not ordered with respect to later
+   stores until fd_disco_copy_fence is called. */
+
+static inline void
+fd_disco_copy_nt( void *       dst,
+                  void const * src,
+                  ulong        sz ) {
+# if FD_HAS_AVX
+  uchar *       d = (uchar *)      dst;
+  uchar const * s = (uchar const *)src;
+  for( ; sz>=128UL; sz-=128UL ) {
+    __m256i a0 = _mm256_loadu_si256( (__m256i const *)(s      ) );
+    __m256i a1 = _mm256_loadu_si256( (__m256i const *)(s+ 32UL) );
+    __m256i a2 = _mm256_loadu_si256( (__m256i const *)(s+ 64UL) );
+    __m256i a3 = _mm256_loadu_si256( (__m256i const *)(s+ 96UL) );
+    _mm256_stream_si256( (__m256i *)(d      ), a0 );
+    _mm256_stream_si256( (__m256i *)(d+ 32UL), a1 );
+    _mm256_stream_si256( (__m256i *)(d+ 64UL), a2 );
+    _mm256_stream_si256( (__m256i *)(d+ 96UL), a3 );
+    s += 128UL; d += 128UL;
+  }
+  for( ; sz>=32UL; sz-=32UL ) {
+    _mm256_stream_si256( (__m256i *)d, _mm256_loadu_si256( (__m256i const *)s ) );
+    s += 32UL; d += 32UL;
+  }
+  if( sz ) { /* Stage the tail so we don't read past the end of src */
+    __m256i tail[1];
+    tail[0] = _mm256_setzero_si256();
+    fd_memcpy( tail, s, sz );
+    _mm256_stream_si256( (__m256i *)d, tail[0] );
+  }
+# else
+  fd_memcpy( dst, src, sz );
+# endif
+}
+
+/* fd_disco_copy_fence makes all stores done by previous
+   fd_disco_copy_nt calls visible before any subsequent stores (e.g.
+   the publication of the frag metadata that describes the copied
+   payloads). */
+
+static inline void
+fd_disco_copy_fence( void ) {
+# if FD_HAS_SSE
+  _mm_sfence();
+# endif
+  FD_COMPILER_MFENCE();
+}
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* fd_disco_in_init binds in to the in with the given local joins of its
+   mcache and fseq, starting at seq in the in's sequence space.  mcache
+   and fseq can both be NULL to mark the slot as unbound (seq is ignored
+   in this case). */
+
+static inline void
+fd_disco_in_init( fd_disco_in_t *        in,
+                  fd_frag_meta_t const * mcache,
+                  ulong *                fseq,
+                  ulong                  seq ) {
+  in->mcache = mcache;
+  in->fseq   = fseq;
+  in->depth  = mcache ? fd_mcache_depth( mcache ) : 0UL;
+  in->seq    = mcache ? seq : 0UL;
+  in->mline  = mcache ? (mcache + fd_mcache_line_idx( seq, in->depth )) : NULL;
+  in->accum[0] = 0U; in->accum[1] = 0U; in->accum[2] = 0U;
+  in->accum[3] = 0U; in->accum[4] = 0U; in->accum[5] = 0U;
+}
+
+/* fd_disco_in_update returns flow control credits to the in assuming
+   that there are at most exposed_cnt frags currently exposed to
+   reliable outs and drains the run-time diagnostics accumulated since
+   the last update.  Note that, once an in sequence number has been
+   confirmed to have been consumed downstream, it will remain consumed.
+   So, we can optimize this (and guarantee a monotonically increasing
+   fseq from the in's point of view) by only sending when
+   this_in_seq-exposed_cnt ends up ahead of this_in_fseq.  We still
+   drain diagnostics every update as we might still have diagnostic
+   accumulated since last update even when we don't need to update
+   this_in_fseq.  See note below about quasi-atomic draining.  This is
+   a no-op for an unbound in slot.
+
+   For a simple example in normal operation of this, consider the case
+   where, at last update for this in, outs were caught up, and since
+   then, the tile forwarded 1 frag from this in, the tile forwarded 1
+   frag from another in, and the outs didn't make any progress on the
+   forwarded frags.  At this point then, for the implementation below,
+   exposed_cnt will be 2 but this_in_seq will have advanced only 1 such
+   that this_in_seq-exposed_cnt will be before this_in_fseq.  Thus, we
+   will have diagnostics to accumulate for this in but no update needed
+   for this_in_fseq.
+
+   When we drain, we don't do a fully atomic update of the diagnostics
+   as it is only diagnostic and it will still be correct the usual case
+   where individual diagnostic counters aren't used by multiple writers
+   spread over different threads of execution. */
+
+static inline void
+fd_disco_in_update( fd_disco_in_t * in,
+                    ulong           exposed_cnt ) {
+
+  ulong * in_fseq = in->fseq;
+  if( FD_UNLIKELY( !in_fseq ) ) return; /* unbound */
+
+  /* Technically we don't need to use fd_fseq_query here as *in_fseq
+     is not volatile from the tile's point of view.  But we are
+     paranoid, it won't affect performance in this case and it is
+     consistent with typical fseq usages. */
+
+  ulong seq = fd_seq_dec( in->seq, exposed_cnt );
+  if( FD_LIKELY( fd_seq_gt( seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, seq );
+
+  ulong * diag  = (ulong *)fd_fseq_app_laddr( in_fseq );
+  uint *  accum = in->accum;
+  ulong a0 = (ulong)accum[0]; ulong a1 = (ulong)accum[1]; ulong a2 = (ulong)accum[2];
+  ulong a3 = (ulong)accum[3]; ulong a4 = (ulong)accum[4]; ulong a5 = (ulong)accum[5];
+  FD_COMPILER_MFENCE();
+  diag[0] += a0;              diag[1] += a1;              diag[2] += a2;
+  diag[3] += a3;              diag[4] += a4;              diag[5] += a5;
+  FD_COMPILER_MFENCE();
+  accum[0] = 0U;              accum[1] = 0U;              accum[2] = 0U;
+  accum[3] = 0U;              accum[4] = 0U;              accum[5] = 0U;
+}
+
+/* fd_disco_in_cmd_handle handles a FD_DISCO_CNC_SIGNAL_{ATTACH,DETACH}
+   command (attach is non-zero for ATTACH) raised on cnc for a tile
+   polling the in_cnt in slots in.  poll_map currently has poll_cnt
+   entries (each attached in appears weight times, weight in
+   [1,weight_max]) and has room for in_cnt*weight_max entries.  Returns
+   the updated poll_cnt.  On failure, logs details, leaves in and
+   poll_map unchanged and sets the command's in_idx argument to
+   ULONG_MAX to let the command issuer know.  Meant to be called by the
+   tile from its housekeeping.
+
+   On attach, the in is added to the polling sequence with the given
+   weight.  Its new entries are swapped into random positions such that
+   they are spread over the polling cycle.  If the command does not give
+   an mcache, polling resumes from the tile's current position in the
+   in's sequence space (i.e. where the tile left off when the in was
+   detached or, for an in that was detached at boot, where the in's
+   producer was at boot).  Since the tile continued to return flow
+   control credits for the in only up to this position while detached,
+   no frags published by the in while detached are lost (a producer
+   that kept running will have been backpressured).
+
+   If the command gives an mcache and fseq, the slot (which must be
+   detached) is first rebound to them.  The depth of the new mcache must
+   be at least the tile's cr_max.  Polling starts from the position
+   advertised in the new fseq if the producer is at most one mcache
+   depth ahead of it (such that frags a producer flow controlled by the
+   fseq published before the attach are not lost) and from the
+   producer's current position otherwise.  The slot's previous in, if
+   any, is returned the credits the tile can prove are safe to return
+   given exposed_cnt (see fd_disco_in_update) and its diagnostics are
+   drained.  It will not be returned any credits after that so its
+   producer should be halted (and its frags consumed downstream) before
+   its slot is rebound.  The tile does not leave the joins it replaces
+   (joins given at boot are owned by the tile's caller and joins made on
+   attach are plain local joins).
+
+   On detach, all entries for the in are removed from the polling
+   sequence.  The in still gets its usual housekeeping events such that
+   credits for its frags exposed downstream are still returned to it as
+   the outs make progress. */
+
+ulong
+fd_disco_in_cmd_handle( fd_cnc_t *      cnc,
+                        int             attach,
+                        fd_disco_in_t * in,
+                        ulong           in_cnt,
+                        ulong           weight_max,
+                        ulong           cr_max,
+                        ulong           exposed_cnt,
+                        ushort *        poll_map,
+                        ulong           poll_cnt,
+                        fd_rng_t *      rng );
+
+/* fd_disco_in_cmd issues a FD_DISCO_CNC_SIGNAL_{ATTACH,DETACH} command
+   (given by signal) for in slot in_idx to the running tile that uses
+   cnc for its command and control and waits up to timeout ns for the
+   tile to handle it.  weight, mcache_gaddr and fseq_gaddr are the
+   attach arguments (ignored for detach, see above).  Returns 0 on
+   success and non-zero on failure (a command session could not be
+   opened or the tile did not handle the command in time, logs details,
+   or the tile rejected the command, the tile logs details). */
+
+int
+fd_disco_in_cmd( fd_cnc_t * cnc,
+                 ulong      signal,
+                 ulong      in_idx,
+                 ulong      weight,
+                 ulong      mcache_gaddr,
+                 ulong      fseq_gaddr,
+                 long       timeout );
+
+#endif
+
+FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_disco_fd_disco_base_h */
 
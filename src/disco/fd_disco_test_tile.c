@@ -0,0 +1,608 @@
+/* Do not compile this directly.  These are the synthetic traffic tiles
+   shared by the disco tile unit tests.  A unit test includes this after
+   fd_disco.h, wires a tx tile into the tile under test (and, if the
+   tile under test produces a stream, wires that into one or more rx
+   tiles) and then boots / halts the whole pipeline with
+   test_tiles_boot / test_tiles_halt.  Tests only use what they need so
+   everything here is FD_FN_UNUSED.
+
+   The tx uses the same methodology as test_frag_tx.c to inject test
+   traffic.  See test_frag_tx.c for more details.  The sig of each frag
+   is a hash of the frag's position in the tx stream (starting from 1)
+   and the payload is filled with the sig (repeated little endian) such
+   that rxs and captures can validate order and payload integrity.  The
+   tx is flow controlled on a single fseq.
+
+   The rx uses the same methodology as test_frag_rx.c to process the
+   stream produced by the tile under test.  It validates the frags are
+   received in tx stream order (but with gaps allowed, e.g. for load
+   balancers) with uncorrupted payloads. */
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+#include <math.h> /* For expm1f */
+
+/* TX tile ************************************************************/
+
+struct test_tx {
+  fd_wksp_t * wksp;            /* Wksp holding the objects below */
+  long        lazy;            /* Housekeeping interval in ns, 0 for a reasonable default */
+  ulong       pkt_framing;     /* Synthetic load model, see test_frag_tx.c */
+  ulong       pkt_payload_max;
+  float       burst_tau;
+  float       burst_avg;
+  uchar *     cnc_mem;         /* app-sz 64, type 0 */
+  uchar *     rng_mem;
+  uchar *     fseq_mem;        /* Flow control for the tx's consumer */
+  uchar *     mcache_mem;
+  uchar *     dcache_mem;
+  uchar *     fctl_mem;
+};
+
+typedef struct test_tx test_tx_t;
+
+/* test_tx_new validates the synthetic load configuration and creates
+   the tx's objects in wksp.  The frag stream and the tx fseq start at
+   seq0.  Logs details and terminates the test on failure. */
+
+FD_FN_UNUSED static test_tx_t *
+test_tx_new( test_tx_t * tx,
+             fd_wksp_t * wksp,
+             ulong       depth,
+             ulong       mtu,
+             long        lazy,
+             ulong       pkt_framing,
+             ulong       pkt_payload_max,
+             float       burst_avg,
+             float       pkt_bw,
+             uint        seed,
+             ulong       seq0,
+             long        now ) {
+
+  FD_LOG_NOTICE(( "Configuring synthetic load (--burst-avg %g B --pkt-framing %lu B --pkt-payload-max %lu B --pkt-bw %g b/s)",
+                  (double)burst_avg, pkt_framing, pkt_payload_max, (double)pkt_bw ));
+
+  if( FD_UNLIKELY( !((0.f<burst_avg) & (burst_avg<2.1e17f)) ) ) FD_LOG_ERR(( "--burst-avg out of range" ));
+
+  if( FD_UNLIKELY( !pkt_payload_max ) ) FD_LOG_ERR(( "Zero --pkt-payload-max" ));
+
+  ulong pkt_max = pkt_framing + pkt_payload_max;
+  if( FD_UNLIKELY( (pkt_max<pkt_framing) | (pkt_max>(ulong)USHORT_MAX) ) )
+    FD_LOG_ERR(( "Too large --pkt-framing + --pkt-payload-max" ));
+  if( FD_UNLIKELY( pkt_max>mtu ) ) FD_LOG_ERR(( "--tx-mtu too small for pkt_max" ));
+
+  if( FD_UNLIKELY( !(0.f<pkt_bw) ) ) FD_LOG_ERR(( "--pkt-bw out of range" ));
+
+  float burst_bw = pkt_bw
+                 / (1.f - ((((float)pkt_framing)/((float)burst_avg)) / expm1f( -((float)pkt_payload_max)/((float)burst_avg) )));
+
+  float tick_per_ns = (float)fd_tempo_tick_per_ns( NULL );
+  float burst_tau   = (tick_per_ns*burst_avg)*(8e9f/burst_bw); /* Avg time btw bursts in tick (8 b/B, 1e9 ns/s, bw b/s) */
+  if( FD_UNLIKELY( !(burst_tau<2.1e17f) ) ) FD_LOG_ERR(( "--pkt-bw out of range" ));
+
+  FD_LOG_NOTICE(( "Creating tx (--tx-depth %lu, --tx-mtu %lu, tx-burst 1, tx-compact 1, app-sz 0)", depth, mtu ));
+
+  ulong data_sz = fd_dcache_req_data_sz( mtu, depth, 1UL, 1 ); FD_TEST( data_sz );
+
+  tx->wksp            = wksp;
+  tx->lazy            = lazy;
+  tx->pkt_framing     = pkt_framing;
+  tx->pkt_payload_max = pkt_payload_max;
+  tx->burst_tau       = burst_tau;
+  tx->burst_avg       = burst_avg;
+
+  tx->cnc_mem    = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(),    fd_cnc_footprint( 64UL )          );
+  tx->rng_mem    = (uchar *)fd_wksp_alloc_laddr( wksp, 128UL,             fd_rng_footprint()                );
+  tx->fseq_mem   = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(),   fd_fseq_footprint()               );
+  tx->mcache_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), fd_mcache_footprint( depth, 0UL ) );
+  tx->dcache_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ) );
+  tx->fctl_mem   = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fctl_align(),   fd_fctl_footprint( 1UL )          );
+  FD_TEST( tx->cnc_mem ); FD_TEST( tx->rng_mem    ); FD_TEST( tx->fseq_mem );
+  FD_TEST( tx->mcache_mem ); FD_TEST( tx->dcache_mem ); FD_TEST( tx->fctl_mem );
+
+  FD_TEST( fd_cnc_new   ( tx->cnc_mem,    64UL, 0UL, now   ) );
+  FD_TEST( fd_rng_new   ( tx->rng_mem,    seed, 0UL        ) );
+  FD_TEST( fd_fseq_new  ( tx->fseq_mem,   seq0             ) );
+  FD_TEST( fd_mcache_new( tx->mcache_mem, depth, 0UL, seq0 ) );
+  FD_TEST( fd_dcache_new( tx->dcache_mem, data_sz, 0UL     ) );
+  FD_TEST( fd_fctl_new  ( tx->fctl_mem,   1UL              ) );
+
+  return tx;
+}
+
+FD_FN_UNUSED static void
+test_tx_delete( test_tx_t * tx ) {
+  FD_TEST( fd_fctl_delete  ( tx->fctl_mem   ) );
+  FD_TEST( fd_dcache_delete( tx->dcache_mem ) );
+  FD_TEST( fd_mcache_delete( tx->mcache_mem ) );
+  FD_TEST( fd_fseq_delete  ( tx->fseq_mem   ) );
+  FD_TEST( fd_rng_delete   ( tx->rng_mem    ) );
+  FD_TEST( fd_cnc_delete   ( tx->cnc_mem    ) );
+
+  fd_wksp_free_laddr( tx->fctl_mem   );
+  fd_wksp_free_laddr( tx->dcache_mem );
+  fd_wksp_free_laddr( tx->mcache_mem );
+  fd_wksp_free_laddr( tx->fseq_mem   );
+  fd_wksp_free_laddr( tx->rng_mem    );
+  fd_wksp_free_laddr( tx->cnc_mem    );
+}
+
+/* test_tx_tile_main is a fd_tile_task_t.  argv is the test_tx_t. */
+
+FD_FN_UNUSED static int
+test_tx_tile_main( int     argc,
+                   char ** argv ) {
+  (void)argc;
+  test_tx_t * cfg  = (test_tx_t *)argv;
+  fd_wksp_t * wksp = cfg->wksp;
+
+  /* Hook up to tx command-and-control */
+  fd_cnc_t * cnc      = fd_cnc_join( cfg->cnc_mem );
+  ulong *    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  int        in_backp = 1;
+
+  FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_IN_BACKP  ] ) = 1UL;
+  FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) = 0UL;
+
+  /* Hook up to the tx mcache */
+  fd_frag_meta_t * mcache = fd_mcache_join( cfg->mcache_mem );
+  ulong            depth  = fd_mcache_depth( mcache );
+  ulong *          sync   = fd_mcache_seq_laddr( mcache );
+  ulong            seq    = fd_mcache_seq_query( sync );
+
+  /* Hook up to the tx dcache */
+  uchar * dcache = fd_dcache_join( cfg->dcache_mem );
+  ulong   chunk0 = fd_dcache_compact_chunk0( wksp, dcache );
+  ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, cfg->pkt_framing + cfg->pkt_payload_max );
+  ulong   chunk  = chunk0;
+
+  /* Hook up to the tx flow control inputs */
+  ulong * fseq      = fd_fseq_join( cfg->fseq_mem );
+  ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
+
+  FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
+
+  /* Hook up to the tx flow control state */
+  fd_fctl_t * fctl = fd_fctl_join( cfg->fctl_mem );
+  fd_fctl_cfg_rx_add( fctl, depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] );
+  fd_fctl_cfg_done( fctl, 1UL, 0UL, 0UL, 0UL );
+  ulong cr_avail = 0UL;
+
+  /* Hook up to the random number generator */
+  fd_rng_t * rng = fd_rng_join( cfg->rng_mem );
+
+  /* Configure housekeeping */
+  float tick_per_ns = (float)fd_tempo_tick_per_ns( NULL );
+  ulong async_min   = fd_tempo_async_min( cfg->lazy ? cfg->lazy : fd_tempo_lazy_default( depth ),
+                                          1UL /*event_cnt*/, tick_per_ns );
+  if( FD_UNLIKELY( !async_min ) ) FD_LOG_ERR(( "bad --tx-lazy" ));
+
+  long  now  = fd_tickcount();
+  long  then = now;            /* Do housekeeping on first iteration of run loop */
+
+  long  diag_interval = (long)(1e9f*tick_per_ns);
+  long  diag_last     = now;
+  ulong diag_iter     = 0UL;
+
+  /* Configure the synthetic load model */
+  ulong pkt_framing     = cfg->pkt_framing;
+  ulong pkt_payload_max = cfg->pkt_payload_max;
+  float burst_tau       = cfg->burst_tau;
+  float burst_avg       = cfg->burst_avg;
+
+  int   ctl_som    = 1;
+  ulong burst_ts   = 0UL;  /* Irrelevant value at init */
+  long  burst_next = then;
+  ulong burst_rem;
+  do {
+    burst_next +=        (long)(0.5f + burst_tau*fd_rng_float_exp( rng ));
+    burst_rem   = (ulong)(long)(0.5f + burst_avg*fd_rng_float_exp( rng ));
+  } while( FD_UNLIKELY( !burst_rem ) );
+
+  ulong tx_seq = 1UL; /* Position in tx stream (the sig of frag tx_seq is fd_ulong_hash( tx_seq )) */
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Send synchronization info */
+      fd_mcache_seq_update( sync, seq );
+
+      /* Send diagnostic info */
+      fd_cnc_heartbeat( cnc, now );
+
+      long dt = now - diag_last;
+      if( FD_UNLIKELY( dt>=diag_interval ) ) {
+        float mfps = ((1e3f*tick_per_ns)*(float)diag_iter) / (float)dt;
+        FD_LOG_NOTICE(( "%7.3f Mfrag/s tx (in_backp %lu backp_cnt %lu slow_cnt %lu)", (double)mfps,
+                        FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_IN_BACKP  ] ),
+                        FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ),
+                        fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ));
+        FD_VOLATILE( cnc_diag [ FD_CNC_DIAG_BACKP_CNT ] ) = 0UL;
+        FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
+        diag_last = now;
+        diag_iter = 0UL;
+      }
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_HALT ) ) FD_LOG_ERR(( "Unexpected signal" ));
+        break;
+      }
+
+      /* Receive flow control credits */
+      cr_avail = fd_fctl_tx_cr_update( fctl, cr_avail, seq );
+      if( FD_UNLIKELY( in_backp ) ) {
+        if( FD_LIKELY( cr_avail ) ) {
+          FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_IN_BACKP ] ) = 0UL;
+          in_backp = 0;
+        }
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured */
+    if( FD_UNLIKELY( !cr_avail ) ) {
+      if( FD_UNLIKELY( !in_backp ) ) {
+        FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_IN_BACKP  ] ) = 1UL;
+        FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) + 1UL;
+        in_backp = 1;
+      }
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Check if we are waiting for the next burst to start */
+
+    if( FD_LIKELY( ctl_som ) ) {
+      if( FD_UNLIKELY( now<burst_next ) ) { /* Optimize for burst starting */
+        FD_SPIN_PAUSE();
+        now = fd_tickcount();
+        continue;
+      }
+      burst_ts = fd_frag_meta_ts_comp( burst_next );
+    }
+
+    /* Compute the details of the synthetic fragment and fill the data
+       region with a suitable test pattern as fast as we can. */
+
+    ulong frag_sz = fd_ulong_min( burst_rem, pkt_payload_max );
+    burst_rem -= frag_sz;
+
+    int ctl_eom = !burst_rem;
+    int ctl_err = 0;
+
+    ulong sig    = fd_ulong_hash( tx_seq );
+    ulong sz     = pkt_framing + frag_sz;
+    ulong ctl    = fd_frag_meta_ctl( 0UL, ctl_som, ctl_eom, ctl_err );
+    ulong tsorig = burst_ts;
+
+    uchar * p   = (uchar *)fd_chunk_to_laddr( wksp, chunk );
+    __m256i avx = _mm256_set1_epi64x( (long)sig );
+    for( ulong off=0UL; off<sz; off+=128UL ) {
+      _mm256_store_si256( (__m256i *)(p     ), avx );
+      _mm256_store_si256( (__m256i *)(p+32UL), avx );
+      _mm256_store_si256( (__m256i *)(p+64UL), avx );
+      _mm256_store_si256( (__m256i *)(p+96UL), avx );
+      p += 128UL;
+    }
+
+    now = fd_tickcount();
+    ulong tspub = fd_frag_meta_ts_comp( now );
+    fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+
+    /* Wind up for the next iteration */
+
+    chunk  = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+    seq    = fd_seq_inc( seq, 1UL );
+    tx_seq++;
+    cr_avail--;
+    if( FD_UNLIKELY( !ctl_eom ) ) ctl_som = 0;
+    else {
+      ctl_som = 1;
+      do {
+        burst_next +=        (long)(0.5f + burst_tau*fd_rng_float_exp( rng ));
+        burst_rem   = (ulong)(long)(0.5f + burst_avg*fd_rng_float_exp( rng ));
+      } while( FD_UNLIKELY( !burst_rem ) );
+    }
+    diag_iter++;
+  }
+
+  fd_rng_leave   ( rng    );
+  fd_fctl_leave  ( fctl   );
+  fd_fseq_leave  ( fseq   );
+  fd_dcache_leave( dcache );
+  fd_mcache_leave( mcache );
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* RX tile ************************************************************/
+
+/* test_rx_sig_ok_t is an optional per-test check that a frag with the
+   given sig should have been routed to rx rx_idx of rx_cnt. */
+
+typedef int (*test_rx_sig_ok_t)( ulong sig, ulong rx_idx, ulong rx_cnt );
+
+struct test_rx {
+  fd_wksp_t *      wksp;       /* Wksp holding the received payloads and the objects below */
+  ulong            idx;        /* Index of this rx, in [0,cnt) */
+  ulong            cnt;        /* Number of rxs */
+  int              lazy;       /* Housekeeping every ~2^lazy frags */
+  long             slow;       /* Spin this many ns per frag to model a slow worker */
+  test_rx_sig_ok_t sig_ok;     /* NULL if no routing check */
+  uchar const *    mcache_mem; /* Stream to receive */
+  uchar const *    dcache_mem; /* NULL if no payload location check */
+  uchar *          cnc_mem;    /* app-sz 64, type 2 */
+  uchar *          rng_mem;
+  uchar *          fseq_mem;   /* Flow control of this rx */
+};
+
+typedef struct test_rx test_rx_t;
+
+/* test_rx_new creates rx idx of cnt's objects in wksp.  The rx fseq
+   starts at seq0 (should match the seq0 of the stream in mcache_mem).
+   Logs details and terminates the test on failure. */
+
+FD_FN_UNUSED static test_rx_t *
+test_rx_new( test_rx_t *      rx,
+             fd_wksp_t *      wksp,
+             ulong            idx,
+             ulong            cnt,
+             uchar const *    mcache_mem,
+             uchar const *    dcache_mem,
+             int              lazy,
+             long             slow,
+             test_rx_sig_ok_t sig_ok,
+             uint             seed,
+             ulong            seq0,
+             long             now ) {
+  if( FD_UNLIKELY( slow<0L ) ) FD_LOG_ERR(( "--rx-slow should be non-negative" ));
+
+  rx->wksp       = wksp;
+  rx->idx        = idx;
+  rx->cnt        = cnt;
+  rx->lazy       = lazy;
+  rx->slow       = slow;
+  rx->sig_ok     = sig_ok;
+  rx->mcache_mem = mcache_mem;
+  rx->dcache_mem = dcache_mem;
+
+  rx->cnc_mem  = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(),  fd_cnc_footprint( 64UL ) );
+  rx->rng_mem  = (uchar *)fd_wksp_alloc_laddr( wksp, 128UL,           fd_rng_footprint()       );
+  rx->fseq_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fd_fseq_footprint()      );
+  FD_TEST( rx->cnc_mem ); FD_TEST( rx->rng_mem ); FD_TEST( rx->fseq_mem );
+
+  FD_TEST( fd_cnc_new ( rx->cnc_mem,  64UL, 2UL, now ) );
+  FD_TEST( fd_rng_new ( rx->rng_mem,  seed, 0UL      ) );
+  FD_TEST( fd_fseq_new( rx->fseq_mem, seq0           ) );
+
+  return rx;
+}
+
+FD_FN_UNUSED static void
+test_rx_delete( test_rx_t * rx ) {
+  FD_TEST( fd_fseq_delete( rx->fseq_mem ) );
+  FD_TEST( fd_rng_delete ( rx->rng_mem  ) );
+  FD_TEST( fd_cnc_delete ( rx->cnc_mem  ) );
+
+  fd_wksp_free_laddr( rx->fseq_mem );
+  fd_wksp_free_laddr( rx->rng_mem  );
+  fd_wksp_free_laddr( rx->cnc_mem  );
+}
+
+/* test_rx_tile_main is a fd_tile_task_t.  argv is the test_rx_t. */
+
+FD_FN_UNUSED static int
+test_rx_tile_main( int     argc,
+                   char ** argv ) {
+  (void)argc;
+  test_rx_t * cfg    = (test_rx_t *)argv;
+  fd_wksp_t * wksp   = cfg->wksp;
+  ulong       rx_idx = cfg->idx;
+
+  /* Hook up to rx cnc */
+  fd_cnc_t * cnc = fd_cnc_join( cfg->cnc_mem );
+
+  /* Hook up to the stream to receive */
+  fd_frag_meta_t const * mcache = fd_mcache_join( (void *)cfg->mcache_mem );
+  ulong                  depth  = fd_mcache_depth( mcache );
+  ulong const *          sync   = fd_mcache_seq_laddr_const( mcache );
+  ulong                  seq    = fd_mcache_seq_query( sync );
+
+  uchar const * dcache = cfg->dcache_mem ? (uchar const *)fd_dcache_join( (void *)cfg->dcache_mem ) : NULL;
+  ulong         chunk0 = dcache ? fd_dcache_compact_chunk0( wksp, dcache ) : 0UL;
+  ulong         chunk1 = dcache ? fd_dcache_compact_chunk1( wksp, dcache ) : ULONG_MAX;
+
+  /* Hook up to rx flow control */
+  ulong * fseq = fd_fseq_join( cfg->fseq_mem );
+
+  /* Hook up to the random number generator */
+  fd_rng_t * rng = fd_rng_join( cfg->rng_mem );
+
+  /* Configure the load model */
+  long slow = (long)((double)cfg->slow*fd_tempo_tick_per_ns( NULL ));
+
+  /* Configure housekeeping */
+  ulong async_min = 1UL << cfg->lazy;
+  ulong async_rem = 1UL; /* Do housekeeping on first iteration */
+
+  long  then = fd_log_wallclock();
+  ulong iter = 0UL;
+
+  ulong tx_seq_last = 0UL; /* tx stream position of the last frag received */
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  for(;;) {
+
+    /* Wait for frag seq while doing housekeeping in the background */
+
+    fd_frag_meta_t const * mline;
+    ulong                  seq_found;
+    long                   diff;
+
+    ulong sig;
+    ulong chunk;
+    ulong sz;
+    ulong ctl;
+    ulong tsorig;
+    ulong tspub;
+    FD_MCACHE_WAIT_REG( sig, chunk, sz, ctl, tsorig, tspub, mline, seq_found, diff, async_rem, mcache, depth, seq );
+    if( FD_UNLIKELY( !async_rem ) ) {
+
+      /* Send flow control credits */
+      fd_fctl_rx_cr_return( fseq, seq );
+
+      /* Send diagnostic info */
+      long now = fd_log_wallclock();
+      fd_cnc_heartbeat( cnc, now );
+
+      long dt = now - then;
+      if( FD_UNLIKELY( dt > (long)1e9 ) ) {
+        float mfps = (1e3f*(float)iter) / (float)dt;
+        FD_LOG_NOTICE(( "%7.3f Mfrag/s rx %lu", (double)mfps, rx_idx ));
+        then = now;
+        iter = 0UL;
+      }
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_HALT ) ) FD_LOG_ERR(( "Unexpected signal" ));
+        break;
+      }
+
+      /* Reload housekeeping timer */
+      async_rem = fd_tempo_async_reload( rng, async_min );
+      FD_YIELD();
+      continue;
+    }
+
+    if( FD_UNLIKELY( diff ) ) FD_LOG_ERR(( "Overrun while polling" ));
+
+    /* Process the received fragment */
+
+    ulong tx_seq = fd_ulong_hash_inverse( sig );
+    if( FD_UNLIKELY( tx_seq<=tx_seq_last ) ) FD_LOG_ERR(( "Received a frag out of order" ));
+    tx_seq_last = tx_seq;
+    if( FD_UNLIKELY( cfg->sig_ok && !cfg->sig_ok( sig, rx_idx, cfg->cnt ) ) ) FD_LOG_ERR(( "Received a frag for another rx" ));
+    if( FD_UNLIKELY( !((chunk0<=chunk) & (chunk<chunk1)) ) ) FD_LOG_ERR(( "Received a frag outside the expected dcache" ));
+
+    (void)ctl; (void)tsorig; (void)tspub;
+
+    /* Model a slow worker (the payload must still be valid afterward
+       as the producer must not overrun frags still in use) */
+    if( FD_UNLIKELY( slow ) ) {
+      long done = fd_tickcount() + slow;
+      while( fd_tickcount()<done ) FD_SPIN_PAUSE();
+    }
+
+    /* Only the first sz bytes of the payload are validated (the tile
+       under test might not copy the full tx test pattern) */
+
+    uchar const * p    = (uchar const *)fd_chunk_to_laddr_const( wksp, chunk );
+    __m256i       avx  = _mm256_set1_epi64x( (long)sig );
+    int           mask = -1;
+    ulong         off  = 0UL;
+    for( ; (off+32UL)<=sz; off+=32UL )
+      mask &= _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_load_si256( (__m256i const *)(p+off) ), avx ) );
+    int corrupt = (mask!=-1);
+    for( ; off<sz; off++ ) corrupt |= (p[ off ]!=(uchar)(sig >> (8UL*(off & 7UL))));
+
+    /* Check that we weren't overrun while processing */
+    seq_found = fd_frag_meta_seq_query( mline );
+    if( FD_UNLIKELY( fd_seq_ne( seq_found, seq ) ) ) FD_LOG_ERR(( "Overrun while reading" ));
+
+    /* Validate that the frag payload was as expected */
+    if( FD_UNLIKELY( corrupt ) ) FD_LOG_ERR(( "Corrupt payload received" ));
+
+    /* Wind up for the next iteration */
+
+    seq = fd_seq_inc( seq, 1UL );
+    iter++;
+  }
+
+  fd_rng_leave ( rng  );
+  fd_fseq_leave( fseq );
+  if( dcache ) fd_dcache_leave( dcache );
+  fd_mcache_leave( mcache );
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* Pipeline ***********************************************************/
+
+/* A test_tile_t describes a tile of the pipeline.  task is run on its
+   own tile with argc 0 and argv arg.  cnc_mem is the tile's cnc. */
+
+struct test_tile {
+  fd_tile_task_t task;
+  void *         arg;
+  uchar *        cnc_mem;
+  fd_cnc_t *     cnc;      /* Valid between test_tiles_boot and test_tiles_halt */
+};
+
+typedef struct test_tile test_tile_t;
+
+/* test_tiles_boot starts tile[i] on tile index i+1 for i in
+   [0,tile_cnt).  Tiles are started in reverse order such that, if the
+   pipeline is listed from producers to consumers, consumers are up
+   before their producers.  Returns once all tiles signal RUN. */
+
+FD_FN_UNUSED static void
+test_tiles_boot( test_tile_t * tile,
+                 ulong         tile_cnt ) {
+  FD_LOG_NOTICE(( "Booting" ));
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+    tile[ tile_idx ].cnc = fd_cnc_join( tile[ tile_idx ].cnc_mem );
+    FD_TEST( tile[ tile_idx ].cnc );
+  }
+
+  for( ulong tile_idx=tile_cnt; tile_idx; tile_idx-- )
+    FD_TEST( fd_tile_exec_new( tile_idx, tile[ tile_idx-1UL ].task, 0, (char **)tile[ tile_idx-1UL ].arg ) );
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ )
+    FD_TEST( fd_cnc_wait( tile[ tile_idx ].cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+}
+
+/* test_tiles_halt halts all the tiles booted by test_tiles_boot and
+   waits for them to finish.  Each tile's cnc diagnostics are still
+   readable afterward from its cnc_mem. */
+
+FD_FN_UNUSED static void
+test_tiles_halt( test_tile_t * tile,
+                 ulong         tile_cnt ) {
+  FD_LOG_NOTICE(( "Halting" ));
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+    FD_TEST( !fd_cnc_open( tile[ tile_idx ].cnc ) );
+    fd_cnc_signal( tile[ tile_idx ].cnc, FD_CNC_SIGNAL_HALT );
+    fd_cnc_close( tile[ tile_idx ].cnc );
+  }
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ )
+    FD_TEST( fd_cnc_wait( tile[ tile_idx ].cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+    int ret;
+    FD_TEST( !fd_tile_exec_delete( fd_tile_exec( tile_idx+1UL ), &ret ) );
+    FD_TEST( !ret );
+  }
+
+  for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+    FD_TEST( fd_cnc_leave( tile[ tile_idx ].cnc ) );
+    tile[ tile_idx ].cnc = NULL;
+  }
+}
+
+#endif /* FD_HAS_HOSTED && FD_HAS_AVX */
@@ -0,0 +1,4 @@
+$(call add-hdrs,fd_lb.h)
+$(call add-objs,fd_lb,fd_disco)
+$(call make-unit-test,test_lb,test_lb,fd_disco fd_tango fd_util)
+$(call make-bin,fd_lb_tile,fd_lb_tile,fd_disco fd_tango fd_util)
@@ -0,0 +1,466 @@
+#include "fd_lb.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* A fd_lb_tile_out has all the state needed for forwarding frags to an
+   out.  It fits on exactly one cache line. */
+
+struct __attribute__((aligned(64))) fd_lb_tile_out {
+  fd_frag_meta_t * mcache;   /* local join to this out's mcache */
+  ulong            depth;    /* == fd_mcache_depth( mcache ), depth of this out's mcache (const) */
+  ulong            seq;      /* next sequence number to publish to this out */
+  ulong *          fseq;     /* local join to the fseq used to receive flow control credits from this out */
+  ulong            fseq_obs; /* most recent observation of *fseq (out frags [fseq_obs,seq) are potentially exposed) */
+  ulong            cr_avail; /* number of flow control credits available to publish to this out, in [0,cr_max] */
+  ulong *          in_seq;   /* in_seq[ out_seq & (in_depth-1) ] is the in sequence number of out frag out_seq,
+                                indexed [0,in_depth) */
+};
+
+typedef struct fd_lb_tile_out fd_lb_tile_out_t;
+
+/* fd_lb_tile_out_update receives flow control credits from the out and
+   returns the number of credits available.  Credits are computed
+   exactly from the observed fseq (and then clamped to [0,cr_max] to be
+   robust against misbehaving consumers). */
+
+static inline ulong
+fd_lb_tile_out_update( fd_lb_tile_out_t * out,
+                       ulong              cr_max ) {
+  ulong fseq_obs = fd_fseq_query( out->fseq );
+  long  lag      = fd_long_max( fd_seq_diff( out->seq, fseq_obs ), 0L );
+  ulong cr_avail = (ulong)fd_long_max( (long)cr_max - lag, 0L );
+  out->fseq_obs  = fd_seq_dec( out->seq, (ulong)lag );
+  out->cr_avail  = cr_avail;
+  return cr_avail;
+}
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+FD_STATIC_ASSERT( alignof(fd_lb_tile_out_t)<=FD_LB_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( sizeof (fd_lb_tile_out_t)==64UL,                     packing );
+
+ulong
+fd_lb_tile_scratch_align( void ) {
+  return FD_LB_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_lb_tile_scratch_footprint( ulong in_depth,
+                              ulong out_cnt ) {
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( in_depth )      ) ) return 0UL;
+  if( FD_UNLIKELY( in_depth>FD_LB_TILE_IN_DEPTH_MAX   ) ) return 0UL;
+  if( FD_UNLIKELY( out_cnt >FD_LB_TILE_OUT_MAX        ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( alignof(fd_lb_tile_out_t), out_cnt*sizeof(fd_lb_tile_out_t) ); /* out */
+  SCRATCH_ALLOC( alignof(ulong),            out_cnt*in_depth*sizeof(ulong)   ); /* out in_seq */
+  SCRATCH_ALLOC( alignof(ushort),           (out_cnt+2UL)*sizeof(ushort)     ); /* event_map */
+  return fd_ulong_align_up( scratch_top, fd_lb_tile_scratch_align() );
+}
+
+int
+fd_lb_tile( fd_cnc_t *              cnc,
+            fd_frag_meta_t const *  in_mcache,
+            ulong *                 in_fseq,
+            ulong                   out_cnt,
+            fd_frag_meta_t **       out_mcache,
+            ulong **                out_fseq,
+            int                     policy,
+            ulong                   cr_max,
+            long                    lazy,
+            fd_rng_t *              rng,
+            void *                  scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the lb tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+
+  /* in frag stream state */
+  ulong                  in_depth; /* ==fd_mcache_depth( in_mcache ), depth of the in's mcache */
+  ulong                  in_seq;   /* sequence number of next frag expected from the in */
+  fd_frag_meta_t const * in_mline; /* ==in_mcache + fd_mcache_line_idx( in_seq, in_depth ), location to poll next */
+  uint                   in_accum[6]; /* local diagnostic accumulators, drained during in housekeeping */
+                                      /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+
+  /* out frag stream and flow control state */
+  fd_lb_tile_out_t * out;    /* out[out_idx] for out_idx in [0,out_cnt) has information about out out_idx */
+  ulong              out_rr; /* next out to consider first when picking an out, in [0,out_cnt) */
+
+  /* housekeeping state */
+  ulong    event_cnt; /* ==out_cnt+2, total number of housekeeping events */
+  ulong    event_seq; /* current position in housekeeping event sequence, in [0,event_cnt) */
+  ushort * event_map; /* current mapping of event_seq to event idx, event_map[ event_seq ] is next event to process */
+  ulong    async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting lb (out-cnt %lu, policy %i)", out_cnt, policy ));
+    if( FD_UNLIKELY( !out_cnt                   ) ) { FD_LOG_WARNING(( "out_cnt must be positive" )); return 1; }
+    if( FD_UNLIKELY( out_cnt>FD_LB_TILE_OUT_MAX ) ) { FD_LOG_WARNING(( "out_cnt too large"        )); return 1; }
+    if( FD_UNLIKELY( !((policy==FD_LB_POLICY_RR) | (policy==FD_LB_POLICY_CR) | (policy==FD_LB_POLICY_SIG)) ) ) {
+      FD_LOG_WARNING(( "unsupported policy" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_lb_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<16UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 16" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,  1U },
+      { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
+       cleared during first run loop iteration if credits available */
+    cnc_diag_in_backp  = 1UL;
+    cnc_diag_backp_cnt = 0UL;
+
+    /* in frag stream init */
+
+    if( FD_UNLIKELY( !in_mcache ) ) { FD_LOG_WARNING(( "NULL in_mcache" )); return 1; }
+    if( FD_UNLIKELY( !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
+
+    in_depth = fd_mcache_depth( in_mcache );
+    if( FD_UNLIKELY( in_depth>FD_LB_TILE_IN_DEPTH_MAX ) ) { FD_LOG_WARNING(( "in_mcache depth too large" )); return 1; }
+    in_seq   = fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache ) ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    in_accum[0] = 0U; in_accum[1] = 0U; in_accum[2] = 0U;
+    in_accum[3] = 0U; in_accum[4] = 0U; in_accum[5] = 0U;
+
+    /* out frag stream init */
+
+    out    = (fd_lb_tile_out_t *)SCRATCH_ALLOC( alignof(fd_lb_tile_out_t), out_cnt*sizeof(fd_lb_tile_out_t) );
+    out_rr = 0UL;
+
+    ulong * out_in_seq = (ulong *)SCRATCH_ALLOC( alignof(ulong), out_cnt*in_depth*sizeof(ulong) );
+
+    ulong min_out_depth = (ulong)LONG_MAX;
+
+    if( FD_UNLIKELY( !out_mcache ) ) { FD_LOG_WARNING(( "NULL out_mcache" )); return 1; }
+    if( FD_UNLIKELY( !out_fseq   ) ) { FD_LOG_WARNING(( "NULL out_fseq"   )); return 1; }
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+      if( FD_UNLIKELY( !out_mcache[ out_idx ] ) ) { FD_LOG_WARNING(( "NULL out_mcache[%lu]", out_idx )); return 1; }
+      if( FD_UNLIKELY( !out_fseq  [ out_idx ] ) ) { FD_LOG_WARNING(( "NULL out_fseq[%lu]",   out_idx )); return 1; }
+
+      fd_lb_tile_out_t * this_out = &out[ out_idx ];
+
+      this_out->mcache   = out_mcache[ out_idx ];
+      this_out->depth    = fd_mcache_depth( this_out->mcache ); min_out_depth = fd_ulong_min( min_out_depth, this_out->depth );
+      this_out->seq      = fd_mcache_seq_query( fd_mcache_seq_laddr( this_out->mcache ) ); /* FIXME: ALLOW MANUAL SPECIFICATION? */
+      this_out->fseq     = out_fseq[ out_idx ];
+      this_out->fseq_obs = this_out->seq;
+      this_out->cr_avail = 0UL; /* Will be initialized below */
+      this_out->in_seq   = out_in_seq + out_idx*in_depth;
+    }
+
+    /* out flow control init */
+
+    /* Every frag forwarded to an out consumes one of that out's credits
+       until the out's consumer reports it has been processed.  Since
+       the lb keeps track of the in sequence number of each exposed
+       frag, it can tell the in exactly up to where it can be overrun.
+       cr_max then must be at most the in depth (such that the in_seq
+       ring of an out cannot be overrun and such that a frag exposed to
+       an out cannot be from further back than the in can cache) and at
+       most the out depth (such that a consumer cannot be overrun). */
+
+    ulong cr_max_max = fd_ulong_min( in_depth, min_out_depth );
+    if( !cr_max ) cr_max = cr_max_max; /* use default */
+    FD_LOG_INFO(( "Using cr_max %lu", cr_max ));
+    if( FD_UNLIKELY( !((1UL<=cr_max) & (cr_max<=cr_max_max)) ) ) {
+      FD_LOG_WARNING(( "cr_max %lu must be in [1,%lu] for these mcaches", cr_max, cr_max_max ));
+      return 1;
+    }
+
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) fd_lb_tile_out_update( &out[ out_idx ], cr_max );
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( cr_max );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    /* Initialize the initial event sequence to do housekeeping first
+       and then update the in and the outs. */
+
+    event_cnt = out_cnt + 2UL;
+    event_map = (ushort *)SCRATCH_ALLOC( alignof(ushort), event_cnt*sizeof(ushort) );
+    event_seq = 0UL;                                     event_map[ event_seq++ ] = (ushort) out_cnt;
+    /**/                                                 event_map[ event_seq++ ] = (ushort)(out_cnt+1UL);
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) event_map[ event_seq++ ] = (ushort) out_idx;
+    event_seq = 0UL;
+
+    async_min = fd_tempo_async_min( lazy, event_cnt, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running lb" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+      ulong event_idx = (ulong)event_map[ event_seq ];
+
+      /* Do the next async event.  event_idx:
+            <out_cnt - receive credits from out event_idx
+           ==out_cnt - housekeeping
+           >out_cnt - send credits to in.
+         Branch hints and order are optimized for the case:
+           out_cnt >~ 1. */
+
+      if( FD_LIKELY( event_idx<out_cnt ) ) { /* out fctl for out out_idx */
+        fd_lb_tile_out_t * this_out = &out[ event_idx ];
+
+        /* Receive flow control credits from this out.  See notes below
+           about use of quasi-atomic diagnostic accum. */
+        if( FD_UNLIKELY( !fd_lb_tile_out_update( this_out, cr_max ) ) ) {
+          ulong * out_slow = (ulong *)fd_fseq_app_laddr( this_out->fseq ) + FD_FSEQ_DIAG_SLOW_CNT;
+          FD_COMPILER_MFENCE();
+          out_slow[0]++;
+          FD_COMPILER_MFENCE();
+        }
+
+      } else if( FD_LIKELY( event_idx>out_cnt ) ) { /* in fctl */
+
+        /* Send flow control credits and drain flow control diagnostics
+           for the in.  The oldest in frag that might still be in use
+           downstream is the oldest frag exposed to any out (the in
+           sequence number of the frag at each out's most recently
+           observed fseq).  If nothing is exposed, everything up to
+           in_seq has been consumed.  Like the mux, we only update the
+           in's fseq when it would advance. */
+
+        ulong seq = in_seq;
+        for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+          fd_lb_tile_out_t * this_out = &out[ out_idx ];
+          if( FD_LIKELY( fd_seq_ne( this_out->fseq_obs, this_out->seq ) ) ) {
+            ulong out_oldest = this_out->in_seq[ this_out->fseq_obs & (in_depth-1UL) ];
+            seq = fd_ulong_if( fd_seq_lt( out_oldest, seq ), out_oldest, seq );
+          }
+        }
+        if( FD_LIKELY( fd_seq_gt( seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, seq );
+
+        ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+        ulong a0 = (ulong)in_accum[0]; ulong a1 = (ulong)in_accum[1]; ulong a2 = (ulong)in_accum[2];
+        ulong a3 = (ulong)in_accum[3]; ulong a4 = (ulong)in_accum[4]; ulong a5 = (ulong)in_accum[5];
+        FD_COMPILER_MFENCE();
+        diag[0] += a0;                 diag[1] += a1;                 diag[2] += a2;
+        diag[3] += a3;                 diag[4] += a4;                 diag[5] += a5;
+        FD_COMPILER_MFENCE();
+        in_accum[0] = 0U;              in_accum[1] = 0U;              in_accum[2] = 0U;
+        in_accum[3] = 0U;              in_accum[4] = 0U;              in_accum[5] = 0U;
+
+      } else { /* event_idx==out_cnt, housekeeping event */
+
+        /* Send synchronization info */
+        for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ )
+          fd_mcache_seq_update( fd_mcache_seq_laddr( out[ out_idx ].mcache ), out[ out_idx ].seq );
+
+        /* Send diagnostic info */
+        /* When we drain, we don't do a fully atomic update of the
+           diagnostics as it is only diagnostic and it will still be
+           correct the usual case where individual diagnostic counters
+           aren't used by multiple writers spread over different threads
+           of execution. */
+        fd_cnc_heartbeat( cnc, now );
+        FD_COMPILER_MFENCE();
+        cnc_diag[ FD_CNC_DIAG_IN_BACKP  ]  = cnc_diag_in_backp;
+        cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] += cnc_diag_backp_cnt;
+        FD_COMPILER_MFENCE();
+        cnc_diag_backp_cnt = 0UL;
+
+        /* Receive command-and-control signals */
+        ulong s = fd_cnc_signal_query( cnc );
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+          if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+          if( FD_UNLIKELY( s!=FD_LB_CNC_SIGNAL_ACK ) ) {
+            char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+            FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+          }
+          fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+        }
+      }
+
+      /* Select which event to do next (randomized round robin) and
+         reload the housekeeping timer. */
+
+      event_seq++;
+      if( FD_UNLIKELY( event_seq>=event_cnt ) ) {
+        event_seq = 0UL;
+
+        /* Randomize the order of event processing for the next event
+           event_cnt events to avoid lighthousing effects causing out
+           credit starvation at extreme fan out and high credit return
+           laziness. */
+
+        ulong  swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)event_cnt );
+        ushort map_tmp        = event_map[ swap_idx ];
+        event_map[ swap_idx ] = event_map[ 0        ];
+        event_map[ 0        ] = map_tmp;
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if the in has a new fragment to forward */
+
+    FD_COMPILER_MFENCE();
+    ulong seq_found = in_mline->seq;
+    FD_COMPILER_MFENCE();
+
+    long diff = fd_seq_diff( in_seq, seq_found );
+    if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+      if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if in is honoring our flow control) */
+        in_seq   = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
+        in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+        in_accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+      }
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* We have a new fragment to forward.  Try to load it.  This attempt
+       should always be successful if the in producer is honoring our
+       flow control (see fd_mux_tile for more details). */
+
+    FD_COMPILER_MFENCE();
+    ulong sig      =        in_mline->sig;
+    ulong chunk    = (ulong)in_mline->chunk;
+    ulong sz       = (ulong)in_mline->sz;
+    ulong ctl      = (ulong)in_mline->ctl;
+    ulong tsorig   = (ulong)in_mline->tsorig;
+    FD_COMPILER_MFENCE();
+    ulong seq_test =        in_mline->seq;
+    FD_COMPILER_MFENCE();
+
+    if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading (impossible if in honoring our fctl) */
+      in_seq   = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
+      in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+      in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Pick the out for this frag.  If there is no suitable out with
+       credits available, we are backpressured.  Count any transition
+       into a backpressured regime and spin to wait for flow control
+       credits to return (without consuming the frag).  We don't do a
+       fully atomic update here as it is only diagnostic and it will
+       still be correct in the usual case where individual diagnostic
+       counters aren't used by writers in different threads of
+       execution.  We only count the transition from not backpressured
+       to backpressured. */
+
+    ulong out_idx;
+    if( policy==FD_LB_POLICY_SIG ) {
+      out_idx = fd_lb_sig_out_idx( sig, out_cnt );
+      out_idx = fd_ulong_if( !!out[ out_idx ].cr_avail, out_idx, ULONG_MAX );
+    } else {
+      /* Scan the outs starting from the round robin position.  For RR,
+         take the first out with credits.  For CR, take the out with the
+         most credits. */
+      ulong best_cr = 0UL;
+      out_idx = ULONG_MAX;
+      ulong idx = out_rr;
+      for( ulong rem=out_cnt; rem; rem-- ) {
+        ulong cr_avail = out[ idx ].cr_avail;
+        if( cr_avail>best_cr ) {
+          out_idx = idx;
+          best_cr = cr_avail;
+          if( policy==FD_LB_POLICY_RR ) break;
+        }
+        idx++;
+        if( idx>=out_cnt ) idx = 0UL; /* cmov */
+      }
+      /* RR resumes after the picked out, CR just rotates where ties
+         start being broken */
+      out_rr = ( policy==FD_LB_POLICY_RR && out_idx!=ULONG_MAX ) ? out_idx+1UL : out_rr+1UL;
+      if( out_rr>=out_cnt ) out_rr = 0UL; /* cmov */
+    }
+
+    if( FD_UNLIKELY( out_idx==ULONG_MAX ) ) {
+      cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
+      cnc_diag_in_backp   = 1UL;
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+    cnc_diag_in_backp = 0UL;
+
+    /* Forward the frag to the out and remember where it came from */
+
+    fd_lb_tile_out_t * this_out = &out[ out_idx ];
+    ulong this_out_seq = this_out->seq;
+    this_out->in_seq[ this_out_seq & (in_depth-1UL) ] = in_seq;
+
+    now = fd_tickcount();
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( now );
+    fd_mcache_publish( this_out->mcache, this_out->depth, this_out_seq, sig, chunk, sz, ctl, tsorig, tspub );
+    this_out->seq = fd_seq_inc( this_out_seq, 1UL );
+    this_out->cr_avail--;
+
+    /* Windup for the next in poll and accumulate diagnostics */
+
+    in_seq   = fd_seq_inc( in_seq, 1UL );
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    in_accum[ FD_FSEQ_DIAG_PUB_CNT ]++;
+    in_accum[ FD_FSEQ_DIAG_PUB_SZ  ] += (uint)sz;
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting lb" ));
+
+    /* Return all credits to the in (assumes all reliable consumers
+       caught up or shutdown) and drain the diagnostics */
+
+    if( FD_LIKELY( fd_seq_gt( in_seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, in_seq );
+    ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+    FD_COMPILER_MFENCE();
+    for( ulong diag_idx=0UL; diag_idx<6UL; diag_idx++ ) diag[ diag_idx ] += (ulong)in_accum[ diag_idx ];
+    FD_COMPILER_MFENCE();
+
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ )
+      fd_mcache_seq_update( fd_mcache_seq_laddr( out[ out_idx ].mcache ), out[ out_idx ].seq );
+
+    FD_LOG_INFO(( "Halted lb" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+
+#endif
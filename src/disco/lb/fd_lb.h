@@ -0,0 +1,195 @@
+#ifndef HEADER_fd_src_disco_lb_fd_lb_h
+#define HEADER_fd_src_disco_lb_fd_lb_h
+
+/* fd_lb provides services to load balance a single stream of input
+   fragments over multiple output streams (e.g. to fan out one ingress
+   stream over a pool of identical worker tiles).  It is the 1->N
+   counterpart of fd_mux.  The entire process is zero copy for the
+   actual fragment payloads and thus has extremely high throughput and
+   extremely high scalability. */
+
+#include "../fd_disco_base.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_LB_CNC_SIGNAL_ACK can be
+   raised by a cnc thread with an open command session while the lb is
+   in the RUN state.  The lb will transition from ACK->RUN the next time
+   it processes cnc signals to indicate it is running normally.  If a
+   signal other than ACK, HALT, or RUN is raised, it will be logged as
+   unexpected and transitioned by back to RUN. */
+
+#define FD_LB_CNC_SIGNAL_ACK (4UL)
+
+/* FD_LB_POLICY_* specify how a lb tile picks the out to which an in
+   frag is forwarded:
+
+     RR:  round robin over the outs that currently have flow control
+          credits available (an out that is backpressuring is skipped
+          such that a slow out does not stall the others).
+
+     CR:  the out with the fewest frags outstanding (i.e. the most flow
+          control credits available), ties broken round robin.  This
+          adapts to outs that process frags at different rates.
+
+     SIG: the out given by fd_lb_sig_out_idx( sig, out_cnt ).  All frags
+          with the same sig go to the same out (e.g. for affinity of
+          related frags or to keep duplicates on the same worker).  A
+          backpressuring out will backpressure the lb. */
+
+#define FD_LB_POLICY_RR  (0)
+#define FD_LB_POLICY_CR  (1)
+#define FD_LB_POLICY_SIG (2)
+
+/* FD_LB_TILE_OUT_MAX is the maximum number of outputs a lb tile can
+   have.  This limit is more or less arbitrary from a functional
+   correctness POV.  It mostly exists to set some practical upper bounds
+   for things like scratch footprint (and is set to match
+   FD_MUX_TILE_IN_MAX such that a lb's outs can be merged back by a
+   single mux).  FD_LB_TILE_IN_DEPTH_MAX is the maximum in_mcache depth
+   supported. */
+
+#define FD_LB_TILE_OUT_MAX      FD_FRAG_META_ORIG_MAX
+#define FD_LB_TILE_IN_DEPTH_MAX (1UL<<31)
+
+/* FD_LB_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for a lb tile scratch region that can support an
+   in_mcache with depth in_depth and out_cnt outputs.  ALIGN is an
+   integer power of 2 of at least double cache line to mitigate various
+   kinds of false sharing.  FOOTPRINT will be an integer multiple of
+   ALIGN.  in_depth and out_cnt are assumed to be valid (i.e. in_depth
+   is an integer power of 2 of at most FD_LB_TILE_IN_DEPTH_MAX and
+   out_cnt is at most FD_LB_TILE_OUT_MAX) and safe against multiple
+   evaluation.  These are provided to facilitate compile time
+   declarations. */
+
+#define FD_LB_TILE_SCRATCH_ALIGN (128UL)
+#define FD_LB_TILE_SCRATCH_FOOTPRINT( in_depth, out_cnt )              \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(                  \
+  FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                                    \
+    64UL,            (out_cnt)*64UL                        ),          \
+    alignof(ulong),  (out_cnt)*(in_depth)*sizeof(ulong)    ),          \
+    alignof(ushort), ((out_cnt)+2UL)*sizeof(ushort)        ),          \
+    FD_LB_TILE_SCRATCH_ALIGN )
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_lb_sig_out_idx returns the out to which a FD_LB_POLICY_SIG lb tile
+   with out_cnt outs forwards frags with signature sig.  out_cnt is
+   assumed in [1,FD_LB_TILE_OUT_MAX].  Result will be in [0,out_cnt).
+   The sig is hashed first such that the mapping is uniform even when
+   sigs are not and such that it is uncorrelated with the sig ranges
+   used by fd_dedup_shard_idx (so that a lb feeding workers feeding
+   dedup shards does not concentrate load on some shards). */
+
+FD_FN_CONST static inline ulong
+fd_lb_sig_out_idx( ulong sig,
+                   ulong out_cnt ) {
+  return ((fd_ulong_hash( sig )>>32)*out_cnt)>>32;
+}
+
+/* fd_lb_tile load balances the fragment stream described by in_mcache
+   over out_cnt out_mcaches, each with exactly one reliable consumer
+   (and an arbitrary number of unreliable consumers).  The consumer of
+   out_mcache[out_idx] returns flow control credits to the lb via
+   out_fseq[out_idx].  The out to which each in frag is forwarded is
+   picked according to policy (see FD_LB_POLICY_* above).
+
+   The order of frags forwarded to any given out will be preserved.
+   Frags forwarded to different outs are processed independently by
+   their consumers and can complete in an arbitrary order.  Note that
+   this implies that, except under FD_LB_POLICY_SIG, fragments of a
+   multiple frag message can be forwarded to different outs.  Under
+   FD_LB_POLICY_SIG, an application that does multiple frag messages
+   should use the same sig for all frags of a message.
+
+   The sig, chunk, sz, ctl and tsorig input fragment metadata will be
+   unchanged by this tile.  In particular, the lb does not copy payloads
+   and the consumers of the outs should read the payloads from the in's
+   dcache (exactly like consumers of a mux).
+
+   For seq, each out has its own sequence space (the lb will sequence
+   the frags forwarded to an out consecutively, starting from
+   out_mcache's sequence number at boot).
+
+   For tsorig and tspub, the lb tile will recompute tspub for forwarded
+   fragments (see fd_mux_tile for more details).
+
+   cr_max is the maximum number of flow control credits the lb tile is
+   allowed for publishing frags to each out.  It represents the maximum
+   number of frags a reliable out can lag behind the lb on that out.
+   cr_max must be in [1,min(in_mcache.depth,out_mcache[*].depth)].  If
+   cr_max is zero, this uses that range's upper limit.
+
+   The lb returns flow control credits to the in producer such that
+   the producer will never overrun the oldest frag still being processed
+   by any out.  To do this exactly, the lb keeps track of in which in
+   sequence number each frag exposed to an out originated (this is the
+   reason the scratch footprint depends on the in_mcache's depth).  As
+   such, a slow out will eventually backpressure the in producer but
+   only after the other outs have used up all the in's credits.
+
+   lazy is the ballpark interval in ns for how often to receive credits
+   from an out (and, equivalently, how often to return credits to the
+   in).  See fd_mux_tile for more details.  <=0 indicates to pick a
+   conservative default.
+
+   scratch points to tile scratch memory.  fd_lb_tile_scratch_align and
+   fd_lb_tile_scratch_footprint return the required alignment and
+   footprint needed for this region.  This memory region is exclusively
+   owned by the lb tile while the tile is running and is ideally near
+   the core running the lb tile.  fd_lb_tile_scratch_align will return
+   the same value as FD_LB_TILE_SCRATCH_ALIGN.  If (in_depth,out_cnt) is
+   not valid, fd_lb_tile_scratch_footprint silently returns 0 so callers
+   can diagnose configuration issues.  Otherwise,
+   fd_lb_tile_scratch_footprint will return the same value as
+   FD_LB_TILE_SCRATCH_FOOTPRINT.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the lb tile (see fd_mux_tile for details of
+   the cnc state transitions).  Returns a non-zero error code if the
+   tile fails to boot up (logs details).  For maximally robust operation
+   in the current implementation, all reliable consumers should be
+   halted and/or caught up before this tile is halted.
+
+   A fd_lb_tile will use the application regions of the fseqs and cnc
+   for accumulating standard diagnostics in the standard ways.  The
+   FD_FSEQ_DIAG_SLOW_CNT of an out_fseq counts the number of times the
+   lb observed that out had no credits available.
+
+   The lifetime of the cnc, mcaches, fseqs, rng and scratch used by this
+   tile should be a superset of this tile's lifetime.  While this tile
+   is running, no other tile should use cnc for its command and control,
+   publish into the out_mcaches, use the rng for anything (and the rng
+   should be be seeded distinctly from all other rngs in the system), or
+   use scratch for anything.  This tile will act as a reliable consumer
+   of in_mcache metadata.  The out_mcache and out_fseq arrays will not
+   be used the after the tile has successfully booted (transitioned the
+   cnc from BOOT to RUN) or returned (e.g. failed to boot), whichever
+   comes first. */
+
+FD_FN_CONST ulong
+fd_lb_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_lb_tile_scratch_footprint( ulong in_depth,
+                              ulong out_cnt );
+
+int
+fd_lb_tile( fd_cnc_t *              cnc,        /* Local join to the lb's command-and-control */
+            fd_frag_meta_t const *  in_mcache,  /* Local join to the in's mcache */
+            ulong *                 in_fseq,    /* Local join to the in's fseq */
+            ulong                   out_cnt,    /* Number of outs, outs are indexed [0,out_cnt) */
+            fd_frag_meta_t **       out_mcache, /* out_mcache[out_idx] is the local join to out out_idx's mcache */
+            ulong **                out_fseq,   /* out_fseq  [out_idx] is the local join to out out_idx's reliable consumer's fseq */
+            int                     policy,     /* FD_LB_POLICY_* */
+            ulong                   cr_max,     /* Maximum number of flow control credits per out, 0 means use a reasonable default */
+            long                    lazy,       /* Lazyiness, <=0 means use a reasonable default */
+            fd_rng_t *              rng,        /* Local join to the rng this lb should use */
+            void *                  scratch );  /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif
+
+#endif /* HEADER_fd_src_disco_lb_fd_lb_h */
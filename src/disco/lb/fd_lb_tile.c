@@ -0,0 +1,113 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+FD_STATIC_ASSERT( FD_LB_TILE_SCRATCH_ALIGN<=FD_SHMEM_HUGE_PAGE_SZ, alignment );
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  FD_LOG_NOTICE(( "Init" ));
+
+  char const * _cnc         = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",         NULL, NULL );
+  char const * _in_mcache   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcache",   NULL, NULL );
+  char const * _in_fseq     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseq",     NULL, NULL );
+  char const * _out_mcaches = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-mcaches", NULL, ""   );
+  char const * _out_fseqs   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",   NULL, ""   );
+  char const * _policy      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--policy",      NULL, "rr" ); /* rr, cr or sig */
+  ulong        cr_max       = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",      NULL, 0UL  ); /*   0 <> use default */
+  long         lazy         = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",        NULL, 0L   ); /* <=0 <> use default */
+  uint         seed         = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",        NULL, (uint)(ulong)fd_tickcount() );
+
+  int policy;
+  if(      !strcmp( _policy, "rr"  ) ) policy = FD_LB_POLICY_RR;
+  else if( !strcmp( _policy, "cr"  ) ) policy = FD_LB_POLICY_CR;
+  else if( !strcmp( _policy, "sig" ) ) policy = FD_LB_POLICY_SIG;
+  else FD_LOG_ERR(( "unsupported --policy %s (should be rr, cr or sig)", _policy ));
+
+  if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
+  FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_map( _cnc ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+
+  if( FD_UNLIKELY( !_in_mcache ) ) FD_LOG_ERR(( "--in-mcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --in-mcache %s", _in_mcache ));
+  fd_frag_meta_t const * in_mcache = fd_mcache_join( fd_wksp_map( _in_mcache ) );
+  if( FD_UNLIKELY( !in_mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+  if( FD_UNLIKELY( !_in_fseq ) ) FD_LOG_ERR(( "--in-fseq not specified" ));
+  FD_LOG_NOTICE(( "Joining --in-fseq %s", _in_fseq ));
+  ulong * in_fseq = fd_fseq_join( fd_wksp_map( _in_fseq ) );
+  if( FD_UNLIKELY( !in_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+
+  char * _out_mcache[ 256 ];
+  ulong out_cnt = fd_cstr_tokenize( _out_mcache, 256UL, (char *)_out_mcaches, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( out_cnt>256UL ) ) FD_LOG_ERR(( "too many --out-mcaches specified for current implementation" ));
+
+  fd_frag_meta_t * out_mcache[ 256 ];
+  for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+    FD_LOG_NOTICE(( "Joining --out-mcaches[%lu] %s", out_idx, _out_mcache[ out_idx ] ));
+    out_mcache[ out_idx ] = fd_mcache_join( fd_wksp_map( _out_mcache[ out_idx ] ) );
+    if( FD_UNLIKELY( !out_mcache[ out_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+  }
+
+  char * _out_fseq[ 256 ];
+  ulong tmp = fd_cstr_tokenize( _out_fseq, 256UL, (char *)_out_fseqs, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( tmp!=out_cnt ) ) FD_LOG_ERR(( "--out-mcaches and --out-fseqs mismatch" ));
+
+  ulong * out_fseq[ 256 ];
+  for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+    FD_LOG_NOTICE(( "Joining --out-fseqs[%lu] %s", out_idx, _out_fseq[ out_idx ] ));
+    out_fseq[ out_idx ] = fd_fseq_join( fd_wksp_map( _out_fseq[ out_idx ] ) );
+    if( FD_UNLIKELY( !out_fseq[ out_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  }
+
+  FD_LOG_NOTICE(( "Using --policy %s, --cr-max %lu, --lazy %li", _policy, cr_max, lazy ));
+
+  FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+
+  FD_LOG_NOTICE(( "Creating scratch" ));
+  ulong footprint = fd_lb_tile_scratch_footprint( fd_mcache_depth( in_mcache ), out_cnt );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_lb_tile_scratch_footprint failed" ));
+  ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
+  ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
+  ulong  cpu_idx  = fd_tile_cpu_id( fd_tile_idx() );
+  void * scratch  = fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+  if( FD_UNLIKELY( !scratch ) ) FD_LOG_ERR(( "fd_shmem_acquire failed (need at least %lu free huge pages on numa node %lu)",
+                                             page_cnt, fd_shmem_numa_idx( cpu_idx ) ));
+
+  FD_LOG_NOTICE(( "Run" ));
+
+  int err = fd_lb_tile( cnc, in_mcache, in_fseq, out_cnt, out_mcache, out_fseq, policy, cr_max, lazy, rng, scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_lb_tile failed (%i)", err ));
+
+  FD_LOG_NOTICE(( "Fini" ));
+
+  fd_shmem_release( scratch, page_sz, page_cnt );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave  ( out_fseq  [ out_idx-1UL ] ) );
+  for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_mcache_leave( out_mcache[ out_idx-1UL ] ) );
+  fd_wksp_unmap( fd_fseq_leave  ( in_fseq   ) );
+  fd_wksp_unmap( fd_mcache_leave( in_mcache ) );
+  fd_wksp_unmap( fd_cnc_leave( cnc ) );
+
+  fd_halt();
+  return err;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "implement support for this build target" ));
+  fd_halt();
+  return 1;
+}
+
+#endif
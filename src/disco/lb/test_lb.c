@@ -0,0 +1,241 @@
+#include "../fd_disco.h"
+#include "../fd_disco_test_tile.c"
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+FD_STATIC_ASSERT( FD_LB_CNC_SIGNAL_ACK==4UL, unit_test );
+
+FD_STATIC_ASSERT( FD_LB_POLICY_RR ==0, unit_test );
+FD_STATIC_ASSERT( FD_LB_POLICY_CR ==1, unit_test );
+FD_STATIC_ASSERT( FD_LB_POLICY_SIG==2, unit_test );
+
+FD_STATIC_ASSERT( FD_LB_TILE_OUT_MAX     ==8192UL,    unit_test );
+FD_STATIC_ASSERT( FD_LB_TILE_IN_DEPTH_MAX==(1UL<<31), unit_test );
+
+FD_STATIC_ASSERT( FD_LB_TILE_SCRATCH_ALIGN==128UL, unit_test );
+
+struct test_cfg {
+  test_tx_t   tx[1];
+
+  uchar *     lb_cnc_mem;
+  uchar *     lb_scratch_mem;
+  int         lb_policy;
+  ulong       lb_cr_max;
+  long        lb_lazy;
+  uint        lb_seed;
+
+  ulong       rx_cnt;
+  test_rx_t   rx[ 128 ];
+  uchar *     rx_mcache_mem; ulong rx_mcache_footprint;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+/* LB tile ************************************************************/
+
+static int
+lb_tile_main( int     argc,
+              char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_cnc_t * cnc = fd_cnc_join( cfg->lb_cnc_mem );
+
+  fd_frag_meta_t const * tx_mcache = fd_mcache_join( cfg->tx->mcache_mem );
+  ulong *                tx_fseq   = fd_fseq_join  ( cfg->tx->fseq_mem   );
+
+  fd_frag_meta_t * rx_mcache[ 128 ];
+  for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ )
+    rx_mcache[ rx_idx ] = fd_mcache_join( cfg->rx_mcache_mem + rx_idx*cfg->rx_mcache_footprint );
+
+  ulong * rx_fseq[ 128 ];
+  for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ )
+    rx_fseq[ rx_idx ] = fd_fseq_join( cfg->rx[ rx_idx ].fseq_mem );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->lb_seed, 0UL ) );
+
+  int err = fd_lb_tile( cnc, tx_mcache, tx_fseq, cfg->rx_cnt, rx_mcache, rx_fseq, cfg->lb_policy,
+                        cfg->lb_cr_max, cfg->lb_lazy, rng, cfg->lb_scratch_mem );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_lb_tile failed (%i)", err ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  for( ulong rx_idx=cfg->rx_cnt; rx_idx; rx_idx-- ) fd_fseq_leave  ( rx_fseq  [ rx_idx-1UL ] );
+  for( ulong rx_idx=cfg->rx_cnt; rx_idx; rx_idx-- ) fd_mcache_leave( rx_mcache[ rx_idx-1UL ] );
+  fd_fseq_leave  ( tx_fseq   );
+  fd_mcache_leave( tx_mcache );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* RX tile ************************************************************/
+
+/* The rxs are the shared test rxs (see fd_disco_test_tile.c).  Under
+   the sig policy, they also check each frag was routed by its sig.
+   Only rx 0 is slow to model a slow worker. */
+
+static int
+rx_sig_ok( ulong sig,
+           ulong rx_idx,
+           ulong rx_cnt ) {
+  return fd_lb_sig_out_idx( sig, rx_cnt )==rx_idx;
+}
+
+/* CNC tile ***********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  FD_TEST( fd_lb_tile_scratch_align()==FD_LB_TILE_SCRATCH_ALIGN );
+  FD_TEST( !fd_lb_tile_scratch_footprint( 0UL,                           1UL                    ) );
+  FD_TEST( !fd_lb_tile_scratch_footprint( 3UL,                           1UL                    ) );
+  FD_TEST( !fd_lb_tile_scratch_footprint( FD_LB_TILE_IN_DEPTH_MAX<<1,    1UL                    ) );
+  FD_TEST( !fd_lb_tile_scratch_footprint( 1UL,                           FD_LB_TILE_OUT_MAX+1UL ) );
+  for( ulong iter_rem=10000000UL; iter_rem; iter_rem-- ) {
+    ulong in_depth = 1UL << fd_rng_uint_roll( rng, 32U );
+    ulong out_cnt  = fd_rng_ulong_roll( rng, FD_LB_TILE_OUT_MAX+1UL );
+    FD_TEST( fd_lb_tile_scratch_footprint( in_depth, out_cnt )==FD_LB_TILE_SCRATCH_FOOTPRINT( in_depth, out_cnt ) );
+  }
+  for( ulong iter_rem=10000000UL; iter_rem; iter_rem-- ) {
+    ulong out_cnt = fd_rng_ulong_roll( rng, FD_LB_TILE_OUT_MAX ) + 1UL;
+    ulong sig     = fd_rng_ulong( rng );
+    FD_TEST( fd_lb_sig_out_idx( sig, out_cnt )<out_cnt );
+    FD_TEST( !fd_lb_sig_out_idx( sig, 1UL ) );
+  }
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                 );
+  ulong        page_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                        );
+  ulong        numa_idx   = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        tx_depth   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",  NULL, 32768UL                    );
+  ulong        tx_mtu     = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",    NULL, 1542UL                     );
+  long         tx_lazy    = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",   NULL, 0L                         );
+  char const * _lb_policy = fd_env_strip_cmdline_cstr ( &argc, &argv, "--lb-policy", NULL, "cr"                       );
+  ulong        lb_cr_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--lb-cr-max", NULL, 0UL /* use default */      );
+  long         lb_lazy    = fd_env_strip_cmdline_long ( &argc, &argv, "--lb-lazy",   NULL, 0L /* use default */       );
+  ulong        rx_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",    NULL, 3UL                        );
+  ulong        rx_depth   = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-depth",  NULL, 4096UL                     );
+  int          rx_lazy    = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",   NULL, 7                          );
+  long         rx_slow    = fd_env_strip_cmdline_long ( &argc, &argv, "--rx-slow",   NULL, 100L                       );
+  long         duration   = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",  NULL, (long)10e9                 );
+
+  float burst_avg       = fd_env_strip_cmdline_float( &argc, &argv, "--burst-avg",       NULL, 1472.f );
+  ulong pkt_payload_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-payload-max", NULL, 1472UL );
+  ulong pkt_framing     = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-framing",     NULL,   70UL );
+  float pkt_bw          = fd_env_strip_cmdline_float( &argc, &argv, "--pkt-bw",          NULL,  25e9f );
+
+  int lb_policy;
+  if(      !strcmp( _lb_policy, "rr"  ) ) lb_policy = FD_LB_POLICY_RR;
+  else if( !strcmp( _lb_policy, "cr"  ) ) lb_policy = FD_LB_POLICY_CR;
+  else if( !strcmp( _lb_policy, "sig" ) ) lb_policy = FD_LB_POLICY_SIG;
+  else FD_LOG_ERR(( "unsupported --lb-policy (should be rr, cr or sig)" ));
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz        ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !rx_cnt         ) ) FD_LOG_ERR(( "rx_cnt should be positive" ));
+  if( FD_UNLIKELY( rx_cnt>128UL    ) ) FD_LOG_ERR(( "--rx-cnt too large for this unit test" ));
+
+  ulong tile_cnt = 1UL+1UL+1UL+rx_cnt; /* 1 main(cnc,this) + 1 tx_main + 1 lb_main + rx_cnt rx_mains */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
+
+  FD_LOG_NOTICE(( "Creating workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  long now = fd_tickcount();
+
+  test_cfg_t cfg[1];
+
+  ulong tx_seq0 = fd_rng_ulong( rng );
+  test_tx_new( cfg->tx, wksp, tx_depth, tx_mtu, tx_lazy, pkt_framing, pkt_payload_max, burst_avg, pkt_bw,
+               rng_seq++, tx_seq0, now );
+
+  FD_LOG_NOTICE(( "Creating lb (--lb-policy %s, --rx-cnt %lu, --rx-depth %lu)", _lb_policy, rx_cnt, rx_depth ));
+
+  cfg->lb_cnc_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) );
+  FD_TEST( cfg->lb_cnc_mem );
+  FD_TEST( fd_cnc_new( cfg->lb_cnc_mem, 64UL, 1UL, now ) );
+
+  ulong lb_scratch_footprint = fd_lb_tile_scratch_footprint( tx_depth, rx_cnt );
+  FD_TEST( lb_scratch_footprint );
+  cfg->lb_scratch_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_lb_tile_scratch_align(), lb_scratch_footprint );
+  FD_TEST( cfg->lb_scratch_mem );
+
+  cfg->lb_policy = lb_policy;
+  cfg->lb_cr_max = lb_cr_max;
+  cfg->lb_lazy   = lb_lazy;
+  cfg->lb_seed   = rng_seq++;
+
+  cfg->rx_cnt              = rx_cnt;
+  cfg->rx_mcache_footprint = fd_mcache_footprint( rx_depth, 0UL ); /* No app region for the mcache */
+  cfg->rx_mcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), cfg->rx_mcache_footprint*rx_cnt );
+  FD_TEST( cfg->rx_mcache_mem );
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    uchar * rx_mcache_mem = cfg->rx_mcache_mem + rx_idx*cfg->rx_mcache_footprint;
+    ulong   rx_seq0       = fd_rng_ulong( rng );
+    FD_TEST( fd_mcache_new( rx_mcache_mem, rx_depth, 0UL, rx_seq0 ) );
+    test_rx_new( cfg->rx + rx_idx, wksp, rx_idx, rx_cnt, rx_mcache_mem, cfg->tx->dcache_mem, rx_lazy,
+                 rx_idx ? 0L : rx_slow, (lb_policy==FD_LB_POLICY_SIG) ? rx_sig_ok : NULL, rng_seq++, rx_seq0, now );
+  }
+
+  test_tile_t tile[ 2UL+128UL ];
+  tile_cnt = 0UL;
+  tile[ tile_cnt++ ] = (test_tile_t){ .task = test_tx_tile_main, .arg = cfg->tx, .cnc_mem = cfg->tx->cnc_mem };
+  tile[ tile_cnt++ ] = (test_tile_t){ .task = lb_tile_main,      .arg = cfg,     .cnc_mem = cfg->lb_cnc_mem  };
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ )
+    tile[ tile_cnt++ ] = (test_tile_t){ .task = test_rx_tile_main, .arg = cfg->rx + rx_idx, .cnc_mem = cfg->rx[ rx_idx ].cnc_mem };
+
+  test_tiles_boot( tile, tile_cnt );
+
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --lb-policy %s, --lb-cr-max %lu, --lb-lazy %li ns, "
+                  "--rx-lazy %i, --rx-slow %li ns)",
+                  duration, tx_lazy, _lb_policy, lb_cr_max, lb_lazy, rx_lazy, rx_slow ));
+
+  /* FIXME: DO MONITORING WHILE RUNNING */
+  fd_log_sleep( duration );
+
+  test_tiles_halt( tile, tile_cnt );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    test_rx_delete( cfg->rx + rx_idx );
+    FD_TEST( fd_mcache_delete( cfg->rx_mcache_mem + rx_idx*cfg->rx_mcache_footprint ) );
+  }
+  fd_wksp_free_laddr( cfg->rx_mcache_mem );
+
+  FD_TEST( fd_cnc_delete( cfg->lb_cnc_mem ) );
+  fd_wksp_free_laddr( cfg->lb_scratch_mem );
+  fd_wksp_free_laddr( cfg->lb_cnc_mem     );
+
+  test_tx_delete( cfg->tx );
+
+  fd_wksp_delete_anonymous( wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_AVX capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
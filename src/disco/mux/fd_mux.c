@@ -2,76 +2,13 @@
 
 #if FD_HAS_HOSTED && FD_HAS_X86
 
-/* A fd_mux_tile_in has all the state needed for muxing frags from an
-   in.  It fits on exactly one cache line. */
-
-struct __attribute__((aligned(64))) fd_mux_tile_in {
-  fd_frag_meta_t const * mcache;   /* local join to this in's mcache */
-  ulong                  depth;    /* == fd_mcache_depth( mcache ), depth of this in's cache (const) */
-  ulong                  seq;      /* sequence number of next frag expected from the upstream producer,
-                                      updated when frag from this in published/filtered */
-  fd_frag_meta_t const * mline;    /* == mcache + fd_mcache_line_idx( seq, depth ), location to poll next */
-  ulong *                fseq;     /* local join to the fseq used to return flow control credits the in */
-  uint                   accum[6]; /* local diagnostic accumualtors.  These are drained during in housekeeping. */
-                                   /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
-};
-
-typedef struct fd_mux_tile_in fd_mux_tile_in_t;
-
-/* fd_mux_tile_in_update returns flow control credits to the in assuming
-   that there are at most exposed_cnt frags currently exposed to
-   reliable outs and drains the run-time diagnostics accumulated since
-   the last update.  Note that, once an in sequence number has been
-   confirmed to have been consumed downstream, it will remain consumed.
-   So, we can optimize this (and guarantee a monotonically increasing
-   fseq from the in's point of view) by only sending when
-   this_in_seq-exposed_cnt ends up ahead of this_in_fseq.  We still
-   drain diagnostics every update as we might still have diagnostic
-   accumulated since last update even when we don't need to update
-   this_in_fseq.  See note below about quasi-atomic draining.
-
-   For a simple example in normal operation of this, consider the case
-   where, at last update for this in, outs were caught up, and since
-   then, the mux forwarded 1 frag from this in, the mux forwarded 1 frag
-   from another in, and the outs didn't make any progress on the
-   forwarded frags.  At this point then, for the implementation below,
-   exposed_cnt will be 2 but this_in_seq will have advanced only 1 such
-   that this_in_seq-exposed_cnt will be before this_in_fseq.  Thus, we
-   will have diagnostics to accumulate for this in but no update needed
-   for this_in_fseq. */
-
-static inline void
-fd_mux_tile_in_update( fd_mux_tile_in_t * in,
-                       ulong              exposed_cnt ) {
-
-  /* Technically we don't need to use fd_fseq_query here as *in_fseq
-     is not volatile from the mux's point of view.  But we are paranoid,
-     it won't affect performance in this case and it is consistent with
-     typical fseq usages. */
-
-  ulong * in_fseq = in->fseq;
-  ulong seq = fd_seq_dec( in->seq, exposed_cnt );
-  if( FD_LIKELY( fd_seq_gt( seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, seq );
-
-  ulong * diag  = (ulong *)fd_fseq_app_laddr( in_fseq );
-  uint *  accum = in->accum;
-  ulong a0 = (ulong)accum[0]; ulong a1 = (ulong)accum[1]; ulong a2 = (ulong)accum[2];
-  ulong a3 = (ulong)accum[3]; ulong a4 = (ulong)accum[4]; ulong a5 = (ulong)accum[5];
-  FD_COMPILER_MFENCE();
-  diag[0] += a0;              diag[1] += a1;              diag[2] += a2;
-  diag[3] += a3;              diag[4] += a4;              diag[5] += a5;
-  FD_COMPILER_MFENCE();
-  accum[0] = 0U;              accum[1] = 0U;              accum[2] = 0U;
-  accum[3] = 0U;              accum[4] = 0U;              accum[5] = 0U;
-}
-
 #define SCRATCH_ALLOC( a, s ) (__extension__({                    \
     ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
     scratch_top = _scratch_alloc + (s);                           \
     (void *)_scratch_alloc;                                       \
   }))
 
-FD_STATIC_ASSERT( alignof(fd_mux_tile_in_t)<=FD_MUX_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( alignof(fd_disco_in_t)<=FD_MUX_TILE_SCRATCH_ALIGN, packing );
 
 ulong
 fd_mux_tile_scratch_align( void ) {
@@ -84,11 +21,12 @@ fd_mux_tile_scratch_footprint( ulong in_cnt,
   if( FD_UNLIKELY( in_cnt >FD_MUX_TILE_IN_MAX  ) ) return 0UL;
   if( FD_UNLIKELY( out_cnt>FD_MUX_TILE_OUT_MAX ) ) return 0UL;
   ulong scratch_top = 0UL;
-  SCRATCH_ALLOC( alignof(fd_mux_tile_in_t), in_cnt*sizeof(fd_mux_tile_in_t)     ); /* in */
-  SCRATCH_ALLOC( alignof(ulong const *),    out_cnt*sizeof(ulong const *)       ); /* out_fseq */
-  SCRATCH_ALLOC( alignof(ulong *),          out_cnt*sizeof(ulong *)             ); /* out_slow */
-  SCRATCH_ALLOC( alignof(ulong),            out_cnt*sizeof(ulong)               ); /* out_seq */
-  SCRATCH_ALLOC( alignof(ushort),           (in_cnt+out_cnt+1UL)*sizeof(ushort) ); /* event_map */
+  SCRATCH_ALLOC( alignof(fd_disco_in_t),    in_cnt*sizeof(fd_disco_in_t)                     ); /* in */
+  SCRATCH_ALLOC( alignof(ushort),           in_cnt*FD_MUX_TILE_IN_WEIGHT_MAX*sizeof(ushort) ); /* poll_map */
+  SCRATCH_ALLOC( alignof(ulong const *),    out_cnt*sizeof(ulong const *)                    ); /* out_fseq */
+  SCRATCH_ALLOC( alignof(ulong *),          out_cnt*sizeof(ulong *)                          ); /* out_slow */
+  SCRATCH_ALLOC( alignof(ulong),            out_cnt*sizeof(ulong)                            ); /* out_seq */
+  SCRATCH_ALLOC( alignof(ushort),           (in_cnt+out_cnt+1UL)*sizeof(ushort)              ); /* event_map */
   return fd_ulong_align_up( scratch_top, fd_mux_tile_scratch_align() );
 }
 
@@ -97,11 +35,13 @@ fd_mux_tile( fd_cnc_t *              cnc,
              ulong                   in_cnt,
              fd_frag_meta_t const ** in_mcache,
              ulong **                in_fseq,
+             ulong const *           in_weight,
              fd_frag_meta_t *        mcache,
              ulong                   out_cnt,
              ulong **                _out_fseq,
              ulong                   cr_max,
              long                    lazy,
+             fd_idle_t *             idle,
              fd_rng_t *              rng,
              void *                  scratch ) {
 
@@ -109,12 +49,15 @@ fd_mux_tile( fd_cnc_t *              cnc,
   ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the mux tile cnc diagnostic region */
   ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
   ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  int     cnc_cmd_en;         /* non-zero if the cnc app region has room for FD_DISCO_CNC_ARG_* (i.e. attach / detach supported) */
 
   /* in frag stream state */
-  ulong              in_seq; /* current position in input poll sequence, in [0,in_cnt) */
-  fd_mux_tile_in_t * in;     /* in[in_seq] for in_seq in [0,in_cnt) has information about input fragment stream currently at
-                                position in_seq in the in_idx polling sequence.  The ordering of this array is continuously
-                                shuffled to avoid lighthousing effects in the output fragment stream at extreme fan-in and load */
+  fd_disco_in_t *    in;       /* in[in_idx] for in_idx in [0,in_cnt) has information about input fragment stream in_idx */
+  ulong              poll_cnt; /* ==sum(in_weight) over attached ins, number of polls in a polling cycle */
+  ulong              poll_seq; /* current position in input poll sequence, in [0,poll_cnt) */
+  ushort *           poll_map; /* poll_map[poll_seq] is the in_idx to poll at position poll_seq in the polling sequence.  Each
+                                  in_idx appears in_weight[in_idx] times.  The ordering of this array is continuously shuffled
+                                  to avoid lighthousing effects in the output fragment stream at extreme fan-in and load */
 
   /* out frag stream state */
   ulong   depth; /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
@@ -155,10 +98,20 @@ fd_mux_tile( fd_cnc_t *              cnc,
 
     if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
     if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<16UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 16" )); return 1; }
+    cnc_cmd_en = (fd_cnc_app_sz( cnc )>=FD_DISCO_CNC_CMD_APP_SZ);
     if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
 
     cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
 
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,  1U },
+      { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT, 1U }
+    };
+    /* The in command args are not metrics but the registry must not
+       grow over them */
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t),
+                                cnc_cmd_en ? FD_DISCO_CNC_CMD_APP_SZ : 0UL );
+
     /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
        cleared during first housekeeping if credits available */
     cnc_diag_in_backp  = 1UL;
@@ -166,8 +119,7 @@ fd_mux_tile( fd_cnc_t *              cnc,
 
     /* in frag stream init */
 
-    in_seq = 0UL; /* First in to poll */
-    in = (fd_mux_tile_in_t *)SCRATCH_ALLOC( alignof(fd_mux_tile_in_t), in_cnt*sizeof(fd_mux_tile_in_t) );
+    in = (fd_disco_in_t *)SCRATCH_ALLOC( alignof(fd_disco_in_t), in_cnt*sizeof(fd_disco_in_t) );
 
     ulong min_in_depth = (ulong)LONG_MAX;
 
@@ -175,24 +127,44 @@ fd_mux_tile( fd_cnc_t *              cnc,
     if( FD_UNLIKELY( !!in_cnt && !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
     for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
 
-      /* FIXME: CONSIDER NULL OR EMPTY CSTR IN_FCTL[ IN_IDX ] TO SPECIFY
-         NO FLOW CONTROL FOR A PARTICULAR IN? */
-      if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) { FD_LOG_WARNING(( "NULL in_mcache[%lu]", in_idx )); return 1; }
-      if( FD_UNLIKELY( !in_fseq  [ in_idx ] ) ) { FD_LOG_WARNING(( "NULL in_fseq[%lu]",   in_idx )); return 1; }
-
-      fd_mux_tile_in_t * this_in = &in[ in_idx ];
+      /* A NULL in_mcache[ in_idx ] and in_fseq[ in_idx ] is an unbound
+         slot that can be bound to an in at run time (it must be booted
+         detached).  FIXME: CONSIDER NULL OR EMPTY CSTR IN_FCTL[ IN_IDX ]
+         TO SPECIFY NO FLOW CONTROL FOR A PARTICULAR IN? */
+      if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) {
+        if( FD_UNLIKELY( in_fseq[ in_idx ] || !in_weight || in_weight[ in_idx ] ) ) {
+          FD_LOG_WARNING(( "NULL in_mcache[%lu] (an unbound slot needs a NULL in_fseq and 0 in_weight)", in_idx ));
+          return 1;
+        }
+        fd_disco_in_init( &in[ in_idx ], NULL, NULL, 0UL );
+        continue;
+      }
+      if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) { FD_LOG_WARNING(( "NULL in_fseq[%lu]", in_idx )); return 1; }
 
-      this_in->mcache = in_mcache[ in_idx ];
-      this_in->fseq   = in_fseq  [ in_idx ];
-      ulong const * this_in_sync = fd_mcache_seq_laddr_const( this_in->mcache );
+      fd_disco_in_init( &in[ in_idx ], in_mcache[ in_idx ], in_fseq[ in_idx ],
+                        fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache[ in_idx ] ) ) ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
+      min_in_depth = fd_ulong_min( min_in_depth, in[ in_idx ].depth );
+    }
 
-      this_in->depth  = fd_mcache_depth( this_in->mcache ); min_in_depth = fd_ulong_min( min_in_depth, this_in->depth );
-      this_in->seq    = fd_mcache_seq_query( this_in_sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
-      this_in->mline  = this_in->mcache + fd_mcache_line_idx( this_in->seq, this_in->depth );
+    /* Initialize the polling sequence.  We interleave the ins by
+       weight round such that, before the first shuffle, the polls of
+       each in are spread evenly over the polling cycle. */
 
-      this_in->accum[0] = 0U; this_in->accum[1] = 0U; this_in->accum[2] = 0U;
-      this_in->accum[3] = 0U; this_in->accum[4] = 0U; this_in->accum[5] = 0U;
+    poll_map = (ushort *)SCRATCH_ALLOC( alignof(ushort), in_cnt*FD_MUX_TILE_IN_WEIGHT_MAX*sizeof(ushort) );
+    poll_cnt = 0UL;
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+      ulong weight = in_weight ? in_weight[ in_idx ] : 1UL;
+      if( FD_UNLIKELY( weight>FD_MUX_TILE_IN_WEIGHT_MAX ) ) {
+        FD_LOG_WARNING(( "in_weight[%lu] %lu must be in [0,%lu]", in_idx, weight, FD_MUX_TILE_IN_WEIGHT_MAX ));
+        return 1;
+      }
+      if( FD_UNLIKELY( !weight ) ) FD_LOG_INFO(( "in %lu detached at boot", in_idx ));
     }
+    for( ulong round=0UL; round<FD_MUX_TILE_IN_WEIGHT_MAX; round++ )
+      for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ )
+        if( (in_weight ? in_weight[ in_idx ] : 1UL)>round ) poll_map[ poll_cnt++ ] = (ushort)in_idx;
+    poll_seq = 0UL; /* First in to poll */
+    if( in_weight ) FD_LOG_INFO(( "Using weighted polling (poll_cnt %lu)", poll_cnt ));
 
     /* out frag stream init */
 
@@ -374,12 +346,13 @@ fd_mux_tile( fd_cnc_t *              cnc,
            this in.  FIXME: COULD DO A NUMBER OF TRICKS FOR AN EVEN
            TIGHTER BOUND HERE (E.G. EXPLICITLY TRACKING THE NUMBER OF
            FRAGS EXPOSED PER UPSTREAM CONSUMER FOR EXAMPLE). */
-        fd_mux_tile_in_update( &in[ in_idx ], cr_max-cr_avail );
+        fd_disco_in_update( &in[ in_idx ], cr_max-cr_avail );
 
       } else { /* event_idx==out_cnt, housekeeping event */
 
-        /* Send synchronization info */
+        /* Send synchronization info (and wake up any parked outs) */
         fd_mcache_seq_update( sync, seq );
+        fd_idle_wake( sync, seq );
 
         /* Send diagnostic info */
         /* When we drain, we don't do a fully atomic update of the
@@ -398,7 +371,11 @@ fd_mux_tile( fd_cnc_t *              cnc,
         ulong s = fd_cnc_signal_query( cnc );
         if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
           if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
-          if( FD_UNLIKELY( s!=FD_MUX_CNC_SIGNAL_ACK ) ) {
+          if( FD_UNLIKELY( ((s==FD_MUX_CNC_SIGNAL_ATTACH) | (s==FD_MUX_CNC_SIGNAL_DETACH)) & cnc_cmd_en ) ) {
+            poll_cnt = fd_disco_in_cmd_handle( cnc, s==FD_MUX_CNC_SIGNAL_ATTACH, in, in_cnt, FD_MUX_TILE_IN_WEIGHT_MAX,
+                                               cr_max, cr_max-cr_avail, poll_map, poll_cnt, rng );
+            poll_seq = 0UL;
+          } else if( FD_UNLIKELY( s!=FD_MUX_CNC_SIGNAL_ACK ) ) {
             char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
             FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
           }
@@ -440,15 +417,16 @@ fd_mux_tile( fd_cnc_t *              cnc,
         event_map[ swap_idx ] = event_map[ 0        ];
         event_map[ 0        ] = map_tmp;
 
-        /* We also do the same with the ins to prevent there being a
-           correlated order frag origins from different inputs
-           downstream at extreme fan in and extreme in load. */
+        /* We also do the same with the polling sequence to prevent
+           there being a correlated order frag origins from different
+           inputs downstream at extreme fan in and extreme in load. */
 
-        swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)in_cnt );
-        fd_mux_tile_in_t in_tmp;
-        in_tmp         = in[ swap_idx ];
-        in[ swap_idx ] = in[ 0        ];
-        in[ 0        ] = in_tmp;
+        if( FD_LIKELY( poll_cnt ) ) {
+          swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)poll_cnt );
+          map_tmp              = poll_map[ swap_idx ];
+          poll_map[ swap_idx ] = poll_map[ 0        ];
+          poll_map[ 0        ] = map_tmp;
+        }
       }
 
       /* Reload housekeeping timer */
@@ -472,12 +450,12 @@ fd_mux_tile( fd_cnc_t *              cnc,
     }
     cnc_diag_in_backp = 0UL;
 
-    /* Select which in to poll next (randomized round robin) */
+    /* Select which in to poll next (randomized weighted round robin) */
 
-    if( FD_UNLIKELY( !in_cnt ) ) { now = fd_tickcount(); continue; }
-    fd_mux_tile_in_t * this_in = &in[ in_seq ];
-    in_seq++;
-    if( in_seq>=in_cnt ) in_seq = 0UL; /* cmov */
+    if( FD_UNLIKELY( !poll_cnt ) ) { now = fd_tickcount(); continue; }
+    fd_disco_in_t * this_in = &in[ poll_map[ poll_seq ] ];
+    poll_seq++;
+    if( poll_seq>=poll_cnt ) poll_seq = 0UL; /* cmov */
 
     /* Check if this in has any new fragments to mux */
 
@@ -493,6 +471,8 @@ fd_mux_tile( fd_cnc_t *              cnc,
       if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if in is honoring our flow control) */
         this_in->seq = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
         this_in->accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+      } else if( FD_UNLIKELY( idle ) ) { /* Caught up and idling opted in, park on this in if idle long enough */
+        fd_idle_wait( idle, seq, now, &this_in_mline->seq, seq_found, (ulong *)fd_mcache_seq_laddr_const( this_in->mcache ) );
       }
       /* Don't bother with spin as polling multiple locations */
       now = fd_tickcount();
@@ -514,6 +494,7 @@ fd_mux_tile( fd_cnc_t *              cnc,
     ulong sz       = (ulong)this_in_mline->sz;
     ulong ctl      = (ulong)this_in_mline->ctl;
     ulong tsorig   = (ulong)this_in_mline->tsorig;
+    ulong in_tspub = (ulong)this_in_mline->tspub;
     FD_COMPILER_MFENCE();
     ulong seq_test =        this_in_mline->seq;
     FD_COMPILER_MFENCE();
@@ -549,16 +530,28 @@ fd_mux_tile( fd_cnc_t *              cnc,
     ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + should_filter*2UL;
     this_in->accum[ diag_idx     ]++;
     this_in->accum[ diag_idx+1UL ] += (uint)sz;
+    fd_fseq_lat_sample( (ulong *)fd_fseq_app_laddr( this_in->fseq ), now, tsorig, in_tspub );
   }
 
   do {
 
     FD_LOG_INFO(( "Halting mux" ));
 
-    while( in_cnt ) {
-      ulong in_idx = --in_cnt;
-      fd_mux_tile_in_t * this_in = &in[ in_idx ];
-      fd_mux_tile_in_update( this_in, 0UL ); /* exposed_cnt 0 assumes all reliable consumers caught up or shutdown */
+    ulong pub_tot = 0UL;
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+      fd_disco_in_t * this_in = &in[ in_idx ];
+      fd_disco_in_update( this_in, 0UL ); /* exposed_cnt 0 assumes all reliable consumers caught up or shutdown */
+      if( this_in->fseq ) pub_tot += ((ulong const *)fd_fseq_app_laddr_const( this_in->fseq ))[ FD_FSEQ_DIAG_PUB_CNT ];
+    }
+
+    /* Report the service share each in got (as accumulated in the in
+       fseq diagnostics) */
+
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+      if( !in[ in_idx ].fseq ) continue; /* unbound */
+      ulong pub_cnt = ((ulong const *)fd_fseq_app_laddr_const( in[ in_idx ].fseq ))[ FD_FSEQ_DIAG_PUB_CNT ];
+      FD_LOG_INFO(( "in %lu: pub_cnt %lu (%.3f%% service share)", in_idx, pub_cnt,
+                    pub_tot ? 100.*(double)pub_cnt/(double)pub_tot : 0. ));
     }
 
     FD_LOG_INFO(( "Halted mux" ));
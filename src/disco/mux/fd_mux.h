@@ -21,6 +21,21 @@
 
 #define FD_MUX_CNC_SIGNAL_ACK (4UL)
 
+/* FD_MUX_CNC_SIGNAL_{ATTACH,DETACH} and FD_MUX_CNC_ARG_* can be
+   raised by a cnc thread with an open command session while the mux is
+   in the RUN state to attach / detach an input to / from the mux while
+   it is running.  These are the standard disco in commands (see
+   FD_DISCO_CNC_SIGNAL_{ATTACH,DETACH} in fd_disco_base.h for details
+   and fd_disco_in_cmd for a convenient way to issue them). */
+
+#define FD_MUX_CNC_SIGNAL_ATTACH FD_DISCO_CNC_SIGNAL_ATTACH
+#define FD_MUX_CNC_SIGNAL_DETACH FD_DISCO_CNC_SIGNAL_DETACH
+
+#define FD_MUX_CNC_ARG_IN_IDX    FD_DISCO_CNC_ARG_IN_IDX
+#define FD_MUX_CNC_ARG_IN_WEIGHT FD_DISCO_CNC_ARG_IN_WEIGHT
+#define FD_MUX_CNC_ARG_IN_MCACHE FD_DISCO_CNC_ARG_IN_MCACHE
+#define FD_MUX_CNC_ARG_IN_FSEQ   FD_DISCO_CNC_ARG_IN_FSEQ
+
 /* FD_MUX_TILE_IN_MAX and FD_MUX_TILE_OUT_MAX are the maximum number of
    inputs and outputs respectively that a mux tile can have.  These
    limits are more or less arbitrary from a functional correctness POV.
@@ -32,25 +47,31 @@
 #define FD_MUX_TILE_IN_MAX  FD_FRAG_META_ORIG_MAX
 #define FD_MUX_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
 
+/* FD_MUX_TILE_IN_WEIGHT_MAX is the maximum polling weight that can be
+   assigned to an input (see fd_mux_tile below for details). */
+
+#define FD_MUX_TILE_IN_WEIGHT_MAX (16UL)
+
 /* FD_MUX_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
    footprint needed for a mux tile scratch region that can support
-   in_cnt inputs and out_cnt outputs.  ALIGN is an integer power of 2 of
-   at least be at least double cache line to mitigate various kinds of
-   false sharing.  FOOTPRINT will be an integer multiple of ALIGN.
-   {in,out}_cnt are assumed to be valid (i.e. at most
-   FD_MUX_TILE_{IN,OUT}_MAX).  in_cnt and out_cnt are assumed to be
-   valid and safe against multiple evaluation.  These are provided to
-   facilitate compile time declarations. */
+   in_cnt inputs (with arbitrary in weights) and out_cnt outputs.  ALIGN
+   is an integer power of 2 of at least be at least double cache line to
+   mitigate various kinds of false sharing.  FOOTPRINT will be an
+   integer multiple of ALIGN.  {in,out}_cnt are assumed to be valid
+   (i.e. at most FD_MUX_TILE_{IN,OUT}_MAX).  in_cnt and out_cnt are
+   assumed to be valid and safe against multiple evaluation.  These are
+   provided to facilitate compile time declarations. */
 
 #define FD_MUX_TILE_SCRATCH_ALIGN (128UL)
-#define FD_MUX_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt )                \
-  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( \
-  FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                   \
-    64UL,             (in_cnt)*64UL                           ),        \
-    alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
-    alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
-    alignof(ulong),   (out_cnt)*sizeof(ulong)                 ),        \
-    alignof(ushort),  ((in_cnt)+(out_cnt)+1UL)*sizeof(ushort) ),        \
+#define FD_MUX_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt )                      \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(       \
+  FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,       \
+    64UL,             (in_cnt)*64UL                                      ),   \
+    alignof(ushort),  (in_cnt)*FD_MUX_TILE_IN_WEIGHT_MAX*sizeof(ushort)  ),   \
+    alignof(ulong *), (out_cnt)*sizeof(ulong *)                          ),   \
+    alignof(ulong *), (out_cnt)*sizeof(ulong *)                          ),   \
+    alignof(ulong),   (out_cnt)*sizeof(ulong)                            ),   \
+    alignof(ushort),  ((in_cnt)+(out_cnt)+1UL)*sizeof(ushort)            ),   \
     FD_MUX_TILE_SCRATCH_ALIGN )
 
 FD_PROTOTYPES_BEGIN
@@ -68,6 +89,48 @@ FD_PROTOTYPES_BEGIN
    interleaved (but this makes an extreme best effort to avoid
    starvation and minimize slip between different groups of streams).
 
+   in_weight[in_idx] is the polling weight of input in_idx and should be
+   in [0,FD_MUX_TILE_IN_WEIGHT_MAX].  The mux polls each in_idx
+   in_weight[in_idx] times per polling cycle, spread evenly over the
+   cycle (a polling cycle is sum(in_weight) polls and its order is
+   continuously shuffled like the unweighted case).  Thus, when the mux
+   is the bottleneck (e.g. a low priority flood on one input), a
+   higher weighted input will be serviced proportionally more often
+   (and thus see lower latency) while the lower weighted inputs absorb
+   the backpressure.  Since every input has a weight of at least 1,
+   every input with frags available is guaranteed to be serviced at
+   least once every sum(in_weight) polls (i.e. starvation is bounded).
+   Strict priority can be approximated by giving high priority inputs
+   FD_MUX_TILE_IN_WEIGHT_MAX and the rest 1.  If in_weight is NULL, all
+   inputs have weight 1 (i.e. a fair shuffled round robin).
+
+   An input with a weight of 0 is booted detached.  Detached inputs are
+   not polled but are still returned flow control credits for any of
+   their frags still exposed downstream.  Inputs can be attached and
+   detached while the mux is running via the FD_MUX_CNC_SIGNAL_{ATTACH,
+   DETACH} commands.  On attach, the mux resumes from where it left off
+   in the input's sequence space (for an input detached at boot, this is
+   where the input's producer was at boot).  Since the mux does not
+   return credits past this point while an input is detached, frags an
+   input's producer publishes while detached are not lost; they are
+   muxed after the input is (re)attached (a detached producer is
+   eventually backpressured).  Applications that do multiple frag
+   messages should only detach an input at a message boundary (e.g.
+   after halting the input's producer and letting the mux catch up).
+   Typical usage is to boot a mux with all the inputs it could ever
+   need, with the ones for producers that are not running detached, and
+   then attach them as producers are started up.  Alternatively, an
+   input slot can be booted unbound (NULL in_mcache[in_idx] and
+   in_fseq[in_idx] with a 0 in_weight[in_idx]) and be bound to an
+   mcache / fseq pair created after the mux booted when it is attached
+   (a detached slot can similarly be rebound to a different producer).
+
+   Each input's service is accumulated in the FD_FSEQ_DIAG_PUB_CNT /
+   FD_FSEQ_DIAG_PUB_SZ diagnostics of its in_fseq such that monitoring
+   can compute each input's service share over an interval as its PUB
+   delta over the sum of the PUB deltas of all inputs.  The mux also
+   logs each input's accumulated service share when halted.
+
    The signature, chunk, sz, ctl and tsorig input fragment metadata will
    be unchanged by this tile.
 
@@ -163,6 +226,15 @@ FD_PROTOTYPES_BEGIN
    fast a consumer can process frags typically.  <=0 indicates to pick a
    conservative default.
 
+   idle is the idle policy the mux should use when it is caught up with
+   the in it is polling (NULL indicates to poll continuously as usual).
+   When a streak of idleness is long enough for the mux to park (see
+   fd_idle.h), the mux parks on the in it was polling.  Other ins will
+   then only be noticed when the park times out, so idle is best suited
+   for muxes where traffic is sparse on all ins.  Regardless of idle,
+   the mux rings the doorbell of its own mcache (see fd_idle_wake) in its
+   housekeeping such that consumers of the mux can park.
+
    scratch points to tile scratch memory.  fd_mux_tile_scratch_align and
    fd_mux_tile_scratch_footprint return the required alignment and
    footprint needed for this region.  This memory region is exclusively
@@ -180,7 +252,9 @@ FD_PROTOTYPES_BEGIN
    such that they can be accumulated over multiple runs).  Clearing is
    up to monitoring scripts.  It is recommend that inputs and outputs
    also use their cnc and fseq application regions similarly for
-   monitoring simplicity / consistency.
+   monitoring simplicity / consistency.  In particular, the latency of
+   every frag consumed from an in is accumulated to the LAT_PUB /
+   LAT_ORIG histograms of its in_fseq.
    
    The lifetime of the cnc, mcaches, fseqs, rng and scratch used by this
    tile should be a superset of this tile's lifetime.  While this tile
@@ -196,7 +270,9 @@ FD_PROTOTYPES_BEGIN
    updating producer oriented diagnostics).  The in_mcache, in_fseq and
    out_fseq arrays will not be used the after the tile has successfully
    booted (transitioned the cnc from BOOT to RUN) or returned (e.g.
-   failed to boot), whichever comes first. */
+   failed to boot), whichever comes first.  The lifetime of idle (if
+   any) should be a superset of this tile's lifetime and it should not
+   be used by anything else while this tile is running. */
 
 FD_FN_CONST ulong
 fd_mux_tile_scratch_align( void );
@@ -210,11 +286,13 @@ fd_mux_tile( fd_cnc_t *              cnc,       /* Local join to the mux's comma
              ulong                   in_cnt,    /* Number of input mcaches to multiplex, inputs are indexed [0,in_cnt) */
              fd_frag_meta_t const ** in_mcache, /* in_mcache[in_idx] is the local join to input in_idx's mcache */
              ulong **                in_fseq,   /* in_fseq  [in_idx] is the local join to input in_idx's fseq */
+             ulong const *           in_weight, /* in_weight[in_idx] is input in_idx's polling weight, NULL means all 1 */
              fd_frag_meta_t *        mcache,    /* Local join to the mux's frag stream output mcache */
              ulong                   out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
              ulong **                out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
              ulong                   cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
              long                    lazy,      /* Lazyiness, <=0 means use a reasonable default */
+             fd_idle_t *             idle,      /* Local join to the idle policy this mux should use, NULL means always poll */
              fd_rng_t *              rng,       /* Local join to the rng this mux should use */
              void *                  scratch ); /* Tile scratch memory */
 
@@ -14,10 +14,12 @@ main( int     argc,
   char const * _cnc        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",        NULL, NULL );
   char const * _in_mcaches = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcaches", NULL, ""   );
   char const * _in_fseqs   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseqs",   NULL, ""   );
+  char const * _in_weights = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-weights", NULL, NULL ); /* NULL <> all 1 */
   char const * _mcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",     NULL, NULL );
   char const * _out_fseqs  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",  NULL, ""   );
   ulong        cr_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",     NULL, 0UL  ); /*   0 <> use default */
   long         lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",       NULL, 0L   ); /* <=0 <> use default */
+  int          idle_en     = fd_env_strip_cmdline_int  ( &argc, &argv, "--idle",       NULL, 0    ); /*   0 <> always poll */
   uint         seed        = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",       NULL, (uint)(ulong)fd_tickcount() );
 
   if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
@@ -47,6 +49,19 @@ main( int     argc,
     if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
   }
 
+  ulong   _in_weight[ 256 ];
+  ulong * in_weight = NULL;
+  if( _in_weights ) {
+    char * _in_weight_cstr[ 256 ];
+    tmp = fd_cstr_tokenize( _in_weight_cstr, 256UL, (char *)_in_weights, ',' ); /* argv is non-const */
+    if( FD_UNLIKELY( tmp!=in_cnt ) ) FD_LOG_ERR(( "--in-mcaches and --in-weights mismatch" ));
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+      _in_weight[ in_idx ] = fd_cstr_to_ulong( _in_weight_cstr[ in_idx ] );
+      FD_LOG_NOTICE(( "Using --in-weights[%lu] %lu", in_idx, _in_weight[ in_idx ] ));
+    }
+    in_weight = _in_weight;
+  }
+
   if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
   FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
   fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_map( _mcache ) );
@@ -65,6 +80,14 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Using --cr-max %lu, --lazy %li", cr_max, lazy ));
 
+  fd_idle_t   _idle[1];
+  fd_idle_t * idle = NULL;
+  if( idle_en ) {
+    FD_LOG_NOTICE(( "Creating idle policy --idle %i", idle_en ));
+    idle = fd_idle_join( fd_idle_new( _idle, -1L, -1L, -1L ) );
+    if( FD_UNLIKELY( !idle ) ) FD_LOG_ERR(( "fd_idle_new failed" ));
+  }
+
   FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
@@ -81,13 +104,14 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_mux_tile( cnc, in_cnt, in_mcache, in_fseq, mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_mux_tile( cnc, in_cnt, in_mcache, in_fseq, in_weight, mcache, out_cnt, out_fseq, cr_max, lazy, idle, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
 
   fd_shmem_release( scratch, page_sz, page_cnt );
   fd_rng_delete( fd_rng_leave( rng ) );
+  if( idle ) fd_idle_delete( fd_idle_leave( idle ) );
   for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave( out_fseq[ out_idx-1UL ] ) );
   fd_wksp_unmap( fd_mcache_leave( mcache ) );
   for( ulong in_idx=in_cnt; in_idx; in_idx-- ) fd_wksp_unmap( fd_fseq_leave  ( in_fseq  [ in_idx-1UL ] ) );
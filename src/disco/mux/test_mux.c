@@ -5,9 +5,14 @@
 #include <math.h> /* For expm1f */
 
 FD_STATIC_ASSERT( FD_MUX_CNC_SIGNAL_ACK==4UL, unit_test );
+FD_STATIC_ASSERT( FD_MUX_CNC_SIGNAL_ATTACH==5UL, unit_test );
+FD_STATIC_ASSERT( FD_MUX_CNC_SIGNAL_DETACH==6UL, unit_test );
+FD_STATIC_ASSERT( FD_MUX_CNC_ARG_IN_IDX   ==6UL, unit_test );
+FD_STATIC_ASSERT( FD_MUX_CNC_ARG_IN_WEIGHT==7UL, unit_test );
 
 FD_STATIC_ASSERT( FD_MUX_TILE_IN_MAX ==8192UL, unit_test );
 FD_STATIC_ASSERT( FD_MUX_TILE_OUT_MAX==8192UL, unit_test );
+FD_STATIC_ASSERT( FD_MUX_TILE_IN_WEIGHT_MAX==16UL, unit_test );
 
 FD_STATIC_ASSERT( FD_MUX_TILE_SCRATCH_ALIGN==128UL, unit_test );
 
@@ -28,6 +33,8 @@ struct test_cfg {
   uchar *     mux_scratch_mem;
   ulong       mux_cr_max;
   long        mux_lazy;
+  ulong       mux_weight;
+  int         mux_idle;
   uint        mux_seed;
 
   ulong       rx_cnt;
@@ -128,6 +135,7 @@ tx_tile_main( int     argc,
 
       /* Send synchronization info */
       fd_mcache_seq_update( sync, seq );
+      fd_idle_wake( sync, seq );
 
       /* Send diagnostic info */
       fd_cnc_heartbeat( cnc, now );
@@ -272,13 +280,24 @@ mux_tile_main( int     argc,
   for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ )
     rx_fseq[ rx_idx ] = fd_fseq_join( cfg->rx_fseq_mem + rx_idx*cfg->rx_fseq_footprint );
 
+  ulong tx_weight[ 128 ]; /* tx 0 has weight mux_weight, the rest 1 */
+  for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ ) tx_weight[ tx_idx ] = tx_idx ? 1UL : cfg->mux_weight;
+
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->mux_seed, 0UL ) );
 
-  int err = fd_mux_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, mux_mcache, cfg->rx_cnt, rx_fseq,
-                         cfg->mux_cr_max, cfg->mux_lazy, rng, cfg->mux_scratch_mem );
+  fd_idle_t _idle[1];
+  fd_idle_t * idle = cfg->mux_idle ? fd_idle_join( fd_idle_new( _idle, -1L, -1L, -1L ) ) : NULL;
+
+  int err = fd_mux_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, tx_weight, mux_mcache, cfg->rx_cnt, rx_fseq,
+                         cfg->mux_cr_max, cfg->mux_lazy, idle, rng, cfg->mux_scratch_mem );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
 
+  if( idle ) {
+    FD_LOG_NOTICE(( "mux idle: park_cnt %lu wake_cnt %lu", fd_idle_park_cnt( idle ), fd_idle_wake_cnt( idle ) ));
+    fd_idle_delete( fd_idle_leave( idle ) );
+  }
+
   fd_rng_delete( fd_rng_leave( rng ) );
   for( ulong rx_idx=cfg->rx_cnt; rx_idx; rx_idx-- ) fd_fseq_leave  ( rx_fseq  [ rx_idx-1UL ] );
   fd_mcache_leave( mux_mcache );
@@ -437,8 +456,11 @@ main( int     argc,
   ulong        tx_mtu     = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",     NULL, 1472UL                       );
   long         tx_lazy    = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",    NULL, 0L                           );
   ulong        mux_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-depth",  NULL, 32768UL                      );
-  ulong        mux_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-cr-max", NULL, 0UL /* use default */        );
+  ulong        mux_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-cr-max", NULL, 1024UL /* 0 for default */   );
   long         mux_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--mux-lazy",   NULL, 0L /* use default */         );
+  ulong        mux_weight = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-weight", NULL, 1UL /* tx 0 weight */        );
+  int          mux_idle   = fd_env_strip_cmdline_int  ( &argc, &argv, "--mux-idle",   NULL, 0 /* always poll */          );
+  float        share_tol  = fd_env_strip_cmdline_float( &argc, &argv, "--share-tol",  NULL, 0.05f /* absolute */       );
   ulong        rx_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",     NULL, 2UL                          );
   int          rx_lazy    = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",    NULL, 7                            );
   long         duration   = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",   NULL, (long)10e9                   );
@@ -482,8 +504,9 @@ main( int     argc,
   fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( wksp );
 
-  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, mux-cnt 1, --rx-cnt %lu, app-sz 64)", tx_cnt, rx_cnt ));
-  ulong   cnc_footprint = fd_cnc_footprint( 64UL ); /* Room for 8 64-bit diagnostic counters */
+  ulong cnc_app_sz = 160UL; /* Room for the in command args and a metric registry describing the 2 tile diagnostics */
+  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, mux-cnt 1, --rx-cnt %lu, app-sz %lu)", tx_cnt, rx_cnt, cnc_app_sz ));
+  ulong   cnc_footprint = fd_cnc_footprint( cnc_app_sz );
   uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), cnc_footprint*(tx_cnt+1UL+rx_cnt) );
   FD_TEST( cnc_mem );
 
@@ -545,6 +568,8 @@ main( int     argc,
   cfg->mux_scratch_mem = mux_scratch_mem;
   cfg->mux_cr_max      = mux_cr_max;
   cfg->mux_lazy        = mux_lazy;
+  cfg->mux_weight      = mux_weight;
+  cfg->mux_idle        = mux_idle;
   cfg->mux_seed        = rng_seq++;
 
   cfg->rx_cnt      = rx_cnt;
@@ -560,7 +585,7 @@ main( int     argc,
 
   for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
     ulong tx_seq0 = fd_rng_ulong( rng );
-    FD_TEST( fd_cnc_new   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint,    64UL, 0UL, now         ) );
+    FD_TEST( fd_cnc_new   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint,    cnc_app_sz, 0UL, now   ) );
     FD_TEST( fd_rng_new   ( cfg->tx_rng_mem    + tx_idx*cfg->tx_rng_footprint,    rng_seq++, 0UL         ) );
     FD_TEST( fd_fseq_new  ( cfg->tx_fseq_mem   + tx_idx*cfg->tx_fseq_footprint,   tx_seq0                ) );
     FD_TEST( fd_mcache_new( cfg->tx_mcache_mem + tx_idx*cfg->tx_mcache_footprint, tx_depth, 0UL, tx_seq0 ) );
@@ -569,11 +594,11 @@ main( int     argc,
   }
 
   ulong mux_seq0 = fd_rng_ulong( rng );
-  FD_TEST( fd_cnc_new   ( cfg->mux_cnc_mem,    64UL, 1UL, now           ) );
+  FD_TEST( fd_cnc_new   ( cfg->mux_cnc_mem,    cnc_app_sz, 1UL, now     ) );
   FD_TEST( fd_mcache_new( cfg->mux_mcache_mem, mux_depth, 0UL, mux_seq0 ) );
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
-    FD_TEST( fd_cnc_new ( cfg->rx_cnc_mem  + rx_idx*cfg->rx_cnc_footprint,  64UL, 2UL, now ) );
+    FD_TEST( fd_cnc_new ( cfg->rx_cnc_mem  + rx_idx*cfg->rx_cnc_footprint,  cnc_app_sz, 2UL, now ) );
     FD_TEST( fd_rng_new ( cfg->rx_rng_mem  + rx_idx*cfg->rx_rng_footprint,  rng_seq++, 0UL ) );
     FD_TEST( fd_fseq_new( cfg->rx_fseq_mem + rx_idx*cfg->rx_fseq_footprint, mux_seq0       ) );
   }
@@ -599,11 +624,46 @@ main( int     argc,
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
     FD_TEST( fd_cnc_wait( cnc[ tile_idx ], FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --mux-cr-max %lu, --mux-lazy %li ns, --rx-lazy %i)",
-                  duration, tx_lazy, mux_cr_max, mux_lazy, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --mux-cr-max %lu, --mux-lazy %li ns, --mux-weight %lu, "
+                  "--mux-idle %i, --rx-lazy %i)", duration, tx_lazy, mux_cr_max, mux_lazy, mux_weight, mux_idle, rx_lazy ));
 
   /* FIXME: DO MONITORING WHILE RUNNING */
-  fd_log_sleep( duration );
+  fd_log_sleep( duration/4L );
+
+  /* Detach tx 0 from the running mux for a while and then reattach it.
+     Redundant commands should be rejected.  tx 0 will be backpressured
+     while detached and should resume cleanly when reattached (checked
+     below by tx 0 getting service and the rxs not seeing overruns). */
+
+  fd_cnc_t * mux_cnc = cnc[ tx_cnt+1UL ];
+  FD_TEST( !fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_DETACH, 0UL,    0UL,                           0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_DETACH, 0UL,    0UL,                           0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_DETACH, tx_cnt, 0UL,                           0UL, 0UL, (long)5e9 ) );
+  fd_log_sleep( duration/4L );
+  FD_TEST(  fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_ATTACH, 0UL,    FD_MUX_TILE_IN_WEIGHT_MAX+1UL, 0UL, 0UL, (long)5e9 ) );
+  FD_TEST( !fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_ATTACH, 0UL,    mux_weight,                    0UL, 0UL, (long)5e9 ) );
+  FD_TEST(  fd_disco_in_cmd( mux_cnc, FD_MUX_CNC_SIGNAL_ATTACH, 0UL,    mux_weight,                    0UL, 0UL, (long)5e9 ) );
+
+  /* The in command args should not have clobbered the tile's metric
+     registry */
+
+  FD_TEST( fd_cnc_metric_find( mux_cnc, "in_backp"  )!=ULONG_MAX );
+  FD_TEST( fd_cnc_metric_find( mux_cnc, "backp_cnt" )!=ULONG_MAX );
+
+  /* Measure the service share of each tx over the rest of the run
+     (after letting tx 0's backlog from being detached settle).  The
+     mux accumulates each in's service into its fseq diagnostics. */
+
+  fd_log_sleep( duration/8L );
+
+  ulong pub_cnt0[ 128 ];
+  for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+    ulong * tx_fseq = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
+    pub_cnt0[ tx_idx ] = FD_VOLATILE_CONST( ((ulong const *)fd_fseq_app_laddr_const( tx_fseq ))[ FD_FSEQ_DIAG_PUB_CNT ] );
+    fd_fseq_leave( tx_fseq );
+  }
+
+  fd_log_sleep( duration - 2L*(duration/4L) - duration/8L );
 
   FD_LOG_NOTICE(( "Halting" ));
 
@@ -624,6 +684,33 @@ main( int     argc,
 
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_cnc_leave( cnc[ tile_idx ] ) );
 
+  /* Report the service share of each tx over the measurement window.
+     Every tx should have gotten some service regardless of the weights
+     (bounded starvation).  The default --mux-cr-max is small relative
+     to --tx-depth such that the mux, not the txs, is the bottleneck
+     (even when the tiles are time sharing a core).  Thus every tx is
+     backlogged and the mux should service each tx in proportion to its
+     weight (tx 0 has weight mux_weight, the rest weight 1). */
+
+  ulong pub_cnt[ 128 ];
+  ulong pub_tot = 0UL;
+  for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+    ulong * tx_fseq = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
+    pub_cnt[ tx_idx ] = ((ulong const *)fd_fseq_app_laddr_const( tx_fseq ))[ FD_FSEQ_DIAG_PUB_CNT ] - pub_cnt0[ tx_idx ];
+    pub_tot += pub_cnt[ tx_idx ];
+    fd_fseq_leave( tx_fseq );
+  }
+  double weight_tot = (double)(mux_weight + tx_cnt - 1UL);
+  for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+    double share    = (double)pub_cnt[ tx_idx ] / (double)pub_tot;
+    double expected = (double)(tx_idx ? 1UL : mux_weight) / weight_tot;
+    FD_LOG_NOTICE(( "tx %lu: pub_cnt %lu (%.3f%% service share, %.3f%% expected)", tx_idx, pub_cnt[ tx_idx ],
+                    100.*share, 100.*expected ));
+    FD_TEST( pub_cnt[ tx_idx ] );
+    if( FD_UNLIKELY( fabs( share-expected )>(double)share_tol ) )
+      FD_LOG_ERR(( "tx %lu service share not within --share-tol %g of its weighted share", tx_idx, (double)share_tol ));
+  }
+
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
@@ -0,0 +1,6 @@
+$(call add-hdrs,fd_rec.h)
+$(call add-objs,fd_rec fd_rec_play,fd_disco)
+$(call make-unit-test,test_rec,test_rec,fd_disco fd_tango fd_util)
+$(call make-unit-test,test_rec_play,test_rec_play,fd_disco fd_tango fd_util)
+$(call make-bin,fd_rec_tile,fd_rec_tile,fd_disco fd_tango fd_util)
+$(call make-bin,fd_rec_play_tile,fd_rec_play_tile,fd_disco fd_tango fd_util)
@@ -0,0 +1,492 @@
+#include "fd_rec.h"
+
+#if FD_HAS_HOSTED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+FD_STATIC_ASSERT( sizeof(fd_rec_t)<=FD_REC_DATA_OFF,                        layout );
+FD_STATIC_ASSERT( sizeof(fd_rec_frag_t)==64UL,                              layout );
+FD_STATIC_ASSERT( sizeof(fd_rec_frag_t)==FD_REC_FRAG_FOOTPRINT( 0UL ),      layout );
+FD_STATIC_ASSERT( !(FD_REC_DATA_OFF & (FD_REC_FRAG_ALIGN-1UL)),             layout );
+
+void *
+fd_rec_new( void * shmem,
+            ulong  sz ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, FD_REC_FRAG_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( sz<(FD_REC_DATA_OFF+FD_REC_FRAG_FOOTPRINT( 0UL )) ) ) {
+    FD_LOG_WARNING(( "sz too small" ));
+    return NULL;
+  }
+
+  fd_rec_t * rec = (fd_rec_t *)shmem;
+
+  fd_memset( rec, 0, sizeof(fd_rec_t) );
+
+  rec->data_max    = fd_ulong_align_dn( sz - FD_REC_DATA_OFF, FD_REC_FRAG_ALIGN );
+  rec->data_sz     = 0UL;
+  rec->rec_cnt     = 0UL;
+  rec->drop_cnt    = 0UL;
+  rec->tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  rec->ts0         = fd_tickcount();
+  rec->wallclock0  = fd_log_wallclock();
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rec->magic ) = FD_REC_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_rec_t *
+fd_rec_join( void * shrec ) {
+
+  if( FD_UNLIKELY( !shrec ) ) {
+    FD_LOG_WARNING(( "NULL shrec" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shrec, FD_REC_FRAG_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned shrec" ));
+    return NULL;
+  }
+
+  fd_rec_t * rec = (fd_rec_t *)shrec;
+
+  if( FD_UNLIKELY( rec->magic!=FD_REC_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return rec;
+}
+
+void *
+fd_rec_leave( fd_rec_t * rec ) {
+
+  if( FD_UNLIKELY( !rec ) ) {
+    FD_LOG_WARNING(( "NULL rec" ));
+    return NULL;
+  }
+
+  return (void *)rec;
+}
+
+void *
+fd_rec_delete( void * shrec ) {
+
+  if( FD_UNLIKELY( !shrec ) ) {
+    FD_LOG_WARNING(( "NULL shrec" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shrec, FD_REC_FRAG_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned shrec" ));
+    return NULL;
+  }
+
+  fd_rec_t * rec = (fd_rec_t *)shrec;
+
+  if( FD_UNLIKELY( rec->magic!=FD_REC_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rec->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shrec;
+}
+
+void *
+fd_rec_file_map( char const * path,
+                 ulong *      _sz,
+                 int          create ) {
+
+  if( FD_UNLIKELY( !path ) ) { FD_LOG_WARNING(( "NULL path" )); return NULL; }
+  if( FD_UNLIKELY( !_sz  ) ) { FD_LOG_WARNING(( "NULL _sz"  )); return NULL; }
+
+  int fd = create ? open( path, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0644 ) : open( path, O_RDONLY );
+  if( FD_UNLIKELY( fd==-1 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\") failed (%i-%s)", path, errno, strerror( errno ) ));
+    return NULL;
+  }
+
+  ulong sz;
+  if( create ) {
+    sz = *_sz;
+    if( FD_UNLIKELY( (!sz) | (sz>(ulong)LONG_MAX) ) ) {
+      FD_LOG_WARNING(( "bad sz for \"%s\"", path ));
+      close( fd );
+      return NULL;
+    }
+
+    /* Preallocate the whole file up front such that the recorder never
+       takes a page fault that needs to allocate file system blocks (or
+       a SIGBUS if the file system is full) in its run loop. */
+
+    int falloc_err = posix_fallocate( fd, (off_t)0, (off_t)sz );
+    if( FD_UNLIKELY( falloc_err ) ) {
+      FD_LOG_WARNING(( "posix_fallocate(\"%s\",%lu) failed (%i-%s)", path, sz, falloc_err, strerror( falloc_err ) ));
+      close( fd );
+      return NULL;
+    }
+  } else {
+    struct stat st[1];
+    if( FD_UNLIKELY( fstat( fd, st ) ) ) {
+      FD_LOG_WARNING(( "fstat(\"%s\") failed (%i-%s)", path, errno, strerror( errno ) ));
+      close( fd );
+      return NULL;
+    }
+    sz = (ulong)st->st_size;
+    if( FD_UNLIKELY( !sz ) ) {
+      FD_LOG_WARNING(( "\"%s\" is empty", path ));
+      close( fd );
+      return NULL;
+    }
+  }
+
+  void * map = mmap( NULL, sz, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, (off_t)0 );
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(\"%s\",%lu) failed (%i-%s)", path, sz, errno, strerror( errno ) ));
+    close( fd );
+    return NULL;
+  }
+
+  /* The mapping keeps the file open so we can close the descriptor */
+
+  if( FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, strerror( errno ) ));
+
+  int err = posix_madvise( map, sz, POSIX_MADV_SEQUENTIAL );
+  if( FD_UNLIKELY( err ) )
+    FD_LOG_WARNING(( "posix_madvise(\"%s\") failed (%i-%s); attempting to continue", path, err, strerror( err ) ));
+
+  *_sz = sz;
+  return map;
+}
+
+void
+fd_rec_file_unmap( void * map,
+                   ulong  sz ) {
+  if( FD_UNLIKELY( !map ) ) return;
+  if( FD_UNLIKELY( munmap( map, sz ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+}
+
+#endif /* FD_HAS_HOSTED */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+int
+fd_rec_tile( fd_cnc_t *             cnc,
+             char const *           rec_path,
+             ulong                  rec_sz,
+             fd_frag_meta_t const * in_mcache,
+             ulong *                in_fseq,
+             void const *           in_base,
+             long                   lazy,
+             fd_rng_t *             rng ) {
+
+  /* cnc state */
+  ulong * cnc_diag;      /* ==fd_cnc_app_laddr( cnc ), local address of the recorder tile cnc diagnostic region */
+  ulong   cnc_diag_full; /* is the capture file full, in [0,1] */
+
+  /* in frag stream state */
+  ulong                  in_depth; /* ==fd_mcache_depth( in_mcache ), depth of the in's mcache */
+  ulong                  in_seq;   /* sequence number of next frag expected from the in */
+  fd_frag_meta_t const * in_mline; /* ==in_mcache + fd_mcache_line_idx( in_seq, in_depth ), location to poll next */
+  uint                   in_accum[6]; /* local diagnostic accumulators, drained during in housekeeping */
+                                      /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+
+  /* capture state */
+  void *     map;      /* location of the capture file mapping in the local address space */
+  ulong      map_sz;   /* size of the capture file mapping */
+  fd_rec_t * rec;      /* ==fd_rec_join( map ) */
+  uchar *    data;     /* ==fd_rec_data_laddr( rec ) */
+  ulong      data_max; /* ==fd_rec_data_max( rec ) */
+  ulong      data_sz;  /* bytes of data holding completed records, committed to rec->data_sz during housekeeping */
+  ulong      rec_cnt;  /* number of completed records, committed to rec->rec_cnt during housekeeping */
+  ulong      drop_cnt; /* number of frags not recorded, committed to rec->drop_cnt during housekeeping */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting rec (rec-sz %lu)", rec_sz ));
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp", FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,    1U },
+      { "full",     FD_CNC_METRIC_TYPE_GAUGE,   FD_REC_CNC_DIAG_FULL,    1U },
+      { "data_sz",  FD_CNC_METRIC_TYPE_COUNTER, FD_REC_CNC_DIAG_DATA_SZ, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* The recorder never backpressures so in_backp is always 0 */
+    cnc_diag[ FD_CNC_DIAG_IN_BACKP      ] = 0UL;
+    cnc_diag[ FD_REC_CNC_DIAG_FULL      ] = 0UL;
+    cnc_diag[ FD_REC_CNC_DIAG_DATA_SZ   ] = 0UL;
+    cnc_diag_full = 0UL;
+
+    /* in frag stream init */
+
+    if( FD_UNLIKELY( !in_mcache ) ) { FD_LOG_WARNING(( "NULL in_mcache" )); return 1; }
+    if( FD_UNLIKELY( !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
+    if( FD_UNLIKELY( !in_base   ) ) { FD_LOG_WARNING(( "NULL in_base"   )); return 1; }
+
+    in_depth = fd_mcache_depth( in_mcache );
+    in_seq   = fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache ) ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    in_accum[0] = 0U; in_accum[1] = 0U; in_accum[2] = 0U;
+    in_accum[3] = 0U; in_accum[4] = 0U; in_accum[5] = 0U;
+
+    /* capture init */
+
+    if( FD_UNLIKELY( !rec_path ) ) { FD_LOG_WARNING(( "NULL rec_path" )); return 1; }
+    if( FD_UNLIKELY( rec_sz<(FD_REC_DATA_OFF+FD_REC_FRAG_FOOTPRINT( 0UL )) ) ) { FD_LOG_WARNING(( "rec_sz too small" )); return 1; }
+
+    FD_LOG_INFO(( "Creating capture file %s", rec_path ));
+    map_sz = rec_sz;
+    map    = fd_rec_file_map( rec_path, &map_sz, 1 );
+    if( FD_UNLIKELY( !map ) ) { FD_LOG_WARNING(( "fd_rec_file_map failed" )); return 1; }
+
+    rec = fd_rec_join( fd_rec_new( map, map_sz ) );
+    if( FD_UNLIKELY( !rec ) ) {
+      FD_LOG_WARNING(( "fd_rec_new failed" ));
+      fd_rec_file_unmap( map, map_sz );
+      return 1;
+    }
+
+    data     = fd_rec_data_laddr( rec );
+    data_max = fd_rec_data_max  ( rec );
+    data_sz  = 0UL;
+    rec_cnt  = 0UL;
+    drop_cnt = 0UL;
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( in_depth );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) {
+      FD_LOG_WARNING(( "bad lazy" ));
+      fd_rec_file_unmap( fd_rec_leave( rec ), map_sz );
+      return 1;
+    }
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running rec" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Commit the records written since the last housekeeping.  The
+         records were written with non-temporal stores so we fence
+         before updating the header to insure a reader following the
+         capture never sees a partially written record. */
+
+      fd_disco_copy_fence();
+      FD_VOLATILE( rec->data_sz  ) = data_sz;
+      FD_VOLATILE( rec->rec_cnt  ) = rec_cnt;
+      FD_VOLATILE( rec->drop_cnt ) = drop_cnt;
+      FD_COMPILER_MFENCE();
+
+      /* Update the in's fseq (the recorder is an unreliable consumer so
+         this is for monitoring only) and drain the in diagnostics */
+
+      fd_fseq_update( in_fseq, in_seq );
+
+      ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+      ulong a0 = (ulong)in_accum[0]; ulong a1 = (ulong)in_accum[1]; ulong a2 = (ulong)in_accum[2];
+      ulong a3 = (ulong)in_accum[3]; ulong a4 = (ulong)in_accum[4]; ulong a5 = (ulong)in_accum[5];
+      FD_COMPILER_MFENCE();
+      diag[0] += a0;                 diag[1] += a1;                 diag[2] += a2;
+      diag[3] += a3;                 diag[4] += a4;                 diag[5] += a5;
+      FD_COMPILER_MFENCE();
+      in_accum[0] = 0U;              in_accum[1] = 0U;              in_accum[2] = 0U;
+      in_accum[3] = 0U;              in_accum[4] = 0U;              in_accum[5] = 0U;
+
+      /* Send diagnostic info */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_REC_CNC_DIAG_FULL    ] = cnc_diag_full;
+      cnc_diag[ FD_REC_CNC_DIAG_DATA_SZ ] = data_sz;
+      FD_COMPILER_MFENCE();
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_REC_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Record up to a batch worth of new in frags.  We stop the batch
+       early if the in is caught up. */
+
+    ulong batch_cnt = 0UL;
+    for( ulong poll_rem=FD_REC_TILE_BATCH_MAX; poll_rem; poll_rem-- ) {
+
+      /* Check if the in has a new fragment to record */
+
+      FD_COMPILER_MFENCE();
+      ulong seq_found = in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      long diff = fd_seq_diff( in_seq, seq_found );
+      if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+        if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (the in does not know about us so this is possible) */
+          drop_cnt += (ulong)-diff;
+          in_seq    = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
+          in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+        }
+        break;
+      }
+
+      /* We have a new fragment to record.  Try to load its metadata. */
+
+      fd_rec_frag_t hdr[1];
+
+      FD_COMPILER_MFENCE();
+      hdr->meta.sig    =         in_mline->sig;
+      hdr->meta.chunk  =         in_mline->chunk;
+      hdr->meta.sz     =         in_mline->sz;
+      hdr->meta.ctl    =         in_mline->ctl;
+      hdr->meta.tsorig =         in_mline->tsorig;
+      hdr->meta.tspub  =         in_mline->tspub;
+      FD_COMPILER_MFENCE();
+      ulong seq_test   =         in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading */
+        drop_cnt += (ulong)fd_seq_diff( seq_test, in_seq );
+        in_seq    = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
+        in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+        in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+        break;
+      }
+
+      /* Append the record to the capture if there is room.  The payload
+         is copied first such that we can check we weren't overrun while
+         copying before writing the record header (if we were, the
+         partial record past data_sz will be overwritten by the next
+         record). */
+
+      ulong sz            = (ulong)hdr->meta.sz;
+      ulong footprint     = FD_REC_FRAG_FOOTPRINT( sz );
+      ulong should_filter = cnc_diag_full | (ulong)(footprint>(data_max-data_sz)); /* Once full, stay full (no gaps) */
+
+      if( FD_LIKELY( !should_filter ) ) {
+        uchar * dst = data + data_sz;
+        fd_disco_copy_nt( dst + sizeof(fd_rec_frag_t), fd_chunk_to_laddr_const( in_base, (ulong)hdr->meta.chunk ), sz );
+
+        seq_test = fd_frag_meta_seq_query( in_mline );
+        if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while copying */
+          drop_cnt += (ulong)fd_seq_diff( seq_test, in_seq );
+          in_seq    = seq_test;
+          in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+          break;
+        }
+
+        hdr->meta.seq  = seq_found;
+        hdr->ts        = fd_frag_meta_ts_decomp( (ulong)hdr->meta.tspub, now );
+        hdr->footprint = footprint;
+        hdr->_pad[0]   = 0UL;
+        hdr->_pad[1]   = 0UL;
+        fd_disco_copy_nt( dst, hdr, sizeof(fd_rec_frag_t) );
+
+        data_sz += footprint;
+        rec_cnt++;
+      } else {
+        cnc_diag_full = 1UL;
+        drop_cnt++;
+      }
+
+      /* Windup for the next in poll and accumulate diagnostics */
+
+      in_seq   = fd_seq_inc( in_seq, 1UL );
+      in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+      ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + should_filter*2UL;
+      in_accum[ diag_idx     ]++;
+      in_accum[ diag_idx+1UL ] += (uint)sz;
+
+      batch_cnt++;
+    }
+
+    if( FD_UNLIKELY( !batch_cnt ) ) FD_SPIN_PAUSE(); /* Optimize for recording under load */
+    now = fd_tickcount();
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting rec" ));
+
+    /* Commit the remaining records and drain the diagnostics */
+
+    fd_disco_copy_fence();
+    FD_VOLATILE( rec->data_sz  ) = data_sz;
+    FD_VOLATILE( rec->rec_cnt  ) = rec_cnt;
+    FD_VOLATILE( rec->drop_cnt ) = drop_cnt;
+    FD_COMPILER_MFENCE();
+
+    fd_fseq_update( in_fseq, in_seq );
+    ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+    FD_COMPILER_MFENCE();
+    for( ulong diag_idx=0UL; diag_idx<6UL; diag_idx++ ) diag[ diag_idx ] += (ulong)in_accum[ diag_idx ];
+    cnc_diag[ FD_REC_CNC_DIAG_FULL    ] = cnc_diag_full;
+    cnc_diag[ FD_REC_CNC_DIAG_DATA_SZ ] = data_sz;
+    FD_COMPILER_MFENCE();
+
+    FD_LOG_INFO(( "Closing capture file (%lu records, %lu bytes, %lu dropped)", rec_cnt, data_sz, drop_cnt ));
+    fd_rec_file_unmap( fd_rec_leave( rec ), map_sz );
+
+    FD_LOG_INFO(( "Halted rec" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,391 @@
+#ifndef HEADER_fd_src_disco_rec_fd_rec_h
+#define HEADER_fd_src_disco_rec_fd_rec_h
+
+/* fd_rec provides services to record a tango fragment stream (full
+   fragment metadata _and_ payloads) to a memory mapped capture file
+   for offline analysis and replay.  The recorder is an unreliable
+   consumer such that it can be attached to any point of a production
+   pipeline without ever backpressuring the producer.
+
+   A capture file has the layout:
+
+     [0,FD_REC_DATA_OFF)       fd_rec_t header (followed by padding)
+     [FD_REC_DATA_OFF,...)     data region of data_max bytes, the first
+                               data_sz of which are consecutive records
+
+   and each record has the layout:
+
+     fd_rec_frag_t             64 byte record header (the frag metadata
+                               as observed in the mcache and a full
+                               resolution publication timestamp)
+     payload                   sz bytes of frag payload, padded to a
+                               multiple of FD_REC_FRAG_ALIGN
+
+   Everything is stored in the native (little endian) byte order.  The
+   file is preallocated at its full size when the recording starts such
+   that the recorder never needs to extend the file while running.
+
+   fd_rec_play_tile plays a capture back into a mcache / dcache pair
+   with production identical frag metadata and optionally with the
+   recorded timing (to give reproducible, time accurate load for
+   benchmarking individual pipeline stages). */
+
+#include "../fd_disco_base.h"
+
+#if FD_HAS_HOSTED
+
+/* FD_REC_MAGIC is a magic number identifying a capture file */
+
+#define FD_REC_MAGIC (0xf17eda2c3772ec00UL) /* firedancer rec ver 0 */
+
+/* FD_REC_DATA_OFF is the byte offset of the data region in a capture
+   file (a normal page such that the data region is page aligned in the
+   mapping).  FD_REC_FRAG_ALIGN is the alignment of records in the data
+   region.  FD_REC_FRAG_FOOTPRINT( sz ) is the footprint of a record of
+   a sz byte frag.  sz is assumed to be at most USHORT_MAX. */
+
+#define FD_REC_DATA_OFF                  (4096UL)
+#define FD_REC_FRAG_ALIGN                (64UL)
+#define FD_REC_FRAG_FOOTPRINT( sz )      (64UL + (((sz) + FD_REC_FRAG_ALIGN-1UL) & ~(FD_REC_FRAG_ALIGN-1UL)))
+
+struct __attribute__((aligned(64))) fd_rec_private {
+  ulong  magic;       /* == FD_REC_MAGIC */
+  ulong  data_max;    /* Size of the data region in bytes, multiple of FD_REC_FRAG_ALIGN */
+  ulong  data_sz;     /* Bytes of the data region holding completed records, in [0,data_max], multiple of FD_REC_FRAG_ALIGN */
+  ulong  rec_cnt;     /* Number of completed records */
+  ulong  drop_cnt;    /* Number of frags the recorder observed but could not record (overruns and frags after the file
+                         filled up) */
+  double tick_per_ns; /* fd_tempo_tick_per_ns of the recording host (for interpreting ts and tsorig/tspub) */
+  long   ts0;         /* fd_tickcount when the recording started */
+  long   wallclock0;  /* fd_log_wallclock when the recording started */
+};
+
+typedef struct fd_rec_private fd_rec_t;
+
+struct __attribute__((aligned(FD_REC_FRAG_ALIGN))) fd_rec_frag {
+  fd_frag_meta_t meta;      /* Metadata as observed in the mcache, meta.seq is the frag's sequence number in the recorded
+                               stream, meta.chunk is meaningless */
+  long           ts;        /* meta.tspub decompressed to a full resolution fd_tickcount */
+  ulong          footprint; /* == FD_REC_FRAG_FOOTPRINT( meta.sz ) */
+  ulong          _pad[2];
+};
+
+typedef struct fd_rec_frag fd_rec_frag_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_rec_new formats a sz byte memory region (e.g. a mapping of a
+   capture file) as an empty capture.  shmem should be aligned to a
+   FD_REC_FRAG_ALIGN boundary and sz should be large enough for at least
+   the header and one record.  Returns shmem on success and NULL on
+   failure (logs details).  fd_rec_join joins a formatted region and
+   returns a pointer to its header (NULL on failure, logs details).
+   fd_rec_leave / fd_rec_delete are the usual inverses.  A capture
+   mapped read only can be joined (the join will not write to it) but
+   then obviously should not be written through the join. */
+
+void *
+fd_rec_new( void * shmem,
+            ulong  sz );
+
+fd_rec_t *
+fd_rec_join( void * shrec );
+
+void *
+fd_rec_leave( fd_rec_t * rec );
+
+void *
+fd_rec_delete( void * shrec );
+
+/* Accessors.  fd_rec_data_laddr{_const} return the location of the
+   first byte of rec's data region in the caller's address space. */
+
+FD_FN_PURE static inline ulong fd_rec_data_max ( fd_rec_t const * rec ) { return rec->data_max; }
+FD_FN_PURE static inline ulong fd_rec_data_sz  ( fd_rec_t const * rec ) { return FD_VOLATILE_CONST( rec->data_sz  ); }
+FD_FN_PURE static inline ulong fd_rec_rec_cnt  ( fd_rec_t const * rec ) { return FD_VOLATILE_CONST( rec->rec_cnt  ); }
+FD_FN_PURE static inline ulong fd_rec_drop_cnt ( fd_rec_t const * rec ) { return FD_VOLATILE_CONST( rec->drop_cnt ); }
+
+FD_FN_CONST static inline uchar const * fd_rec_data_laddr_const( fd_rec_t const * rec ) { return ((uchar const *)rec) + FD_REC_DATA_OFF; }
+FD_FN_CONST static inline uchar *       fd_rec_data_laddr      ( fd_rec_t *       rec ) { return ((uchar *)      rec) + FD_REC_DATA_OFF; }
+
+/* fd_rec_frag_{first,next} iterate over the completed records in a
+   capture in recording order.  first returns the first record (NULL if
+   there are none) and next returns the record after frag (NULL if frag
+   is the last).  Records that would extend past the completed data
+   region (i.e. a corrupt capture) end the iteration.  A typical
+   iteration:
+
+     for( fd_rec_frag_t const * frag = fd_rec_frag_first( rec ); frag; frag = fd_rec_frag_next( rec, frag ) ) {
+       ... frag->meta has the frag metadata
+       ... fd_rec_frag_payload( frag ) has the frag->meta.sz payload bytes
+     }
+
+   data_sz is sampled on every call so a capture that is still being
+   recorded can be followed. */
+
+static inline fd_rec_frag_t const *
+fd_rec_frag_next_at( fd_rec_t const * rec,
+                     ulong            off ) {
+  ulong data_sz = fd_rec_data_sz( rec );
+  if( FD_UNLIKELY( (off+sizeof(fd_rec_frag_t))>data_sz ) ) return NULL;
+  fd_rec_frag_t const * frag = (fd_rec_frag_t const *)(fd_rec_data_laddr_const( rec ) + off);
+  ulong footprint = frag->footprint;
+  if( FD_UNLIKELY( (footprint!=FD_REC_FRAG_FOOTPRINT( (ulong)frag->meta.sz )) | ((off+footprint)>data_sz) ) ) return NULL;
+  return frag;
+}
+
+static inline fd_rec_frag_t const *
+fd_rec_frag_first( fd_rec_t const * rec ) {
+  return fd_rec_frag_next_at( rec, 0UL );
+}
+
+static inline fd_rec_frag_t const *
+fd_rec_frag_next( fd_rec_t const *      rec,
+                  fd_rec_frag_t const * frag ) {
+  ulong off = (ulong)frag - (ulong)fd_rec_data_laddr_const( rec );
+  return fd_rec_frag_next_at( rec, off + frag->footprint );
+}
+
+FD_FN_CONST static inline uchar const *
+fd_rec_frag_payload( fd_rec_frag_t const * frag ) {
+  return (uchar const *)(frag+1);
+}
+
+/* fd_rec_file_map memory maps the capture file at path.  If create is
+   non-zero, the file will be created (or truncated if it already
+   exists), preallocated to *_sz bytes and mapped read-write.
+   Otherwise, the existing file will be mapped read-only and *_sz will
+   be set to its size.  The mapping is advised for sequential access.
+   Returns the location of the mapping in the caller's address space on
+   success and NULL on failure (logs details).  fd_rec_file_unmap
+   unmaps a sz byte mapping returned by fd_rec_file_map (any changes
+   made to a read-write mapping are written back to the file). */
+
+void *
+fd_rec_file_map( char const * path,
+                 ulong *      _sz,
+                 int          create );
+
+void
+fd_rec_file_unmap( void * map,
+                   ulong  sz );
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_HOSTED */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_REC_CNC_SIGNAL_ACK can be
+   raised by a cnc thread with an open command session while the
+   recorder is in the RUN state.  The recorder will transition from
+   ACK->RUN the next time it processes cnc signals to indicate it is
+   running normally.  If a signal other than ACK, HALT, or RUN is
+   raised, it will be logged as unexpected and transitioned by back to
+   RUN. */
+
+#define FD_REC_CNC_SIGNAL_ACK (4UL)
+
+/* A fd_rec_tile will use the fseq and cnc application regions to
+   accumulate diagnostics in the standard ways.  Frags recorded are
+   accumulated to the in fseq's PUB_{CNT,SZ}, frags that could not be
+   recorded because the capture file is full are accumulated to its
+   FILT_{CNT,SZ} and overruns are accumulated to its OVRNP_CNT and
+   OVRNR_CNT.  It additionally will accumulate to the cnc application
+   region the following tile specific counters:
+
+     FULL    is cleared when the tile starts recording and set when the
+             capture file has filled up
+     DATA_SZ is the number of bytes of the capture file data region
+             holding completed records
+
+   As such, the cnc app region must be at least 64B in size. */
+
+#define FD_REC_CNC_DIAG_FULL    (2UL) /* On 1st cache line of app region, updated by producer, rarely */
+#define FD_REC_CNC_DIAG_DATA_SZ (3UL) /* ", frequently */
+
+/* FD_REC_TILE_BATCH_MAX is the maximum number of frags the recorder
+   will record between checking for housekeeping. */
+
+#define FD_REC_TILE_BATCH_MAX (64UL)
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_rec_tile records the fragment stream described by in_mcache (with
+   payloads at chunk addresses relative to in_base) into a newly created
+   rec_sz byte capture file at rec_path.
+
+   The recorder is an unreliable consumer.  It never returns flow
+   control credits to the in producer (it is fine for in_fseq to not be
+   one of the producer's reliable consumers) and thus can never
+   backpressure it.  If the recorder falls behind the producer, the
+   overrun is counted and the recorder resumes from the most recent
+   frag.  Frags that were overrun while their payload was being copied
+   are discarded.  Records are appended sequentially to the capture with
+   non-temporal stores (such that recording does not pollute the
+   recorder core's caches) and are committed to the capture header in
+   batches during housekeeping (a reader following a live capture sees
+   completed records only).  When the capture is full, the recorder
+   stops recording (later frags are counted as filtered) but keeps
+   consuming such that its diagnostics remain meaningful.
+
+   lazy is the ballpark interval in ns for how often to commit records
+   and do housekeeping.  <=0 indicates to pick a conservative default.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the recorder tile (see fd_mux_tile for details
+   of the cnc state transitions).  Returns a non-zero error code if the
+   tile fails to boot up (logs details).  The capture file will have
+   all the records committed by the time the tile returns.
+
+   The lifetime of the cnc, in_mcache, in_fseq and rng used by this tile
+   should be a superset of this tile's lifetime.  While this tile is
+   running, no other tile should use cnc for its command and control,
+   update in_fseq, or use the rng for anything (and the rng should be
+   seeded distinctly from all other rngs in the system).  rec_path will
+   not be used after the tile has successfully booted (transitioned the
+   cnc from BOOT to RUN) or returned (e.g. failed to boot), whichever
+   comes first. */
+
+int
+fd_rec_tile( fd_cnc_t *             cnc,       /* Local join to the recorder's command-and-control */
+             char const *           rec_path,  /* Points to first byte of cstr with the path of the capture file to create */
+             ulong                  rec_sz,    /* Size of the capture file to preallocate in bytes */
+             fd_frag_meta_t const * in_mcache, /* Local join to the in's mcache */
+             ulong *                in_fseq,   /* Local join to the recorder's fseq for the in (diagnostics only) */
+             void const *           in_base,   /* Local address of the in's chunk 0 (e.g. the wksp containing the in's dcache) */
+             long                   lazy,      /* Lazyiness, <=0 means use a reasonable default */
+             fd_rng_t *             rng );     /* Local join to the rng this recorder should use */
+
+FD_PROTOTYPES_END
+
+/* A fd_rec_play_tile will use the fseq and cnc application regions to
+   accumulate flow control diagnostics in the standard ways.  It
+   additionally will accumulate to the cnc application region the
+   following tile specific counters:
+
+     DONE     is cleared before the tile starts playing the capture and
+              is set when all the records have been played
+     PUB_CNT  is the number of frags published by the player
+     PUB_SZ   is the number of frag payload bytes published by the
+              player
+     FILT_CNT is the number of recorded frags filtered by the player
+              (e.g. too large for the player's mtu)
+     FILT_SZ  is the number of recorded frag payload bytes filtered by
+              the player
+     LATE_CNT is the number of frags published after their scheduled
+              time by more than a housekeeping interval (always 0 when
+              playing as fast as possible)
+
+   As such, the cnc app region must be at least 64B in size.  Except
+   for IN_BACKP and DONE, none of the diagnostics are cleared at tile
+   startup. */
+
+#define FD_REC_PLAY_CNC_DIAG_DONE     (2UL) /* On 1st cache line of app region, updated by producer, rarely */
+#define FD_REC_PLAY_CNC_DIAG_PUB_CNT  (3UL) /* ", frequently */
+#define FD_REC_PLAY_CNC_DIAG_PUB_SZ   (4UL) /* ", frequently */
+#define FD_REC_PLAY_CNC_DIAG_FILT_CNT (5UL) /* ", rarely */
+#define FD_REC_PLAY_CNC_DIAG_FILT_SZ  (6UL) /* ", rarely */
+#define FD_REC_PLAY_CNC_DIAG_LATE_CNT (7UL) /* ", rarely */
+
+/* FD_REC_PLAY_TILE_OUT_MAX is the maximum number of reliable consumers
+   a player tile can have (see FD_REPLAY_TILE_OUT_MAX).
+
+   FD_REC_PLAY_TILE_BATCH_MAX is the maximum number of frags a player
+   will copy before making them visible to consumers.  Like the relay,
+   payloads are written with non-temporal stores and a batch amortizes
+   the store fence needed before publishing over several frags.  The
+   player's dcache should be sized for this many frags in preparation
+   (see fd_rec_play_tile below).
+
+   FD_REC_PLAY_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for a player tile scratch region that can support
+   out_cnt reliable consumers.  Usual conventions apply. */
+
+#define FD_REC_PLAY_TILE_OUT_MAX   FD_FRAG_META_ORIG_MAX
+#define FD_REC_PLAY_TILE_BATCH_MAX (16UL)
+
+#define FD_REC_PLAY_TILE_SCRATCH_ALIGN (128UL)
+#define FD_REC_PLAY_TILE_SCRATCH_FOOTPRINT( out_cnt )                              \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,              \
+    FD_FCTL_ALIGN,           FD_FCTL_FOOTPRINT( (out_cnt) )                    ), \
+    alignof(fd_frag_meta_t), FD_REC_PLAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) ), \
+    FD_REC_PLAY_TILE_SCRATCH_ALIGN )
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_rec_play_tile plays back the capture file at rec_path as a tango
+   fragment stream into the given mcache and dcache.  The tile can send
+   to out_cnt reliable consumers and an arbitrary number of unreliable
+   consumers.
+
+   The sig, sz and ctl (including the origin and the som / eom / err
+   bits) of played frags are exactly as recorded such that downstream
+   tiles (e.g. dedup and pack) see production identical traffic.  chunk
+   will be the location of the payload copy in dcache (indexed relative
+   to the wksp containing the dcache).  The played stream has its own
+   sequence space (starting from mcache's sequence number at boot).
+   tspub will be the time of publication and tsorig will be such that
+   the time between the frag's origin and its publication is the same as
+   in the recording.  Recorded frags larger than mtu are filtered.  The
+   dcache should have room for at least fd_dcache_req_data_sz( mtu,
+   mcache.depth, FD_REC_PLAY_TILE_BATCH_MAX, 1 ) bytes of compactly
+   stored payloads.
+
+   pace selects the timing of the playback.  If pace is zero, frags are
+   played as fast as possible (subject to flow control).  Otherwise, a
+   frag that was published dt ns after the first recorded frag is
+   published pace*dt ns after the player started playing.  E.g. 1
+   reproduces the recorded timing, 0.5 plays back at twice the recorded
+   rate and 2 at half the recorded rate.  The player never publishes a
+   frag before its scheduled time.  If it falls behind schedule (e.g.
+   because of backpressure), it publishes frags as fast as it can until
+   it catches up and counts the frags published late.  pace should be a
+   finite non-negative value.
+
+   cr_max and lazy have the same meaning as in fd_replay_tile.  lazy
+   also bounds how precisely frags are published at their scheduled
+   times.  <=0 indicates to pick a conservative default.
+
+   scratch points to tile scratch memory.  fd_rec_play_tile_scratch_align
+   and fd_rec_play_tile_scratch_footprint return the required alignment
+   and footprint needed for this region (see fd_replay_tile for details).
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the player tile (see fd_replay_tile for details
+   of the cnc state transitions).  Returns a non-zero error code if the
+   tile fails to boot up (logs details).  When the whole capture has
+   been played, the tile sets the DONE diagnostic and idles until halted.
+
+   The lifetime of the cnc, mcache, dcache, out_fseq[*], rng and scratch
+   used by this tile should be a superset of this tile's lifetime (see
+   fd_replay_tile for details).  The out_fseq array and rec_path cstr
+   will not be used the after the tile has successfully booted
+   (transitioned the cnc from BOOT to RUN) or returned (e.g. failed to
+   boot), whichever comes first. */
+
+FD_FN_CONST ulong
+fd_rec_play_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_rec_play_tile_scratch_footprint( ulong out_cnt );
+
+int
+fd_rec_play_tile( fd_cnc_t *       cnc,       /* Local join to the player's command-and-control */
+                  char const *     rec_path,  /* Points to first byte of cstr with the path of the capture file to play */
+                  ulong            mtu,       /* Maximum size frag the player can publish */
+                  float            pace,      /* Playback pacing, 0 means as fast as possible, 1 means recorded timing */
+                  fd_frag_meta_t * mcache,    /* Local join to the player's frag stream output mcache */
+                  uchar *          dcache,    /* Local join to the player's frag stream output dcache */
+                  ulong            out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+                  ulong **         out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+                  ulong            cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
+                  long             lazy,      /* Lazyiness, <=0 means use a reasonable default */
+                  fd_rng_t *       rng,       /* Local join to the rng this player should use */
+                  void *           scratch ); /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif
+
+#endif /* HEADER_fd_src_disco_rec_fd_rec_h */
@@ -0,0 +1,417 @@
+#include "fd_rec.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <float.h>
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+FD_STATIC_ASSERT( FD_FCTL_ALIGN         <=FD_REC_PLAY_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( alignof(fd_frag_meta_t)<=FD_REC_PLAY_TILE_SCRATCH_ALIGN, packing );
+
+ulong
+fd_rec_play_tile_scratch_align( void ) {
+  return FD_REC_PLAY_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_rec_play_tile_scratch_footprint( ulong out_cnt ) {
+  if( FD_UNLIKELY( out_cnt>FD_REC_PLAY_TILE_OUT_MAX ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( fd_fctl_align(),         fd_fctl_footprint( out_cnt )                       ); /* fctl */
+  SCRATCH_ALLOC( alignof(fd_frag_meta_t), FD_REC_PLAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) ); /* batch */
+  return fd_ulong_align_up( scratch_top, fd_rec_play_tile_scratch_align() );
+}
+
+int
+fd_rec_play_tile( fd_cnc_t *       cnc,
+                  char const *     rec_path,
+                  ulong            mtu,
+                  float            pace,
+                  fd_frag_meta_t * mcache,
+                  uchar *          dcache,
+                  ulong            out_cnt,
+                  ulong **         out_fseq,
+                  ulong            cr_max,
+                  long             lazy,
+                  fd_rng_t *       rng,
+                  void *           scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the player tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  ulong   cnc_diag_done;      /* has the whole capture been played */
+  ulong   cnc_diag_pub_cnt;   /* Accumulates number of frags published between housekeeping events */
+  ulong   cnc_diag_pub_sz;    /* Accumulates payload bytes published between housekeeping events */
+  ulong   cnc_diag_filt_cnt;  /* Accumulates number of recorded frags filtered between housekeeping events */
+  ulong   cnc_diag_filt_sz;   /* Accumulates recorded payload bytes filtered between housekeeping events */
+  ulong   cnc_diag_late_cnt;  /* Accumulates number of frags published late between housekeeping events */
+
+  /* in capture state */
+  void *                map;        /* location of the capture file mapping in the local address space */
+  ulong                 map_sz;     /* size of the capture file mapping */
+  fd_rec_t const *      rec;        /* ==fd_rec_join( map ) */
+  fd_rec_frag_t const * frag;       /* next record to play, NULL if the capture has been played */
+  int                   paced;      /* 0 if playing as fast as possible, 1 if playing with recorded timing */
+  double                tick_scale; /* ratio of this host's tick rate to the recording host's tick rate */
+  double                pace_scale; /* ==pace*tick_scale, converts recorded ticks since ts0 into local ticks since play0 */
+  long                  ts0;        /* recorded ts of the first record */
+  long                  play0;      /* local tickcount when the first record was played */
+  long                  late_min;   /* frags published more than this many ticks after their scheduled time are late */
+
+  /* out frag stream state */
+  ulong            depth;  /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
+  ulong *          sync;   /* ==fd_mcache_seq_laddr( mcache ), local addr where player mcache sync info is published */
+  ulong            seq;    /* next player frag sequence number to publish */
+  void *           base;   /* ==fd_wksp_containing( dcache ), chunk reference address in the tile's local address space */
+  ulong            chunk0; /* ==fd_dcache_compact_chunk0( base, dcache ) */
+  ulong            wmark;  /* ==fd_dcache_compact_wmark ( base, dcache, mtu ), payload chunks start in [chunk0,wmark] */
+  ulong            chunk;  /* Chunk where next payload will be copied, in [chunk0,wmark] */
+  fd_frag_meta_t * batch;  /* batch[batch_idx] for batch_idx in [0,FD_REC_PLAY_TILE_BATCH_MAX) is the metadata for a copied
+                              frag awaiting publication */
+
+  /* flow control state */
+  fd_fctl_t * fctl;     /* output flow control */
+  ulong       cr_avail; /* number of flow control credits available to publish downstream, in [0,cr_max] */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting rec play (out-cnt %lu)", out_cnt ));
+    if( FD_UNLIKELY( out_cnt>FD_REC_PLAY_TILE_OUT_MAX ) ) { FD_LOG_WARNING(( "out_cnt too large" )); return 1; }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_rec_play_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,          1U },
+      { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT,         1U },
+      { "done",      FD_CNC_METRIC_TYPE_GAUGE,   FD_REC_PLAY_CNC_DIAG_DONE,     1U },
+      { "pub_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_REC_PLAY_CNC_DIAG_PUB_CNT,  1U },
+      { "pub_sz",    FD_CNC_METRIC_TYPE_COUNTER, FD_REC_PLAY_CNC_DIAG_PUB_SZ,   1U },
+      { "filt_cnt",  FD_CNC_METRIC_TYPE_COUNTER, FD_REC_PLAY_CNC_DIAG_FILT_CNT, 1U },
+      { "filt_sz",   FD_CNC_METRIC_TYPE_COUNTER, FD_REC_PLAY_CNC_DIAG_FILT_SZ,  1U },
+      { "late_cnt",  FD_CNC_METRIC_TYPE_COUNTER, FD_REC_PLAY_CNC_DIAG_LATE_CNT, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
+       cleared during first housekeeping if credits available */
+    cnc_diag_in_backp  = 1UL;
+    cnc_diag_backp_cnt = 0UL;
+    cnc_diag_done      = 0UL;
+    cnc_diag_pub_cnt   = 0UL;
+    cnc_diag_pub_sz    = 0UL;
+    cnc_diag_filt_cnt  = 0UL;
+    cnc_diag_filt_sz   = 0UL;
+    cnc_diag_late_cnt  = 0UL;
+
+    /* out frag stream init (done before opening the capture such that
+       there is nothing to clean up on failure) */
+
+    if( FD_UNLIKELY( !mcache ) ) { FD_LOG_WARNING(( "NULL mcache" )); return 1; }
+    if( FD_UNLIKELY( !dcache ) ) { FD_LOG_WARNING(( "NULL dcache" )); return 1; }
+    if( FD_UNLIKELY( !mtu    ) ) { FD_LOG_WARNING(( "mtu must be positive" )); return 1; }
+
+    depth = fd_mcache_depth    ( mcache );
+    sync  = fd_mcache_seq_laddr( mcache );
+
+    seq = fd_mcache_seq_query( sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION */
+
+    base = fd_wksp_containing( dcache );
+    if( FD_UNLIKELY( !base ) ) { FD_LOG_WARNING(( "fd_wksp_containing failed" )); return 1; }
+
+    /* As in the relay, a batch being copied is not yet visible in the
+       mcache so the dcache needs room for a full batch in preparation. */
+
+    if( FD_UNLIKELY( !fd_dcache_compact_is_safe( base, dcache, mtu, depth+FD_REC_PLAY_TILE_BATCH_MAX-1UL ) ) ) {
+      FD_LOG_WARNING(( "dcache not compatible with wksp base, mtu and mcache depth" ));
+      return 1;
+    }
+
+    chunk0 = fd_dcache_compact_chunk0( base, dcache );
+    wmark  = fd_dcache_compact_wmark ( base, dcache, mtu );
+    chunk  = chunk0;
+
+    /* out flow control init */
+
+    if( FD_UNLIKELY( !!out_cnt && !out_fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq" )); return 1; }
+
+    fctl = fd_fctl_join( fd_fctl_new( SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ), out_cnt ) );
+    if( FD_UNLIKELY( !fctl ) ) { FD_LOG_WARNING(( "join failed" )); return 1; }
+
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+
+      ulong * fseq = out_fseq[ out_idx ];
+      if( FD_UNLIKELY( !fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq[%lu]", out_idx )); return 1; }
+      ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
+
+      /* Assumes lag_max==depth */
+      if( FD_UNLIKELY( !fd_fctl_cfg_rx_add( fctl, depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) ) ) {
+        FD_LOG_WARNING(( "fd_fctl_cfg_rx_add failed" ));
+        return 1;
+      }
+    }
+
+    /* cr_burst is BATCH_MAX because we publish up to a batch between
+       checking cr_avail.  (The run loop never publishes more than
+       cr_avail frags in a batch but fctl needs to know the burst to
+       compute sane defaults.) */
+
+    if( FD_UNLIKELY( !fd_fctl_cfg_done( fctl, FD_REC_PLAY_TILE_BATCH_MAX, cr_max, 0UL, 0UL ) ) ) {
+      FD_LOG_WARNING(( "fd_fctl_cfg_done failed" ));
+      return 1;
+    }
+    FD_LOG_INFO(( "cr_burst %lu cr_max %lu cr_resume %lu cr_refill %lu",
+                  fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
+
+    cr_max   = fd_fctl_cr_max( fctl );
+    cr_avail = 0UL; /* Will be initialized by run loop */
+
+    batch = (fd_frag_meta_t *)SCRATCH_ALLOC( alignof(fd_frag_meta_t), FD_REC_PLAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) );
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( cr_max );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)tick_per_ns );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+    /* in capture init */
+
+    if( FD_UNLIKELY( !((pace>=0.f) & (pace<=FLT_MAX)) ) ) { FD_LOG_WARNING(( "pace must be finite and non-negative" )); return 1; }
+    if( FD_UNLIKELY( !rec_path ) ) { FD_LOG_WARNING(( "NULL rec_path" )); return 1; }
+
+    FD_LOG_INFO(( "Opening capture %s (mtu %lu, pace %g)", rec_path, mtu, (double)pace ));
+    map_sz = 0UL;
+    map    = fd_rec_file_map( rec_path, &map_sz, 0 );
+    if( FD_UNLIKELY( !map ) ) { FD_LOG_WARNING(( "fd_rec_file_map failed" )); return 1; }
+
+    rec = fd_rec_join( map );
+    if( FD_UNLIKELY( !rec ) ) {
+      FD_LOG_WARNING(( "fd_rec_join failed" ));
+      fd_rec_file_unmap( map, map_sz );
+      return 1;
+    }
+
+    if( FD_UNLIKELY( (FD_REC_DATA_OFF+fd_rec_data_max( rec ))>map_sz ) ) {
+      FD_LOG_WARNING(( "capture truncated" ));
+      fd_rec_file_unmap( map, map_sz );
+      return 1;
+    }
+
+    frag = fd_rec_frag_first( rec );
+    FD_LOG_INFO(( "Capture has %lu records (%lu bytes, %lu dropped while recording)",
+                  fd_rec_rec_cnt( rec ), fd_rec_data_sz( rec ), fd_rec_drop_cnt( rec ) ));
+
+    /* Recorded timestamps are in the recording host's ticks so we
+       convert them to ours.  Pacing uses double precision such that
+       captures spanning long durations are played accurately. */
+
+    double rec_tick_per_ns = rec->tick_per_ns;
+    tick_scale = (rec_tick_per_ns>0.) ? (tick_per_ns / rec_tick_per_ns) : 1.;
+    pace_scale = ((double)pace)*tick_scale;
+    paced      = (pace>0.f);
+    ts0        = frag ? frag->ts : 0L;
+    play0      = 0L; /* Set when the tile starts running */
+    late_min   = (long)async_min;
+
+    FD_COMPILER_MFENCE();
+    cnc_diag[ FD_REC_PLAY_CNC_DIAG_DONE ] = 0UL; /* Clear before entering running state */
+    FD_COMPILER_MFENCE();
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running rec play" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  play0 = now;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Send synchronization info */
+      fd_mcache_seq_update( sync, seq );
+
+      /* Send diagnostic info */
+      /* When we drain, we don't do a fully atomic update of the
+         diagnostics as it is only diagnostic and it will still be
+         correct the usual case where individual diagnostic counters
+         aren't used by multiple writers spread over different threads
+         of execution. */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_CNC_DIAG_IN_BACKP            ]  = cnc_diag_in_backp;
+      cnc_diag[ FD_CNC_DIAG_BACKP_CNT           ] += cnc_diag_backp_cnt;
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_PUB_CNT    ] += cnc_diag_pub_cnt;
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_PUB_SZ     ] += cnc_diag_pub_sz;
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_FILT_CNT   ] += cnc_diag_filt_cnt;
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_FILT_SZ    ] += cnc_diag_filt_sz;
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_LATE_CNT   ] += cnc_diag_late_cnt;
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_REC_PLAY_CNC_DIAG_DONE       ]  = cnc_diag_done; /* After the counters such that DONE implies final counts */
+      FD_COMPILER_MFENCE();
+      cnc_diag_backp_cnt = 0UL;
+      cnc_diag_pub_cnt   = 0UL;
+      cnc_diag_pub_sz    = 0UL;
+      cnc_diag_filt_cnt  = 0UL;
+      cnc_diag_filt_sz   = 0UL;
+      cnc_diag_late_cnt  = 0UL;
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_REC_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Receive flow control credits */
+      cr_avail = fd_fctl_tx_cr_update( fctl, cr_avail, seq );
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured (see fd_replay_tile for details) */
+
+    if( FD_UNLIKELY( !cr_avail ) ) {
+      cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
+      cnc_diag_in_backp   = 1UL;
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+    cnc_diag_in_backp = 0UL;
+
+    if( FD_UNLIKELY( cnc_diag_done ) ) {
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Copy up to a batch worth of records that are due (limited by the
+       credits we have to publish them).  When paced, we stop the batch
+       at the first record that isn't due yet. */
+
+    ulong batch_cnt = 0UL;
+    for( ulong poll_rem=fd_ulong_min( cr_avail, FD_REC_PLAY_TILE_BATCH_MAX ); poll_rem; poll_rem-- ) {
+
+      if( FD_UNLIKELY( !frag ) ) { /* Capture done */
+        cnc_diag_done = 1UL;
+        break;
+      }
+
+      long ts = frag->ts;
+
+      if( FD_LIKELY( paced ) ) {
+        long due = play0 + (long)(pace_scale*(double)(ts - ts0));
+        long lag = now - due;
+        if( lag<0L ) break; /* Not due yet */
+        cnc_diag_late_cnt += (ulong)(lag>late_min);
+      }
+
+      ulong sz = (ulong)frag->meta.sz;
+      if( FD_UNLIKELY( sz>mtu ) ) {
+        cnc_diag_filt_cnt++;
+        cnc_diag_filt_sz += sz;
+      } else {
+        fd_disco_copy_nt( fd_chunk_to_laddr( base, chunk ), fd_rec_frag_payload( frag ), sz );
+
+        /* Time between the frag's origin and its recorded publication
+           in local ticks */
+
+        long tsorig = fd_frag_meta_ts_decomp( (ulong)frag->meta.tsorig, ts );
+        long origin_lag = (long)(tick_scale*(double)(ts - tsorig));
+
+        fd_frag_meta_t * meta = batch + batch_cnt;
+        meta->sig    =         frag->meta.sig;
+        meta->chunk  = (uint  )chunk;
+        meta->sz     = (ushort)sz;
+        meta->ctl    =         frag->meta.ctl;
+        meta->tsorig = (uint  )fd_frag_meta_ts_comp( now - origin_lag );
+        batch_cnt++;
+
+        chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+      }
+
+      frag = fd_rec_frag_next( rec, frag );
+    }
+
+    if( FD_UNLIKELY( !batch_cnt ) ) {
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Make the copied payloads visible before publishing the metadata
+       describing them and then publish the batch */
+
+    fd_disco_copy_fence();
+
+    now = fd_tickcount();
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( now );
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      fd_frag_meta_t const * meta = batch + batch_idx;
+      ulong sz = (ulong)meta->sz;
+      fd_mcache_publish( mcache, depth, seq, meta->sig, (ulong)meta->chunk, sz, (ulong)meta->ctl, (ulong)meta->tsorig, tspub );
+      seq = fd_seq_inc( seq, 1UL );
+      cnc_diag_pub_sz += sz;
+    }
+    cr_avail         -= batch_cnt;
+    cnc_diag_pub_cnt += batch_cnt;
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting rec play" ));
+
+    FD_LOG_INFO(( "Destroying fctl" ));
+    fd_fctl_delete( fd_fctl_leave( fctl ) );
+
+    FD_LOG_INFO(( "Closing capture" ));
+    fd_rec_file_unmap( fd_rec_leave( (fd_rec_t *)rec ), map_sz );
+
+    FD_LOG_INFO(( "Halted rec play" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+
+#endif
@@ -0,0 +1,304 @@
+#include "../fd_disco.h"
+#include "../fd_disco_test_tile.c"
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+#include <unistd.h> /* For unlink */
+
+FD_STATIC_ASSERT( FD_REC_MAGIC==0xf17eda2c3772ec00UL, unit_test );
+
+FD_STATIC_ASSERT( FD_REC_DATA_OFF  ==4096UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_FRAG_ALIGN==64UL,   unit_test );
+
+FD_STATIC_ASSERT( FD_REC_FRAG_FOOTPRINT(    0UL )==  64UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_FRAG_FOOTPRINT(    1UL )== 128UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_FRAG_FOOTPRINT(   64UL )== 128UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_FRAG_FOOTPRINT( 1542UL )==1664UL, unit_test );
+
+FD_STATIC_ASSERT( sizeof(fd_rec_frag_t)==64UL, unit_test );
+
+FD_STATIC_ASSERT( FD_REC_CNC_SIGNAL_ACK  ==4UL,  unit_test );
+FD_STATIC_ASSERT( FD_REC_CNC_DIAG_FULL   ==2UL,  unit_test );
+FD_STATIC_ASSERT( FD_REC_CNC_DIAG_DATA_SZ==3UL,  unit_test );
+FD_STATIC_ASSERT( FD_REC_TILE_BATCH_MAX  ==64UL, unit_test );
+
+static uchar shrec[ 8192 ] __attribute__((aligned(FD_REC_FRAG_ALIGN)));
+
+struct test_cfg {
+  test_tx_t   tx[1];
+
+  uchar *     rec_cnc_mem;
+  char const* rec_path;
+  ulong       rec_sz;
+  long        rec_lazy;
+  uint        rec_seed;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+/* REC tile ***********************************************************/
+
+static int
+rec_tile_main( int     argc,
+               char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_cnc_t * cnc = fd_cnc_join( cfg->rec_cnc_mem );
+
+  fd_frag_meta_t const * tx_mcache = fd_mcache_join( cfg->tx->mcache_mem );
+  ulong *                tx_fseq   = fd_fseq_join  ( cfg->tx->fseq_mem   );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->rec_seed, 0UL ) );
+
+  int err = fd_rec_tile( cnc, cfg->rec_path, cfg->rec_sz, tx_mcache, tx_fseq, cfg->tx->wksp, cfg->rec_lazy, rng );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_rec_tile failed (%i)", err ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_fseq_leave  ( tx_fseq   );
+  fd_mcache_leave( tx_mcache );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* CNC tile ***********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  /* Test the capture format by hand building a small capture */
+
+  FD_TEST( !fd_rec_new( NULL,       8192UL ) ); /* NULL shmem */
+  FD_TEST( !fd_rec_new( shrec+1UL,  8191UL ) ); /* misaligned */
+  FD_TEST( !fd_rec_new( shrec,      4159UL ) ); /* too small */
+  FD_TEST( !fd_rec_join( NULL      ) );         /* NULL shrec */
+  FD_TEST( !fd_rec_join( shrec+1UL ) );         /* misaligned */
+  fd_memset( shrec, 0, 8192UL );
+  FD_TEST( !fd_rec_join( shrec ) );             /* bad magic */
+
+  FD_TEST( fd_rec_new( shrec, 8192UL-1UL )==shrec );
+  fd_rec_t * rec = fd_rec_join( shrec );
+  FD_TEST( rec==(fd_rec_t *)shrec );
+
+  FD_TEST( fd_rec_data_max ( rec )==4032UL );
+  FD_TEST( fd_rec_data_sz  ( rec )==0UL    );
+  FD_TEST( fd_rec_rec_cnt  ( rec )==0UL    );
+  FD_TEST( fd_rec_drop_cnt ( rec )==0UL    );
+  FD_TEST( fd_rec_data_laddr_const( rec )==shrec+FD_REC_DATA_OFF );
+  FD_TEST( fd_rec_data_laddr      ( rec )==shrec+FD_REC_DATA_OFF );
+  FD_TEST( !fd_rec_frag_first( rec ) );
+
+  ulong data_sz = 0UL;
+  ulong rec_cnt = 0UL;
+  for(;;) {
+    ulong sz        = fd_rng_ulong_roll( rng, 200UL );
+    ulong footprint = FD_REC_FRAG_FOOTPRINT( sz );
+    if( data_sz+footprint>fd_rec_data_max( rec ) ) break;
+    fd_rec_frag_t * frag = (fd_rec_frag_t *)(fd_rec_data_laddr( rec ) + data_sz);
+    frag->meta.seq   = rec_cnt;
+    frag->meta.sig   = fd_ulong_hash( rec_cnt );
+    frag->meta.sz    = (ushort)sz;
+    frag->ts         = (long)rec_cnt;
+    frag->footprint  = footprint;
+    fd_memset( frag+1, (int)(uchar)rec_cnt, sz );
+    data_sz += footprint;
+    rec_cnt++;
+  }
+  FD_TEST( rec_cnt );
+
+  /* Records are only visible once committed */
+
+  FD_TEST( !fd_rec_frag_first( rec ) );
+  rec->data_sz = data_sz;
+  rec->rec_cnt = rec_cnt;
+
+  ulong rec_idx = 0UL;
+  for( fd_rec_frag_t const * frag = fd_rec_frag_first( rec ); frag; frag = fd_rec_frag_next( rec, frag ) ) {
+    FD_TEST( frag->meta.seq==rec_idx                );
+    FD_TEST( frag->meta.sig==fd_ulong_hash( rec_idx ) );
+    FD_TEST( frag->ts      ==(long)rec_idx          );
+    uchar const * p = fd_rec_frag_payload( frag );
+    FD_TEST( p==(uchar const *)(frag+1) );
+    for( ulong off=0UL; off<(ulong)frag->meta.sz; off++ ) FD_TEST( p[ off ]==(uchar)rec_idx );
+    rec_idx++;
+  }
+  FD_TEST( rec_idx==rec_cnt );
+
+  /* A corrupt record ends the iteration */
+
+  ((fd_rec_frag_t *)fd_rec_data_laddr( rec ))->footprint++;
+  FD_TEST( !fd_rec_frag_first( rec ) );
+
+  FD_TEST( fd_rec_leave( rec )==shrec );
+  FD_TEST( fd_rec_delete( shrec )==shrec );
+  FD_TEST( !fd_rec_join( shrec ) );
+
+  /* Test the recorder tile */
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                 );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                        );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",  NULL, 32768UL                    );
+  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",    NULL, 1542UL                     );
+  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",   NULL, 0L                         );
+  char const * rec_path  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--rec",       NULL, "/tmp/test_rec.rec"        );
+  ulong        rec_sz    = fd_env_strip_cmdline_ulong( &argc, &argv, "--rec-sz",    NULL, 1UL<<26                    );
+  long         rec_lazy  = fd_env_strip_cmdline_long ( &argc, &argv, "--rec-lazy",  NULL, 0L /* use default */       );
+  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",  NULL, (long)1e9                  );
+
+  float burst_avg       = fd_env_strip_cmdline_float( &argc, &argv, "--burst-avg",       NULL, 1472.f );
+  ulong pkt_payload_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-payload-max", NULL, 1472UL );
+  ulong pkt_framing     = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-framing",     NULL,   70UL );
+  float pkt_bw          = fd_env_strip_cmdline_float( &argc, &argv, "--pkt-bw",          NULL,   1e9f );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  ulong tile_cnt = 1UL+1UL+1UL; /* 1 main(cnc,this) + 1 tx_main + 1 rec_main */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
+
+  FD_LOG_NOTICE(( "Creating workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  long now = fd_tickcount();
+
+  test_cfg_t cfg[1];
+
+  ulong tx_seq0 = fd_rng_ulong( rng );
+  test_tx_new( cfg->tx, wksp, tx_depth, tx_mtu, tx_lazy, pkt_framing, pkt_payload_max, burst_avg, pkt_bw,
+               rng_seq++, tx_seq0, now );
+
+  cfg->rec_cnc_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) );
+  FD_TEST( cfg->rec_cnc_mem );
+  FD_TEST( fd_cnc_new( cfg->rec_cnc_mem, 64UL, 1UL, now ) );
+
+  cfg->rec_path = rec_path;
+  cfg->rec_sz   = rec_sz;
+  cfg->rec_lazy = rec_lazy;
+  cfg->rec_seed = rng_seq++;
+
+  FD_LOG_NOTICE(( "Booting (--rec %s --rec-sz %lu)", rec_path, rec_sz ));
+
+  test_tile_t tile[2];
+  tile[0] = (test_tile_t){ .task = test_tx_tile_main, .arg = cfg->tx, .cnc_mem = cfg->tx->cnc_mem };
+  tile[1] = (test_tile_t){ .task = rec_tile_main,     .arg = cfg,     .cnc_mem = cfg->rec_cnc_mem };
+  test_tiles_boot( tile, 2UL );
+
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --rec-lazy %li ns)", duration, tx_lazy, rec_lazy ));
+
+  /* FIXME: DO MONITORING WHILE RUNNING */
+  fd_log_sleep( duration );
+
+  test_tiles_halt( tile, 2UL );
+
+  fd_cnc_t *    rec_cnc      = fd_cnc_join( cfg->rec_cnc_mem );
+  ulong const * rec_cnc_diag = (ulong const *)fd_cnc_app_laddr_const( rec_cnc );
+  ulong         rec_full     = rec_cnc_diag[ FD_REC_CNC_DIAG_FULL    ];
+  ulong         rec_data_sz  = rec_cnc_diag[ FD_REC_CNC_DIAG_DATA_SZ ];
+  FD_TEST( fd_cnc_leave( rec_cnc ) );
+
+  /* The tx was flow controlled by the rec so the rec should not have
+     been overrun.  Every frag was either recorded or filtered (because
+     the capture filled up). */
+
+  ulong *       tx_fseq      = fd_fseq_join( cfg->tx->fseq_mem );
+  ulong const * tx_fseq_diag = (ulong const *)fd_fseq_app_laddr_const( tx_fseq );
+  ulong         pub_cnt      = tx_fseq_diag[ FD_FSEQ_DIAG_PUB_CNT  ];
+  ulong         pub_sz       = tx_fseq_diag[ FD_FSEQ_DIAG_PUB_SZ   ];
+  ulong         filt_cnt     = tx_fseq_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+  FD_LOG_NOTICE(( "rec pub_cnt %lu pub_sz %lu filt_cnt %lu full %lu data_sz %lu", pub_cnt, pub_sz, filt_cnt, rec_full, rec_data_sz ));
+  FD_TEST( pub_cnt );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] );
+  FD_TEST( rec_full==(ulong)!!filt_cnt );
+  FD_TEST( fd_fseq_leave( tx_fseq ) );
+
+  /* Validate the capture */
+
+  FD_LOG_NOTICE(( "Validating capture" ));
+
+  ulong  map_sz = 0UL;
+  void * map    = fd_rec_file_map( rec_path, &map_sz, 0 );
+  FD_TEST( map );
+  FD_TEST( map_sz==rec_sz );
+
+  rec = fd_rec_join( map );
+  FD_TEST( rec );
+  FD_TEST( fd_rec_data_max ( rec )==fd_ulong_align_dn( rec_sz-FD_REC_DATA_OFF, FD_REC_FRAG_ALIGN ) );
+  FD_TEST( fd_rec_data_sz  ( rec )==rec_data_sz );
+  FD_TEST( fd_rec_rec_cnt  ( rec )==pub_cnt     );
+  FD_TEST( fd_rec_drop_cnt ( rec )==filt_cnt    );
+
+  /* The rec might have joined the stream after the tx started (the tx
+     only publishes its sync during housekeeping) so the capture starts
+     at an arbitrary tx stream position.  From there, the capture should
+     have every frag in order. */
+
+  fd_rec_frag_t const * frag0 = fd_rec_frag_first( rec );
+  FD_TEST( frag0 );
+
+  ulong tx_pos0    = fd_ulong_hash_inverse( frag0->meta.sig );
+  ulong tx_seq     = tx_pos0;
+  ulong seq        = frag0->meta.seq;
+  ulong rec_pub_sz = 0UL;
+  long  ts_last    = LONG_MIN;
+  for( fd_rec_frag_t const * frag = frag0; frag; frag = fd_rec_frag_next( rec, frag ) ) {
+    FD_TEST( fd_ulong_hash_inverse( frag->meta.sig )==tx_seq );
+    FD_TEST( frag->meta.seq==fd_seq_inc( seq, tx_seq-tx_pos0 ) );
+    FD_TEST( (ulong)fd_frag_meta_ts_comp( frag->ts )==(ulong)frag->meta.tspub );
+    FD_TEST( frag->ts>=ts_last );
+    ts_last = frag->ts;
+
+    ulong         sz  = (ulong)frag->meta.sz;
+    ulong         sig = frag->meta.sig;
+    uchar const * p   = fd_rec_frag_payload( frag );
+    for( ulong off=0UL; off<sz; off++ ) FD_TEST( p[ off ]==(uchar)(sig >> (8UL*(off & 7UL))) );
+
+    rec_pub_sz += sz;
+    tx_seq++;
+  }
+  FD_TEST( (tx_seq-tx_pos0)==pub_cnt );
+  FD_TEST( rec_pub_sz==pub_sz );
+
+  FD_TEST( fd_rec_leave( rec )==map );
+  fd_rec_file_unmap( map, map_sz );
+  FD_TEST( !unlink( rec_path ) );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  FD_TEST( fd_cnc_delete( cfg->rec_cnc_mem ) );
+  fd_wksp_free_laddr( cfg->rec_cnc_mem );
+
+  test_tx_delete( cfg->tx );
+
+  fd_wksp_delete_anonymous( wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_AVX capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
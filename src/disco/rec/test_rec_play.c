@@ -0,0 +1,440 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+#include <unistd.h> /* For unlink */
+
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_DONE    ==2UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_PUB_CNT ==3UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_PUB_SZ  ==4UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_FILT_CNT==5UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_FILT_SZ ==6UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_CNC_DIAG_LATE_CNT==7UL, unit_test );
+
+FD_STATIC_ASSERT( FD_REC_PLAY_TILE_OUT_MAX  ==8192UL, unit_test );
+FD_STATIC_ASSERT( FD_REC_PLAY_TILE_BATCH_MAX==16UL,   unit_test );
+
+FD_STATIC_ASSERT( FD_REC_PLAY_TILE_SCRATCH_ALIGN==128UL, unit_test );
+
+/* The test capture has frags with sig fd_ulong_hash( idx+1 ) for idx
+   the frag's position in the capture.  Every FILT_PERIOD frag is too
+   large to be played and the rest are played.  Payloads are filled with
+   the sig. */
+
+#define FILT_PERIOD (997UL)
+#define ORIG        (7UL)
+#define ORIG_LAG    (1000L) /* recorded ticks between a frag's origin and its publication */
+
+struct test_cfg {
+  fd_wksp_t * wksp;
+
+  uchar *     play_cnc_mem;
+  uchar *     play_scratch_mem;
+  uchar *     play_mcache_mem;
+  uchar *     play_dcache_mem;
+  char const* play_path;
+  ulong       play_mtu;
+  float       play_pace;
+  ulong       play_cr_max;
+  long        play_lazy;
+  uint        play_seed;
+
+  uchar *     rx_cnc_mem;
+  uchar *     rx_fseq_mem;
+  uchar *     rx_rng_mem;
+  int         rx_lazy;
+
+  /* rx results */
+  ulong       rx_cnt;   /* number of frags received */
+  long        rx_pub0;  /* tspub of the first frag received */
+  long        rx_pub1;  /* tspub of the last frag received */
+};
+
+typedef struct test_cfg test_cfg_t;
+
+static void
+test_capture_create( char const * path,
+                     ulong        frag_cnt,
+                     ulong        mtu,
+                     long         gap,
+                     fd_rng_t *   rng ) {
+  ulong rec_sz = FD_REC_DATA_OFF;
+  for( ulong idx=0UL; idx<frag_cnt; idx++ ) rec_sz += FD_REC_FRAG_FOOTPRINT( mtu+1UL );
+
+  void * map = fd_rec_file_map( path, &rec_sz, 1 );
+  FD_TEST( map );
+  fd_rec_t * rec = fd_rec_join( fd_rec_new( map, rec_sz ) );
+  FD_TEST( rec );
+
+  uchar * data    = fd_rec_data_laddr( rec );
+  ulong   data_sz = 0UL;
+  long    ts      = rec->ts0;
+  for( ulong idx=0UL; idx<frag_cnt; idx++ ) {
+    ulong sig = fd_ulong_hash( idx+1UL );
+    ulong sz  = ((idx % FILT_PERIOD)==(FILT_PERIOD-1UL)) ? (mtu+1UL) : fd_rng_ulong_roll( rng, mtu+1UL );
+
+    fd_rec_frag_t * frag = (fd_rec_frag_t *)(data + data_sz);
+    frag->meta.seq    = idx;
+    frag->meta.sig    = sig;
+    frag->meta.chunk  = 0U;
+    frag->meta.sz     = (ushort)sz;
+    frag->meta.ctl    = (ushort)fd_frag_meta_ctl( ORIG, (int)(idx & 1UL), (int)((idx>>1) & 1UL), 0 );
+    frag->meta.tsorig = (uint)fd_frag_meta_ts_comp( ts - ORIG_LAG );
+    frag->meta.tspub  = (uint)fd_frag_meta_ts_comp( ts );
+    frag->ts          = ts;
+    frag->footprint   = FD_REC_FRAG_FOOTPRINT( sz );
+
+    uchar * p = (uchar *)(frag+1);
+    for( ulong off=0UL; off<sz; off++ ) p[ off ] = (uchar)(sig >> (8UL*(off & 7UL)));
+
+    data_sz += frag->footprint;
+    ts      += gap;
+  }
+
+  rec->data_sz = data_sz;
+  rec->rec_cnt = frag_cnt;
+
+  FD_TEST( fd_rec_leave( rec )==map );
+  fd_rec_file_unmap( map, rec_sz );
+}
+
+/* PLAY tile **********************************************************/
+
+static int
+play_tile_main( int     argc,
+                char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_cnc_t *       cnc     = fd_cnc_join   ( cfg->play_cnc_mem    );
+  fd_frag_meta_t * mcache  = fd_mcache_join( cfg->play_mcache_mem );
+  uchar *          dcache  = fd_dcache_join( cfg->play_dcache_mem );
+  ulong *          rx_fseq = fd_fseq_join  ( cfg->rx_fseq_mem     );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->play_seed, 0UL ) );
+
+  int err = fd_rec_play_tile( cnc, cfg->play_path, cfg->play_mtu, cfg->play_pace, mcache, dcache, 1UL, &rx_fseq,
+                              cfg->play_cr_max, cfg->play_lazy, rng, cfg->play_scratch_mem );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_rec_play_tile failed (%i)", err ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_fseq_leave  ( rx_fseq );
+  fd_dcache_leave( dcache  );
+  fd_mcache_leave( mcache  );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* RX tile ************************************************************/
+
+/* This uses the same methodology as test_frag_rx.c to process the
+   played stream.  It validates the metadata and payloads are exactly as
+   recorded (and that filtered frags were skipped). */
+
+static int
+rx_tile_main( int     argc,
+              char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg  = (test_cfg_t *)argv;
+  fd_wksp_t *  wksp = cfg->wksp;
+
+  fd_cnc_t * cnc = fd_cnc_join( cfg->rx_cnc_mem );
+
+  fd_frag_meta_t const * mcache = fd_mcache_join( cfg->play_mcache_mem );
+  ulong                  depth  = fd_mcache_depth( mcache );
+  ulong const *          sync   = fd_mcache_seq_laddr_const( mcache );
+  ulong                  seq    = fd_mcache_seq_query( sync );
+
+  ulong *    fseq = fd_fseq_join( cfg->rx_fseq_mem );
+  fd_rng_t * rng  = fd_rng_join ( cfg->rx_rng_mem  );
+
+  ulong async_min = 1UL << cfg->rx_lazy;
+  ulong async_rem = 1UL; /* Do housekeeping on first iteration */
+
+  ulong idx    = 0UL; /* Position in the capture of the next frag we expect */
+  ulong rx_cnt = 0UL;
+  long  pub0   = 0L;
+  long  pub1   = 0L;
+
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  for(;;) {
+
+    fd_frag_meta_t const * mline;
+    ulong                  seq_found;
+    long                   diff;
+
+    ulong sig;
+    ulong chunk;
+    ulong sz;
+    ulong ctl;
+    ulong tsorig;
+    ulong tspub;
+    FD_MCACHE_WAIT_REG( sig, chunk, sz, ctl, tsorig, tspub, mline, seq_found, diff, async_rem, mcache, depth, seq );
+    if( FD_UNLIKELY( !async_rem ) ) {
+
+      /* Send flow control credits and results */
+      fd_fctl_rx_cr_return( fseq, seq );
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( cfg->rx_pub0 ) = pub0;
+      FD_VOLATILE( cfg->rx_pub1 ) = pub1;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( cfg->rx_cnt  ) = rx_cnt;
+      FD_COMPILER_MFENCE();
+
+      fd_cnc_heartbeat( cnc, fd_tickcount() );
+
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_HALT ) ) FD_LOG_ERR(( "Unexpected signal" ));
+        break;
+      }
+
+      async_rem = fd_tempo_async_reload( rng, async_min );
+      FD_YIELD();
+      continue;
+    }
+
+    if( FD_UNLIKELY( diff ) ) FD_LOG_ERR(( "Overrun while polling" ));
+
+    /* Process the received fragment */
+
+    if( FD_UNLIKELY( (idx % FILT_PERIOD)==(FILT_PERIOD-1UL) ) ) idx++; /* Filtered by the player */
+
+    if( FD_UNLIKELY( sig!=fd_ulong_hash( idx+1UL ) ) ) FD_LOG_ERR(( "Received a frag out of order" ));
+
+    ulong ctl_expected = fd_frag_meta_ctl( ORIG, (int)(idx & 1UL), (int)((idx>>1) & 1UL), 0 );
+    if( FD_UNLIKELY( ctl!=ctl_expected ) ) FD_LOG_ERR(( "ctl not preserved" ));
+
+    long now = fd_tickcount();
+    long ts  = fd_frag_meta_ts_decomp( tspub, now );
+    if( FD_UNLIKELY( (long)(uint)(tspub-tsorig)<ORIG_LAG ) ) FD_LOG_ERR(( "tsorig not preserved" ));
+
+    uchar const * p       = (uchar const *)fd_chunk_to_laddr_const( wksp, chunk );
+    int           corrupt = 0;
+    for( ulong off=0UL; off<sz; off++ ) corrupt |= (p[ off ]!=(uchar)(sig >> (8UL*(off & 7UL))));
+
+    seq_found = fd_frag_meta_seq_query( mline );
+    if( FD_UNLIKELY( fd_seq_ne( seq_found, seq ) ) ) FD_LOG_ERR(( "Overrun while reading" ));
+
+    if( FD_UNLIKELY( corrupt ) ) FD_LOG_ERR(( "Corrupt payload received" ));
+
+    if( FD_UNLIKELY( !rx_cnt ) ) pub0 = ts;
+    pub1 = ts;
+    rx_cnt++;
+
+    seq = fd_seq_inc( seq, 1UL );
+    idx++;
+  }
+
+  fd_rng_leave  ( rng    );
+  fd_fseq_leave ( fseq   );
+  fd_mcache_leave( mcache );
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* CNC tile ***********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  FD_TEST( fd_rec_play_tile_scratch_align()==FD_REC_PLAY_TILE_SCRATCH_ALIGN );
+  FD_TEST( !fd_rec_play_tile_scratch_footprint( FD_REC_PLAY_TILE_OUT_MAX+1UL ) );
+  for( ulong out_cnt=0UL; out_cnt<=FD_REC_PLAY_TILE_OUT_MAX; out_cnt++ )
+    FD_TEST( fd_rec_play_tile_scratch_footprint( out_cnt )==FD_REC_PLAY_TILE_SCRATCH_FOOTPRINT( out_cnt ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "gigantic"                 );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 1UL                        );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx(cpu_idx) );
+  char const * path      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--rec",      NULL, "/tmp/test_rec_play.rec"   );
+  ulong        frag_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--frag-cnt", NULL, 100000UL                   );
+  long         span      = fd_env_strip_cmdline_long ( &argc, &argv, "--span",     NULL, (long)200e6                );
+  ulong        depth     = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth",    NULL, 4096UL                     );
+  ulong        mtu       = fd_env_strip_cmdline_ulong( &argc, &argv, "--mtu",      NULL, 1542UL                     );
+  float        pace      = fd_env_strip_cmdline_float( &argc, &argv, "--pace",     NULL, 1.f                        );
+  ulong        cr_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",   NULL, 0UL /* use default */      );
+  long         lazy      = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",     NULL, 0L  /* use default */      );
+  int          rx_lazy   = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",  NULL, 7                          );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !frag_cnt ) ) FD_LOG_ERR(( "--frag-cnt should be positive" ));
+  if( FD_UNLIKELY( mtu>=(ulong)USHORT_MAX ) ) FD_LOG_ERR(( "--mtu too large" ));
+
+  ulong tile_cnt = 1UL+1UL+1UL; /* 1 main(cnc,this) + 1 play_main + 1 rx_main */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
+
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  long   gap         = (long)((tick_per_ns*(double)span) / (double)frag_cnt);
+
+  FD_LOG_NOTICE(( "Creating capture (--rec %s --frag-cnt %lu --span %li ns --mtu %lu)", path, frag_cnt, span, mtu ));
+  test_capture_create( path, frag_cnt, mtu, gap, rng );
+
+  ulong filt_cnt = frag_cnt / FILT_PERIOD;
+  ulong pub_cnt  = frag_cnt - filt_cnt;
+
+  FD_LOG_NOTICE(( "Creating workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong   cnc_footprint = fd_cnc_footprint( 64UL );
+  uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), 2UL*cnc_footprint );
+  uchar * rx_fseq_mem   = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fd_fseq_footprint() );
+  uchar * rx_rng_mem    = (uchar *)fd_wksp_alloc_laddr( wksp, fd_rng_align(), fd_rng_footprint() );
+  FD_TEST( cnc_mem ); FD_TEST( rx_fseq_mem ); FD_TEST( rx_rng_mem );
+
+  ulong   scratch_footprint = fd_rec_play_tile_scratch_footprint( 1UL );
+  uchar * scratch_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_rec_play_tile_scratch_align(), scratch_footprint );
+  FD_TEST( scratch_mem );
+
+  FD_LOG_NOTICE(( "Creating mcache (--depth %lu) and dcache (--mtu %lu)", depth, mtu ));
+  uchar * mcache_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), fd_mcache_footprint( depth, 0UL ) );
+  ulong   data_sz    = fd_dcache_req_data_sz( mtu, depth, FD_REC_PLAY_TILE_BATCH_MAX, 1 ); FD_TEST( data_sz );
+  uchar * dcache_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ) );
+  FD_TEST( mcache_mem ); FD_TEST( dcache_mem );
+
+  test_cfg_t cfg[1];
+
+  cfg->wksp = wksp;
+
+  cfg->play_cnc_mem     = cnc_mem;
+  cfg->play_scratch_mem = scratch_mem;
+  cfg->play_mcache_mem  = mcache_mem;
+  cfg->play_dcache_mem  = dcache_mem;
+  cfg->play_path        = path;
+  cfg->play_mtu         = mtu;
+  cfg->play_pace        = pace;
+  cfg->play_cr_max      = cr_max;
+  cfg->play_lazy        = lazy;
+  cfg->play_seed        = rng_seq++;
+
+  cfg->rx_cnc_mem  = cnc_mem + cnc_footprint;
+  cfg->rx_fseq_mem = rx_fseq_mem;
+  cfg->rx_rng_mem  = rx_rng_mem;
+  cfg->rx_lazy     = rx_lazy;
+
+  cfg->rx_cnt  = 0UL;
+  cfg->rx_pub0 = 0L;
+  cfg->rx_pub1 = 0L;
+
+  long  now  = fd_tickcount();
+  ulong seq0 = fd_rng_ulong( rng );
+  FD_TEST( fd_cnc_new   ( cfg->play_cnc_mem,    64UL, 0UL, now    ) );
+  FD_TEST( fd_mcache_new( cfg->play_mcache_mem, depth, 0UL, seq0  ) );
+  FD_TEST( fd_dcache_new( cfg->play_dcache_mem, data_sz, 0UL      ) );
+  FD_TEST( fd_cnc_new   ( cfg->rx_cnc_mem,      64UL, 1UL, now    ) );
+  FD_TEST( fd_fseq_new  ( cfg->rx_fseq_mem,     seq0              ) );
+  FD_TEST( fd_rng_new   ( cfg->rx_rng_mem,      rng_seq++, 0UL    ) );
+
+  fd_cnc_t * play_cnc = fd_cnc_join( cfg->play_cnc_mem ); FD_TEST( play_cnc );
+  fd_cnc_t * rx_cnc   = fd_cnc_join( cfg->rx_cnc_mem   ); FD_TEST( rx_cnc   );
+
+  FD_LOG_NOTICE(( "Booting" ));
+
+  FD_TEST( fd_tile_exec_new( 2UL, rx_tile_main,   0, (char **)fd_type_pun( cfg ) ) );
+  FD_TEST( fd_cnc_wait( rx_cnc,   FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+  FD_TEST( fd_tile_exec_new( 1UL, play_tile_main, 0, (char **)fd_type_pun( cfg ) ) );
+  FD_TEST( fd_cnc_wait( play_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+
+  FD_LOG_NOTICE(( "Playing (--pace %g --cr-max %lu --lazy %li --rx-lazy %i)", (double)pace, cr_max, lazy, rx_lazy ));
+
+  ulong const * play_diag = (ulong const *)fd_cnc_app_laddr_const( play_cnc );
+
+  long timeout = fd_log_wallclock() + (long)10e9 + (long)(2.f*pace*(float)span);
+  while( !FD_VOLATILE_CONST( play_diag[ FD_REC_PLAY_CNC_DIAG_DONE ] ) ) {
+    if( FD_UNLIKELY( fd_log_wallclock()>timeout ) ) FD_LOG_ERR(( "Timed out waiting for the player" ));
+    fd_log_sleep( (long)1e6 );
+  }
+  while( FD_VOLATILE_CONST( cfg->rx_cnt )<pub_cnt ) {
+    if( FD_UNLIKELY( fd_log_wallclock()>timeout ) ) FD_LOG_ERR(( "Timed out waiting for the rx" ));
+    fd_log_sleep( (long)1e6 );
+  }
+
+  FD_LOG_NOTICE(( "Halting" ));
+
+  fd_cnc_t * cnc[2] = { play_cnc, rx_cnc };
+  for( ulong cnc_idx=0UL; cnc_idx<2UL; cnc_idx++ ) {
+    FD_TEST( !fd_cnc_open( cnc[ cnc_idx ] ) );
+    fd_cnc_signal( cnc[ cnc_idx ], FD_CNC_SIGNAL_HALT );
+    fd_cnc_close( cnc[ cnc_idx ] );
+    FD_TEST( fd_cnc_wait( cnc[ cnc_idx ], FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+  }
+
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) {
+    int ret;
+    FD_TEST( !fd_tile_exec_delete( fd_tile_exec( tile_idx ), &ret ) );
+    FD_TEST( !ret );
+  }
+
+  /* Validate the diagnostics and timing.  The player never publishes a
+     frag early so the played stream should span at least pace times
+     the recorded span (less some tolerance for the first frag getting
+     published late).  We can't give an upper bound robustly as we might
+     be running on an oversubscribed host. */
+
+  ulong diag_pub_cnt  = play_diag[ FD_REC_PLAY_CNC_DIAG_PUB_CNT  ];
+  ulong diag_filt_cnt = play_diag[ FD_REC_PLAY_CNC_DIAG_FILT_CNT ];
+  ulong diag_late_cnt = play_diag[ FD_REC_PLAY_CNC_DIAG_LATE_CNT ];
+  long  played_span   = cfg->rx_pub1 - cfg->rx_pub0;
+  long  paced_span    = (long)((double)pace*(double)(gap*(long)(frag_cnt-2UL)));
+
+  FD_LOG_NOTICE(( "pub_cnt %lu filt_cnt %lu late_cnt %lu rx_cnt %lu played span %li ticks (paced span %li ticks)",
+                  diag_pub_cnt, diag_filt_cnt, diag_late_cnt, cfg->rx_cnt, played_span, paced_span ));
+
+  FD_TEST( diag_pub_cnt ==pub_cnt  );
+  FD_TEST( diag_filt_cnt==filt_cnt );
+  FD_TEST( cfg->rx_cnt  ==pub_cnt  );
+  FD_TEST( played_span>=(paced_span-paced_span/10L) );
+  if( pace==0.f ) FD_TEST( !diag_late_cnt );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  FD_TEST( fd_cnc_leave( rx_cnc   ) );
+  FD_TEST( fd_cnc_leave( play_cnc ) );
+
+  FD_TEST( fd_rng_delete   ( cfg->rx_rng_mem      ) );
+  FD_TEST( fd_fseq_delete  ( cfg->rx_fseq_mem     ) );
+  FD_TEST( fd_cnc_delete   ( cfg->rx_cnc_mem      ) );
+  FD_TEST( fd_dcache_delete( cfg->play_dcache_mem ) );
+  FD_TEST( fd_mcache_delete( cfg->play_mcache_mem ) );
+  FD_TEST( fd_cnc_delete   ( cfg->play_cnc_mem    ) );
+
+  fd_wksp_free_laddr( dcache_mem  );
+  fd_wksp_free_laddr( mcache_mem  );
+  fd_wksp_free_laddr( scratch_mem );
+  fd_wksp_free_laddr( rx_rng_mem  );
+  fd_wksp_free_laddr( rx_fseq_mem );
+  fd_wksp_free_laddr( cnc_mem     );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_TEST( !unlink( path ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_AVX capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
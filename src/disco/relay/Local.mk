@@ -0,0 +1,4 @@
+$(call add-hdrs,fd_relay.h)
+$(call add-objs,fd_relay,fd_disco)
+$(call make-unit-test,test_relay,test_relay,fd_disco fd_tango fd_util)
+$(call make-bin,fd_relay_tile,fd_relay_tile,fd_disco fd_tango fd_util)
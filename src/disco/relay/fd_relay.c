@@ -0,0 +1,470 @@
+#include "fd_relay.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+FD_STATIC_ASSERT( alignof(fd_frag_meta_t)<=FD_RELAY_TILE_SCRATCH_ALIGN, packing );
+
+ulong
+fd_relay_tile_scratch_align( void ) {
+  return FD_RELAY_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_relay_tile_scratch_footprint( ulong out_cnt ) {
+  if( FD_UNLIKELY( out_cnt>FD_RELAY_TILE_OUT_MAX ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( alignof(fd_frag_meta_t), FD_RELAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) ); /* batch */
+  SCRATCH_ALLOC( alignof(ulong const *),  out_cnt*sizeof(ulong const *)                  ); /* out_fseq */
+  SCRATCH_ALLOC( alignof(ulong *),        out_cnt*sizeof(ulong *)                        ); /* out_slow */
+  SCRATCH_ALLOC( alignof(ulong),          out_cnt*sizeof(ulong)                          ); /* out_seq */
+  SCRATCH_ALLOC( alignof(ushort),         (out_cnt+2UL)*sizeof(ushort)                   ); /* event_map */
+  return fd_ulong_align_up( scratch_top, fd_relay_tile_scratch_align() );
+}
+
+int
+fd_relay_tile( fd_cnc_t *              cnc,
+               fd_frag_meta_t const *  in_mcache,
+               ulong *                 in_fseq,
+               void const *            in_base,
+               fd_frag_meta_t *        mcache,
+               uchar *                 dcache,
+               ulong                   mtu,
+               ulong                   out_cnt,
+               ulong **                _out_fseq,
+               ulong                   cr_max,
+               long                    lazy,
+               fd_rng_t *              rng,
+               void *                  scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the relay tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+
+  /* in frag stream state */
+  ulong                  in_depth; /* ==fd_mcache_depth( in_mcache ), depth of the in's mcache */
+  ulong                  in_seq;   /* sequence number of next frag expected from the in */
+  fd_frag_meta_t const * in_mline; /* ==in_mcache + fd_mcache_line_idx( in_seq, in_depth ), location to poll next */
+  uint                   in_accum[6]; /* local diagnostic accumulators, drained during in housekeeping */
+                                      /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+
+  /* out frag stream state */
+  ulong            depth;  /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
+  ulong *          sync;   /* ==fd_mcache_seq_laddr( mcache ), local addr where relay mcache sync info is published */
+  ulong            seq;    /* next relay frag sequence number to publish */
+  void *           base;   /* ==fd_wksp_containing( dcache ), chunk reference address in the tile's local address space */
+  ulong            chunk0; /* ==fd_dcache_compact_chunk0( base, dcache ) */
+  ulong            wmark;  /* ==fd_dcache_compact_wmark ( base, dcache, mtu ), payload chunks start in [chunk0,wmark] */
+  ulong            chunk;  /* Chunk where next payload will be copied, in [chunk0,wmark] */
+  fd_frag_meta_t * batch;  /* batch[batch_idx] for batch_idx in [0,FD_RELAY_TILE_BATCH_MAX) is the metadata for a copied
+                              frag awaiting publication */
+
+  /* out flow control state */
+  ulong          cr_avail; /* number of flow control credits available to publish downstream, in [0,cr_max] */
+  ulong const ** out_fseq; /* out_fseq[out_idx] for out_idx in [0,out_cnt) is where to receive fctl credits from outs */
+  ulong **       out_slow; /* out_slow[out_idx] for out_idx in [0,out_cnt) is where to accumulate slow events */
+  ulong *        out_seq;  /* out_seq [out_idx] is the most recent observation of out_fseq[out_idx] */
+
+  /* housekeeping state */
+  ulong    event_cnt; /* ==out_cnt+2, total number of housekeeping events */
+  ulong    event_seq; /* current position in housekeeping event sequence, in [0,event_cnt) */
+  ushort * event_map; /* current mapping of event_seq to event idx, event_map[ event_seq ] is next event to process */
+  ulong    async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting relay (out-cnt %lu, mtu %lu)", out_cnt, mtu ));
+    if( FD_UNLIKELY( out_cnt>FD_RELAY_TILE_OUT_MAX ) ) { FD_LOG_WARNING(( "out_cnt too large" )); return 1; }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_relay_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<16UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 16" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,  1U },
+      { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
+       cleared during first run loop iteration if credits available */
+    cnc_diag_in_backp  = 1UL;
+    cnc_diag_backp_cnt = 0UL;
+
+    /* in frag stream init */
+
+    if( FD_UNLIKELY( !in_mcache ) ) { FD_LOG_WARNING(( "NULL in_mcache" )); return 1; }
+    if( FD_UNLIKELY( !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
+    if( FD_UNLIKELY( !in_base   ) ) { FD_LOG_WARNING(( "NULL in_base"   )); return 1; }
+
+    in_depth = fd_mcache_depth( in_mcache );
+    in_seq   = fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache ) ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    in_accum[0] = 0U; in_accum[1] = 0U; in_accum[2] = 0U;
+    in_accum[3] = 0U; in_accum[4] = 0U; in_accum[5] = 0U;
+
+    /* out frag stream init */
+
+    if( FD_UNLIKELY( !mcache ) ) { FD_LOG_WARNING(( "NULL mcache" )); return 1; }
+    if( FD_UNLIKELY( !dcache ) ) { FD_LOG_WARNING(( "NULL dcache" )); return 1; }
+    if( FD_UNLIKELY( !mtu    ) ) { FD_LOG_WARNING(( "mtu must be positive" )); return 1; }
+
+    depth = fd_mcache_depth    ( mcache );
+    sync  = fd_mcache_seq_laddr( mcache );
+
+    seq = fd_mcache_seq_query( sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION */
+
+    base = fd_wksp_containing( dcache );
+    if( FD_UNLIKELY( !base ) ) { FD_LOG_WARNING(( "fd_wksp_containing failed" )); return 1; }
+
+    /* A batch being copied is not yet visible in the mcache so the
+       dcache needs to hold up to depth frags accessible to consumers
+       plus a full batch in preparation. */
+
+    if( FD_UNLIKELY( !fd_dcache_compact_is_safe( base, dcache, mtu, depth+FD_RELAY_TILE_BATCH_MAX-1UL ) ) ) {
+      FD_LOG_WARNING(( "dcache not compatible with wksp base, mtu and mcache depth" ));
+      return 1;
+    }
+
+    chunk0 = fd_dcache_compact_chunk0( base, dcache );
+    wmark  = fd_dcache_compact_wmark ( base, dcache, mtu );
+    chunk  = chunk0;
+
+    batch = (fd_frag_meta_t *)SCRATCH_ALLOC( alignof(fd_frag_meta_t), FD_RELAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) );
+
+    /* out flow control init */
+
+    /* Unlike the mux and lb, the relay does not expose the in's frags
+       downstream (it exposes its own copies).  So the relay can return
+       credits to the in as soon as it has copied a frag and cr_max is
+       only limited by the relay's mcache depth.  Flow control still
+       propagates back to the in producer because the relay does not
+       consume in frags while it has no credits to publish them.  Like
+       the mux, credits from the outs are replenished continuously
+       (without the fctl object) to avoid bursts of reads. */
+
+    if( !cr_max ) cr_max = depth; /* use default */
+    FD_LOG_INFO(( "Using cr_max %lu", cr_max ));
+    if( FD_UNLIKELY( !((1UL<=cr_max) & (cr_max<=depth)) ) ) {
+      FD_LOG_WARNING(( "cr_max %lu must be in [1,%lu] for this mcache", cr_max, depth ));
+      return 1;
+    }
+
+    cr_avail = 0UL; /* Will be initialized by run loop */
+
+    out_fseq = (ulong const **)SCRATCH_ALLOC( alignof(ulong const *), out_cnt*sizeof(ulong const *) );
+    out_slow = (ulong **)      SCRATCH_ALLOC( alignof(ulong *),       out_cnt*sizeof(ulong *)       );
+    out_seq  = (ulong *)       SCRATCH_ALLOC( alignof(ulong),         out_cnt*sizeof(ulong)         );
+
+    if( FD_UNLIKELY( !!out_cnt && !_out_fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq" )); return 1; }
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+      if( FD_UNLIKELY( !_out_fseq[ out_idx ] ) ) { FD_LOG_WARNING(( "NULL out_fseq[%lu]", out_idx )); return 1; }
+      out_fseq[ out_idx ] = _out_fseq[ out_idx ];
+      out_slow[ out_idx ] = (ulong *)fd_fseq_app_laddr( _out_fseq[ out_idx ] ) + FD_FSEQ_DIAG_SLOW_CNT;
+      out_seq [ out_idx ] = fd_fseq_query( out_fseq[ out_idx ] );
+    }
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( cr_max );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    /* Initialize the initial event sequence to immediately update
+       cr_avail on the first run loop iteration and then update the in
+       and the outs. */
+
+    event_cnt = out_cnt + 2UL;
+    event_map = (ushort *)SCRATCH_ALLOC( alignof(ushort), event_cnt*sizeof(ushort) );
+    event_seq = 0UL;                                     event_map[ event_seq++ ] = (ushort) out_cnt;
+    /**/                                                 event_map[ event_seq++ ] = (ushort)(out_cnt+1UL);
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) event_map[ event_seq++ ] = (ushort) out_idx;
+    event_seq = 0UL;
+
+    async_min = fd_tempo_async_min( lazy, event_cnt, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running relay" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+      ulong event_idx = (ulong)event_map[ event_seq ];
+
+      /* Do the next async event.  event_idx:
+            <out_cnt - receive credits from out event_idx
+           ==out_cnt - housekeeping
+           >out_cnt - send credits to in.
+         Branch hints and order are optimized for the case:
+           out_cnt >~ 1. */
+
+      if( FD_LIKELY( event_idx<out_cnt ) ) { /* out fctl for out out_idx */
+        ulong out_idx = event_idx;
+
+        /* Receive flow control credits from this out. */
+        out_seq[ out_idx ] = fd_fseq_query( out_fseq[ out_idx ] );
+
+      } else if( FD_LIKELY( event_idx>out_cnt ) ) { /* in fctl */
+
+        /* Send flow control credits and drain flow control diagnostics
+           for the in.  Everything before in_seq has been copied (a
+           batch is always completed before doing housekeeping) so the
+           in is free to overrun it.  Like the mux, we only update the
+           in's fseq when it would advance. */
+
+        if( FD_LIKELY( fd_seq_gt( in_seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, in_seq );
+
+        ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+        ulong a0 = (ulong)in_accum[0]; ulong a1 = (ulong)in_accum[1]; ulong a2 = (ulong)in_accum[2];
+        ulong a3 = (ulong)in_accum[3]; ulong a4 = (ulong)in_accum[4]; ulong a5 = (ulong)in_accum[5];
+        FD_COMPILER_MFENCE();
+        diag[0] += a0;                 diag[1] += a1;                 diag[2] += a2;
+        diag[3] += a3;                 diag[4] += a4;                 diag[5] += a5;
+        FD_COMPILER_MFENCE();
+        in_accum[0] = 0U;              in_accum[1] = 0U;              in_accum[2] = 0U;
+        in_accum[3] = 0U;              in_accum[4] = 0U;              in_accum[5] = 0U;
+
+      } else { /* event_idx==out_cnt, housekeeping event */
+
+        /* Send synchronization info */
+        fd_mcache_seq_update( sync, seq );
+
+        /* Send diagnostic info */
+        /* When we drain, we don't do a fully atomic update of the
+           diagnostics as it is only diagnostic and it will still be
+           correct the usual case where individual diagnostic counters
+           aren't used by multiple writers spread over different threads
+           of execution. */
+        fd_cnc_heartbeat( cnc, now );
+        FD_COMPILER_MFENCE();
+        cnc_diag[ FD_CNC_DIAG_IN_BACKP  ]  = cnc_diag_in_backp;
+        cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] += cnc_diag_backp_cnt;
+        FD_COMPILER_MFENCE();
+        cnc_diag_backp_cnt = 0UL;
+
+        /* Receive command-and-control signals */
+        ulong s = fd_cnc_signal_query( cnc );
+        if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+          if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+          if( FD_UNLIKELY( s!=FD_RELAY_CNC_SIGNAL_ACK ) ) {
+            char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+            FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+          }
+          fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+        }
+
+        /* Receive flow control credits */
+        if( FD_LIKELY( cr_avail<cr_max ) ) {
+          ulong slowest_out = ULONG_MAX;
+          cr_avail = cr_max;
+          for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+            ulong out_cr_avail = (ulong)fd_long_max( (long)cr_max-fd_long_max( fd_seq_diff( seq, out_seq[ out_idx ] ), 0L ), 0L );
+            slowest_out = fd_ulong_if( out_cr_avail<cr_avail, out_idx, slowest_out );
+            cr_avail    = fd_ulong_min( out_cr_avail, cr_avail );
+          }
+          /* See notes above about use of quasi-atomic diagnostic accum */
+          if( FD_LIKELY( slowest_out!=ULONG_MAX ) ) {
+            FD_COMPILER_MFENCE();
+            out_slow[ slowest_out ][0]++;
+            FD_COMPILER_MFENCE();
+          }
+        }
+      }
+
+      /* Select which event to do next (randomized round robin) and
+         reload the housekeeping timer. */
+
+      event_seq++;
+      if( FD_UNLIKELY( event_seq>=event_cnt ) ) {
+        event_seq = 0UL;
+
+        /* Randomize the order of event processing for the next event
+           event_cnt events to avoid lighthousing effects causing out
+           credit starvation at extreme fan out and high credit return
+           laziness. */
+
+        ulong  swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)event_cnt );
+        ushort map_tmp        = event_map[ swap_idx ];
+        event_map[ swap_idx ] = event_map[ 0        ];
+        event_map[ 0        ] = map_tmp;
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured.  If so, count any transition into
+       a backpressured regime and spin to wait for flow control credits
+       to return.  We don't do a fully atomic update here as it is only
+       diagnostic and it will still be correct the usual case where
+       individual diagnostic counters aren't used by writers in
+       different threads of execution.  We only count the transition
+       from not backpressured to backpressured. */
+
+    if( FD_UNLIKELY( !cr_avail ) ) {
+      cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
+      cnc_diag_in_backp   = 1UL;
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+    cnc_diag_in_backp = 0UL;
+
+    /* Copy up to a batch worth of new in frags (limited by the credits
+       we have to publish them).  We stop the batch early if the in is
+       caught up such that relaying doesn't add latency at low load. */
+
+    ulong batch_cnt = 0UL;
+    for( ulong poll_rem=fd_ulong_min( cr_avail, FD_RELAY_TILE_BATCH_MAX ); poll_rem; poll_rem-- ) {
+
+      /* Check if the in has a new fragment to relay */
+
+      FD_COMPILER_MFENCE();
+      ulong seq_found = in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      long diff = fd_seq_diff( in_seq, seq_found );
+      if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+        if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if in is honoring our flow control) */
+          in_seq   = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
+          in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+        }
+        break;
+      }
+
+      /* We have a new fragment to relay.  Try to load it.  This attempt
+         should always be successful if the in producer is honoring our
+         flow control (see fd_mux_tile for more details). */
+
+      FD_COMPILER_MFENCE();
+      ulong sig      =        in_mline->sig;
+      ulong in_chunk = (ulong)in_mline->chunk;
+      ulong sz       = (ulong)in_mline->sz;
+      ulong ctl      = (ulong)in_mline->ctl;
+      ulong tsorig   = (ulong)in_mline->tsorig;
+      FD_COMPILER_MFENCE();
+      ulong seq_test =        in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading (impossible if in honoring our fctl) */
+        in_seq   = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
+        in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+        in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+        break;
+      }
+
+      /* Copy the payload into our dcache.  Frags we can't hold are
+         filtered.  Since the in might be misconfigured such that it
+         does not honor our flow control, we check we weren't overrun
+         while copying and discard the copy if so. */
+
+      ulong should_filter = (ulong)(sz>mtu);
+
+      if( FD_LIKELY( !should_filter ) ) {
+        fd_disco_copy_nt( fd_chunk_to_laddr( base, chunk ), fd_chunk_to_laddr_const( in_base, in_chunk ), sz );
+
+        seq_test = fd_frag_meta_seq_query( in_mline );
+        if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while copying (impossible if in honoring our fctl) */
+          in_seq   = seq_test;
+          in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+          break;
+        }
+
+        fd_frag_meta_t * meta = batch + batch_cnt;
+        meta->sig    =         sig;
+        meta->chunk  = (uint  )chunk;
+        meta->sz     = (ushort)sz;
+        meta->ctl    = (ushort)ctl;
+        meta->tsorig = (uint  )tsorig;
+        batch_cnt++;
+
+        chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+      }
+
+      /* Windup for the next in poll and accumulate diagnostics */
+
+      in_seq   = fd_seq_inc( in_seq, 1UL );
+      in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+      ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + should_filter*2UL;
+      in_accum[ diag_idx     ]++;
+      in_accum[ diag_idx+1UL ] += (uint)sz;
+    }
+
+    if( FD_UNLIKELY( !batch_cnt ) ) { /* Optimize for relaying under load */
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+
+    /* Make the copied payloads visible before publishing the metadata
+       describing them and then publish the batch */
+
+    fd_disco_copy_fence();
+
+    now = fd_tickcount();
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( now );
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      fd_frag_meta_t const * meta = batch + batch_idx;
+      fd_mcache_publish( mcache, depth, seq, meta->sig, (ulong)meta->chunk, (ulong)meta->sz, (ulong)meta->ctl,
+                         (ulong)meta->tsorig, tspub );
+      seq = fd_seq_inc( seq, 1UL );
+    }
+    cr_avail -= batch_cnt;
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting relay" ));
+
+    /* Return all credits to the in and drain the diagnostics */
+
+    if( FD_LIKELY( fd_seq_gt( in_seq, fd_fseq_query( in_fseq ) ) ) ) fd_fseq_update( in_fseq, in_seq );
+    ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+    FD_COMPILER_MFENCE();
+    for( ulong diag_idx=0UL; diag_idx<6UL; diag_idx++ ) diag[ diag_idx ] += (ulong)in_accum[ diag_idx ];
+    FD_COMPILER_MFENCE();
+
+    fd_mcache_seq_update( sync, seq );
+
+    FD_LOG_INFO(( "Halted relay" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+
+#endif
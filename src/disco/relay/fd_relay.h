@@ -0,0 +1,162 @@
+#ifndef HEADER_fd_src_disco_relay_fd_relay_h
+#define HEADER_fd_src_disco_relay_fd_relay_h
+
+/* fd_relay provides services to replicate a fragment stream (metadata
+   _and_ payloads) from a mcache / dcache pair on one NUMA node into a
+   mcache / dcache pair on another NUMA node.  Unlike fd_mux and fd_lb,
+   which are zero copy, the relay copies payloads such that consumers of
+   the relayed stream only ever touch memory local to their NUMA node in
+   their hot loops.  The cross node traffic is thus paid exactly once
+   per frag (by the relay) instead of once per frag per consumer. */
+
+#include "../fd_disco_base.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_RELAY_CNC_SIGNAL_ACK can
+   be raised by a cnc thread with an open command session while the
+   relay is in the RUN state.  The relay will transition from ACK->RUN
+   the next time it processes cnc signals to indicate it is running
+   normally.  If a signal other than ACK, HALT, or RUN is raised, it
+   will be logged as unexpected and transitioned by back to RUN. */
+
+#define FD_RELAY_CNC_SIGNAL_ACK (4UL)
+
+/* FD_RELAY_TILE_OUT_MAX is the maximum number of reliable consumers a
+   relay tile can have.  This limit is more or less arbitrary from a
+   functional correctness POV.  It mostly exists to set some practical
+   upper bounds for things like scratch footprint.
+
+   FD_RELAY_TILE_BATCH_MAX is the maximum number of frags a relay will
+   copy before making them visible to consumers.  Payloads are written
+   with non-temporal stores (fd_disco_copy_nt, such that the relayed
+   payloads do not pollute the relay core's caches and go straight to
+   the memory local to the consumers) and a batch amortizes the store
+   fence needed before the corresponding metadata can be published over
+   several frags.  The relay's dcache should be sized for this many
+   frags in preparation (see fd_relay_tile below). */
+
+#define FD_RELAY_TILE_OUT_MAX   FD_FRAG_META_ORIG_MAX
+#define FD_RELAY_TILE_BATCH_MAX (16UL)
+
+/* FD_RELAY_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for a relay tile scratch region that can support
+   out_cnt reliable consumers.  ALIGN is an integer power of 2 of at
+   least double cache line to mitigate various kinds of false sharing.
+   FOOTPRINT will be an integer multiple of ALIGN.  out_cnt is assumed
+   to be valid (i.e. at most FD_RELAY_TILE_OUT_MAX).  These are provided
+   to facilitate compile time declarations. */
+
+#define FD_RELAY_TILE_SCRATCH_ALIGN (128UL)
+#define FD_RELAY_TILE_SCRATCH_FOOTPRINT( out_cnt )                            \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(       \
+  FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                         \
+    alignof(fd_frag_meta_t), FD_RELAY_TILE_BATCH_MAX*sizeof(fd_frag_meta_t) ), \
+    alignof(ulong const *),  (out_cnt)*sizeof(ulong const *)                ), \
+    alignof(ulong *),        (out_cnt)*sizeof(ulong *)                      ), \
+    alignof(ulong),          (out_cnt)*sizeof(ulong)                        ), \
+    alignof(ushort),         ((out_cnt)+2UL)*sizeof(ushort)                 ), \
+    FD_RELAY_TILE_SCRATCH_ALIGN )
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_relay_tile replicates the fragment stream described by in_mcache
+   (with payloads at chunk addresses relative to in_base) into mcache
+   and dcache.  mcache and dcache should be located in a workspace near
+   the consumers of the relayed stream (e.g. in the gigantic page wksp
+   of the far NUMA node) while the relay tile itself should ideally run
+   on a core on the same NUMA node as mcache and dcache (such that the
+   cross node traffic is the relay's reads of the in's metadata and
+   payloads).  The relayed stream can have out_cnt reliable consumers
+   and an arbitrary number of unreliable consumers.
+
+   The relay acts as a reliable consumer of in_mcache, returning flow
+   control credits to the in producer via in_fseq.  As payloads are
+   copied, credits are returned as soon as a frag has been copied.  The
+   relay only consumes in frags when it has credits to publish them
+   downstream.  Thus, a slow reliable consumer of the relayed stream
+   will backpressure the relay which will in turn backpressure the in
+   producer (i.e. flow control goes all the way back to the source).
+
+   The sig, sz, ctl and tsorig input fragment metadata will be unchanged
+   by this tile.  chunk will be changed to the location of the copied
+   payload in dcache (indexed relative to the wksp containing the
+   dcache).  The relayed stream has its own sequence space (starting
+   from mcache's sequence number at boot).  tspub will be recomputed for
+   relayed frags (see fd_mux_tile for more details).
+
+   In frags larger than mtu cannot be relayed and will be filtered
+   (accumulated to FD_FSEQ_DIAG_FILT_{CNT,SZ} of in_fseq).  The dcache
+   should have room for at least fd_dcache_req_data_sz( mtu,
+   mcache.depth, FD_RELAY_TILE_BATCH_MAX, 1 ) bytes of compactly stored
+   payloads.  This insures a batch being prepared can never clobber the
+   payload of a frag that is still accessible through the mcache.
+
+   cr_max is the maximum number of flow control credits the relay tile
+   is allowed for publishing frags.  It represents the maximum number of
+   frags a reliable out can lag behind the relay.  cr_max must be in
+   [1,mcache.depth].  If cr_max is zero, mcache.depth will be used.
+
+   lazy is the ballpark interval in ns for how often to receive credits
+   from an out (and, equivalently, how often to return credits to the
+   in).  See fd_mux_tile for more details.  <=0 indicates to pick a
+   conservative default.
+
+   scratch points to tile scratch memory.  fd_relay_tile_scratch_align
+   and fd_relay_tile_scratch_footprint return the required alignment
+   and footprint needed for this region.  This memory region is
+   exclusively owned by the relay tile while the tile is running and is
+   ideally near the core running the relay tile.
+   fd_relay_tile_scratch_align will return the same value as
+   FD_RELAY_TILE_SCRATCH_ALIGN.  If out_cnt is not valid,
+   fd_relay_tile_scratch_footprint silently returns 0 so callers can
+   diagnose configuration issues.  Otherwise,
+   fd_relay_tile_scratch_footprint will return the same value as
+   FD_RELAY_TILE_SCRATCH_FOOTPRINT.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the relay tile (see fd_mux_tile for details
+   of the cnc state transitions).  Returns a non-zero error code if the
+   tile fails to boot up (logs details).  For maximally robust operation
+   in the current implementation, all reliable consumers should be
+   halted and/or caught up before this tile is halted.
+
+   A fd_relay_tile will use the application regions of the fseqs and
+   cnc for accumulating standard diagnostics in the standard ways.
+
+   The lifetime of the cnc, mcaches, dcache, fseqs, rng and scratch used
+   by this tile should be a superset of this tile's lifetime.  While
+   this tile is running, no other tile should use cnc for its command
+   and control, publish into mcache or dcache, use the rng for anything
+   (and the rng should be be seeded distinctly from all other rngs in
+   the system), or use scratch for anything.  The out_fseq array will
+   not be used the after the tile has successfully booted (transitioned
+   the cnc from BOOT to RUN) or returned (e.g. failed to boot),
+   whichever comes first. */
+
+FD_FN_CONST ulong
+fd_relay_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_relay_tile_scratch_footprint( ulong out_cnt );
+
+int
+fd_relay_tile( fd_cnc_t *              cnc,       /* Local join to the relay's command-and-control */
+               fd_frag_meta_t const *  in_mcache, /* Local join to the in's mcache */
+               ulong *                 in_fseq,   /* Local join to the in's fseq */
+               void const *            in_base,   /* Local address of the in's chunk 0 (e.g. the wksp containing the in's dcache) */
+               fd_frag_meta_t *        mcache,    /* Local join to the relay's frag stream output mcache */
+               uchar *                 dcache,    /* Local join to the relay's frag stream output dcache */
+               ulong                   mtu,       /* Maximum size frag the relay can copy */
+               ulong                   out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+               ulong **                out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+               ulong                   cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
+               long                    lazy,      /* Lazyiness, <=0 means use a reasonable default */
+               fd_rng_t *              rng,       /* Local join to the rng this relay should use */
+               void *                  scratch ); /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif
+
+#endif /* HEADER_fd_src_disco_relay_fd_relay_h */
@@ -0,0 +1,236 @@
+#include "../fd_disco.h"
+#include "../fd_disco_test_tile.c"
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+FD_STATIC_ASSERT( FD_RELAY_CNC_SIGNAL_ACK==4UL, unit_test );
+
+FD_STATIC_ASSERT( FD_RELAY_TILE_OUT_MAX  ==8192UL, unit_test );
+FD_STATIC_ASSERT( FD_RELAY_TILE_BATCH_MAX==16UL,   unit_test );
+
+FD_STATIC_ASSERT( FD_RELAY_TILE_SCRATCH_ALIGN==128UL, unit_test );
+
+struct test_cfg {
+  test_tx_t   tx[1];            /* In the tx wksp */
+
+  uchar *     relay_cnc_mem;
+  uchar *     relay_scratch_mem;
+  uchar *     relay_mcache_mem;
+  uchar *     relay_dcache_mem;
+  ulong       relay_mtu;
+  ulong       relay_cr_max;
+  long        relay_lazy;
+  uint        relay_seed;
+
+  ulong       rx_cnt;
+  test_rx_t   rx[ 128 ];        /* In the rx wksp */
+};
+
+typedef struct test_cfg test_cfg_t;
+
+/* RELAY tile *********************************************************/
+
+static int
+relay_tile_main( int     argc,
+                 char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_cnc_t * cnc = fd_cnc_join( cfg->relay_cnc_mem );
+
+  fd_frag_meta_t const * tx_mcache = fd_mcache_join( cfg->tx->mcache_mem );
+  ulong *                tx_fseq   = fd_fseq_join  ( cfg->tx->fseq_mem   );
+
+  fd_frag_meta_t * mcache = fd_mcache_join( cfg->relay_mcache_mem );
+  uchar *          dcache = fd_dcache_join( cfg->relay_dcache_mem );
+
+  ulong * rx_fseq[ 128 ];
+  for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ )
+    rx_fseq[ rx_idx ] = fd_fseq_join( cfg->rx[ rx_idx ].fseq_mem );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->relay_seed, 0UL ) );
+
+  int err = fd_relay_tile( cnc, tx_mcache, tx_fseq, cfg->tx->wksp, mcache, dcache, cfg->relay_mtu, cfg->rx_cnt, rx_fseq,
+                           cfg->relay_cr_max, cfg->relay_lazy, rng, cfg->relay_scratch_mem );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_relay_tile failed (%i)", err ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  for( ulong rx_idx=cfg->rx_cnt; rx_idx; rx_idx-- ) fd_fseq_leave( rx_fseq[ rx_idx-1UL ] );
+  fd_dcache_leave( dcache    );
+  fd_mcache_leave( mcache    );
+  fd_fseq_leave  ( tx_fseq   );
+  fd_mcache_leave( tx_mcache );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* The rxs are the shared test rxs (see fd_disco_test_tile.c).  They
+   only touch the rx wksp and check the relayed payloads are located in
+   the relay's dcache. */
+
+/* CNC tile ***********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  FD_TEST( fd_relay_tile_scratch_align()==FD_RELAY_TILE_SCRATCH_ALIGN );
+  FD_TEST( !fd_relay_tile_scratch_footprint( FD_RELAY_TILE_OUT_MAX+1UL ) );
+  for( ulong out_cnt=0UL; out_cnt<=FD_RELAY_TILE_OUT_MAX; out_cnt++ )
+    FD_TEST( fd_relay_tile_scratch_footprint( out_cnt )==FD_RELAY_TILE_SCRATCH_FOOTPRINT( out_cnt ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",       NULL, "gigantic"                 );
+  ulong        page_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",      NULL, 1UL                        );
+  ulong        tx_numa_idx    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-numa-idx",   NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        rx_numa_idx    = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-numa-idx",   NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        tx_depth       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",      NULL, 32768UL                    );
+  ulong        tx_mtu         = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",        NULL, 1542UL                     );
+  long         tx_lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",       NULL, 0L                         );
+  ulong        relay_depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--relay-depth",   NULL, 4096UL                     );
+  ulong        relay_mtu      = fd_env_strip_cmdline_ulong( &argc, &argv, "--relay-mtu",     NULL, 1542UL                     );
+  ulong        relay_cr_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--relay-cr-max",  NULL, 0UL /* use default */      );
+  long         relay_lazy     = fd_env_strip_cmdline_long ( &argc, &argv, "--relay-lazy",    NULL, 0L /* use default */       );
+  ulong        rx_cnt         = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",        NULL, 2UL                        );
+  int          rx_lazy        = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",       NULL, 7                          );
+  long         duration       = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",      NULL, (long)10e9                 );
+
+  float burst_avg       = fd_env_strip_cmdline_float( &argc, &argv, "--burst-avg",       NULL, 1472.f );
+  ulong pkt_payload_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-payload-max", NULL, 1472UL );
+  ulong pkt_framing     = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-framing",     NULL,   70UL );
+  float pkt_bw          = fd_env_strip_cmdline_float( &argc, &argv, "--pkt-bw",          NULL,  25e9f );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz      ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( rx_cnt>128UL  ) ) FD_LOG_ERR(( "--rx-cnt too large for this unit test" ));
+  if( FD_UNLIKELY( (pkt_framing+pkt_payload_max)>relay_mtu ) ) FD_LOG_ERR(( "--relay-mtu too small for pkt_max" ));
+
+  ulong tile_cnt = 1UL+1UL+1UL+rx_cnt; /* 1 main(cnc,this) + 1 tx_main + 1 relay_main + rx_cnt rx_mains */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
+
+  /* The tx wksp models the memory local to the producer's socket and
+     the rx wksp models the memory local to the consumers' socket.
+     Only the relay touches both. */
+
+  FD_LOG_NOTICE(( "Creating tx workspace with --page-cnt %lu --page-sz %s pages on --tx-numa-idx %lu",
+                  page_cnt, _page_sz, tx_numa_idx ));
+  fd_wksp_t * tx_wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( tx_numa_idx ), "tx_wksp", 0UL );
+  FD_TEST( tx_wksp );
+
+  FD_LOG_NOTICE(( "Creating rx workspace with --page-cnt %lu --page-sz %s pages on --rx-numa-idx %lu",
+                  page_cnt, _page_sz, rx_numa_idx ));
+  fd_wksp_t * rx_wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( rx_numa_idx ), "rx_wksp", 0UL );
+  FD_TEST( rx_wksp );
+
+  long now = fd_tickcount();
+
+  test_cfg_t cfg[1];
+
+  ulong tx_seq0 = fd_rng_ulong( rng );
+  test_tx_new( cfg->tx, tx_wksp, tx_depth, tx_mtu, tx_lazy, pkt_framing, pkt_payload_max, burst_avg, pkt_bw,
+               rng_seq++, tx_seq0, now );
+
+  FD_LOG_NOTICE(( "Creating relay (--relay-depth %lu, --relay-mtu %lu, relay-burst %lu, relay-compact 1, app-sz 0)",
+                  relay_depth, relay_mtu, FD_RELAY_TILE_BATCH_MAX ));
+
+  ulong relay_scratch_footprint = fd_relay_tile_scratch_footprint( rx_cnt );
+  FD_TEST( relay_scratch_footprint );
+  ulong relay_data_sz = fd_dcache_req_data_sz( relay_mtu, relay_depth, FD_RELAY_TILE_BATCH_MAX, 1 );
+  FD_TEST( relay_data_sz );
+
+  cfg->relay_cnc_mem     = (uchar *)fd_wksp_alloc_laddr( rx_wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) );
+  cfg->relay_scratch_mem = (uchar *)fd_wksp_alloc_laddr( rx_wksp, fd_relay_tile_scratch_align(), relay_scratch_footprint );
+  cfg->relay_mcache_mem  = (uchar *)fd_wksp_alloc_laddr( rx_wksp, fd_mcache_align(), fd_mcache_footprint( relay_depth, 0UL ) );
+  cfg->relay_dcache_mem  = (uchar *)fd_wksp_alloc_laddr( rx_wksp, fd_dcache_align(), fd_dcache_footprint( relay_data_sz, 0UL ) );
+  FD_TEST( cfg->relay_cnc_mem ); FD_TEST( cfg->relay_scratch_mem );
+  FD_TEST( cfg->relay_mcache_mem ); FD_TEST( cfg->relay_dcache_mem );
+
+  cfg->relay_mtu    = relay_mtu;
+  cfg->relay_cr_max = relay_cr_max;
+  cfg->relay_lazy   = relay_lazy;
+  cfg->relay_seed   = rng_seq++;
+
+  ulong relay_seq0 = fd_rng_ulong( rng );
+  FD_TEST( fd_cnc_new   ( cfg->relay_cnc_mem,    64UL, 1UL, now               ) );
+  FD_TEST( fd_mcache_new( cfg->relay_mcache_mem, relay_depth, 0UL, relay_seq0 ) );
+  FD_TEST( fd_dcache_new( cfg->relay_dcache_mem, relay_data_sz, 0UL           ) );
+
+  cfg->rx_cnt = rx_cnt;
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ )
+    test_rx_new( cfg->rx + rx_idx, rx_wksp, rx_idx, rx_cnt, cfg->relay_mcache_mem, cfg->relay_dcache_mem, rx_lazy, 0L, NULL,
+                 rng_seq++, relay_seq0, now );
+
+  test_tile_t tile[ 2UL+128UL ];
+  tile_cnt = 0UL;
+  tile[ tile_cnt++ ] = (test_tile_t){ .task = test_tx_tile_main, .arg = cfg->tx, .cnc_mem = cfg->tx->cnc_mem   };
+  tile[ tile_cnt++ ] = (test_tile_t){ .task = relay_tile_main,   .arg = cfg,     .cnc_mem = cfg->relay_cnc_mem };
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ )
+    tile[ tile_cnt++ ] = (test_tile_t){ .task = test_rx_tile_main, .arg = cfg->rx + rx_idx, .cnc_mem = cfg->rx[ rx_idx ].cnc_mem };
+
+  test_tiles_boot( tile, tile_cnt );
+
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --relay-cr-max %lu, --relay-lazy %li ns, --rx-lazy %i)",
+                  duration, tx_lazy, relay_cr_max, relay_lazy, rx_lazy ));
+
+  /* FIXME: DO MONITORING WHILE RUNNING */
+  fd_log_sleep( duration );
+
+  test_tiles_halt( tile, tile_cnt );
+
+  /* Every frag the relay consumed was either relayed or filtered (none
+     should have been filtered given the mtus) and the relay should not
+     have been overrun */
+
+  ulong *       tx_fseq      = fd_fseq_join( cfg->tx->fseq_mem );
+  ulong const * tx_fseq_diag = (ulong const *)fd_fseq_app_laddr_const( tx_fseq );
+  FD_LOG_NOTICE(( "relay pub_cnt %lu pub_sz %lu", tx_fseq_diag[ FD_FSEQ_DIAG_PUB_CNT ], tx_fseq_diag[ FD_FSEQ_DIAG_PUB_SZ ] ));
+  FD_TEST( tx_fseq_diag[ FD_FSEQ_DIAG_PUB_CNT   ] );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_FILT_CNT  ] );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] );
+  FD_TEST( fd_fseq_leave( tx_fseq ) );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) test_rx_delete( cfg->rx + rx_idx );
+
+  FD_TEST( fd_dcache_delete( cfg->relay_dcache_mem ) );
+  FD_TEST( fd_mcache_delete( cfg->relay_mcache_mem ) );
+  FD_TEST( fd_cnc_delete   ( cfg->relay_cnc_mem    ) );
+
+  fd_wksp_free_laddr( cfg->relay_dcache_mem  );
+  fd_wksp_free_laddr( cfg->relay_mcache_mem  );
+  fd_wksp_free_laddr( cfg->relay_scratch_mem );
+  fd_wksp_free_laddr( cfg->relay_cnc_mem     );
+
+  test_tx_delete( cfg->tx );
+
+  fd_wksp_delete_anonymous( rx_wksp );
+  fd_wksp_delete_anonymous( tx_wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_AVX capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -2,9 +2,6 @@
 
 #if FD_HAS_HOSTED && FD_HAS_X86
 
-#include "../../util/net/fd_pcap.h"
-#include <stdio.h>
-#include <errno.h>
 
 #define SCRATCH_ALLOC( a, s ) (__extension__({                    \
     ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
@@ -27,11 +24,38 @@ fd_replay_tile_scratch_footprint( ulong out_cnt ) {
   return fd_ulong_align_up( scratch_top, fd_replay_tile_scratch_align() );
 }
 
+/* fd_replay_copy copies the sz byte packet at pkt in the pcap mapping to
+   the dcache chunk at dst with non-temporal stores.  If hdr is non-NULL,
+   the first sizeof(fd_eth_hdr_t) bytes of the packet are replaced with
+   hdr (see fd_pcap_mmap_iter_next).  In this case, the head of the
+   packet is staged such that all stores to dst are non-temporal. */
+
+static inline void
+fd_replay_copy( uchar *              dst,
+                uchar const *        pkt,
+                ulong                sz,
+                fd_eth_hdr_t const * hdr ) {
+  if( FD_LIKELY( !hdr ) ) {
+    fd_disco_copy_nt( dst, pkt, sz );
+    return;
+  }
+  uchar head[ 32 ] __attribute__((aligned(32)));
+  ulong head_sz = fd_ulong_min( sz, 32UL );
+  memcpy( head, hdr, sizeof(fd_eth_hdr_t) );
+  memcpy( head + sizeof(fd_eth_hdr_t), pkt + sizeof(fd_eth_hdr_t), head_sz - sizeof(fd_eth_hdr_t) );
+  fd_disco_copy_nt( dst, head, head_sz );
+  if( sz>32UL ) fd_disco_copy_nt( dst + 32UL, pkt + 32UL, sz - 32UL );
+}
+
 int
 fd_replay_tile( fd_cnc_t *       cnc,
                 char const *     pcap_path,
+                int              pcap_flags,
                 ulong            pkt_max,
                 ulong            orig,
+                int              pace,
+                float            pace_rate,
+                ulong            loop_cnt,
                 fd_frag_meta_t * mcache,
                 uchar *          dcache,
                 ulong            out_cnt,
@@ -50,10 +74,26 @@ fd_replay_tile( fd_cnc_t *       cnc,
   ulong   cnc_diag_pcap_pub_sz;   /* Accumulates pcap payload bytes publised between housekeeping events */
   ulong   cnc_diag_pcap_filt_cnt; /* Accumulates number of pcap packets filtered between housekeeping events */
   ulong   cnc_diag_pcap_filt_sz;  /* Accumulates pcap payload bytes filtered between housekeeping events */
+  ulong   cnc_diag_pcap_late_cnt; /* Accumulates number of pcap packets published late between housekeeping events */
+  ulong   cnc_diag_pcap_loop_cnt; /* Accumulates number of passes through the pcap completed between housekeeping events */
 
   /* in pcap stream state */
-  FILE *           pcap_file; /* handle of pcap file stream */
-  fd_pcap_iter_t * pcap_iter; /* iterator for the pcap file stream */
+  fd_pcap_mmap_iter_t  pcap_iter[1]; /* iterator over the memory mapped pcap */
+  uchar const *        pkt;          /* pending packet (in the pcap mapping), NULL if none */
+  ulong                pkt_sz;       /* size of the pending packet */
+  long                 pkt_ts;       /* pcap timestamp of the pending packet (ns) */
+  fd_eth_hdr_t const * pkt_hdr;      /* phony header of the pending packet (see fd_pcap_mmap_iter_next) */
+  long                 ts0;          /* pcap timestamp of the first packet in the pcap */
+  long                 ts1;          /* pcap timestamp of the most recent packet in the pcap */
+  long                 pass_ts;      /* offset added to pcap timestamps of the current pass such that time is continuous over passes */
+  ulong                pass_cnt;     /* number of packets read so far in the current pass */
+  ulong                loop_rem;     /* number of passes remaining (including the current one) */
+
+  /* pacing state */
+  double pace_tick; /* TS: local ticks per pcap ns, PPS: local ticks per packet, BPS: local ticks per payload byte */
+  double sched;     /* local ticks after play0 when the pending packet should be published */
+  long   play0;     /* local tickcount when the replay started */
+  long   late_min;  /* packets published more than this many ticks after their scheduled time are late */
 
   /* out frag stream state */
   ulong   depth;  /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
@@ -92,11 +132,25 @@ fd_replay_tile( fd_cnc_t *       cnc,
     /* cnc state init */
 
     if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
-    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<128UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 128" )); return 1; }
     if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
 
     cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
 
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",      FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,             1U },
+      { "backp_cnt",     FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT,            1U },
+      { "chunk_idx",     FD_CNC_METRIC_TYPE_GAUGE,   FD_REPLAY_CNC_DIAG_CHUNK_IDX,     1U },
+      { "pcap_done",     FD_CNC_METRIC_TYPE_GAUGE,   FD_REPLAY_CNC_DIAG_PCAP_DONE,     1U },
+      { "pcap_pub_cnt",  FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_PUB_CNT,  1U },
+      { "pcap_pub_sz",   FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ,   1U },
+      { "pcap_filt_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT, 1U },
+      { "pcap_filt_sz",  FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ,  1U },
+      { "pcap_late_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_LATE_CNT, 1U },
+      { "pcap_loop_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_REPLAY_CNC_DIAG_PCAP_LOOP_CNT, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
     /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
        cleared during first housekeeping if credits available */
     cnc_diag_in_backp      = 1UL;
@@ -106,20 +160,17 @@ fd_replay_tile( fd_cnc_t *       cnc,
     cnc_diag_pcap_pub_sz   = 0UL;
     cnc_diag_pcap_filt_cnt = 0UL;
     cnc_diag_pcap_filt_sz  = 0UL;
+    cnc_diag_pcap_late_cnt = 0UL;
+    cnc_diag_pcap_loop_cnt = 0UL;
 
     /* in pcap stream init */
 
     if( FD_UNLIKELY( !pkt_max ) ) { FD_LOG_WARNING(( "pkt_max must be positive" )); return 1; }
     if( FD_UNLIKELY( !pcap_path ) ) { FD_LOG_WARNING(( "NULL pcap path" )); return 1; }
-    FD_LOG_INFO(( "Opening pcap %s (pkt_max %lu)", pcap_path, pkt_max ));
-    pcap_file = fopen( pcap_path, "r" );
-    if( FD_UNLIKELY( !pcap_file ) ) { FD_LOG_WARNING(( "fopen failed" )); return 1; }
+    /* (the pcap itself is mapped last such that the mapping can't leak
+       if boot fails) */
 
-    pcap_iter = fd_pcap_iter_new( pcap_file );
-    if( FD_UNLIKELY( !pcap_iter ) ) { FD_LOG_WARNING(( "fd_pcap_iter_new failed" )); return 1; }
-    FD_COMPILER_MFENCE();
-    cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_DONE ] = 0UL; /* Clear before entering running state */
-    FD_COMPILER_MFENCE();
+    loop_rem = loop_cnt ? loop_cnt : ULONG_MAX; /* ULONG_MAX passes is forever for all practical purposes */
 
     /* out frag stream init */
 
@@ -190,12 +241,53 @@ fd_replay_tile( fd_cnc_t *       cnc,
     async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
     if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
 
+    /* pacing init */
+
+    double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+    FD_LOG_INFO(( "Configuring pacing (pace %i, pace_rate %g, loop_cnt %lu)", pace, (double)pace_rate, loop_cnt ));
+    switch( pace ) {
+    case FD_REPLAY_PACE_NONE: pace_tick = 0.;                                     break;
+    case FD_REPLAY_PACE_TS:   pace_tick = tick_per_ns / (double)pace_rate;        break;
+    case FD_REPLAY_PACE_PPS:  pace_tick = tick_per_ns * 1e9 / (double)pace_rate;  break;
+    case FD_REPLAY_PACE_BPS:  pace_tick = tick_per_ns * 8e9 / (double)pace_rate;  break;
+    default: FD_LOG_WARNING(( "unsupported pace" )); return 1;
+    }
+    if( FD_UNLIKELY( pace && !((pace_rate>0.f) & (pace_rate<=FLT_MAX)) ) ) {
+      FD_LOG_WARNING(( "pace_rate must be finite and positive" ));
+      return 1;
+    }
+    sched    = 0.;
+    late_min = (long)async_min;
+
+    /* in pcap stream map */
+
+    FD_LOG_INFO(( "Mapping pcap %s (pkt_max %lu, flags %i)", pcap_path, pkt_max, pcap_flags ));
+    if( FD_UNLIKELY( !fd_pcap_mmap_iter_new( pcap_iter, pcap_path, pcap_flags ) ) ) {
+      FD_LOG_WARNING(( "fd_pcap_mmap_iter_new failed" ));
+      return 1;
+    }
+
+    /* Peek at the first packet to find the start of the pcap timeline */
+
+    pkt = fd_pcap_mmap_iter_next( pcap_iter, &pkt_sz, &pkt_ts, &pkt_hdr );
+    ts0 = pkt ? pkt_ts : 0L;
+    ts1 = ts0;
+    fd_pcap_mmap_iter_rewind( pcap_iter );
+    pkt      = NULL;
+    pass_ts  = 0L;
+    pass_cnt = 0UL;
+
+    FD_COMPILER_MFENCE();
+    cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_DONE ] = 0UL; /* Clear before entering running state */
+    FD_COMPILER_MFENCE();
+
   } while(0);
 
   FD_LOG_INFO(( "Running replay (orig %lu)", orig ));
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
   long then = fd_tickcount();
   long now  = then;
+  play0 = now;
   for(;;) {
 
     /* Do housekeeping at a low rate in the background */
@@ -220,12 +312,16 @@ fd_replay_tile( fd_cnc_t *       cnc,
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   ] += cnc_diag_pcap_pub_sz;
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT ] += cnc_diag_pcap_filt_cnt;
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  ] += cnc_diag_pcap_filt_sz;
+      cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_LATE_CNT ] += cnc_diag_pcap_late_cnt;
+      cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_LOOP_CNT ] += cnc_diag_pcap_loop_cnt;
       FD_COMPILER_MFENCE();
       cnc_diag_backp_cnt     = 0UL;
       cnc_diag_pcap_pub_cnt  = 0UL;
       cnc_diag_pcap_pub_sz   = 0UL;
       cnc_diag_pcap_filt_cnt = 0UL;
       cnc_diag_pcap_filt_sz  = 0UL;
+      cnc_diag_pcap_late_cnt = 0UL;
+      cnc_diag_pcap_loop_cnt = 0UL;
 
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
@@ -262,32 +358,77 @@ fd_replay_tile( fd_cnc_t *       cnc,
     }
     cnc_diag_in_backp = 0UL;
 
-    /* Try to load the next packet directly into the dcache at chunk */
-
     if( FD_UNLIKELY( cnc_diag_pcap_done ) ) {
       FD_SPIN_PAUSE();
       now = fd_tickcount();
       continue;
     }
 
-    long  ts;
-    ulong sz = fd_pcap_iter_next( pcap_iter, fd_chunk_to_laddr( base, chunk ), pkt_max, &ts );
-    if( FD_UNLIKELY( !sz ) ) {
-      cnc_diag_pcap_done = 1UL;
-      now = fd_tickcount();
-      continue;
+    /* Get the next packet to replay if we don't have one pending */
+
+    if( FD_LIKELY( !pkt ) ) {
+      pkt = fd_pcap_mmap_iter_next( pcap_iter, &pkt_sz, &pkt_ts, &pkt_hdr );
+
+      if( FD_UNLIKELY( !pkt ) ) {
+
+        /* End of a pass.  If there are more passes to do (and this pass
+           wasn't empty), start the next pass one average inter-packet
+           gap after the last packet of this pass such that the replayed
+           timeline is continuous. */
+
+        cnc_diag_pcap_loop_cnt++;
+        loop_rem--;
+        if( FD_UNLIKELY( (!loop_rem) | (!pass_cnt) ) ) {
+          cnc_diag_pcap_done = 1UL;
+          now = fd_tickcount();
+          continue;
+        }
+        long span = ts1 - ts0;
+        pass_ts += span + (pass_cnt>1UL ? span/(long)(pass_cnt-1UL) : 0L);
+        pass_cnt = 0UL;
+        fd_pcap_mmap_iter_rewind( pcap_iter );
+        now = fd_tickcount();
+        continue;
+      }
+
+      pass_cnt++;
+      ts1 = pkt_ts;
+
+      if( FD_UNLIKELY( pkt_sz>pkt_max ) ) { /* Filtered packets don't count against the pacing */
+        cnc_diag_pcap_filt_cnt++;
+        cnc_diag_pcap_filt_sz += pkt_sz;
+        pkt = NULL;
+        now = fd_tickcount();
+        continue;
+      }
+
+      if( pace==FD_REPLAY_PACE_TS ) sched = pace_tick*(double)(pkt_ts + pass_ts - ts0);
     }
 
-    int should_filter = 0; /* FIXME: filter logic goes here */
+    /* If pacing, wait until the pending packet is due.  If we've fallen
+       behind (e.g. because of backpressure), we publish as fast as we
+       can until we catch up and count the packets published late. */
 
-    if( FD_UNLIKELY( should_filter ) ) {
-      cnc_diag_pcap_filt_cnt++;
-      cnc_diag_pcap_filt_sz += sz;
-      now = fd_tickcount();
-      continue;
+    if( FD_LIKELY( pace ) ) {
+      long lag = now - (play0 + (long)sched);
+      if( lag<0L ) {
+        FD_SPIN_PAUSE();
+        now = fd_tickcount();
+        continue;
+      }
+      cnc_diag_pcap_late_cnt += (ulong)(lag>late_min);
     }
 
-    ulong sig = (ulong)ts; /* FIXME: TEMPORARY HACK */
+    /* Copy the packet straight from the mapping into the dcache with
+       non-temporal stores (the replay never reads the payload again and
+       the consumers are on other cores) and make the copy visible
+       before the metadata that describes it. */
+
+    ulong sz = pkt_sz;
+    fd_replay_copy( (uchar *)fd_chunk_to_laddr( base, chunk ), pkt, sz, pkt_hdr );
+    fd_disco_copy_fence();
+
+    ulong sig = (ulong)(pkt_ts + pass_ts); /* FIXME: TEMPORARY HACK */
     ulong ctl = fd_frag_meta_ctl( orig, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
 
     now = fd_tickcount();
@@ -300,6 +441,9 @@ fd_replay_tile( fd_cnc_t *       cnc,
     chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
     seq   = fd_seq_inc( seq, 1UL );
     cr_avail--;
+    pkt   = NULL;
+    if(      pace==FD_REPLAY_PACE_PPS ) sched += pace_tick;
+    else if( pace==FD_REPLAY_PACE_BPS ) sched += pace_tick*(double)sz;
     cnc_diag_pcap_pub_cnt++;
     cnc_diag_pcap_pub_sz += sz;
   }
@@ -311,9 +455,8 @@ fd_replay_tile( fd_cnc_t *       cnc,
     FD_LOG_INFO(( "Destroying fctl" ));
     fd_fctl_delete( fd_fctl_leave( fctl ) );
 
-    FD_LOG_INFO(( "Closing pcap" ));
-    if( FD_UNLIKELY( fclose( fd_pcap_iter_delete( pcap_iter ) ) ) )
-      FD_LOG_WARNING(( "fclose failed (%i-%s)", errno, strerror( errno ) ));
+    FD_LOG_INFO(( "Unmapping pcap" ));
+    fd_pcap_mmap_iter_delete( pcap_iter );
 
     FD_LOG_INFO(( "Halted replay" ));
     fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
@@ -2,9 +2,12 @@
 #define HEADER_fd_src_disco_replay_fd_replay_h
 
 /* fd_replay provides services to replay data from a pcap file into a
-   tango frag stream. */
+   tango frag stream.  The pcap is memory mapped (see fd_pcap_mmap) and
+   packets are copied straight from the mapping into the dcache such
+   that replaying large captures is not limited by stdio. */
 
 #include "../fd_disco_base.h"
+#include "../../util/net/fd_pcap_mmap.h"
 
 #if FD_HAS_HOSTED && FD_HAS_X86
 
@@ -28,8 +31,10 @@
      PCAP_PUB_SZ   is the number of pcap packet payload bytes published by the replay
      PCAP_FILT_CNT is the number of pcap packets filtered by the replay
      PCAP_FILT_SZ  is the number of pcap packet payload bytes filtered by the replay
+     PCAP_LATE_CNT is the number of pcap packets published late by a paced replay
+     PCAP_LOOP_CNT is the number of passes through the pcap completed by the replay
 
-   As such, the cnc app region must be at least 64B in size.
+   As such, the cnc app region must be at least 128B in size.
 
    Except for IN_BACKP, none of the diagnostics are cleared at
    tile startup (as such that they can be accumulated over multiple
@@ -41,6 +46,23 @@
 #define FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   (5UL) /* ", frequently */
 #define FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT (6UL) /* ", frequently */
 #define FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  (7UL) /* ", frequently */
+#define FD_REPLAY_CNC_DIAG_PCAP_LATE_CNT (8UL) /* On 2nd cache line of app region, updated by producer, frequently */
+#define FD_REPLAY_CNC_DIAG_PCAP_LOOP_CNT (9UL) /* ", rarely */
+
+/* FD_REPLAY_PACE_* specify how a replay tile times the publication of
+   pcap packets.
+
+     NONE publishes packets as fast as flow control allows.
+     TS   publishes packets with the relative timing of their pcap
+          timestamps, sped up by a factor of pace_rate (e.g. 1 reproduces
+          the capture's timing and 4 plays it 4x faster).
+     PPS  publishes packets at a fixed rate of pace_rate packets/s.
+     BPS  publishes packets at a fixed rate of pace_rate payload bits/s. */
+
+#define FD_REPLAY_PACE_NONE (0)
+#define FD_REPLAY_PACE_TS   (1)
+#define FD_REPLAY_PACE_PPS  (2)
+#define FD_REPLAY_PACE_BPS  (3)
 
 /* FD_REPLAY_TILE_OUT_MAX are the maximum number of outputs a replay
    tile can have.  These limits are more or less arbitrary from a
@@ -85,6 +107,32 @@ FD_PROTOTYPES_BEGIN
    operation in the current implementation, all reliable consumers
    should be halted and/or caught up before this tile is halted.
 
+   The pcap at pcap_path can be a classic pcap or a pcapng capture of
+   Ethernet or cooked packets (see fd_pcap_mmap_iter_next for how cooked
+   packets are replayed).  pcap_flags is a set of FD_PCAP_MMAP_FLAG_*
+   used when mapping it (e.g. FD_PCAP_MMAP_FLAG_POPULATE to take all
+   the page faults on boot for a capture that fits in memory).  Packet
+   payloads are copied into the dcache with non-temporal stores.
+   Packets larger than pkt_max are filtered.
+
+   pace and pace_rate select the timing of the replay (see
+   FD_REPLAY_PACE_*).  Times are converted to local ticks with
+   fd_tempo_tick_per_ns.  A paced replay never publishes a packet before
+   its scheduled time.  If it falls behind schedule (e.g. because of
+   backpressure), it publishes packets as fast as it can until it
+   catches up and counts the packets published late (lazy bounds how
+   precisely packets are published at their scheduled times).  Filtered
+   packets do not count against the schedule.  pace_rate is ignored for
+   FD_REPLAY_PACE_NONE and should otherwise be finite and positive.
+
+   loop_cnt is the number of passes to make through the pcap (0 means
+   loop until halted).  The replayed stream is continuous over passes:
+   sequence numbers keep incrementing and each pass is scheduled (and
+   has its pcap timestamps offset) as though the pcap were followed by
+   another copy of itself, one average inter-packet gap after its last
+   packet.  PCAP_DONE is set when all
+   passes are complete.
+
    There are no theoretical restrictions on the mcache depth.
    Practically, it is recommend it be as large as possible, especially
    for bursty streams and/or a large number of reliable consumers.  This
@@ -142,18 +190,22 @@ FD_FN_CONST ulong
 fd_replay_tile_scratch_footprint( ulong out_cnt );
 
 int
-fd_replay_tile( fd_cnc_t *       cnc,       /* Local join to the replay's command-and-control */
-                char const *     pcap_path, /* Points to first byte of cstr with the path to the pcap to use */
-                ulong            pkt_max,   /* Upper bound of a size of packet in the pcap */
-                ulong            orig,      /* Origin for this pcap fragment stream, in [0,FD_FRAG_META_ORIG_MAX) */
-                fd_frag_meta_t * mcache,    /* Local join to the replay's frag stream output mcache */
-                uchar *          dcache,    /* Local join to the replay's frag stream output dcache */
-                ulong            out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
-                ulong **         out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
-                ulong            cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
-                long             lazy,      /* Lazyiness, <=0 means use a reasonable default */
-                fd_rng_t *       rng,       /* Local join to the rng this replay should use */
-                void *           scratch ); /* Tile scratch memory */
+fd_replay_tile( fd_cnc_t *       cnc,        /* Local join to the replay's command-and-control */
+                char const *     pcap_path,  /* Points to first byte of cstr with the path to the pcap to use */
+                int              pcap_flags, /* FD_PCAP_MMAP_FLAG_* to use when mapping the pcap */
+                ulong            pkt_max,    /* Largest packet to replay, larger packets in the pcap are filtered */
+                ulong            orig,       /* Origin for this pcap fragment stream, in [0,FD_FRAG_META_ORIG_MAX) */
+                int              pace,       /* FD_REPLAY_PACE_* */
+                float            pace_rate,  /* Speed up (TS), packets/s (PPS) or bits/s (BPS) of a paced replay */
+                ulong            loop_cnt,   /* Number of passes to make through the pcap, 0 means until halted */
+                fd_frag_meta_t * mcache,     /* Local join to the replay's frag stream output mcache */
+                uchar *          dcache,     /* Local join to the replay's frag stream output dcache */
+                ulong            out_cnt,    /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+                ulong **         out_fseq,   /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+                ulong            cr_max,     /* Maximum number of flow control credits, 0 means use a reasonable default */
+                long             lazy,       /* Lazyiness, <=0 means use a reasonable default */
+                fd_rng_t *       rng,        /* Local join to the rng this replay should use */
+                void *           scratch );  /* Tile scratch memory */
 
 FD_PROTOTYPES_END
 
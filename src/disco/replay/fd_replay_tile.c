@@ -11,16 +11,20 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Init" ));
 
-  char const * _cnc       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",       NULL, NULL   );
-  char const * _pcap      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pcap",      NULL, NULL   );
-  ulong        pkt_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-max",   NULL, 1522UL );
-  ulong        orig       = fd_env_strip_cmdline_ulong( &argc, &argv, "--orig",      NULL, 0UL    );
-  char const * _mcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",    NULL, NULL   );
-  char const * _dcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dcache",    NULL, NULL   );
-  char const * _out_fseqs = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs", NULL, ""     );
-  ulong        cr_max     = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",    NULL, 0UL    ); /*   0 <> use default */
-  long         lazy       = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",      NULL, 0L     ); /* <=0 <> use default */
-  uint         seed       = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",      NULL, (uint)(ulong)fd_tickcount() );
+  char const * _cnc       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",        NULL, NULL   );
+  char const * _pcap      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pcap",       NULL, NULL   );
+  int          pcap_flags = fd_env_strip_cmdline_int  ( &argc, &argv, "--pcap-flags", NULL, 0      ); /* FD_PCAP_MMAP_FLAG_* */
+  ulong        pkt_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-max",    NULL, 1522UL );
+  ulong        orig       = fd_env_strip_cmdline_ulong( &argc, &argv, "--orig",       NULL, 0UL    );
+  char const * _pace      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pace",       NULL, "none" ); /* none, ts, pps or bps */
+  float        pace_rate  = fd_env_strip_cmdline_float( &argc, &argv, "--pace-rate",  NULL, 1.f    );
+  ulong        loop_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--loop-cnt",   NULL, 1UL    ); /*   0 <> until halted */
+  char const * _mcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",     NULL, NULL   );
+  char const * _dcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dcache",     NULL, NULL   );
+  char const * _out_fseqs = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",  NULL, ""     );
+  ulong        cr_max     = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",     NULL, 0UL    ); /*   0 <> use default */
+  long         lazy       = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",       NULL, 0L     ); /* <=0 <> use default */
+  uint         seed       = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",       NULL, (uint)(ulong)fd_tickcount() );
 
   if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
   FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
@@ -28,7 +32,15 @@ main( int     argc,
   if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
 
   if( FD_UNLIKELY( !_pcap ) ) FD_LOG_ERR(( "--pcap not specified" ));
-  FD_LOG_NOTICE(( "Using --pcap %s", _pcap ));
+  FD_LOG_NOTICE(( "Using --pcap %s (--pcap-flags %i)", _pcap, pcap_flags ));
+
+  int pace;
+  if(      !strcmp( _pace, "none" ) ) pace = FD_REPLAY_PACE_NONE;
+  else if( !strcmp( _pace, "ts"   ) ) pace = FD_REPLAY_PACE_TS;
+  else if( !strcmp( _pace, "pps"  ) ) pace = FD_REPLAY_PACE_PPS;
+  else if( !strcmp( _pace, "bps"  ) ) pace = FD_REPLAY_PACE_BPS;
+  else FD_LOG_ERR(( "unsupported --pace %s (should be none, ts, pps or bps)", _pace ));
+  FD_LOG_NOTICE(( "Using --pace %s, --pace-rate %g, --loop-cnt %lu", _pace, (double)pace_rate, loop_cnt ));
 
   if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
   FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
@@ -69,7 +81,7 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_replay_tile( cnc, _pcap, pkt_max, orig, mcache, dcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_replay_tile( cnc, _pcap, pcap_flags, pkt_max, orig, pace, pace_rate, loop_cnt, mcache, dcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_replay_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
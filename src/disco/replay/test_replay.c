@@ -10,6 +10,13 @@ FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_PUB_CNT ==4UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ  ==5UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT==6UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ ==7UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_LATE_CNT==8UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_LOOP_CNT==9UL, unit_test );
+
+FD_STATIC_ASSERT( FD_REPLAY_PACE_NONE==0, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_PACE_TS  ==1, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_PACE_PPS ==2, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_PACE_BPS ==3, unit_test );
 
 FD_STATIC_ASSERT( FD_REPLAY_TILE_OUT_MAX==8192UL, unit_test );
 
@@ -20,8 +27,12 @@ struct test_cfg {
 
   fd_cnc_t *       tx_cnc;
   char const *     tx_pcap;
+  int              tx_pcap_flags;
   ulong            tx_mtu;
   ulong            tx_orig;
+  int              tx_pace;
+  float            tx_pace_rate;
+  ulong            tx_loop_cnt;
   fd_frag_meta_t * tx_mcache;
   uchar *          tx_dcache;
   ulong            tx_cr_max;
@@ -49,7 +60,8 @@ tx_tile_main( int     argc,
 
   uchar scratch[ FD_REPLAY_TILE_SCRATCH_FOOTPRINT( 1UL ) ] __attribute__((aligned( FD_REPLAY_TILE_SCRATCH_ALIGN )));
 
-  FD_TEST( !fd_replay_tile( cfg->tx_cnc, cfg->tx_pcap, cfg->tx_mtu, cfg->tx_orig, cfg->tx_mcache, cfg->tx_dcache,
+  FD_TEST( !fd_replay_tile( cfg->tx_cnc, cfg->tx_pcap, cfg->tx_pcap_flags, cfg->tx_mtu, cfg->tx_orig,
+                            cfg->tx_pace, cfg->tx_pace_rate, cfg->tx_loop_cnt, cfg->tx_mcache, cfg->tx_dcache,
                             1UL, &cfg->rx_fseq, cfg->tx_cr_max, cfg->tx_lazy, rng, scratch ) );
 
   fd_rng_delete( fd_rng_leave( rng ) );
@@ -184,17 +196,21 @@ main( int     argc,
   ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
   if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
 
-  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                   );
-  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                          );
-  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx( cpu_idx ) );
-  char const * tx_pcap   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tx-pcap",   NULL, NULL                         );
-  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",    NULL, 1542UL                       );
-  ulong        tx_orig   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-orig",   NULL, 0UL                          );
-  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",  NULL, 32768UL                      );
-  ulong        tx_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cr-max", NULL, 0UL /* use default */        );
-  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",   NULL, 0L /* use default */         );
-  int          rx_lazy   = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",   NULL, 7                            );
-  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",  NULL, (long)10e9                   );
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",       NULL, "gigantic"                   );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",      NULL, 1UL                          );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",      NULL, fd_shmem_numa_idx( cpu_idx ) );
+  char const * tx_pcap   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tx-pcap",       NULL, NULL                         );
+  int          tx_pflags = fd_env_strip_cmdline_int  ( &argc, &argv, "--tx-pcap-flags", NULL, 0                            );
+  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",        NULL, 1542UL                       );
+  ulong        tx_orig   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-orig",       NULL, 0UL                          );
+  int          tx_pace   = fd_env_strip_cmdline_int  ( &argc, &argv, "--tx-pace",       NULL, FD_REPLAY_PACE_NONE          );
+  float        tx_rate   = fd_env_strip_cmdline_float( &argc, &argv, "--tx-pace-rate",  NULL, 1.f                          );
+  ulong        tx_loops  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-loop-cnt",   NULL, 1UL                          );
+  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",      NULL, 32768UL                      );
+  ulong        tx_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cr-max",     NULL, 0UL /* use default */        );
+  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",       NULL, 0L /* use default */         );
+  int          rx_lazy   = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",       NULL, 7                            );
+  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",      NULL, (long)10e9                   );
 
   ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
   if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz"  ));
@@ -211,14 +227,18 @@ main( int     argc,
   cfg->wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( cfg->wksp );
 
-  FD_LOG_NOTICE(( "Creating tx cnc (app_sz 64, type 0, heartbeat0 %li)", hb0 ));
-  cfg->tx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) ),
-                             64UL, 0UL, hb0 ) );
+  FD_LOG_NOTICE(( "Creating tx cnc (app_sz 128, type 0, heartbeat0 %li)", hb0 ));
+  cfg->tx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( 128UL ) ),
+                            128UL, 0UL, hb0 ) );
   FD_TEST( cfg->tx_cnc );
 
-  cfg->tx_pcap = tx_pcap;
-  cfg->tx_mtu  = tx_mtu;
-  cfg->tx_orig = tx_orig;
+  cfg->tx_pcap       = tx_pcap;
+  cfg->tx_pcap_flags = tx_pflags;
+  cfg->tx_mtu        = tx_mtu;
+  cfg->tx_orig       = tx_orig;
+  cfg->tx_pace       = tx_pace;
+  cfg->tx_pace_rate  = tx_rate;
+  cfg->tx_loop_cnt   = tx_loops;
 
   FD_LOG_NOTICE(( "Creating tx mcache (--tx-depth %lu, app_sz 0, seq0 %lu)", tx_depth, seq0 ));
   cfg->tx_mcache = fd_mcache_join( fd_mcache_new( fd_wksp_alloc_laddr( cfg->wksp,
@@ -257,14 +277,16 @@ main( int     argc,
   FD_TEST( fd_cnc_wait( cfg->tx_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
   FD_TEST( fd_cnc_wait( cfg->rx_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --tx-cr-max %lu, tx_seed %u, --rx-lazy %i)",
-                  duration, tx_lazy, tx_cr_max, cfg->tx_seed, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --tx-cr-max %lu, tx_seed %u, --rx-lazy %i, "
+                  "--tx-pace %i, --tx-pace-rate %g, --tx-loop-cnt %lu)",
+                  duration, tx_lazy, tx_cr_max, cfg->tx_seed, rx_lazy, tx_pace, (double)tx_rate, tx_loops ));
 
   ulong const * tx_cnc_diag = (ulong const *)fd_cnc_app_laddr( cfg->tx_cnc );
 
   long now  = fd_log_wallclock();
   long next = now;
   long done = now + duration;
+  long run0 = now;
   for(;;) {
     long now = fd_log_wallclock();
     if( FD_UNLIKELY( (now-done) >= 0L ) ) {
@@ -280,12 +302,31 @@ main( int     argc,
       ulong pub_sz    = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   ];
       ulong filt_cnt  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT ];
       ulong filt_sz   = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  ];
+      ulong late_cnt  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_LATE_CNT ];
+      ulong loop_cnt  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_LOOP_CNT ];
       FD_COMPILER_MFENCE();
       FD_LOG_NOTICE(( "monitor\n\t"
-                      "tx: pub_cnt %20lu pub_sz %20lu filt_cnt %20lu filt_sz %20lu",
-                      pub_cnt, pub_sz, filt_cnt, filt_sz ));
+                      "tx: pub_cnt %20lu pub_sz %20lu filt_cnt %20lu filt_sz %20lu late_cnt %20lu loop_cnt %5lu",
+                      pub_cnt, pub_sz, filt_cnt, filt_sz, late_cnt, loop_cnt ));
       if( FD_UNLIKELY( pcap_done ) ) {
         FD_LOG_NOTICE(( "pcap replay finished before duration" ));
+
+        /* All the passes were made with every packet either published
+           or filtered each pass */
+
+        ulong pass_cnt = (pub_cnt+filt_cnt) / tx_loops;
+        FD_TEST( loop_cnt==tx_loops );
+        FD_TEST( pass_cnt*tx_loops==(pub_cnt+filt_cnt) );
+
+        /* A paced replay never publishes early (the expected durations
+           are for the first packet published at the start of the run
+           and the last one published at its scheduled time) */
+
+        double elapsed = (double)(now - run0);
+        if( tx_pace==FD_REPLAY_PACE_PPS )
+          FD_TEST( elapsed >= 0.99e9*(double)(pub_cnt-1UL)/(double)tx_rate );
+        if( tx_pace==FD_REPLAY_PACE_BPS )
+          FD_TEST( elapsed >= 0.99e9*8.*(double)(pub_sz-tx_mtu)/(double)tx_rate );
         break;
       }
       next += (long)1e9;
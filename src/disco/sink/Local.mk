@@ -0,0 +1,4 @@
+$(call add-hdrs,fd_sink.h)
+$(call add-objs,fd_sink,fd_disco)
+$(call make-unit-test,test_sink,test_sink,fd_disco fd_tango fd_util)
+$(call make-bin,fd_sink_tile,fd_sink_tile,fd_disco fd_tango fd_util)
@@ -0,0 +1,674 @@
+#define _GNU_SOURCE /* For O_DIRECT */
+#include "fd_sink.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* These match the layout fd_pcap_fwrite_hdr / fd_pcap_fwrite_pkt use */
+
+struct fd_sink_pcap_hdr {
+  uint   magic_number;
+  ushort version_major;
+  ushort version_minor;
+  int    thiszone;
+  uint   sigfigs;
+  uint   snaplen;
+  uint   network;
+};
+
+typedef struct fd_sink_pcap_hdr fd_sink_pcap_hdr_t;
+
+struct fd_sink_pcap_pkt_hdr {
+  uint sec;
+  uint nsec;
+  uint incl_len;
+  uint orig_len;
+};
+
+typedef struct fd_sink_pcap_pkt_hdr fd_sink_pcap_pkt_hdr_t;
+
+/* fd_sink_uring_t is a minimal io_uring used to submit buffer writes
+   and reap their completions.  There is no liburing dependency so this
+   uses the raw system calls and the ring layout described in
+   linux/io_uring.h.  fd is -1 if io_uring is not in use. */
+
+struct fd_sink_uring {
+  int                   fd;
+  void *                sq_map;     ulong sq_map_sz;
+  void *                cq_map;     ulong cq_map_sz;  /* ==sq_map if the kernel supports a single mapping for both rings */
+  struct io_uring_sqe * sqe;        ulong sqe_map_sz;
+  uint *                sq_tail;
+  uint *                sq_mask;
+  uint *                sq_array;
+  uint *                cq_head;
+  uint *                cq_tail;
+  uint *                cq_mask;
+  struct io_uring_cqe * cqe;
+  uint                  sq_pend;    /* Number of sqes queued but not yet consumed by the kernel */
+};
+
+typedef struct fd_sink_uring fd_sink_uring_t;
+
+static inline int
+fd_sink_uring_setup( uint                    entries,
+                     struct io_uring_params * params ) {
+  return (int)syscall( __NR_io_uring_setup, entries, params );
+}
+
+static inline int
+fd_sink_uring_enter( int  fd,
+                     uint to_submit,
+                     uint min_complete,
+                     uint flags ) {
+  return (int)syscall( __NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0UL );
+}
+
+static void
+fd_sink_uring_fini( fd_sink_uring_t * uring ) {
+  if( uring->sqe                                     ) munmap( uring->sqe,    uring->sqe_map_sz );
+  if( uring->cq_map && (uring->cq_map!=uring->sq_map) ) munmap( uring->cq_map, uring->cq_map_sz );
+  if( uring->sq_map                                  ) munmap( uring->sq_map, uring->sq_map_sz );
+  if( uring->fd>=0                                   ) close( uring->fd );
+  uring->fd = -1;
+}
+
+/* fd_sink_uring_init creates an io_uring with room for entries
+   submissions in flight.  Returns 0 on success and an errno compatible
+   error code on failure (uring->fd will be -1). */
+
+static int
+fd_sink_uring_init( fd_sink_uring_t * uring,
+                    uint              entries ) {
+  fd_memset( uring, 0, sizeof(fd_sink_uring_t) );
+  uring->fd = -1;
+
+  struct io_uring_params params[1];
+  fd_memset( params, 0, sizeof(struct io_uring_params) );
+  int fd = fd_sink_uring_setup( entries, params );
+  if( FD_UNLIKELY( fd<0 ) ) return errno;
+  uring->fd = fd;
+
+  uring->sq_map_sz = (ulong)params->sq_off.array + (ulong)params->sq_entries*sizeof(uint);
+  uring->cq_map_sz = (ulong)params->cq_off.cqes  + (ulong)params->cq_entries*sizeof(struct io_uring_cqe);
+  int single = !!(params->features & IORING_FEAT_SINGLE_MMAP);
+  if( single ) uring->sq_map_sz = uring->cq_map_sz = fd_ulong_max( uring->sq_map_sz, uring->cq_map_sz );
+
+  void * sq_map = mmap( NULL, uring->sq_map_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+  if( FD_UNLIKELY( sq_map==MAP_FAILED ) ) { int err = errno; fd_sink_uring_fini( uring ); return err; }
+  uring->sq_map = sq_map;
+
+  void * cq_map = sq_map;
+  if( !single ) {
+    cq_map = mmap( NULL, uring->cq_map_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+    if( FD_UNLIKELY( cq_map==MAP_FAILED ) ) { int err = errno; fd_sink_uring_fini( uring ); return err; }
+  }
+  uring->cq_map = cq_map;
+
+  uring->sqe_map_sz = (ulong)params->sq_entries*sizeof(struct io_uring_sqe);
+  void * sqe = mmap( NULL, uring->sqe_map_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+  if( FD_UNLIKELY( sqe==MAP_FAILED ) ) { int err = errno; fd_sink_uring_fini( uring ); return err; }
+  uring->sqe = (struct io_uring_sqe *)sqe;
+
+  uring->sq_tail  = (uint *)((ulong)sq_map + params->sq_off.tail        );
+  uring->sq_mask  = (uint *)((ulong)sq_map + params->sq_off.ring_mask   );
+  uring->sq_array = (uint *)((ulong)sq_map + params->sq_off.array       );
+  uring->cq_head  = (uint *)((ulong)cq_map + params->cq_off.head        );
+  uring->cq_tail  = (uint *)((ulong)cq_map + params->cq_off.tail        );
+  uring->cq_mask  = (uint *)((ulong)cq_map + params->cq_off.ring_mask   );
+  uring->cqe      = (struct io_uring_cqe *)((ulong)cq_map + params->cq_off.cqes );
+  uring->sq_pend  = 0U;
+  return 0;
+}
+
+/* fd_sink_uring_flush hands any queued submissions to the kernel.
+   Returns 0 on success (including the kernel being temporarily unable
+   to accept them, in which case they stay queued) and an errno
+   compatible error code on failure. */
+
+static int
+fd_sink_uring_flush( fd_sink_uring_t * uring ) {
+  if( FD_LIKELY( !uring->sq_pend ) ) return 0;
+  int ret = fd_sink_uring_enter( uring->fd, uring->sq_pend, 0U, 0U );
+  if( FD_UNLIKELY( ret<0 ) ) {
+    int err = errno;
+    return ((err==EAGAIN) | (err==EBUSY) | (err==EINTR)) ? 0 : err;
+  }
+  uring->sq_pend -= fd_uint_min( (uint)ret, uring->sq_pend );
+  return 0;
+}
+
+/* A fd_sink_writer_t tracks the write buffers that have been handed to
+   the kernel.  Buffer i (at buf + i*buf_sz) is being written if bit i of
+   busy is set.  The sink only ever reuses a buffer after its write
+   completed. */
+
+struct fd_sink_writer {
+  int               fd;       /* Capture file descriptor */
+  int               direct;   /* 1 if the capture was opened with O_DIRECT */
+  int               fail;     /* 1 if a write failed */
+  ulong             fail_off; /* If fail, the lowest capture offset of a failed write */
+  uchar *           buf;      /* Write buffers, buf_cnt*buf_sz bytes, FD_SINK_TILE_BUF_ALIGN aligned */
+  ulong             buf_sz;
+  ulong             busy;
+  ulong             file_sz;  /* Number of capture bytes completely written */
+  ulong             len[ FD_SINK_TILE_BUF_CNT_MAX ]; /* len[i] is the size of the write of buffer i in progress */
+  ulong             off[ FD_SINK_TILE_BUF_CNT_MAX ]; /* off[i] is the capture offset of the write of buffer i in progress */
+  fd_sink_uring_t   uring[1];
+};
+
+typedef struct fd_sink_writer fd_sink_writer_t;
+
+static void
+fd_sink_writer_fail( fd_sink_writer_t * w,
+                     ulong              off,
+                     int                err ) {
+  if( !w->fail ) FD_LOG_WARNING(( "capture write at offset %lu failed (%i-%s); ending capture", off, err, strerror( err ) ));
+  w->fail_off = w->fail ? fd_ulong_min( w->fail_off, off ) : off;
+  w->fail     = 1;
+}
+
+/* fd_sink_writer_write starts writing len bytes of buffer buf_idx to
+   the capture at offset off.  If the writer is synchronous, the write
+   is done before return. */
+
+static void
+fd_sink_writer_write( fd_sink_writer_t * w,
+                      ulong              buf_idx,
+                      ulong              len,
+                      ulong              off ) {
+  uchar const * buf = w->buf + buf_idx*w->buf_sz;
+
+  fd_sink_uring_t * uring = w->uring;
+  if( FD_UNLIKELY( uring->fd<0 ) ) { /* Synchronous fallback */
+    ulong rem = len;
+    while( rem ) {
+      long ret = pwrite( w->fd, buf + len - rem, rem, (long)(off + len - rem) );
+      if( FD_UNLIKELY( ret<=0L ) ) {
+        if( FD_LIKELY( (ret<0L) && (errno==EINTR) ) ) continue;
+        fd_sink_writer_fail( w, off, ret<0L ? errno : EIO );
+        return;
+      }
+      rem -= (ulong)ret;
+    }
+    w->file_sz += len;
+    return;
+  }
+
+  /* We are the only producer of sqes so the tail can be read plainly.
+     The sqe and array entry must be visible before the tail update
+     (x86 stores are not reordered with other stores so a compiler
+     fence suffices). */
+
+  uint tail = *uring->sq_tail;
+  uint idx  = tail & FD_VOLATILE_CONST( *uring->sq_mask );
+
+  struct io_uring_sqe * sqe = uring->sqe + idx;
+  fd_memset( sqe, 0, sizeof(struct io_uring_sqe) );
+  sqe->opcode    = (uchar)IORING_OP_WRITE;
+  sqe->fd        = w->fd;
+  sqe->addr      = (ulong)buf;
+  sqe->len       = (uint)len;
+  sqe->off       = off;
+  sqe->user_data = buf_idx;
+  uring->sq_array[ idx ] = idx;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *uring->sq_tail ) = tail + 1U;
+  FD_COMPILER_MFENCE();
+  uring->sq_pend++;
+
+  w->busy          |= 1UL << buf_idx;
+  w->len[ buf_idx ] = len;
+  w->off[ buf_idx ] = off;
+
+  int err = fd_sink_uring_flush( uring );
+  if( FD_UNLIKELY( err ) ) fd_sink_writer_fail( w, off, err );
+}
+
+/* fd_sink_writer_reap processes all the write completions the kernel
+   has posted. */
+
+static void
+fd_sink_writer_reap( fd_sink_writer_t * w ) {
+  fd_sink_uring_t * uring = w->uring;
+  if( FD_UNLIKELY( uring->fd<0 ) ) return;
+
+  uint head = *uring->cq_head;
+  FD_COMPILER_MFENCE();
+  uint tail = FD_VOLATILE_CONST( *uring->cq_tail );
+  FD_COMPILER_MFENCE();
+  if( FD_LIKELY( head==tail ) ) return;
+
+  uint mask = FD_VOLATILE_CONST( *uring->cq_mask );
+  for( ; head!=tail; head++ ) {
+    struct io_uring_cqe const * cqe = uring->cqe + (head & mask);
+    ulong buf_idx = (ulong)cqe->user_data;
+    int   res     = cqe->res;
+    if( FD_UNLIKELY( buf_idx>=FD_SINK_TILE_BUF_CNT_MAX ) ) continue; /* Paranoia */
+    if( FD_UNLIKELY( (res<0) | ((ulong)res!=w->len[ buf_idx ]) ) ) /* Short writes to a regular file only happen on errors */
+      fd_sink_writer_fail( w, w->off[ buf_idx ], res<0 ? -res : EIO );
+    else w->file_sz += w->len[ buf_idx ];
+    w->busy &= ~(1UL << buf_idx);
+  }
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *uring->cq_head ) = head;
+  FD_COMPILER_MFENCE();
+
+  if( FD_UNLIKELY( uring->sq_pend ) ) {
+    int err = fd_sink_uring_flush( uring );
+    if( FD_UNLIKELY( err ) ) fd_sink_writer_fail( w, w->file_sz, err );
+  }
+}
+
+/* fd_sink_writer_drain blocks until all writes in progress have
+   completed. */
+
+static void
+fd_sink_writer_drain( fd_sink_writer_t * w ) {
+  fd_sink_uring_t * uring = w->uring;
+  if( FD_UNLIKELY( uring->fd<0 ) ) return;
+  while( w->busy ) {
+    int ret = fd_sink_uring_enter( uring->fd, uring->sq_pend, 1U, IORING_ENTER_GETEVENTS );
+    if( FD_LIKELY( ret>=0 ) ) uring->sq_pend -= fd_uint_min( (uint)ret, uring->sq_pend );
+    else if( FD_UNLIKELY( (errno!=EAGAIN) & (errno!=EBUSY) & (errno!=EINTR) ) ) {
+      FD_LOG_WARNING(( "io_uring_enter failed (%i-%s); abandoning %i writes in progress",
+                       errno, strerror( errno ), fd_ulong_popcnt( w->busy ) ));
+      fd_sink_writer_fail( w, w->file_sz, errno );
+      return;
+    }
+    fd_sink_writer_reap( w );
+  }
+}
+
+/* fd_sink_append copies n bytes from src to offset off of a record
+   that starts in the current buffer at d0 (with rem bytes left in the
+   current buffer) and continues at the start of the next buffer d1. */
+
+static inline void
+fd_sink_append( uchar *      d0,
+                ulong        rem,
+                uchar *      d1,
+                ulong        off,
+                void const * src,
+                ulong        n ) {
+  uchar const * s = (uchar const *)src;
+  if( FD_LIKELY( off<rem ) ) {
+    ulong n0 = fd_ulong_min( n, rem-off );
+    fd_memcpy( d0 + off, s, n0 );
+    s   += n0;
+    n   -= n0;
+    off += n0;
+  }
+  if( FD_UNLIKELY( n ) ) fd_memcpy( d1 + (off-rem), s, n );
+}
+
+ulong
+fd_sink_tile_scratch_align( void ) {
+  return FD_SINK_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_sink_tile_scratch_footprint( ulong buf_cnt,
+                                ulong buf_sz ) {
+  if( FD_UNLIKELY( (buf_cnt<FD_SINK_TILE_BUF_CNT_MIN) | (buf_cnt>FD_SINK_TILE_BUF_CNT_MAX) ) ) return 0UL;
+  if( FD_UNLIKELY( (buf_sz<FD_SINK_TILE_BUF_SZ_MIN) | (!fd_ulong_is_aligned( buf_sz, FD_SINK_TILE_BUF_ALIGN )) ) ) return 0UL;
+  if( FD_UNLIKELY( buf_sz>(ULONG_MAX/buf_cnt) ) ) return 0UL;
+  return buf_cnt*buf_sz;
+}
+
+int
+fd_sink_tile( fd_cnc_t *             cnc,
+              char const *           sink_path,
+              ulong                  buf_cnt,
+              ulong                  buf_sz,
+              fd_frag_meta_t const * in_mcache,
+              ulong *                in_fseq,
+              void const *           in_base,
+              long                   lazy,
+              fd_rng_t *             rng,
+              void *                 scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;          /* ==fd_cnc_app_laddr( cnc ), local address of the sink tile cnc diagnostic region */
+  ulong   cnc_diag_busy_cnt; /* Number of times the sink started dropping because all buffers were being written */
+
+  /* in frag stream state */
+  ulong                  in_depth; /* ==fd_mcache_depth( in_mcache ), depth of the in's mcache */
+  ulong                  in_seq;   /* sequence number of next frag expected from the in */
+  fd_frag_meta_t const * in_mline; /* ==in_mcache + fd_mcache_line_idx( in_seq, in_depth ), location to poll next */
+  uint                   in_accum[6]; /* local diagnostic accumulators, drained during in housekeeping */
+                                      /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+
+  /* capture state */
+  fd_sink_writer_t w[1];    /* Capture file and write buffers */
+  ulong            buf_idx; /* Index of the buffer being filled */
+  ulong            buf_off; /* Number of bytes of buffer buf_idx filled, in [0,buf_sz) */
+  ulong            file_off;/* Capture offset of buffer buf_idx */
+  int              busy;    /* 1 if the sink is currently dropping because the buffers it needs are being written */
+  fd_tempo_clock_t clock[1];/* Converts frag timestamps to wallclock, refreshed during housekeeping */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting sink (buf-cnt %lu, buf-sz %lu)", buf_cnt, buf_sz ));
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp", FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,      1U },
+      { "fail",     FD_CNC_METRIC_TYPE_GAUGE,   FD_SINK_CNC_DIAG_FAIL,     1U },
+      { "file_sz",  FD_CNC_METRIC_TYPE_COUNTER, FD_SINK_CNC_DIAG_FILE_SZ,  1U },
+      { "busy_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_SINK_CNC_DIAG_BUSY_CNT, 1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* The sink never backpressures so in_backp is always 0 */
+    cnc_diag[ FD_CNC_DIAG_IN_BACKP       ] = 0UL;
+    cnc_diag[ FD_SINK_CNC_DIAG_FAIL      ] = 0UL;
+    cnc_diag[ FD_SINK_CNC_DIAG_FILE_SZ   ] = 0UL;
+    cnc_diag[ FD_SINK_CNC_DIAG_BUSY_CNT  ] = 0UL;
+    cnc_diag_busy_cnt = 0UL;
+
+    /* in frag stream init */
+
+    if( FD_UNLIKELY( !in_mcache ) ) { FD_LOG_WARNING(( "NULL in_mcache" )); return 1; }
+    if( FD_UNLIKELY( !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
+    if( FD_UNLIKELY( !in_base   ) ) { FD_LOG_WARNING(( "NULL in_base"   )); return 1; }
+
+    in_depth = fd_mcache_depth( in_mcache );
+    in_seq   = fd_mcache_seq_query( fd_mcache_seq_laddr_const( in_mcache ) ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
+    in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+    in_accum[0] = 0U; in_accum[1] = 0U; in_accum[2] = 0U;
+    in_accum[3] = 0U; in_accum[4] = 0U; in_accum[5] = 0U;
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( in_depth );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+    /* capture init (last such that nothing needs to be cleaned up on
+       failure above) */
+
+    if( FD_UNLIKELY( !fd_sink_tile_scratch_footprint( buf_cnt, buf_sz ) ) ) {
+      FD_LOG_WARNING(( "bad buf_cnt or buf_sz" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_sink_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !sink_path ) ) { FD_LOG_WARNING(( "NULL sink_path" )); return 1; }
+
+    fd_memset( w, 0, sizeof(fd_sink_writer_t) );
+    w->buf    = (uchar *)scratch;
+    w->buf_sz = buf_sz;
+
+    /* Captures can be long so we track tickcount / wallclock drift when
+       converting frag timestamps */
+
+    if( FD_UNLIKELY( !fd_tempo_clock_join( fd_tempo_clock_new( clock, 0., 0L ) ) ) ) return 1; /* logs details */
+
+    FD_LOG_INFO(( "Creating capture file %s", sink_path ));
+    w->direct = 1;
+    w->fd     = open( sink_path, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644 );
+    if( FD_UNLIKELY( (w->fd<0) && (errno==EINVAL) ) ) { /* File system does not support O_DIRECT */
+      FD_LOG_INFO(( "O_DIRECT not supported for %s; using buffered writes", sink_path ));
+      w->direct = 0;
+      w->fd     = open( sink_path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    }
+    if( FD_UNLIKELY( w->fd<0 ) ) {
+      FD_LOG_WARNING(( "open(\"%s\") failed (%i-%s)", sink_path, errno, strerror( errno ) ));
+      return 1;
+    }
+
+    int err = fd_sink_uring_init( w->uring, (uint)buf_cnt );
+    if( FD_UNLIKELY( err ) )
+      FD_LOG_WARNING(( "io_uring unavailable (%i-%s); using synchronous writes (expect overruns under load)",
+                       err, strerror( err ) ));
+
+    buf_idx  = 0UL;
+    buf_off  = sizeof(fd_sink_pcap_hdr_t);
+    file_off = 0UL;
+    busy     = 0;
+
+    fd_sink_pcap_hdr_t * hdr = (fd_sink_pcap_hdr_t *)w->buf;
+    hdr->magic_number  = 0xa1b23c4dU; /* ns resolution */
+    hdr->version_major = (ushort)2;
+    hdr->version_minor = (ushort)4;
+    hdr->thiszone      = 0;
+    hdr->sigfigs       = 0U;
+    hdr->snaplen       = (uint)USHORT_MAX;
+    hdr->network       = 1U; /* Ethernet */
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running sink" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Process completed writes */
+
+      fd_sink_writer_reap( w );
+
+      /* Update the in's fseq (the sink is an unreliable consumer so
+         this is for monitoring only) and drain the in diagnostics */
+
+      fd_fseq_update( in_fseq, in_seq );
+
+      ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+      ulong a0 = (ulong)in_accum[0]; ulong a1 = (ulong)in_accum[1]; ulong a2 = (ulong)in_accum[2];
+      ulong a3 = (ulong)in_accum[3]; ulong a4 = (ulong)in_accum[4]; ulong a5 = (ulong)in_accum[5];
+      FD_COMPILER_MFENCE();
+      diag[0] += a0;                 diag[1] += a1;                 diag[2] += a2;
+      diag[3] += a3;                 diag[4] += a4;                 diag[5] += a5;
+      FD_COMPILER_MFENCE();
+      in_accum[0] = 0U;              in_accum[1] = 0U;              in_accum[2] = 0U;
+      in_accum[3] = 0U;              in_accum[4] = 0U;              in_accum[5] = 0U;
+
+      /* Track tickcount / wallclock drift */
+      fd_tempo_clock_refresh( clock, now );
+
+      /* Send diagnostic info */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_SINK_CNC_DIAG_FAIL     ] = (ulong)w->fail;
+      cnc_diag[ FD_SINK_CNC_DIAG_FILE_SZ  ] = w->file_sz;
+      cnc_diag[ FD_SINK_CNC_DIAG_BUSY_CNT ] = cnc_diag_busy_cnt;
+      FD_COMPILER_MFENCE();
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_SINK_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Capture up to a batch worth of new in frags.  We stop the batch
+       early if the in is caught up. */
+
+    ulong batch_cnt = 0UL;
+    for( ulong poll_rem=FD_SINK_TILE_BATCH_MAX; poll_rem; poll_rem-- ) {
+
+      /* Check if the in has a new fragment to capture */
+
+      FD_COMPILER_MFENCE();
+      ulong seq_found = in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      long diff = fd_seq_diff( in_seq, seq_found );
+      if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+        if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (the in does not know about us so this is possible) */
+          in_seq    = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
+          in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+        }
+        break;
+      }
+
+      /* We have a new fragment to capture.  Try to load its metadata. */
+
+      FD_COMPILER_MFENCE();
+      ulong chunk      = (ulong)in_mline->chunk;
+      ulong sz         = (ulong)in_mline->sz;
+      ulong tspub      = (ulong)in_mline->tspub;
+      FD_COMPILER_MFENCE();
+      ulong seq_test   =        in_mline->seq;
+      FD_COMPILER_MFENCE();
+
+      if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading */
+        in_seq    = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
+        in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+        in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+        break;
+      }
+
+      /* Append the record to the buffer being filled, spilling into the
+         next buffer if necessary.  If a buffer we need is still being
+         written, check for completions and, if still busy, drop the
+         frag.  Once the capture has failed, stay failed (no gaps). */
+
+      ulong rec_sz   = sizeof(fd_sink_pcap_pkt_hdr_t) + sz;
+      ulong rem      = buf_sz - buf_off;
+      ulong next_idx = fd_ulong_if( buf_idx+1UL<buf_cnt, buf_idx+1UL, 0UL );
+      ulong need     = (1UL << buf_idx) | fd_ulong_if( rec_sz>rem, 1UL << next_idx, 0UL );
+
+      if( FD_UNLIKELY( w->busy & need ) ) fd_sink_writer_reap( w );
+      int stalled = !!(w->busy & need);
+      if( FD_UNLIKELY( stalled & !busy ) ) cnc_diag_busy_cnt++;
+      busy = stalled;
+
+      ulong should_filter = (ulong)(w->fail | stalled);
+
+      if( FD_LIKELY( !should_filter ) ) {
+        long ts = fd_tempo_clock_ns( clock, fd_frag_meta_ts_decomp( tspub, now ) );
+
+        fd_sink_pcap_pkt_hdr_t pkt_hdr[1];
+        pkt_hdr->sec      = (uint)(((ulong)ts) / (ulong)1e9);
+        pkt_hdr->nsec     = (uint)(((ulong)ts) % (ulong)1e9);
+        pkt_hdr->incl_len = (uint)sz;
+        pkt_hdr->orig_len = (uint)sz;
+
+        uchar * d0 = w->buf + buf_idx *buf_sz + buf_off;
+        uchar * d1 = w->buf + next_idx*buf_sz;
+        fd_sink_append( d0, rem, d1, 0UL,                            pkt_hdr,                                      sizeof(fd_sink_pcap_pkt_hdr_t) );
+        fd_sink_append( d0, rem, d1, sizeof(fd_sink_pcap_pkt_hdr_t), fd_chunk_to_laddr_const( in_base, chunk ), sz                             );
+
+        seq_test = fd_frag_meta_seq_query( in_mline );
+        if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while copying (the partial record will be overwritten) */
+          in_seq    = seq_test;
+          in_mline  = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+          in_accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+          break;
+        }
+
+        /* Commit the record and, if the buffer filled up, start writing
+           it and move on to the next buffer */
+
+        buf_off += rec_sz;
+        if( FD_UNLIKELY( buf_off>=buf_sz ) ) {
+          fd_sink_writer_write( w, buf_idx, buf_sz, file_off );
+          file_off += buf_sz;
+          buf_off  -= buf_sz;
+          buf_idx   = next_idx;
+        }
+      }
+
+      /* Windup for the next in poll and accumulate diagnostics */
+
+      in_seq   = fd_seq_inc( in_seq, 1UL );
+      in_mline = in_mcache + fd_mcache_line_idx( in_seq, in_depth );
+
+      ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + should_filter*2UL;
+      in_accum[ diag_idx     ]++;
+      in_accum[ diag_idx+1UL ] += (uint)sz;
+
+      batch_cnt++;
+    }
+
+    if( FD_UNLIKELY( !batch_cnt ) ) FD_SPIN_PAUSE(); /* Optimize for capturing under load */
+    now = fd_tickcount();
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting sink" ));
+
+    /* Write the partially filled buffer (O_DIRECT writes need to be
+       block aligned so this might write some padding that gets
+       truncated below), wait for all writes to complete and drain the
+       diagnostics. */
+
+    ulong file_sz = file_off + buf_off;
+    if( FD_LIKELY( (!w->fail) & (!!buf_off) ) ) {
+      ulong len = w->direct ? fd_ulong_align_up( buf_off, FD_SINK_TILE_BUF_ALIGN ) : buf_off;
+      fd_memset( w->buf + buf_idx*buf_sz + buf_off, 0, len - buf_off );
+      fd_sink_writer_write( w, buf_idx, len, file_off );
+    }
+    fd_sink_writer_drain( w );
+    if( FD_UNLIKELY( w->fail ) ) file_sz = fd_ulong_min( file_sz, w->fail_off );
+    w->file_sz = fd_ulong_min( w->file_sz, file_sz );
+
+    fd_fseq_update( in_fseq, in_seq );
+    ulong * diag = (ulong *)fd_fseq_app_laddr( in_fseq );
+    FD_COMPILER_MFENCE();
+    for( ulong diag_idx=0UL; diag_idx<6UL; diag_idx++ ) diag[ diag_idx ] += (ulong)in_accum[ diag_idx ];
+    cnc_diag[ FD_SINK_CNC_DIAG_FAIL     ] = (ulong)w->fail;
+    cnc_diag[ FD_SINK_CNC_DIAG_FILE_SZ  ] = w->file_sz;
+    cnc_diag[ FD_SINK_CNC_DIAG_BUSY_CNT ] = cnc_diag_busy_cnt;
+    FD_COMPILER_MFENCE();
+
+    FD_LOG_INFO(( "Closing capture file (%lu bytes%s)", file_sz, w->fail ? ", failed" : "" ));
+    if( FD_UNLIKELY( ftruncate( w->fd, (long)file_sz ) ) )
+      FD_LOG_WARNING(( "ftruncate failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+    if( FD_UNLIKELY( close( w->fd ) ) )
+      FD_LOG_WARNING(( "close failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+    fd_sink_uring_fini( w->uring );
+
+    FD_LOG_INFO(( "Halted sink" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef HEADER_fd_src_disco_sink_fd_sink_h
+#define HEADER_fd_src_disco_sink_fd_sink_h
+
+/* fd_sink provides a tile that captures a tango fragment stream to a
+   pcap file (e.g. to see exactly what a verify or dedup tile emitted
+   with standard tools or to feed it back into a pipeline with
+   fd_replay_tile).  Like fd_rec_tile, the sink is an unreliable
+   consumer such that it can be attached to any point of a production
+   pipeline without ever backpressuring the producer.  Unlike
+   fd_rec_tile, the capture is not limited by the size of a memory
+   mapping.  Records are batched into large aligned buffers that are
+   written to the capture asynchronously such that the sink core never
+   waits on the disk.  When the disk falls behind, frags are dropped
+   (and counted) instead.
+
+   The capture is a classic little endian nanosecond resolution 2.4
+   Ethernet pcap file with the same layout fd_pcap_fwrite_hdr and
+   fd_pcap_fwrite_pkt produce.  Each frag is one packet: the packet
+   bytes are the frag payload verbatim (no FCS is appended as the
+   payload is typically not an Ethernet frame) and the packet timestamp
+   is the frag's publication time as a wallclock.  As such, the snap
+   length in the capture header is USHORT_MAX (the largest possible frag
+   size) instead of FD_PCAP_SNAPLEN. */
+
+#include "../fd_disco_base.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_SINK_CNC_SIGNAL_ACK can be
+   raised by a cnc thread with an open command session while the sink is
+   in the RUN state.  The sink will transition from ACK->RUN the next
+   time it processes cnc signals to indicate it is running normally.  If
+   a signal other than ACK, HALT, or RUN is raised, it will be logged as
+   unexpected and transitioned by back to RUN. */
+
+#define FD_SINK_CNC_SIGNAL_ACK (4UL)
+
+/* A fd_sink_tile will use the fseq and cnc application regions to
+   accumulate diagnostics in the standard ways.  Frags captured are
+   accumulated to the in fseq's PUB_{CNT,SZ}, frags that could not be
+   captured (because all the write buffers were waiting on the disk or
+   because the capture failed) are accumulated to its FILT_{CNT,SZ} and
+   overruns are accumulated to its OVRNP_CNT and OVRNR_CNT.  It
+   additionally will accumulate to the cnc application region the
+   following tile specific counters:
+
+     FAIL     is cleared when the tile starts capturing and set if a
+              write to the capture failed (the capture ends at the last
+              completely written buffer before the failure)
+     FILE_SZ  is the number of bytes of the capture that the disk has
+              completed writing
+     BUSY_CNT is the number of times the sink started dropping frags
+              because all the write buffers were waiting on the disk
+
+   As such, the cnc app region must be at least 64B in size. */
+
+#define FD_SINK_CNC_DIAG_FAIL     (2UL) /* On 1st cache line of app region, updated by producer, rarely */
+#define FD_SINK_CNC_DIAG_FILE_SZ  (3UL) /* ", frequently */
+#define FD_SINK_CNC_DIAG_BUSY_CNT (4UL) /* ", rarely */
+
+/* FD_SINK_TILE_BATCH_MAX is the maximum number of frags the sink will
+   capture between checking for housekeeping. */
+
+#define FD_SINK_TILE_BATCH_MAX (64UL)
+
+/* FD_SINK_TILE_BUF_{CNT_MIN,CNT_MAX,SZ_MIN,ALIGN} give the supported
+   range of write buffer configurations.  There must be at least 2
+   buffers (one being filled while the others are written) and the
+   buffer size must be a multiple of FD_SINK_TILE_BUF_ALIGN (which is
+   suitable for O_DIRECT writes on typical file systems) large enough
+   that any record fits in at most 2 consecutive buffers.
+   FD_SINK_TILE_BUF_{CNT,SZ}_DEFAULT give reasonable defaults. */
+
+#define FD_SINK_TILE_BUF_CNT_MIN     (2UL)
+#define FD_SINK_TILE_BUF_CNT_MAX     (64UL)
+#define FD_SINK_TILE_BUF_SZ_MIN      (131072UL)
+#define FD_SINK_TILE_BUF_ALIGN       (4096UL)
+#define FD_SINK_TILE_BUF_CNT_DEFAULT (8UL)
+#define FD_SINK_TILE_BUF_SZ_DEFAULT  (4UL<<20)
+
+#define FD_SINK_TILE_SCRATCH_ALIGN   FD_SINK_TILE_BUF_ALIGN
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_sink_tile captures the fragment stream described by in_mcache
+   (with payloads at chunk addresses relative to in_base) into a newly
+   created pcap file at sink_path (truncated if it already exists).
+
+   The sink is an unreliable consumer.  It never returns flow control
+   credits to the in producer (it is fine for in_fseq to not be one of
+   the producer's reliable consumers) and thus can never backpressure
+   it.  If the sink falls behind the producer, the overrun is counted
+   and the sink resumes from the most recent frag.  Frags that were
+   overrun while their payload was being copied are discarded.
+
+   Records are appended to buf_cnt write buffers of buf_sz bytes each
+   in tile scratch.  When a buffer fills up, it is handed to the kernel
+   for writing (at its offset in the capture) with io_uring and the
+   sink moves on to the next buffer.  If the next buffer is still being
+   written, frags are dropped until it completes.  The capture is
+   opened with O_DIRECT such that the writes bypass the page cache where
+   the file system supports it (buffered writes otherwise).  If io_uring
+   is not available on the host, buffers are written synchronously with
+   pwrite as they fill up (which will likely result in overruns under
+   load but will not backpressure the producer).  Write errors are
+   logged, flagged in the cnc diagnostics and end the capture (later
+   frags are counted as filtered) but the sink keeps consuming such that
+   its diagnostics remain meaningful.
+
+   lazy is the ballpark interval in ns for how often to check for write
+   completions and do housekeeping.  <=0 indicates to pick a
+   conservative default.
+
+   scratch points to tile scratch memory.  fd_sink_tile_scratch_align
+   and fd_sink_tile_scratch_footprint return the required alignment and
+   footprint needed for a sink tile scratch region with buf_cnt buffers
+   of buf_sz bytes.  fd_sink_tile_scratch_footprint returns 0 if
+   buf_cnt / buf_sz are not valid.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the sink tile (see fd_mux_tile for details of
+   the cnc state transitions).  Returns a non-zero error code if the
+   tile fails to boot up (logs details).  All buffered records will be
+   written to the capture and the capture closed by the time the tile
+   returns.
+
+   The lifetime of the cnc, in_mcache, in_fseq, rng and scratch used by
+   this tile should be a superset of this tile's lifetime.  While this
+   tile is running, no other tile should use cnc for its command and
+   control, update in_fseq, use the rng for anything (and the rng should
+   be seeded distinctly from all other rngs in the system) or use
+   scratch for anything.  sink_path will not be used after the tile has
+   successfully booted (transitioned the cnc from BOOT to RUN) or
+   returned (e.g. failed to boot), whichever comes first. */
+
+FD_FN_CONST ulong
+fd_sink_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_sink_tile_scratch_footprint( ulong buf_cnt,
+                                ulong buf_sz );
+
+int
+fd_sink_tile( fd_cnc_t *             cnc,       /* Local join to the sink's command-and-control */
+              char const *           sink_path, /* Points to first byte of cstr with the path of the pcap file to create */
+              ulong                  buf_cnt,   /* Number of write buffers */
+              ulong                  buf_sz,    /* Size of a write buffer in bytes */
+              fd_frag_meta_t const * in_mcache, /* Local join to the in's mcache */
+              ulong *                in_fseq,   /* Local join to the sink's fseq for the in (diagnostics only) */
+              void const *           in_base,   /* Local address of the in's chunk 0 (e.g. the wksp containing the in's dcache) */
+              long                   lazy,      /* Lazyiness, <=0 means use a reasonable default */
+              fd_rng_t *             rng,       /* Local join to the rng this sink should use */
+              void *                 scratch ); /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_HOSTED && FD_HAS_X86 */
+
+#endif /* HEADER_fd_src_disco_sink_fd_sink_h */
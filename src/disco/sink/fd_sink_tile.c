@@ -0,0 +1,101 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+FD_STATIC_ASSERT( FD_SINK_TILE_SCRATCH_ALIGN<=FD_SHMEM_HUGE_PAGE_SZ, alignment );
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  FD_LOG_NOTICE(( "Init" ));
+
+  char const * _cnc       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",       NULL, NULL            );
+  char const * _sink      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--sink",      NULL, NULL            );
+  ulong        buf_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-cnt",   NULL, FD_SINK_TILE_BUF_CNT_DEFAULT );
+  ulong        buf_sz     = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-sz",    NULL, FD_SINK_TILE_BUF_SZ_DEFAULT  );
+  char const * _in_mcache = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcache", NULL, NULL            );
+  char const * _in_dcache = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-dcache", NULL, NULL            );
+  char const * _in_fseq   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseq",   NULL, NULL            );
+  long         lazy       = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",      NULL, 0L              ); /* <=0 <> use default */
+  uint         seed       = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",      NULL, (uint)(ulong)fd_tickcount() );
+
+  if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
+  FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_map( _cnc ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+
+  if( FD_UNLIKELY( !_sink ) ) FD_LOG_ERR(( "--sink not specified" ));
+  FD_LOG_NOTICE(( "Using --sink %s, --buf-cnt %lu, --buf-sz %lu", _sink, buf_cnt, buf_sz ));
+
+  if( FD_UNLIKELY( !_in_mcache ) ) FD_LOG_ERR(( "--in-mcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --in-mcache %s", _in_mcache ));
+  fd_frag_meta_t const * in_mcache = fd_mcache_join( fd_wksp_map( _in_mcache ) );
+  if( FD_UNLIKELY( !in_mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+  /* The in's chunks are indexed relative to the wksp containing the
+     in's dcache (the usual tango convention) */
+
+  if( FD_UNLIKELY( !_in_dcache ) ) FD_LOG_ERR(( "--in-dcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --in-dcache %s", _in_dcache ));
+  uchar * in_dcache = fd_dcache_join( fd_wksp_map( _in_dcache ) );
+  if( FD_UNLIKELY( !in_dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+  void const * in_base = fd_wksp_containing( in_dcache );
+  if( FD_UNLIKELY( !in_base ) ) FD_LOG_ERR(( "fd_wksp_containing failed" ));
+
+  /* The sink is an unreliable consumer so the in fseq should not
+     be one the in producer uses for flow control */
+
+  if( FD_UNLIKELY( !_in_fseq ) ) FD_LOG_ERR(( "--in-fseq not specified" ));
+  FD_LOG_NOTICE(( "Joining --in-fseq %s", _in_fseq ));
+  ulong * in_fseq = fd_fseq_join( fd_wksp_map( _in_fseq ) );
+  if( FD_UNLIKELY( !in_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+
+  FD_LOG_NOTICE(( "Using --lazy %li", lazy ));
+
+  FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+
+  FD_LOG_NOTICE(( "Creating scratch" ));
+  ulong footprint = fd_sink_tile_scratch_footprint( buf_cnt, buf_sz );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_sink_tile_scratch_footprint failed" ));
+  ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
+  ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
+  ulong  cpu_idx  = fd_tile_cpu_id( fd_tile_idx() );
+  void * scratch  = fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+  if( FD_UNLIKELY( !scratch ) ) FD_LOG_ERR(( "fd_shmem_acquire failed (need at least %lu free huge pages on numa node %lu)",
+                                             page_cnt, fd_shmem_numa_idx( cpu_idx ) ));
+
+  FD_LOG_NOTICE(( "Run" ));
+
+  int err = fd_sink_tile( cnc, _sink, buf_cnt, buf_sz, in_mcache, in_fseq, in_base, lazy, rng, scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_sink_tile failed (%i)", err ));
+
+  FD_LOG_NOTICE(( "Fini" ));
+
+  fd_shmem_release( scratch, page_sz, page_cnt );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_unmap( fd_fseq_leave  ( in_fseq   ) );
+  fd_wksp_unmap( fd_dcache_leave( in_dcache ) );
+  fd_wksp_unmap( fd_mcache_leave( in_mcache ) );
+  fd_wksp_unmap( fd_cnc_leave( cnc ) );
+
+  fd_halt();
+  return err;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "implement support for this build target" ));
+  fd_halt();
+  return 1;
+}
+
+#endif
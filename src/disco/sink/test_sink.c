@@ -0,0 +1,261 @@
+#include "../fd_disco.h"
+#include "../fd_disco_test_tile.c"
+
+#if FD_HAS_HOSTED && FD_HAS_AVX
+
+#include <unistd.h> /* For unlink */
+
+FD_STATIC_ASSERT( FD_SINK_CNC_SIGNAL_ACK      ==4UL,      unit_test );
+FD_STATIC_ASSERT( FD_SINK_CNC_DIAG_FAIL       ==2UL,      unit_test );
+FD_STATIC_ASSERT( FD_SINK_CNC_DIAG_FILE_SZ    ==3UL,      unit_test );
+FD_STATIC_ASSERT( FD_SINK_CNC_DIAG_BUSY_CNT   ==4UL,      unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_BATCH_MAX      ==64UL,     unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_BUF_CNT_MIN    ==2UL,      unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_BUF_CNT_MAX    ==64UL,     unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_BUF_SZ_MIN     ==131072UL, unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_BUF_ALIGN      ==4096UL,   unit_test );
+FD_STATIC_ASSERT( FD_SINK_TILE_SCRATCH_ALIGN  ==4096UL,   unit_test );
+
+struct test_cfg {
+  test_tx_t   tx[1];
+
+  uchar *     sink_cnc_mem;
+  char const* sink_path;
+  ulong       sink_buf_cnt;
+  ulong       sink_buf_sz;
+  long        sink_lazy;
+  uint        sink_seed;
+  uchar *     sink_scratch;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+/* SINK tile **********************************************************/
+
+static int
+sink_tile_main( int     argc,
+                char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_cnc_t * cnc = fd_cnc_join( cfg->sink_cnc_mem );
+
+  fd_frag_meta_t const * tx_mcache = fd_mcache_join( cfg->tx->mcache_mem );
+  ulong *                tx_fseq   = fd_fseq_join  ( cfg->tx->fseq_mem   );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->sink_seed, 0UL ) );
+
+  int err = fd_sink_tile( cnc, cfg->sink_path, cfg->sink_buf_cnt, cfg->sink_buf_sz, tx_mcache, tx_fseq, cfg->tx->wksp,
+                          cfg->sink_lazy, rng, cfg->sink_scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_sink_tile failed (%i)", err ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_fseq_leave  ( tx_fseq   );
+  fd_mcache_leave( tx_mcache );
+  fd_cnc_leave( cnc );
+  return 0;
+}
+
+/* CNC tile ***********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  /* Test the scratch requirements */
+
+  FD_TEST( fd_sink_tile_scratch_align()==FD_SINK_TILE_SCRATCH_ALIGN );
+
+  FD_TEST( !fd_sink_tile_scratch_footprint(  1UL, 131072UL         ) ); /* too few buffers */
+  FD_TEST( !fd_sink_tile_scratch_footprint( 65UL, 131072UL         ) ); /* too many buffers */
+  FD_TEST( !fd_sink_tile_scratch_footprint(  2UL, 131072UL-4096UL  ) ); /* too small buffers */
+  FD_TEST( !fd_sink_tile_scratch_footprint(  2UL, 131072UL+512UL   ) ); /* misaligned buffers */
+  FD_TEST( !fd_sink_tile_scratch_footprint( 64UL, ULONG_MAX-4095UL ) ); /* overflow */
+  FD_TEST(  fd_sink_tile_scratch_footprint(  2UL, 131072UL         )==262144UL   );
+  FD_TEST(  fd_sink_tile_scratch_footprint( 64UL, 1UL<<20          )==(64UL<<20) );
+  FD_TEST(  fd_sink_tile_scratch_footprint( FD_SINK_TILE_BUF_CNT_DEFAULT, FD_SINK_TILE_BUF_SZ_DEFAULT )
+            ==FD_SINK_TILE_BUF_CNT_DEFAULT*FD_SINK_TILE_BUF_SZ_DEFAULT );
+
+  /* Test the sink tile */
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                 );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                        );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",  NULL, 32768UL                    );
+  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",    NULL, 1542UL                     );
+  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",   NULL, 0L                         );
+  char const * sink_path = fd_env_strip_cmdline_cstr ( &argc, &argv, "--sink",      NULL, "/tmp/test_sink.pcap"      );
+  ulong        buf_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-cnt",   NULL, 4UL                        );
+  ulong        buf_sz    = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-sz",    NULL, 1UL<<20                    );
+  long         sink_lazy = fd_env_strip_cmdline_long ( &argc, &argv, "--sink-lazy", NULL, 0L /* use default */       );
+  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",  NULL, (long)1e9                  );
+
+  float burst_avg       = fd_env_strip_cmdline_float( &argc, &argv, "--burst-avg",       NULL, 1472.f );
+  ulong pkt_payload_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-payload-max", NULL, 1472UL );
+  ulong pkt_framing     = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-framing",     NULL,   70UL );
+  float pkt_bw          = fd_env_strip_cmdline_float( &argc, &argv, "--pkt-bw",          NULL,   1e9f );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  ulong tile_cnt = 1UL+1UL+1UL; /* 1 main(cnc,this) + 1 tx_main + 1 sink_main */
+  if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
+
+  FD_LOG_NOTICE(( "Creating workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  long now = fd_tickcount();
+
+  test_cfg_t cfg[1];
+
+  ulong tx_seq0 = fd_rng_ulong( rng );
+  test_tx_new( cfg->tx, wksp, tx_depth, tx_mtu, tx_lazy, pkt_framing, pkt_payload_max, burst_avg, pkt_bw,
+               rng_seq++, tx_seq0, now );
+
+  FD_LOG_NOTICE(( "Creating sink scratch (--buf-cnt %lu --buf-sz %lu)", buf_cnt, buf_sz ));
+  ulong sink_scratch_footprint = fd_sink_tile_scratch_footprint( buf_cnt, buf_sz );
+  if( FD_UNLIKELY( !sink_scratch_footprint ) ) FD_LOG_ERR(( "bad --buf-cnt or --buf-sz" ));
+
+  cfg->sink_cnc_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) );
+  cfg->sink_scratch = (uchar *)fd_wksp_alloc_laddr( wksp, fd_sink_tile_scratch_align(), sink_scratch_footprint );
+  FD_TEST( cfg->sink_cnc_mem ); FD_TEST( cfg->sink_scratch );
+  FD_TEST( fd_cnc_new( cfg->sink_cnc_mem, 64UL, 1UL, now ) );
+
+  cfg->sink_path    = sink_path;
+  cfg->sink_buf_cnt = buf_cnt;
+  cfg->sink_buf_sz  = buf_sz;
+  cfg->sink_lazy    = sink_lazy;
+  cfg->sink_seed    = rng_seq++;
+
+  FD_LOG_NOTICE(( "Booting (--sink %s)", sink_path ));
+
+  test_tile_t tile[2];
+  tile[0] = (test_tile_t){ .task = test_tx_tile_main, .arg = cfg->tx, .cnc_mem = cfg->tx->cnc_mem  };
+  tile[1] = (test_tile_t){ .task = sink_tile_main,    .arg = cfg,     .cnc_mem = cfg->sink_cnc_mem };
+  test_tiles_boot( tile, 2UL );
+
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --sink-lazy %li ns)", duration, tx_lazy, sink_lazy ));
+
+  /* FIXME: DO MONITORING WHILE RUNNING */
+  fd_log_sleep( duration );
+
+  test_tiles_halt( tile, 2UL );
+
+  fd_cnc_t *    sink_cnc      = fd_cnc_join( cfg->sink_cnc_mem );
+  ulong const * sink_cnc_diag = (ulong const *)fd_cnc_app_laddr_const( sink_cnc );
+  ulong         sink_fail     = sink_cnc_diag[ FD_SINK_CNC_DIAG_FAIL     ];
+  ulong         sink_file_sz  = sink_cnc_diag[ FD_SINK_CNC_DIAG_FILE_SZ  ];
+  ulong         sink_busy_cnt = sink_cnc_diag[ FD_SINK_CNC_DIAG_BUSY_CNT ];
+  FD_TEST( fd_cnc_leave( sink_cnc ) );
+
+  /* The tx was flow controlled by the sink so the sink should not have
+     been overrun.  Every frag was either captured or filtered (because
+     the disk fell behind). */
+
+  ulong *       tx_fseq      = fd_fseq_join( cfg->tx->fseq_mem );
+  ulong const * tx_fseq_diag = (ulong const *)fd_fseq_app_laddr_const( tx_fseq );
+  ulong         pub_cnt      = tx_fseq_diag[ FD_FSEQ_DIAG_PUB_CNT  ];
+  ulong         pub_sz       = tx_fseq_diag[ FD_FSEQ_DIAG_PUB_SZ   ];
+  ulong         filt_cnt     = tx_fseq_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+  FD_LOG_NOTICE(( "sink pub_cnt %lu pub_sz %lu filt_cnt %lu fail %lu file_sz %lu busy_cnt %lu",
+                  pub_cnt, pub_sz, filt_cnt, sink_fail, sink_file_sz, sink_busy_cnt ));
+  FD_TEST( pub_cnt );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] );
+  FD_TEST( !tx_fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] );
+  FD_TEST( !sink_fail );
+  FD_TEST( (!!sink_busy_cnt)==(!!filt_cnt) );
+  FD_TEST( sink_file_sz==24UL + 16UL*pub_cnt + pub_sz ); /* pcap header + pcap record header and payload per frag */
+  FD_TEST( fd_fseq_leave( tx_fseq ) );
+
+  /* Validate the capture */
+
+  FD_LOG_NOTICE(( "Validating capture" ));
+
+  fd_pcap_mmap_iter_t iter[1];
+  FD_TEST( fd_pcap_mmap_iter_new( iter, sink_path, 0 )==iter );
+  FD_TEST( fd_pcap_mmap_iter_map_sz( iter )==sink_file_sz );
+  FD_TEST( !fd_pcap_mmap_iter_is_pcapng( iter ) );
+
+  /* The sink might have joined the stream after the tx started (the tx
+     only publishes its sync during housekeeping) so the capture starts
+     at an arbitrary tx stream position.  From there, the capture should
+     have every frag in order (with gaps only if frags were filtered). */
+
+  ulong tx_seq  = 0UL;
+  ulong cap_cnt = 0UL;
+  ulong cap_sz  = 0UL;
+  long  ts_last = LONG_MIN;
+  for(;;) {
+    ulong                pkt_sz;
+    long                 pkt_ts;
+    fd_eth_hdr_t const * pkt_hdr;
+    uchar const *        p = fd_pcap_mmap_iter_next( iter, &pkt_sz, &pkt_ts, &pkt_hdr );
+    if( !p ) break;
+    FD_TEST( !pkt_hdr );
+    FD_TEST( pkt_sz>=8UL );
+
+    ulong sig = FD_LOAD( ulong, p );
+    ulong pos = fd_ulong_hash_inverse( sig );
+    if( cap_cnt ) {
+      if( !filt_cnt ) FD_TEST( pos==tx_seq );
+      else            FD_TEST( pos>=tx_seq );
+    }
+    tx_seq = pos + 1UL;
+
+    for( ulong off=0UL; off<pkt_sz; off++ ) FD_TEST( p[ off ]==(uchar)(sig >> (8UL*(off & 7UL))) );
+
+    FD_TEST( pkt_ts>=ts_last );
+    ts_last = pkt_ts;
+
+    cap_cnt++;
+    cap_sz += pkt_sz;
+  }
+  FD_TEST( cap_cnt==pub_cnt );
+  FD_TEST( cap_sz ==pub_sz  );
+
+  /* The timestamps should be wallclocks from the run */
+
+  FD_TEST( (fd_log_wallclock()-ts_last)>=0L         );
+  FD_TEST( (fd_log_wallclock()-ts_last)< (long)60e9 );
+
+  FD_TEST( fd_pcap_mmap_iter_delete( iter )==iter );
+  FD_TEST( !unlink( sink_path ) );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  FD_TEST( fd_cnc_delete( cfg->sink_cnc_mem ) );
+  fd_wksp_free_laddr( cfg->sink_scratch );
+  fd_wksp_free_laddr( cfg->sink_cnc_mem );
+
+  test_tx_delete( cfg->tx );
+
+  fd_wksp_delete_anonymous( wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_AVX capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
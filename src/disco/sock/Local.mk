@@ -0,0 +1,4 @@
+$(call add-hdrs,fd_sock.h)
+$(call add-objs,fd_sock,fd_disco)
+$(call make-unit-test,test_sock,test_sock,fd_disco fd_tango fd_util)
+$(call make-bin,fd_sock_tile,fd_sock_tile,fd_disco fd_tango fd_util)
@@ -0,0 +1,420 @@
+#define _GNU_SOURCE /* For recvmmsg */
+#include "fd_sock.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "../../util/net/fd_ip4.h"
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+FD_STATIC_ASSERT( FD_FCTL_ALIGN<=FD_SOCK_TILE_SCRATCH_ALIGN, packing );
+
+int
+fd_sock_open( uint   ip4_addr,
+              ushort port,
+              int    reuseport,
+              int    rcvbuf_sz ) {
+
+  int sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+  if( FD_UNLIKELY( sock<0 ) ) {
+    FD_LOG_WARNING(( "socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP) failed (%i-%s)", errno, strerror( errno ) ));
+    return -1;
+  }
+
+  int one = 1;
+  if( FD_UNLIKELY( reuseport && setsockopt( sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(int) ) ) ) {
+    FD_LOG_WARNING(( "setsockopt(SO_REUSEPORT) failed (%i-%s)", errno, strerror( errno ) ));
+    close( sock );
+    return -1;
+  }
+
+  /* The kernel silently caps SO_RCVBUF to net.core.rmem_max for
+     unprivileged processes.  SO_RCVBUFFORCE lifts the cap but needs
+     CAP_NET_ADMIN so we try it first and fall back quietly. */
+
+  if( rcvbuf_sz>0 && setsockopt( sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf_sz, sizeof(int) ) ) {
+    if( FD_UNLIKELY( setsockopt( sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf_sz, sizeof(int) ) ) ) {
+      FD_LOG_WARNING(( "setsockopt(SO_RCVBUF,%i) failed (%i-%s)", rcvbuf_sz, errno, strerror( errno ) ));
+      close( sock );
+      return -1;
+    }
+  }
+
+  int flags = fcntl( sock, F_GETFL, 0 );
+  if( FD_UNLIKELY( (flags<0) || fcntl( sock, F_SETFL, flags | O_NONBLOCK ) ) ) {
+    FD_LOG_WARNING(( "fcntl(O_NONBLOCK) failed (%i-%s)", errno, strerror( errno ) ));
+    close( sock );
+    return -1;
+  }
+
+  struct sockaddr_in addr[1];
+  memset( addr, 0, sizeof(struct sockaddr_in) );
+  addr->sin_family      = AF_INET;
+  addr->sin_addr.s_addr = ip4_addr;
+  addr->sin_port        = htons( port );
+  if( FD_UNLIKELY( bind( sock, (struct sockaddr const *)fd_type_pun_const( addr ), sizeof(struct sockaddr_in) ) ) ) {
+    FD_LOG_WARNING(( "bind(" FD_IP4_ADDR_FMT ":%hu) failed (%i-%s)",
+                     FD_IP4_ADDR_FMT_ARGS( ip4_addr ), port, errno, strerror( errno ) ));
+    close( sock );
+    return -1;
+  }
+
+  return sock;
+}
+
+ulong
+fd_sock_tile_scratch_align( void ) {
+  return FD_SOCK_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_sock_tile_scratch_footprint( ulong out_cnt ) {
+  if( FD_UNLIKELY( out_cnt>FD_SOCK_TILE_OUT_MAX ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ); /* fctl */
+  return fd_ulong_align_up( scratch_top, fd_sock_tile_scratch_align() );
+}
+
+int
+fd_sock_tile( fd_cnc_t *       cnc,
+              int              sock,
+              ulong            batch_max,
+              ulong            pkt_max,
+              ulong            orig,
+              ulong            hash_seed,
+              fd_frag_meta_t * mcache,
+              uchar *          dcache,
+              ulong            out_cnt,
+              ulong **         out_fseq,
+              ulong            cr_max,
+              long             lazy,
+              fd_idle_t *      idle,
+              fd_rng_t *       rng,
+              void *           scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;               /* ==fd_cnc_app_laddr( cnc ), local address of the sock tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;      /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt;     /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  ulong   cnc_diag_pub_cnt;       /* Accumulates number of datagrams published between housekeeping events */
+  ulong   cnc_diag_pub_sz;        /* Accumulates datagram payload bytes publised between housekeeping events */
+  ulong   cnc_diag_filt_cnt;      /* Accumulates number of datagrams filtered between housekeeping events */
+  ulong   cnc_diag_filt_sz;       /* Accumulates datagram payload bytes filtered between housekeeping events */
+  ulong   cnc_diag_batch_cnt;     /* Accumulates number of non-empty batches received between housekeeping events */
+  ulong   cnc_diag_err_cnt;       /* Accumulates number of failed receives between housekeeping events */
+
+  /* in socket state */
+  struct mmsghdr msg[ FD_SOCK_TILE_BATCH_MAX ]; /* msg[i] describes where the i-th datagram of a batch is received */
+  struct iovec   iov[ FD_SOCK_TILE_BATCH_MAX ]; /* iov[i] points to the dcache chunk reserved for the i-th datagram of a batch */
+
+  /* out frag stream state */
+  ulong   depth;  /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
+  ulong * sync;   /* ==fd_mcache_seq_laddr( mcache ), local addr where sock tile mcache sync info is published */
+  ulong   seq;    /* seq sock tile frag sequence number to publish */
+
+  void *  base;   /* ==fd_wksp_containing( dcache ), chunk reference address in the tile's local address space */
+  ulong   chunk0; /* ==fd_dcache_compact_chunk0( base, dcache ) */
+  ulong   wmark;  /* ==fd_dcache_compact_wmark ( base, dcache, pkt_max ), datagram chunks start in [chunk0,wmark] */
+  ulong   chunk;  /* Chunk where the next batch's first datagram will be received, in [chunk0,wmark] */
+
+  /* flow control state */
+  fd_fctl_t * fctl;     /* output flow control */
+  ulong       cr_avail; /* number of flow control credits available to publish downstream, in [0,cr_max] */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting sock (out-cnt %lu)", out_cnt ));
+    if( FD_UNLIKELY( out_cnt>FD_SOCK_TILE_OUT_MAX ) ) { FD_LOG_WARNING(( "out_cnt too large" )); return 1; }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_sock_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    static fd_cnc_metric_t const cnc_metric[] = {
+      { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,   FD_CNC_DIAG_IN_BACKP,       1U },
+      { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_CNC_DIAG_BACKP_CNT,      1U },
+      { "pub_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_PUB_CNT,   1U },
+      { "pub_sz",    FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_PUB_SZ,    1U },
+      { "filt_cnt",  FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_FILT_CNT,  1U },
+      { "filt_sz",   FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_FILT_SZ,   1U },
+      { "batch_cnt", FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_BATCH_CNT, 1U },
+      { "err_cnt",   FD_CNC_METRIC_TYPE_COUNTER, FD_SOCK_CNC_DIAG_ERR_CNT,   1U }
+    };
+    fd_cnc_metric_register_try( cnc, cnc_metric, sizeof(cnc_metric)/sizeof(fd_cnc_metric_t), 0UL );
+
+    /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
+       cleared during first housekeeping if credits available */
+    cnc_diag_in_backp  = 1UL;
+    cnc_diag_backp_cnt = 0UL;
+    cnc_diag_pub_cnt   = 0UL;
+    cnc_diag_pub_sz    = 0UL;
+    cnc_diag_filt_cnt  = 0UL;
+    cnc_diag_filt_sz   = 0UL;
+    cnc_diag_batch_cnt = 0UL;
+    cnc_diag_err_cnt   = 0UL;
+
+    /* in socket init */
+
+    if( FD_UNLIKELY( sock<0 ) ) { FD_LOG_WARNING(( "bad sock" )); return 1; }
+    if( FD_UNLIKELY( !((1UL<=batch_max) & (batch_max<=FD_SOCK_TILE_BATCH_MAX)) ) ) {
+      FD_LOG_WARNING(( "batch_max should be in [1,%lu]", FD_SOCK_TILE_BATCH_MAX ));
+      return 1;
+    }
+    if( FD_UNLIKELY( !pkt_max                 ) ) { FD_LOG_WARNING(( "pkt_max must be positive" )); return 1; }
+    if( FD_UNLIKELY( pkt_max>(ulong)USHORT_MAX ) ) { FD_LOG_WARNING(( "pkt_max too large" ));       return 1; }
+
+    memset( msg, 0, sizeof(msg) );
+    for( ulong idx=0UL; idx<FD_SOCK_TILE_BATCH_MAX; idx++ ) {
+      msg[ idx ].msg_hdr.msg_iov    = iov + idx;
+      msg[ idx ].msg_hdr.msg_iovlen = 1UL;
+      iov[ idx ].iov_len            = pkt_max;
+    }
+
+    /* out frag stream init */
+
+    if( FD_UNLIKELY( !mcache ) ) { FD_LOG_WARNING(( "NULL mcache" )); return 1; }
+    depth = fd_mcache_depth    ( mcache );
+    sync  = fd_mcache_seq_laddr( mcache );
+
+    seq = fd_mcache_seq_query( sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION */
+
+    if( FD_UNLIKELY( !dcache ) ) { FD_LOG_WARNING(( "NULL dcache" )); return 1; }
+
+    base = fd_wksp_containing( dcache );
+    if( FD_UNLIKELY( !base ) ) { FD_LOG_WARNING(( "fd_wksp_containing failed" )); return 1; }
+
+    /* Up to batch_max datagrams can be received into the dcache ahead
+       of publication */
+
+    if( FD_UNLIKELY( !fd_dcache_compact_is_safe( base, dcache, pkt_max, depth+batch_max-1UL ) ) ) {
+      FD_LOG_WARNING(( "dcache not compatible with wksp base, pkt_max, batch_max and mcache depth" ));
+      return 1;
+    }
+
+    chunk0 = fd_dcache_compact_chunk0( base, dcache );
+    wmark  = fd_dcache_compact_wmark ( base, dcache, pkt_max );
+    chunk  = chunk0;
+
+    /* out flow control init */
+
+    if( FD_UNLIKELY( !!out_cnt && !out_fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq" )); return 1; }
+
+    fctl = fd_fctl_join( fd_fctl_new( SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ), out_cnt ) );
+    if( FD_UNLIKELY( !fctl ) ) { FD_LOG_WARNING(( "join failed" )); return 1; }
+
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+
+      ulong * fseq = out_fseq[ out_idx ];
+      if( FD_UNLIKELY( !fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq[%lu]", out_idx )); return 1; }
+      ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
+
+      /* Assumes lag_max==depth */
+      if( FD_UNLIKELY( !fd_fctl_cfg_rx_add( fctl, depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) ) ) {
+        FD_LOG_WARNING(( "fd_fctl_cfg_rx_add failed" ));
+        return 1;
+      }
+    }
+
+    /* cr_burst is batch_max because we can publish up to batch_max
+       frags between checking cr_avail.  We use defaults for cr_resume
+       and cr_refill.  cr_max defaults to the mcache depth (the fctl
+       default would be unbounded when there are no reliable outs,
+       which is a poor basis for the default lazy). */
+
+    if( !cr_max ) cr_max = depth;
+    if( FD_UNLIKELY( !fd_fctl_cfg_done( fctl, batch_max, cr_max, 0UL, 0UL ) ) ) {
+      FD_LOG_WARNING(( "fd_fctl_cfg_done failed" ));
+      return 1;
+    }
+    FD_LOG_INFO(( "cr_burst %lu cr_max %lu cr_resume %lu cr_refill %lu",
+                  fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
+
+    cr_max   = fd_fctl_cr_max( fctl );
+    cr_avail = 0UL; /* Will be initialized by run loop */
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( cr_max );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running sock (orig %lu, batch_max %lu, pkt_max %lu)", orig, batch_max, pkt_max ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Send synchronization info */
+      fd_mcache_seq_update( sync, seq );
+      fd_idle_wake( sync, seq );
+
+      /* Send diagnostic info */
+      /* When we drain, we don't do a fully atomic update of the
+         diagnostics as it is only diagnostic and it will still be
+         correct the usual case where individual diagnostic counters
+         aren't used by multiple writers spread over different threads
+         of execution. */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_CNC_DIAG_IN_BACKP       ]  = cnc_diag_in_backp;
+      cnc_diag[ FD_CNC_DIAG_BACKP_CNT      ] += cnc_diag_backp_cnt;
+      cnc_diag[ FD_SOCK_CNC_DIAG_PUB_CNT   ] += cnc_diag_pub_cnt;
+      cnc_diag[ FD_SOCK_CNC_DIAG_PUB_SZ    ] += cnc_diag_pub_sz;
+      cnc_diag[ FD_SOCK_CNC_DIAG_FILT_CNT  ] += cnc_diag_filt_cnt;
+      cnc_diag[ FD_SOCK_CNC_DIAG_FILT_SZ   ] += cnc_diag_filt_sz;
+      cnc_diag[ FD_SOCK_CNC_DIAG_BATCH_CNT ] += cnc_diag_batch_cnt;
+      cnc_diag[ FD_SOCK_CNC_DIAG_ERR_CNT   ] += cnc_diag_err_cnt;
+      FD_COMPILER_MFENCE();
+      cnc_diag_backp_cnt = 0UL;
+      cnc_diag_pub_cnt   = 0UL;
+      cnc_diag_pub_sz    = 0UL;
+      cnc_diag_filt_cnt  = 0UL;
+      cnc_diag_filt_sz   = 0UL;
+      cnc_diag_batch_cnt = 0UL;
+      cnc_diag_err_cnt   = 0UL;
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_SOCK_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Receive flow control credits */
+      cr_avail = fd_fctl_tx_cr_update( fctl, cr_avail, seq );
+
+      /* Reload housekeeping timer */
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured.  If so, count any transition into
+       a backpressured regime and spin to wait for flow control credits
+       to return.  We don't do a fully atomic update here as it is only
+       diagnostic and it will still be correct the usual case where
+       individual diagnostic counters aren't used by writers in
+       different threads of execution.  We only count the transition
+       from not backpressured to backpressured. */
+
+    if( FD_UNLIKELY( !cr_avail ) ) {
+      cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
+      cnc_diag_in_backp   = 1UL;
+      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+    cnc_diag_in_backp = 0UL;
+
+    /* Reserve a pkt_max sized run of chunks for each datagram we can
+       receive with the credits we have and receive a batch straight
+       into them.  The chunks reserved for datagrams that did not arrive
+       are reused for the next batch. */
+
+    ulong batch_cnt   = fd_ulong_min( batch_max, cr_avail );
+    ulong batch_chunk = chunk;
+    for( ulong idx=0UL; idx<batch_cnt; idx++ ) {
+      iov[ idx ].iov_base = fd_chunk_to_laddr( base, batch_chunk );
+      batch_chunk = fd_dcache_compact_next( batch_chunk, pkt_max, chunk0, wmark );
+    }
+
+    /* MSG_TRUNC makes msg_len the full size of a datagram larger than
+       pkt_max (msg_flags still flags it as truncated). */
+
+    int rcv_cnt = recvmmsg( sock, msg, (uint)batch_cnt, MSG_DONTWAIT | MSG_TRUNC, NULL );
+    now = fd_tickcount();
+    if( FD_UNLIKELY( rcv_cnt<=0 ) ) {
+      if( FD_UNLIKELY( rcv_cnt<0 && errno!=EAGAIN && errno!=EWOULDBLOCK ) ) { /* Failed, try again */
+        cnc_diag_err_cnt += (ulong)(errno!=EINTR);
+        continue;
+      }
+      if( FD_UNLIKELY( idle ) ) fd_idle_wait_fd( idle, seq, now, sock ); /* Caught up and idling opted in */
+      else                      FD_SPIN_PAUSE();
+      now = fd_tickcount();
+      continue;
+    }
+    cnc_diag_batch_cnt++;
+
+    /* Publish the batch.  The kernel wrote the payloads with normal
+       stores so they are visible to consumers before the metadata that
+       describes them.  Hashing the payload right after it was received
+       is cheap as it is still hot in cache. */
+
+    ulong ctl    = fd_frag_meta_ctl( orig, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
+    ulong tsorig = fd_frag_meta_ts_comp( now );
+    ulong tspub  = tsorig;
+    for( ulong idx=0UL; idx<(ulong)rcv_cnt; idx++ ) {
+      ulong sz = (ulong)msg[ idx ].msg_len;
+      if( FD_UNLIKELY( msg[ idx ].msg_hdr.msg_flags & MSG_TRUNC ) ) { /* Larger than pkt_max */
+        cnc_diag_filt_cnt++;
+        cnc_diag_filt_sz += sz;
+        chunk = fd_dcache_compact_next( chunk, pkt_max, chunk0, wmark );
+        continue;
+      }
+      ulong sig = fd_hash( hash_seed, iov[ idx ].iov_base, sz );
+      fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+      chunk = fd_dcache_compact_next( chunk, pkt_max, chunk0, wmark );
+      seq   = fd_seq_inc( seq, 1UL );
+      cr_avail--;
+      cnc_diag_pub_cnt++;
+      cnc_diag_pub_sz += sz;
+    }
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting sock" ));
+
+    FD_LOG_INFO(( "Destroying fctl" ));
+    fd_fctl_delete( fd_fctl_leave( fctl ) );
+
+    FD_LOG_INFO(( "Halted sock" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+
+#endif
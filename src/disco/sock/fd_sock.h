@@ -0,0 +1,187 @@
+#ifndef HEADER_fd_src_disco_sock_fd_sock_h
+#define HEADER_fd_src_disco_sock_fd_sock_h
+
+/* fd_sock provides a tile that receives UDP datagrams from a kernel
+   socket into a tango fragment stream (e.g. raw transactions for a
+   verify tile).  Datagrams are received in batches with recvmmsg
+   straight into dcache chunks (no intermediate copy) and each datagram
+   is published as one frag whose sig is a hash of its payload.
+
+   Ingress can be scaled horizontally by running several sock tiles on
+   sockets bound to the same address with SO_REUSEPORT.  The kernel
+   then shards the incoming flows over the tiles (by hash of the
+   source / destination addresses and ports), each tile publishing to
+   its own mcache / dcache. */
+
+#include "../fd_disco_base.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_SOCK_CNC_SIGNAL_ACK can be
+   raised by a cnc thread with an open command session while the sock
+   tile is in the RUN state.  The tile will transition from ACK->RUN the
+   next time it processes cnc signals to indicate it is running
+   normally.  If a signal other than ACK, HALT, or RUN is raised, it
+   will be logged as unexpected and transitioned by back to RUN. */
+
+#define FD_SOCK_CNC_SIGNAL_ACK (4UL)
+
+/* A fd_sock_tile will use the fseq and cnc application regions to
+   accumulate flow control diagnostics in the standard ways.  It
+   additionally will accumulate to the cnc application region the
+   following tile specific counters:
+
+     PUB_CNT   is the number of datagrams published by the tile
+     PUB_SZ    is the number of datagram payload bytes published
+     FILT_CNT  is the number of datagrams filtered by the tile (larger
+               than pkt_max)
+     FILT_SZ   is the number of datagram payload bytes filtered (the
+               full size of each datagram, not just the pkt_max bytes
+               that were received)
+     BATCH_CNT is the number of non-empty batches received
+     ERR_CNT   is the number of failed receives (other than no datagram
+               being available)
+
+   As such, the cnc app region must be at least 64B in size.
+
+   Except for IN_BACKP, none of the diagnostics are cleared at tile
+   startup (as such that they can be accumulated over multiple runs).
+   Clearing is up to monitoring scripts. */
+
+#define FD_SOCK_CNC_DIAG_PUB_CNT   (2UL) /* On 1st cache line of app region, updated by producer, frequently */
+#define FD_SOCK_CNC_DIAG_PUB_SZ    (3UL) /* ", frequently */
+#define FD_SOCK_CNC_DIAG_FILT_CNT  (4UL) /* ", rarely */
+#define FD_SOCK_CNC_DIAG_FILT_SZ   (5UL) /* ", rarely */
+#define FD_SOCK_CNC_DIAG_BATCH_CNT (6UL) /* ", frequently */
+#define FD_SOCK_CNC_DIAG_ERR_CNT   (7UL) /* ", rarely */
+
+/* FD_SOCK_TILE_BATCH_MAX is the maximum number of datagrams a sock tile
+   can receive in a single recvmmsg call. */
+
+#define FD_SOCK_TILE_BATCH_MAX (64UL)
+
+/* FD_SOCK_TILE_OUT_MAX are the maximum number of outputs a sock tile
+   can have.  These limits are more or less arbitrary from a functional
+   correctness POV.  They mostly exist to set some practical upper
+   bounds for things like scratch footprint. */
+
+#define FD_SOCK_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
+
+/* FD_SOCK_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for a sock tile scratch region that can support
+   out_cnt outputs.  ALIGN is an integer power of 2 of at least double
+   cache line to mitigate various kinds of false sharing.  FOOTPRINT
+   will be an integer multiple of ALIGN.  out_cnt is assumed to be valid
+   (i.e. at most FD_SOCK_TILE_OUT_MAX).  These are provided to
+   facilitate compile time declarations. */
+
+#define FD_SOCK_TILE_SCRATCH_ALIGN (128UL)
+#define FD_SOCK_TILE_SCRATCH_FOOTPRINT( out_cnt )    \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,  \
+    FD_FCTL_ALIGN, FD_FCTL_FOOTPRINT( (out_cnt) ) ), \
+    FD_SOCK_TILE_SCRATCH_ALIGN )
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_sock_open opens a non-blocking UDP socket bound to ip4_addr:port
+   (ip4_addr is in network order as in fd_ip4.h, e.g. 0 for any local
+   address, port is in host order, 0 for a kernel assigned port).  If
+   reuseport is non-zero, SO_REUSEPORT is set before binding such that
+   multiple sockets (typically one per sock tile) can be bound to the
+   same address to shard the incoming traffic.  If rcvbuf_sz is
+   positive, the socket's receive buffer size is set to (at least)
+   rcvbuf_sz (a large receive buffer absorbs bursts while the tile is
+   backpressured or doing housekeeping).  Returns the socket file
+   descriptor on success and -1 on failure (logs details).  The caller
+   is responsible for closing the socket. */
+
+int
+fd_sock_open( uint   ip4_addr,
+              ushort port,
+              int    reuseport,
+              int    rcvbuf_sz );
+
+/* fd_sock_tile receives datagrams from the UDP socket sock and publishes
+   them as a tango fragment stream from origin orig into the given
+   mcache and dcache.  The tile can send to out_cnt reliable consumers
+   and an arbitrary number of unreliable consumers.  Each datagram is
+   published as a complete message (SOM and EOM set) whose payload is
+   the datagram payload and whose sig is fd_hash( hash_seed, payload,
+   sz ) (e.g. for sharding or filtering downstream without touching the
+   payload).  Datagrams larger than pkt_max are filtered.
+
+   The tile polls the socket without blocking (sock should be
+   non-blocking, see fd_sock_open, but the tile does not depend on it)
+   and receives up to batch_max datagrams per recvmmsg call (fewer when
+   it has fewer flow control credits available).  batch_max should be
+   in [1,FD_SOCK_TILE_BATCH_MAX].  The datagrams of a batch are received
+   straight into consecutive dcache chunks, each reserving room for
+   pkt_max bytes.  The dcache should thus be sized for an mtu of pkt_max
+   with a burst of batch_max (e.g. fd_dcache_req_data_sz( pkt_max,
+   depth, batch_max, 1 )).  While the tile is backpressured, datagrams
+   accumulate in the socket's receive buffer (and are dropped by the
+   kernel if it overflows).
+
+   idle is the idle policy the tile should use when its socket has no
+   datagrams (NULL indicates to poll continuously).  When a streak of
+   idleness is long enough for the tile to park (see fd_idle.h), the
+   tile blocks in poll on sock until a datagram arrives or the park
+   times out.  Regardless of idle, the tile rings the doorbell of its
+   own mcache (see fd_idle_wake) in its housekeeping such that its
+   consumers can park.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the sock tile.  That is, the tile booted
+   successfully (transitioning the cnc from BOOT->RUN), ran (handling
+   any application specific cnc signals while running), and (after
+   receiving a HALT signal) halted successfully (transitioning the cnc
+   from HALT->BOOT before return).  Returns a non-zero error code if the
+   tile fails to boot up (logs details ... the cnc will not be
+   transitioned from its original state and thus is likely bootable
+   again if its original state was BOOT).  For maximally robust
+   operation in the current implementation, all reliable consumers
+   should be halted and/or caught up before this tile is halted.
+
+   cr_max, lazy, rng and scratch are as in fd_replay_tile (a zero
+   cr_max uses the mcache depth and scratch should be sized with
+   fd_sock_tile_scratch_footprint, which silently returns 0 if out_cnt
+   is not valid).
+
+   The lifetime of the cnc, sock, mcache, dcache, out_fseq[*], idle (if
+   any), rng and scratch used by this tile should be a superset of this tile's
+   lifetime.  While this tile is running, no other tile should use cnc
+   for its command and control, receive from sock, publish into mcache
+   or dcache, use the idle or the rng for anything (and the rng should be seeded
+   distinctly from all other rngs in the system), or use scratch for
+   anything.  The out_fseq array will not be used the after the tile has
+   successfully booted (transitioned the cnc from BOOT to RUN) or
+   returned (e.g. failed to boot), whichever comes first. */
+
+FD_FN_CONST ulong
+fd_sock_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_sock_tile_scratch_footprint( ulong out_cnt );
+
+int
+fd_sock_tile( fd_cnc_t *       cnc,       /* Local join to the sock tile's command-and-control */
+              int              sock,      /* UDP socket to receive from */
+              ulong            batch_max, /* Max datagrams received per recvmmsg, in [1,FD_SOCK_TILE_BATCH_MAX] */
+              ulong            pkt_max,   /* Largest datagram to publish, larger datagrams are filtered */
+              ulong            orig,      /* Origin for this fragment stream, in [0,FD_FRAG_META_ORIG_MAX) */
+              ulong            hash_seed, /* Seed of the payload hash published as the frag sig */
+              fd_frag_meta_t * mcache,    /* Local join to the sock tile's frag stream output mcache */
+              uchar *          dcache,    /* Local join to the sock tile's frag stream output dcache */
+              ulong            out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+              ulong **         out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+              ulong            cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
+              long             lazy,      /* Lazyiness, <=0 means use a reasonable default */
+              fd_idle_t *      idle,      /* Local join to the idle policy this tile should use, NULL means always poll */
+              fd_rng_t *       rng,       /* Local join to the rng this sock tile should use */
+              void *           scratch ); /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif
+
+#endif /* HEADER_fd_src_disco_sock_fd_sock_h */
@@ -0,0 +1,357 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "../../util/net/fd_ip4.h"
+
+FD_STATIC_ASSERT( FD_SOCK_CNC_SIGNAL_ACK==4UL, unit_test );
+
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_PUB_CNT  ==2UL, unit_test );
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_PUB_SZ   ==3UL, unit_test );
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_FILT_CNT ==4UL, unit_test );
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_FILT_SZ  ==5UL, unit_test );
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_BATCH_CNT==6UL, unit_test );
+FD_STATIC_ASSERT( FD_SOCK_CNC_DIAG_ERR_CNT  ==7UL, unit_test );
+
+FD_STATIC_ASSERT( FD_SOCK_TILE_BATCH_MAX==64UL,   unit_test );
+FD_STATIC_ASSERT( FD_SOCK_TILE_OUT_MAX  ==8192UL, unit_test );
+
+FD_STATIC_ASSERT( FD_SOCK_TILE_SCRATCH_ALIGN==128UL, unit_test );
+
+#define RX_MAX  (2UL)    /* Number of sock tiles sharding the port */
+#define TX_CNT  (32UL)   /* Number of sending sockets (distinct source ports) */
+#define MSG_MAX (1UL<<20)
+
+struct test_cfg {
+  fd_cnc_t *       cnc;
+  int              sock;
+  ulong            batch_max;
+  ulong            pkt_max;
+  ulong            orig;
+  ulong            hash_seed;
+  fd_frag_meta_t * mcache;
+  uchar *          dcache;
+  int              idle_en;
+  uint             seed;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+static uchar msg_seen[ MSG_MAX ];
+
+static int
+rx_tile_main( int     argc,
+              char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->seed, 0UL ) );
+
+  fd_idle_t _idle[1];
+  fd_idle_t * idle = cfg->idle_en ? fd_idle_join( fd_idle_new( _idle, -1L, -1L, -1L ) ) : NULL;
+
+  uchar scratch[ FD_SOCK_TILE_SCRATCH_FOOTPRINT( 0UL ) ] __attribute__((aligned( FD_SOCK_TILE_SCRATCH_ALIGN )));
+
+  FD_TEST( !fd_sock_tile( cfg->cnc, cfg->sock, cfg->batch_max, cfg->pkt_max, cfg->orig, cfg->hash_seed,
+                          cfg->mcache, cfg->dcache, 0UL, NULL, 0UL, 0L, idle, rng, scratch ) );
+
+  if( idle ) fd_idle_delete( fd_idle_leave( idle ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+/* msg_sz returns the payload size of message msg_id.  Every 16th
+   message is larger than pkt_max and should be filtered. */
+
+static ulong
+msg_sz( ulong msg_id,
+        ulong pkt_max ) {
+  ulong h = fd_ulong_hash( msg_id );
+  if( !(h & 15UL) ) return pkt_max + 1UL + ((h>>4) & 63UL);
+  return 8UL + ((h>>4) % (pkt_max-7UL)); /* In [8,pkt_max] */
+}
+
+static void
+msg_fill( uchar * p,
+          ulong   msg_id,
+          ulong   sz ) {
+  FD_STORE( ulong, p, msg_id );
+  for( ulong off=8UL; off<sz; off++ ) p[ off ] = (uchar)(msg_id*7UL + off);
+}
+
+/* rx_drain consumes all frags published so far by the rx tiles and
+   validates them.  Returns the number of frags consumed. */
+
+static ulong
+rx_drain( test_cfg_t const * cfg,
+          ulong              rx_cnt,
+          ulong *            rx_seq,
+          ulong *            rx_got ) {
+  ulong cnt = 0UL;
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    fd_frag_meta_t const * mcache = cfg[ rx_idx ].mcache;
+    ulong                  depth  = fd_mcache_depth( mcache );
+    void const *           base   = fd_wksp_containing( cfg[ rx_idx ].dcache );
+    for(;;) {
+      ulong                  seq   = rx_seq[ rx_idx ];
+      fd_frag_meta_t const * mline = mcache + fd_mcache_line_idx( seq, depth );
+      FD_COMPILER_MFENCE();
+      ulong seq_found = mline->seq;
+      FD_COMPILER_MFENCE();
+      long diff = fd_seq_diff( seq_found, seq );
+      if( diff<0L ) break; /* Caught up */
+      FD_TEST( !diff );    /* Overrun */
+      ulong sig   = mline->sig;
+      ulong chunk = (ulong)mline->chunk;
+      ulong sz    = (ulong)mline->sz;
+      ulong ctl   = (ulong)mline->ctl;
+      FD_COMPILER_MFENCE();
+
+      FD_TEST( fd_frag_meta_ctl_som ( ctl ) );
+      FD_TEST( fd_frag_meta_ctl_eom ( ctl ) );
+      FD_TEST( !fd_frag_meta_ctl_err( ctl ) );
+      FD_TEST( fd_frag_meta_ctl_orig( ctl )==cfg[ rx_idx ].orig );
+
+      uchar const * p = (uchar const *)fd_chunk_to_laddr_const( base, chunk );
+      FD_TEST( sz>=8UL );
+      FD_TEST( sig==fd_hash( cfg[ rx_idx ].hash_seed, p, sz ) );
+      ulong msg_id = FD_LOAD( ulong, p );
+      FD_TEST( msg_id<MSG_MAX );
+      FD_TEST( sz==msg_sz( msg_id, cfg[ rx_idx ].pkt_max ) );
+      for( ulong off=8UL; off<sz; off++ ) FD_TEST( p[ off ]==(uchar)(msg_id*7UL + off) );
+      FD_TEST( !msg_seen[ msg_id ] );
+      msg_seen[ msg_id ] = (uchar)1;
+
+      FD_COMPILER_MFENCE();
+      FD_TEST( mline->seq==seq ); /* Not overrun while validating */
+
+      rx_seq[ rx_idx ] = fd_seq_inc( seq, 1UL );
+      rx_got[ rx_idx ]++;
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+
+  FD_TEST( fd_sock_tile_scratch_align()==FD_SOCK_TILE_SCRATCH_ALIGN );
+  FD_TEST( !fd_sock_tile_scratch_footprint( FD_SOCK_TILE_OUT_MAX+1UL ) );
+  for( ulong iter_rem=1000000UL; iter_rem; iter_rem-- ) {
+    ulong out_cnt = fd_rng_ulong_roll( rng, FD_SOCK_TILE_OUT_MAX+1UL );
+    FD_TEST( fd_sock_tile_scratch_footprint( out_cnt )==FD_SOCK_TILE_SCRATCH_FOOTPRINT( out_cnt ) );
+  }
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                 );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                        );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx(cpu_idx) );
+  ulong        rx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-depth",  NULL, 4096UL                     );
+  ulong        batch_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch-max", NULL, FD_SOCK_TILE_BATCH_MAX     );
+  ulong        pkt_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-max",   NULL, 1232UL                     );
+  ulong        msg_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--msg-cnt",   NULL, 65536UL                    );
+  ulong        burst     = fd_env_strip_cmdline_ulong( &argc, &argv, "--burst",     NULL, 256UL                      );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz                                     ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( msg_cnt>MSG_MAX                              ) ) FD_LOG_ERR(( "--msg-cnt too large" ));
+  if( FD_UNLIKELY( !((1UL<=burst) & (burst<=rx_depth))          ) ) FD_LOG_ERR(( "--burst should be in [1,--rx-depth]" ));
+  if( FD_UNLIKELY( !((8UL<=pkt_max) & (pkt_max+64UL<=65507UL))  ) ) FD_LOG_ERR(( "--pkt-max out of range" ));
+
+  if( FD_UNLIKELY( fd_tile_cnt()<2UL ) ) FD_LOG_ERR(( "this unit test requires at least 2 tiles" ));
+  ulong rx_cnt = fd_ulong_min( fd_tile_cnt()-1UL, RX_MAX );
+
+  /* Test socket creation.  A port can only be shared by sockets that
+     all set SO_REUSEPORT. */
+
+  uint lo = FD_IP4_ADDR( 127, 0, 0, 1 );
+
+  int sock[ RX_MAX ];
+  sock[0] = fd_sock_open( lo, (ushort)0, 1, 1<<22 ); FD_TEST( sock[0]>=0 );
+  struct sockaddr_in addr[1];
+  socklen_t addr_sz = (socklen_t)sizeof(struct sockaddr_in);
+  FD_TEST( !getsockname( sock[0], (struct sockaddr *)fd_type_pun( addr ), &addr_sz ) );
+  ushort port = ntohs( addr->sin_port );
+  FD_LOG_NOTICE(( "Receiving on 127.0.0.1:%hu with %lu sock tiles", port, rx_cnt ));
+
+  FD_TEST( fd_sock_open( lo, port, 0, 0 )<0 ); /* Not shareable without SO_REUSEPORT */
+  for( ulong rx_idx=1UL; rx_idx<rx_cnt; rx_idx++ ) { sock[ rx_idx ] = fd_sock_open( lo, port, 1, 1<<22 ); FD_TEST( sock[ rx_idx ]>=0 ); }
+
+  int tx_sock[ TX_CNT ];
+  for( ulong tx_idx=0UL; tx_idx<TX_CNT; tx_idx++ ) {
+    tx_sock[ tx_idx ] = fd_sock_open( lo, (ushort)0, 0, 0 ); FD_TEST( tx_sock[ tx_idx ]>=0 ); /* Distinct source ports */
+  }
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  long  hb0  = fd_tickcount();
+  ulong seq0 = fd_rng_ulong( rng );
+
+  test_cfg_t cfg[ RX_MAX ];
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    cfg[ rx_idx ].cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ) ),
+                                                 64UL, 0UL, hb0 ) );
+    FD_TEST( cfg[ rx_idx ].cnc );
+    memset( fd_cnc_app_laddr( cfg[ rx_idx ].cnc ), 0, 64UL );
+
+    cfg[ rx_idx ].sock      = sock[ rx_idx ];
+    cfg[ rx_idx ].batch_max = batch_max;
+    cfg[ rx_idx ].pkt_max   = pkt_max;
+    cfg[ rx_idx ].orig      = rx_idx;
+    cfg[ rx_idx ].hash_seed = fd_rng_ulong( rng );
+
+    cfg[ rx_idx ].mcache = fd_mcache_join( fd_mcache_new( fd_wksp_alloc_laddr( wksp, fd_mcache_align(),
+                                                                               fd_mcache_footprint( rx_depth, 0UL ) ),
+                                                          rx_depth, 0UL, seq0 ) );
+    FD_TEST( cfg[ rx_idx ].mcache );
+
+    ulong data_sz = fd_dcache_req_data_sz( pkt_max, rx_depth, batch_max, 1 ); FD_TEST( data_sz );
+    cfg[ rx_idx ].dcache = fd_dcache_join( fd_dcache_new( fd_wksp_alloc_laddr( wksp, fd_dcache_align(),
+                                                                               fd_dcache_footprint( data_sz, 0UL ) ),
+                                                          data_sz, 0UL ) );
+    FD_TEST( cfg[ rx_idx ].dcache );
+
+    cfg[ rx_idx ].idle_en = (int)(rx_idx & 1UL); /* Odd sock tiles park when idle */
+    cfg[ rx_idx ].seed    = rng_seq++;
+  }
+
+  /* A dcache sized without room for the batch should be rejected */
+
+  do {
+    test_cfg_t bad[1] = { cfg[0] };
+    ulong data_sz = fd_dcache_req_data_sz( pkt_max, rx_depth, 1UL, 1 );
+    bad->dcache = fd_dcache_join( fd_dcache_new( fd_wksp_alloc_laddr( wksp, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ) ),
+                                                 data_sz, 0UL ) );
+    FD_TEST( bad->dcache );
+    uchar scratch[ FD_SOCK_TILE_SCRATCH_FOOTPRINT( 0UL ) ] __attribute__((aligned( FD_SOCK_TILE_SCRATCH_ALIGN )));
+    if( batch_max>2UL )
+      FD_TEST( fd_sock_tile( bad->cnc, bad->sock, batch_max, pkt_max, 0UL, 0UL, bad->mcache, bad->dcache, 0UL, NULL, 0UL, 0L, NULL, rng, scratch ) );
+    FD_TEST( fd_sock_tile( bad->cnc, bad->sock, 0UL, pkt_max, 0UL, 0UL, bad->mcache, cfg[0].dcache, 0UL, NULL, 0UL, 0L, NULL, rng, scratch ) );
+    FD_TEST( fd_sock_tile( bad->cnc, -1, batch_max, pkt_max, 0UL, 0UL, bad->mcache, cfg[0].dcache, 0UL, NULL, 0UL, 0L, NULL, rng, scratch ) );
+    FD_TEST( fd_cnc_signal_query( bad->cnc )==FD_CNC_SIGNAL_BOOT );
+    fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( bad->dcache ) ) );
+  } while(0);
+
+  FD_LOG_NOTICE(( "Booting" ));
+
+  fd_tile_exec_t * exec[ RX_MAX ];
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    exec[ rx_idx ] = fd_tile_exec_new( 1UL+rx_idx, rx_tile_main, 0, (char **)fd_type_pun( cfg+rx_idx ) );
+    FD_TEST( exec[ rx_idx ] );
+  }
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ )
+    FD_TEST( fd_cnc_wait( cfg[ rx_idx ].cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+
+  /* Send the messages over loopback in bursts (small enough that
+     neither the socket buffers nor the mcaches can overflow) and check
+     every message that should make it through makes it through exactly
+     once. */
+
+  FD_LOG_NOTICE(( "Running (--msg-cnt %lu, --burst %lu, --batch-max %lu, --pkt-max %lu)", msg_cnt, burst, batch_max, pkt_max ));
+
+  uchar buf[ 65536 ];
+  ulong rx_seq[ RX_MAX ]; ulong rx_got[ RX_MAX ];
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) { rx_seq[ rx_idx ] = seq0; rx_got[ rx_idx ] = 0UL; }
+
+  ulong pub_cnt  = 0UL; ulong pub_sz  = 0UL;
+  ulong filt_cnt = 0UL; ulong filt_sz = 0UL;
+  long  t0 = fd_log_wallclock();
+  for( ulong msg_id=0UL; msg_id<msg_cnt; ) {
+    ulong burst_pub = 0UL;
+    for( ulong burst_rem=burst; burst_rem && msg_id<msg_cnt; burst_rem--, msg_id++ ) {
+      ulong sz = msg_sz( msg_id, pkt_max );
+      msg_fill( buf, msg_id, sz );
+      int tx = tx_sock[ fd_ulong_hash( msg_id ^ 0x5a5aUL ) % TX_CNT ];
+      FD_TEST( sendto( tx, buf, sz, 0, (struct sockaddr const *)fd_type_pun_const( addr ), (socklen_t)sizeof(struct sockaddr_in) )==(long)sz );
+      if( sz>pkt_max ) { filt_cnt++; filt_sz += sz; continue; } /* Truncated receive, counted at full size */
+      pub_cnt++; pub_sz += sz; burst_pub++;
+    }
+
+    long timeout = fd_log_wallclock() + (long)5e9;
+    while( burst_pub ) {
+      ulong cnt = rx_drain( cfg, rx_cnt, rx_seq, rx_got );
+      FD_TEST( cnt<=burst_pub );
+      burst_pub -= cnt;
+      if( FD_UNLIKELY( fd_log_wallclock()>timeout ) ) FD_LOG_ERR(( "timed out waiting for datagrams (%lu missing)", burst_pub ));
+      FD_YIELD();
+    }
+  }
+  long dt = fd_log_wallclock() - t0;
+
+  FD_LOG_NOTICE(( "Received %lu datagrams in %.3f ms (filtered %lu)", pub_cnt, 1e-6*(double)dt, filt_cnt ));
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    FD_LOG_NOTICE(( "sock tile %lu: %lu datagrams", rx_idx, rx_got[ rx_idx ] ));
+    FD_TEST( rx_got[ rx_idx ] ); /* The flows are sharded over all the tiles */
+  }
+
+  FD_LOG_NOTICE(( "Halting" ));
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    FD_TEST( !fd_cnc_open( cfg[ rx_idx ].cnc ) );
+    fd_cnc_signal( cfg[ rx_idx ].cnc, FD_CNC_SIGNAL_HALT );
+    FD_TEST( fd_cnc_wait( cfg[ rx_idx ].cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+    fd_cnc_close( cfg[ rx_idx ].cnc );
+    int ret;
+    FD_TEST( !fd_tile_exec_delete( exec[ rx_idx ], &ret ) ); FD_TEST( !ret );
+  }
+
+  /* The diagnostics are drained before halting */
+
+  ulong diag[8]; memset( diag, 0, sizeof(diag) );
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    ulong const * cnc_diag = (ulong const *)fd_cnc_app_laddr( cfg[ rx_idx ].cnc );
+    for( ulong idx=0UL; idx<8UL; idx++ ) diag[ idx ] += cnc_diag[ idx ];
+  }
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_PUB_CNT  ]==pub_cnt  );
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_PUB_SZ   ]==pub_sz   );
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_FILT_CNT ]==filt_cnt );
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_FILT_SZ  ]==filt_sz  );
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_ERR_CNT  ]==0UL      );
+  FD_TEST( diag[ FD_SOCK_CNC_DIAG_BATCH_CNT ] && diag[ FD_SOCK_CNC_DIAG_BATCH_CNT ]<=pub_cnt+filt_cnt );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( cfg[ rx_idx ].dcache ) ) );
+    fd_wksp_free_laddr( fd_mcache_delete( fd_mcache_leave( cfg[ rx_idx ].mcache ) ) );
+    fd_wksp_free_laddr( fd_cnc_delete   ( fd_cnc_leave   ( cfg[ rx_idx ].cnc    ) ) );
+    close( sock[ rx_idx ] );
+  }
+  for( ulong tx_idx=0UL; tx_idx<TX_CNT; tx_idx++ ) close( tx_sock[ tx_idx ] );
+
+  fd_wksp_delete_anonymous( wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "fd_disco.h"
 
+static uchar copy_src[ 4096 ] __attribute__((aligned(128)));
+static uchar copy_dst[ 4096 ] __attribute__((aligned(128)));
+
 int
 main( int     argc,
       char ** argv ) {
@@ -7,7 +10,23 @@ main( int     argc,
 
   fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
 
-  /* This is currently just a stub in anticipation of future tests */
+  /* Test the non-temporal copy (only [0,sz) of the source is read and
+     only the 32-byte blocks covering [0,sz) of the destination are
+     written) */
+
+  for( ulong i=0UL; i<4096UL; i++ ) copy_src[ i ] = fd_rng_uchar( rng );
+  for( ulong iter_rem=100000UL; iter_rem; iter_rem-- ) {
+    ulong src_off = fd_rng_ulong_roll( rng, 128UL );
+    ulong sz      = fd_rng_ulong_roll( rng, 2048UL );
+    ulong dst_off = 32UL*fd_rng_ulong_roll( rng, 4UL );
+    memset( copy_dst, 0xa5, 4096UL );
+    fd_disco_copy_nt( copy_dst + dst_off, copy_src + src_off, sz );
+    fd_disco_copy_fence();
+    ulong sz_up = fd_ulong_align_up( sz, 32UL );
+    for( ulong i=0UL;           i<dst_off; i++ ) FD_TEST( copy_dst[ i ]==(uchar)0xa5 );
+    FD_TEST( !memcmp( copy_dst + dst_off, copy_src + src_off, sz ) );
+    for( ulong i=dst_off+sz_up; i<4096UL;  i++ ) FD_TEST( copy_dst[ i ]==(uchar)0xa5 );
+  }
 
   fd_rng_delete( fd_rng_leave( rng ) );
 
@@ -15,4 +34,3 @@ main( int     argc,
   fd_halt();
   return 0;
 }
-
@@ -309,6 +309,167 @@ fd_cnc_wait( fd_cnc_t const * cnc,
   return obs;
 }
 
+/* fd_cnc_private_metric_hdr returns the location of cnc's metric
+   registry header (2 ulongs: magic and metric_cnt) or NULL if the app
+   region is too small to hold one. */
+
+FD_FN_PURE static inline ulong *
+fd_cnc_private_metric_hdr( fd_cnc_t const * cnc ) {
+  ulong app_sz = fd_ulong_align_dn( cnc->app_sz, 8UL );
+  if( FD_UNLIKELY( app_sz<16UL ) ) return NULL;
+  return (ulong *)(((ulong)fd_cnc_app_laddr_const( cnc )) + app_sz - 16UL);
+}
+
+ulong
+fd_cnc_metric_cnt( fd_cnc_t const * cnc ) {
+  ulong const * hdr = fd_cnc_private_metric_hdr( cnc );
+  if( FD_UNLIKELY( !hdr ) ) return 0UL;
+  FD_COMPILER_MFENCE();
+  ulong magic      = FD_VOLATILE_CONST( hdr[0] );
+  FD_COMPILER_MFENCE();
+  ulong metric_cnt = FD_VOLATILE_CONST( hdr[1] );
+  FD_COMPILER_MFENCE();
+  if( FD_UNLIKELY( magic!=FD_CNC_METRIC_MAGIC ) ) return 0UL;
+  if( FD_UNLIKELY( FD_CNC_METRIC_FOOTPRINT( metric_cnt ) > fd_ulong_align_dn( cnc->app_sz, 8UL ) ) ) return 0UL; /* corrupt */
+  return metric_cnt;
+}
+
+ulong
+fd_cnc_metric_find( fd_cnc_t const * cnc,
+                    char const *     name ) {
+  if( FD_UNLIKELY( !name ) ) return ULONG_MAX;
+  ulong metric_cnt = fd_cnc_metric_cnt( cnc );
+  for( ulong metric_idx=0UL; metric_idx<metric_cnt; metric_idx++ )
+    if( !strncmp( fd_cnc_metric( cnc, metric_idx )->name, name, FD_CNC_METRIC_NAME_MAX ) ) return metric_idx;
+  return ULONG_MAX;
+}
+
+int
+fd_cnc_metric_register( fd_cnc_t *              cnc,
+                        fd_cnc_metric_t const * metric,
+                        ulong                   metric_cnt,
+                        ulong                   reserved_sz ) {
+
+  if( FD_UNLIKELY( !cnc ) ) {
+    FD_LOG_WARNING(( "NULL cnc" ));
+    return FD_CNC_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( (!metric) & (!!metric_cnt) ) ) {
+    FD_LOG_WARNING(( "NULL metric" ));
+    return FD_CNC_ERR_INVAL;
+  }
+
+  ulong app_sz  = fd_ulong_align_dn( cnc->app_sz, 8UL );
+  ulong old_cnt = fd_cnc_metric_cnt( cnc );
+
+  /* Validate the new metrics and count how many are actually new */
+
+  ulong new_cnt = old_cnt;
+  ulong val_end = reserved_sz; /* Bytes of the app region used by the metric values (and reserved) */
+  for( ulong idx=0UL; idx<old_cnt; idx++ ) {
+    fd_cnc_metric_t const * m = fd_cnc_metric( cnc, idx );
+    val_end = fd_ulong_max( val_end, 8UL*((ulong)m->idx + (ulong)m->cnt) );
+  }
+
+  for( ulong idx=0UL; idx<metric_cnt; idx++ ) {
+    fd_cnc_metric_t const * m = metric + idx;
+
+    ulong name_len = strnlen( m->name, FD_CNC_METRIC_NAME_MAX );
+    if( FD_UNLIKELY( (!name_len) | (name_len>=FD_CNC_METRIC_NAME_MAX) ) ) {
+      FD_LOG_WARNING(( "metric %lu: bad name", idx ));
+      return FD_CNC_ERR_INVAL;
+    }
+
+    int type = (int)m->type;
+    if( FD_UNLIKELY( !( (type==FD_CNC_METRIC_TYPE_COUNTER) | (type==FD_CNC_METRIC_TYPE_GAUGE) |
+                        (type==FD_CNC_METRIC_TYPE_HISTOGRAM) ) ) ) {
+      FD_LOG_WARNING(( "metric %lu (%s): bad type (%i)", idx, m->name, type ));
+      return FD_CNC_ERR_INVAL;
+    }
+
+    if( FD_UNLIKELY( (!m->cnt) | ((type!=FD_CNC_METRIC_TYPE_HISTOGRAM) & (m->cnt!=1U)) ) ) {
+      FD_LOG_WARNING(( "metric %lu (%s): bad cnt (%u)", idx, m->name, m->cnt ));
+      return FD_CNC_ERR_INVAL;
+    }
+
+    /* Reject names used earlier in this batch */
+
+    for( ulong idx2=0UL; idx2<idx; idx2++ )
+      if( FD_UNLIKELY( !strncmp( metric[idx2].name, m->name, FD_CNC_METRIC_NAME_MAX ) ) ) {
+        FD_LOG_WARNING(( "metric %lu (%s): duplicate name", idx, m->name ));
+        return FD_CNC_ERR_INVAL;
+      }
+
+    ulong old_idx = fd_cnc_metric_find( cnc, m->name );
+    if( old_idx!=ULONG_MAX ) {
+      fd_cnc_metric_t const * o = fd_cnc_metric( cnc, old_idx );
+      if( FD_UNLIKELY( (o->type!=m->type) | (o->idx!=m->idx) | (o->cnt!=m->cnt) ) ) {
+        FD_LOG_WARNING(( "metric %lu (%s): conflicts with the registered metric of the same name", idx, m->name ));
+        return FD_CNC_ERR_INVAL;
+      }
+      continue; /* Already registered */
+    }
+
+    new_cnt++;
+    val_end = fd_ulong_max( val_end, 8UL*((ulong)m->idx + (ulong)m->cnt) );
+  }
+
+  if( FD_UNLIKELY( (new_cnt > ((app_sz>>5)+1UL)) || (val_end>app_sz) ||
+                   ((val_end + FD_CNC_METRIC_FOOTPRINT( new_cnt )) > app_sz) ) )
+    return FD_CNC_ERR_UNSUP; /* Registry would not fit / would overlap metric values (silent) */
+
+  if( FD_UNLIKELY( new_cnt==old_cnt ) ) return FD_CNC_SUCCESS; /* Nothing to do (e.g. reboot) */
+
+  /* Append the new descriptions and then publish the new count.  A
+     concurrent reader either sees the old count (and thus only old
+     descriptions) or the new count (and thus fully written
+     descriptions). */
+
+  ulong * hdr = fd_cnc_private_metric_hdr( cnc );
+  ulong   cnt = old_cnt;
+  for( ulong idx=0UL; idx<metric_cnt; idx++ ) {
+    fd_cnc_metric_t const * m = metric + idx;
+    if( fd_cnc_metric_find( cnc, m->name )!=ULONG_MAX ) continue;
+    fd_cnc_metric_t * d = (fd_cnc_metric_t *)fd_cnc_metric( cnc, cnt );
+    memset( d, 0, sizeof(fd_cnc_metric_t) );
+    memcpy( d->name, m->name, strnlen( m->name, FD_CNC_METRIC_NAME_MAX ) ); /* d->name already '\0' terminated */
+    d->type = m->type;
+    d->idx  = m->idx;
+    d->cnt  = m->cnt;
+    cnt++;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( hdr[1] ) = new_cnt;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( hdr[0] ) = FD_CNC_METRIC_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return FD_CNC_SUCCESS;
+}
+
+int
+fd_cnc_metric_register_try( fd_cnc_t *              cnc,
+                            fd_cnc_metric_t const * metric,
+                            ulong                   metric_cnt,
+                            ulong                   reserved_sz ) {
+  int err = fd_cnc_metric_register( cnc, metric, metric_cnt, reserved_sz );
+  if( FD_UNLIKELY( err==FD_CNC_ERR_UNSUP ) ) FD_LOG_INFO(( "cnc app region too small for a metric registry" ));
+  return err;
+}
+
+char const *
+fd_cnc_metric_type_cstr( int type ) {
+  switch( type ) {
+  case FD_CNC_METRIC_TYPE_COUNTER:   return "counter";
+  case FD_CNC_METRIC_TYPE_GAUGE:     return "gauge";
+  case FD_CNC_METRIC_TYPE_HISTOGRAM: return "histogram";
+  default: break;
+  }
+  return "unknown";
+}
+
 char const *
 fd_cnc_strerror( int err ) {
   switch( err ) {
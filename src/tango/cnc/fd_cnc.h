@@ -140,6 +140,56 @@
 #define FD_CNC_DIAG_IN_BACKP  (0UL) /* updated by the producer, ideally never */
 #define FD_CNC_DIAG_BACKP_CNT (1UL) /* updated by the producer, ideally never */
 
+/* A cnc app region can additionally hold a registry that describes the
+   diagnostics an app thread publishes in it such that generic monitors
+   can enumerate and sample any app thread's diagnostics without having
+   to be taught about each app thread's diagnostic layout.  The app
+   thread registers its diagnostics once when it boots (e.g. with
+   fd_cnc_metric_register) and continues to update them with plain
+   stores as before (i.e. the registry has no impact on the app
+   thread's run loop).  Describing diagnostics is best effort: an app
+   thread whose cnc app region is too small to also hold a registry
+   runs as before, it just is not enumerable by generic monitors (see
+   fd_cnc_metric_register_try).
+
+   A metric is a named range of cnt ulongs starting at ulong idx of the
+   app region (treating it as an array of ulongs as above).  A
+   FD_CNC_METRIC_TYPE_COUNTER is a single monotonically increasing
+   count (e.g. BACKP_CNT), a FD_CNC_METRIC_TYPE_GAUGE is a single value
+   that can go up and down (e.g. IN_BACKP) and a
+   FD_CNC_METRIC_TYPE_HISTOGRAM is cnt monotonically increasing bucket
+   counts.  Names are cstrs of at most FD_CNC_METRIC_NAME_MAX-1 chars
+   and unique within a cnc.
+
+   The registry lives at the end of the app region and grows toward
+   its start.  The last 16 bytes (rounded down to a multiple of 8) of
+   the app region hold FD_CNC_METRIC_MAGIC and the number of registered
+   metrics.  These are preceded by the metric descriptions (the first
+   registered metric is immediately before the header, the next one
+   immediately before that and so on).  As such, a registry with
+   metric_cnt metrics requires FD_CNC_METRIC_FOOTPRINT( metric_cnt )
+   bytes at the end of the app region that are not used for anything
+   else. */
+
+#define FD_CNC_METRIC_TYPE_COUNTER   (1)
+#define FD_CNC_METRIC_TYPE_GAUGE     (2)
+#define FD_CNC_METRIC_TYPE_HISTOGRAM (3)
+
+#define FD_CNC_METRIC_NAME_MAX (24UL)
+
+#define FD_CNC_METRIC_MAGIC (0xf17eda2c37e7c000UL) /* firedancer cnc metric ver 0 */
+
+#define FD_CNC_METRIC_FOOTPRINT( metric_cnt ) (16UL + 32UL*(metric_cnt))
+
+struct fd_cnc_metric {
+  char   name[ FD_CNC_METRIC_NAME_MAX ]; /* '\0' terminated */
+  ushort type;                           /* FD_CNC_METRIC_TYPE_* */
+  ushort idx;                            /* Index of the metric's first ulong in the app region */
+  uint   cnt;                            /* Number of ulongs, 1 for counters and gauges, positive */
+};
+
+typedef struct fd_cnc_metric fd_cnc_metric_t;
+
 /* fd_cnc_t is an opaque handle of a command-and-control object.
    Details are exposed here to facilitate inlining of many cnc
    operations in performance critical app thread paths. */
@@ -397,6 +447,97 @@ fd_cnc_close( fd_cnc_t * cnc ) {
   FD_COMPILER_MFENCE();
 }
 
+/* fd_cnc_metric_register registers the metric_cnt metrics described
+   by metric (indexed [0,metric_cnt)) in cnc's metric registry.  Meant
+   to be called by the app thread when it boots.  Registering a metric
+   that is already registered with the identical description is a no-op
+   (such that an app thread can be rebooted).  Either all the metrics
+   are registered or none are.  The first reserved_sz bytes of the app
+   region are treated as in use even if no registered metric covers
+   them (e.g. command arguments an app thread exchanges through its app
+   region, see FD_DISCO_CNC_CMD_APP_SZ) such that the registry never
+   grows over them.  Returns FD_CNC_SUCCESS on success.
+   Returns FD_CNC_ERR_INVAL if a description is malformed or conflicts
+   with a registered metric of the same name (logs details) and
+   FD_CNC_ERR_UNSUP if the app region is too small to hold the registry
+   (and the metrics) without overlap (silent, such that app threads can
+   treat a small app region as simply not describing their metrics).
+   Not safe to call concurrently from multiple threads.
+
+   fd_cnc_metric_register_try is the best effort variant app threads
+   typically use at boot: same as fd_cnc_metric_register but a cnc that
+   cannot hold the registry is logged at info level (and a malformed
+   description is logged as above) instead of needing handling by the
+   caller.  Returns the fd_cnc_metric_register result for callers that
+   care. */
+
+int
+fd_cnc_metric_register( fd_cnc_t *              cnc,
+                        fd_cnc_metric_t const * metric,
+                        ulong                   metric_cnt,
+                        ulong                   reserved_sz );
+
+int
+fd_cnc_metric_register_try( fd_cnc_t *              cnc,
+                            fd_cnc_metric_t const * metric,
+                            ulong                   metric_cnt,
+                            ulong                   reserved_sz );
+
+/* fd_cnc_metric_cnt returns the number of metrics registered in cnc (0
+   if cnc has no registry).  fd_cnc_metric returns the description of
+   metric metric_idx, assumes metric_idx is in [0,fd_cnc_metric_cnt).
+   The lifetime of the returned pointer is the lifetime of the join.
+   fd_cnc_metric_find returns the index of the metric named name or
+   ULONG_MAX if no such metric is registered.  These are meant for
+   monitors. */
+
+FD_FN_PURE ulong
+fd_cnc_metric_cnt( fd_cnc_t const * cnc );
+
+FD_FN_PURE static inline fd_cnc_metric_t const *
+fd_cnc_metric( fd_cnc_t const * cnc,
+               ulong            metric_idx ) {
+  ulong end = ((ulong)fd_cnc_app_laddr_const( cnc )) + fd_ulong_align_dn( cnc->app_sz, 8UL ) - 16UL;
+  return (fd_cnc_metric_t const *)(end - 32UL*(metric_idx+1UL));
+}
+
+FD_FN_PURE ulong
+fd_cnc_metric_find( fd_cnc_t const * cnc,
+                    char const *     name );
+
+/* fd_cnc_metric_laddr_const returns the location in the caller's local
+   address space of the first ulong of metric (from fd_cnc_metric for
+   the same cnc).  fd_cnc_metric_query samples metric's current value.
+   For a histogram, this is the total of its bucket counts.  Like other
+   cnc app region diagnostics, this is not an atomic snapshot of
+   multiple ulongs. */
+
+FD_FN_PURE static inline ulong const *
+fd_cnc_metric_laddr_const( fd_cnc_t const *        cnc,
+                           fd_cnc_metric_t const * metric ) {
+  return ((ulong const *)fd_cnc_app_laddr_const( cnc )) + (ulong)metric->idx;
+}
+
+static inline ulong
+fd_cnc_metric_query( fd_cnc_t const *        cnc,
+                     fd_cnc_metric_t const * metric ) {
+  ulong const * val = fd_cnc_metric_laddr_const( cnc, metric );
+  ulong         cnt = (ulong)metric->cnt;
+  ulong         sum = 0UL;
+  FD_COMPILER_MFENCE();
+  for( ulong idx=0UL; idx<cnt; idx++ ) sum += FD_VOLATILE_CONST( val[ idx ] );
+  FD_COMPILER_MFENCE();
+  return sum;
+}
+
+/* fd_cnc_metric_type_cstr returns a human readable cstr for a
+   FD_CNC_METRIC_TYPE_* (e.g. "counter").  The lifetime of the returned
+   pointer is infinite.  The returned pointer is always to a non-NULL
+   cstr. */
+
+FD_FN_CONST char const *
+fd_cnc_metric_type_cstr( int type );
+
 /* fd_cnc_strerror converts a FD_CNC_SUCCESS / FD_CNC_ERR_* code into
    a human readable cstr.  The lifetime of the returned pointer is
    infinite.  The returned pointer is always to a non-NULL cstr. */
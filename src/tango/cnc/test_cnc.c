@@ -212,6 +212,87 @@ main( int     argc,
   FD_TEST( fd_cnc_leave( cnc )==shcnc );
   FD_TEST( fd_cnc_delete( shcnc )==shmem );
 
+  /* Test the metric registry.  With a APP_MAX app region, there is room
+     for 6 ulongs of metric values and 4 metric descriptions. */
+
+  FD_TEST( FD_CNC_METRIC_FOOTPRINT( 4UL )==144UL );
+  FD_TEST( !strcmp( fd_cnc_metric_type_cstr( FD_CNC_METRIC_TYPE_COUNTER   ), "counter"   ) );
+  FD_TEST( !strcmp( fd_cnc_metric_type_cstr( FD_CNC_METRIC_TYPE_GAUGE     ), "gauge"     ) );
+  FD_TEST( !strcmp( fd_cnc_metric_type_cstr( FD_CNC_METRIC_TYPE_HISTOGRAM ), "histogram" ) );
+  FD_TEST( !strcmp( fd_cnc_metric_type_cstr( 0                            ), "unknown"   ) );
+
+  cnc = fd_cnc_join( fd_cnc_new( shmem, APP_MAX, type, now ) ); FD_TEST( cnc );
+  app = (ulong *)fd_cnc_app_laddr( cnc );
+
+  FD_TEST( !fd_cnc_metric_cnt( cnc ) );
+  FD_TEST( fd_cnc_metric_find( cnc, "in_backp" )==ULONG_MAX );
+
+  static fd_cnc_metric_t const metric[4] = {
+    { "in_backp",  FD_CNC_METRIC_TYPE_GAUGE,     FD_CNC_DIAG_IN_BACKP,  1U },
+    { "backp_cnt", FD_CNC_METRIC_TYPE_COUNTER,   FD_CNC_DIAG_BACKP_CNT, 1U },
+    { "frag_cnt",  FD_CNC_METRIC_TYPE_COUNTER,   2,                     1U },
+    { "lat",       FD_CNC_METRIC_TYPE_HISTOGRAM, 3,                     3U }
+  };
+
+  fd_cnc_metric_t bad[1];
+  bad[0] = metric[0]; bad[0].name[0] = '\0';                  FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  bad[0] = metric[0]; memset( bad[0].name, 'x', sizeof(bad[0].name) );
+  /**/                                                        FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  bad[0] = metric[0]; bad[0].type = (ushort)0;                 FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  bad[0] = metric[0]; bad[0].cnt  = 0U;                        FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  bad[0] = metric[0]; bad[0].cnt  = 2U;                        FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  bad[0] = metric[3]; bad[0].idx  = (ushort)16;                FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_UNSUP );
+  FD_TEST( fd_cnc_metric_register( NULL, metric, 1UL, 0UL )==FD_CNC_ERR_INVAL );
+  FD_TEST( fd_cnc_metric_register( cnc,  NULL,   1UL, 0UL )==FD_CNC_ERR_INVAL );
+  FD_TEST( fd_cnc_metric_register( cnc,  NULL,   0UL, 0UL )==FD_CNC_SUCCESS   );
+  FD_TEST( fd_cnc_metric_register_try( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_UNSUP );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 1UL, ULONG_MAX )==FD_CNC_ERR_UNSUP );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 4UL, 56UL      )==FD_CNC_ERR_UNSUP ); /* Registry would overlap the reserved prefix */
+  FD_TEST( !fd_cnc_metric_cnt( cnc ) );
+
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 2UL, 0UL )==FD_CNC_SUCCESS );
+  FD_TEST( fd_cnc_metric_cnt( cnc )==2UL );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 4UL, 48UL )==FD_CNC_SUCCESS ); /* Reregistration is fine (reserved prefix fits) */
+  FD_TEST( fd_cnc_metric_cnt( cnc )==4UL );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 4UL, 0UL )==FD_CNC_SUCCESS );
+  FD_TEST( fd_cnc_metric_cnt( cnc )==4UL );
+
+  bad[0] = metric[2]; bad[0].idx = (ushort)1;                  FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_INVAL ); /* Conflict */
+  bad[0] = metric[2]; strcpy( bad[0].name, "other" );          FD_TEST( fd_cnc_metric_register( cnc, bad, 1UL, 0UL )==FD_CNC_ERR_UNSUP ); /* Full */
+  FD_TEST( fd_cnc_metric_cnt( cnc )==4UL );
+
+  for( ulong idx=0UL; idx<6UL; idx++ ) app[ idx ] = idx+1UL;
+  for( ulong idx=0UL; idx<4UL; idx++ ) {
+    fd_cnc_metric_t const * m = fd_cnc_metric( cnc, idx );
+    FD_TEST( !strcmp( m->name, metric[idx].name ) );
+    FD_TEST( (m->type==metric[idx].type) & (m->idx==metric[idx].idx) & (m->cnt==metric[idx].cnt) );
+    FD_TEST( fd_cnc_metric_find( cnc, metric[idx].name )==idx );
+    FD_TEST( fd_cnc_metric_laddr_const( cnc, m )==app + metric[idx].idx );
+  }
+  FD_TEST( fd_cnc_metric_find( cnc, "other" )==ULONG_MAX );
+  FD_TEST( fd_cnc_metric_find( cnc, NULL    )==ULONG_MAX );
+  FD_TEST( fd_cnc_metric_query( cnc, fd_cnc_metric( cnc, 0UL ) )==1UL       );
+  FD_TEST( fd_cnc_metric_query( cnc, fd_cnc_metric( cnc, 2UL ) )==3UL       );
+  FD_TEST( fd_cnc_metric_query( cnc, fd_cnc_metric( cnc, 3UL ) )==4UL+5UL+6UL );
+
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cnc ) )==shmem );
+
+  /* A small app region just has no registry */
+
+  cnc = fd_cnc_join( fd_cnc_new( shmem, 8UL, type, now ) ); FD_TEST( cnc );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 1UL, 0UL )==FD_CNC_ERR_UNSUP );
+  FD_TEST( !fd_cnc_metric_cnt( cnc ) );
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cnc ) )==shmem );
+
+  /* A registry for 2 metrics fits in a 128 byte app region but not
+     without growing over an 80 byte reserved prefix */
+
+  cnc = fd_cnc_join( fd_cnc_new( shmem, 128UL, type, now ) ); FD_TEST( cnc );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 2UL, 80UL )==FD_CNC_ERR_UNSUP );
+  FD_TEST( fd_cnc_metric_register( cnc, metric, 2UL, 48UL )==FD_CNC_SUCCESS   );
+  FD_TEST( fd_cnc_metric_cnt( cnc )==2UL );
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cnc ) )==shmem );
+
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
   return 0;
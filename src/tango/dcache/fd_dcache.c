@@ -257,3 +257,169 @@ fd_dcache_compact_is_safe( void const * base,
   return 1;
 }
 
+int
+fd_dcache_hold_is_safe( void const * base,
+                        void const * dcache,
+                        ulong        mtu,
+                        ulong        slot_cnt ) {
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)base, 2UL*FD_CHUNK_SZ ) ) ) {
+    FD_LOG_WARNING(( "base is not double chunk aligned" ));
+    return 0;
+  }
+
+  if( FD_UNLIKELY( !dcache ) ) {
+    FD_LOG_WARNING(( "NULL dcache" ));
+    return 0;
+  }
+
+  if( FD_UNLIKELY( ((ulong)dcache < (ulong)base) | !fd_ulong_is_aligned( (ulong)dcache, 2UL*FD_CHUNK_SZ ) ) ) {
+    FD_LOG_WARNING(( "bad dcache (before base or misaligned)" ));
+    return 0;
+  }
+
+  ulong chunk0 = fd_dcache_compact_chunk0( base, dcache );
+  ulong chunk1 = fd_dcache_compact_chunk1( base, dcache );
+  if( FD_UNLIKELY( (chunk1<chunk0) | (chunk1>(ulong)UINT_MAX) ) ) {
+    FD_LOG_WARNING(( "base to dcache address space span too large" ));
+    return 0;
+  }
+
+  if( FD_UNLIKELY( (!mtu) | (mtu>(ULONG_MAX>>1)) ) ) {
+    FD_LOG_WARNING(( "bad mtu" ));
+    return 0;
+  }
+
+  ulong chunk_mtu = FD_DCACHE_SLOT_FOOTPRINT( mtu ) >> FD_CHUNK_LG_SZ;
+  if( FD_UNLIKELY( (!slot_cnt) | (slot_cnt>((chunk1-chunk0)/chunk_mtu)) ) ) {
+    FD_LOG_WARNING(( "too small dcache for slot_cnt" ));
+    return 0;
+  }
+
+  return 1;
+}
+
+ulong
+fd_dcache_hold_align( void ) {
+  return FD_DCACHE_HOLD_ALIGN;
+}
+
+ulong
+fd_dcache_hold_footprint( ulong slot_cnt ) {
+  if( FD_UNLIKELY( !slot_cnt ) ) return 0UL; /* zero slot_cnt */
+  if( FD_UNLIKELY( slot_cnt>((ULONG_MAX-2UL*FD_DCACHE_HOLD_ALIGN)/sizeof(fd_dcache_hold_private_slot_t)) ) ) return 0UL; /* overflow */
+  return FD_DCACHE_HOLD_FOOTPRINT( slot_cnt );
+}
+
+void *
+fd_dcache_hold_new( void * shmem,
+                    ulong  slot_cnt,
+                    ulong  depth,
+                    ulong  burst,
+                    ulong  seq0 ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_dcache_hold_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_dcache_hold_footprint( slot_cnt );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad slot_cnt (%lu)", slot_cnt ));
+    return NULL;
+  }
+
+  ulong dist = depth + burst;
+  if( FD_UNLIKELY( (!depth) | (!burst) | (dist<depth) | (dist>(ulong)LONG_MAX) ) ) {
+    FD_LOG_WARNING(( "bad depth (%lu) or burst (%lu)", depth, burst ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( slot_cnt<dist ) ) {
+    FD_LOG_WARNING(( "slot_cnt (%lu) too small for depth (%lu) and burst (%lu)", slot_cnt, depth, burst ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, footprint );
+
+  fd_dcache_hold_t * hold = (fd_dcache_hold_t *)shmem;
+
+  hold->slot_cnt = slot_cnt;
+  hold->dist     = dist;
+
+  /* Mark all slots as last written dist frags before seq0 such that
+     they are all immediately free */
+
+  fd_dcache_hold_private_slot_t * slot = fd_dcache_hold_private_slot( hold );
+  for( ulong slot_idx=0UL; slot_idx<slot_cnt; slot_idx++ ) slot[ slot_idx ].seq = fd_seq_dec( seq0, dist );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( hold->magic ) = FD_DCACHE_HOLD_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_dcache_hold_t *
+fd_dcache_hold_join( void * shhold ) {
+
+  if( FD_UNLIKELY( !shhold ) ) {
+    FD_LOG_WARNING(( "NULL shhold" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shhold, fd_dcache_hold_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shhold" ));
+    return NULL;
+  }
+
+  fd_dcache_hold_t * hold = (fd_dcache_hold_t *)shhold;
+  if( FD_UNLIKELY( hold->magic!=FD_DCACHE_HOLD_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return hold;
+}
+
+void *
+fd_dcache_hold_leave( fd_dcache_hold_t const * hold ) {
+
+  if( FD_UNLIKELY( !hold ) ) {
+    FD_LOG_WARNING(( "NULL hold" ));
+    return NULL;
+  }
+
+  return (void *)hold; /* Kinda ugly const cast */
+}
+
+void *
+fd_dcache_hold_delete( void * shhold ) {
+
+  if( FD_UNLIKELY( !shhold ) ) {
+    FD_LOG_WARNING(( "NULL shhold" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shhold, fd_dcache_hold_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shhold" ));
+    return NULL;
+  }
+
+  fd_dcache_hold_t * hold = (fd_dcache_hold_t *)shhold;
+  if( FD_UNLIKELY( hold->magic!=FD_DCACHE_HOLD_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( hold->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shhold;
+}
@@ -54,6 +54,46 @@
 
 #define FD_DCACHE_REQ_DATA_SZ( mtu, depth, burst, compact ) (FD_DCACHE_SLOT_FOOTPRINT( mtu )*((depth)+(burst)+(ulong)!!(compact)))
 
+/* FD_DCACHE_HOLD_{ALIGN,FOOTPRINT} specify the alignment and footprint
+   needed for a dcache hold table with slot_cnt slots (see
+   fd_dcache_hold_next below).  ALIGN is double cache line.  FOOTPRINT
+   will be a ALIGN multiple.  slot_cnt is assumed to be valid.  These
+   are provided to facilitate compile time hold table declarations. */
+
+#define FD_DCACHE_HOLD_ALIGN (128UL)
+#define FD_DCACHE_HOLD_FOOTPRINT( slot_cnt )                                 \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,        \
+    FD_DCACHE_HOLD_ALIGN, 128UL                     ), /* hdr   */         \
+    16UL,                 (slot_cnt)*16UL           ), /* slots */         \
+    FD_DCACHE_HOLD_ALIGN )
+
+/* fd_dcache_hold_t is an opaque handle of a dcache hold table.  Details
+   are exposed here to facilitate usage in performance critical
+   contexts. */
+
+#define FD_DCACHE_HOLD_MAGIC (0xf17eda2c37d401d0UL) /* firedancer dhold ver 0 */
+
+struct fd_dcache_hold_private_slot {
+  ulong seq; /* Sequence number of the frag most recently written to this slot, only written by the producer */
+  ulong cnt; /* Number of outstanding pins on this slot, atomically modified by consumers */
+};
+
+typedef struct fd_dcache_hold_private_slot fd_dcache_hold_private_slot_t;
+
+struct __attribute__((aligned(FD_DCACHE_HOLD_ALIGN))) fd_dcache_hold_private {
+  ulong magic;    /* == FD_DCACHE_HOLD_MAGIC */
+  ulong slot_cnt; /* Number of slots in the hold table, positive */
+  ulong dist;     /* A slot can be reused for frag seq if the slot's seq is at least dist older */
+
+  /* Padding to FD_DCACHE_HOLD_ALIGN here */
+
+  /* slot_cnt fd_dcache_hold_private_slot_t here */
+
+  /* Padding to FD_DCACHE_HOLD_ALIGN here */
+};
+
+typedef struct fd_dcache_hold_private fd_dcache_hold_t;
+
 FD_PROTOTYPES_BEGIN
 
 /* Construction API */
@@ -268,6 +308,221 @@ fd_dcache_compact_next( ulong chunk,    /* Assumed in [chunk0,wmark] */
   return fd_ulong_if( chunk>wmark, chunk0, chunk );                 /* If that goes over the high water mark, wrap to zero */
 }
 
+/* Hold API
+
+   In the compact ring above, a payload is implicitly freed when the
+   producer wraps around the dcache.  Consumers that want to keep a
+   payload for longer than that (e.g. pack holding pending transactions
+   indefinitely) would have to copy it out.  A hold table is an optional
+   companion to a dcache that lets consumers pin a payload in place
+   instead.
+
+   In this mode, the dcache data region is partitioned into slot_cnt
+   fixed size slots of chunk_mtu chunks each (chunk_mtu is
+   FD_DCACHE_SLOT_FOOTPRINT(mtu)>>FD_CHUNK_LG_SZ).  Slot slot_idx covers
+   chunks [chunk0+slot_idx*chunk_mtu,chunk0+(slot_idx+1)*chunk_mtu).
+   The producer writes each frag to a whole slot and consumers can pin
+   that slot such that the producer skips over it until it is unpinned.
+
+   Since slots are fixed size, pinning can never fragment the data
+   region (the only waste is slot internal, the same as a non-compact
+   dcache).  If a producer has an mcache of depth, can be preparing up
+   to burst frags and consumers collectively keep at most pin_max slots
+   pinned at any point in time, the dcache needs:
+
+     slot_cnt >= depth + burst + pin_max
+
+   slots.  The data_sz for this is given by:
+
+     fd_dcache_req_data_sz( mtu, depth, burst+pin_max, 0 )
+
+   That is, every pin costs exactly one slot of memory and a pinned
+   slot never costs the producer anything beyond a skipped slot when
+   allocating.  Pinning and unpinning are O(1) (an atomic operation and
+   a load).  fd_dcache_hold_next is O(1) typically (pinned slots are
+   skipped and slots cost at most depth+burst+pin_max probes to find in
+   the worst case). */
+
+/* fd_dcache_hold_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a dcache hold table
+   with slot_cnt slots.  align returns FD_DCACHE_HOLD_ALIGN.  If slot_cnt
+   is invalid (e.g. zero or the footprint would be larger than
+   ULONG_MAX), footprint silently returns 0. */
+
+FD_FN_CONST ulong
+fd_dcache_hold_align( void );
+
+FD_FN_CONST ulong
+fd_dcache_hold_footprint( ulong slot_cnt );
+
+/* fd_dcache_hold_new formats an unused memory region for use as a
+   dcache hold table.  shmem is a non-NULL pointer to this region in
+   the local address space with the required footprint and alignment.
+   slot_cnt is the number of slots (see above).  depth is the depth of
+   the mcache describing the frags in the dcache and burst is the
+   number of frags the producer can be preparing concurrently.  seq0 is
+   the sequence number of the first frag the producer will publish.
+   Returns shmem (and the memory region it points to will be formatted
+   as a hold table with all slots unpinned and free, caller is not
+   joined) on success and NULL on failure (logs details).  Reasons for
+   failure include obviously bad shmem, bad slot_cnt, zero depth, zero
+   burst or slot_cnt<depth+burst. */
+
+void *
+fd_dcache_hold_new( void * shmem,
+                    ulong  slot_cnt,
+                    ulong  depth,
+                    ulong  burst,
+                    ulong  seq0 );
+
+/* fd_dcache_hold_{join,leave,delete} are the usual join / leave /
+   delete semantics for a hold table (see fd_dcache_{join,leave,delete}
+   for details).  join returns a pointer in the local address space to
+   the hold table on success and NULL on failure (logs details). */
+
+fd_dcache_hold_t *
+fd_dcache_hold_join( void * shhold );
+
+void *
+fd_dcache_hold_leave( fd_dcache_hold_t const * hold );
+
+void *
+fd_dcache_hold_delete( void * shhold );
+
+/* fd_dcache_hold_slot_cnt returns the number of slots in the hold
+   table.  fd_dcache_hold_dist returns the depth+burst the table was
+   created with (a producer with an mcache deeper than dist-burst should
+   not use it).  fd_dcache_hold_cnt returns the number of pins currently
+   outstanding on slot slot_idx (assumed in [0,slot_cnt)).  The value is
+   a snapshot and can be stale by the time it is returned.  Both assume
+   hold is a current local join. */
+
+FD_FN_PURE static inline ulong
+fd_dcache_hold_slot_cnt( fd_dcache_hold_t const * hold ) {
+  return hold->slot_cnt;
+}
+
+FD_FN_PURE static inline ulong
+fd_dcache_hold_dist( fd_dcache_hold_t const * hold ) {
+  return hold->dist;
+}
+
+FD_FN_CONST static inline fd_dcache_hold_private_slot_t const *
+fd_dcache_hold_private_slot_const( fd_dcache_hold_t const * hold ) {
+  return (fd_dcache_hold_private_slot_t const *)(hold+1);
+}
+
+FD_FN_CONST static inline fd_dcache_hold_private_slot_t *
+fd_dcache_hold_private_slot( fd_dcache_hold_t * hold ) {
+  return (fd_dcache_hold_private_slot_t *)(hold+1);
+}
+
+static inline ulong
+fd_dcache_hold_cnt( fd_dcache_hold_t const * hold,
+                    ulong                    slot_idx ) {
+  return FD_VOLATILE_CONST( fd_dcache_hold_private_slot_const( hold )[ slot_idx ].cnt );
+}
+
+/* fd_dcache_hold_is_safe returns whether the dcache data region can
+   hold slot_cnt slots for frags of up to mtu bytes with chunks indexed
+   relative to base (the same base / dcache requirements as
+   fd_dcache_compact_is_safe apply).  Logs details if not. */
+
+int
+fd_dcache_hold_is_safe( void const * base,
+                        void const * dcache,
+                        ulong        mtu,
+                        ulong        slot_cnt );
+
+/* fd_dcache_hold_{chunk,slot_idx} convert between a slot index and the
+   chunk index of the first chunk in that slot.  chunk0 is from
+   fd_dcache_compact_chunk0 (the same base / dcache requirements apply)
+   and chunk_mtu is FD_DCACHE_SLOT_FOOTPRINT(mtu)>>FD_CHUNK_LG_SZ.
+   slot_idx is assumed in [0,slot_cnt) and chunk is assumed to be the
+   first chunk of a slot. */
+
+FD_FN_CONST static inline ulong
+fd_dcache_hold_chunk( ulong chunk0,
+                      ulong chunk_mtu,
+                      ulong slot_idx ) {
+  return chunk0 + slot_idx*chunk_mtu;
+}
+
+FD_FN_CONST static inline ulong
+fd_dcache_hold_slot_idx( ulong chunk0,
+                         ulong chunk_mtu,
+                         ulong chunk ) {
+  return (chunk - chunk0) / chunk_mtu;
+}
+
+/* fd_dcache_hold_next returns the slot the producer should write frag
+   seq into.  slot_idx is the slot returned by the previous call (or
+   slot_cnt-1 for the first call).  The slots are scanned cyclically
+   from slot_idx+1, skipping slots that are pinned or that still hold
+   one of the frags that might be exposed to consumers via the mcache.
+   The returned slot is claimed for seq (i.e. consumers can no longer
+   pin the frag previously stored there).  Returns ULONG_MAX if there
+   is no slot available (only possible if consumers have more than
+   pin_max slots pinned ... the producer should treat this like being
+   backpressured and try again later).  Sequence numbers passed to
+   consecutive calls should be increasing.
+
+   Claiming a slot needs a full memory fence to order the claim against
+   concurrent pins.  As such, this costs an atomic operation per frag
+   (plus one for each slot that was pinned between the unfenced check
+   and the claim, which is rare). */
+
+static inline ulong
+fd_dcache_hold_next( fd_dcache_hold_t * hold,
+                     ulong              slot_idx,
+                     ulong              seq ) {
+  fd_dcache_hold_private_slot_t * slot = fd_dcache_hold_private_slot( hold );
+  ulong slot_cnt = hold->slot_cnt;
+  ulong dist     = hold->dist;
+  for( ulong rem=slot_cnt; rem; rem-- ) {
+    slot_idx++;
+    slot_idx = fd_ulong_if( slot_idx<slot_cnt, slot_idx, 0UL );
+    fd_dcache_hold_private_slot_t * s = slot + slot_idx;
+    ulong seq_old = s->seq;
+    if( FD_UNLIKELY( fd_seq_diff( seq, seq_old )<(long)dist ) ) continue; /* Might still be exposed */
+    if( FD_UNLIKELY( FD_VOLATILE_CONST( s->cnt ) ) ) continue;             /* Pinned */
+    FD_VOLATILE( s->seq ) = seq;                                              /* Claim ... */
+    if( FD_LIKELY( !FD_ATOMIC_FETCH_AND_ADD( &s->cnt, 0UL ) ) ) return slot_idx; /* ... fence and check not pinned meanwhile */
+    FD_VOLATILE( s->seq ) = seq_old;                                          /* Pinned meanwhile, unclaim */
+  }
+  return ULONG_MAX;
+}
+
+/* fd_dcache_hold_pin pins the slot slot_idx holding the payload of frag
+   seq.  Returns 1 on success, in which case the producer will not
+   reuse the slot (and thus the payload is stable) until the matching
+   fd_dcache_hold_unpin.  Returns 0 if the frag has already been
+   overwritten (or is in the process of being overwritten) by the
+   producer, in which case the caller should treat the frag as
+   overrun.  The usual pattern is to read frag seq's metadata from the
+   mcache, pin, and then check the mcache for overrun as usual (if
+   overrun after a successful pin, unpin and treat as overrun).  Slots
+   can be pinned multiple times (by the same or different consumers);
+   a slot is free once all pins have been released.  Pin and unpin are
+   O(1). */
+
+static inline int
+fd_dcache_hold_pin( fd_dcache_hold_t * hold,
+                    ulong              slot_idx,
+                    ulong              seq ) {
+  fd_dcache_hold_private_slot_t * s = fd_dcache_hold_private_slot( hold ) + slot_idx;
+  FD_ATOMIC_FETCH_AND_ADD( &s->cnt, 1UL );                     /* Pin (full fence) ... */
+  if( FD_LIKELY( FD_VOLATILE_CONST( s->seq )==seq ) ) return 1; /* ... and check not claimed meanwhile */
+  FD_ATOMIC_FETCH_AND_SUB( &s->cnt, 1UL );
+  return 0;
+}
+
+static inline void
+fd_dcache_hold_unpin( fd_dcache_hold_t * hold,
+                      ulong              slot_idx ) {
+  FD_ATOMIC_FETCH_AND_SUB( &fd_dcache_hold_private_slot( hold )[ slot_idx ].cnt, 1UL );
+}
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_dcache_fd_dcache_h */
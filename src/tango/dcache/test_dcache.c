@@ -55,11 +55,23 @@ FD_STATIC_ASSERT( FD_DCACHE_REQ_DATA_SZ(  1UL,2UL,2UL,1)== 640UL, unit_test );
 FD_STATIC_ASSERT( FD_DCACHE_REQ_DATA_SZ(128UL,2UL,2UL,1)== 640UL, unit_test );
 FD_STATIC_ASSERT( FD_DCACHE_REQ_DATA_SZ(129UL,2UL,2UL,1)==1280UL, unit_test );
 
+FD_STATIC_ASSERT( FD_DCACHE_HOLD_ALIGN        ==128UL, unit_test );
+FD_STATIC_ASSERT( FD_DCACHE_HOLD_FOOTPRINT(1UL)==256UL, unit_test );
+FD_STATIC_ASSERT( FD_DCACHE_HOLD_FOOTPRINT(8UL)==256UL, unit_test );
+FD_STATIC_ASSERT( FD_DCACHE_HOLD_FOOTPRINT(9UL)==384UL, unit_test );
+
 #define DATA_MAX (28416UL)
 #define APP_MAX  (4096UL)
 
 static ulong __attribute__((aligned(FD_DCACHE_ALIGN))) shmem[ FD_DCACHE_FOOTPRINT( DATA_MAX, APP_MAX ) ];
 
+#define HOLD_DEPTH   (4UL)
+#define HOLD_BURST   (1UL)
+#define HOLD_PIN_MAX (3UL)
+#define HOLD_SLOT_CNT (HOLD_DEPTH+HOLD_BURST+HOLD_PIN_MAX)
+
+static uchar __attribute__((aligned(FD_DCACHE_HOLD_ALIGN))) hold_shmem[ FD_DCACHE_HOLD_FOOTPRINT( HOLD_SLOT_CNT ) ];
+
 int
 main( int     argc,
       char ** argv ) {
@@ -182,6 +194,116 @@ main( int     argc,
     }
   }
 
+  /* Test hold table */
+
+  FD_TEST( fd_dcache_hold_align()==FD_DCACHE_HOLD_ALIGN );
+  FD_TEST( !fd_dcache_hold_footprint( 0UL ) );
+  FD_TEST( !fd_dcache_hold_footprint( ULONG_MAX ) );
+  for( ulong slot_cnt=1UL; slot_cnt<1024UL; slot_cnt++ )
+    FD_TEST( fd_dcache_hold_footprint( slot_cnt )==FD_DCACHE_HOLD_FOOTPRINT( slot_cnt ) );
+
+  FD_TEST( fd_dcache_req_data_sz( mtu, HOLD_DEPTH, HOLD_BURST+HOLD_PIN_MAX, 0 )==HOLD_SLOT_CNT*FD_DCACHE_SLOT_FOOTPRINT( mtu ) );
+
+  ulong hold_slot_max = data_sz / FD_DCACHE_SLOT_FOOTPRINT( mtu );
+  FD_TEST( !fd_dcache_hold_is_safe( dcache, dcache, mtu, 0UL             ) ); /* zero slot_cnt */
+  FD_TEST( !fd_dcache_hold_is_safe( dcache, dcache, 0UL, 1UL             ) ); /* zero mtu */
+  FD_TEST( !fd_dcache_hold_is_safe( dcache, dcache, mtu, hold_slot_max+1UL ) ); /* too small */
+  if( hold_slot_max ) FD_TEST( fd_dcache_hold_is_safe( dcache, dcache, mtu, hold_slot_max ) );
+
+  ulong seq0 = fd_rng_ulong( rng );
+
+  FD_TEST( !fd_dcache_hold_new( NULL,         HOLD_SLOT_CNT,     HOLD_DEPTH, HOLD_BURST, seq0 ) ); /* NULL shmem */
+  FD_TEST( !fd_dcache_hold_new( hold_shmem+1, HOLD_SLOT_CNT,     HOLD_DEPTH, HOLD_BURST, seq0 ) ); /* misaligned */
+  FD_TEST( !fd_dcache_hold_new( hold_shmem,   0UL,               HOLD_DEPTH, HOLD_BURST, seq0 ) ); /* zero slot_cnt */
+  FD_TEST( !fd_dcache_hold_new( hold_shmem,   HOLD_SLOT_CNT,     0UL,        HOLD_BURST, seq0 ) ); /* zero depth */
+  FD_TEST( !fd_dcache_hold_new( hold_shmem,   HOLD_SLOT_CNT,     HOLD_DEPTH, 0UL,        seq0 ) ); /* zero burst */
+  FD_TEST( !fd_dcache_hold_new( hold_shmem,   HOLD_DEPTH,        HOLD_DEPTH, HOLD_BURST, seq0 ) ); /* too few slots */
+
+  void *             shhold = fd_dcache_hold_new( hold_shmem, HOLD_SLOT_CNT, HOLD_DEPTH, HOLD_BURST, seq0 ); FD_TEST( shhold );
+  fd_dcache_hold_t * hold   = fd_dcache_hold_join( shhold );                                                FD_TEST( hold   );
+
+  FD_TEST( fd_dcache_hold_slot_cnt( hold )==HOLD_SLOT_CNT );
+  FD_TEST( fd_dcache_hold_dist   ( hold )==HOLD_DEPTH+HOLD_BURST );
+  for( ulong slot_idx=0UL; slot_idx<HOLD_SLOT_CNT; slot_idx++ ) FD_TEST( !fd_dcache_hold_cnt( hold, slot_idx ) );
+
+  for( ulong slot_idx=0UL; slot_idx<HOLD_SLOT_CNT; slot_idx++ ) {
+    ulong chunk = fd_dcache_hold_chunk( 12UL, 4UL, slot_idx );
+    FD_TEST( chunk==12UL+4UL*slot_idx );
+    FD_TEST( fd_dcache_hold_slot_idx( 12UL, 4UL, chunk )==slot_idx );
+  }
+
+  /* Run a producer with randomly pinning / unpinning consumers against
+     a shadow model of the slots.  The producer should never reuse a
+     pinned slot or a slot holding one of the last depth frags and
+     should never fail to find a slot. */
+
+  ulong shadow_seq[ HOLD_SLOT_CNT ]; /* Frag seq most recently written to each slot */
+  ulong shadow_cnt[ HOLD_SLOT_CNT ]; /* Pins outstanding on each slot */
+  for( ulong slot_idx=0UL; slot_idx<HOLD_SLOT_CNT; slot_idx++ ) { shadow_seq[ slot_idx ] = ULONG_MAX; shadow_cnt[ slot_idx ] = 0UL; }
+  ulong pin_slot_cnt = 0UL; /* Number of slots with at least one pin */
+
+  ulong recent[ HOLD_DEPTH ]; /* Slot of frag seq is recent[ seq % HOLD_DEPTH ] */
+  ulong slot_idx = HOLD_SLOT_CNT-1UL;
+  ulong seq      = seq0;
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+
+    /* Produce frag seq */
+
+    slot_idx = fd_dcache_hold_next( hold, slot_idx, seq );
+    FD_TEST( slot_idx<HOLD_SLOT_CNT );
+    FD_TEST( !shadow_cnt[ slot_idx ] );
+    for( ulong age=1UL; age<=fd_ulong_min( iter, HOLD_DEPTH ); age++ ) {
+      ulong recent_slot_idx = recent[ (seq-age) % HOLD_DEPTH ];
+      FD_TEST( recent_slot_idx!=slot_idx );
+    }
+    shadow_seq[ slot_idx ]          = seq;
+    recent[ seq % HOLD_DEPTH ]      = slot_idx;
+
+    /* Pin one of the last depth frags (or an older one that might
+       have been overwritten) and/or release a random pin */
+
+    uint r = fd_rng_uint( rng );
+    if( r & 1U ) {
+      ulong age       = (ulong)((r>>1) & 7U); /* In [0,8) */
+      ulong pin_seq   = seq - age;
+      ulong pin_slot  = (age<fd_ulong_min( iter+1UL, HOLD_DEPTH )) ? recent[ pin_seq % HOLD_DEPTH ] : (ulong)((r>>4) % HOLD_SLOT_CNT);
+      int   expected  = (shadow_seq[ pin_slot ]==pin_seq);
+      if( shadow_cnt[ pin_slot ] || pin_slot_cnt<HOLD_PIN_MAX ) {
+        int ok = fd_dcache_hold_pin( hold, pin_slot, pin_seq );
+        FD_TEST( ok==expected );
+        if( ok ) {
+          pin_slot_cnt += (ulong)!shadow_cnt[ pin_slot ];
+          shadow_cnt[ pin_slot ]++;
+        }
+      }
+    }
+    if( (r>>8) & 1U ) {
+      ulong unpin_slot = (ulong)((r>>9) % HOLD_SLOT_CNT);
+      if( shadow_cnt[ unpin_slot ] ) {
+        fd_dcache_hold_unpin( hold, unpin_slot );
+        shadow_cnt[ unpin_slot ]--;
+        pin_slot_cnt -= (ulong)!shadow_cnt[ unpin_slot ];
+      }
+    }
+
+    for( ulong idx=0UL; idx<HOLD_SLOT_CNT; idx++ ) FD_TEST( fd_dcache_hold_cnt( hold, idx )==shadow_cnt[ idx ] );
+
+    seq++;
+  }
+
+  /* With every slot pinned, the producer should be backpressured */
+
+  for( ulong idx=0UL; idx<HOLD_SLOT_CNT; idx++ ) if( !shadow_cnt[ idx ] ) {
+    FD_TEST( fd_dcache_hold_pin( hold, idx, shadow_seq[ idx ] ) );
+    shadow_cnt[ idx ]++;
+  }
+  FD_TEST( fd_dcache_hold_next( hold, slot_idx, seq )==ULONG_MAX );
+  for( ulong idx=0UL; idx<HOLD_SLOT_CNT; idx++ ) while( shadow_cnt[ idx ] ) { fd_dcache_hold_unpin( hold, idx ); shadow_cnt[ idx ]--; }
+  FD_TEST( fd_dcache_hold_next( hold, slot_idx, seq )<HOLD_SLOT_CNT );
+
+  FD_TEST( fd_dcache_hold_leave ( hold   )==shhold     );
+  FD_TEST( fd_dcache_hold_delete( shhold )==hold_shmem );
+
   /* Test mcache destruction */
 
   FD_TEST( fd_dcache_leave ( dcache   )==shdcache );
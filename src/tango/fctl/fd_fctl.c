@@ -20,13 +20,16 @@ fd_fctl_new( void * shmem,
 
   fd_fctl_t * fctl = (fd_fctl_t *)shmem;
 
-  fctl->rx_max    = (ushort)rx_max;
-  fctl->rx_cnt    = (ushort)0;
-  fctl->in_refill = 0;
-  fctl->cr_burst  = 0UL;
-  fctl->cr_max    = 0UL;
-  fctl->cr_resume = 0UL;
-  fctl->cr_refill = 0UL;
+  fctl->rx_max     = (ushort)rx_max;
+  fctl->rx_cnt     = (ushort)0;
+  fctl->in_refill  = 0;
+  fctl->cr_burst   = 0UL;
+  fctl->cr_max     = 0UL;
+  fctl->cr_resume  = 0UL;
+  fctl->cr_refill  = 0UL;
+  fctl->adapt      = 0;
+  fctl->cr_lag     = 0UL;
+  fctl->diag_laddr = NULL;
 
   return shmem;
 }
@@ -137,3 +140,80 @@ fd_fctl_cfg_done( fd_fctl_t * fctl,
   return fctl;
 }
 
+
+/* fd_fctl_private_adapt_publish publishes the current thresholds of an
+   adaptive fctl for remote monitoring. */
+
+static inline void
+fd_fctl_private_adapt_publish( fd_fctl_t const * fctl ) {
+  ulong * diag = fctl->diag_laddr;
+  if( FD_UNLIKELY( !diag ) ) return;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( diag[0] ) = fctl->cr_resume;
+  FD_VOLATILE( diag[1] ) = fctl->cr_refill;
+  FD_COMPILER_MFENCE();
+}
+
+fd_fctl_t *
+fd_fctl_cfg_adapt( fd_fctl_t * fctl,
+                   ulong *     diag_laddr ) {
+  if( FD_UNLIKELY( !fctl ) ) {
+    FD_LOG_WARNING(( "NULL fctl" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fctl->cr_burst ) ) {
+    FD_LOG_WARNING(( "fctl not configured" ));
+    return NULL;
+  }
+
+  fctl->adapt      = 1;
+  fctl->cr_lag     = (fctl->cr_max - fctl->cr_resume)>>1; /* Start from the configured cr_resume */
+  fctl->diag_laddr = diag_laddr;
+  fd_fctl_private_adapt_publish( fctl );
+
+  return fctl;
+}
+
+void
+fd_fctl_private_adapt( fd_fctl_t * fctl,
+                       ulong       cr_query,
+                       int         refill_dir ) {
+  ulong cr_burst  = fctl->cr_burst;
+  ulong cr_max    = fctl->cr_max;
+  ulong cr_resume = fctl->cr_resume;
+  ulong cr_refill = fctl->cr_refill;
+
+  /* Bounds on the thresholds (see fd_fctl_cfg_adapt).  No ovfl possible
+     as cr_burst<=cr_max<=LONG_MAX. */
+
+  ulong cr_span       = cr_max - cr_burst;
+  ulong cr_resume_min = cr_burst + cr_span/3UL;
+  ulong cr_refill_min = cr_burst + (cr_span>>4);
+  ulong cr_gap        = cr_span>>3;
+
+  /* Update the moving average of the slowest receiver's lag (cr_query is
+     in [0,cr_max] so the sample is in [0,cr_max]) and move cr_resume to
+     leave twice that lag as headroom */
+
+  ulong cr_lag = fctl->cr_lag;
+  cr_lag = cr_lag - (cr_lag>>2) + ((cr_max - fd_ulong_min( cr_query, cr_max ))>>2);
+
+  cr_resume = cr_max - fd_ulong_min( 2UL*cr_lag, cr_max - cr_resume_min ); /* in [cr_resume_min,cr_max] */
+
+  /* Refill earlier after a slow event and later after a fast refill,
+     keeping the thresholds well separated */
+
+  if(      refill_dir>0 ) cr_refill += (cr_resume - fd_ulong_min( cr_refill, cr_resume ) + 1UL)>>1;
+  else if( refill_dir<0 ) cr_refill -= (cr_refill - fd_ulong_min( cr_refill, cr_refill_min ))>>3;
+
+  ulong cr_refill_max = fd_ulong_max( cr_resume - fd_ulong_min( cr_gap, cr_resume ), cr_refill_min );
+  cr_refill = fd_ulong_max( fd_ulong_min( cr_refill, cr_refill_max ), cr_refill_min );
+  cr_refill = fd_ulong_max( fd_ulong_min( cr_refill, cr_resume ), cr_burst ); /* Paranoia, in [cr_burst,cr_resume] */
+
+  fctl->cr_lag = cr_lag;
+  if( FD_LIKELY( (cr_resume==fctl->cr_resume) & (cr_refill==fctl->cr_refill) ) ) return;
+  fctl->cr_resume = cr_resume;
+  fctl->cr_refill = cr_refill;
+  fd_fctl_private_adapt_publish( fctl );
+}
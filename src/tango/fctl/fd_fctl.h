@@ -49,13 +49,16 @@ struct fd_fctl_private_rx {
 typedef struct fd_fctl_private_rx fd_fctl_private_rx_t;
 
 struct fd_fctl_private {
-  ushort rx_max;    /* Maximum number of receivers for this fctl, in [0,FD_FCTL_RX_MAX_MAX] */
-  ushort rx_cnt;    /* Current number of receivers for this fctl, in [0,rx_max] */
-  int    in_refill; /* 0 / 1 if the flow control currently in a refilling state */
-  ulong  cr_burst;  /* See fd_fctl_cfg_done for details, in [1,LONG_MAX] (not ULONG_MAX) */
-  ulong  cr_max;    /* ", in [cr_burst,LONG_MAX] */
-  ulong  cr_resume; /* ", in [cr_burst,cr_max  ] */
-  ulong  cr_refill; /* ", In [1,cr_resume      ] */
+  ushort  rx_max;     /* Maximum number of receivers for this fctl, in [0,FD_FCTL_RX_MAX_MAX] */
+  ushort  rx_cnt;     /* Current number of receivers for this fctl, in [0,rx_max] */
+  int     in_refill;  /* 0 / 1 if the flow control currently in a refilling state */
+  ulong   cr_burst;   /* See fd_fctl_cfg_done for details, in [1,LONG_MAX] (not ULONG_MAX) */
+  ulong   cr_max;     /* ", in [cr_burst,LONG_MAX] */
+  ulong   cr_resume;  /* ", in [cr_burst,cr_max  ] */
+  ulong   cr_refill;  /* ", In [1,cr_resume      ] */
+  int     adapt;      /* 0 / 1 if cr_resume and cr_refill are adapted online (see fd_fctl_cfg_adapt) */
+  ulong   cr_lag;     /* If adapt, moving average of how many credits the slowest receiver was holding back at refill queries */
+  ulong * diag_laddr; /* If adapt, where to publish the adapted cr_resume and cr_refill, NULL if not published */
   /* rx_max fd_fctl_private_rx_t array indexed [0,rx_max) follows.  Only
      elements [0,rx_cnt) are in use.  Only elements with non-NULL
      seq_laddr are currently allowed to backpressure this fctl. */
@@ -76,6 +79,19 @@ fd_fctl_private_rx_const( fd_fctl_t const * fctl ) {
   return (fd_fctl_private_rx_t const *)(fctl+1UL);
 }
 
+/* fd_fctl_private_adapt updates the cr_resume and cr_refill of an
+   adaptive fctl given the result of a refill query.  refill_dir is +1
+   if the query was the first of a refill and did not get enough credits
+   to resume (i.e. a slow event), -1 if the query was the first of a
+   refill and did get enough credits to resume and 0 otherwise.  This is
+   only called on the rare refill paths of fd_fctl_tx_cr_update and thus
+   is not inlined. */
+
+void
+fd_fctl_private_adapt( fd_fctl_t * fctl,
+                       ulong       cr_query,
+                       int         refill_dir );
+
 FD_PROTOTYPES_END
 
 /* Public APIs ********************************************************/
@@ -219,6 +235,47 @@ fd_fctl_cfg_done( fd_fctl_t * fctl,
                   ulong       cr_resume,
                   ulong       cr_refill );
 
+/* fd_fctl_cfg_adapt switches a configured fctl to adaptive mode.  In
+   adaptive mode, fd_fctl_tx_cr_update tunes cr_resume and cr_refill
+   online, starting from the values set by fd_fctl_cfg_done:
+
+   - Every refill query samples how many credits the slowest receiver
+     is holding back (i.e. cr_max less the credits the query found).
+     cr_resume tracks twice a moving average of this lag below cr_max
+     such that the transmitter resumes as soon as the receivers are
+     about as caught up as they typically get (instead of waiting in
+     the refilling state for a resume threshold the receivers rarely
+     reach).
+
+   - When the first query of a refill does not get enough credits to
+     resume (i.e. a slow event, the same events counted in the rx
+     slow_laddr), cr_refill moves halfway toward cr_resume such that
+     later refills start earlier and the transmitter is less likely to
+     run out of credits while the receivers catch up.
+
+   - When the first query of a refill does get enough credits to resume,
+     cr_refill decays toward its floor such that receivers that are
+     keeping up are queried less often.
+
+   cr_resume is kept in [cr_burst+(cr_max-cr_burst)/3,cr_max] and
+   cr_refill is kept in [cr_burst+(cr_max-cr_burst)/16,cr_resume] with
+   at least (cr_max-cr_burst)/8 credits between them (when possible) to
+   avoid start / stop flow control flooding.  The adapted values are
+   visible via fd_fctl_cr_{resume,refill}.
+
+   If diag_laddr is non-NULL, the adapted cr_resume and cr_refill will
+   be published to diag_laddr[0] and diag_laddr[1] respectively (on
+   this call and whenever they change) for remote monitoring.  Typical
+   usage is to point this at &fseq_diag[ FD_FSEQ_DIAG_CR_RESUME ] of one
+   of the receivers' fseqs.
+
+   Returns fctl on success and NULL on failure (logs details).  Reasons
+   for failure include NULL fctl and fctl not configured. */
+
+fd_fctl_t *
+fd_fctl_cfg_adapt( fd_fctl_t * fctl,
+                   ulong *     diag_laddr );
+
 /* Accessor APIs */
 
 /* fd_fctl_{rx_max,rx_cnt,
@@ -232,6 +289,10 @@ fd_fctl_cfg_done( fd_fctl_t * fctl,
    rx_idx is in [0,rx_cnt).  slow_laddr_const is a const-correct
    version of rx_slow_laddr.
    
+   fd_fctl_adapt returns 1 if the fctl is in adaptive mode (see
+   fd_fctl_cfg_adapt) and 0 otherwise.  In adaptive mode, cr_resume and
+   cr_refill return the current adapted values.
+
    (FIXME: CONSIDER ACCESSES FOR DISTIGUISHING WHETHER CR_MAX /
    CR_RESUME / CR_REFILL WERE AUTOCONFIGURED.  EXPOSE IN_REFILL?
    GET/SET RX_SEQ_LADDR DYNAMICALLY?  GET/SET IN_REFILL?) */
@@ -242,6 +303,7 @@ FD_FN_PURE static inline ulong fd_fctl_cr_burst ( fd_fctl_t const * fctl ) { ret
 FD_FN_PURE static inline ulong fd_fctl_cr_max   ( fd_fctl_t const * fctl ) { return fctl->cr_max;        }
 FD_FN_PURE static inline ulong fd_fctl_cr_resume( fd_fctl_t const * fctl ) { return fctl->cr_resume;     }
 FD_FN_PURE static inline ulong fd_fctl_cr_refill( fd_fctl_t const * fctl ) { return fctl->cr_refill;     }
+FD_FN_PURE static inline int   fd_fctl_adapt    ( fd_fctl_t const * fctl ) { return fctl->adapt;         }
 
 FD_FN_PURE static inline ulong
 fd_fctl_rx_cr_max( fd_fctl_t const * fctl,
@@ -526,6 +588,7 @@ fd_fctl_tx_cr_update( fd_fctl_t * fctl,
       /* We got enough credits to resume.  Update the credits available
          and exit the refilling state. */
 
+      if( FD_UNLIKELY( fctl->adapt ) ) fd_fctl_private_adapt( fctl, cr_query, in_refill ? 0 : -1 );
       fctl->in_refill = 0;
       cr_avail = cr_query;
 
@@ -551,6 +614,7 @@ fd_fctl_tx_cr_update( fd_fctl_t * fctl,
         slow[0] += 1UL;
         FD_COMPILER_MFENCE();
       }
+      if( FD_UNLIKELY( fctl->adapt ) ) fd_fctl_private_adapt( fctl, cr_query, 1 );
       fctl->in_refill = 1;
 
     } /* else {
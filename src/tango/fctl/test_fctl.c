@@ -9,6 +9,47 @@ static uchar __attribute__((aligned(FD_FCTL_ALIGN))) shmem[ FD_FCTL_FOOTPRINT( R
 static ulong rx_seq [ RX_MAX ]; /* Init to zero */
 static ulong rx_slow[ RX_MAX ];
 
+static uchar __attribute__((aligned(FD_FCTL_ALIGN))) adapt_shmem[ FD_FCTL_FOOTPRINT( 1UL ) ];
+static ulong adapt_diag[ 2 ];
+
+/* A sim_t is a simulated transmitter and a single receiver that trails
+   it by up to lag sequence numbers (the receiver only gets closer when
+   the transmitter is stalled). */
+
+struct sim {
+  ulong tx_seq;
+  ulong * rx_seq;   /* Points to the receiver's fseq */
+  ulong cr_avail;
+  ulong refill_cnt; /* Number of times the transmitter's credits were replenished */
+  ulong stall_cnt;  /* Number of iterations the transmitter was stalled */
+};
+
+typedef struct sim sim_t;
+
+static void
+sim_run( sim_t *     sim,
+         fd_fctl_t * fctl,
+         ulong       lag,
+         ulong       tx_cnt ) {
+  ulong tx_end = sim->tx_seq + tx_cnt;
+  while( sim->tx_seq<tx_end ) {
+    if( sim->tx_seq-(*sim->rx_seq)>lag ) (*sim->rx_seq) = sim->tx_seq - lag;
+    ulong cr_avail = fd_fctl_tx_cr_update( fctl, sim->cr_avail, sim->tx_seq );
+    sim->refill_cnt += (ulong)(cr_avail>sim->cr_avail);
+    sim->cr_avail    = cr_avail;
+    FD_TEST( fd_fctl_cr_burst ( fctl )<=fd_fctl_cr_refill( fctl ) );
+    FD_TEST( fd_fctl_cr_refill( fctl )<=fd_fctl_cr_resume( fctl ) );
+    FD_TEST( fd_fctl_cr_resume( fctl )<=fd_fctl_cr_max   ( fctl ) );
+    if( cr_avail<fd_fctl_cr_burst( fctl ) ) { /* Stalled, receiver makes progress */
+      sim->stall_cnt++;
+      (*sim->rx_seq) += (ulong)((*sim->rx_seq)<sim->tx_seq);
+      continue;
+    }
+    sim->tx_seq   += fd_fctl_cr_burst( fctl );
+    sim->cr_avail -= fd_fctl_cr_burst( fctl );
+  }
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -85,6 +126,68 @@ main( int     argc,
   /* FIXME: TX_CR_UPDATE TESTING HERE */
   fd_fctl_tx_cr_update( fctl, 0UL, 0UL );
 
+  /* Test adaptive mode */
+
+  FD_TEST( !fd_fctl_adapt( fctl ) );
+  FD_TEST( !fd_fctl_cfg_adapt( NULL, NULL ) ); /* NULL fctl */
+
+  fd_fctl_t * afctl = fd_fctl_join( fd_fctl_new( adapt_shmem, 1UL ) ); FD_TEST( afctl );
+  ulong       a_seq  = 0UL;
+  ulong       a_slow = 0UL;
+  FD_TEST( fd_fctl_cfg_rx_add( afctl, 1024UL, &a_seq, &a_slow ) );
+  FD_TEST( !fd_fctl_cfg_adapt( afctl, adapt_diag ) ); /* not configured */
+  FD_TEST( fd_fctl_cfg_done( afctl, 4UL, 0UL, 0UL, 0UL ) );
+
+  ulong refill0 = fd_fctl_cr_refill( afctl );
+  ulong resume0 = fd_fctl_cr_resume( afctl );
+
+  sim_t sim[1]; fd_memset( sim, 0, sizeof(sim_t) ); sim->rx_seq = &a_seq;
+
+  sim_run( sim, afctl, 0UL, 1000000UL ); /* Fast receiver, static thresholds */
+  ulong static_refill_cnt = sim->refill_cnt;
+
+  FD_TEST( fd_fctl_cfg_adapt( afctl, adapt_diag )==afctl );
+  FD_TEST( fd_fctl_adapt( afctl ) );
+  FD_TEST( fd_fctl_cr_refill( afctl )==refill0 ); FD_TEST( adapt_diag[1]==refill0 );
+  FD_TEST( fd_fctl_cr_resume( afctl )==resume0 ); FD_TEST( adapt_diag[0]==resume0 );
+
+  /* A fast receiver should be queried less often as cr_refill decays
+     toward its floor and cr_resume rises toward cr_max */
+
+  sim->refill_cnt = 0UL;
+  sim_run( sim, afctl, 0UL, 1000000UL );
+  ulong adapt_refill_cnt = sim->refill_cnt;
+  FD_LOG_NOTICE(( "fast rx: refill_cnt %lu static, %lu adaptive (cr_resume %lu cr_refill %lu)",
+                  static_refill_cnt, adapt_refill_cnt, fd_fctl_cr_resume( afctl ), fd_fctl_cr_refill( afctl ) ));
+  FD_TEST( adapt_refill_cnt<static_refill_cnt );
+  FD_TEST( fd_fctl_cr_refill( afctl )<refill0 );
+  FD_TEST( fd_fctl_cr_resume( afctl )>resume0 );
+  FD_TEST( adapt_diag[0]==fd_fctl_cr_resume( afctl ) );
+  FD_TEST( adapt_diag[1]==fd_fctl_cr_refill( afctl ) );
+
+  /* A slow receiver (holding back more credits than cr_max-cr_resume)
+     produces slow events and stalls the transmitter.  As the thresholds
+     adapt (earlier refills, lower resume), the transmitter should spend
+     less time stalled. */
+
+  ulong refill1 = fd_fctl_cr_refill( afctl );
+  a_slow = 0UL; sim->stall_cnt = 0UL;
+  sim_run( sim, afctl, 700UL, 100000UL );
+  ulong slow1 = a_slow; ulong stall1 = sim->stall_cnt;
+  a_slow = 0UL; sim->stall_cnt = 0UL;
+  sim_run( sim, afctl, 700UL, 100000UL );
+  ulong slow2 = a_slow; ulong stall2 = sim->stall_cnt;
+  FD_LOG_NOTICE(( "slow rx: slow_cnt %lu then %lu, stall_cnt %lu then %lu (cr_resume %lu cr_refill %lu)",
+                  slow1, slow2, stall1, stall2, fd_fctl_cr_resume( afctl ), fd_fctl_cr_refill( afctl ) ));
+  FD_TEST( slow1 );
+  FD_TEST( stall2<stall1 );
+  FD_TEST( fd_fctl_cr_refill( afctl )>refill1 );
+  FD_TEST( fd_fctl_cr_resume( afctl )<resume0 );
+  FD_TEST( adapt_diag[0]==fd_fctl_cr_resume( afctl ) );
+  FD_TEST( adapt_diag[1]==fd_fctl_cr_refill( afctl ) );
+
+  FD_TEST( fd_fctl_delete( fd_fctl_leave( afctl ) )==adapt_shmem );
+
   FD_TEST( fd_fctl_leave ( fctl )==shfctl );
   FD_TEST( fd_fctl_delete( fctl )==shmem  );
 
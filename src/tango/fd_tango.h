@@ -9,6 +9,7 @@
 #include "mcache/fd_mcache.h" /* Includes fd_tango_base.h */
 #include "dcache/fd_dcache.h" /* Includes fd_tango_base.h */
 #include "tcache/fd_tcache.h" /* Includes fd_tango_base.h */
+#include "idle/fd_idle.h"     /* Includes mcache/fd_mcache.h */
 
 #endif /* HEADER_fd_src_tango_fd_tango_h */
 
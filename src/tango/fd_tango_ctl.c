@@ -69,6 +69,16 @@ main( int     argc,
         "\t  to stdout (implicitly verifying gaddr is a dcache).\n\t"
         "\t  Otherwise, prints a detailed query to stdout.\n\t" 
         "\n\t"
+        "\tnew-dcache-hold wksp slot-cnt depth burst seq0\n\t"
+        "\t- Creates a hold table in wksp with slot-cnt slots for a\n\t"
+        "\t  non-compact dcache (see new-dcache) whose producer has an\n\t"
+        "\t  mcache of depth, can be preparing up to burst frags and\n\t"
+        "\t  publishes seq0 first.  Prints the wksp gaddr of the hold\n\t"
+        "\t  table to stdout.\n\t"
+        "\n\t"
+        "\tdelete-dcache-hold gaddr\n\t"
+        "\t- Destroys the dcache hold table at gaddr.\n\t"
+        "\n\t"
         "\tnew-fseq wksp seq0\n\t"
         "\t- Creates a flow control variable in wksp initialized to seq0.\n\t"
         "\t  Prints the wksp gaddr of the created fseq to stdout.\n\t"
@@ -96,7 +106,9 @@ main( int     argc,
         "\n\t"
         "\tquery-cnc gaddr verbose\n\t"
         "\t- Queries the cnc at gaddr.  If verbose is 0, prints signal to\n\t"
-        "\t  stdout.  Otherwise, prints a detailed query to stdout.\n\t"
+        "\t  stdout.  Otherwise, prints a detailed query to stdout\n\t"
+        "\t  (including the current values of any metrics registered by\n\t"
+        "\t  the app thread).\n\t"
         "\n\t"
         "\tsignal-cnc gaddr sig\n\t"
         "\t- Sends signal sig to cnc at gaddr and waits for the response.\n\t"
@@ -412,6 +424,76 @@ main( int     argc,
       FD_LOG_NOTICE(( "%i: %s %s %i: success", cnt, cmd, _shdcache, verbose ));
       SHIFT( 2 );
 
+    } else if( !strcmp( cmd, "new-dcache-hold" ) ) {
+
+      if( FD_UNLIKELY( argc<5 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * _wksp    =                   argv[0];
+      ulong        slot_cnt = fd_cstr_to_ulong( argv[1] );
+      ulong        depth    = fd_cstr_to_ulong( argv[2] );
+      ulong        burst    = fd_cstr_to_ulong( argv[3] );
+      ulong        seq0     = fd_cstr_to_ulong( argv[4] );
+
+      ulong align     = fd_dcache_hold_align();
+      ulong footprint = fd_dcache_hold_footprint( slot_cnt );
+      if( FD_UNLIKELY( !footprint ) ) {
+        FD_LOG_ERR(( "%i: %s: slot_cnt (%lu) must be positive and result in a footprint smaller than 2^64.\n\tDo %s help for help",
+                     cnt, cmd, slot_cnt, bin ));
+      }
+
+      fd_wksp_t * wksp = fd_wksp_attach( _wksp );
+      if( FD_UNLIKELY( !wksp ) ) {
+        FD_LOG_ERR(( "%i: %s: fd_wksp_attach( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _wksp, bin ));
+      }
+
+      ulong gaddr = fd_wksp_alloc( wksp, align, footprint );
+      if( FD_UNLIKELY( !gaddr ) ) {
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_wksp_alloc( \"%s\", %lu, %lu ) failed\n\tDo %s help for help",
+                     cnt, cmd, _wksp, align, footprint, bin ));
+      }
+
+      void * shmem = fd_wksp_laddr( wksp, gaddr );
+      if( FD_UNLIKELY( !shmem ) ) {
+        fd_wksp_free( wksp, gaddr );
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_wksp_laddr( \"%s\", %lu ) failed\n\tDo %s help for help", cnt, cmd, _wksp, gaddr, bin ));
+      }
+
+      void * shhold = fd_dcache_hold_new( shmem, slot_cnt, depth, burst, seq0 );
+      if( FD_UNLIKELY( !shhold ) ) {
+        fd_wksp_free( wksp, gaddr );
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_dcache_hold_new( %s:%lu, %lu, %lu, %lu, %lu ) failed\n\tDo %s help for help",
+                     cnt, cmd, _wksp, gaddr, slot_cnt, depth, burst, seq0, bin ));
+      }
+
+      char buf[ FD_WKSP_CSTR_MAX ];
+      printf( "%s\n", fd_wksp_cstr( wksp, gaddr, buf ) );
+
+      fd_wksp_detach( wksp );
+
+      FD_LOG_NOTICE(( "%i: %s %s %lu %lu %lu %lu: success", cnt, cmd, _wksp, slot_cnt, depth, burst, seq0 ));
+      SHIFT( 5 );
+
+    } else if( !strcmp( cmd, "delete-dcache-hold" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * _shhold = argv[0];
+
+      void * shhold = fd_wksp_map( _shhold );
+      if( FD_UNLIKELY( !shhold ) )
+        FD_LOG_ERR(( "%i: %s: fd_wksp_map( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shhold, bin ));
+      if( FD_UNLIKELY( !fd_dcache_hold_delete( shhold ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_dcache_hold_delete( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shhold, bin ));
+      fd_wksp_unmap( shhold );
+
+      fd_wksp_cstr_free( _shhold );
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, _shhold ));
+      SHIFT( 1 );
+
     } else if( !strcmp( cmd, "new-fseq" ) ) {
 
       if( FD_UNLIKELY( argc<2 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
@@ -632,9 +714,14 @@ main( int     argc,
         printf( "\tlock       %lu\n",      cnc->lock                                           );
         printf( "\tsignal     %s (%lu)\n", fd_cnc_signal_cstr( cnc->signal, buf ), cnc->signal );
 
+        /* Don't dump the metric registry (if any) as raw bytes */
+
+        ulong metric_cnt = fd_cnc_metric_cnt( cnc );
+        ulong app_max    = metric_cnt ? (fd_ulong_align_dn( cnc->app_sz, 8UL ) - FD_CNC_METRIC_FOOTPRINT( metric_cnt )) : cnc->app_sz;
+
         uchar const * a = (uchar const *)fd_cnc_app_laddr_const( cnc );
         ulong app_sz;
-        for( app_sz=cnc->app_sz; app_sz; app_sz-- ) if( a[app_sz-1UL] ) break;
+        for( app_sz=app_max; app_sz; app_sz-- ) if( a[app_sz-1UL] ) break;
         ulong off = 0UL;
         printf( "\tapp        %04lx: %02x %02x %02x %02x %02x %02x %02x %02x  %02x %02x %02x %02x %02x %02x %02x %02x\n", off,
                 (uint)a[ 0], (uint)a[ 1], (uint)a[ 2], (uint)a[ 3], (uint)a[ 4], (uint)a[ 5], (uint)a[ 6], (uint)a[ 7],
@@ -643,7 +730,20 @@ main( int     argc,
           printf( "\t           %04lx: %02x %02x %02x %02x %02x %02x %02x %02x  %02x %02x %02x %02x %02x %02x %02x %02x\n", off,
                   (uint)a[ 0], (uint)a[ 1], (uint)a[ 2], (uint)a[ 3], (uint)a[ 4], (uint)a[ 5], (uint)a[ 6], (uint)a[ 7],
                   (uint)a[ 8], (uint)a[ 9], (uint)a[10], (uint)a[11], (uint)a[12], (uint)a[13], (uint)a[14], (uint)a[15] );
-        if( off<cnc->app_sz ) printf( "\t           ... snip (all remaining are zero) ...\n" );
+        if( off<app_max ) printf( "\t           ... snip (all remaining are zero) ...\n" );
+
+        for( ulong metric_idx=0UL; metric_idx<metric_cnt; metric_idx++ ) {
+          fd_cnc_metric_t const * metric = fd_cnc_metric( cnc, metric_idx );
+          printf( "\t%-10s %-23s %-9s %4lu: %lu", metric_idx ? "" : "metric", metric->name,
+                  fd_cnc_metric_type_cstr( (int)metric->type ), 8UL*(ulong)metric->idx, fd_cnc_metric_query( cnc, metric ) );
+          if( metric->type==FD_CNC_METRIC_TYPE_HISTOGRAM ) {
+            ulong const * val = fd_cnc_metric_laddr_const( cnc, metric );
+            printf( " (" );
+            for( ulong idx=0UL; idx<(ulong)metric->cnt; idx++ ) printf( idx ? " %lu" : "%lu", val[ idx ] );
+            printf( ")" );
+          }
+          printf( "\n" );
+        }
       }
 
       fd_wksp_unmap( fd_cnc_leave( cnc ) );
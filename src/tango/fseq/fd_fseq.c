@@ -3,7 +3,7 @@
 /* fd_fseq_shmem_t specifies the layout of a shared memory region
    containing an fseq */
 
-#define FD_FSEQ_MAGIC (0xf17eda2c37f5ec00UL) /* firedancer fseq ver 0 */
+#define FD_FSEQ_MAGIC (0xf17eda2c37f5ec01UL) /* firedancer fseq ver 1 */
 
 struct __attribute__((aligned(FD_FSEQ_ALIGN))) fd_fseq_shmem {
   ulong magic; /* == FD_FSEQ_MAGIC */
@@ -115,3 +115,30 @@ fd_fseq_delete( void * shfseq ) {
   return (void *)fseq;
 }
 
+
+ulong
+fd_fseq_lat_quantile( ulong const * hist,
+                      double        q ) {
+
+  ulong cnt = 0UL;
+  for( ulong idx=0UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) cnt += hist[ idx ];
+  if( FD_UNLIKELY( !cnt ) ) return ULONG_MAX;
+
+  /* rank is the 1-indexed rank of the sample at quantile q (i.e.
+     ceil(q cnt) clamped to [1,cnt] to handle q outside [0,1] and
+     floating point rounding) */
+
+  if( FD_UNLIKELY( !(q>0.) ) ) q = 0.; /* Handles NaN too */
+  if( FD_UNLIKELY(   q>1.  ) ) q = 1.;
+  double r    = q*(double)cnt;
+  ulong  rank = (ulong)r;
+  rank += (ulong)((double)rank<r);
+  rank  = fd_ulong_min( fd_ulong_max( rank, 1UL ), cnt );
+
+  ulong idx = 0UL;
+  for( ; idx<FD_FSEQ_LAT_BUCKET_CNT-1UL; idx++ ) {
+    if( rank<=hist[ idx ] ) break;
+    rank -= hist[ idx ];
+  }
+  return fd_fseq_lat_bucket_lo( idx );
+}
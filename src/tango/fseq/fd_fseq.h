@@ -15,14 +15,14 @@
    to facilitate compile time declarations. */
 
 #define FD_FSEQ_ALIGN     (128UL)
-#define FD_FSEQ_FOOTPRINT (128UL)
+#define FD_FSEQ_FOOTPRINT (2176UL)
 
 /* FD_FSEQ_APP_{ALIGN,FOOTPRINT} specify the alignment and footprint of
    a fseq's application region.  ALIGN is a positive integer power of 2.
    FOOTPRINT is a multiple of ALIGN. */
 
 #define FD_FSEQ_APP_ALIGN     (32UL)
-#define FD_FSEQ_APP_FOOTPRINT (96UL)
+#define FD_FSEQ_APP_FOOTPRINT (2144UL)
 
 /* FD_FSEQ_DIAG_* specify standard locations in the fseq's application
    region that can be used across a wide variety communicating producers
@@ -37,6 +37,10 @@
      OVRNP_CNT is the number of input overruns detected while polling for metadata by the consumer
      OVRNR_CNT is the number of input overruns detected while reading metadata by the consumer
      SLOW_CNT  is the number of times the consumer was detected as rate limiting consumer by the producer
+     CR_RESUME is the flow control resume threshold currently used by the producer (see fd_fctl_cfg_adapt)
+     CR_REFILL is the flow control refill threshold currently used by the producer (")
+     LAT_PUB   is the start of a histogram of now-tspub of received fragments when processed/filtered by the consumer
+     LAT_ORIG  is the start of a histogram of now-tsorig of received fragments when processed/filtered by the consumer
 
    It is worth noting that, given properly configured flow control:
 
@@ -49,7 +53,21 @@
    counters that are already there under normal operating conditions and
    abnormal operating conditions can be detected.
 
-   Note that application that use these counters, counters 7:11 remain
+   CR_RESUME and CR_REFILL are only meaningful if the producer uses
+   adaptive flow control and publishes its thresholds here (they should
+   be adjacent for fd_fctl_cfg_adapt).
+
+   LAT_PUB and LAT_ORIG are FD_FSEQ_LAT_BUCKET_CNT counters each (see
+   fd_fseq_lat_bucket for the bucketing) that give the distribution of
+   the latency, in ticks, between when a fragment was published (i.e.
+   the queueing delay at this hop) / originated (i.e. the delay since
+   it entered the system) and when the consumer got to it.  These are
+   updated by the consumer directly (fd_fseq_lat_sample) as they are on
+   cache lines only the consumer writes.  Monitors should compute
+   quantiles from the difference between two snapshots (e.g.
+   fd_fseq_lat_quantile).
+
+   Note that application that use these counters, counters 9:11 remain
    available for application specific usage.  To avoid cache line ping
    pong, it recommend that any use of these be for rare events and/or
    for events counted by the producer. */
@@ -61,6 +79,19 @@
 #define FD_FSEQ_DIAG_OVRNP_CNT (4UL) /* On the 2nd fseq cache line, updated by the consumer, ideally never */
 #define FD_FSEQ_DIAG_OVRNR_CNT (5UL) /* " */
 #define FD_FSEQ_DIAG_SLOW_CNT  (6UL) /* ", updated by the producer, rarely */
+#define FD_FSEQ_DIAG_CR_RESUME (7UL) /* ", updated by the producer, rarely */
+#define FD_FSEQ_DIAG_CR_REFILL (8UL) /* " */
+#define FD_FSEQ_DIAG_LAT_PUB   (12UL)                                      /* On the 3rd:18th fseq cache lines, updated by the consumer frequently */
+#define FD_FSEQ_DIAG_LAT_ORIG  (FD_FSEQ_DIAG_LAT_PUB+FD_FSEQ_LAT_BUCKET_CNT) /* On the 19th:34th fseq cache lines, " */
+
+/* FD_FSEQ_LAT_BUCKET_CNT is the number of buckets in a fseq latency
+   histogram.  FD_FSEQ_LAT_SUB_CNT is the number of buckets each power
+   of two latency range is split into (i.e. bucket resolution is within
+   25%).  Together, these cover latencies up to 2^33 ticks (seconds on
+   typical hosts) with larger latencies accumulated in the last bucket. */
+
+#define FD_FSEQ_LAT_BUCKET_CNT (128UL)
+#define FD_FSEQ_LAT_SUB_CNT    (4UL)
 
 FD_PROTOTYPES_BEGIN
 
@@ -156,6 +187,57 @@ fd_fseq_update( ulong * fseq,
   FD_COMPILER_MFENCE();
 }
 
+/* fd_fseq_lat_bucket returns the index of the latency histogram bucket
+   for a latency of lat ticks.  This is a log-linear (HDR-style)
+   bucketing: latencies in [0,8) get a bucket each and then each power
+   of two range [2^e,2^(e+1)) is split into FD_FSEQ_LAT_SUB_CNT equal
+   width buckets.  Negative latencies (e.g. from small tickcount skews
+   between cores) are treated as 0 and latencies too large for the
+   histogram map to the last bucket.  Result will be in
+   [0,FD_FSEQ_LAT_BUCKET_CNT).  This is branchless.
+
+   fd_fseq_lat_bucket_lo returns the smallest latency that maps to
+   bucket idx.  Assumes idx in [0,FD_FSEQ_LAT_BUCKET_CNT). */
+
+FD_FN_CONST static inline ulong
+fd_fseq_lat_bucket( long lat ) {
+  ulong l = (ulong)fd_long_max( lat, 0L );
+  int   e = fd_ulong_find_msb( l | 4UL ) - 2;
+  return fd_ulong_min( (((ulong)e)<<2) + (l>>e), FD_FSEQ_LAT_BUCKET_CNT-1UL );
+}
+
+FD_FN_CONST static inline ulong
+fd_fseq_lat_bucket_lo( ulong idx ) {
+  return fd_ulong_if( idx<8UL, idx, (4UL + (idx & 3UL)) << ((idx>>2)-1UL) );
+}
+
+/* fd_fseq_lat_sample accumulates the latencies of a received fragment
+   with the given tsorig and tspub (as stored in the fragment metadata)
+   observed at tickcount now into the LAT_PUB and LAT_ORIG histograms in
+   the fseq diagnostic region diag (e.g. fd_fseq_app_laddr( fseq )).
+   Should only be used by the consumer that owns the fseq. */
+
+static inline void
+fd_fseq_lat_sample( ulong * diag,
+                    long    now,
+                    ulong   tsorig,
+                    ulong   tspub ) {
+  diag[ FD_FSEQ_DIAG_LAT_PUB  + fd_fseq_lat_bucket( now - fd_frag_meta_ts_decomp( tspub,  now ) ) ]++;
+  diag[ FD_FSEQ_DIAG_LAT_ORIG + fd_fseq_lat_bucket( now - fd_frag_meta_ts_decomp( tsorig, now ) ) ]++;
+}
+
+/* fd_fseq_lat_quantile returns the latency in ticks at quantile q (in
+   [0,1], e.g. 0.99 for p99) of the samples in the latency histogram
+   hist (FD_FSEQ_LAT_BUCKET_CNT counters, e.g. the difference of two
+   snapshots of a LAT_PUB histogram).  The result is the lower bound of
+   the bucket holding the quantile (such that it is accurate to within
+   the bucket resolution, rounded down).  Returns ULONG_MAX if hist has
+   no samples. */
+
+FD_FN_PURE ulong
+fd_fseq_lat_quantile( ulong const * hist,
+                      double        q );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_fseq_fd_fseq_h */
@@ -1,10 +1,10 @@
 #include "../fd_tango.h"
 
 FD_STATIC_ASSERT( FD_FSEQ_ALIGN    ==128UL, unit_test );
-FD_STATIC_ASSERT( FD_FSEQ_FOOTPRINT==128UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_FOOTPRINT==2176UL, unit_test );
 
 FD_STATIC_ASSERT( FD_FSEQ_APP_ALIGN    ==32UL, unit_test );
-FD_STATIC_ASSERT( FD_FSEQ_APP_FOOTPRINT==96UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_APP_FOOTPRINT==2144UL, unit_test );
 
 FD_STATIC_ASSERT( FD_FSEQ_DIAG_PUB_CNT  ==0UL, unit_test );
 FD_STATIC_ASSERT( FD_FSEQ_DIAG_PUB_SZ   ==1UL, unit_test );
@@ -13,6 +13,15 @@ FD_STATIC_ASSERT( FD_FSEQ_DIAG_FILT_SZ  ==3UL, unit_test );
 FD_STATIC_ASSERT( FD_FSEQ_DIAG_OVRNP_CNT==4UL, unit_test );
 FD_STATIC_ASSERT( FD_FSEQ_DIAG_OVRNR_CNT==5UL, unit_test );
 FD_STATIC_ASSERT( FD_FSEQ_DIAG_SLOW_CNT ==6UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_DIAG_CR_RESUME==7UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_DIAG_CR_REFILL==8UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_DIAG_LAT_PUB  ==12UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_DIAG_LAT_ORIG ==140UL, unit_test );
+
+FD_STATIC_ASSERT( FD_FSEQ_LAT_BUCKET_CNT==128UL, unit_test );
+FD_STATIC_ASSERT( FD_FSEQ_LAT_SUB_CNT   ==4UL,   unit_test );
+
+FD_STATIC_ASSERT( 16UL+8UL*(FD_FSEQ_DIAG_LAT_ORIG+FD_FSEQ_LAT_BUCKET_CNT)<=16UL+FD_FSEQ_APP_FOOTPRINT, unit_test );
 
 static uchar shmem[ FD_FSEQ_FOOTPRINT ] __attribute__((aligned(FD_FSEQ_ALIGN)));
 
@@ -49,6 +58,61 @@ main( int     argc,
     FD_TEST( fd_fseq_query( fseq )==seq  );
   }
 
+  /* Test latency histogram bucketing */
+
+  FD_TEST( fd_fseq_lat_bucket( LONG_MIN )==0UL );
+  FD_TEST( fd_fseq_lat_bucket( -1L      )==0UL );
+  FD_TEST( fd_fseq_lat_bucket( LONG_MAX )==FD_FSEQ_LAT_BUCKET_CNT-1UL );
+  FD_TEST( fd_fseq_lat_bucket_lo( 0UL )==0UL );
+  for( ulong idx=1UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) {
+    ulong lo = fd_fseq_lat_bucket_lo( idx );
+    FD_TEST( lo>fd_fseq_lat_bucket_lo( idx-1UL ) );
+    FD_TEST( fd_fseq_lat_bucket( (long)lo       )==idx     );
+    FD_TEST( fd_fseq_lat_bucket( (long)lo - 1L  )==idx-1UL );
+    FD_TEST( 4UL*(lo - fd_fseq_lat_bucket_lo( idx-1UL ))<=lo+3UL ); /* Bucket width within 25% (exact below 8) */
+  }
+  FD_TEST( fd_fseq_lat_bucket( (long)fd_fseq_lat_bucket_lo( FD_FSEQ_LAT_BUCKET_CNT-1UL )*2L )==FD_FSEQ_LAT_BUCKET_CNT-1UL );
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+    long  lat = (long)(fd_rng_ulong( rng ) >> (1U+fd_rng_uint_roll( rng, 63U )));
+    ulong idx = fd_fseq_lat_bucket( lat );
+    FD_TEST( idx<FD_FSEQ_LAT_BUCKET_CNT );
+    FD_TEST( fd_fseq_lat_bucket_lo( idx )<=(ulong)lat );
+    if( idx<FD_FSEQ_LAT_BUCKET_CNT-1UL ) FD_TEST( (ulong)lat<fd_fseq_lat_bucket_lo( idx+1UL ) );
+  }
+
+  /* Test latency sampling and quantiles */
+
+  ulong * diag     = (ulong *)app;
+  ulong * lat_pub  = diag + FD_FSEQ_DIAG_LAT_PUB;
+  ulong * lat_orig = diag + FD_FSEQ_DIAG_LAT_ORIG;
+
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 0.5 )==ULONG_MAX );
+
+  long now = fd_tickcount();
+  for( ulong iter=0UL; iter<1000UL; iter++ ) {
+    ulong tsorig = fd_frag_meta_ts_comp( now - 1000L - (long)iter );
+    ulong tspub  = fd_frag_meta_ts_comp( now - (long)(iter<990UL ? 10UL : 100000UL) );
+    fd_fseq_lat_sample( diag, now, tsorig, tspub );
+  }
+  fd_fseq_lat_sample( diag, now, fd_frag_meta_ts_comp( now+5L ), fd_frag_meta_ts_comp( now+5L ) ); /* Skewed, counts as 0 */
+
+  ulong pub_cnt = 0UL; ulong orig_cnt = 0UL;
+  for( ulong idx=0UL; idx<FD_FSEQ_LAT_BUCKET_CNT; idx++ ) { pub_cnt += lat_pub[ idx ]; orig_cnt += lat_orig[ idx ]; }
+  FD_TEST( pub_cnt==1001UL ); FD_TEST( orig_cnt==1001UL );
+  FD_TEST( lat_pub [ 0                             ]==1UL   );
+  FD_TEST( lat_pub [ fd_fseq_lat_bucket( 10L     ) ]==990UL );
+  FD_TEST( lat_pub [ fd_fseq_lat_bucket( 100000L ) ]==10UL  );
+
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 0.    )==0UL );
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 0.5   )==fd_fseq_lat_bucket_lo( fd_fseq_lat_bucket( 10L     ) ) );
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 0.99  )==fd_fseq_lat_bucket_lo( fd_fseq_lat_bucket( 10L     ) ) );
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 0.999 )==fd_fseq_lat_bucket_lo( fd_fseq_lat_bucket( 100000L ) ) );
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 1.    )==fd_fseq_lat_bucket_lo( fd_fseq_lat_bucket( 100000L ) ) );
+  FD_TEST( fd_fseq_lat_quantile( lat_pub, 2.    )==fd_fseq_lat_bucket_lo( fd_fseq_lat_bucket( 100000L ) ) );
+
+  ulong p50 = fd_fseq_lat_quantile( lat_orig, 0.5 );
+  FD_TEST( p50<=1500UL ); FD_TEST( 1500UL<4UL*p50/3UL+1UL );
+
   FD_TEST( fd_fseq_leave ( fseq   )==shfseq );
   FD_TEST( fd_fseq_delete( shfseq )==shmem  );
   
@@ -0,0 +1,3 @@
+$(call add-hdrs,fd_idle.h)
+$(call add-objs,fd_idle,fd_tango)
+$(call make-unit-test,test_idle,test_idle,fd_tango fd_util)
@@ -0,0 +1,204 @@
+#define _GNU_SOURCE /* For syscall */
+#include "../fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <cpuid.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/* FD_IDLE_PAUSE_CHUNK is the maximum number of ticks for a single
+   UMWAIT.  This bounds how long the caller goes without looking at
+   anything but its watch location (the OS might impose a tighter bound
+   via IA32_UMWAIT_CONTROL). */
+
+#define FD_IDLE_PAUSE_CHUNK (16384L)
+
+ulong
+fd_idle_align( void ) {
+  return FD_IDLE_ALIGN;
+}
+
+ulong
+fd_idle_footprint( void ) {
+  return FD_IDLE_FOOTPRINT;
+}
+
+void *
+fd_idle_new( void * mem,
+             long   spin,
+             long   pause,
+             long   park ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_idle_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  if( spin <0L ) spin  = FD_IDLE_SPIN_DEFAULT;
+  if( pause<0L ) pause = FD_IDLE_PAUSE_DEFAULT;
+  if( park <0L ) park  = FD_IDLE_PARK_DEFAULT;
+
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  double _spin       = tick_per_ns*(double)spin;
+  double _pause      = tick_per_ns*(double)(spin+pause);
+  if( FD_UNLIKELY( !((spin<=(1L<<40)) & (pause<=(1L<<40)) & (_pause<=(double)(1L<<62))) ) ) {
+    FD_LOG_WARNING(( "spin and pause imply an unreasonably long idle streak" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( park>(long)1e9 ) ) {
+    FD_LOG_WARNING(( "park should be at most 1 s to keep the tile responsive" ));
+    return NULL;
+  }
+
+  uint a; uint b; uint c; uint d;
+  int waitpkg = __get_cpuid_count( 7U, 0U, &a, &b, &c, &d ) && (c & (1U<<5)); /* CPUID.(EAX=7,ECX=0):ECX.WAITPKG[bit 5] */
+
+  fd_idle_t * idle = (fd_idle_t *)mem;
+
+  idle->spin     = (long)_spin;
+  idle->pause    = (long)_pause;
+  idle->park     = park;
+  idle->progress = 0UL;
+  idle->idle0    = fd_tickcount();
+  idle->waitpkg  = waitpkg;
+  idle->park_cnt = 0UL;
+  idle->wake_cnt = 0UL;
+
+  return mem;
+}
+
+fd_idle_t *
+fd_idle_join( void * _idle ) {
+  if( FD_UNLIKELY( !_idle ) ) {
+    FD_LOG_WARNING(( "NULL _idle" ));
+    return NULL;
+  }
+  return (fd_idle_t *)_idle;
+}
+
+void *
+fd_idle_leave( fd_idle_t * idle ) {
+  if( FD_UNLIKELY( !idle ) ) {
+    FD_LOG_WARNING(( "NULL idle" ));
+    return NULL;
+  }
+  return (void *)idle;
+}
+
+void *
+fd_idle_delete( void * _idle ) {
+  if( FD_UNLIKELY( !_idle ) ) {
+    FD_LOG_WARNING(( "NULL _idle" ));
+    return NULL;
+  }
+  return _idle;
+}
+
+/* fd_idle_private_umwait arms a monitor on the cache line holding watch
+   and, if *watch is still watch_val, waits in C0.1 (the lighter of the
+   two UMWAIT states, for the faster wakeup) until the line is written
+   or the tickcount reaches deadline.  Encoded by hand such that this
+   does not require building with -mwaitpkg (UMONITOR rax is
+   F3 0F AE F0 and UMWAIT ecx is F2 0F AE F1). */
+
+static inline void
+fd_idle_private_umwait( ulong const * watch,
+                        ulong         watch_val,
+                        long          deadline ) {
+  __asm__ __volatile__( ".byte 0xf3, 0x0f, 0xae, 0xf0" : : "a" (watch) : "memory" );
+  if( FD_LIKELY( FD_VOLATILE_CONST( *watch )==watch_val ) )
+    __asm__ __volatile__( ".byte 0xf2, 0x0f, 0xae, 0xf1"
+                          : : "c" (1U), "a" ((uint)(ulong)deadline), "d" ((uint)((ulong)deadline>>32))
+                          : "cc", "memory" );
+}
+
+void
+fd_idle_private_wait( fd_idle_t *   idle,
+                      long          now,
+                      ulong const * watch,
+                      ulong         watch_val,
+                      ulong *       sync ) {
+
+  /* Pause phase (or we are never allowed to park) */
+
+  if( FD_LIKELY( ((now-idle->idle0)<idle->pause) | (!sync) | (!idle->park) ) ) {
+    if( FD_LIKELY( idle->waitpkg & (!!watch) ) ) fd_idle_private_umwait( watch, watch_val, now + FD_IDLE_PAUSE_CHUNK );
+    else                                         FD_SPIN_PAUSE();
+    return;
+  }
+
+  /* Park phase.  We snapshot the doorbell before advertising we are
+     parked and then recheck the watch location after (the atomic
+     increment is a full memory fence on x86).  Thus, if the producer
+     publishes after our recheck, it either sees our waiter count and
+     rings the doorbell after our snapshot (such that the futex wait
+     below returns immediately if we haven't gone to sleep yet) or the
+     wakeup is missed and we wake up when the park times out. */
+
+  uint * doorbell = (uint *)(sync + FD_IDLE_SEQ_DOORBELL);
+
+  FD_COMPILER_MFENCE();
+  uint ring = FD_VOLATILE_CONST( *doorbell );
+  FD_ATOMIC_FETCH_AND_ADD( sync + FD_IDLE_SEQ_WAITER_CNT, 1UL );
+
+  if( FD_LIKELY( (!watch) || FD_VOLATILE_CONST( *watch )==watch_val ) ) {
+    struct timespec ts[1];
+    ts->tv_sec  = (time_t)(idle->park / (long)1e9);
+    ts->tv_nsec = (long)  (idle->park % (long)1e9);
+    long err = syscall( SYS_futex, doorbell, FUTEX_WAIT, ring, ts, NULL, 0 );
+    idle->park_cnt++;
+    idle->wake_cnt += (ulong)( (!err) | ((err==-1L) && (errno==EAGAIN)) );
+  }
+
+  FD_ATOMIC_FETCH_AND_SUB( sync + FD_IDLE_SEQ_WAITER_CNT, 1UL );
+  FD_COMPILER_MFENCE();
+}
+
+void
+fd_idle_private_wait_fd( fd_idle_t * idle,
+                         long        now,
+                         int         fd ) {
+
+  /* Pause phase (or we are never allowed to park) */
+
+  if( FD_LIKELY( ((now-idle->idle0)<idle->pause) | (!idle->park) ) ) {
+    FD_SPIN_PAUSE();
+    return;
+  }
+
+  /* Park phase.  poll has ms resolution so round the park up. */
+
+  struct pollfd pfd[1];
+  pfd->fd      = fd;
+  pfd->events  = POLLIN;
+  pfd->revents = 0;
+  int ready = poll( pfd, 1UL, (int)((idle->park + 999999L) / 1000000L) );
+  idle->park_cnt++;
+  idle->wake_cnt += (ulong)(ready>0);
+}
+
+void
+fd_idle_private_wake( ulong * sync,
+                      ulong   seq ) {
+  uint * doorbell = (uint *)(sync + FD_IDLE_SEQ_DOORBELL);
+  uint   ring     = (uint)seq;
+  if( FD_LIKELY( FD_VOLATILE_CONST( *doorbell )==ring ) ) return; /* Nothing new published since we last rang */
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *doorbell ) = ring;
+  FD_COMPILER_MFENCE();
+  syscall( SYS_futex, doorbell, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+}
+
+#endif /* FD_HAS_HOSTED && FD_HAS_X86 */
@@ -0,0 +1,226 @@
+#ifndef HEADER_fd_src_tango_idle_fd_idle_h
+#define HEADER_fd_src_tango_idle_fd_idle_h
+
+/* APIs for letting a consumer tile that is caught up with its inputs
+   give its core back gracefully when it stays idle.
+
+   A tile's run loop normally spins with FD_SPIN_PAUSE when it is caught
+   up.  This gives the lowest possible latency but burns a full core
+   (and, with hyperthreading, steals issue slots from the sibling) even
+   when the tile sees a frag once in a blue moon.  A fd_idle lets a tile
+   opt into a spin-then-park policy for its caught up path:
+
+   - For the first spin ns of an idle streak, the tile spins as usual
+     (such that bursty traffic sees no latency change at all).
+
+   - For the next pause ns, the tile waits with UMONITOR / UMWAIT on the
+     location it would see its next frag (such that the core enters a
+     light power state but wakes up within a few hundred ns of the
+     producer publishing).  If the CPU does not support WAITPKG, the
+     tile keeps spinning instead.
+
+   - After that, the tile parks on a futex in its upstream producer's
+     mcache (see below) for at most park ns at a time.  The producer
+     rings the futex in its housekeeping when it sees the tile parked.
+
+   The policy costs nothing on the path where the tile has a frag to
+   process: it is only called from the caught up path and it detects the
+   end of an idle streak by comparing a caller provided progress value
+   (e.g. the tile's in sequence number) against the value at the start
+   of the streak.
+
+   Since park is bounded, a parked tile still does its housekeeping
+   (heartbeats, cnc signals, flow control credit returns) at least once
+   every park ns.  Conversely, a tile that is parked only sees a new frag
+   once its producer does its next housekeeping (or the park times out),
+   so park latency is in the ballpark of the producer's lazy.  Tiles that
+   need their idle-to-busy latency in the sub-microsecond range should
+   not use park (e.g. use a park of 0). */
+
+#include "../mcache/fd_mcache.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* FD_IDLE_SEQ_{WAITER_CNT,DOORBELL} give the entries of an mcache's seq
+   array (see fd_mcache_seq_laddr) used to park consumers of that mcache.
+   WAITER_CNT is the number of consumers currently parked (or about to
+   park).  The low 32-bits of DOORBELL is the futex word consumers park
+   on.  The producer sets it to the low 32-bits of its sequence number
+   when it wakes them up.  These are on the second cache line of the seq
+   array such that parking does not interfere with seq[0]. */
+
+#define FD_IDLE_SEQ_WAITER_CNT (8UL) /* Updated by consumers, rarely */
+#define FD_IDLE_SEQ_DOORBELL   (9UL) /* Updated by the producer, rarely */
+
+#define FD_IDLE_ALIGN     (64UL)
+#define FD_IDLE_FOOTPRINT (64UL)
+
+/* FD_IDLE_{SPIN,PAUSE,PARK}_DEFAULT give the default durations in ns of
+   the spin and pause phases of an idle streak and the default maximum
+   duration of a single park. */
+
+#define FD_IDLE_SPIN_DEFAULT  (100000L)  /* 100 us */
+#define FD_IDLE_PAUSE_DEFAULT (1000000L) /*   1 ms */
+#define FD_IDLE_PARK_DEFAULT  (1000000L) /*   1 ms */
+
+/* Internals are exposed here to facilitate inlining and should not be
+   used directly. */
+
+struct __attribute__((aligned(FD_IDLE_ALIGN))) fd_idle_private {
+  long  spin;      /* Ticks since the start of an idle streak to spin for, non-negative */
+  long  pause;     /* Ticks since the start of an idle streak to pause for, >=spin */
+  long  park;      /* Maximum duration of a park in ns, 0 means never park */
+  ulong progress;  /* Caller progress value at the start of the current idle streak */
+  long  idle0;     /* Tickcount at the start of the current idle streak */
+  int   waitpkg;   /* Non-zero if UMONITOR / UMWAIT are supported */
+  ulong park_cnt;  /* Number of parks so far */
+  ulong wake_cnt;  /* Number of parks ended by the producer (vs by a timeout) */
+};
+
+typedef struct fd_idle_private fd_idle_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_idle_{align,footprint} return the required alignment and footprint
+   of a memory region suitable for holding a fd_idle (i.e.
+   FD_IDLE_{ALIGN,FOOTPRINT}).
+
+   fd_idle_new formats a memory region with the appropriate alignment
+   and footprint as a fd_idle.  spin and pause are the durations in ns of
+   the spin and pause phases of an idle streak (<0 indicates to use
+   FD_IDLE_{SPIN,PAUSE}_DEFAULT).  park is the maximum duration in ns of
+   a single park (<0 indicates to use FD_IDLE_PARK_DEFAULT and 0
+   indicates to never park, pausing instead).  Returns mem on success and
+   NULL on failure (logs details).
+
+   fd_idle_join joins the caller to a fd_idle.  Returns the local handle
+   on success and NULL on failure (logs details).  fd_idle_leave leaves a
+   current local join and returns the underlying memory region.
+   fd_idle_delete unformats the memory region and returns ownership of
+   it to the caller.  A fd_idle has no shared state with anything else
+   such that these are mostly for consistency with other APIs (e.g. it
+   can be declared on the stack like fd_rng).  It is not safe for
+   concurrent use by multiple threads. */
+
+FD_FN_CONST ulong fd_idle_align    ( void );
+FD_FN_CONST ulong fd_idle_footprint( void );
+
+void *
+fd_idle_new( void * mem,
+             long   spin,
+             long   pause,
+             long   park );
+
+fd_idle_t * fd_idle_join  ( void *      _idle );
+void *      fd_idle_leave ( fd_idle_t * idle  );
+void *      fd_idle_delete( void *      _idle );
+
+/* fd_idle_{park_cnt,wake_cnt} return the number of times the caller
+   parked and the number of parks that were ended by the producer
+   (rather than by a timeout) so far.  Useful for diagnostics. */
+
+FD_FN_PURE static inline ulong fd_idle_park_cnt( fd_idle_t const * idle ) { return idle->park_cnt; }
+FD_FN_PURE static inline ulong fd_idle_wake_cnt( fd_idle_t const * idle ) { return idle->wake_cnt; }
+
+/* fd_idle_wait is called by a tile in its run loop when it is caught up
+   (i.e. in place of the FD_SPIN_PAUSE the run loop would otherwise do).
+   progress is a value that changes whenever the tile makes progress
+   (e.g. the tile's next in sequence number), now is the tile's current
+   tickcount, the wait ends early if the value at watch is different
+   from watch_val (e.g. watch is the mcache line where the tile expects
+   its next frag and watch_val is the sequence number found there) and
+   sync is the upstream producer's mcache seq array (e.g. from
+   fd_mcache_seq_laddr, NULL if the tile should not park).  On return,
+   the caller should read the tickcount and resume its run loop as
+   usual.
+
+   The first call with a new progress value starts a new idle streak.
+   Typically returns quickly during the spin phase, within a few us
+   during the pause phase and within park ns during the park phase. */
+
+void
+fd_idle_private_wait( fd_idle_t *   idle,
+                      long          now,
+                      ulong const * watch,
+                      ulong         watch_val,
+                      ulong *       sync );
+
+static inline void
+fd_idle_wait( fd_idle_t *   idle,
+              ulong         progress,
+              long          now,
+              ulong const * watch,
+              ulong         watch_val,
+              ulong *       sync ) {
+  if( FD_UNLIKELY( progress!=idle->progress ) ) { /* Start of an idle streak */
+    idle->progress = progress;
+    idle->idle0    = now;
+  } else if( FD_UNLIKELY( (now-idle->idle0)>=idle->spin ) ) {
+    fd_idle_private_wait( idle, now, watch, watch_val, sync );
+    return;
+  }
+  FD_SPIN_PAUSE();
+}
+
+/* fd_idle_wait_fd is fd_idle_wait for a tile whose input is a file
+   descriptor rather than an mcache (e.g. a sock tile that found its
+   socket empty).  There is no location to watch, so the pause phase
+   spins, and the park phase blocks in poll on fd for at most park ns
+   at a time (woken up by the kernel as soon as fd is readable instead
+   of by a producer's doorbell).  wake_cnt counts the parks that ended
+   with fd readable. */
+
+void
+fd_idle_private_wait_fd( fd_idle_t * idle,
+                         long        now,
+                         int         fd );
+
+static inline void
+fd_idle_wait_fd( fd_idle_t * idle,
+                 ulong       progress,
+                 long        now,
+                 int         fd ) {
+  if( FD_UNLIKELY( progress!=idle->progress ) ) { /* Start of an idle streak */
+    idle->progress = progress;
+    idle->idle0    = now;
+  } else if( FD_UNLIKELY( (now-idle->idle0)>=idle->spin ) ) {
+    fd_idle_private_wait_fd( idle, now, fd );
+    return;
+  }
+  FD_SPIN_PAUSE();
+}
+
+/* fd_idle_wake wakes any consumers parked on the producer's mcache
+   with seq array sync (e.g. from fd_mcache_seq_laddr).  seq is the
+   producer's current position in sequence space.  This is meant to be
+   called by the producer in its housekeeping just after
+   fd_mcache_seq_update (and with the same seq).  When no consumer is
+   parked, this is a single load from a cache line that is otherwise
+   rarely written.  Parked consumers are only woken if the producer
+   has published something since it last woke them (such that an idle
+   producer does not keep waking up idle consumers).
+
+   The producer does not fence before checking for parked consumers
+   (that would cost the producer on every housekeeping regardless of
+   whether or not any consumer uses parking).  As such, a consumer that
+   parks just as the producer publishes can miss the wakeup but it will
+   still wake up when its park times out. */
+
+void
+fd_idle_private_wake( ulong * sync,
+                      ulong   seq );
+
+static inline void
+fd_idle_wake( ulong * sync,
+              ulong   seq ) {
+  FD_COMPILER_MFENCE();
+  ulong waiter_cnt = FD_VOLATILE_CONST( sync[ FD_IDLE_SEQ_WAITER_CNT ] );
+  FD_COMPILER_MFENCE();
+  if( FD_UNLIKELY( waiter_cnt ) ) fd_idle_private_wake( sync, seq );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_HOSTED && FD_HAS_X86 */
+
+#endif /* HEADER_fd_src_tango_idle_fd_idle_h */
@@ -0,0 +1,208 @@
+#include "../fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <unistd.h>
+
+FD_STATIC_ASSERT( FD_IDLE_ALIGN    ==64UL, unit_test );
+FD_STATIC_ASSERT( FD_IDLE_FOOTPRINT==64UL, unit_test );
+FD_STATIC_ASSERT( sizeof(fd_idle_t)==FD_IDLE_FOOTPRINT, unit_test );
+
+FD_STATIC_ASSERT( FD_IDLE_SEQ_WAITER_CNT< FD_MCACHE_SEQ_CNT, unit_test );
+FD_STATIC_ASSERT( FD_IDLE_SEQ_DOORBELL  < FD_MCACHE_SEQ_CNT, unit_test );
+FD_STATIC_ASSERT( FD_IDLE_SEQ_WAITER_CNT>=8UL,               unit_test ); /* Not on seq[0]'s cache line */
+FD_STATIC_ASSERT( FD_IDLE_SEQ_DOORBELL  >=8UL,               unit_test );
+
+#define DEPTH     (128UL)
+#define BURST_CNT (64UL)
+#define BURST_MAX (16UL)
+
+static uchar __attribute__((aligned(FD_MCACHE_ALIGN))) shmem[ FD_MCACHE_FOOTPRINT( DEPTH, 0UL ) ];
+
+static ulong rx_seq; /* Consumer progress (poor man's fseq) */
+
+/* tx_main publishes BURST_CNT bursts of frags separated by idle gaps
+   long enough for the consumer to park.  It waits for the consumer to
+   catch up before each burst (such that the consumer never gets
+   overrun) and rings the doorbell the way a producer would in its
+   housekeeping. */
+
+static int
+tx_main( int     argc,
+         char ** argv ) {
+  (void)argc;
+  fd_frag_meta_t * mcache = (fd_frag_meta_t *)argv;
+  ulong *          sync   = fd_mcache_seq_laddr( mcache );
+  ulong            seq    = fd_mcache_seq0( mcache );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+
+  for( ulong burst_idx=0UL; burst_idx<BURST_CNT; burst_idx++ ) {
+
+    /* Wait for the consumer to catch up and then idle for up to ~4 ms */
+
+    while( FD_VOLATILE_CONST( rx_seq )!=seq ) FD_SPIN_PAUSE();
+    long gap = (long)(fd_rng_uint_roll( rng, 4000U ) * 1000U);
+    long then = fd_log_wallclock() + gap;
+    while( fd_log_wallclock()<then ) { fd_idle_wake( sync, seq ); FD_YIELD(); }
+
+    ulong frag_cnt = 1UL + (ulong)fd_rng_uint_roll( rng, (uint)BURST_MAX );
+    for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+      fd_mcache_publish( mcache, DEPTH, seq, fd_ulong_hash( seq ), 0UL, 0UL, 0UL, 0UL, 0UL );
+      seq = fd_seq_inc( seq, 1UL );
+    }
+
+    fd_mcache_seq_update( sync, seq );
+    fd_idle_wake( sync, seq );
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  if( FD_UNLIKELY( fd_tile_cnt()<2UL ) ) FD_LOG_ERR(( "this unit test requires at least 2 tiles" ));
+
+  FD_TEST( fd_idle_align()    ==FD_IDLE_ALIGN     );
+  FD_TEST( fd_idle_footprint()==FD_IDLE_FOOTPRINT );
+
+  fd_idle_t _idle[1];
+
+  FD_TEST( !fd_idle_new( NULL,                       -1L,    -1L,       -1L ) ); /* NULL mem */
+  FD_TEST( !fd_idle_new( (void *)(1UL+(ulong)_idle), -1L,    -1L,       -1L ) ); /* misaligned */
+  FD_TEST( !fd_idle_new( _idle,                   1L<<41,    -1L,       -1L ) ); /* too long spin */
+  FD_TEST( !fd_idle_new( _idle,                      -1L, 1L<<41,       -1L ) ); /* too long pause */
+  FD_TEST( !fd_idle_new( _idle,                      -1L,    -1L, (long)2e9 ) ); /* too long park */
+  FD_TEST( !fd_idle_join  ( NULL ) );
+  FD_TEST( !fd_idle_leave ( NULL ) );
+  FD_TEST( !fd_idle_delete( NULL ) );
+
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( shmem, DEPTH, 0UL, 0UL ) ); FD_TEST( mcache );
+  ulong *          sync   = fd_mcache_seq_laddr( mcache );
+  FD_TEST( !sync[ FD_IDLE_SEQ_WAITER_CNT ] );
+  FD_TEST( !sync[ FD_IDLE_SEQ_DOORBELL   ] );
+
+  /* Test the producer side in isolation.  With no waiters, the doorbell
+     is never rung.  With waiters, it is rung once per new seq. */
+
+  fd_idle_wake( sync, 3UL ); FD_TEST( !sync[ FD_IDLE_SEQ_DOORBELL ] );
+  sync[ FD_IDLE_SEQ_WAITER_CNT ] = 1UL;
+  fd_idle_wake( sync, 3UL ); FD_TEST( sync[ FD_IDLE_SEQ_DOORBELL ]==3UL );
+  fd_idle_wake( sync, 3UL ); FD_TEST( sync[ FD_IDLE_SEQ_DOORBELL ]==3UL );
+  fd_idle_wake( sync, 5UL ); FD_TEST( sync[ FD_IDLE_SEQ_DOORBELL ]==5UL );
+  sync[ FD_IDLE_SEQ_WAITER_CNT ] = 0UL;
+  sync[ FD_IDLE_SEQ_DOORBELL   ] = 0UL;
+
+  /* Test the idle phases in isolation.  A 1 ms park with nobody to ring
+     the doorbell should time out.  Progress should restart the streak.
+     A watch location that has already changed should not park. */
+
+  fd_idle_t * idle = fd_idle_join( fd_idle_new( _idle, 10000L, 10000L, 1000000L ) ); FD_TEST( idle );
+  FD_LOG_NOTICE(( "waitpkg %s", idle->waitpkg ? "supported" : "not supported (pause phase will spin)" ));
+
+  ulong watch = 0UL;
+  long  t0    = fd_log_wallclock();
+  ulong iter  = 0UL;
+  while( !fd_idle_park_cnt( idle ) ) { fd_idle_wait( idle, 1UL, fd_tickcount(), &watch, 0UL, sync ); iter++; }
+  long  dt    = fd_log_wallclock() - t0;
+  FD_LOG_NOTICE(( "first park after %lu iter, %li ns", iter, dt ));
+  FD_TEST( dt>=1000000L ); /* spin + pause + timed out park */
+  FD_TEST( !fd_idle_wake_cnt( idle ) );
+  FD_TEST( !sync[ FD_IDLE_SEQ_WAITER_CNT ] );
+
+  fd_idle_wait( idle, 2UL, fd_tickcount(), &watch, 0UL, sync ); /* New streak */
+  fd_idle_wait( idle, 2UL, fd_tickcount(), &watch, 0UL, sync ); /* Spinning */
+  FD_TEST( fd_idle_park_cnt( idle )==1UL );
+
+  watch = 1UL;
+  for( ulong rem=100UL; rem; rem-- ) fd_idle_wait( idle, 1UL, fd_tickcount()+(long)1e9, &watch, 0UL, sync );
+  FD_TEST( fd_idle_park_cnt( idle )==1UL );
+
+  fd_idle_wait( idle, 3UL, fd_tickcount(), &watch, 1UL, NULL ); /* Never parks without a sync */
+  for( ulong rem=100UL; rem; rem-- ) fd_idle_wait( idle, 3UL, fd_tickcount()+(long)1e9, &watch, 1UL, NULL );
+  FD_TEST( fd_idle_park_cnt( idle )==1UL );
+
+  /* Test idling on a file descriptor.  A park on an empty pipe should
+     time out and a park on a readable one should end right away. */
+
+  int pipe_fd[2]; FD_TEST( !pipe( pipe_fd ) );
+  while( fd_idle_park_cnt( idle )<2UL ) fd_idle_wait_fd( idle, 4UL, fd_tickcount(), pipe_fd[0] );
+  FD_TEST( !fd_idle_wake_cnt( idle ) );
+  FD_TEST( write( pipe_fd[1], "x", 1UL )==1L );
+  while( fd_idle_park_cnt( idle )<3UL ) fd_idle_wait_fd( idle, 4UL, fd_tickcount(), pipe_fd[0] );
+  FD_TEST( fd_idle_wake_cnt( idle )==1UL );
+  FD_TEST( !close( pipe_fd[0] ) );
+  FD_TEST( !close( pipe_fd[1] ) );
+
+  FD_TEST( fd_idle_delete( fd_idle_leave( idle ) )==_idle );
+
+  /* Test a consumer that idles between bursts of frags from a producer
+     on another tile.  Parks long enough that the producer should be the
+     one waking up the consumer most of the time.  All frags should be
+     received in order. */
+
+  idle = fd_idle_join( fd_idle_new( _idle, 10000L, 100000L, 100000000L ) ); FD_TEST( idle );
+
+  FD_VOLATILE( rx_seq ) = fd_mcache_seq0( mcache );
+  fd_tile_exec_t * tx_exec = fd_tile_exec_new( 1UL, tx_main, 0, (char **)mcache );
+  FD_TEST( tx_exec );
+
+  ulong                  seq     = fd_mcache_seq0( mcache );
+  fd_frag_meta_t const * mline   = mcache + fd_mcache_line_idx( seq, DEPTH );
+  ulong                  rx_cnt  = 0UL;
+  long                   rx_then = fd_log_wallclock() + (long)10e9;
+  for(;;) {
+    FD_COMPILER_MFENCE();
+    ulong seq_found = mline->seq;
+    FD_COMPILER_MFENCE();
+    long diff = fd_seq_diff( seq, seq_found );
+    if( FD_UNLIKELY( diff ) ) {
+      FD_TEST( diff>0L ); /* Never overrun */
+      if( FD_UNLIKELY( fd_tile_exec_done( tx_exec ) && fd_mcache_seq_query( sync )==seq ) ) break;
+      FD_TEST( fd_log_wallclock()<rx_then );
+      fd_idle_wait( idle, seq, fd_tickcount(), &mline->seq, seq_found, sync );
+      continue;
+    }
+    FD_TEST( mline->sig==fd_ulong_hash( seq ) );
+    seq   = fd_seq_inc( seq, 1UL );
+    mline = mcache + fd_mcache_line_idx( seq, DEPTH );
+    rx_cnt++;
+    FD_VOLATILE( rx_seq ) = seq;
+  }
+
+  int ret;
+  FD_TEST( !fd_tile_exec_delete( tx_exec, &ret ) );
+  FD_TEST( !ret );
+
+  ulong park_cnt = fd_idle_park_cnt( idle );
+  ulong wake_cnt = fd_idle_wake_cnt( idle );
+  FD_LOG_NOTICE(( "rx_cnt %lu park_cnt %lu wake_cnt %lu", rx_cnt, park_cnt, wake_cnt ));
+  FD_TEST( rx_cnt>=BURST_CNT );
+  FD_TEST( park_cnt );
+  FD_TEST( wake_cnt ); /* 100 ms parks, the producer should have woken us at least once */
+  FD_TEST( !sync[ FD_IDLE_SEQ_WAITER_CNT ] );
+
+  FD_TEST( fd_idle_delete( fd_idle_leave( idle ) )==_idle );
+  FD_TEST( fd_mcache_delete( fd_mcache_leave( mcache ) )==shmem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
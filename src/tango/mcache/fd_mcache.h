@@ -379,6 +379,153 @@ fd_mcache_publish_avx( fd_frag_meta_t * mcache,   /* Assumed a current local joi
 
 #endif
 
+#if FD_HAS_ATOMIC
+
+/* Multiple producer API
+
+   The above publish APIs assume a single producer per mcache.  Fanning
+   in multiple streams then requires a mux tile (and an extra hop of
+   latency).  For low rate producers (e.g. housekeeping, gossip, etc)
+   that is overkill.  The below allows multiple producers to share a
+   single mcache directly.
+
+   Each producer reserves sequence numbers with fd_mcache_mp_reserve
+   (an atomic fetch-and-add on the mcache's seq[0]), writes the frag
+   payloads into its own dcache (the usual practice of indexing chunks
+   relative to a common workspace makes multiple producer dcaches
+   transparent to consumers) and then publishes the reserved sequence
+   numbers with fd_mcache_mp_publish.  Producers can publish their
+   reservations in any order relative to other producers.  In multiple
+   producer mode, seq[0] is the next sequence number that will be
+   reserved.  That is, all sequence numbers before seq[0] have been
+   reserved but are not necessarily published yet.
+
+   Consumers use the exact same FD_MCACHE_WAIT* / overrun handling as
+   for a single producer mcache.  The only difference is that a
+   reserved sequence number might not get published for a long time
+   (or ever if its producer dies or abandons the reservation).  A
+   consumer waiting on such a gap will see its waits time out while
+   seq[0] has moved past the sequence number it is waiting for.
+   fd_mcache_mp_gap_query can be used in consumer housekeeping to
+   detect this and the consumer can decide to skip the gap (e.g. after
+   the same gap has been seen over more than a couple of housekeeping
+   intervals).  A producer that cannot use a reservation should
+   publish it with fd_mcache_mp_cancel to avoid creating a gap.
+
+   Flow control works as usual with the caveat that the producers
+   share the consumers' credits.  A producer can compute its credits
+   available as, for example:
+
+     cr_max - fd_seq_diff( fd_mcache_seq_query( seq ), fd_fseq_query( rx_fseq ) )
+
+   before reserving.  As this is racy between producers, cr_max should
+   be reduced by the maximum number of producers that might reserve
+   concurrently (times the number of sequence numbers each reserves at
+   a time).  fd_mcache_mp_publish will not overwrite a line that has
+   been claimed for a newer sequence number (it fails instead), such
+   that a very late producer can never clobber newer metadata. */
+
+/* fd_mcache_mp_reserve atomically reserves cnt (positive) consecutive
+   sequence numbers from a multiple producer mcache whose seq[0] is at
+   _seq (e.g. from fd_mcache_seq_laddr).  Returns the first reserved
+   sequence number.  This is an atomic operation (and thus a full
+   memory fence). */
+
+static inline ulong
+fd_mcache_mp_reserve( ulong * _seq,
+                      ulong   cnt ) {
+  return FD_ATOMIC_FETCH_AND_ADD( _seq, cnt );
+}
+
+/* fd_mcache_mp_publish publishes reserved sequence number seq to a
+   multiple producer mcache.  Arguments are the same as
+   fd_mcache_publish.  Returns 1 on success and 0 if the line for seq
+   has already been claimed for a newer sequence number (i.e. this
+   producer was so slow that it was lapped, the frag is dropped and
+   consumers will see it as an overrun).
+
+   The line is claimed with a compare-and-swap from a published (or
+   initial) state for an older sequence number to seq-2.  Like the
+   seq-1 used by fd_mcache_publish, consumers waiting for seq see seq-2
+   as not yet published and consumers waiting for the line's previous
+   sequence number see it as overrun.  Unlike seq-1, seq-2 can be
+   distinguished from the state fd_mcache_new leaves a line in, which
+   lets producers tell a line being written by another producer apart
+   from a free line.  If the line is currently being written by a
+   producer for an older sequence number, this spins until that write
+   completes (this is typically a handful of ns but requires that
+   producers are not preempted while writing a line).  Once claimed,
+   the line body is written exactly like fd_mcache_publish.  This costs
+   an atomic operation per publish. */
+
+static inline int
+fd_mcache_mp_publish( fd_frag_meta_t * mcache,   /* Assumed a current local join */
+                      ulong            depth,    /* Assumed an integer power-of-2 >= BLOCK */
+                      ulong            seq,
+                      ulong            sig,
+                      ulong            chunk,    /* Assumed in [0,UINT_MAX] */
+                      ulong            sz,       /* Assumed in [0,USHORT_MAX] */
+                      ulong            ctl,      /* Assumed in [0,USHORT_MAX] */
+                      ulong            tsorig,   /* Assumed in [0,UINT_MAX] */
+                      ulong            tspub ) { /* Assumed in [0,UINT_MAX] */
+  ulong            line = fd_mcache_line_idx( seq, depth );
+  fd_frag_meta_t * meta = mcache + line;
+  for(;;) {
+    FD_COMPILER_MFENCE();
+    ulong seq_line = meta->seq;
+    FD_COMPILER_MFENCE();
+    int   busy     = (fd_mcache_line_idx( fd_seq_inc( seq_line, 2UL ), depth )==line); /* Being written by another producer */
+    ulong seq_own  = fd_ulong_if( busy, fd_seq_inc( seq_line, 2UL ), seq_line );
+    if( FD_UNLIKELY( fd_seq_ge( seq_own, seq ) ) ) return 0; /* Line claimed for seq or newer already */
+    if( FD_LIKELY( !busy ) && FD_LIKELY( FD_ATOMIC_CAS( &meta->seq, seq_line, fd_seq_dec( seq, 2UL ) )==seq_line ) ) break;
+    FD_SPIN_PAUSE(); /* Being written for an older seq or lost a race, try again */
+  }
+  FD_COMPILER_MFENCE();
+  meta->sig    =         sig;
+  meta->chunk  = (uint  )chunk;
+  meta->sz     = (ushort)sz;
+  meta->ctl    = (ushort)ctl;
+  meta->tsorig = (uint  )tsorig;
+  meta->tspub  = (uint  )tspub;
+  FD_COMPILER_MFENCE();
+  meta->seq    = seq;
+  FD_COMPILER_MFENCE();
+  return 1;
+}
+
+/* fd_mcache_mp_cancel publishes reserved sequence number seq as an
+   empty frag with the err bit set in ctl (and sig, chunk, sz, tsorig
+   and tspub zero).  Consumers should treat such a frag like any other
+   error frag (e.g. skip it).  Returns the same as fd_mcache_mp_publish.  */
+
+static inline int
+fd_mcache_mp_cancel( fd_frag_meta_t * mcache,
+                     ulong            depth,
+                     ulong            seq ) {
+  return fd_mcache_mp_publish( mcache, depth, seq, 0UL, 0UL, 0UL, fd_frag_meta_ctl( 0UL, 1, 1, 1 ), 0UL, 0UL );
+}
+
+/* fd_mcache_mp_gap_query returns 1 if sequence number seq of a
+   multiple producer mcache (with seq[0] at _seq, e.g. from
+   fd_mcache_seq_laddr_const) has been reserved but not yet published
+   (i.e. a consumer waiting for seq is waiting on a slow or dead
+   producer) and 0 otherwise (seq is published, has not been reserved
+   yet or has been overrun).  This is meant to be used in consumer
+   housekeeping when a wait for seq is timing out.  This acts as a
+   compiler memory fence. */
+
+static inline int
+fd_mcache_mp_gap_query( fd_frag_meta_t const * mcache,
+                        ulong                  depth,
+                        ulong const *          _seq,
+                        ulong                  seq ) {
+  ulong seq_line = fd_frag_meta_seq_query( mcache + fd_mcache_line_idx( seq, depth ) );
+  ulong seq_next = fd_mcache_seq_query( _seq );
+  return fd_seq_lt( seq_line, seq ) & fd_seq_lt( seq, seq_next );
+}
+
+#endif /* FD_HAS_ATOMIC */
+
 /* FD_MCACHE_WAIT does a bounded wait for a producer to transmit a
    particular frag.
 
@@ -25,6 +25,39 @@ FD_STATIC_ASSERT( FD_MCACHE_BLOCK        == 128UL, unit_test );
 
 static uchar __attribute__((aligned(FD_MCACHE_ALIGN))) shmem[ FD_MCACHE_FOOTPRINT( DEPTH_MAX, APP_MAX ) ];
 
+#if FD_HAS_X86 && FD_HAS_ATOMIC
+
+/* Multiple producer test.  Producers run on tiles [1,tile_cnt) and
+   each publishes MP_ITER_CNT frags with sig seq^tile_idx (with a crude
+   shared flow control) while tile 0 consumes them in order. */
+
+#define MP_DEPTH    (128UL)
+#define MP_ITER_CNT (100000UL)
+
+static uchar __attribute__((aligned(FD_MCACHE_ALIGN))) mp_shmem[ FD_MCACHE_FOOTPRINT( MP_DEPTH, 0UL ) ];
+static ulong mp_rx_seq; /* Next sequence number the consumer will process */
+
+static int
+mp_tx_main( int     argc,
+            char ** argv ) {
+  (void)argc; (void)argv;
+  fd_frag_meta_t * mcache = fd_mcache_join( mp_shmem );
+  ulong *          _seq   = fd_mcache_seq_laddr( mcache );
+  ulong            tag    = fd_tile_idx();
+  ulong            tx_cnt = fd_tile_cnt() - 1UL;
+  for( ulong iter=0UL; iter<MP_ITER_CNT; iter++ ) {
+    /* Credits are shared between producers so reserve a margin of one
+       frag per producer */
+    while( fd_seq_diff( fd_mcache_seq_query( _seq ), FD_VOLATILE_CONST( mp_rx_seq ) )>=(long)(MP_DEPTH-tx_cnt) ) FD_YIELD();
+    ulong seq = fd_mcache_mp_reserve( _seq, 1UL );
+    FD_TEST( fd_mcache_mp_publish( mcache, MP_DEPTH, seq, seq ^ tag, 0UL, 0UL, fd_frag_meta_ctl( tag, 1, 1, 0 ), 0UL, 0UL ) );
+  }
+  fd_mcache_leave( mcache );
+  return 0;
+}
+
+#endif
+
 int
 main( int     argc,
       char ** argv ) {
@@ -202,6 +235,110 @@ main( int     argc,
   FD_TEST( fd_mcache_leave ( mcache   )==shmcache );
   FD_TEST( fd_mcache_delete( shmcache )==shmem    );
 
+# if FD_HAS_X86 && FD_HAS_ATOMIC
+
+  /* Test multiple producer publishing */
+
+  FD_TEST( fd_mcache_new( mp_shmem, MP_DEPTH, 0UL, seq0 ) );
+  fd_frag_meta_t * mp = fd_mcache_join( mp_shmem ); FD_TEST( mp );
+  ulong * mp_seq = fd_mcache_seq_laddr( mp );
+
+  ulong a = fd_mcache_mp_reserve( mp_seq, 1UL ); FD_TEST( a==seq0 );
+  ulong b = fd_mcache_mp_reserve( mp_seq, 2UL ); FD_TEST( b==fd_seq_inc( a, 1UL ) );
+  ulong c = fd_seq_inc( b, 1UL );
+  FD_TEST( fd_mcache_seq_query( mp_seq )==fd_seq_inc( a, 3UL ) );
+
+  FD_TEST( !fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, fd_seq_inc( a, 3UL ) ) ); /* not reserved */
+  FD_TEST(  fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, a ) );
+
+  /* Publish out of order */
+
+  FD_TEST( fd_mcache_mp_publish( mp, MP_DEPTH, c, 3UL, 0UL, 0UL, 0UL, 0UL, 0UL ) );
+  FD_TEST( !fd_mcache_mp_publish( mp, MP_DEPTH, c, 3UL, 0UL, 0UL, 0UL, 0UL, 0UL ) ); /* already published */
+  FD_TEST( fd_seq_eq( fd_mcache_query( mp, MP_DEPTH, c ), c ) );
+  FD_TEST( fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, a ) );
+  FD_TEST( fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, b ) );
+
+  fd_frag_meta_t         meta[1];
+  fd_frag_meta_t const * mline;
+  ulong                  seq_found;
+  long                   seq_diff;
+  ulong                  poll_max = 16UL;
+  FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mp, MP_DEPTH, a );
+  FD_TEST( !poll_max ); /* a is a gap so the wait should time out */
+
+  FD_TEST( fd_mcache_mp_publish( mp, MP_DEPTH, a, 1UL, 0UL, 0UL, 0UL, 0UL, 0UL ) );
+  FD_TEST( !fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, a ) );
+  poll_max = 16UL;
+  FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mp, MP_DEPTH, a );
+  FD_TEST( poll_max ); FD_TEST( !seq_diff ); FD_TEST( seq_found==a ); FD_TEST( mline==mp+fd_mcache_line_idx( a, MP_DEPTH ) );
+  FD_TEST( meta->sig==1UL );
+
+  FD_TEST( fd_mcache_mp_cancel( mp, MP_DEPTH, b ) );
+  FD_TEST( !fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, b ) );
+  poll_max = 16UL;
+  FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mp, MP_DEPTH, b );
+  FD_TEST( poll_max ); FD_TEST( !seq_diff ); FD_TEST( fd_frag_meta_ctl_err( (ulong)meta->ctl ) ); FD_TEST( !meta->sz );
+
+  /* A producer lapped by a newer reservation should not clobber the
+     newer frag */
+
+  ulong d = fd_mcache_mp_reserve( mp_seq, MP_DEPTH+1UL );
+  ulong e = fd_seq_inc( d, MP_DEPTH );
+  FD_TEST(  fd_mcache_mp_publish( mp, MP_DEPTH, e, 5UL, 0UL, 0UL, 0UL, 0UL, 0UL ) );
+  FD_TEST( !fd_mcache_mp_publish( mp, MP_DEPTH, d, 4UL, 0UL, 0UL, 0UL, 0UL, 0UL ) );
+  FD_TEST( fd_seq_eq( fd_mcache_query( mp, MP_DEPTH, d ), e ) );
+  FD_TEST( mp[ fd_mcache_line_idx( e, MP_DEPTH ) ].sig==5UL );
+  FD_TEST( !fd_mcache_mp_gap_query( mp, MP_DEPTH, mp_seq, d ) ); /* overrun, not a gap */
+
+  FD_TEST( fd_mcache_leave ( mp       )==mp_shmem );
+  FD_TEST( fd_mcache_delete( mp_shmem )==mp_shmem );
+
+  /* Test multiple concurrent producers */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) FD_LOG_WARNING(( "skipping concurrent multiple producer test (needs at least 2 tiles)" ));
+  else {
+    FD_LOG_NOTICE(( "Testing %lu concurrent producers", tile_cnt-1UL ));
+
+    FD_TEST( fd_mcache_new( mp_shmem, MP_DEPTH, 0UL, seq0 ) );
+    mp = fd_mcache_join( mp_shmem ); FD_TEST( mp );
+    FD_VOLATILE( mp_rx_seq ) = seq0;
+
+    fd_tile_exec_t * exec[ FD_TILE_MAX ];
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) exec[ tile_idx ] = fd_tile_exec_new( tile_idx, mp_tx_main, 0, NULL );
+
+    ulong rx_cnt[ FD_TILE_MAX ]; fd_memset( rx_cnt, 0, sizeof(rx_cnt) );
+    ulong rx_seq = seq0;
+    for( ulong rem=(tile_cnt-1UL)*MP_ITER_CNT; rem; rem-- ) {
+      for(;;) {
+        poll_max = 1024UL;
+        FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mp, MP_DEPTH, rx_seq );
+        if( FD_LIKELY( poll_max ) ) break;
+        FD_YIELD(); /* Let producers run if oversubscribed */
+      }
+      FD_TEST( !seq_diff ); /* No overruns (flow controlled) */
+      ulong tag = fd_frag_meta_ctl_orig( (ulong)meta->ctl );
+      FD_TEST( (1UL<=tag) & (tag<tile_cnt) );
+      FD_TEST( meta->sig==(rx_seq ^ tag) );
+      rx_cnt[ tag ]++;
+      rx_seq = fd_seq_inc( rx_seq, 1UL );
+      FD_VOLATILE( mp_rx_seq ) = rx_seq;
+    }
+
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) {
+      int ret;
+      FD_TEST( !fd_tile_exec_delete( exec[ tile_idx ], &ret ) ); FD_TEST( !ret );
+      FD_TEST( rx_cnt[ tile_idx ]==MP_ITER_CNT );
+    }
+    FD_TEST( fd_mcache_seq_query( fd_mcache_seq_laddr( mp ) )==rx_seq );
+
+    FD_TEST( fd_mcache_leave ( mp       )==mp_shmem );
+    FD_TEST( fd_mcache_delete( mp_shmem )==mp_shmem );
+  }
+
+# endif
+
   fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
@@ -56,6 +56,17 @@
 
 #define FD_TCACHE_SPARSE_DEFAULT (2)
 
+/* FD_TCACHE_HOT_{DEPTH,MAP_CNT} specify the recommended configuration
+   for the small first level tcache of a two-level tcache (see
+   FD_TCACHE_INSERT_HOT below).  DEPTH is a power of 2 minus 2 and
+   MAP_CNT is fd_tcache_map_cnt_default( DEPTH ).  The resulting
+   FD_TCACHE_FOOTPRINT( DEPTH, MAP_CNT ) is ~96 KiB, which comfortably
+   fits in a typical core's L2 cache (and the slots around the newest
+   and oldest tags will typically be in L1). */
+
+#define FD_TCACHE_HOT_DEPTH   (4094UL)
+#define FD_TCACHE_HOT_MAP_CNT (8192UL)
+
 /* fd_tcache_t is an opaque handle of a tcache object.  Details are
    exposed here to facilitate usage of tcache in performance critical
    contexts. */
@@ -402,6 +413,65 @@ fd_tcache_remove( ulong * map,
     (oldest) = _fti_oldest;                                                      \
   } while(0)
 
+/* FD_TCACHE_INSERT_HOT is FD_TCACHE_INSERT for a two-level tcache.  The
+   first level ("hot") is a small tcache (e.g. FD_TCACHE_HOT_DEPTH
+   tags) that should fit in a core's L1 / L2 and the second level is a
+   (typically large and DRAM resident) tcache.  The hot tcache holds the
+   most recent hot_depth unique tags inserted into the tcache.  Since
+   these are a subset of the most recent depth unique tags held by the
+   tcache (assuming hot_depth<=depth), a tag found in the hot tcache is
+   a duplicate without needing to touch the tcache at all.  If a tag is
+   not found in the hot tcache, it is inserted into the tcache as usual
+   and, if unique, also inserted into the hot tcache.
+
+   The result (dup and the tcache state) is exactly what
+   FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, tag ) would
+   produce.  That is, the hot tcache is purely an accelerator for the
+   (common) case of temporally clustered duplicates (e.g. spam bursts)
+   and never changes which tags are considered duplicates.  Note that
+   duplicates found in the tcache but not in the hot tcache are _not_
+   inserted into the hot tcache (doing so would break the subset
+   invariant above).
+
+   Same assumptions as FD_TCACHE_INSERT for both levels.  Additionally
+   assumes hot_depth<=depth and that the hot tcache is only ever
+   inserted into via this macro (a reset hot tcache is always valid).
+   As the hot tcache is typically private to the thread of execution
+   using it, it is fine to keep it in thread local scratch memory and
+   reset it on (re)start. */
+
+#define FD_TCACHE_INSERT_HOT( dup, hot_oldest, hot_ring, hot_depth, hot_map, hot_map_cnt,                     \
+                              oldest, ring, depth, map, map_cnt, tag ) do {                                   \
+    ulong   _ftih_hot_oldest  = (hot_oldest);                                                                 \
+    ulong * _ftih_hot_ring    = (hot_ring);                                                                   \
+    ulong   _ftih_hot_depth   = (hot_depth);                                                                  \
+    ulong * _ftih_hot_map     = (hot_map);                                                                    \
+    ulong   _ftih_hot_map_cnt = (hot_map_cnt);                                                                \
+    ulong   _ftih_oldest      = (oldest);                                                                     \
+    ulong   _ftih_tag         = (tag);                                                                        \
+                                                                                                              \
+    int   _ftih_dup;                                                                                          \
+    ulong _ftih_hot_map_idx;                                                                                  \
+    FD_TCACHE_QUERY( _ftih_dup, _ftih_hot_map_idx, _ftih_hot_map, _ftih_hot_map_cnt, _ftih_tag );             \
+    if( !_ftih_dup ) { /* application dependent branch probability */                                         \
+      FD_TCACHE_INSERT( _ftih_dup, _ftih_oldest, (ring), (depth), (map), (map_cnt), _ftih_tag );              \
+      if( !_ftih_dup ) { /* application dependent branch probability */                                       \
+                                                                                                              \
+        /* Unique tag ... insert it into the hot tcache too.  The hot */                                      \
+        /* query above is still valid as nothing touched hot map.    */                                       \
+        _ftih_hot_map[ _ftih_hot_map_idx ] = _ftih_tag;                                                       \
+        ulong _ftih_tag_oldest = _ftih_hot_ring[ _ftih_hot_oldest ];                                          \
+        _ftih_hot_ring[ _ftih_hot_oldest ] = _ftih_tag;                                                       \
+        _ftih_hot_oldest++;                                                                                   \
+        if( _ftih_hot_oldest >= _ftih_hot_depth ) _ftih_hot_oldest = 0UL; /* cmov */                          \
+        fd_tcache_remove( _ftih_hot_map, _ftih_hot_map_cnt, _ftih_tag_oldest );                               \
+      }                                                                                                       \
+    }                                                                                                         \
+    (dup)        = _ftih_dup;                                                                                 \
+    (hot_oldest) = _ftih_hot_oldest;                                                                          \
+    (oldest)     = _ftih_oldest;                                                                              \
+  } while(0)
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_tcache_fd_tcache_h */
@@ -9,6 +9,9 @@ FD_STATIC_ASSERT( FD_TCACHE_TAG_NULL==0UL, unit_test );
 
 FD_STATIC_ASSERT( FD_TCACHE_SPARSE_DEFAULT==2, unit_test );
 
+FD_STATIC_ASSERT( FD_TCACHE_HOT_DEPTH  ==4094UL, unit_test );
+FD_STATIC_ASSERT( FD_TCACHE_HOT_MAP_CNT==8192UL, unit_test );
+
 int
 main( int     argc,
       char ** argv ) {
@@ -25,6 +28,7 @@ main( int     argc,
   FD_TEST( fd_tcache_map_cnt_default( 3UL )==16UL );
   FD_TEST( fd_tcache_map_cnt_default( 6UL )==16UL );
   FD_TEST( fd_tcache_map_cnt_default( 7UL )==32UL );
+  FD_TEST( fd_tcache_map_cnt_default( FD_TCACHE_HOT_DEPTH )==FD_TCACHE_HOT_MAP_CNT );
   for( ulong rem=1000000UL; rem; rem-- ) {
     uint  r       = fd_rng_uint( rng );
     ulong depth   = (ulong)(r & 1023U);     r >>= 10;
@@ -199,12 +203,76 @@ main( int     argc,
     rem += (ulong)is_dup; /* Only count unique inserts */
   }
 
+  FD_LOG_NOTICE(( "Testing two-level (hot) insert" ));
+
+  ulong   hot_depth     = fd_ulong_min( FD_TCACHE_HOT_DEPTH, depth );
+  ulong   hot_map_cnt   = FD_TCACHE_HOT_MAP_CNT;
+  void *  hot_mem       = fd_wksp_alloc_laddr( wksp, fd_tcache_align(), fd_tcache_footprint( hot_depth, hot_map_cnt ) );
+  FD_TEST( hot_mem );
+  fd_tcache_t * hot     = fd_tcache_join( fd_tcache_new( hot_mem, hot_depth, hot_map_cnt ) ); FD_TEST( hot );
+  ulong * hot_ring      = fd_tcache_ring_laddr( hot );
+  ulong * hot_map       = fd_tcache_map_laddr ( hot );
+  ulong   hot_oldest    = 0UL;
+
+  oldest = fd_tcache_reset( ring, depth, map, map_cnt ); FD_TEST( !oldest );
+
+  for( ulong rem=3UL*depth; rem; rem-- ) {
+
+    /* Same tag generation as above */
+
+    ulong tag;
+
+    int is_dup = (fd_rng_uint( rng ) < dup_thresh);
+    if( is_dup ) {
+      ulong age; do age = (ulong)(uint)(int)(1.0f + dup_avg_age*fd_rng_float_exp( rng )); while( FD_UNLIKELY( age>depth ) );
+      ulong dup_idx = oldest + depth - age;
+      dup_idx = fd_ulong_if( dup_idx<depth, dup_idx, dup_idx-depth );
+      tag = ring[ dup_idx ];
+      if( FD_UNLIKELY( fd_tcache_tag_is_null( tag ) ) ) is_dup = 0;
+    }
+
+    if( !is_dup ) {
+      int found;
+      do {
+        do tag = fd_rng_ulong( rng ); while( FD_UNLIKELY( fd_tcache_tag_is_null( tag ) ) );
+        ulong map_idx;
+        FD_TCACHE_QUERY( found, map_idx, map, map_cnt, tag );
+        (void)map_idx;
+      } while( FD_UNLIKELY( found ) );
+    }
+
+    int dup;
+    FD_TCACHE_INSERT_HOT( dup, hot_oldest, hot_ring, hot_depth, hot_map, hot_map_cnt, oldest, ring, depth, map, map_cnt, tag );
+    FD_TEST( dup==is_dup );
+    FD_TEST( hot_oldest<hot_depth );
+
+    /* The newest unique tag should be the newest in both levels and
+       every tag in the hot tcache should be in the tcache */
+
+    ulong newest     = fd_ulong_if( !!oldest,     oldest,     depth     ) - 1UL;
+    ulong hot_newest = fd_ulong_if( !!hot_oldest, hot_oldest, hot_depth ) - 1UL;
+    FD_TEST( ring[ newest ]==hot_ring[ hot_newest ] );
+    if( !(rem & 1023UL) ) {
+      for( ulong hot_idx=0UL; hot_idx<hot_depth; hot_idx++ ) {
+        ulong hot_tag = hot_ring[ hot_idx ];
+        if( fd_tcache_tag_is_null( hot_tag ) ) continue;
+        int   found;
+        ulong map_idx;
+        FD_TCACHE_QUERY( found, map_idx, map, map_cnt, hot_tag );
+        FD_TEST( found ); FD_TEST( map[ map_idx ]==hot_tag );
+      }
+    }
+
+    rem += (ulong)is_dup; /* Only count unique inserts */
+  }
+
   FD_LOG_NOTICE(( "Benchmarking" ));
 
   ulong   bench_cnt = 1UL<<20;
   ulong * bench_tag = (ulong *)fd_wksp_alloc_laddr( wksp, 0UL, bench_cnt*sizeof(ulong) ); FD_TEST( bench_tag );
 
-  for( ulong iter=0UL; iter<10UL; iter++ ) {
+  for( ulong iter=0UL; iter<20UL; iter++ ) {
+    int use_hot = (int)(iter & 1UL); /* Alternate between plain and two-level inserts */
 
     /* Make a longish test vector */
     for( ulong bench_idx=0UL; bench_idx<bench_cnt; bench_idx++ ) {
@@ -219,23 +287,39 @@ main( int     argc,
       bench_tag[ bench_idx ] = tag;
     }
 
-    /* Benchmark it */
-    long tic = fd_log_wallclock();
-    for( ulong bench_idx=0UL; bench_idx<bench_cnt; bench_idx++ ) {
-      int dup;
-      FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, bench_tag[ bench_idx ] );
-      (void)dup;
+    /* Benchmark it (the hot tcache is reset as plain inserts do not
+       maintain it) */
+    long tic;
+    if( !use_hot ) {
+      tic = fd_log_wallclock();
+      for( ulong bench_idx=0UL; bench_idx<bench_cnt; bench_idx++ ) {
+        int dup;
+        FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, bench_tag[ bench_idx ] );
+        (void)dup;
+      }
+    } else {
+      hot_oldest = fd_tcache_reset( hot_ring, hot_depth, hot_map, hot_map_cnt );
+      tic = fd_log_wallclock();
+      for( ulong bench_idx=0UL; bench_idx<bench_cnt; bench_idx++ ) {
+        int dup;
+        FD_TCACHE_INSERT_HOT( dup, hot_oldest, hot_ring, hot_depth, hot_map, hot_map_cnt,
+                              oldest, ring, depth, map, map_cnt, bench_tag[ bench_idx ] );
+        (void)dup;
+      }
     }
     long toc = fd_log_wallclock();
 
     float avg = ((float)(toc-tic))/((float)bench_cnt);
-    FD_LOG_NOTICE(( "iter %lu: %.3f ns/dedup", iter, (double)avg ));
+    FD_LOG_NOTICE(( "iter %lu: %.3f ns/dedup%s", iter/2UL, (double)avg, use_hot ? " (hot)" : "" ));
   }
 
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   fd_wksp_free_laddr( bench_tag );
 
+  FD_TEST( fd_tcache_delete( fd_tcache_leave( hot ) )==hot_mem );
+  fd_wksp_free_laddr( hot_mem );
+
   FD_TEST( fd_tcache_leave ( tcache  )==_tcache );
   FD_TEST( fd_tcache_delete( _tcache )==mem     );
   fd_wksp_free_laddr( mem );
@@ -241,6 +241,142 @@ fd_tempo_observe_pair( long * opt_now,
 }
 #endif
 
+#if FD_HAS_DOUBLE && FD_HAS_X86
+
+ulong fd_tempo_clock_align    ( void ) { return FD_TEMPO_CLOCK_ALIGN;     }
+ulong fd_tempo_clock_footprint( void ) { return FD_TEMPO_CLOCK_FOOTPRINT; }
+
+FD_STATIC_ASSERT( sizeof(fd_tempo_clock_t)==FD_TEMPO_CLOCK_FOOTPRINT, layout );
+
+void *
+fd_tempo_clock_new( void * mem,
+                    double tick_per_ns,
+                    long   refresh ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_tempo_clock_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  if( tick_per_ns<=0. ) tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  if( FD_UNLIKELY( !(tick_per_ns<=DBL_MAX) ) ) { /* robust against nan */
+    FD_LOG_WARNING(( "bad tick_per_ns" ));
+    return NULL;
+  }
+
+  if( refresh<=0L ) refresh = FD_TEMPO_CLOCK_REFRESH_DEFAULT;
+  double _refresh = tick_per_ns*(double)refresh;
+  if( FD_UNLIKELY( !((1.<=_refresh) & (_refresh<=(double)(1L<<62))) ) ) {
+    FD_LOG_WARNING(( "refresh and tick_per_ns imply an unreasonable refresh interval" ));
+    return NULL;
+  }
+
+  fd_tempo_clock_t * clock = (fd_tempo_clock_t *)mem;
+
+  long now; long tic; fd_tempo_observe_pair( &now, &tic );
+
+  clock->tic0      = tic;
+  clock->ns0       = now;
+  clock->rate      = 1./tick_per_ns;
+  clock->slew      = 0.;
+  clock->obs_tic   = tic;
+  clock->obs_ns    = now;
+  clock->refresh   = (long)_refresh;
+  clock->reset_cnt = 0UL;
+
+  return mem;
+}
+
+fd_tempo_clock_t *
+fd_tempo_clock_join( void * _clock ) {
+  if( FD_UNLIKELY( !_clock ) ) {
+    FD_LOG_WARNING(( "NULL _clock" ));
+    return NULL;
+  }
+  return (fd_tempo_clock_t *)_clock;
+}
+
+void *
+fd_tempo_clock_leave( fd_tempo_clock_t * clock ) {
+  if( FD_UNLIKELY( !clock ) ) {
+    FD_LOG_WARNING(( "NULL clock" ));
+    return NULL;
+  }
+  return (void *)clock;
+}
+
+void *
+fd_tempo_clock_delete( void * _clock ) {
+  if( FD_UNLIKELY( !_clock ) ) {
+    FD_LOG_WARNING(( "NULL _clock" ));
+    return NULL;
+  }
+  return _clock;
+}
+
+long
+fd_tempo_clock_observe( fd_tempo_clock_t * clock,
+                        long               now,
+                        long               tic ) {
+
+  long pred   = fd_tempo_clock_ns( clock, tic );
+  long err    = now - pred;
+  long dt_tic = tic - clock->obs_tic;
+  long dt_ns  = now - clock->obs_ns;
+
+  clock->obs_tic = tic;
+  clock->obs_ns  = now;
+
+  if( FD_UNLIKELY( (dt_tic<=0L) | (dt_ns<=0L) | (err<-FD_TEMPO_CLOCK_STEP_MAX) | (err>FD_TEMPO_CLOCK_STEP_MAX) ) ) {
+
+    /* The wallclock was stepped (or observations were out of order).
+       Restart the model at this observation with the current rate
+       estimate (the rate observed over this interval is meaningless). */
+
+    clock->tic0 = tic;
+    clock->ns0  = now;
+    clock->slew = 0.;
+    clock->reset_cnt++;
+    return err;
+  }
+
+  /* Update the rate estimate with an EMA of the observed rate.  As the
+     observation jitter is fixed, observations over intervals shorter
+     than the refresh interval are proportionally less informative and
+     weighted accordingly. */
+
+  double w = 0.125*fd_double_if( dt_tic<clock->refresh, (double)dt_tic / (double)clock->refresh, 1. );
+  clock->rate += w*( (double)dt_ns / (double)dt_tic - clock->rate );
+
+  /* Anchor the model at tic where it currently is (such that the model
+     stays continuous) and slew away the error over the next refresh
+     interval.  We limit how fast the model can be slowed down such that
+     it is always increasing (any error not slewed away will be picked up
+     by the next refresh). */
+
+  double slew = (double)err / (double)clock->refresh;
+  double slew_min = -0.5*clock->rate;
+
+  clock->tic0 = tic;
+  clock->ns0  = pred;
+  clock->slew = fd_double_if( slew<slew_min, slew_min, slew );
+  return err;
+}
+
+int
+fd_tempo_clock_private_refresh( fd_tempo_clock_t * clock ) {
+  long now; long tic; fd_tempo_observe_pair( &now, &tic );
+  fd_tempo_clock_observe( clock, now, tic );
+  return 1;
+}
+
+#endif
+
 ulong
 fd_tempo_async_min( long  lazy,
                     ulong event_cnt,
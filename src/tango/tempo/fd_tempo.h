@@ -5,6 +5,52 @@
 
 #include "../fd_tango_base.h"
 
+#if FD_HAS_DOUBLE && FD_HAS_X86
+
+/* A fd_tempo_clock models the relationship between fd_tickcount() and
+   fd_log_wallclock() such that a tile can convert tickcounts into
+   wallclock ns with a handful of instructions and without reading the
+   wallclock.  Unlike a conversion with a fixed fd_tempo_tick_per_ns,
+   the model tracks how the two clocks drift relative to each other over
+   long periods of time (e.g. days) by being periodically refreshed with
+   joint observations (typically in a tile's housekeeping).
+
+   The model is piecewise linear and continuous.  Each refresh anchors
+   the model at the current tickcount with the current modeled time
+   (such that converted times never jump), updates the rate estimate
+   from the observed rate since the previous refresh and slews away any
+   error between the modeled and observed wallclock over the next
+   refresh interval.  If the observed error is implausibly large (e.g.
+   the wallclock was stepped by an administrator), the model is
+   restarted at the observation instead.  Internals are exposed here to
+   facilitate inlining and should not be used directly. */
+
+#define FD_TEMPO_CLOCK_ALIGN     (64UL)
+#define FD_TEMPO_CLOCK_FOOTPRINT (64UL)
+
+/* FD_TEMPO_CLOCK_REFRESH_DEFAULT is the default interval in ns between
+   model refreshes.  FD_TEMPO_CLOCK_STEP_MAX is the largest error in ns
+   between the modeled and observed wallclock that will be slewed away
+   (larger errors restart the model). */
+
+#define FD_TEMPO_CLOCK_REFRESH_DEFAULT (100000000L) /* 100 ms */
+#define FD_TEMPO_CLOCK_STEP_MAX        (1000000L)   /* 1 ms */
+
+struct __attribute__((aligned(FD_TEMPO_CLOCK_ALIGN))) fd_tempo_clock_private {
+  long   tic0;      /* Tickcount at the model anchor */
+  long   ns0;       /* Modeled wallclock at the model anchor */
+  double rate;      /* Estimated ns per tick */
+  double slew;      /* Additional ns per tick applied for the first refresh ticks past the anchor */
+  long   obs_tic;   /* Tickcount of the most recent observation */
+  long   obs_ns;    /* Wallclock of the most recent observation */
+  long   refresh;   /* Interval in ticks between refreshes, positive */
+  ulong  reset_cnt; /* Number of times the model was restarted */
+};
+
+typedef struct fd_tempo_clock_private fd_tempo_clock_t;
+
+#endif
+
 FD_PROTOTYPES_BEGIN
 
 #if FD_HAS_DOUBLE
@@ -98,6 +144,95 @@ fd_tempo_observe_pair( long * opt_now,
 
 #endif
 
+#if FD_HAS_DOUBLE && FD_HAS_X86
+
+/* fd_tempo_clock_{align,footprint} return FD_TEMPO_CLOCK_{ALIGN,
+   FOOTPRINT}.
+
+   fd_tempo_clock_new formats a memory region with the appropriate
+   alignment and footprint as a fd_tempo_clock.  The model starts at a
+   fresh fd_tempo_observe_pair with a rate of tick_per_ns ticks per ns
+   (<=0 indicates to use fd_tempo_tick_per_ns( NULL )) and will be
+   refreshed roughly every refresh ns (<=0 indicates to use
+   FD_TEMPO_CLOCK_REFRESH_DEFAULT).  Returns mem on success and NULL on
+   failure (logs details).
+
+   fd_tempo_clock_join joins the caller to a fd_tempo_clock.  Returns
+   the local handle on success and NULL on failure (logs details).
+   fd_tempo_clock_leave leaves a current local join and returns the
+   underlying memory region.  fd_tempo_clock_delete unformats the
+   memory region and returns ownership of it to the caller.  A
+   fd_tempo_clock has no shared state with anything else such that
+   these are mostly for consistency with other APIs (e.g. it can be
+   declared on the stack like fd_rng).  It is not safe for concurrent
+   use by multiple threads. */
+
+FD_FN_CONST ulong fd_tempo_clock_align    ( void );
+FD_FN_CONST ulong fd_tempo_clock_footprint( void );
+
+void *
+fd_tempo_clock_new( void * mem,
+                    double tick_per_ns,
+                    long   refresh );
+
+fd_tempo_clock_t * fd_tempo_clock_join  ( void *             _clock );
+void *             fd_tempo_clock_leave ( fd_tempo_clock_t * clock  );
+void *             fd_tempo_clock_delete( void *             _clock );
+
+/* fd_tempo_clock_ns returns the modeled fd_log_wallclock() at
+   tickcount tic.  This is a handful of instructions and does not read
+   any clocks.  tic should be reasonably close to (e.g. within a few
+   refresh intervals of) the most recent refresh for best accuracy (it
+   is fine for tic to be before the most recent refresh, e.g. for
+   converting frag timestamps).  The model is non-decreasing in tic. */
+
+FD_FN_PURE static inline long
+fd_tempo_clock_ns( fd_tempo_clock_t const * clock,
+                   long                     tic ) {
+  long d = tic - clock->tic0;
+  return clock->ns0 + (long)( clock->rate*(double)d + clock->slew*(double)fd_long_min( d, clock->refresh ) );
+}
+
+/* fd_tempo_clock_{ns_per_tick,tick_per_ns} return the model's current
+   estimate of the rate the tickcount ticks relative to the wallclock.
+   These are useful for converting tick intervals to ns intervals (and
+   vice versa) when an exact wallclock is not needed.  fd_tempo_clock_
+   reset_cnt returns the number of times the model has been restarted
+   due to a wallclock discontinuity. */
+
+FD_FN_PURE static inline double fd_tempo_clock_ns_per_tick( fd_tempo_clock_t const * clock ) { return clock->rate;      }
+FD_FN_PURE static inline double fd_tempo_clock_tick_per_ns( fd_tempo_clock_t const * clock ) { return 1./clock->rate;  }
+FD_FN_PURE static inline ulong  fd_tempo_clock_reset_cnt  ( fd_tempo_clock_t const * clock ) { return clock->reset_cnt; }
+
+/* fd_tempo_clock_observe updates the model with a joint observation
+   that the wallclock was now at tickcount tic (e.g. from
+   fd_tempo_observe_pair).  Observations should be made with tic
+   increasing.  Returns the error in ns of the model at tic before the
+   update (positive if the model was behind the wallclock). */
+
+long
+fd_tempo_clock_observe( fd_tempo_clock_t * clock,
+                        long               now,
+                        long               tic );
+
+/* fd_tempo_clock_refresh is meant to be called during housekeeping
+   with a recent tickcount tic.  If at least a refresh interval has
+   elapsed since the most recent observation, this does a
+   fd_tempo_observe_pair and updates the model with it and returns 1.
+   Otherwise, this is a single compare and returns 0. */
+
+int
+fd_tempo_clock_private_refresh( fd_tempo_clock_t * clock );
+
+static inline int
+fd_tempo_clock_refresh( fd_tempo_clock_t * clock,
+                        long               tic ) {
+  if( FD_LIKELY( (tic - clock->obs_tic) < clock->refresh ) ) return 0;
+  return fd_tempo_clock_private_refresh( clock );
+}
+
+#endif
+
 /* fd_tempo_lazy_default returns a target interval between housekeeping
    events in ns (laziness) for a producer / consumer that has a maximum
    credits of cr_max / lag behind the producer of lag_max.
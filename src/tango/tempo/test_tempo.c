@@ -101,6 +101,86 @@ main( int     argc,
 //FD_TEST( !fd_tempo_async_min( 100L, 10000UL, 1.f ) );
   FD_TEST( fd_ulong_is_pow2( fd_tempo_async_min( 100000L, 1UL, 1.f ) ) );
 
+  /* Test the clock model */
+
+  FD_TEST( fd_tempo_clock_align    ()==FD_TEMPO_CLOCK_ALIGN     );
+  FD_TEST( fd_tempo_clock_footprint()==FD_TEMPO_CLOCK_FOOTPRINT );
+
+  fd_tempo_clock_t _clock[1];
+
+  FD_TEST( !fd_tempo_clock_new( NULL,                          3., 1000000L ) ); /* NULL mem */
+  FD_TEST( !fd_tempo_clock_new( (void *)(1UL+(ulong)_clock),   3., 1000000L ) ); /* misaligned mem */
+  FD_TEST( !fd_tempo_clock_new( _clock,                  1e-12, 1L       ) ); /* sub-tick refresh */
+  FD_TEST( !fd_tempo_clock_join  ( NULL ) );
+  FD_TEST( !fd_tempo_clock_leave ( NULL ) );
+  FD_TEST( !fd_tempo_clock_delete( NULL ) );
+
+  fd_tempo_clock_t * clock = fd_tempo_clock_join( fd_tempo_clock_new( _clock, 3., 1000000L ) ); FD_TEST( clock );
+  FD_TEST( fd_tempo_clock_tick_per_ns( clock )==3. );
+  FD_TEST( !fd_tempo_clock_reset_cnt ( clock )     );
+
+  /* Simulate a host whose tickcount runs 100 ppm fast relative to the
+     model's initial rate and then random walks.  Starting the
+     simulation far from the real clocks also tests restarts. */
+
+  double true_ns_per_tick = (1./3.)*(1.-100e-6);
+  long   tic              = 1L<<40;
+  double ns               = (double)(1L<<50);
+
+  fd_tempo_clock_observe( clock, (long)ns, tic );
+  FD_TEST( fd_tempo_clock_reset_cnt( clock )==1UL      );
+  FD_TEST( fd_tempo_clock_ns( clock, tic )==(long)ns );
+
+  ulong err_max = 0UL;
+  for( ulong iter=0UL; iter<20000UL; iter++ ) {
+    long dtic = 3000000L + (long)fd_rng_ulong_roll( rng, 1000000UL );
+
+    for( ulong rem=16UL; rem; rem-- ) { /* Model is non-decreasing */
+      long t0 = tic - dtic + (long)fd_rng_ulong_roll( rng, 3UL*(ulong)dtic );
+      long t1 = t0 + (long)fd_rng_ulong_roll( rng, (ulong)dtic );
+      FD_TEST( fd_tempo_clock_ns( clock, t0 )<=fd_tempo_clock_ns( clock, t1 ) );
+    }
+
+    tic              += dtic;
+    ns               += true_ns_per_tick*(double)dtic;
+    true_ns_per_tick *= 1. + 1e-8*(fd_rng_double_o( rng )-0.5);
+    long now = (long)ns + (long)fd_rng_ulong_roll( rng, 41UL ) - 20L; /* +/-20 ns observation jitter */
+
+    long pred = fd_tempo_clock_ns( clock, tic );
+    long err  = fd_tempo_clock_observe( clock, now, tic );
+    FD_TEST( err==now-pred );
+    FD_TEST( fd_tempo_clock_ns( clock, tic )==pred ); /* Model is continuous */
+    if( iter>=1000UL ) err_max = fd_ulong_max( err_max, fd_long_abs( err ) );
+  }
+  double rate_err = fd_tempo_clock_ns_per_tick( clock )/true_ns_per_tick - 1.;
+  FD_LOG_NOTICE(( "clock: err_max %lu ns, rate_err %.2e", err_max, rate_err ));
+  FD_TEST( err_max<1000UL );
+  FD_TEST( fd_double_abs( rate_err )<1e-5 ); /* Dominated by the observation jitter over short refresh intervals */
+  FD_TEST( fd_tempo_clock_reset_cnt( clock )==1UL );
+
+  /* A wallclock step restarts the model */
+
+  tic += 3000000L; ns += 1e9;
+  fd_tempo_clock_observe( clock, (long)ns, tic );
+  FD_TEST( fd_tempo_clock_reset_cnt( clock )==2UL      );
+  FD_TEST( fd_tempo_clock_ns( clock, tic )==(long)ns );
+
+  FD_TEST( fd_tempo_clock_delete( fd_tempo_clock_leave( clock ) )==_clock );
+
+  /* Track the real clocks */
+
+  clock = fd_tempo_clock_join( fd_tempo_clock_new( _clock, 0., 1000000L ) ); FD_TEST( clock );
+  FD_TEST( !fd_tempo_clock_refresh( clock, clock->obs_tic ) );
+  for( ulong iter=0UL; iter<8UL; iter++ ) {
+    fd_log_sleep( 2000000L );
+    FD_TEST( fd_tempo_clock_refresh( clock, fd_tickcount() ) );
+    long then; long tic_; fd_tempo_observe_pair( &then, &tic_ );
+    long err = then - fd_tempo_clock_ns( clock, tic_ );
+    FD_LOG_NOTICE(( "clock: real err %li ns", err ));
+    FD_TEST( fd_long_abs( err )<100000UL );
+  }
+  FD_TEST( fd_tempo_clock_delete( fd_tempo_clock_leave( clock ) )==_clock );
+
 # endif
 
   for( ulong iter=0UL; iter<1000000UL; iter++ ) {
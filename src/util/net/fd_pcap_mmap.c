@@ -0,0 +1,457 @@
+#define _GNU_SOURCE
+#include "fd_pcap_mmap.h"
+
+#if FD_HAS_HOSTED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define FD_PCAP_MMAP_NETWORK_ETHERNET  (1U)
+#define FD_PCAP_MMAP_NETWORK_LINUX_SLL (113U)
+
+#define FD_PCAP_MMAP_IF_TYPE_UNSUPPORTED ((uchar)0xff)
+
+/* Classic pcap file and record header sizes */
+
+#define FD_PCAP_MMAP_CLASSIC_HDR_SZ     (24UL)
+#define FD_PCAP_MMAP_CLASSIC_PKT_HDR_SZ (16UL)
+
+/* pcapng block types and sizes (a block is a 4 byte type, a 4 byte
+   total length, the body and a trailing copy of the total length) */
+
+#define FD_PCAP_MMAP_PCAPNG_SHB       (0x0a0d0d0aU)
+#define FD_PCAP_MMAP_PCAPNG_IDB       (0x00000001U)
+#define FD_PCAP_MMAP_PCAPNG_SPB       (0x00000003U)
+#define FD_PCAP_MMAP_PCAPNG_EPB       (0x00000006U)
+#define FD_PCAP_MMAP_PCAPNG_BOM       (0x1a2b3c4dU)
+#define FD_PCAP_MMAP_PCAPNG_BLK_MIN   (12UL)
+#define FD_PCAP_MMAP_PCAPNG_SHB_MIN   (28UL)
+#define FD_PCAP_MMAP_PCAPNG_IDB_MIN   (20UL)
+#define FD_PCAP_MMAP_PCAPNG_EPB_MIN   (32UL)
+#define FD_PCAP_MMAP_PCAPNG_OPT_TSRES (9U)
+
+#define FD_PCAP_MMAP_SLL_HDR_SZ (16UL)
+
+static inline uint
+fd_pcap_mmap_ld32( fd_pcap_mmap_iter_t const * iter,
+                   ulong                       off ) {
+  uint x; memcpy( &x, iter->map + off, sizeof(uint) );
+  return iter->swap ? fd_uint_bswap( x ) : x;
+}
+
+static inline ushort
+fd_pcap_mmap_ld16( fd_pcap_mmap_iter_t const * iter,
+                   ulong                       off ) {
+  ushort x; memcpy( &x, iter->map + off, sizeof(ushort) );
+  return iter->swap ? fd_ushort_bswap( x ) : x;
+}
+
+static uchar
+fd_pcap_mmap_if_type( uint network ) {
+  network &= 0xffffU; /* Upper bits can be used to describe FCS presence */
+  if( network==FD_PCAP_MMAP_NETWORK_ETHERNET  ) return (uchar)FD_PCAP_ITER_TYPE_ETHERNET;
+  if( network==FD_PCAP_MMAP_NETWORK_LINUX_SLL ) return (uchar)FD_PCAP_ITER_TYPE_COOKED;
+  return FD_PCAP_MMAP_IF_TYPE_UNSUPPORTED;
+}
+
+/* fd_pcap_mmap_tsresol_is_valid returns 1 if tsresol (encoded as the
+   pcapng if_tsresol option) can be converted to ns without overflowing
+   the intermediates of fd_pcap_mmap_ts_ns for any 64-bit timestamp. */
+
+static inline int
+fd_pcap_mmap_tsresol_is_valid( uint tsresol ) {
+  return (tsresol & 0x80U) ? ((tsresol & 0x7fU)<=34U) : (tsresol<=19U);
+}
+
+static inline long
+fd_pcap_mmap_ts_ns( ulong ts,
+                    uint  tsresol ) {
+  static ulong const pow10[20] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL,
+    10000000000UL, 100000000000UL, 1000000000000UL, 10000000000000UL, 100000000000000UL, 1000000000000000UL,
+    10000000000000000UL, 100000000000000000UL, 1000000000000000000UL, 10000000000000000000UL
+  };
+  if( FD_LIKELY( !(tsresol & 0x80U) ) ) { /* ts units are 10^-tsresol s */
+    if( FD_LIKELY( tsresol<=9U ) ) return (long)(ts*pow10[ 9U-tsresol ]);
+    return (long)(ts/pow10[ tsresol-9U ]);
+  }
+  uint  n    = tsresol & 0x7fU;  /* ts units are 2^-n s */
+  ulong mask = (1UL<<n) - 1UL;
+  return (long)( (ts>>n)*1000000000UL + (((ts & mask)*1000000000UL)>>n) );
+}
+
+/* fd_pcap_mmap_prefetch asks the kernel to start reading the next
+   window of the capture before the iterator gets to it. */
+
+static void
+fd_pcap_mmap_prefetch( fd_pcap_mmap_iter_t * iter ) {
+  ulong off = iter->prefetch_off;
+  ulong sz  = fd_ulong_min( FD_PCAP_MMAP_PREFETCH_SZ/2UL, iter->map_sz - off );
+  if( FD_UNLIKELY( madvise( (void *)(iter->map + off), sz, MADV_WILLNEED ) ) )
+    FD_LOG_WARNING(( "madvise(MADV_WILLNEED) failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+  iter->prefetch_off = off + sz;
+}
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_new_mem( fd_pcap_mmap_iter_t * iter,
+                           void const *          mem,
+                           ulong                 sz ) {
+
+  if( FD_UNLIKELY( !iter ) ) { FD_LOG_WARNING(( "NULL iter" )); return NULL; }
+  if( FD_UNLIKELY( !mem  ) ) { FD_LOG_WARNING(( "NULL mem"  )); return NULL; }
+
+  if( FD_UNLIKELY( sz<sizeof(uint) ) ) { FD_LOG_WARNING(( "capture too small" )); return NULL; }
+
+  memset( iter, 0, sizeof(fd_pcap_mmap_iter_t) );
+  iter->map          = (uchar const *)mem;
+  iter->map_sz       = sz;
+  iter->prefetch_off = sz; /* Nothing to prefetch unless mapped by fd_pcap_mmap_iter_new */
+
+  uint magic; memcpy( &magic, mem, sizeof(uint) );
+
+  if( magic==FD_PCAP_MMAP_PCAPNG_SHB ) {
+
+    /* pcapng (the first block must be a section header block).  The
+       section header is processed by the iterator like any other block
+       such that multi-section captures are handled uniformly. */
+
+    if( FD_UNLIKELY( sz<FD_PCAP_MMAP_PCAPNG_SHB_MIN ) ) { FD_LOG_WARNING(( "truncated pcapng section header" )); return NULL; }
+    uint bom; memcpy( &bom, iter->map + 8UL, sizeof(uint) );
+    if( FD_UNLIKELY( !((bom==FD_PCAP_MMAP_PCAPNG_BOM) | (bom==fd_uint_bswap( FD_PCAP_MMAP_PCAPNG_BOM ))) ) ) {
+      FD_LOG_WARNING(( "not a supported pcapng file (bad byte order magic)" ));
+      return NULL;
+    }
+
+    iter->pcapng = 1;
+    iter->off    = 0UL;
+    iter->if_cnt = 0UL;
+    return iter;
+  }
+
+  /* Classic pcap */
+
+  int   swap;
+  uchar tsresol;
+  switch( magic ) {
+  case 0xa1b2c3d4U: swap = 0; tsresol = (uchar)6; break;
+  case 0xa1b23c4dU: swap = 0; tsresol = (uchar)9; break;
+  case 0xd4c3b2a1U: swap = 1; tsresol = (uchar)6; break;
+  case 0x4d3cb2a1U: swap = 1; tsresol = (uchar)9; break;
+  default:
+    FD_LOG_WARNING(( "not a supported pcap file (bad magic number)" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( sz<FD_PCAP_MMAP_CLASSIC_HDR_SZ ) ) { FD_LOG_WARNING(( "truncated pcap header" )); return NULL; }
+
+  iter->swap = swap;
+
+  uchar type = fd_pcap_mmap_if_type( fd_pcap_mmap_ld32( iter, 20UL ) );
+  if( FD_UNLIKELY( type==FD_PCAP_MMAP_IF_TYPE_UNSUPPORTED ) ) {
+    FD_LOG_WARNING(( "unsupported network type (neither an Ethernet nor a cooked socket pcap)" ));
+    return NULL;
+  }
+
+  iter->pcapng          = 0;
+  iter->off             = FD_PCAP_MMAP_CLASSIC_HDR_SZ;
+  iter->if_cnt          = 1UL;
+  iter->if_type   [ 0 ] = type;
+  iter->if_tsresol[ 0 ] = tsresol;
+  return iter;
+}
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_new( fd_pcap_mmap_iter_t * iter,
+                       char const *          path,
+                       int                   flags ) {
+
+  if( FD_UNLIKELY( !iter ) ) { FD_LOG_WARNING(( "NULL iter" )); return NULL; }
+  if( FD_UNLIKELY( !path ) ) { FD_LOG_WARNING(( "NULL path" )); return NULL; }
+
+  int fd = open( path, O_RDONLY );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\",O_RDONLY) failed (%i-%s)", path, errno, strerror( errno ) ));
+    return NULL;
+  }
+
+  struct stat st[1];
+  if( FD_UNLIKELY( fstat( fd, st ) ) ) {
+    FD_LOG_WARNING(( "fstat(\"%s\") failed (%i-%s)", path, errno, strerror( errno ) ));
+    close( fd );
+    return NULL;
+  }
+
+  ulong sz = (ulong)st->st_size;
+  if( FD_UNLIKELY( !sz ) ) {
+    FD_LOG_WARNING(( "\"%s\" is empty", path ));
+    close( fd );
+    return NULL;
+  }
+
+  int mmap_flags = MAP_PRIVATE;
+  if( flags & FD_PCAP_MMAP_FLAG_POPULATE ) mmap_flags |= MAP_POPULATE;
+
+  void * map = mmap( NULL, sz, PROT_READ, mmap_flags, fd, (off_t)0 );
+  int mmap_errno = errno;
+  if( FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, strerror( errno ) ));
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(\"%s\",%lu KiB) failed (%i-%s)", path, sz>>10, mmap_errno, strerror( mmap_errno ) ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( madvise( map, sz, MADV_SEQUENTIAL ) ) )
+    FD_LOG_WARNING(( "madvise(MADV_SEQUENTIAL) failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+
+# ifdef MADV_HUGEPAGE
+  if( flags & FD_PCAP_MMAP_FLAG_HUGE ) (void)madvise( map, sz, MADV_HUGEPAGE ); /* Best effort */
+# endif
+
+  if( FD_UNLIKELY( !fd_pcap_mmap_iter_new_mem( iter, map, sz ) ) ) {
+    if( FD_UNLIKELY( munmap( map, sz ) ) )
+      FD_LOG_WARNING(( "munmap failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+    return NULL;
+  }
+
+  /* If the capture was populated, there is nothing to prefetch */
+
+  iter->mapped    = 1;
+  iter->readahead = !(flags & FD_PCAP_MMAP_FLAG_POPULATE);
+
+  iter->prefetch_off = iter->readahead ? 0UL : sz;
+  if( iter->readahead ) fd_pcap_mmap_prefetch( iter );
+
+  return iter;
+}
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_rewind( fd_pcap_mmap_iter_t * iter ) {
+
+  /* For pcapng, the section header block at offset 0 will reset the
+     byte order and interfaces when it is processed again */
+
+  iter->off          = iter->pcapng ? 0UL : FD_PCAP_MMAP_CLASSIC_HDR_SZ;
+  iter->prefetch_off = iter->readahead ? 0UL : iter->map_sz;
+  if( iter->readahead ) fd_pcap_mmap_prefetch( iter );
+
+  return iter;
+}
+
+void *
+fd_pcap_mmap_iter_delete( fd_pcap_mmap_iter_t * iter ) {
+  if( FD_UNLIKELY( !iter ) ) { FD_LOG_WARNING(( "NULL iter" )); return NULL; }
+  if( iter->mapped && FD_UNLIKELY( munmap( (void *)iter->map, iter->map_sz ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+  memset( iter, 0, sizeof(fd_pcap_mmap_iter_t) );
+  return (void *)iter;
+}
+
+/* fd_pcap_mmap_pkt finishes extracting a packet of sz bytes at off with
+   link type type.  Returns the pointer fd_pcap_mmap_iter_next should
+   return (NULL if the packet is too small for its link type). */
+
+static uchar const *
+fd_pcap_mmap_pkt( fd_pcap_mmap_iter_t *  iter,
+                  ulong                  off,
+                  ulong                  sz,
+                  uchar                  type,
+                  ulong *                _pkt_sz,
+                  fd_eth_hdr_t const **  _pkt_hdr ) {
+
+  if( FD_LIKELY( type==(uchar)FD_PCAP_ITER_TYPE_ETHERNET ) ) {
+    if( FD_UNLIKELY( sz<sizeof(fd_eth_hdr_t) ) ) { FD_LOG_WARNING(( "Corrupt packet size in pcap file %lu", sz )); return NULL; }
+    *_pkt_sz  = sz;
+    *_pkt_hdr = NULL;
+    return iter->map + off;
+  }
+
+  if( FD_UNLIKELY( sz<FD_PCAP_MMAP_SLL_HDR_SZ ) ) { FD_LOG_WARNING(( "Corrupt incl_len in cooked pcap file %lu", sz )); return NULL; }
+
+  /* Construct an ethernet compatible header that encodes the sll header
+     info in the same way as fd_pcap_iter_next.  The sll header is dir,
+     ha_type and ha_len (2 bytes each), ha (8 bytes) and net_type (2
+     bytes), all in net order. */
+
+  uchar const  * sll = iter->map + off;
+  fd_eth_hdr_t * hdr = iter->hdr;
+  memcpy( hdr->dst,       sll,       6UL );
+  memcpy( hdr->src,       sll+ 6UL,  6UL );
+  memcpy( &hdr->net_type, sll+14UL,  2UL );
+  hdr->dst[0] = (uchar)(((ulong)hdr->dst[0] & ~3UL) | 2UL); /* Mark as a local admin unicast MAC */
+  hdr->src[0] = (uchar)(((ulong)hdr->src[0] & ~3UL) | 2UL); /* " */
+
+  ulong skip = FD_PCAP_MMAP_SLL_HDR_SZ - sizeof(fd_eth_hdr_t);
+  *_pkt_sz  = sz - skip;
+  *_pkt_hdr = hdr;
+  return sll + skip;
+}
+
+uchar const *
+fd_pcap_mmap_iter_next( fd_pcap_mmap_iter_t *  iter,
+                        ulong *                _pkt_sz,
+                        long *                 _pkt_ts,
+                        fd_eth_hdr_t const **  _pkt_hdr ) {
+
+  ulong off    = iter->off;
+  ulong map_sz = iter->map_sz;
+
+  uchar const * pkt;
+  ulong         next;
+
+  if( FD_LIKELY( !iter->pcapng ) ) {
+
+    ulong rem = map_sz - off;
+    if( FD_UNLIKELY( !rem ) ) return NULL; /* Normal end of capture */
+    if( FD_UNLIKELY( rem<FD_PCAP_MMAP_CLASSIC_PKT_HDR_SZ ) ) { FD_LOG_WARNING(( "truncated packet header (truncated pcap file?)" )); return NULL; }
+
+    ulong sec      = (ulong)fd_pcap_mmap_ld32( iter, off       );
+    ulong subsec   = (ulong)fd_pcap_mmap_ld32( iter, off + 4UL );
+    ulong incl_len = (ulong)fd_pcap_mmap_ld32( iter, off + 8UL );
+    ulong orig_len = (ulong)fd_pcap_mmap_ld32( iter, off +12UL );
+
+    if( FD_UNLIKELY( incl_len>(rem-FD_PCAP_MMAP_CLASSIC_PKT_HDR_SZ) ) ) {
+      FD_LOG_WARNING(( "packet payload extends past end of capture (truncated pcap file?)" ));
+      return NULL;
+    }
+
+    if( FD_UNLIKELY( incl_len!=orig_len ) ) {
+      FD_LOG_WARNING(( "Read a truncated packet (%lu bytes to %lu bytes), run tcpdump with '-s0' option to capture everything",
+                       incl_len, orig_len ));
+      return NULL;
+    }
+
+    ulong pkt_off = off + FD_PCAP_MMAP_CLASSIC_PKT_HDR_SZ;
+    pkt = fd_pcap_mmap_pkt( iter, pkt_off, incl_len, iter->if_type[0], _pkt_sz, _pkt_hdr );
+    if( FD_UNLIKELY( !pkt ) ) return NULL;
+
+    *_pkt_ts = (long)(sec*1000000000UL) + fd_pcap_mmap_ts_ns( subsec, (uint)iter->if_tsresol[0] );
+    next     = pkt_off + incl_len;
+
+  } else {
+
+    for(;;) {
+      ulong rem = map_sz - off;
+      if( FD_UNLIKELY( !rem ) ) return NULL; /* Normal end of capture */
+      if( FD_UNLIKELY( rem<FD_PCAP_MMAP_PCAPNG_BLK_MIN ) ) { FD_LOG_WARNING(( "truncated block (truncated pcapng file?)" )); return NULL; }
+
+      uint type; memcpy( &type, iter->map + off, sizeof(uint) ); /* SHB type is byte order independent */
+
+      if( FD_UNLIKELY( type==FD_PCAP_MMAP_PCAPNG_SHB ) ) {
+        if( FD_UNLIKELY( rem<FD_PCAP_MMAP_PCAPNG_SHB_MIN ) ) { FD_LOG_WARNING(( "truncated section header (truncated pcapng file?)" )); return NULL; }
+        uint bom; memcpy( &bom, iter->map + off + 8UL, sizeof(uint) );
+        if(      bom==FD_PCAP_MMAP_PCAPNG_BOM                  ) iter->swap = 0;
+        else if( bom==fd_uint_bswap( FD_PCAP_MMAP_PCAPNG_BOM ) ) iter->swap = 1;
+        else { FD_LOG_WARNING(( "corrupt section header (bad byte order magic)" )); return NULL; }
+      } else {
+        type = iter->swap ? fd_uint_bswap( type ) : type;
+      }
+
+      ulong blk_sz = (ulong)fd_pcap_mmap_ld32( iter, off + 4UL );
+      if( FD_UNLIKELY( (blk_sz<FD_PCAP_MMAP_PCAPNG_BLK_MIN) | (blk_sz>rem) | (!fd_ulong_is_aligned( blk_sz, 4UL )) ) ) {
+        FD_LOG_WARNING(( "corrupt block length %lu (truncated pcapng file?)", blk_sz ));
+        return NULL;
+      }
+
+      if( FD_LIKELY( type==FD_PCAP_MMAP_PCAPNG_EPB ) ) {
+
+        if( FD_UNLIKELY( blk_sz<FD_PCAP_MMAP_PCAPNG_EPB_MIN ) ) { FD_LOG_WARNING(( "corrupt enhanced packet block" )); return NULL; }
+
+        ulong if_idx   = (ulong)fd_pcap_mmap_ld32( iter, off +  8UL );
+        ulong ts_hi    = (ulong)fd_pcap_mmap_ld32( iter, off + 12UL );
+        ulong ts_lo    = (ulong)fd_pcap_mmap_ld32( iter, off + 16UL );
+        ulong cap_len  = (ulong)fd_pcap_mmap_ld32( iter, off + 20UL );
+        ulong orig_len = (ulong)fd_pcap_mmap_ld32( iter, off + 24UL );
+
+        if( FD_UNLIKELY( if_idx>=iter->if_cnt ) ) { FD_LOG_WARNING(( "packet on undescribed interface %lu", if_idx )); return NULL; }
+
+        if( FD_UNLIKELY( cap_len>(blk_sz-FD_PCAP_MMAP_PCAPNG_EPB_MIN) ) ) {
+          FD_LOG_WARNING(( "packet payload extends past end of block (corrupt pcapng file?)" ));
+          return NULL;
+        }
+
+        if( FD_UNLIKELY( cap_len!=orig_len ) ) {
+          FD_LOG_WARNING(( "Read a truncated packet (%lu bytes to %lu bytes), run tcpdump with '-s0' option to capture everything",
+                           cap_len, orig_len ));
+          return NULL;
+        }
+
+        uchar if_type = iter->if_type[ if_idx ];
+        if( FD_UNLIKELY( if_type==FD_PCAP_MMAP_IF_TYPE_UNSUPPORTED ) ) {
+          FD_LOG_WARNING(( "packet on interface %lu with unsupported link type (neither Ethernet nor cooked socket)", if_idx ));
+          return NULL;
+        }
+
+        pkt = fd_pcap_mmap_pkt( iter, off + 28UL, cap_len, if_type, _pkt_sz, _pkt_hdr );
+        if( FD_UNLIKELY( !pkt ) ) return NULL;
+
+        *_pkt_ts = fd_pcap_mmap_ts_ns( (ts_hi<<32) | ts_lo, (uint)iter->if_tsresol[ if_idx ] );
+        next     = off + blk_sz;
+        break;
+
+      } else if( type==FD_PCAP_MMAP_PCAPNG_SHB ) {
+
+        iter->if_cnt = 0UL; /* A new section starts a new set of interfaces */
+
+      } else if( type==FD_PCAP_MMAP_PCAPNG_IDB ) {
+
+        if( FD_UNLIKELY( blk_sz<FD_PCAP_MMAP_PCAPNG_IDB_MIN ) ) { FD_LOG_WARNING(( "corrupt interface description block" )); return NULL; }
+
+        ulong if_idx = iter->if_cnt;
+        if( FD_UNLIKELY( if_idx>=FD_PCAP_MMAP_IF_MAX ) ) { FD_LOG_WARNING(( "too many interfaces in pcapng section" )); return NULL; }
+
+        uint tsresol = 6U; /* Default is us */
+        ulong opt     = off + 16UL;
+        ulong opt_end = off + blk_sz - 4UL;
+        while( (opt_end-opt)>=4UL ) {
+          ulong opt_code = (ulong)fd_pcap_mmap_ld16( iter, opt       );
+          ulong opt_len  = (ulong)fd_pcap_mmap_ld16( iter, opt + 2UL );
+          if( !opt_code ) break; /* opt_endofopt */
+          if( FD_UNLIKELY( opt_len>(opt_end-opt-4UL) ) ) { FD_LOG_WARNING(( "corrupt interface option" )); return NULL; }
+          if( (opt_code==FD_PCAP_MMAP_PCAPNG_OPT_TSRES) & (opt_len>=1UL) ) tsresol = (uint)iter->map[ opt + 4UL ];
+          opt += 4UL + fd_ulong_min( fd_ulong_align_up( opt_len, 4UL ), opt_end-opt-4UL );
+        }
+
+        if( FD_UNLIKELY( !fd_pcap_mmap_tsresol_is_valid( tsresol ) ) ) {
+          FD_LOG_WARNING(( "unsupported interface timestamp resolution 0x%02x", tsresol ));
+          return NULL;
+        }
+
+        iter->if_type   [ if_idx ] = fd_pcap_mmap_if_type( (uint)fd_pcap_mmap_ld16( iter, off + 8UL ) );
+        iter->if_tsresol[ if_idx ] = (uchar)tsresol;
+        iter->if_cnt = if_idx + 1UL;
+
+      } else if( FD_UNLIKELY( type==FD_PCAP_MMAP_PCAPNG_SPB ) ) {
+
+        /* Simple packet blocks have no timestamp, so they can't be
+           replayed meaningfully. */
+
+        FD_LOG_WARNING(( "simple packet blocks are not supported" ));
+        return NULL;
+
+      } /* else skip blocks that don't describe packets (name resolution, statistics, custom, ...) */
+
+      off       += blk_sz;
+      iter->off  = off; /* Failures on the next block leave the iterator at it */
+    }
+
+  }
+
+  iter->off = next;
+
+  /* Keep the kernel reading ahead of us (at most one madvise per half
+     prefetch window iterated) */
+
+  if( FD_UNLIKELY( ((next + FD_PCAP_MMAP_PREFETCH_SZ) > iter->prefetch_off) & (iter->prefetch_off<map_sz) ) )
+    fd_pcap_mmap_prefetch( iter );
+
+  return pkt;
+}
+
+#else
+
+/* Implement pcap mmap support for this target */
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef HEADER_fd_src_util_net_fd_pcap_mmap_h
+#define HEADER_fd_src_util_net_fd_pcap_mmap_h
+
+/* fd_pcap_mmap provides an iterator over the packets in a capture file
+   that is memory mapped instead of streamed through stdio.  Packets are
+   handed back as pointers straight into the mapping such that a caller
+   that needs the packet somewhere else (e.g. a dcache chunk) does
+   exactly one copy of it (and can pick how that copy is done, e.g. with
+   non-temporal stores).  Unlike fd_pcap_iter, this supports classic
+   pcap files in either byte order at microsecond or nanosecond
+   resolution and pcapng files (section header, interface description
+   and enhanced packet blocks with arbitrary interface timestamp
+   resolutions).  Ethernet and Linux cooked (SLL) link types are
+   supported for both. */
+
+#include "fd_pcap.h"
+
+#if FD_HAS_HOSTED
+
+/* FD_PCAP_MMAP_FLAG_* are flags that can be passed to
+   fd_pcap_mmap_iter_new to tune how the capture is mapped.
+
+     POPULATE pre-faults the whole capture into memory when the
+              iterator is created (MAP_POPULATE).  This makes iteration
+              immune to page faults at the cost of a potentially long
+              delay at creation and the capture needing to fit in
+              memory.
+
+     HUGE     requests that the mapping be backed by huge pages where
+              the kernel and the file system holding the capture allow
+              it (e.g. a capture on a hugetlbfs or THP enabled tmpfs
+              mount).  This is best effort and silently ignored when
+              not possible. */
+
+#define FD_PCAP_MMAP_FLAG_POPULATE (1)
+#define FD_PCAP_MMAP_FLAG_HUGE     (2)
+
+/* FD_PCAP_MMAP_IF_MAX is the maximum number of pcapng interfaces a
+   section of a capture can describe. */
+
+#define FD_PCAP_MMAP_IF_MAX (64UL)
+
+/* FD_PCAP_MMAP_PREFETCH_SZ is the size of the window ahead of the
+   iterator that the iterator will ask the kernel to read ahead.  The
+   window is advanced by half its size at a time such that there is at
+   most one madvise per FD_PCAP_MMAP_PREFETCH_SZ/2 bytes iterated. */
+
+#define FD_PCAP_MMAP_PREFETCH_SZ (64UL<<20)
+
+/* A fd_pcap_mmap_iter_t is a mapping of a capture and the position of
+   the next packet in it.  The internals are exposed here to facilitate
+   declaring one on the stack.  They should not be used directly. */
+
+struct fd_pcap_mmap_iter {
+  uchar const * map;          /* First byte of the capture */
+  ulong         map_sz;       /* Size of the capture in bytes */
+  int           mapped;       /* 1 if map was mmap'd by the iterator (unmapped on delete) */
+  int           readahead;    /* 1 if the iterator asks the kernel to read ahead of it */
+  int           pcapng;       /* 1 if a pcapng capture, 0 if a classic pcap capture */
+  int           swap;         /* 1 if the capture (or current pcapng section) byte order is not the host's */
+  ulong         off;          /* Offset of the next record to process */
+  ulong         prefetch_off; /* Offset of the end of the region the kernel was most recently asked to read ahead */
+  ulong         if_cnt;       /* Number of interfaces (1 for classic pcap) */
+  uchar         if_type  [ FD_PCAP_MMAP_IF_MAX ]; /* if_type[i] is the FD_PCAP_ITER_TYPE of interface i */
+  uchar         if_tsresol[ FD_PCAP_MMAP_IF_MAX ]; /* if_tsresol[i] is the timestamp resolution of interface i (pcapng if_tsresol encoding) */
+  fd_eth_hdr_t  hdr[1];       /* Phony Ethernet header of the most recent cooked packet */
+};
+
+typedef struct fd_pcap_mmap_iter fd_pcap_mmap_iter_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_pcap_mmap_iter_new maps the capture at path read-only and formats
+   iter as an iterator positioned at its first packet.  flags is a set
+   of FD_PCAP_MMAP_FLAG_*.  The mapping is advised for sequential
+   access.  Returns iter on success and NULL on failure (logs details).
+   The file descriptor used to create the mapping is closed before
+   return.
+
+   fd_pcap_mmap_iter_new_mem is the same but iterates over the sz byte
+   capture already in memory at mem (e.g. for fuzzing or for captures
+   in a workspace).  The caller promises mem will not be changed for
+   the lifetime of the iterator. */
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_new( fd_pcap_mmap_iter_t * iter,
+                       char const *          path,
+                       int                   flags );
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_new_mem( fd_pcap_mmap_iter_t * iter,
+                           void const *          mem,
+                           ulong                 sz );
+
+/* fd_pcap_mmap_iter_delete unmaps the capture (if mapped by
+   fd_pcap_mmap_iter_new) and returns the memory used by iter to the
+   caller.  Any pointers returned by fd_pcap_mmap_iter_next for this
+   iterator are invalid after this returns. */
+
+void *
+fd_pcap_mmap_iter_delete( fd_pcap_mmap_iter_t * iter );
+
+/* fd_pcap_mmap_iter_{map,map_sz} return the location and size of the
+   mapped capture.  fd_pcap_mmap_iter_is_pcapng returns 1 if the capture
+   is a pcapng capture and 0 otherwise. */
+
+FD_FN_PURE static inline void const * fd_pcap_mmap_iter_map      ( fd_pcap_mmap_iter_t const * iter ) { return iter->map;    }
+FD_FN_PURE static inline ulong        fd_pcap_mmap_iter_map_sz   ( fd_pcap_mmap_iter_t const * iter ) { return iter->map_sz; }
+FD_FN_PURE static inline int          fd_pcap_mmap_iter_is_pcapng( fd_pcap_mmap_iter_t const * iter ) { return iter->pcapng; }
+
+/* fd_pcap_mmap_iter_rewind positions iter back at the first packet of
+   the capture (e.g. to replay a capture multiple times).  Returns
+   iter. */
+
+fd_pcap_mmap_iter_t *
+fd_pcap_mmap_iter_rewind( fd_pcap_mmap_iter_t * iter );
+
+/* fd_pcap_mmap_iter_next returns a pointer to the next packet in the
+   capture and advances the iterator.  On success, *_pkt_sz will hold
+   the size of the packet (in the same sense as fd_pcap_iter_next, from
+   the first byte of an Ethernet header to the last byte captured for
+   the packet) and *_pkt_ts will hold the packet timestamp in ns
+   (converted from the resolution of the capture).
+
+   If the packet's link type is Ethernet, the returned pointer points
+   at the packet's Ethernet header in the mapping and *_pkt_hdr will be
+   NULL.  If the packet came from a cooked capture, the returned pointer
+   points sizeof(fd_eth_hdr_t) bytes before the cooked packet's network
+   payload in the mapping (i.e. at the tail of the cooked header) and
+   *_pkt_hdr will point to a phony Ethernet header constructed from the
+   cooked header (in the same way as fd_pcap_iter_next) that should be
+   used in place of the first sizeof(fd_eth_hdr_t) bytes.  The phony
+   header is valid until the next call on this iterator.
+
+   Returns NULL on failure.  Failure reasons include normal end of
+   capture, a corrupt capture, a truncated packet (captured with a snap
+   length smaller than the packet) and packets with an unsupported link
+   type.  Details of all failures except normal end of capture are
+   logged with a warning and the iterator is left at the failing
+   record (such that subsequent calls will fail the same way). */
+
+uchar const *
+fd_pcap_mmap_iter_next( fd_pcap_mmap_iter_t *  iter,
+                        ulong *                _pkt_sz,
+                        long *                 _pkt_ts,
+                        fd_eth_hdr_t const **  _pkt_hdr );
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_HOSTED */
+
+#endif /* HEADER_fd_src_util_net_fd_pcap_mmap_h */
@@ -0,0 +1,47 @@
+#if !FD_HAS_HOSTED
+#error "This target requires FD_HAS_HOSTED"
+#endif
+
+#include <stdlib.h>
+
+#include "../fd_util.h"
+#include "./fd_pcap_mmap.h"
+
+int
+LLVMFuzzerInitialize( int  *   argc,
+                      char *** argv ) {
+  /* Set up shell without signal handlers */
+  putenv( "FD_LOG_BACKTRACE=0" );
+  fd_boot( argc, argv );
+  atexit( fd_halt );
+
+  /* Disable parsing error logging */
+  fd_log_level_stderr_set(4);
+  return 0;
+}
+
+int
+LLVMFuzzerTestOneInput( uchar const * data,
+                        ulong         size ) {
+  /* The mmap iterator can iterate over memory directly, so no need to
+     round trip the input through a file. */
+  fd_pcap_mmap_iter_t _iter[1];
+  fd_pcap_mmap_iter_t * iter = fd_pcap_mmap_iter_new_mem( _iter, data, size );
+  if( FD_LIKELY( iter ) ) {
+    /* Loop over all packets, touching every byte of each */
+    ulong                pkt_sz;
+    long                 pkt_ts;
+    fd_eth_hdr_t const * pkt_hdr;
+    uchar const *        pkt;
+    ulong                sum = 0UL;
+    while( (pkt = fd_pcap_mmap_iter_next( iter, &pkt_sz, &pkt_ts, &pkt_hdr )) ) {
+      FD_TEST( pkt>=data && (pkt+pkt_sz)<=(data+size) );
+      for( ulong i=0UL; i<pkt_sz; i++ ) sum += (ulong)pkt[i];
+    }
+    FD_COMPILER_FORGET( sum );
+
+    /* Release pcap */
+    FD_TEST( fd_pcap_mmap_iter_delete( iter )==(void *)_iter );
+  }
+  return 0;
+}
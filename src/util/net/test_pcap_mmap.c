@@ -0,0 +1,303 @@
+#include "../fd_util.h"
+#include "fd_pcap_mmap.h"
+
+FD_STATIC_ASSERT( FD_PCAP_MMAP_FLAG_POPULATE==1,         unit_test );
+FD_STATIC_ASSERT( FD_PCAP_MMAP_FLAG_HUGE    ==2,         unit_test );
+FD_STATIC_ASSERT( FD_PCAP_MMAP_IF_MAX       ==64UL,      unit_test );
+FD_STATIC_ASSERT( FD_PCAP_MMAP_PREFETCH_SZ  ==(64UL<<20), unit_test );
+
+#if FD_HAS_HOSTED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Capture builder ****************************************************/
+
+static uchar cap[ 1UL<<20 ];
+static ulong cap_sz;
+static int   cap_swap;
+
+static void ap8 ( uint   x ) { cap[ cap_sz++ ] = (uchar)x; }
+static void ap16( ushort x ) { if( cap_swap ) x = fd_ushort_bswap( x ); memcpy( cap+cap_sz, &x, 2UL ); cap_sz += 2UL; }
+static void ap32( uint   x ) { if( cap_swap ) x = fd_uint_bswap  ( x ); memcpy( cap+cap_sz, &x, 4UL ); cap_sz += 4UL; }
+static void apb ( void const * b, ulong sz ) { memcpy( cap+cap_sz, b, sz ); cap_sz += sz; }
+static void pad4( void ) { while( cap_sz & 3UL ) ap8( 0U ); }
+
+static void
+classic_hdr( uint magic,
+             uint network ) {
+  ap32( magic ); ap16( (ushort)2 ); ap16( (ushort)4 ); ap32( 0U ); ap32( 0U ); ap32( 65535U ); ap32( network );
+}
+
+static void
+classic_pkt( uint         sec,
+             uint         subsec,
+             void const * pkt,
+             ulong        sz ) {
+  ap32( sec ); ap32( subsec ); ap32( (uint)sz ); ap32( (uint)sz ); apb( pkt, sz );
+}
+
+static void
+ng_shb( void ) {
+  ap32( 0x0a0d0d0aU ); ap32( 28U ); ap32( 0x1a2b3c4dU ); ap16( (ushort)1 ); ap16( (ushort)0 );
+  ap32( 0xffffffffU ); ap32( 0xffffffffU ); ap32( 28U );
+}
+
+static void
+ng_idb( ushort link,
+        int    tsresol ) { /* tsresol<0 means use the default */
+  uint sz = tsresol<0 ? 20U : 32U;
+  ap32( 1U ); ap32( sz ); ap16( link ); ap16( (ushort)0 ); ap32( 0U );
+  if( tsresol>=0 ) { ap16( (ushort)9 ); ap16( (ushort)1 ); ap8( (uint)tsresol ); pad4(); ap16( (ushort)0 ); ap16( (ushort)0 ); }
+  ap32( sz );
+}
+
+static void
+ng_epb( uint         if_idx,
+        ulong        ts,
+        void const * pkt,
+        ulong        sz ) {
+  uint blk_sz = (uint)(32UL + fd_ulong_align_up( sz, 4UL ));
+  ap32( 6U ); ap32( blk_sz ); ap32( if_idx ); ap32( (uint)(ts>>32) ); ap32( (uint)ts ); ap32( (uint)sz ); ap32( (uint)sz );
+  apb( pkt, sz ); pad4(); ap32( blk_sz );
+}
+
+static void
+ng_nrb( void ) { /* Name resolution block with just an end of records */
+  ap32( 4U ); ap32( 16U ); ap16( (ushort)0 ); ap16( (ushort)0 ); ap32( 16U );
+}
+
+/* Test packets *******************************************************/
+
+#define PKT_CNT (32UL)
+
+static uchar pkt_mem[ PKT_CNT ][ 1600 ];
+static ulong pkt_sz [ PKT_CNT ];
+
+static void
+pkt_init( fd_rng_t * rng ) {
+  for( ulong i=0UL; i<PKT_CNT; i++ ) {
+    pkt_sz[i] = 60UL + fd_rng_ulong_roll( rng, 1460UL );
+    for( ulong j=0UL; j<pkt_sz[i]; j++ ) pkt_mem[i][j] = fd_rng_uchar( rng );
+  }
+}
+
+/* check_pkt checks the next packet of iter is the Ethernet frame
+   pkt_mem[i] (as it would be replayed) with timestamp ts */
+
+static void
+check_pkt( fd_pcap_mmap_iter_t * iter,
+           ulong                 i,
+           long                  ts ) {
+  ulong                pkt_sz_; long pkt_ts;
+  fd_eth_hdr_t const * hdr;
+  uchar const *        pkt = fd_pcap_mmap_iter_next( iter, &pkt_sz_, &pkt_ts, &hdr );
+  FD_TEST( pkt );
+  FD_TEST( !hdr );
+  FD_TEST( pkt_sz_==pkt_sz[i] );
+  FD_TEST( pkt_ts==ts );
+  FD_TEST( (ulong)(pkt-(uchar const *)fd_pcap_mmap_iter_map( iter ))<fd_pcap_mmap_iter_map_sz( iter ) ); /* Zero copy */
+  FD_TEST( !memcmp( pkt, pkt_mem[i], pkt_sz_ ) );
+}
+
+/* check_cooked checks the next packet of iter is the cooked packet
+   pkt_mem[i] (the first 16 bytes are the sll header) */
+
+static void
+check_cooked( fd_pcap_mmap_iter_t * iter,
+              ulong                 i,
+              long                  ts ) {
+  ulong                pkt_sz_; long pkt_ts;
+  fd_eth_hdr_t const * hdr;
+  uchar const *        pkt = fd_pcap_mmap_iter_next( iter, &pkt_sz_, &pkt_ts, &hdr );
+  FD_TEST( pkt );
+  FD_TEST( hdr );
+  FD_TEST( pkt_sz_==pkt_sz[i]-2UL );
+  FD_TEST( pkt_ts==ts );
+  uchar const * sll = pkt_mem[i];
+  FD_TEST( hdr->dst[0]==(uchar)((sll[0] & ~3U) | 2U) ); FD_TEST( !memcmp( hdr->dst+1, sll+ 1, 5UL ) );
+  FD_TEST( hdr->src[0]==(uchar)((sll[6] & ~3U) | 2U) ); FD_TEST( !memcmp( hdr->src+1, sll+ 7, 5UL ) );
+  FD_TEST( !memcmp( &hdr->net_type, sll+14, 2UL ) );
+  FD_TEST( !memcmp( pkt+sizeof(fd_eth_hdr_t), sll+16, pkt_sz_-sizeof(fd_eth_hdr_t) ) );
+}
+
+static void
+check_done( fd_pcap_mmap_iter_t * iter ) {
+  ulong sz; long ts; fd_eth_hdr_t const * hdr;
+  FD_TEST( !fd_pcap_mmap_iter_next( iter, &sz, &ts, &hdr ) );
+  FD_TEST( !fd_pcap_mmap_iter_next( iter, &sz, &ts, &hdr ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  pkt_init( rng );
+
+  fd_pcap_mmap_iter_t _iter[1];
+  fd_pcap_mmap_iter_t * iter;
+
+  /* Classic pcap at us and ns resolution in both byte orders */
+
+  for( int swap=0; swap<2; swap++ ) {
+    for( int ns=0; ns<2; ns++ ) {
+      cap_sz = 0UL; cap_swap = swap;
+      classic_hdr( ns ? 0xa1b23c4dU : 0xa1b2c3d4U, 1U );
+      for( ulong i=0UL; i<PKT_CNT; i++ ) classic_pkt( 1000U+(uint)i, 999U*(uint)i, pkt_mem[i], pkt_sz[i] );
+
+      iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter==_iter );
+      FD_TEST( !fd_pcap_mmap_iter_is_pcapng( iter ) );
+      for( ulong i=0UL; i<PKT_CNT; i++ )
+        check_pkt( iter, i, 1000000000L*(1000L+(long)i) + (ns ? 1L : 1000L)*999L*(long)i );
+      check_done( iter );
+      FD_TEST( fd_pcap_mmap_iter_delete( iter )==(void *)_iter );
+    }
+  }
+
+  /* Classic cooked pcap */
+
+  cap_sz = 0UL; cap_swap = 0;
+  classic_hdr( 0xa1b23c4dU, 113U );
+  for( ulong i=0UL; i<PKT_CNT; i++ ) classic_pkt( 7U, (uint)i, pkt_mem[i], pkt_sz[i] );
+  iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter );
+  for( ulong i=0UL; i<PKT_CNT; i++ ) check_cooked( iter, i, 7000000000L + (long)i );
+  check_done( iter );
+  fd_pcap_mmap_iter_delete( iter );
+
+  /* Corrupt and unsupported classic pcaps */
+
+  cap_sz = 0UL; classic_hdr( 0xdeadbeefU, 1U );   FD_TEST( !fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz     ) );
+  cap_sz = 0UL; classic_hdr( 0xa1b2c3d4U, 105U ); FD_TEST( !fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz     ) );
+  cap_sz = 0UL; classic_hdr( 0xa1b2c3d4U, 1U );   FD_TEST( !fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz-1UL ) );
+  FD_TEST( !fd_pcap_mmap_iter_new_mem( NULL,  cap,  cap_sz ) );
+  FD_TEST( !fd_pcap_mmap_iter_new_mem( _iter, NULL, cap_sz ) );
+
+  classic_pkt( 1U, 0U, pkt_mem[0], pkt_sz[0] );
+  for( ulong trunc=1UL; trunc<=pkt_sz[0]+16UL; trunc++ ) { /* Truncated capture fails without reading past end */
+    iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz-trunc ); FD_TEST( iter );
+    check_done( iter );
+    FD_TEST( iter->off==24UL );
+    fd_pcap_mmap_iter_delete( iter );
+  }
+
+  cap_sz = 0UL; classic_hdr( 0xa1b2c3d4U, 1U ); /* Truncated packet */
+  ap32( 1U ); ap32( 0U ); ap32( 64U ); ap32( 1500U ); apb( pkt_mem[0], 64UL );
+  iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter ); check_done( iter ); fd_pcap_mmap_iter_delete( iter );
+
+  cap_sz = 0UL; classic_hdr( 0xa1b2c3d4U, 1U ); /* Runt */
+  classic_pkt( 1U, 0U, pkt_mem[0], 13UL );
+  iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter ); check_done( iter ); fd_pcap_mmap_iter_delete( iter );
+
+  /* pcapng with multiple interfaces and sections, mixed byte orders,
+     timestamp resolutions and link types.  Section 0 (host order) has
+     interface 0 Ethernet at the default us resolution, interface 1
+     cooked at ns resolution and interface 2 with an unsupported link
+     type.  Section 1 (swapped) has interface 0 Ethernet at 2^-20 s
+     resolution. */
+
+  cap_sz = 0UL; cap_swap = 0;
+  ng_shb();
+  ng_idb( (ushort)1,   -1 );
+  ng_idb( (ushort)113,  9 );
+  ng_idb( (ushort)105,  6 );
+  ng_nrb();
+  for( ulong i=0UL; i<PKT_CNT/2UL; i++ ) ng_epb( (uint)(i & 1UL), 123456789UL + i, pkt_mem[i], pkt_sz[i] );
+  ulong sec1 = cap_sz;
+  cap_swap = 1;
+  ng_shb();
+  ng_idb( (ushort)1, 0x94 );
+  for( ulong i=PKT_CNT/2UL; i<PKT_CNT; i++ ) ng_epb( 0U, (5UL<<20) + (i<<10), pkt_mem[i], pkt_sz[i] );
+
+  iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter );
+  FD_TEST( fd_pcap_mmap_iter_is_pcapng( iter ) );
+  for( ulong i=0UL; i<PKT_CNT/2UL; i++ ) {
+    if( i & 1UL ) check_cooked( iter, i, 123456789L + (long)i );
+    else          check_pkt   ( iter, i, 1000L*(123456789L + (long)i) );
+  }
+  for( ulong i=PKT_CNT/2UL; i<PKT_CNT; i++ ) check_pkt( iter, i, 5000000000L + (long)((i*1000000000UL)>>10) );
+  check_done( iter );
+
+  FD_TEST( fd_pcap_mmap_iter_rewind( iter )==iter ); /* Rewinding resets sections */
+  for( ulong i=0UL; i<PKT_CNT/2UL; i++ ) {
+    if( i & 1UL ) check_cooked( iter, i, 123456789L + (long)i );
+    else          check_pkt   ( iter, i, 1000L*(123456789L + (long)i) );
+  }
+  fd_pcap_mmap_iter_delete( iter );
+
+  /* Truncations of the pcapng capture fail cleanly */
+
+  for( ulong trunc=1UL; trunc<cap_sz-28UL; trunc+=97UL ) {
+    iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz-trunc ); FD_TEST( iter );
+    ulong sz; long ts; fd_eth_hdr_t const * hdr;
+    ulong cnt = 0UL;
+    while( fd_pcap_mmap_iter_next( iter, &sz, &ts, &hdr ) ) cnt++;
+    FD_TEST( cnt<PKT_CNT );
+    fd_pcap_mmap_iter_delete( iter );
+  }
+
+  /* Packet on an interface with an unsupported link type and packet on
+     an undescribed interface */
+
+  for( uint if_idx=2U; if_idx<4U; if_idx++ ) {
+    cap_sz = sec1;
+    cap_swap = 0;
+    ng_epb( if_idx, 0UL, pkt_mem[0], pkt_sz[0] );
+    iter = fd_pcap_mmap_iter_new_mem( _iter, cap, cap_sz ); FD_TEST( iter );
+    ulong sz; long ts; fd_eth_hdr_t const * hdr;
+    for( ulong i=0UL; i<PKT_CNT/2UL; i++ ) FD_TEST( fd_pcap_mmap_iter_next( iter, &sz, &ts, &hdr ) );
+    check_done( iter );
+    FD_TEST( iter->off==sec1 );
+    fd_pcap_mmap_iter_delete( iter );
+  }
+
+  /* File backed capture (including a round trip with fd_pcap) */
+
+  char path[] = "/tmp/test_pcap_mmap.XXXXXX";
+  int fd = mkstemp( path ); FD_TEST( fd>=0 );
+  FILE * file = fdopen( fd, "w" ); FD_TEST( file );
+  FD_TEST( fd_pcap_fwrite_hdr( file )==1UL );
+  for( ulong i=0UL; i<PKT_CNT; i++ ) {
+    uint fcs; memcpy( &fcs, pkt_mem[i]+pkt_sz[i]-4UL, 4UL );
+    FD_TEST( fd_pcap_fwrite_pkt( 1234567L*(long)i, pkt_mem[i], 14UL, pkt_mem[i]+14UL, pkt_sz[i]-18UL, fcs, file )==1UL );
+  }
+  FD_TEST( !fclose( file ) );
+
+  FD_TEST( !fd_pcap_mmap_iter_new( NULL,  path, 0 ) );
+  FD_TEST( !fd_pcap_mmap_iter_new( _iter, NULL, 0 ) );
+  FD_TEST( !fd_pcap_mmap_iter_new( _iter, "/tmp/test_pcap_mmap.does_not_exist", 0 ) );
+
+  for( int flags=0; flags<4; flags++ ) {
+    iter = fd_pcap_mmap_iter_new( _iter, path, flags ); FD_TEST( iter );
+    for( ulong i=0UL; i<PKT_CNT; i++ ) check_pkt( iter, i, 1234567L*(long)i );
+    check_done( iter );
+    FD_TEST( fd_pcap_mmap_iter_rewind( iter )==iter );
+    for( ulong i=0UL; i<PKT_CNT; i++ ) check_pkt( iter, i, 1234567L*(long)i );
+    check_done( iter );
+    FD_TEST( fd_pcap_mmap_iter_delete( iter )==(void *)_iter );
+  }
+
+  FD_TEST( !unlink( path ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_NOTICE(( "skip: unit test requires FD_HAS_HOSTED" ));
+  fd_halt();
+  return 0;
+}
+
+#endif